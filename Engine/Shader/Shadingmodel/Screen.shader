@@ -7,6 +7,7 @@ Shader "Screen"
         HLSLPROGRAM
         #pragma vertex VS
         #pragma fragment PS
+        #pragma multi_compile _ _SSGI
 
         struct VSInput
         {
@@ -230,11 +231,13 @@ Shader "Screen"
             float gtao = GTAOTexture.Sample(gSamPointClamp, input.uv).r;
             float ao = clamp(materialAO * gtao,0.03,1);
 
+#ifdef _SSGI
             // 采样SSGI（t7由编译器注入）
             // rgb = SSGI间接光照, a = 命中率权重（用于与IBL lerp混合）
             float4 ssgiData = SSGITexture.Sample(gSamPointClamp, input.uv);
             float3 ssgi = ssgiData.rgb;
             float ssgiWeight = ssgiData.a;
+#endif
 
             // 计算视线方向和反射方向
             float3 N = normalize(normal.xyz);
@@ -279,12 +282,13 @@ Shader "Screen"
             // 采样阴影图（从LightPass输出）
             float shadow = ShadowMap.Sample(gSamPointWrap, input.uv).r;
             // 直接光照 * 阴影 + 间接光照
-             // GI模式通过场景常量缓冲区传入：_Padding0.x = giType (0=ambient, 1=SSGI)
-            
+            // GI模式由全局关键字_SSGI选择变体（0=ambient, 1=SSGI）
             float3 ambient = (diffuseIBL + specularIBL) * Skylight;
+#ifdef _SSGI
             // SSGI模式：用命中率权重在 IBL 和 SSGI 之间 lerp
             // ssgiWeight=0 → 全部使用IBL, ssgiWeight=1 → 全部使用SSGI
-            ambient = (_Padding0.x > 0.5) ? lerp(ambient, ssgi, ssgiWeight) : ambient;
+            ambient = lerp(ambient, ssgi, ssgiWeight);
+#endif
             ambient = ambient * MultiBounceAO(ao,baseColor.xyz);
             // ==================== 组合最终颜色 ====================
             float3 finalColor = float3(0, 0, 0);
@@ -7,6 +7,7 @@ Shader "StandardPBR"
         //# float4 BaseColor {default(1.0, 1.0, 1.0, 1.0), ui(ColorPicker)};
         //# float Roughness {default(0.5), min(0.0), max(1.0), ui(Slider)};
         //# float Metallic {default(0.0), min(0.0), max(1.0), ui(Slider)};
+        //# bool UseNormalMap {default(1), ui(Checkbox), keyword(_NORMALMAP)};
         //# Texture2D BaseColorTex;
         //# Texture2D NormalTex;
         //# Texture2D OrmTex;
@@ -20,6 +21,7 @@ Shader "StandardPBR"
         HLSLPROGRAM
         #pragma vertex MainVS
         #pragma fragment MainPS
+        #pragma multi_compile _ _NORMALMAP
 
         struct VertexData
         {
@@ -45,15 +47,18 @@ Shader "StandardPBR"
 
         static const float PI = 3.141592;
 
-        VSOut MainVS(VertexData inVertexData)
+        VSOut MainVS(VertexData inVertexData, uint instanceID : SV_InstanceID)
         {
+            // 逐实例变换（同Mesh同材质的Actor合并为一次实例化绘制）
+            InstanceData instance = g_InstanceData[instanceID];
+
             VSOut vo;
-            vo.IT_ModelMatrix = IT_ModelMatrix;
-            float3 tangentWS = normalize(mul(float4(inVertexData.tangent.xyz, 0.0f), ModelMatrix).xyz);
+            vo.IT_ModelMatrix = instance.IT_ModelMatrix;
+            float3 tangentWS = normalize(mul(float4(inVertexData.tangent.xyz, 0.0f), instance.ModelMatrix).xyz);
             vo.tangent = float4(tangentWS, inVertexData.tangent.w);
-            vo.normal = mul(IT_ModelMatrix, inVertexData.normal);
+            vo.normal = mul(instance.IT_ModelMatrix, inVertexData.normal);
             float3 positionMS = inVertexData.position.xyz;
-            float4 positionWS = mul(ModelMatrix, float4(positionMS, 1.0));
+            float4 positionWS = mul(instance.ModelMatrix, float4(positionMS, 1.0));
             float4 positionVS = mul(ViewMatrix, positionWS);
             vo.position = mul(ProjectionMatrix, positionVS);
             vo.positionWS = positionWS;
@@ -64,9 +69,9 @@ Shader "StandardPBR"
             // TAA: 计算当前帧和上一帧的裁剪空间位置（用于Motion Vector）
             // 注意：Motion Vector必须使用不带Jitter的投影矩阵，否则会导致重影
             vo.currentPositionCS = mul(CurrentViewProjectionMatrix, positionWS);  // 不带Jitter
-            // 使用上一帧的ViewProjection矩阵计算上一帧位置
-            // 注意：这里假设物体是静态的，动态物体需要使用上一帧的ModelMatrix
-            vo.previousPositionCS = mul(PreviousViewProjectionMatrix, positionWS);
+            // 使用上一帧的ModelMatrix和ViewProjection矩阵计算上一帧位置（动态物体也有正确的速度）
+            float4 previousPositionWS = mul(instance.PreviousModelMatrix, float4(positionMS, 1.0));
+            vo.previousPositionCS = mul(PreviousViewProjectionMatrix, previousPositionWS);
 
             return vo;
         }
@@ -85,7 +90,6 @@ Shader "StandardPBR"
 
             // 采样纹理 - 使用Bindless纹理系统（通过CB中的索引访问全局纹理数组）
             float3 sampledBaseColor = SAMPLE_TEXTURE(BaseColorTexIndex, gSamAnisotropicWarp, inPSInput.texcoord.xy).xyz;
-            float4 sampledNormal = SAMPLE_TEXTURE(NormalTexIndex, gSamAnisotropicWarp, inPSInput.texcoord.xy);
             float3 sampledOrm = SAMPLE_TEXTURE(OrmTexIndex, gSamAnisotropicWarp, inPSInput.texcoord.xy).xyz;
 
             // 应用材质参数
@@ -96,8 +100,9 @@ Shader "StandardPBR"
             float finalRoughness = saturate(sampledOrm.g + Roughness);  // 粗糙度相加
             float finalMetallic = saturate(sampledOrm.b + Metallic);    // 金属度相加
 
-            // 计算TBN矩阵
             float3 N = normalize(inPSInput.normal.xyz);
+#ifdef _NORMALMAP
+            // 计算TBN矩阵
             float4 T = inPSInput.tangent;
             T.xyz = normalize(T.xyz - dot(T.xyz, N) * N);
             float3 B = normalize(cross(N, T.xyz)) * T.w;
@@ -105,8 +110,13 @@ Shader "StandardPBR"
             TBN = transpose(TBN);
 
             // 法线贴图处理
+            float4 sampledNormal = SAMPLE_TEXTURE(NormalTexIndex, gSamAnisotropicWarp, inPSInput.texcoord.xy);
             float3 tangentNormal = sampledNormal.xyz * 2.0 - 1.0;
             float3 normalWS = normalize(mul(TBN, tangentNormal));
+#else
+            // 没有法线贴图的材质直接使用顶点法线，省掉一次采样和TBN变换
+            float3 normalWS = N;
+#endif
 
             // 输出到GBuffer
             gbuffer.BaseColor = float4(finalBaseColor, 1.0f);
@@ -26,6 +26,7 @@ Shader "ToonPBR"
         //# float4 BaseColor {default(1.0, 1.0, 1.0, 1.0), ui(ColorPicker)};
         //# float Roughness {default(0.5), min(0.0), max(1.0), ui(Slider)};
         //# float Metallic {default(0.0), min(0.0), max(1.0), ui(Slider)};
+        //# bool UseNormalMap {default(1), ui(Checkbox), keyword(_NORMALMAP)};
         //# Texture2D BaseColorTex;
         //# Texture2D NormalTex;
         //# Texture2D OrmTex;
@@ -40,6 +41,7 @@ Shader "ToonPBR"
         HLSLPROGRAM
         #pragma vertex MainVS
         #pragma fragment MainPS
+        #pragma multi_compile _ _NORMALMAP
 
         struct VertexData
         {
@@ -65,15 +67,18 @@ Shader "ToonPBR"
 
         static const float PI = 3.141592;
 
-        VSOut MainVS(VertexData inVertexData)
+        VSOut MainVS(VertexData inVertexData, uint instanceID : SV_InstanceID)
         {
+            // 逐实例变换（同Mesh同材质的Actor合并为一次实例化绘制）
+            InstanceData instance = g_InstanceData[instanceID];
+
             VSOut vo;
-            vo.IT_ModelMatrix = IT_ModelMatrix;
-            float3 tangentWS = normalize(mul(float4(inVertexData.tangent.xyz, 0.0f), ModelMatrix).xyz);
+            vo.IT_ModelMatrix = instance.IT_ModelMatrix;
+            float3 tangentWS = normalize(mul(float4(inVertexData.tangent.xyz, 0.0f), instance.ModelMatrix).xyz);
             vo.tangent = float4(tangentWS, inVertexData.tangent.w);
-            vo.normal = mul(IT_ModelMatrix, inVertexData.normal);
+            vo.normal = mul(instance.IT_ModelMatrix, inVertexData.normal);
             float3 positionMS = inVertexData.position.xyz;
-            float4 positionWS = mul(ModelMatrix, float4(positionMS, 1.0));
+            float4 positionWS = mul(instance.ModelMatrix, float4(positionMS, 1.0));
             float4 positionVS = mul(ViewMatrix, positionWS);
             vo.position = mul(ProjectionMatrix, positionVS);
             vo.positionWS = positionWS;
@@ -84,7 +89,8 @@ Shader "ToonPBR"
             // TAA: 计算当前帧和上一帧的裁剪空间位置（用于Motion Vector）
             // 注意：Motion Vector必须使用不带Jitter的投影矩阵，否则会导致重影
             vo.currentPositionCS = mul(CurrentViewProjectionMatrix, positionWS);  // 不带Jitter
-            vo.previousPositionCS = mul(PreviousViewProjectionMatrix, positionWS);
+            float4 previousPositionWS = mul(instance.PreviousModelMatrix, float4(positionMS, 1.0));
+            vo.previousPositionCS = mul(PreviousViewProjectionMatrix, previousPositionWS);
 
             return vo;
         }
@@ -103,7 +109,6 @@ Shader "ToonPBR"
 
             // 采样纹理 - 使用Bindless纹理系统（通过CB中的索引访问全局纹理数组）
             float3 sampledBaseColor = SAMPLE_TEXTURE(BaseColorTexIndex, gSamAnisotropicWarp, inPSInput.texcoord.xy).xyz;
-            float4 sampledNormal = SAMPLE_TEXTURE(NormalTexIndex, gSamAnisotropicWarp, inPSInput.texcoord.xy);
             float3 sampledOrm = SAMPLE_TEXTURE(OrmTexIndex, gSamAnisotropicWarp, inPSInput.texcoord.xy).xyz;
 
             float3 finalBaseColor = sampledBaseColor * BaseColor.xyz;
@@ -112,14 +117,20 @@ Shader "ToonPBR"
             float finalMetallic = saturate(sampledOrm.b + Metallic);
 
             float3 N = normalize(inPSInput.normal.xyz);
+#ifdef _NORMALMAP
             float4 T = inPSInput.tangent;
             T.xyz = normalize(T.xyz - dot(T.xyz, N) * N);
             float3 B = normalize(cross(N, T.xyz)) * T.w;
             float3x3 TBN = float3x3(T.xyz, B, N);
             TBN = transpose(TBN);
 
+            float4 sampledNormal = SAMPLE_TEXTURE(NormalTexIndex, gSamAnisotropicWarp, inPSInput.texcoord.xy);
             float3 tangentNormal = sampledNormal.xyz * 2.0 - 1.0;
             float3 normalWS = normalize(mul(TBN, tangentNormal));
+#else
+            // 没有法线贴图的材质直接使用顶点法线，省掉一次采样和TBN变换
+            float3 normalWS = N;
+#endif
 
             gbuffer.BaseColor = float4(finalBaseColor, 1.0f);
             gbuffer.Normal = float4(normalWS, 1.0f);
@@ -294,13 +294,24 @@ float4 LightPS(VSOut inPSInput) : SV_TARGET
     float3 positionWS = ReconstructWorldPosition(inPSInput.texcoord, depth);
 
     // 根据阴影模式选择算法
+    // 引擎按SHADOW_MODE 0/1/2各编译一个PSO，分支在编译期确定；没有定义时按常量缓冲区动态选择
     float shadow;
+#if defined(SHADOW_MODE)
+#if SHADOW_MODE == 0
+    shadow = CalculateHardShadow(positionWS);
+#elif SHADOW_MODE == 1
+    shadow = CalculateShadow(positionWS);
+#else
+    shadow = CalculateShadowPCSS(positionWS);
+#endif
+#else
     if (ShadowMode < 0.5f)
         shadow = CalculateHardShadow(positionWS);
     else if (ShadowMode < 1.5f)
         shadow = CalculateShadow(positionWS);
     else
         shadow = CalculateShadowPCSS(positionWS);
+#endif
 
     // 输出阴影因子
     return float4(shadow, shadow, shadow, 1.0f);
@@ -21,6 +21,15 @@ cbuffer SceneConstants : register(b0)
     float4x4 LightViewProjectionMatrix;  // LiSPSM矩阵
 };
 
+// 逐实例数据（与ShaderParser生成的InstanceData一致，根签名Slot 3）
+struct InstanceData
+{
+    float4x4 ModelMatrix;
+    float4x4 IT_ModelMatrix;
+    float4x4 PreviousModelMatrix;
+};
+StructuredBuffer<InstanceData> g_InstanceData : register(t0, space1);
+
 // 输入顶点格式（与StaticMeshComponent一致）
 struct VertexInput
 {
@@ -37,12 +46,12 @@ struct VSOutput
 };
 
 // 顶点着色器：将顶点变换到光源裁剪空间
-VSOutput ShadowDepthVS(VertexInput input)
+VSOutput ShadowDepthVS(VertexInput input, uint instanceID : SV_InstanceID)
 {
     VSOutput output;
 
-    // 1. 模型空间 -> 世界空间
-    float4 positionWS = mul(ModelMatrix, float4(input.position.xyz, 1.0));
+    // 1. 模型空间 -> 世界空间（同Mesh的投影者合并为一次实例化绘制）
+    float4 positionWS = mul(g_InstanceData[instanceID].ModelMatrix, float4(input.position.xyz, 1.0));
 
     // 2. 世界空间 -> 光源裁剪空间
     output.position = mul(LightViewProjectionMatrix, positionWS);
@@ -16,8 +16,14 @@
 #include "public/SsgiPass.h"
 #include "public/Material.h"
 #include "public/Material/MaterialManager.h"
+#include "public/Mesh/MeshManager.h"
+#include "public/UploadAllocator.h"
 #include "public/Material/MaterialEditorPanel.h"
 #include "public/Material/ShaderParser.h"
+#include "public/Material/ShaderBytecodeCache.h"
+#include "public/PipelineStateCache.h"
+#include "public/Material/ShaderCompileQueue.h"
+#include "public/Material/ShaderKeywords.h"
 #include "public/ResourceManager.h"
 #include "public/Settings.h"
 #include "public/Texture/TextureManager.h"
@@ -80,6 +86,12 @@ LRESULT CALLBACK WindowProc(HWND inHWND, UINT inMSG, WPARAM inWParam, LPARAM inL
 }
 
 int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPSTR lpCmdLine, _In_ int nShowCmd) {
+    // 离线转换模式：FEngine.exe -cookassets 把XML资产烘焙为二进制格式后退出（不创建窗口和设备）
+    if (lpCmdLine && strstr(lpCmdLine, "-cookassets")) {
+        int failedCount = ResourceManager::GetInstance().CookAssets();
+        return failedCount == 0 ? 0 : 1;
+    }
+
     WNDCLASSEX wndClassEx;
     wndClassEx.cbSize = sizeof(WNDCLASSEX);
     wndClassEx.style = CS_HREDRAW | CS_VREDRAW;
@@ -119,6 +131,19 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
         return -1;
     }
 
+    // 初始化逐帧上传分配器（场景常量、实例数据）
+    if (!LinearUploadAllocator::GetInstance().Initialize(gD3D12Device)) {
+        MessageBox(NULL, L"LinearUploadAllocator初始化失败!", L"错误", MB_OK | MB_ICONERROR);
+        return -1;
+    }
+
+    // 着色器字节码磁盘缓存（初始化失败时仍可编译，只是不缓存）
+    ShaderBytecodeCache::GetInstance().Initialize(GetEnginePath() + L"Shader\\Shader_Cache\\Bytecode\\");
+    // PSO缓存（设备不支持管线库时只做进程内去重）
+    PipelineStateCache::GetInstance().Initialize(gD3D12Device, GetEnginePath() + L"Shader\\Shader_Cache\\Pipelines.bin");
+    // 着色器并行编译线程池
+    ShaderCompileQueue::GetInstance().Initialize();
+
     // 初始化Settings
     Settings::GetInstance().Initialize(viewportWidth, viewportHeight);
 
@@ -184,14 +209,12 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     commandList->Reset(commandAllocator, nullptr);
 
     LightPass* lightPass = new LightPass(viewportWidth, viewportHeight, 4096);  // 包含4096x4096 Shadow Map
-    lightPass->SetSceneConstantBuffer(g_scene->GetConstantBuffer());
     if (!lightPass->Initialize(commandList)) {
         MessageBox(NULL, L"LightPass初始化失败!", L"错误", MB_OK | MB_ICONERROR);
         return -1;
     }
 
     ScreenPass*  screenPass = new ScreenPass();
-    screenPass->SetSceneConstantBuffer(g_scene->GetConstantBuffer());
     if (!screenPass->Initialize(viewportWidth, viewportHeight)) {
         MessageBox(NULL, L"ScreenPass初始化失败!", L"错误", MB_OK | MB_ICONERROR);
         return -1;
@@ -199,7 +222,6 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 
     // 初始化SkyPass
     SkyPass* skyPass = new SkyPass();
-    skyPass->SetSceneConstantBuffer(g_scene->GetConstantBuffer());
     if (!skyPass->Initialize(commandList, 500.0f)) {
         MessageBox(NULL, L"SkyPass初始化失败!", L"错误", MB_OK | MB_ICONERROR);
         return -1;
@@ -207,7 +229,6 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 
     // 初始化TaaPass
     TaaPass* taaPass = new TaaPass();
-    taaPass->SetSceneConstantBuffer(g_scene->GetConstantBuffer());
     if (!taaPass->Initialize(viewportWidth, viewportHeight)) {
         MessageBox(NULL, L"TaaPass初始化失败!", L"错误", MB_OK | MB_ICONERROR);
         return -1;
@@ -215,7 +236,6 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 
     // 初始化GtaoPass
     GtaoPass* gtaoPass = new GtaoPass();
-    gtaoPass->SetSceneConstantBuffer(g_scene->GetConstantBuffer());
     if (!gtaoPass->Initialize(viewportWidth, viewportHeight)) {
         MessageBox(NULL, L"GtaoPass初始化失败!", L"错误", MB_OK | MB_ICONERROR);
         return -1;
@@ -223,7 +243,6 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 
     // 初始化SsgiPass
     SsgiPass* ssgiPass = new SsgiPass();
-    ssgiPass->SetSceneConstantBuffer(g_scene->GetConstantBuffer());
     if (!ssgiPass->Initialize(viewportWidth, viewportHeight)) {
         MessageBox(NULL, L"SsgiPass初始化失败!", L"错误", MB_OK | MB_ICONERROR);
         return -1;
@@ -247,13 +266,20 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
         return -1;
     }
 
-    D3D12_SHADER_BYTECODE lightVS, lightPS;
+    // 阴影模式（0=Hard, 1=PCF, 2=PCSS）各编译一个PS，去掉像素着色器里的动态分支
+    D3D12_SHADER_BYTECODE lightVS;
     CreateShaderFromFile((GetEnginePath() + L"Shader/lighting.hlsl").c_str(), "LightVS", "vs_5_0", &lightVS);
-    CreateShaderFromFile((GetEnginePath() + L"Shader/lighting.hlsl").c_str(), "LightPS", "ps_5_0", &lightPS);
-    ID3D12PipelineState* lightPso = lightPass->CreateLightPSO(rootSignature, lightVS, lightPS);
-    if (!lightPso) {
-        MessageBox(NULL, L"创建LightPass PSO失败!", L"错误", MB_OK | MB_ICONERROR);
-        return -1;
+    ID3D12PipelineState* lightPsos[3] = {};
+    for (int mode = 0; mode < 3; ++mode) {
+        const char* modeValues[] = { "0", "1", "2" };
+        const D3D_SHADER_MACRO defines[] = { { "SHADOW_MODE", modeValues[mode] }, { nullptr, nullptr } };
+        D3D12_SHADER_BYTECODE lightPS;
+        CreateShaderFromFile((GetEnginePath() + L"Shader/lighting.hlsl").c_str(), "LightPS", "ps_5_0", &lightPS, defines);
+        lightPsos[mode] = lightPass->CreateLightPSO(rootSignature, lightVS, lightPS);
+        if (!lightPsos[mode]) {
+            MessageBox(NULL, L"创建LightPass PSO失败!", L"错误", MB_OK | MB_ICONERROR);
+            return -1;
+        }
     }
 
     // 加载ShadowDepth着色器并创建PSO
@@ -377,6 +403,10 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     std::cout << "\n========== Loading Non-Default Shaders ==========" << std::endl;
     
     // ===== 步骤2: 循环加载所有非默认shader（排除screen.shader和StandardPBR.shader） =====
+    // 先全部解析，之后统一交给ShaderCompileQueue并行编译
+    // 全局关键字在解析前设置好，默认变体与当前设置一致
+    ShaderKeywordSpace::SetGlobalKeyword("_SSGI", ssgiPass->GetGIType() == 1);
+    std::vector<Shader*> startupShaders;
     for (const auto& resInfo : shaderResources) {
         // 跳过StandardPBR（这是默认shader，最后加载）
         if (resInfo.name == "StandardPBR") {
@@ -394,25 +424,7 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             return -1;
         }
 
-        // 编译shader
-        if (!shader->CompileShaders(gD3D12Device)) {
-            std::wstring errorMsg = L"编译 " + std::wstring(resInfo.name.begin(), resInfo.name.end()) + L" shader失败!";
-            MessageBox(NULL, errorMsg.c_str(), L"错误", MB_OK | MB_ICONERROR);
-            return -1;
-        }
-
-        // 为所有Pass创建PSO
-        for (int i = 0; i < shader->GetPassCount(); i++) {
-            ID3D12PipelineState* pso = shader->CreatePSO(gD3D12Device, rootSignature, i);
-            if (!pso) {
-                std::wstring errorMsg = L"创建 " + std::wstring(resInfo.name.begin(), resInfo.name.end()) +
-                                       L" shader Pass " + std::to_wstring(i) + L" PSO失败!";
-                MessageBox(NULL, errorMsg.c_str(), L"错误", MB_OK | MB_ICONERROR);
-                return -1;
-            }
-        }
-
-        std::cout << resInfo.name << " shader loaded with " << shader->GetPassCount() << " passes" << std::endl;
+        startupShaders.push_back(shader);
     }
 
     std::cout << "\n========== Loading Default Shader (StandardPBR) ==========" << std::endl;
@@ -425,9 +437,33 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
         return -1;
     }
 
-    // 2. 编译shader（会编译所有Pass）
-    if (!standardShader->CompileShaders(gD3D12Device)) {
-        MessageBox(NULL, L"编译StandardPBR shader失败!", L"错误", MB_OK | MB_ICONERROR);
+    startupShaders.push_back(standardShader);
+
+    // 2. 并行编译所有shader的所有Pass；每个shader编译完后为它的所有Pass创建PSO（StandardPBR的PSO在下面单独创建）
+    std::string failedShaderName;
+    std::string failedPsoName;
+    ShaderCompileQueue::GetInstance().CompileShaders(startupShaders, [&](Shader* shader, bool success) {
+        if (!success) {
+            if (failedShaderName.empty()) failedShaderName = shader->GetName();
+            return;
+        }
+        if (shader == standardShader) return;
+
+        for (int i = 0; i < shader->GetPassCount(); i++) {
+            if (!shader->CreatePSO(gD3D12Device, rootSignature, i) && failedPsoName.empty()) {
+                failedPsoName = shader->GetName() + " shader Pass " + std::to_string(i);
+            }
+        }
+        std::cout << shader->GetName() << " shader loaded with " << shader->GetPassCount() << " passes" << std::endl;
+    });
+    if (!failedShaderName.empty()) {
+        std::wstring errorMsg = L"编译 " + std::wstring(failedShaderName.begin(), failedShaderName.end()) + L" shader失败!";
+        MessageBox(NULL, errorMsg.c_str(), L"错误", MB_OK | MB_ICONERROR);
+        return -1;
+    }
+    if (!failedPsoName.empty()) {
+        std::wstring errorMsg = L"创建 " + std::wstring(failedPsoName.begin(), failedPsoName.end()) + L" PSO失败!";
+        MessageBox(NULL, errorMsg.c_str(), L"错误", MB_OK | MB_ICONERROR);
         return -1;
     }
 
@@ -462,13 +498,15 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     std::cout << "\n========== Loading Materials ==========" << std::endl;
     std::cout << "Found " << materialResources.size() << " material files" << std::endl;
 
+    // 材质文件在工作线程并行读取（.matbin），实例在主线程创建
+    std::vector<std::wstring> materialPaths;
     for (const auto& matInfo : materialResources) {
-        std::cout << "\nLoading material: " << matInfo.name << std::endl;
-        MaterialInstance* material = MaterialManager::GetInstance().LoadMaterial(matInfo.filePath);
-        if (material) {
-            std::cout << "  Material '" << matInfo.name << "' loaded successfully" << std::endl;
-        } else {
-            std::wcout << L"  Warning: Failed to load material from: " << matInfo.filePath << std::endl;
+        materialPaths.push_back(matInfo.filePath);
+    }
+    std::vector<MaterialInstance*> loadedMaterials = MaterialManager::GetInstance().LoadMaterials(materialPaths);
+    for (size_t i = 0; i < loadedMaterials.size(); ++i) {
+        if (!loadedMaterials[i]) {
+            std::wcout << L"  Warning: Failed to load material from: " << materialPaths[i] << std::endl;
         }
     }
 
@@ -502,6 +540,9 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     EndCommandList();
     WaitForCompletionOfCommandList();
 
+    // 预编译变体清单和已加载材质用到的关键字变体，避免运行时第一次使用时回退到默认变体
+    MaterialManager::GetInstance().PrecompileVariants(GetEnginePath() + L"Shader/ShaderVariants.txt");
+
     // 设置场景级Skylight强度（不再是材质参数）
     g_scene->SetSkylightIntensity(1.0f);
 
@@ -553,6 +594,9 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     WaitForCompletionOfCommandList();
     // ======= Level加载完成 =======
 
+    // 资源文件热重载（.shader/.hlsl/.material/纹理）
+    ResourceManager::GetInstance().StartHotReload();
+
     ShowWindow(hwnd, nShowCmd);
     UpdateWindow(hwnd);
 
@@ -584,8 +628,6 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             DispatchMessage(&msg);
         }
         else {
-            WaitForCompletionOfCommandList();
-
             // ======= 处理分辨率变更请求 =======
             if (Settings::GetInstance().IsPendingResolutionChange()) {
                 int newWidth, newHeight;
@@ -593,11 +635,11 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
                 bool shouldResizeWindow = Settings::GetInstance().ShouldResizeWindow();
                 Settings::GetInstance().ClearPendingResolutionChange();
 
-                // 确保GPU完全空闲，所有命令都已完成
+                // 确保GPU完全空闲，所有在途帧的命令都已完成
                 WaitForCompletionOfCommandList();
 
                 // 重置CommandAllocator（确保没有待执行的命令）
-                // 注意：前一帧的EndCommandList已经close了commandList
+                // 注意：前一帧的EndFrame已经close了commandList
                 HRESULT hr = commandAllocator->Reset();
                 if (FAILED(hr)) {
                     OutputDebugStringA("WARNING: commandAllocator->Reset() failed before resize\n");
@@ -648,10 +690,9 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
                 commandAllocator->Reset();
             }
 
-            commandAllocator->Reset();
-
-            // 延迟纹理加载：在帧开始前、GPU空闲时处理待加载的纹理
+            // 延迟纹理加载：在帧开始前处理待加载的纹理（使用初始化用的命令分配器，提交后等待完成）
             if (TexturePreviewPanel::GetInstance().HasPendingLoad()) {
+                WaitForCompletionOfCommandList();
                 commandList->Reset(commandAllocator, nullptr);
                 TextureManager::GetInstance().SetCommandList(commandList);
                 TexturePreviewPanel::GetInstance().ProcessPendingLoad();
@@ -660,219 +701,54 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
                 commandAllocator->Reset();
             }
 
-            DWORD current_time = timeGetTime();
-            float deltaTime = (current_time - last_time) / 1000.0f;
-            last_time = current_time;
-            // TAA: 在帧开始时更新Jitter（必须在场景渲染之前）
-            if (taaPass->IsEnabled()) {
-                taaPass->UpdateJitter();
-                XMFLOAT2 jitter = taaPass->GetJitterOffset();
-                g_scene->SetJitterOffset(jitter.x, jitter.y);
-            } else {
-                g_scene->SetJitterOffset(0.0f, 0.0f);
-            }
-
-            g_scene->Update(deltaTime);  // 更新Scene（计算LiSPSM矩阵）
-
-            //BasePass=======================================
-            // 使用StandardPBR Pass 0（GBuffer填充）
-            commandList->Reset(commandAllocator, gbufferPso);
-            commandList->BeginEvent(0, L"BasePass", (UINT)(wcslen(L"BasePass")* sizeof(wchar_t)));
-            BeginOffscreen(commandList);
-            ID3D12DescriptorHeap* srvHeaps[] = { srvHeap};
-            commandList->SetDescriptorHeaps(_countof(srvHeaps), srvHeaps);
-            g_scene->Render(commandList, gbufferPso, rootSignature);
-            commandList->EndEvent();
-            EndCommandList();
-            WaitForCompletionOfCommandList();  // Wait for BasePass to complete
-
-            //LightPass=======================================
-            // 执行LightPass（包含Shadow Map生成和光照计算）
-            // 只有在shadowmap开启时才执行
-            if (g_scene->IsShadowmapEnabled()) {
-                commandList->Reset(commandAllocator, shadowPso);
-                commandList->BeginEvent(0, L"LightPass", (UINT)(wcslen(L"LightPass") * sizeof(wchar_t)));
-                lightPass->RenderDirectLight(commandList, shadowPso, lightPso, rootSignature, g_scene, gDSRT);
-                commandList->EndEvent();
-                EndCommandList();
-                WaitForCompletionOfCommandList();  // Wait for LightPass to complete
-            }
-
-            //GtaoPass=======================================
-            // 执行GTAO（在LightPass之后、SkyPass之前）
-            if (gtaoPass->IsEnabled()) {
-                commandList->Reset(commandAllocator, gtaoPso);
-                commandList->BeginEvent(0, L"GtaoPass", (UINT)(wcslen(L"GtaoPass") * sizeof(wchar_t)));
-
-                // 注意：深度缓冲在BasePass的Scene::Render末尾已经被转为PIXEL_SHADER_RESOURCE
-                // LightPass使用后状态不变，所以这里直接使用即可
-
-                auto& gtaoSceneRTs = g_scene->m_offscreenRTs;
-                gtaoPass->Render(commandList, gtaoPso, gtaoBlurPso, rootSignature,
-                    gDSRT,              // 深度缓冲（已经是PIXEL_SHADER_RESOURCE状态）
-                    gtaoSceneRTs[1]);   // 法线RT (GBuffer RT1，已经是PIXEL_SHADER_RESOURCE状态)
-
-                commandList->EndEvent();
-                EndCommandList();
-                WaitForCompletionOfCommandList();  // Wait for GtaoPass to complete
-            }
-
-            //SsgiPass=======================================
-            // 执行SSGI（在GTAO之后、SkyPass之前）
-            if (ssgiPass->IsEnabled()) {
-                commandList->Reset(commandAllocator, ssgiDepthPso);
-                commandList->BeginEvent(0, L"SsgiPass", (UINT)(wcslen(L"SsgiPass") * sizeof(wchar_t)));
-
-                auto& ssgiSceneRTs = g_scene->m_offscreenRTs;
-                ssgiPass->Render(commandList,
-                    ssgiDepthPso,
-                    ssgiPso,
-                    ssgiUpsamplePso,
-                    ssgiBlurHPso,
-                    ssgiBlurVPso,
-                    rootSignature,
-                    gDSRT,
-                    ssgiSceneRTs[0],   // BaseColor RT
-                    ssgiSceneRTs[1],   // Normal RT
-                    ssgiSceneRTs[3]);  // Velocity RT (Motion Vector)
-
-                commandList->EndEvent();
-                EndCommandList();
-                WaitForCompletionOfCommandList();  // Wait for SsgiPass to complete
-            }
-
-            //SkyPass=======================================
-            // 执行SkyPass（渲染天空球，在ScreenPass之前）
-            // 当TAA启用时，渲染到中间RT；否则渲染到交换链
-            if (skyPso) {
-                commandList->Reset(commandAllocator, skyPso);
-                commandList->BeginEvent(0, L"SkyPass", (UINT)(wcslen(L"SkyPass") * sizeof(wchar_t)));
-
-                if (taaPass->IsEnabled()) {
-                    // TAA启用：渲染到中间RT
-                    D3D12_CPU_DESCRIPTOR_HANDLE intermediateRTV = taaPass->GetIntermediateRTV();
-                    float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
-                    commandList->ClearRenderTargetView(intermediateRTV, clearColor, 0, nullptr);
-                    commandList->OMSetRenderTargets(1, &intermediateRTV, FALSE, nullptr);
-
-                    // 设置视口和裁剪矩形（使用TaaPass的当前分辨率）
-                    int currentWidth = taaPass->GetViewportWidth();
-                    int currentHeight = taaPass->GetViewportHeight();
-                    D3D12_VIEWPORT viewport = { 0, 0, (float)currentWidth, (float)currentHeight, 0.0f, 1.0f };
-                    D3D12_RECT scissorRect = { 0, 0, currentWidth, currentHeight };
-                    commandList->RSSetViewports(1, &viewport);
-                    commandList->RSSetScissorRects(1, &scissorRect);
-                } else {
-                    // TAA禁用：渲染到交换链
-                    BeginRenderToSwapChain(commandList, true, false);
-                }
-
-                ComPtr<ID3D12Resource> skyTextureForSky = g_scene->ReturnSkyCube();
-                skyPass->Render(commandList, skyPso, rootSignature, skyTextureForSky);
-
-                if (!taaPass->IsEnabled()) {
-                    EndRenderToSwapChain(commandList);
-                }
-
-                commandList->EndEvent();
-                EndCommandList();
-                WaitForCompletionOfCommandList();  // Wait for SkyPass to complete
-            }
-
-            //ScreenPass======================================
-            commandList->Reset(commandAllocator, deferredLightingPso);
-            commandList->BeginEvent(0, L"ScreenPass", (UINT)(wcslen(L"ScreenPass") * sizeof(wchar_t)));
-
-            if (taaPass->IsEnabled()) {
-                // TAA启用：渲染到中间RT（不清空，保留SkyPass的结果）
-                D3D12_CPU_DESCRIPTOR_HANDLE intermediateRTV = taaPass->GetIntermediateRTV();
-                commandList->OMSetRenderTargets(1, &intermediateRTV, FALSE, nullptr);
-
-                // 设置视口和裁剪矩形（使用TaaPass的当前分辨率）
-                int currentWidth = taaPass->GetViewportWidth();
-                int currentHeight = taaPass->GetViewportHeight();
-                D3D12_VIEWPORT viewport = { 0, 0, (float)currentWidth, (float)currentHeight, 0.0f, 1.0f };
-                D3D12_RECT scissorRect = { 0, 0, currentWidth, currentHeight };
-                commandList->RSSetViewports(1, &viewport);
-                commandList->RSSetScissorRects(1, &scissorRect);
-            } else {
-                // TAA禁用：渲染到交换链
-                BeginRenderToSwapChain(commandList, false, false);
-            }
-
-            auto& sceneRTs = g_scene->m_offscreenRTs;
-            ComPtr<ID3D12Resource> skyTexture = g_scene->ReturnSkyCube();
-            // 渲染（使用深度缓冲代替Position RT，传入LightPass的阴影图和GTAO纹理）
-            // GetAOTexture() 在GTAO关闭时会返回默认白色纹理（AO=1，无遮蔽）
-            // 当shadowmap关闭时，传入nullptr，ScreenPass会使用白色纹理
-            screenPass->Render(commandList, deferredLightingPso, rootSignature,
-                sceneRTs[0], sceneRTs[1], sceneRTs[2],  // 3个GBuffer RT
-                gDSRT,  // 深度缓冲用于位置重构
-                skyTexture,
-                g_scene->IsShadowmapEnabled() ? lightPass->GetLightRT() : nullptr,  // shadowmap关闭时传nullptr
-                gtaoPass->GetAOTexture(),  // GTAO输出（关闭时为白色纹理）
-                ssgiPass->GetSSGITexture());  // SSGI输出（关闭时为黑色纹理）
-
-            // 将深度缓冲转换回DEPTH_WRITE状态，供下一帧和BeginRenderToSwapChain使用
-            D3D12_RESOURCE_BARRIER depthBarrier = {};
-            depthBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-            depthBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-            depthBarrier.Transition.pResource = gDSRT;
-            depthBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
-            depthBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_DEPTH_WRITE;
-            depthBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-            commandList->ResourceBarrier(1, &depthBarrier);
-
-            if (!taaPass->IsEnabled()) {
-                EndRenderToSwapChain(commandList);
-            }
-
-            commandList->EndEvent();
-            EndCommandList();
-            WaitForCompletionOfCommandList();  // Wait for ScreenPass to complete
-
-            // TAA Pass
-            if (taaPass->IsEnabled()) {
-                commandList->Reset(commandAllocator, taaPso);
-                commandList->BeginEvent(0, L"TaaPass", (UINT)(wcslen(L"TaaPass") * sizeof(wchar_t)));
-
-                // 获取Motion Vector RT
-                ID3D12Resource* motionVectorRT = g_scene->GetMotionVectorRT();
-
-                // 执行TAA（从中间RT读取，输出到历史缓冲）
-                taaPass->RenderToSwapChain(commandList, taaPso, rootSignature,
-                    motionVectorRT, gDSRT, GetCurrentSwapChainRTV());
-
-                commandList->EndEvent();
-                EndCommandList();
+            // 热重载：shader提交后台编译；纹理和材质需要重新上传，和上面一样在帧开始前等GPU空闲后处理
+            ResourceManager::GetInstance().PollFileChanges();
+            if (ResourceManager::GetInstance().HasPendingReloads()) {
                 WaitForCompletionOfCommandList();
-
-                // 复制TAA结果到交换链
-                commandList->Reset(commandAllocator, taaCopyPso);
-                commandList->BeginEvent(0, L"TaaCopy", (UINT)(wcslen(L"TaaCopy") * sizeof(wchar_t)));
-
-                BeginRenderToSwapChain(commandList, true, false);
-                taaPass->CopyToSwapChain(commandList, taaCopyPso, rootSignature, GetCurrentSwapChainRTV());
-                EndRenderToSwapChain(commandList);
-
-                commandList->EndEvent();
+                commandList->Reset(commandAllocator, nullptr);
+                ResourceManager::GetInstance().ProcessPendingReloads(commandList);
                 EndCommandList();
                 WaitForCompletionOfCommandList();
+                commandAllocator->Reset();
+            }
 
-                // 在帧结束时更新上一帧的 VP 矩阵
-                g_scene->UpdatePreviousViewProjectionMatrix();
-
-                // 交换历史缓冲
-                taaPass->SwapHistoryBuffers();
+            // 开始本帧：只等待同一帧上下文上一次的提交，整帧录制到一个命令列表，最后统一提交
+            BeginFrame();
+            LinearUploadAllocator::GetInstance().BeginFrame();
+            // 回填后台编译完成的着色器（热重载），在录制本帧命令之前替换字节码和PSO
+            ShaderCompileQueue::GetInstance().ProcessCompleted();
+            // 本帧之前注册了新的ShadingModel时，延迟光照Pass过期的shader合成一批重新编译
+            MaterialManager::GetInstance().RecompileStaleShadingModels();
+            MaterialManager::GetInstance().ReleaseRetiredResources();
+            MeshManager::GetInstance().ReleaseRetiredResources();
+            PipelineStateCache::GetInstance().ReleaseRetiredPipelines();
+
+            // 纹理流送：按前几帧的屏幕尺寸反馈和显存预算调整各纹理的常驻mip
+            // 上传录制到本帧命令列表（位于渲染命令之前），上传完成后等在途帧执行完再切换到新资源并在原槽位重建材质的SRV
+            TextureManager::GetInstance().UpdateStreaming();
+            std::vector<TextureAsset*> streamedTextures;
+            TextureManager::GetInstance().ApplyStreaming(commandList, streamedTextures);
+            for (TextureAsset* texture : streamedTextures) {
+                MaterialManager::GetInstance().RefreshTextureBindings(texture);
+                TexturePreviewPanel::GetInstance().OnTextureResourceChanged(texture);
             }
 
-            //UiPass==========================================
-            commandList->Reset(commandAllocator, UiPso);
-            commandList->BeginEvent(0, L"UIPass", (UINT)(wcslen(L"UIPass") * sizeof(wchar_t)));
+            // UI先于渲染Pass构建：UI中触发的资源上传录制在本帧渲染命令之前，UI修改的设置在本帧生效
             ImGui_ImplDX12_NewFrame();
             ImGui_ImplWin32_NewFrame();
             ImGui::NewFrame();
 
+            // 视口点击拾取（拖动旋转相机时不触发）
+            if (!io.WantCaptureMouse && ImGui::IsMouseReleased(0) && io.MouseDragMaxDistanceSqr[0] < 16.0f &&
+                io.DisplaySize.x > 0.0f && io.DisplaySize.y > 0.0f) {
+                float ndcX = io.MousePos.x / io.DisplaySize.x * 2.0f - 1.0f;
+                float ndcY = 1.0f - io.MousePos.y / io.DisplaySize.y * 2.0f;
+                selectedActor = g_scene->PickActor(ndcX, ndcY);
+                if (selectedActor) {
+                    showActorPanel = true;
+                }
+            }
+
             // 主菜单栏（顶部）
             if (ImGui::BeginMainMenuBar())
             {
@@ -988,6 +864,7 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
                 if (ImGui::Combo("GI", &currentGIType, giTypes, 2)) {
                     ssgiPass->SetGIType(currentGIType);
                     g_scene->SetGIType(currentGIType);
+                    ShaderKeywordSpace::SetGlobalKeyword("_SSGI", currentGIType == 1);
                 }
 
                 if (currentGIType == 1) {
@@ -1019,6 +896,23 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
                     }
                 }
 
+                ImGui::Separator();
+                ImGui::Text("Texture Streaming");
+                if (TextureManager::GetInstance().IsStreamingEnabled()) {
+                    int budgetMB = (int)(TextureManager::GetInstance().GetStreamingBudget() >> 20);
+                    if (ImGui::SliderInt("Budget (MB)", &budgetMB, 0, 4096, budgetMB == 0 ? "Unlimited" : "%d")) {
+                        TextureManager::GetInstance().SetStreamingBudget((size_t)budgetMB << 20);
+                    }
+                    StreamingStats streamingStats = TextureManager::GetInstance().GetStreamingStats();
+                    ImGui::Text("Resident: %.1f MB / Requested: %.1f MB (%d textures)",
+                                streamingStats.residentBytes / (1024.0 * 1024.0),
+                                streamingStats.requestedBytes / (1024.0 * 1024.0), streamingStats.textureCount);
+                    ImGui::Text("Pending: %d  Loads: %d  Evictions: %d",
+                                streamingStats.pendingLoads, streamingStats.loadCount, streamingStats.evictCount);
+                } else {
+                    ImGui::Text("Disabled (full mip chains)");
+                }
+
                 ImGui::Separator();
                 ImGui::Text("Resolution Settings");
 
@@ -1107,35 +1001,23 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
                 ImGui::Separator();
 
                 // 通用Actor创建lambda
+                // 网格上传录制到本帧命令列表（位于本帧渲染命令之前）
                 auto CreateActorFromMesh = [&](const std::wstring& meshPath, const std::string& prefix, int& counter) {
-                    WaitForCompletionOfCommandList();
-                    commandAllocator->Reset();
-                    commandList->Reset(commandAllocator, nullptr);
-
                     counter++;
                     std::string actorName = prefix + "_" + std::to_string(counter);
                     Actor* newActor = new Actor(actorName);
-                    newActor->CreateConstantBuffer(gD3D12Device);
                     newActor->SetPosition(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f));
                     newActor->SetRotation(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f));
                     newActor->SetScale(DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f));
 
                     if (newActor->LoadFromMeshFile(meshPath)) {
-                        const MeshAssetInfo& meshInfo = newActor->GetMeshAssetInfo();
-                        std::wstring fbxPath = GetEnginePath();
-                        fbxPath += std::wstring(meshInfo.fbxPath.begin(), meshInfo.fbxPath.end());
-                        std::string fbxPathAnsi(fbxPath.begin(), fbxPath.end());
-
-                        StaticMeshComponent* mesh = new StaticMeshComponent();
-                        mesh->InitFromFile(commandList, fbxPathAnsi.c_str());
+                        StaticMeshComponent* mesh = MeshManager::GetInstance().Acquire(newActor->GetMeshAssetInfo(), commandList);
                         newActor->SetMesh(mesh);
 
                         MaterialInstance* defaultMaterial = MaterialManager::GetInstance().GetMaterial("DefaultPBR");
                         if (defaultMaterial) newActor->SetMaterial(defaultMaterial);
 
-                        g_scene->GetActors().push_back(newActor);
-                        EndCommandList();
-                        WaitForCompletionOfCommandList();
+                        g_scene->AddActor(newActor);
                     } else {
                         char msg[128];
                         sprintf_s(msg, "Failed to load %s", prefix.c_str());
@@ -1168,6 +1050,97 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             // Scene窗口 - 显示Actor列表
             if (showSceneWindow) {
                 ImGui::Begin("Scene", &showSceneWindow);
+
+                bool frustumCulling = g_scene->IsFrustumCullingEnabled();
+                if (ImGui::Checkbox("Frustum Culling", &frustumCulling)) {
+                    g_scene->SetFrustumCullingEnabled(frustumCulling);
+                }
+                ImGui::SameLine();
+                bool instancing = g_scene->IsInstancingEnabled();
+                if (ImGui::Checkbox("Instancing", &instancing)) {
+                    g_scene->SetInstancingEnabled(instancing);
+                }
+                ImGui::SameLine();
+                bool spatialIndex = g_scene->IsSpatialIndexEnabled();
+                if (ImGui::Checkbox("Spatial Index", &spatialIndex)) {
+                    g_scene->SetSpatialIndexEnabled(spatialIndex);
+                }
+                const CullingStats& cullingStats = g_scene->GetCullingStats();
+                ImGui::Text("Visible: %d / %d  Shadow: %d / %d  (%.3f ms)",
+                    cullingStats.cameraVisibleCount, cullingStats.totalCount,
+                    cullingStats.shadowVisibleCount, cullingStats.totalCount, cullingStats.cullTimeMs);
+                const DrawSubmitStats& drawStats = g_scene->GetDrawStats();
+                ImGui::Text("BasePass: %d draws (%d instances), %d state changes, %d eliminated (build %.3f ms)",
+                    drawStats.drawCount, drawStats.instanceCount, drawStats.GetStateChanges(), drawStats.GetEliminated(),
+                    drawStats.sortTimeMs);
+                ImGui::Text("Shadow: %d draws (%d instances)",
+                    (int)g_scene->GetShadowBatches().size(), (int)g_scene->GetShadowDrawList().GetCount());
+                ImGui::Text("  PSO %d (-%d)  Material %d (-%d)  VB %d (-%d)",
+                    drawStats.pipelineSets, drawStats.pipelineSkipped,
+                    drawStats.materialSets, drawStats.materialSkipped,
+                    drawStats.vertexBufferSets, drawStats.vertexBufferSkipped);
+                const LinearUploadAllocator& uploadAllocator = LinearUploadAllocator::GetInstance();
+                ImGui::Text("Upload ring: %.1f KB/frame (peak %.1f KB) of %.1f KB, %d frames in flight",
+                    uploadAllocator.GetFrameUsage() / 1024.0, uploadAllocator.GetPeakFrameUsage() / 1024.0,
+                    uploadAllocator.GetCapacity() / 1024.0, uploadAllocator.GetFramesInFlight());
+                ImGui::Text("Frame: %.2f ms, CPU waited %.2f ms for GPU (%d frames in flight)",
+                    io.DeltaTime * 1000.0f, GetFrameWaitTimeMs(), (int)kFramesInFlight);
+                const ShaderBytecodeCache& shaderCache = ShaderBytecodeCache::GetInstance();
+                ImGui::Text("Shader cache: %d hits, %d compiled (%.0f ms), %d entries, %d include files",
+                    shaderCache.GetHitCount(), shaderCache.GetMissCount(),
+                    shaderCache.GetCompileTimeMs(), (int)shaderCache.GetEntryCount(),
+                    (int)shaderCache.GetIncludeFileCount());
+                const PipelineStateCache& psoCache = PipelineStateCache::GetInstance();
+                ImGui::Text("PSO cache: %d hits, %d from library, %d created (%.0f ms), %d entries, %d evicted%s",
+                    psoCache.GetHitCount(), psoCache.GetLibraryHitCount(), psoCache.GetMissCount(),
+                    psoCache.GetCreateTimeMs(), (int)psoCache.GetEntryCount(), psoCache.GetEvictCount(),
+                    psoCache.HasLibrary() ? "" : " (no library)");
+                const ShaderCompileQueue& compileQueue = ShaderCompileQueue::GetInstance();
+                ImGui::Text("Shader compile: %u workers, %d jobs / %d batches pending, %d shared",
+                    compileQueue.GetWorkerCount(), compileQueue.GetPendingJobCount(), compileQueue.GetPendingBatchCount(),
+                    compileQueue.GetSharedJobCount());
+                const DynamicAABBTree& spatialTree = g_scene->GetSpatialIndex().GetTree();
+                ImGui::Text("AABB Tree: %d proxies, height %d", spatialTree.GetProxyCount(), spatialTree.GetHeight());
+
+                // 动态AABB树与暴力遍历对比（随机包围盒，不影响场景）
+                static SpatialBenchmarkResult spatialBenchmarks[3];
+                static bool spatialBenchmarkDone = false;
+                if (ImGui::Button("Run Spatial Index Benchmark")) {
+                    const int actorCounts[3] = { 1000, 10000, 100000 };
+                    for (int i = 0; i < 3; ++i) {
+                        RunSpatialIndexBenchmark(actorCounts[i], spatialBenchmarks[i]);
+                    }
+                    spatialBenchmarkDone = true;
+                }
+                if (spatialBenchmarkDone) {
+                    for (const SpatialBenchmarkResult& result : spatialBenchmarks) {
+                        ImGui::Text("%d boxes (height %d)%s", result.actorCount, result.treeHeight,
+                            result.resultsMatch ? "" : "  MISMATCH");
+                        ImGui::Text("  Build %.2f ms  Rebuild %.2f ms  Update(1%%) %.3f ms",
+                            result.treeBuildMs, result.treeRebuildMs, result.treeUpdateMs);
+                        ImGui::Text("  Frustum %.3f / %.3f ms  Ray %.4f / %.4f ms  AABB %.4f / %.4f ms (brute / tree)",
+                            result.bruteFrustumMs, result.treeFrustumMs, result.bruteRayMs, result.treeRayMs,
+                            result.bruteAABBMs, result.treeAABBMs);
+                    }
+                }
+
+                // 引擎块压缩编码器：每种格式和质量档位在合成图像上的吞吐量与PSNR（BC6H为色调映射后的PSNR）
+                static std::vector<BlockEncoderBenchmarkResult> blockEncoderBenchmarks;
+                if (ImGui::Button("Run Block Encoder Benchmark")) {
+                    RunBlockEncoderBenchmark(1024, blockEncoderBenchmarks);
+                }
+                if (!blockEncoderBenchmarks.empty()) {
+                    const char* formatNames[] = { "BC1", "BC3", "BC5", "BC7", "BC6H" };
+                    const char* qualityNames[] = { "Fast", "Normal", "High", "Ultra" };
+                    ImGui::Text("%ux%u", blockEncoderBenchmarks[0].width, blockEncoderBenchmarks[0].height);
+                    for (const BlockEncoderBenchmarkResult& result : blockEncoderBenchmarks) {
+                        ImGui::Text("  %-4s %-6s %8.1f ms %7.2f Mpix/s %6.2f dB",
+                            formatNames[(int)result.format], qualityNames[(int)result.quality],
+                            result.encodeMs, result.megapixelsPerSecond, result.psnr);
+                    }
+                }
+                ImGui::Separator();
+
                 ImGui::Text("Scene Actors:");
                 ImGui::Separator();
 
@@ -1294,6 +1267,217 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
                 }
             }
 
+
+            DWORD current_time = timeGetTime();
+            float deltaTime = (current_time - last_time) / 1000.0f;
+            last_time = current_time;
+            // TAA: 在帧开始时更新Jitter（必须在场景渲染之前）
+            if (taaPass->IsEnabled()) {
+                taaPass->UpdateJitter();
+                XMFLOAT2 jitter = taaPass->GetJitterOffset();
+                g_scene->SetJitterOffset(jitter.x, jitter.y);
+            } else {
+                g_scene->SetJitterOffset(0.0f, 0.0f);
+            }
+
+            g_scene->Update(deltaTime);  // 更新Scene（计算LiSPSM矩阵）
+
+            // 场景常量缓冲每帧重新分配，各Pass使用本帧地址
+            D3D12_GPU_VIRTUAL_ADDRESS sceneCBAddress = g_scene->GetSceneCBAddress();
+            lightPass->SetSceneConstantBuffer(sceneCBAddress);
+            screenPass->SetSceneConstantBuffer(sceneCBAddress);
+            skyPass->SetSceneConstantBuffer(sceneCBAddress);
+            taaPass->SetSceneConstantBuffer(sceneCBAddress);
+            gtaoPass->SetSceneConstantBuffer(sceneCBAddress);
+            ssgiPass->SetSceneConstantBuffer(sceneCBAddress);
+
+            //BasePass=======================================
+            // 使用StandardPBR Pass 0（GBuffer填充）
+            // 每帧重新获取：热重载替换Pass后旧PSO随旧Pass释放，不能沿用启动时取到的指针
+            gbufferPso = standardShader->GetPSO(0);
+            if (gbufferPso) {
+                commandList->SetPipelineState(gbufferPso);
+            }
+            commandList->BeginEvent(0, L"BasePass", (UINT)(wcslen(L"BasePass")* sizeof(wchar_t)));
+            BeginOffscreen(commandList);
+            ID3D12DescriptorHeap* srvHeaps[] = { srvHeap};
+            commandList->SetDescriptorHeaps(_countof(srvHeaps), srvHeaps);
+            g_scene->Render(commandList, gbufferPso, rootSignature);
+            commandList->EndEvent();
+
+            //LightPass=======================================
+            // 执行LightPass（包含Shadow Map生成和光照计算）
+            // 只有在shadowmap开启时才执行
+            if (g_scene->IsShadowmapEnabled()) {
+                commandList->SetPipelineState(shadowPso);
+                commandList->BeginEvent(0, L"LightPass", (UINT)(wcslen(L"LightPass") * sizeof(wchar_t)));
+                int shadowMode = g_scene->GetShadowMode();
+                ID3D12PipelineState* lightPso = lightPsos[(shadowMode >= 0 && shadowMode < 3) ? shadowMode : 2];
+                lightPass->RenderDirectLight(commandList, shadowPso, lightPso, rootSignature, g_scene, gDSRT);
+                commandList->EndEvent();
+            }
+
+            //GtaoPass=======================================
+            // 执行GTAO（在LightPass之后、SkyPass之前）
+            if (gtaoPass->IsEnabled()) {
+                commandList->SetPipelineState(gtaoPso);
+                commandList->BeginEvent(0, L"GtaoPass", (UINT)(wcslen(L"GtaoPass") * sizeof(wchar_t)));
+
+                // 注意：深度缓冲在BasePass的Scene::Render末尾已经被转为PIXEL_SHADER_RESOURCE
+                // LightPass使用后状态不变，所以这里直接使用即可
+
+                auto& gtaoSceneRTs = g_scene->m_offscreenRTs;
+                gtaoPass->Render(commandList, gtaoPso, gtaoBlurPso, rootSignature,
+                    gDSRT,              // 深度缓冲（已经是PIXEL_SHADER_RESOURCE状态）
+                    gtaoSceneRTs[1]);   // 法线RT (GBuffer RT1，已经是PIXEL_SHADER_RESOURCE状态)
+
+                commandList->EndEvent();
+            }
+
+            //SsgiPass=======================================
+            // 执行SSGI（在GTAO之后、SkyPass之前）
+            if (ssgiPass->IsEnabled()) {
+                commandList->SetPipelineState(ssgiDepthPso);
+                commandList->BeginEvent(0, L"SsgiPass", (UINT)(wcslen(L"SsgiPass") * sizeof(wchar_t)));
+
+                auto& ssgiSceneRTs = g_scene->m_offscreenRTs;
+                ssgiPass->Render(commandList,
+                    ssgiDepthPso,
+                    ssgiPso,
+                    ssgiUpsamplePso,
+                    ssgiBlurHPso,
+                    ssgiBlurVPso,
+                    rootSignature,
+                    gDSRT,
+                    ssgiSceneRTs[0],   // BaseColor RT
+                    ssgiSceneRTs[1],   // Normal RT
+                    ssgiSceneRTs[3]);  // Velocity RT (Motion Vector)
+
+                commandList->EndEvent();
+            }
+
+            //SkyPass=======================================
+            // 执行SkyPass（渲染天空球，在ScreenPass之前）
+            // 当TAA启用时，渲染到中间RT；否则渲染到交换链
+            if (skyPso) {
+                commandList->SetPipelineState(skyPso);
+                commandList->BeginEvent(0, L"SkyPass", (UINT)(wcslen(L"SkyPass") * sizeof(wchar_t)));
+
+                if (taaPass->IsEnabled()) {
+                    // TAA启用：渲染到中间RT
+                    D3D12_CPU_DESCRIPTOR_HANDLE intermediateRTV = taaPass->GetIntermediateRTV();
+                    float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+                    commandList->ClearRenderTargetView(intermediateRTV, clearColor, 0, nullptr);
+                    commandList->OMSetRenderTargets(1, &intermediateRTV, FALSE, nullptr);
+
+                    // 设置视口和裁剪矩形（使用TaaPass的当前分辨率）
+                    int currentWidth = taaPass->GetViewportWidth();
+                    int currentHeight = taaPass->GetViewportHeight();
+                    D3D12_VIEWPORT viewport = { 0, 0, (float)currentWidth, (float)currentHeight, 0.0f, 1.0f };
+                    D3D12_RECT scissorRect = { 0, 0, currentWidth, currentHeight };
+                    commandList->RSSetViewports(1, &viewport);
+                    commandList->RSSetScissorRects(1, &scissorRect);
+                } else {
+                    // TAA禁用：渲染到交换链
+                    BeginRenderToSwapChain(commandList, true, false);
+                }
+
+                ComPtr<ID3D12Resource> skyTextureForSky = g_scene->ReturnSkyCube();
+                skyPass->Render(commandList, skyPso, rootSignature, skyTextureForSky);
+
+                if (!taaPass->IsEnabled()) {
+                    EndRenderToSwapChain(commandList);
+                }
+
+                commandList->EndEvent();
+            }
+
+            //ScreenPass======================================
+            // 延迟光照按全局关键字（_SSGI）选择变体，变体编译完成前使用默认变体
+            deferredLightingPso = standardShader->GetVariantPSO(1, standardShader->GetVariantKey());
+            commandList->SetPipelineState(deferredLightingPso);
+            commandList->BeginEvent(0, L"ScreenPass", (UINT)(wcslen(L"ScreenPass") * sizeof(wchar_t)));
+
+            if (taaPass->IsEnabled()) {
+                // TAA启用：渲染到中间RT（不清空，保留SkyPass的结果）
+                D3D12_CPU_DESCRIPTOR_HANDLE intermediateRTV = taaPass->GetIntermediateRTV();
+                commandList->OMSetRenderTargets(1, &intermediateRTV, FALSE, nullptr);
+
+                // 设置视口和裁剪矩形（使用TaaPass的当前分辨率）
+                int currentWidth = taaPass->GetViewportWidth();
+                int currentHeight = taaPass->GetViewportHeight();
+                D3D12_VIEWPORT viewport = { 0, 0, (float)currentWidth, (float)currentHeight, 0.0f, 1.0f };
+                D3D12_RECT scissorRect = { 0, 0, currentWidth, currentHeight };
+                commandList->RSSetViewports(1, &viewport);
+                commandList->RSSetScissorRects(1, &scissorRect);
+            } else {
+                // TAA禁用：渲染到交换链
+                BeginRenderToSwapChain(commandList, false, false);
+            }
+
+            auto& sceneRTs = g_scene->m_offscreenRTs;
+            ComPtr<ID3D12Resource> skyTexture = g_scene->ReturnSkyCube();
+            // 渲染（使用深度缓冲代替Position RT，传入LightPass的阴影图和GTAO纹理）
+            // GetAOTexture() 在GTAO关闭时会返回默认白色纹理（AO=1，无遮蔽）
+            // 当shadowmap关闭时，传入nullptr，ScreenPass会使用白色纹理
+            screenPass->Render(commandList, deferredLightingPso, rootSignature,
+                sceneRTs[0], sceneRTs[1], sceneRTs[2],  // 3个GBuffer RT
+                gDSRT,  // 深度缓冲用于位置重构
+                skyTexture,
+                g_scene->IsShadowmapEnabled() ? lightPass->GetLightRT() : nullptr,  // shadowmap关闭时传nullptr
+                gtaoPass->GetAOTexture(),  // GTAO输出（关闭时为白色纹理）
+                ssgiPass->GetSSGITexture());  // SSGI输出（关闭时为黑色纹理）
+
+            // 将深度缓冲转换回DEPTH_WRITE状态，供下一帧和BeginRenderToSwapChain使用
+            D3D12_RESOURCE_BARRIER depthBarrier = {};
+            depthBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            depthBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+            depthBarrier.Transition.pResource = gDSRT;
+            depthBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+            depthBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_DEPTH_WRITE;
+            depthBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+            commandList->ResourceBarrier(1, &depthBarrier);
+
+            if (!taaPass->IsEnabled()) {
+                EndRenderToSwapChain(commandList);
+            }
+
+            commandList->EndEvent();
+
+            // TAA Pass
+            if (taaPass->IsEnabled()) {
+                commandList->SetPipelineState(taaPso);
+                commandList->BeginEvent(0, L"TaaPass", (UINT)(wcslen(L"TaaPass") * sizeof(wchar_t)));
+
+                // 获取Motion Vector RT
+                ID3D12Resource* motionVectorRT = g_scene->GetMotionVectorRT();
+
+                // 执行TAA（从中间RT读取，输出到历史缓冲）
+                taaPass->RenderToSwapChain(commandList, taaPso, rootSignature,
+                    motionVectorRT, gDSRT, GetCurrentSwapChainRTV());
+
+                commandList->EndEvent();
+
+                // 复制TAA结果到交换链
+                commandList->SetPipelineState(taaCopyPso);
+                commandList->BeginEvent(0, L"TaaCopy", (UINT)(wcslen(L"TaaCopy") * sizeof(wchar_t)));
+
+                BeginRenderToSwapChain(commandList, true, false);
+                taaPass->CopyToSwapChain(commandList, taaCopyPso, rootSignature, GetCurrentSwapChainRTV());
+                EndRenderToSwapChain(commandList);
+
+                commandList->EndEvent();
+
+                // 在帧结束时更新上一帧的 VP 矩阵
+                g_scene->UpdatePreviousViewProjectionMatrix();
+
+                // 交换历史缓冲
+                taaPass->SwapHistoryBuffers();
+            }
+
+            //UiPass==========================================
+            commandList->SetPipelineState(UiPso);
+            commandList->BeginEvent(0, L"UIPass", (UINT)(wcslen(L"UIPass") * sizeof(wchar_t)));
             ImGui::Render();
             BeginRenderToSwapChain(commandList, false);
             ID3D12DescriptorHeap* ppHeaps[] = { gImGuiDescriptorHeap };
@@ -1302,12 +1486,20 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 
             EndRenderToSwapChain(commandList);
             commandList->EndEvent();
-            EndCommandList();
+            EndFrame();
+            // 本帧的上传分配在本帧提交完成后才能复用
+            LinearUploadAllocator::GetInstance().EndFrame(GetSubmittedFenceValue());
             SwapD3D12Buffers();
         }
     }
 
+    // 等待所有在途帧执行完成后再释放资源
+    ResourceManager::GetInstance().StopHotReload();
+    WaitForCompletionOfCommandList();
+
     delete g_scene;
+    MeshManager::GetInstance().Shutdown();
+    LinearUploadAllocator::GetInstance().Shutdown();
     delete g_materialEditor;
     delete gtaoPass;
     delete ssgiPass;
@@ -1317,10 +1509,15 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     TextureCompressor::GetInstance().Shutdown();
     TextureManager::GetInstance().Shutdown();
 
+    ShaderCompileQueue::GetInstance().Shutdown();
     MaterialManager::GetInstance().Shutdown();
+    ShaderBytecodeCache::GetInstance().Shutdown();
+    PipelineStateCache::GetInstance().Shutdown();
     ShutdownImGui();
     BasePso->Release();
-    lightPso->Release();
+    for (ID3D12PipelineState* pso : lightPsos) {
+        pso->Release();
+    }
     screenPso->Release();  // 保留原有的screenPso清理
     UiPso->Release();
     // StandardPBR的PSO由Shader类管理，在MaterialManager::Shutdown()中会自动清理
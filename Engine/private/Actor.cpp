@@ -1,6 +1,8 @@
 // Actor.cpp
 #include "public/Actor.h"
 #include "public/StaticMeshComponent.h"
+#include "public/Mesh/MeshManager.h"
+#include "public/SpatialIndex.h"
 #include <fstream>
 #include <sstream>
 
@@ -24,6 +26,22 @@ XMMATRIX Transform::GetModelMatrix() const {
 }
 
 // ============ MeshAssetInfo实现 ============
+std::string MeshAssetInfo::GetMeshBinPath() const {
+    if (!meshBinPath.empty()) {
+        return meshBinPath;
+    }
+    if (fbxPath.empty()) {
+        return "";
+    }
+
+    size_t dotPos = fbxPath.find_last_of('.');
+    size_t slashPos = fbxPath.find_last_of("\\/");
+    if (dotPos == std::string::npos || (slashPos != std::string::npos && dotPos < slashPos)) {
+        return fbxPath + ".meshbin";
+    }
+    return fbxPath.substr(0, dotPos) + ".meshbin";
+}
+
 bool MeshAssetInfo::SaveToFile(const std::wstring& filepath) const {
     std::ofstream file(filepath);
     if (!file.is_open()) {
@@ -34,6 +52,9 @@ bool MeshAssetInfo::SaveToFile(const std::wstring& filepath) const {
     file << "[MeshAsset]\n";
     file << "Name=" << meshName << "\n";
     file << "FBXPath=" << fbxPath << "\n";
+    if (!meshBinPath.empty()) {
+        file << "MeshBinPath=" << meshBinPath << "\n";
+    }
     file << "DefaultMaterial=" << defaultMaterial << "\n";
 
     file.close();
@@ -83,6 +104,8 @@ bool MeshAssetInfo::LoadFromFile(const std::wstring& filepath) {
                 meshName = value;
             } else if (key == "FBXPath") {
                 fbxPath = value;
+            } else if (key == "MeshBinPath") {
+                meshBinPath = value;
             } else if (key == "DefaultMaterial") {
                 defaultMaterial = value;
             }
@@ -94,8 +117,8 @@ bool MeshAssetInfo::LoadFromFile(const std::wstring& filepath) {
     // Debug output
     OutputDebugStringA("MeshAssetInfo loaded successfully:\n");
     char msg[512];
-    sprintf_s(msg, "  Name: %s\n  FBXPath: %s\n  DefaultMaterial: %s\n",
-              meshName.c_str(), fbxPath.c_str(), defaultMaterial.c_str());
+    sprintf_s(msg, "  Name: %s\n  FBXPath: %s\n  MeshBinPath: %s\n  DefaultMaterial: %s\n",
+              meshName.c_str(), fbxPath.c_str(), GetMeshBinPath().c_str(), defaultMaterial.c_str());
     OutputDebugStringA(msg);
 
     return true;
@@ -106,24 +129,28 @@ Actor::Actor(const std::string& name)
     : m_name(name),
       m_mesh(nullptr),
       m_material(nullptr),
-      m_constantBuffer(nullptr),
-      m_mappedConstantBuffer(nullptr),
       m_isSelected(false) {
-    memset(&m_cbData, 0, sizeof(m_cbData));
 }
 
 Actor::~Actor() {
-    // 注意：mesh和material通常由外部管理，这里不删除
+    if (m_spatialIndex) {
+        m_spatialIndex->Remove(this);
+    }
 
-    // 清理Constant Buffer
-    if (m_constantBuffer) {
-        if (m_mappedConstantBuffer) {
-            m_constantBuffer->Unmap(0, nullptr);
-            m_mappedConstantBuffer = nullptr;
-        }
-        m_constantBuffer->Release();
-        m_constantBuffer = nullptr;
+    // mesh来自共享网格缓存，这里只释放引用；material由MaterialManager管理
+    MeshManager::GetInstance().Release(m_mesh);
+    m_mesh = nullptr;
+}
+
+void Actor::SetMesh(StaticMeshComponent* mesh) {
+    if (mesh == m_mesh) {
+        // 调用方已为同一网格多取了一次引用
+        MeshManager::GetInstance().Release(mesh);
+        return;
     }
+    MeshManager::GetInstance().Release(m_mesh);
+    m_mesh = mesh;
+    OnBoundsChanged();
 }
 
 bool Actor::LoadFromMeshFile(const std::wstring& meshFilePath) {
@@ -140,18 +167,22 @@ bool Actor::LoadFromMeshFile(const std::wstring& meshFilePath) {
 
 void Actor::SetTransform(const Transform& transform) {
     m_transform = transform;
+    OnBoundsChanged();
 }
 
 void Actor::SetPosition(const XMFLOAT3& pos) {
     m_transform.position = pos;
+    OnBoundsChanged();
 }
 
 void Actor::SetRotation(const XMFLOAT3& rot) {
     m_transform.rotation = rot;
+    OnBoundsChanged();
 }
 
 void Actor::SetScale(const XMFLOAT3& scale) {
     m_transform.scale = scale;
+    OnBoundsChanged();
 }
 
 void Actor::UpdateModelMatrix() {
@@ -162,61 +193,84 @@ XMMATRIX Actor::GetModelMatrix() const {
     return m_transform.GetModelMatrix();
 }
 
-void Actor::CreateConstantBuffer(ID3D12Device* device) {
-    if (!device) return;
+void Actor::OnBoundsChanged() {
+    m_worldBoundsDirty = true;
+    if (m_spatialIndex && !m_spatialDirty) {
+        m_spatialIndex->MarkDirty(this);
+    }
+}
 
-    // 使用已有工具函数创建CB
-    m_constantBuffer = CreateConstantBufferObject(sizeof(SceneCBData));
-    if (!m_constantBuffer) {
-        OutputDebugStringA("Actor::CreateConstantBuffer - Failed to create CB\n");
-        return;
+const MeshBounds& Actor::GetWorldBounds() {
+    if (m_worldBoundsDirty) {
+        UpdateWorldBounds();
     }
+    return m_worldBounds;
+}
+
+void Actor::UpdateWorldBounds() {
+    m_worldBoundsDirty = false;
 
-    // 持久映射
-    HRESULT hr = m_constantBuffer->Map(0, nullptr, &m_mappedConstantBuffer);
-    if (FAILED(hr)) {
-        OutputDebugStringA("Actor::CreateConstantBuffer - Failed to map CB\n");
-        m_constantBuffer->Release();
-        m_constantBuffer = nullptr;
+    if (!m_mesh) {
+        // 没有Mesh时退化为位置上的一个点
+        const XMFLOAT3& pos = m_transform.position;
+        float p[3] = { pos.x, pos.y, pos.z };
+        for (int i = 0; i < 3; ++i) {
+            m_worldBounds.min[i] = m_worldBounds.max[i] = m_worldBounds.center[i] = p[i];
+        }
+        m_worldBounds.radius = 0.0f;
         return;
     }
 
-    // 初始化CB：用单位矩阵填充关键矩阵字段
-    memset(&m_cbData, 0, sizeof(m_cbData));
-    DirectX::XMMATRIX identity = DirectX::XMMatrixIdentity();
-    DirectX::XMStoreFloat4x4(&m_cbData.projMatrix, identity);
-    DirectX::XMStoreFloat4x4(&m_cbData.viewMatrix, identity);
-    DirectX::XMStoreFloat4x4(&m_cbData.modelMatrix, identity);
-    DirectX::XMStoreFloat4x4(&m_cbData.normalMatrix, identity);
-
-    memcpy(m_mappedConstantBuffer, &m_cbData, sizeof(SceneCBData));
-}
-
-void Actor::UpdateConstantBuffer(const DirectX::XMMATRIX& viewMatrix, const DirectX::XMMATRIX& projMatrix,
-                                  const DirectX::XMFLOAT3& lightDir, const DirectX::XMFLOAT3& cameraPos,
-                                  float skylightIntensity, const DirectX::XMFLOAT3& skylightColor,
-                                  const DirectX::XMMATRIX& invProjMatrix, const DirectX::XMMATRIX& invViewMatrix,
-                                  const DirectX::XMMATRIX& lightViewProjMatrix,
-                                  const DirectX::XMMATRIX& previousViewProjMatrix,
-                                  const DirectX::XMFLOAT2& jitterOffset, const DirectX::XMFLOAT2& previousJitterOffset,
-                                  int viewportWidth, int viewportHeight,
-                                  float nearPlane, float farPlane,
-                                  const DirectX::XMMATRIX& currentViewProjMatrix,
-                                  int shadowMode,
-                                  int giType) {
-    if (!m_mappedConstantBuffer) return;
-
-    // 使用共享函数填充CB（Actor使用自己的ModelMatrix）
-    FillSceneCBData(m_cbData,
-        viewMatrix, projMatrix, GetModelMatrix(),
-        lightDir, cameraPos,
-        skylightIntensity, skylightColor,
-        invProjMatrix, invViewMatrix,
-        lightViewProjMatrix, previousViewProjMatrix,
-        jitterOffset, previousJitterOffset,
-        viewportWidth, viewportHeight,
-        nearPlane, farPlane,
-        currentViewProjMatrix, shadowMode, giType);
-
-    memcpy(m_mappedConstantBuffer, &m_cbData, sizeof(SceneCBData));
+    const MeshBounds& local = m_mesh->mBounds;
+    XMFLOAT4X4 m;
+    XMStoreFloat4x4(&m, m_transform.GetModelMatrix());
+
+    // 行向量约定：p' = p * M。AABB中心直接变换，半长取|M|的3x3部分变换（Arvo）
+    float localCenter[3], localExtent[3];
+    for (int i = 0; i < 3; ++i) {
+        localCenter[i] = (local.min[i] + local.max[i]) * 0.5f;
+        localExtent[i] = (local.max[i] - local.min[i]) * 0.5f;
+    }
+
+    float maxScaleSq = 0.0f;
+    for (int j = 0; j < 3; ++j) {
+        float center = m.m[3][j];
+        float extent = 0.0f;
+        float sphereCenter = m.m[3][j];
+        for (int i = 0; i < 3; ++i) {
+            center += localCenter[i] * m.m[i][j];
+            extent += localExtent[i] * fabsf(m.m[i][j]);
+            sphereCenter += local.center[i] * m.m[i][j];
+        }
+        m_worldBounds.min[j] = center - extent;
+        m_worldBounds.max[j] = center + extent;
+        m_worldBounds.center[j] = sphereCenter;
+
+        float rowLengthSq = m.m[j][0] * m.m[j][0] + m.m[j][1] * m.m[j][1] + m.m[j][2] * m.m[j][2];
+        if (rowLengthSq > maxScaleSq) maxScaleSq = rowLengthSq;
+    }
+    // 包围球半径按最大轴缩放放大
+    m_worldBounds.radius = local.radius * sqrtf(maxScaleSq);
+}
+
+void Actor::UpdateInstanceData(uint64_t frameIndex) {
+    XMMATRIX modelMatrix = GetModelMatrix();
+
+    // 上一帧更新过才有上一帧数据；第一次更新或重新变为可见时，不可见期间的移动不计入Motion Vector，视为静止
+    if (m_instanceDataFrame != 0 && m_instanceDataFrame + 1 == frameIndex) {
+        m_instanceData.prevModelMatrix = m_instanceData.modelMatrix;
+    } else {
+        XMStoreFloat4x4(&m_instanceData.prevModelMatrix, modelMatrix);
+    }
+    m_instanceDataFrame = frameIndex;
+    XMStoreFloat4x4(&m_instanceData.modelMatrix, modelMatrix);
+
+    // NormalMatrix = transpose(inverse(model))，与FillSceneCBData一致
+    XMVECTOR determinant;
+    XMMATRIX invModel = XMMatrixInverse(&determinant, modelMatrix);
+    if (XMVectorGetX(determinant) != 0.0f) {
+        XMStoreFloat4x4(&m_instanceData.normalMatrix, XMMatrixTranspose(invModel));
+    } else {
+        XMStoreFloat4x4(&m_instanceData.normalMatrix, XMMatrixIdentity());
+    }
 }
@@ -0,0 +1,146 @@
+// AssetBin.cpp
+// 烘焙资产通用读写
+
+#include "public/AssetBin.h"
+#include "public/HashUtils.h"
+#include "public/PathUtils.h"
+#include <cstddef>
+#include <fstream>
+
+namespace {
+    // 单个字符串长度上限（防止损坏的文件导致超大分配）
+    constexpr uint32_t kMaxStringLength = 64 * 1024;
+}
+
+bool QueryAssetSourceInfo(const std::wstring& sourcePath, bool computeHash, AssetSourceInfo& outInfo) {
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExW(sourcePath.c_str(), GetFileExInfoStandard, &attributes)) {
+        return false;
+    }
+
+    outInfo.size = ((uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+    outInfo.writeTime = ((uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32) |
+                        attributes.ftLastWriteTime.dwLowDateTime;
+    outInfo.hash = 0;
+
+    if (computeHash) {
+        return HashFileXXH64(sourcePath, outInfo.hash);
+    }
+    return true;
+}
+
+bool ReadAssetBinHeader(const std::wstring& binPath, uint32_t magic, uint32_t version, AssetBinHeader& outHeader) {
+    std::ifstream file(binPath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.read(reinterpret_cast<char*>(&outHeader), sizeof(outHeader));
+    return file.gcount() == sizeof(outHeader) && outHeader.magic == magic && outHeader.version == version;
+}
+
+bool IsAssetBinUpToDate(const std::wstring& sourcePath, const std::wstring& binPath, uint32_t magic, uint32_t version) {
+    AssetBinHeader header;
+    const bool hasBin = ReadAssetBinHeader(binPath, magic, version, header);
+
+    AssetSourceInfo current;
+    if (!QueryAssetSourceInfo(sourcePath, false, current)) {
+        return hasBin;
+    }
+    if (!hasBin) {
+        return false;
+    }
+    if (header.source.size == current.size && header.source.writeTime == current.writeTime) {
+        return true;
+    }
+
+    // 时间戳变了但内容可能没变（例如重新检出），比较内容哈希
+    if (header.source.size == current.size && HashFileXXH64(sourcePath, current.hash) &&
+        current.hash == header.source.hash) {
+        std::fstream file(binPath, std::ios::binary | std::ios::in | std::ios::out);
+        if (file.is_open()) {
+            file.seekp(offsetof(AssetBinHeader, source));
+            file.write(reinterpret_cast<const char*>(&current), sizeof(current));
+        }
+        return true;
+    }
+    return false;
+}
+
+// ========== 写出 ==========
+
+void AssetBinWriter::WriteString(const std::string& str) {
+    Write((uint32_t)str.size());
+    m_payload.insert(m_payload.end(), str.begin(), str.end());
+}
+
+void AssetBinWriter::WriteWString(const std::wstring& str) {
+    WriteString(WToA(str));
+}
+
+bool AssetBinWriter::Save(const std::wstring& filePath, uint32_t magic, uint32_t version, const AssetSourceInfo& source) const {
+    AssetBinHeader header = {};
+    header.magic = magic;
+    header.version = version;
+    header.payloadSize = m_payload.size();
+    header.source = source;
+
+    const FileChunk chunks[] = {
+        { &header, sizeof(header) },
+        { m_payload.data(), m_payload.size() },
+    };
+    return WriteFileAtomic(filePath, chunks, _countof(chunks));
+}
+
+// ========== 读取 ==========
+
+bool AssetBinReader::Open(const std::wstring& filePath, uint32_t magic, uint32_t version) {
+    m_payload.clear();
+    m_cursor = 0;
+    m_failed = true;
+
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    const uint64_t fileSize = (uint64_t)file.tellg();
+    file.seekg(0);
+
+    file.read(reinterpret_cast<char*>(&m_header), sizeof(m_header));
+    if (file.gcount() != sizeof(m_header) || m_header.magic != magic || m_header.version != version ||
+        m_header.payloadSize != fileSize - sizeof(m_header)) {
+        return false;
+    }
+
+    m_payload.resize((size_t)m_header.payloadSize);
+    file.read(reinterpret_cast<char*>(m_payload.data()), (std::streamsize)m_payload.size());
+    if ((uint64_t)file.gcount() != m_header.payloadSize) {
+        m_payload.clear();
+        return false;
+    }
+
+    m_failed = false;
+    return true;
+}
+
+bool AssetBinReader::ReadString(std::string& outStr) {
+    uint32_t length = 0;
+    if (!Read(length)) {
+        return false;
+    }
+    if (length > kMaxStringLength || m_payload.size() - m_cursor < length) {
+        m_failed = true;
+        return false;
+    }
+    outStr.assign(reinterpret_cast<const char*>(m_payload.data() + m_cursor), length);
+    m_cursor += length;
+    return true;
+}
+
+bool AssetBinReader::ReadWString(std::wstring& outStr) {
+    std::string utf8;
+    if (!ReadString(utf8)) {
+        return false;
+    }
+    outStr = AToW(utf8);
+    return true;
+}
@@ -1,9 +1,12 @@
 #include "public\BattleFireDirect.h"
+#include "public\Material\ShaderBytecodeCache.h"
+#include "public\PipelineStateCache.h"
 #include "imgui.h"
 #include "imgui_impl_win32.h"
 #include "imgui_impl_dx12.h"
 #include <d3dx12.h>
 #include <array>
+#include <chrono>
 #include <wrl.h>
 
 ID3D12Device* gD3D12Device = nullptr;
@@ -21,6 +24,15 @@ ID3D12Fence* gFence = nullptr;
 HANDLE gFenceEvent = nullptr;
 UINT64 gFenceValue = 0;
 
+// 帧上下文：每帧独立的命令分配器 + 该帧提交时的栅栏值
+struct FrameContext {
+    ID3D12CommandAllocator* commandAllocator = nullptr;
+    UINT64 fenceValue = 0;
+};
+FrameContext gFrameContexts[kFramesInFlight];
+UINT gFrameIndex = 0;
+double gFrameWaitTimeMs = 0.0;
+
 // 当前渲染分辨率
 int gRenderWidth = 1280;
 int gRenderHeight = 720;
@@ -94,7 +106,7 @@ ID3D12RootSignature* InitRootSignature() {
     srvRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
     // 根参数
-    D3D12_ROOT_PARAMETER1 rootParameters[3] = {};
+    D3D12_ROOT_PARAMETER1 rootParameters[4] = {};
 
     // Slot 0: Scene constant buffer (b0)
     rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
@@ -116,13 +128,20 @@ ID3D12RootSignature* InitRootSignature() {
     rootParameters[2].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
     rootParameters[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
 
+    // Slot 3: Instance data structured buffer (t0, space1) - 实例化绘制的逐实例矩阵
+    rootParameters[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    rootParameters[3].Descriptor.ShaderRegister = 0;
+    rootParameters[3].Descriptor.RegisterSpace = 1;
+    rootParameters[3].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE;
+    rootParameters[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
     // 静态采样器
     auto staticSamplers = GetStaticSamplers();
 
     // 根签名描述 - 版本1.1
     D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSigDesc = {};
     rootSigDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
-    rootSigDesc.Desc_1_1.NumParameters = 3;
+    rootSigDesc.Desc_1_1.NumParameters = 4;
     rootSigDesc.Desc_1_1.pParameters = rootParameters;
     rootSigDesc.Desc_1_1.NumStaticSamplers = static_cast<UINT>(staticSamplers.size());
     rootSigDesc.Desc_1_1.pStaticSamplers = staticSamplers.data();
@@ -145,12 +164,13 @@ ID3D12RootSignature* InitRootSignature() {
         srvRange10.RegisterSpace = 0;
         srvRange10.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
-        CD3DX12_ROOT_PARAMETER rootParams10[3];
+        CD3DX12_ROOT_PARAMETER rootParams10[4];
         rootParams10[0].InitAsConstantBufferView(0, 0, D3D12_SHADER_VISIBILITY_ALL);
         rootParams10[1].InitAsDescriptorTable(1, &srvRange10, D3D12_SHADER_VISIBILITY_PIXEL);
         rootParams10[2].InitAsConstantBufferView(1, 0, D3D12_SHADER_VISIBILITY_PIXEL);
+        rootParams10[3].InitAsShaderResourceView(0, 1, D3D12_SHADER_VISIBILITY_VERTEX);
 
-        CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc10(3, rootParams10,
+        CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc10(4, rootParams10,
             static_cast<UINT>(staticSamplers.size()),
             staticSamplers.data(),
             D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
@@ -168,6 +188,9 @@ ID3D12RootSignature* InitRootSignature() {
     ID3D12RootSignature* rootSignature = nullptr;
     gD3D12Device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(),
         IID_PPV_ARGS(&rootSignature));
+    // 按序列化内容登记，PSO缓存跨进程才能命中
+    PipelineStateCache::GetInstance().RegisterRootSignature(rootSignature,
+        signature->GetBufferPointer(), signature->GetBufferSize());
 
     if (signature) signature->Release();
 
@@ -178,15 +201,19 @@ void CreateShaderFromFile(
     LPCTSTR inShaderFilePath,
     const char* inMainFunctionName,
     const char* inTarget,
-    D3D12_SHADER_BYTECODE* inShader) {
+    D3D12_SHADER_BYTECODE* inShader,
+    const D3D_SHADER_MACRO* inDefines) {
     ID3DBlob* shaderBuffer = nullptr;
     ID3DBlob* errorBuffer = nullptr;
-    HRESULT hResult = D3DCompileFromFile(inShaderFilePath, nullptr, nullptr,
-        inMainFunctionName, inTarget, D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
-        0, &shaderBuffer, &errorBuffer);
+    HRESULT hResult = ShaderBytecodeCache::GetInstance().CompileFromFile(inShaderFilePath, inDefines,
+        inMainFunctionName, inTarget, ShaderBytecodeCache::GetDefaultCompileFlags(),
+        &shaderBuffer, &errorBuffer);
     if (FAILED(hResult)) {
-        printf("CreateShaderFromFile error : [%s][%s]:[%s]\n", inMainFunctionName, inTarget, (char*)errorBuffer->GetBufferPointer());
-        errorBuffer->Release();
+        printf("CreateShaderFromFile error : [%s][%s]:[%s]\n", inMainFunctionName, inTarget,
+            errorBuffer ? (char*)errorBuffer->GetBufferPointer() : "file not found");
+        if (errorBuffer) errorBuffer->Release();
+        inShader->pShaderBytecode = nullptr;
+        inShader->BytecodeLength = 0;
         return;
     }
     inShader->pShaderBytecode = shaderBuffer->GetBufferPointer();
@@ -297,7 +324,7 @@ ID3D12PipelineState* CreateScenePSO(ID3D12RootSignature* inID3D12RootSignature,
 
     // ����PSO
     ID3D12PipelineState* d3d12PSO = nullptr;
-    HRESULT hResult = gD3D12Device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&d3d12PSO));
+    HRESULT hResult = PipelineStateCache::GetInstance().CreateGraphicsPipelineState(gD3D12Device, psoDesc, &d3d12PSO);
     if (FAILED(hResult)) {
         return nullptr;
     }
@@ -432,6 +459,9 @@ bool InitD3D12(HWND inHWND, int inWidth, int inHeight) {
 
     gD3D12Device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&gCommandAllocator));
     gD3D12Device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, gCommandAllocator, nullptr, IID_PPV_ARGS(&gCommandList));
+    for (UINT i = 0; i < kFramesInFlight; i++) {
+        gD3D12Device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&gFrameContexts[i].commandAllocator));
+    }
 
     gD3D12Device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&gFence));
     gFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
@@ -466,6 +496,21 @@ void FlushGPU() {
     }
 }
 
+UINT64 GetSubmittedFenceValue() {
+    return gFenceValue;
+}
+
+UINT64 GetCompletedFenceValue() {
+    return gFence->GetCompletedValue();
+}
+
+void WaitForFenceValue(UINT64 fenceValue) {
+    if (gFence->GetCompletedValue() < fenceValue) {
+        gFence->SetEventOnCompletion(fenceValue, gFenceEvent);
+        WaitForSingleObject(gFenceEvent, INFINITE);
+    }
+}
+
 void EndCommandList() {
     gCommandList->Close();
     ID3D12CommandList* ppCommandLists[] = { gCommandList };
@@ -473,6 +518,34 @@ void EndCommandList() {
     gFenceValue += 1;
     gCommandQueue->Signal(gFence, gFenceValue);
 }
+
+ID3D12GraphicsCommandList* BeginFrame(ID3D12PipelineState* inInitialPSO) {
+    FrameContext& frame = gFrameContexts[gFrameIndex];
+
+    auto waitStart = std::chrono::high_resolution_clock::now();
+    WaitForFenceValue(frame.fenceValue);
+    auto waitEnd = std::chrono::high_resolution_clock::now();
+    gFrameWaitTimeMs = std::chrono::duration<double, std::milli>(waitEnd - waitStart).count();
+
+    frame.commandAllocator->Reset();
+    gCommandList->Reset(frame.commandAllocator, inInitialPSO);
+    return gCommandList;
+}
+
+void EndFrame() {
+    EndCommandList();
+    gFrameContexts[gFrameIndex].fenceValue = gFenceValue;
+    gFrameIndex = (gFrameIndex + 1) % kFramesInFlight;
+}
+
+UINT GetFrameIndex() {
+    return gFrameIndex;
+}
+
+double GetFrameWaitTimeMs() {
+    return gFrameWaitTimeMs;
+}
+
 void BeginOffscreen(ID3D12GraphicsCommandList* commandList) {
     D3D12_VIEWPORT viewport = { 0.0f, 0.0f, static_cast<float>(gRenderWidth), static_cast<float>(gRenderHeight), 0.0f, 1.0f };
     D3D12_RECT scissorRect = { 0, 0, gRenderWidth, gRenderHeight };
@@ -620,7 +693,7 @@ void InitImGui(HWND hWnd, ID3D12Device* device, ID3D12DescriptorHeap* srvHeap, U
     ImGui_ImplWin32_Init(hWnd);
     ImGui_ImplDX12_Init(
         device,
-        2, // ����������������
+        kFramesInFlight, // 与帧上下文数量一致，ImGui按帧轮换顶点/索引缓冲
         DXGI_FORMAT_R8G8B8A8_UNORM,
         srvHeap,
         srvHeap->GetCPUDescriptorHandleForHeapStart(),
@@ -885,7 +958,7 @@ ID3D12PipelineState* CreateFullscreenPSO(
     psoDesc.SampleDesc.Quality = 0;
 
     ID3D12PipelineState* pso = nullptr;
-    HRESULT hr = gD3D12Device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pso));
+    HRESULT hr = PipelineStateCache::GetInstance().CreateGraphicsPipelineState(gD3D12Device, psoDesc, &pso);
     if (FAILED(hr)) {
         char errorMsg[256];
         sprintf_s(errorMsg, "CreateFullscreenPSO failed: HRESULT 0x%08X\n", hr);
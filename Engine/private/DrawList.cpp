@@ -0,0 +1,180 @@
+// DrawList.cpp
+// 绘制列表排序与状态去重实现
+
+#include "public/DrawList.h"
+#include <cstring>
+
+void DrawList::Reset() {
+    m_packets.clear();
+    m_pipelineIds.clear();
+    m_materialIds.clear();
+    m_meshIds.clear();
+}
+
+void DrawList::Add(const void* pipelineState, const void* material, const void* mesh, float depth01, void* userData) {
+    DrawPacket packet;
+    packet.pipelineState = pipelineState;
+    packet.material = material;
+    packet.mesh = mesh;
+    packet.userData = userData;
+    packet.sortKey = MakeSortKey(Intern(m_pipelineIds, pipelineState, PipelineBits),
+                                 Intern(m_materialIds, material, MaterialBits),
+                                 Intern(m_meshIds, mesh, MeshBits),
+                                 QuantizeDepth(depth01));
+    m_packets.push_back(packet);
+}
+
+void DrawList::Sort() {
+    m_scratch.resize(m_packets.size());
+    RadixSort(m_packets.data(), m_scratch.data(), m_packets.size());
+}
+
+void DrawList::BuildBatches(std::vector<DrawBatch>& outBatches, uint32_t maxBatchSize) const {
+    outBatches.clear();
+    for (uint32_t i = 0; i < (uint32_t)m_packets.size(); ++i) {
+        const DrawPacket& packet = m_packets[i];
+        if (!outBatches.empty()) {
+            DrawBatch& batch = outBatches.back();
+            const DrawPacket& first = m_packets[batch.firstPacket];
+            bool sameState = first.pipelineState == packet.pipelineState &&
+                             first.material == packet.material &&
+                             first.mesh == packet.mesh;
+            if (sameState && (maxBatchSize == 0 || batch.packetCount < maxBatchSize)) {
+                batch.packetCount++;
+                continue;
+            }
+        }
+
+        DrawBatch batch;
+        batch.firstPacket = i;
+        batch.packetCount = 1;
+        batch.firstInstance = i;
+        outBatches.push_back(batch);
+    }
+}
+
+uint64_t DrawList::MakeSortKey(uint32_t pipelineId, uint32_t materialId, uint32_t meshId, uint32_t depthBucket) {
+    const uint64_t pipelineMask = (1ull << PipelineBits) - 1;
+    const uint64_t materialMask = (1ull << MaterialBits) - 1;
+    const uint64_t meshMask = (1ull << MeshBits) - 1;
+    const uint64_t depthMask = (1ull << DepthBits) - 1;
+
+    return ((pipelineId & pipelineMask) << (MaterialBits + MeshBits + DepthBits)) |
+           ((materialId & materialMask) << (MeshBits + DepthBits)) |
+           ((meshId & meshMask) << DepthBits) |
+           (depthBucket & depthMask);
+}
+
+uint32_t DrawList::QuantizeDepth(float depth01) {
+    if (!(depth01 > 0.0f)) return 0;  // 同时处理NaN
+    if (depth01 >= 1.0f) return (1u << DepthBits) - 1;
+    return (uint32_t)(depth01 * (float)((1u << DepthBits) - 1));
+}
+
+uint32_t DrawList::Intern(std::unordered_map<const void*, uint32_t>& ids, const void* handle, int bits) {
+    auto it = ids.find(handle);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    const uint32_t maxId = (1u << bits) - 1;
+    uint32_t id = (uint32_t)ids.size();
+    if (id > maxId) id = maxId;
+    ids.emplace(handle, id);
+    return id;
+}
+
+void DrawList::RadixSort(DrawPacket* packets, DrawPacket* scratch, size_t count) {
+    if (count < 2) return;
+
+    // 一次遍历统计8个字节的直方图
+    uint32_t histograms[8][256];
+    memset(histograms, 0, sizeof(histograms));
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t key = packets[i].sortKey;
+        for (int pass = 0; pass < 8; ++pass) {
+            histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    DrawPacket* source = packets;
+    DrawPacket* dest = scratch;
+    for (int pass = 0; pass < 8; ++pass) {
+        uint32_t* histogram = histograms[pass];
+
+        // 所有键在该字节上相同，本趟不改变顺序
+        uint8_t firstByte = (uint8_t)((source[0].sortKey >> (pass * 8)) & 0xFF);
+        if (histogram[firstByte] == count) continue;
+
+        uint32_t offset = 0;
+        for (int bucket = 0; bucket < 256; ++bucket) {
+            uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            uint8_t byte = (uint8_t)((source[i].sortKey >> (pass * 8)) & 0xFF);
+            dest[histogram[byte]++] = source[i];
+        }
+
+        DrawPacket* temp = source;
+        source = dest;
+        dest = temp;
+    }
+
+    // 有效趟数为奇数时结果在scratch中
+    if (source != packets) {
+        memcpy(packets, source, sizeof(DrawPacket) * count);
+    }
+}
+
+// ========== DrawStateCache ==========
+
+void DrawStateCache::Reset() {
+    m_pipelineState = nullptr;
+    m_material = nullptr;
+    m_objectConstants = 0;
+    m_vertexBuffer = nullptr;
+    m_stats = DrawSubmitStats();
+}
+
+bool DrawStateCache::SetPipelineState(const void* pipelineState) {
+    if (pipelineState == m_pipelineState) {
+        m_stats.pipelineSkipped++;
+        return false;
+    }
+    m_pipelineState = pipelineState;
+    m_stats.pipelineSets++;
+    return true;
+}
+
+bool DrawStateCache::SetMaterial(const void* material) {
+    if (material == m_material) {
+        m_stats.materialSkipped++;
+        return false;
+    }
+    m_material = material;
+    m_stats.materialSets++;
+    return true;
+}
+
+bool DrawStateCache::SetObjectConstants(uint64_t gpuAddress) {
+    if (gpuAddress == m_objectConstants) {
+        m_stats.objectCBSkipped++;
+        return false;
+    }
+    m_objectConstants = gpuAddress;
+    m_stats.objectCBSets++;
+    return true;
+}
+
+bool DrawStateCache::SetVertexBuffer(const void* mesh) {
+    if (mesh == m_vertexBuffer) {
+        m_stats.vertexBufferSkipped++;
+        return false;
+    }
+    m_vertexBuffer = mesh;
+    m_stats.vertexBufferSets++;
+    return true;
+}
@@ -0,0 +1,164 @@
+// FileWatcher.cpp
+// 文件变更监视实现
+
+#include "public/FileWatcher.h"
+#include "public/PathUtils.h"
+#include <iostream>
+
+namespace {
+    // 每个目录的通知缓冲区（网络路径上ReadDirectoryChangesW最大只支持64KB）
+    constexpr DWORD kNotifyBufferSize = 64 * 1024;
+    constexpr DWORD kNotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+}
+
+FileWatcher::~FileWatcher() {
+    Stop();
+}
+
+bool FileWatcher::Start(const std::vector<std::wstring>& directories) {
+    Stop();
+
+    for (const std::wstring& path : directories) {
+        HANDLE handle = CreateFileW(path.c_str(), FILE_LIST_DIRECTORY,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                    OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            std::cout << "FileWatcher: cannot watch " << WToA(path) << std::endl;
+            continue;
+        }
+
+        WatchedDirectory directory;
+        directory.path = path;
+        directory.handle = handle;
+        directory.overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        directory.buffer.resize(kNotifyBufferSize / sizeof(DWORD));
+        m_directories.push_back(std::move(directory));
+    }
+
+    // WaitForMultipleObjects最多等待64个句柄，其中一个是停止事件
+    if (m_directories.size() > MAXIMUM_WAIT_OBJECTS - 1) {
+        std::cout << "FileWatcher: too many directories, only the first " << (MAXIMUM_WAIT_OBJECTS - 1)
+                  << " are watched" << std::endl;
+        for (size_t i = MAXIMUM_WAIT_OBJECTS - 1; i < m_directories.size(); ++i) {
+            CloseHandle(m_directories[i].overlapped.hEvent);
+            CloseHandle(m_directories[i].handle);
+        }
+        m_directories.resize(MAXIMUM_WAIT_OBJECTS - 1);
+    }
+
+    if (m_directories.empty()) {
+        return false;
+    }
+
+    m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_thread = std::thread(&FileWatcher::WatchThread, this);
+    std::cout << "FileWatcher: watching " << m_directories.size() << " directories" << std::endl;
+    return true;
+}
+
+void FileWatcher::Stop() {
+    if (m_thread.joinable()) {
+        SetEvent(m_stopEvent);
+        m_thread.join();
+    }
+    if (m_stopEvent) {
+        CloseHandle(m_stopEvent);
+        m_stopEvent = nullptr;
+    }
+
+    for (WatchedDirectory& directory : m_directories) {
+        CloseHandle(directory.overlapped.hEvent);
+        CloseHandle(directory.handle);
+    }
+    m_directories.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pendingChanges.clear();
+}
+
+bool FileWatcher::PollChanges(std::vector<std::wstring>& outPaths) {
+    const auto now = std::chrono::steady_clock::now();
+    const auto debounce = std::chrono::milliseconds(m_debounceMs);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_pendingChanges.begin(); it != m_pendingChanges.end();) {
+        if (now - it->second >= debounce) {
+            outPaths.push_back(it->first);
+            it = m_pendingChanges.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return !outPaths.empty();
+}
+
+// ========== 监视线程 ==========
+
+bool FileWatcher::IssueRead(WatchedDirectory& directory) {
+    ResetEvent(directory.overlapped.hEvent);
+    BOOL ok = ReadDirectoryChangesW(directory.handle, directory.buffer.data(),
+                                    (DWORD)(directory.buffer.size() * sizeof(DWORD)), TRUE, kNotifyFilter,
+                                    nullptr, &directory.overlapped, nullptr);
+    directory.readPending = (ok != FALSE);
+    if (!ok) {
+        std::cout << "FileWatcher: ReadDirectoryChangesW failed for " << WToA(directory.path)
+                  << " (error " << GetLastError() << ")" << std::endl;
+    }
+    return ok != FALSE;
+}
+
+void FileWatcher::WatchThread() {
+    // 句柄0为停止事件，之后依次是各目录的重叠I/O事件
+    std::vector<HANDLE> waitHandles;
+    waitHandles.push_back(m_stopEvent);
+    for (WatchedDirectory& directory : m_directories) {
+        waitHandles.push_back(directory.overlapped.hEvent);
+        IssueRead(directory);
+    }
+
+    while (true) {
+        DWORD result = WaitForMultipleObjects((DWORD)waitHandles.size(), waitHandles.data(), FALSE, INFINITE);
+        if (result == WAIT_OBJECT_0 || result >= WAIT_OBJECT_0 + waitHandles.size()) {
+            break;  // 停止或等待失败
+        }
+
+        WatchedDirectory& directory = m_directories[result - WAIT_OBJECT_0 - 1];
+        DWORD bytes = 0;
+        if (GetOverlappedResult(directory.handle, &directory.overlapped, &bytes, FALSE)) {
+            if (bytes == 0) {
+                // 缓冲区溢出：这段时间的变更丢失，只能等下一次保存
+                std::cout << "FileWatcher: notification buffer overflow in " << WToA(directory.path)
+                          << ", some changes were dropped" << std::endl;
+            } else {
+                ParseNotifications(directory, bytes);
+            }
+        }
+        IssueRead(directory);   // 失败时事件保持未触发，该目录不再报告变更
+    }
+
+    // 取消本线程发起的重叠读取，等待取消完成后才能关闭句柄和释放缓冲区
+    for (WatchedDirectory& directory : m_directories) {
+        if (!directory.readPending) continue;
+        CancelIo(directory.handle);
+        DWORD bytes = 0;
+        GetOverlappedResult(directory.handle, &directory.overlapped, &bytes, TRUE);
+    }
+}
+
+void FileWatcher::ParseNotifications(const WatchedDirectory& directory, DWORD bytes) {
+    const auto now = std::chrono::steady_clock::now();
+    const BYTE* data = reinterpret_cast<const BYTE*>(directory.buffer.data());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DWORD offset = 0;
+    while (offset < bytes) {
+        const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(data + offset);
+        // 删除和改名前的旧名字不需要重新加载；"写临时文件再改名"的保存方式以新名字出现
+        if (info->Action != FILE_ACTION_REMOVED && info->Action != FILE_ACTION_RENAMED_OLD_NAME) {
+            std::wstring fileName(info->FileName, info->FileNameLength / sizeof(WCHAR));
+            m_pendingChanges[directory.path + fileName] = now;
+        }
+        if (info->NextEntryOffset == 0) break;
+        offset += info->NextEntryOffset;
+    }
+}
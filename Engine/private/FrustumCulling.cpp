@@ -0,0 +1,133 @@
+// FrustumCulling.cpp
+// 视锥剔除实现
+
+#include "public/FrustumCulling.h"
+#include "public/Actor.h"
+#include <emmintrin.h>
+#include <intrin.h>
+#include <cmath>
+
+using namespace DirectX;
+
+Frustum Frustum::FromViewProjection(const XMMATRIX& viewProj) {
+    // Gribb-Hartmann：行向量约定下，平面由矩阵的列组合得到
+    XMFLOAT4X4 m;
+    XMStoreFloat4x4(&m, viewProj);
+
+    Frustum frustum;
+    frustum.planes[0] = XMFLOAT4(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41);  // Left
+    frustum.planes[1] = XMFLOAT4(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41);  // Right
+    frustum.planes[2] = XMFLOAT4(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42);  // Bottom
+    frustum.planes[3] = XMFLOAT4(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42);  // Top
+    frustum.planes[4] = XMFLOAT4(m._13, m._23, m._33, m._43);                                  // Near (z >= 0)
+    frustum.planes[5] = XMFLOAT4(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43);  // Far
+
+    for (XMFLOAT4& plane : frustum.planes) {
+        float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) {
+            float invLength = 1.0f / length;
+            plane.x *= invLength;
+            plane.y *= invLength;
+            plane.z *= invLength;
+            plane.w *= invLength;
+        }
+    }
+    return frustum;
+}
+
+Frustum Frustum::FromShadowViewProjection(const XMMATRIX& lightViewProj) {
+    // 近平面换成恒在内侧的平面(0,0,0,1)，沿光源方向向光源一侧无限延伸
+    Frustum frustum = FromViewProjection(lightViewProj);
+    frustum.planes[4] = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+    return frustum;
+}
+
+void FrustumCuller::Gather(const std::vector<Actor*>& actors) {
+    m_actors.clear();
+    m_centerX.clear(); m_centerY.clear(); m_centerZ.clear();
+    m_extentX.clear(); m_extentY.clear(); m_extentZ.clear();
+
+    for (Actor* actor : actors) {
+        if (!actor || !actor->GetMesh()) continue;
+
+        const MeshBounds& bounds = actor->GetWorldBounds();
+        m_actors.push_back(actor);
+        m_centerX.push_back((bounds.min[0] + bounds.max[0]) * 0.5f);
+        m_centerY.push_back((bounds.min[1] + bounds.max[1]) * 0.5f);
+        m_centerZ.push_back((bounds.min[2] + bounds.max[2]) * 0.5f);
+        m_extentX.push_back((bounds.max[0] - bounds.min[0]) * 0.5f);
+        m_extentY.push_back((bounds.max[1] - bounds.min[1]) * 0.5f);
+        m_extentZ.push_back((bounds.max[2] - bounds.min[2]) * 0.5f);
+    }
+
+    // 补齐到4的倍数，补位的包围盒不会被输出
+    size_t padded = (m_actors.size() + 3) & ~(size_t)3;
+    m_centerX.resize(padded, 0.0f); m_centerY.resize(padded, 0.0f); m_centerZ.resize(padded, 0.0f);
+    m_extentX.resize(padded, 0.0f); m_extentY.resize(padded, 0.0f); m_extentZ.resize(padded, 0.0f);
+
+    m_visibilityMask.assign(m_actors.size(), 0);
+}
+
+void FrustumCuller::Cull(const Frustum& frustum, uint8_t viewBit, std::vector<Actor*>& outVisible) {
+    m_visibleIndices.clear();
+    CullSoA(frustum, m_centerX.data(), m_centerY.data(), m_centerZ.data(),
+            m_extentX.data(), m_extentY.data(), m_extentZ.data(), m_actors.size(), m_visibleIndices);
+
+    for (uint32_t index : m_visibleIndices) {
+        m_visibilityMask[index] |= viewBit;
+        outVisible.push_back(m_actors[index]);
+    }
+}
+
+void FrustumCuller::CullSoA(const Frustum& frustum,
+                            const float* centerX, const float* centerY, const float* centerZ,
+                            const float* extentX, const float* extentY, const float* extentZ,
+                            size_t count, std::vector<uint32_t>& outIndices) {
+    const size_t padded = (count + 3) & ~(size_t)3;
+
+    // 平面分量广播到4通道
+    __m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+    __m128 absPlaneX[6], absPlaneY[6], absPlaneZ[6];
+    for (int p = 0; p < 6; ++p) {
+        const XMFLOAT4& plane = frustum.planes[p];
+        planeX[p] = _mm_set1_ps(plane.x);
+        planeY[p] = _mm_set1_ps(plane.y);
+        planeZ[p] = _mm_set1_ps(plane.z);
+        planeW[p] = _mm_set1_ps(plane.w);
+        absPlaneX[p] = _mm_set1_ps(fabsf(plane.x));
+        absPlaneY[p] = _mm_set1_ps(fabsf(plane.y));
+        absPlaneZ[p] = _mm_set1_ps(fabsf(plane.z));
+    }
+    const __m128 zero = _mm_setzero_ps();
+
+    for (size_t i = 0; i < padded; i += 4) {
+        __m128 cx = _mm_loadu_ps(centerX + i);
+        __m128 cy = _mm_loadu_ps(centerY + i);
+        __m128 cz = _mm_loadu_ps(centerZ + i);
+        __m128 ex = _mm_loadu_ps(extentX + i);
+        __m128 ey = _mm_loadu_ps(extentY + i);
+        __m128 ez = _mm_loadu_ps(extentZ + i);
+
+        // AABB在平面法线上的投影半径 r = |n|·e；距离 d = n·c + w；d + r < 0 则完全在外侧
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, planeX[p]), _mm_mul_ps(cy, planeY[p])),
+                                  _mm_add_ps(_mm_mul_ps(cz, planeZ[p]), planeW[p]));
+            __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, absPlaneX[p]), _mm_mul_ps(ey, absPlaneY[p])),
+                                  _mm_mul_ps(ez, absPlaneZ[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(d, r), zero));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        while (mask) {
+            unsigned long lane;
+            _BitScanForward(&lane, (unsigned long)mask);
+            mask &= mask - 1;
+
+            size_t index = i + lane;
+            if (index < count) {
+                outIndices.push_back((uint32_t)index);
+            }
+        }
+    }
+}
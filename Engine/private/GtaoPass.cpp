@@ -1,4 +1,5 @@
 #include "public/GtaoPass.h"
+#include "public/UploadAllocator.h"
 #include <d3dx12.h>
 #include <stdexcept>
 #include <iostream>
@@ -16,7 +17,6 @@ bool GtaoPass::Initialize(int viewportWidth, int viewportHeight) {
 
     CreateRenderTargets();
     CreateSRVHeap();
-    CreateConstantBuffer();
 
     std::cout << "GtaoPass initialized: " << viewportWidth << "x" << viewportHeight << std::endl;
     return true;
@@ -102,21 +102,6 @@ void GtaoPass::CreateSRVHeap() {
     }
 }
 
-void GtaoPass::CreateConstantBuffer() {
-    UINT cbSize = (sizeof(GtaoConstants) + 255) & ~255;
-    CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
-    CD3DX12_RESOURCE_DESC bufDesc = CD3DX12_RESOURCE_DESC::Buffer(cbSize);
-
-    HRESULT hr = gD3D12Device->CreateCommittedResource(
-        &heapProps, D3D12_HEAP_FLAG_NONE, &bufDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-        IID_PPV_ARGS(&m_gtaoConstantBuffer));
-
-    if (FAILED(hr)) {
-        std::cout << "GtaoPass: Failed to create constant buffer" << std::endl;
-    }
-}
-
 void GtaoPass::UpdateConstants() {
     GtaoConstants constants = {};
     constants.resolution = XMFLOAT2(static_cast<float>(m_viewportWidth),
@@ -142,11 +127,8 @@ void GtaoPass::UpdateConstants() {
     constants.falloffStart = constants.aoRadius * 0.6f;
     constants.falloffEnd = constants.aoRadius;
 
-    UINT8* pData;
-    CD3DX12_RANGE readRange(0, 0);
-    m_gtaoConstantBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pData));
-    memcpy(pData, &constants, sizeof(GtaoConstants));
-    m_gtaoConstantBuffer->Unmap(0, nullptr);
+    // 每帧从上传环中分配，避免覆盖GPU仍在读取的上一帧常量
+    m_gtaoCBAddress = LinearUploadAllocator::GetInstance().AllocateConstants(&constants, sizeof(GtaoConstants));
 }
 
 void GtaoPass::CreateAOInputSRVs(ID3D12Resource* depthBuffer, ID3D12Resource* normalRT) {
@@ -236,13 +218,13 @@ void GtaoPass::Render(ID3D12GraphicsCommandList* cmdList,
         cmdList->SetPipelineState(gtaoPso);
 
         // 绑定场景常量缓冲区（b0）
-        if (m_sceneConstantBuffer) {
-            cmdList->SetGraphicsRootConstantBufferView(0, m_sceneConstantBuffer->GetGPUVirtualAddress());
+        if (m_sceneCBAddress) {
+            cmdList->SetGraphicsRootConstantBufferView(0, m_sceneCBAddress);
         }
 
         // 绑定GTAO常量缓冲区（b1，使用root parameter index 2）
         // 注意：root signature中 index 0 = b0(scene CB), index 1 = SRV table, index 2 = b1(material CB)
-        cmdList->SetGraphicsRootConstantBufferView(2, m_gtaoConstantBuffer->GetGPUVirtualAddress());
+        cmdList->SetGraphicsRootConstantBufferView(2, m_gtaoCBAddress);
 
         // 绑定SRV堆
         ID3D12DescriptorHeap* heaps[] = { m_aoSrvHeap.Get() };
@@ -290,8 +272,8 @@ void GtaoPass::Render(ID3D12GraphicsCommandList* cmdList,
         cmdList->SetPipelineState(blurPso);
 
         // 绑定场景常量缓冲区（b0）- Blur也需要分辨率信息
-        if (m_sceneConstantBuffer) {
-            cmdList->SetGraphicsRootConstantBufferView(0, m_sceneConstantBuffer->GetGPUVirtualAddress());
+        if (m_sceneCBAddress) {
+            cmdList->SetGraphicsRootConstantBufferView(0, m_sceneCBAddress);
         }
 
         // 绑定SRV堆
@@ -0,0 +1,191 @@
+// HashUtils.cpp
+// XXH64实现（按xxHash规范，小端）
+
+#include "public/HashUtils.h"
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t kPrime1 = 11400714785074694791ULL;
+constexpr uint64_t kPrime2 = 14029467366897019727ULL;
+constexpr uint64_t kPrime3 = 1609587929392839161ULL;
+constexpr uint64_t kPrime4 = 9650029242287828579ULL;
+constexpr uint64_t kPrime5 = 2870177450012600261ULL;
+
+inline uint64_t RotL64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t Read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t Read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = RotL64(acc, 31);
+    acc *= kPrime1;
+    return acc;
+}
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t val) {
+    val = Round(0, val);
+    acc ^= val;
+    acc = acc * kPrime1 + kPrime4;
+    return acc;
+}
+
+// 处理不足32字节的尾部并做最终混合
+uint64_t Finalize(uint64_t h64, const uint8_t* p, size_t len) {
+    while (len >= 8) {
+        h64 ^= Round(0, Read64(p));
+        h64 = RotL64(h64, 27) * kPrime1 + kPrime4;
+        p += 8;
+        len -= 8;
+    }
+    if (len >= 4) {
+        h64 ^= (uint64_t)Read32(p) * kPrime1;
+        h64 = RotL64(h64, 23) * kPrime2 + kPrime3;
+        p += 4;
+        len -= 4;
+    }
+    while (len > 0) {
+        h64 ^= (*p) * kPrime5;
+        h64 = RotL64(h64, 11) * kPrime1;
+        ++p;
+        --len;
+    }
+
+    h64 ^= h64 >> 33;
+    h64 *= kPrime2;
+    h64 ^= h64 >> 29;
+    h64 *= kPrime3;
+    h64 ^= h64 >> 32;
+    return h64;
+}
+
+} // namespace
+
+uint64_t HashXXH64(const void* data, size_t length, uint64_t seed) {
+    XXH64Hasher hasher(seed);
+    hasher.Update(data, length);
+    return hasher.Digest();
+}
+
+// ========== 流式XXH64 ==========
+
+XXH64Hasher::XXH64Hasher(uint64_t seed) {
+    Reset(seed);
+}
+
+void XXH64Hasher::Reset(uint64_t seed) {
+    m_seed = seed;
+    m_v[0] = seed + kPrime1 + kPrime2;
+    m_v[1] = seed + kPrime2;
+    m_v[2] = seed;
+    m_v[3] = seed - kPrime1;
+    m_totalLength = 0;
+    m_bufferSize = 0;
+}
+
+void XXH64Hasher::Update(const void* data, size_t length) {
+    if (!data || length == 0) {
+        return;
+    }
+
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + length;
+    m_totalLength += length;
+
+    // 先补满上次残留的缓冲
+    if (m_bufferSize + length < 32) {
+        memcpy(m_buffer + m_bufferSize, p, length);
+        m_bufferSize += length;
+        return;
+    }
+    if (m_bufferSize > 0) {
+        size_t fill = 32 - m_bufferSize;
+        memcpy(m_buffer + m_bufferSize, p, fill);
+        m_v[0] = Round(m_v[0], Read64(m_buffer));
+        m_v[1] = Round(m_v[1], Read64(m_buffer + 8));
+        m_v[2] = Round(m_v[2], Read64(m_buffer + 16));
+        m_v[3] = Round(m_v[3], Read64(m_buffer + 24));
+        p += fill;
+        m_bufferSize = 0;
+    }
+
+    // 32字节一组的主循环
+    while (p + 32 <= end) {
+        m_v[0] = Round(m_v[0], Read64(p));
+        m_v[1] = Round(m_v[1], Read64(p + 8));
+        m_v[2] = Round(m_v[2], Read64(p + 16));
+        m_v[3] = Round(m_v[3], Read64(p + 24));
+        p += 32;
+    }
+
+    if (p < end) {
+        m_bufferSize = (size_t)(end - p);
+        memcpy(m_buffer, p, m_bufferSize);
+    }
+}
+
+void XXH64Hasher::UpdateString(const char* text) {
+    if (!text) text = "";
+    Update(text, strlen(text) + 1);
+}
+
+uint64_t XXH64Hasher::Digest() const {
+    uint64_t h64;
+    if (m_totalLength >= 32) {
+        h64 = RotL64(m_v[0], 1) + RotL64(m_v[1], 7) + RotL64(m_v[2], 12) + RotL64(m_v[3], 18);
+        h64 = MergeRound(h64, m_v[0]);
+        h64 = MergeRound(h64, m_v[1]);
+        h64 = MergeRound(h64, m_v[2]);
+        h64 = MergeRound(h64, m_v[3]);
+    } else {
+        h64 = m_seed + kPrime5;
+    }
+    h64 += m_totalLength;
+    return Finalize(h64, m_buffer, m_bufferSize);
+}
+
+// ========== 文件哈希 ==========
+
+bool HashFileXXH64(const std::wstring& filePath, uint64_t& outHash) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    XXH64Hasher hasher;
+    std::vector<char> chunk(1 << 20);  // 1MB分块
+    while (file) {
+        file.read(chunk.data(), (std::streamsize)chunk.size());
+        std::streamsize readBytes = file.gcount();
+        if (readBytes > 0) {
+            hasher.Update(chunk.data(), (size_t)readBytes);
+        }
+    }
+
+    outHash = hasher.Digest();
+    return true;
+}
+
+std::string HashToHexString(uint64_t hash) {
+    static const char* kHexDigits = "0123456789abcdef";
+    std::string result(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        result[i] = kHexDigits[hash & 0xF];
+        hash >>= 4;
+    }
+    return result;
+}
@@ -2,6 +2,7 @@
 // IBL 资源管理类实现
 
 #include "public/IBLResources.h"
+#include "public/Material/ShaderBytecodeCache.h"
 #include <d3dx12.h>
 #include <d3dcompiler.h>
 #include <stdexcept>
@@ -57,15 +58,14 @@ bool IBLResources::Initialize(ID3D12GraphicsCommandList* commandList,
 }
 
 bool IBLResources::CompileComputeShaders() {
-    UINT compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+    UINT compileFlags = ShaderBytecodeCache::GetDefaultCompileFlags();
     ComPtr<ID3DBlob> errorBlob;
 
     // 编译 BRDF LUT 计算着色器
-    HRESULT hr = D3DCompileFromFile(
-        L"Engine/Shader/IBL/BRDFIntegration.hlsl",
-        nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE,
+    HRESULT hr = ShaderBytecodeCache::GetInstance().CompileFromFile(
+        L"Engine/Shader/IBL/BRDFIntegration.hlsl", nullptr,
         "CSMain", "cs_5_0",
-        compileFlags, 0,
+        compileFlags,
         &m_brdfShaderBlob, &errorBlob
     );
     if (FAILED(hr)) {
@@ -76,11 +76,10 @@ bool IBLResources::CompileComputeShaders() {
     }
 
     // 编译辐照度卷积计算着色器
-    hr = D3DCompileFromFile(
-        L"Engine/Shader/IBL/IrradianceConvolution.hlsl",
-        nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE,
+    hr = ShaderBytecodeCache::GetInstance().CompileFromFile(
+        L"Engine/Shader/IBL/IrradianceConvolution.hlsl", nullptr,
         "CSMain", "cs_5_0",
-        compileFlags, 0,
+        compileFlags,
         &m_irradianceShaderBlob, &errorBlob
     );
     if (FAILED(hr)) {
@@ -91,11 +90,10 @@ bool IBLResources::CompileComputeShaders() {
     }
 
     // 编译预过滤环境贴图计算着色器
-    hr = D3DCompileFromFile(
-        L"Engine/Shader/IBL/PrefilterEnvMap.hlsl",
-        nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE,
+    hr = ShaderBytecodeCache::GetInstance().CompileFromFile(
+        L"Engine/Shader/IBL/PrefilterEnvMap.hlsl", nullptr,
         "CSMain", "cs_5_0",
-        compileFlags, 0,
+        compileFlags,
         &m_prefilterShaderBlob, &errorBlob
     );
     if (FAILED(hr)) {
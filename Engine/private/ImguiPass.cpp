@@ -1,4 +1,5 @@
 #include "public\ImguiPass.h"
+#include "public\PipelineStateCache.h"
 #include "imgui.h"
 #include "imgui_impl_win32.h"
 #include "imgui_impl_dx12.h"
@@ -59,7 +60,7 @@ ID3D12PipelineState* CreateUiPSO(ID3D12RootSignature* inID3D12RootSignature,
 
     // ״̬
     ID3D12PipelineState* d3d12PSO = nullptr;
-    HRESULT hResult = gD3D12Device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&d3d12PSO));
+    HRESULT hResult = PipelineStateCache::GetInstance().CreateGraphicsPipelineState(gD3D12Device, psoDesc, &d3d12PSO);
     if (FAILED(hResult)) {
         return nullptr;
     }
@@ -3,6 +3,7 @@
 #include "public/Scene.h"
 #include "public/Actor.h"
 #include "public/StaticMeshComponent.h"
+#include "public/PipelineStateCache.h"
 #include <DirectXMath.h>
 #include <stdexcept>
 #include <d3dx12.h>
@@ -231,29 +232,23 @@ void LightPass::RenderShadowMap(ID3D12GraphicsCommandList* commandList,
     commandList->SetPipelineState(pso);
 
     // 绑定场景常量缓冲区
-    if (m_sceneConstantBuffer) {
-        commandList->SetGraphicsRootConstantBufferView(0, m_sceneConstantBuffer->GetGPUVirtualAddress());
+    if (m_sceneCBAddress) {
+        commandList->SetGraphicsRootConstantBufferView(0, m_sceneCBAddress);
     }
 
     // 设置图元拓扑
     commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    // 渲染所有Actor
-    std::vector<Actor*>& actors = scene->GetActors();
-    for (Actor* actor : actors) {
-        if (!actor) continue;
+    // 渲染阴影正交视锥内的Actor（Scene::Update中已剔除）
+    // 同一Mesh的投影者合并为一次实例化绘制，实例数据由Scene写入实例缓冲（Slot 3）
+    const DrawList& shadowDrawList = scene->GetShadowDrawList();
+    for (const DrawBatch& batch : scene->GetShadowBatches()) {
+        const DrawPacket& packet = shadowDrawList.GetPacket(batch.firstPacket);
+        StaticMeshComponent* mesh = const_cast<StaticMeshComponent*>(static_cast<const StaticMeshComponent*>(packet.mesh));
 
-        StaticMeshComponent* mesh = actor->GetMesh();
-        if (!mesh) continue;
-
-        // 绑定Actor的常量缓冲区
-        ID3D12Resource* actorCB = actor->GetConstantBuffer();
-        if (actorCB) {
-            commandList->SetGraphicsRootConstantBufferView(0, actorCB->GetGPUVirtualAddress());
-        }
-
-        // 渲染mesh
-        mesh->Render(commandList, rootSignature);
+        commandList->SetGraphicsRootShaderResourceView(3, scene->GetInstanceDataAddress(batch.firstInstance));
+        commandList->IASetVertexBuffers(0, 1, &mesh->mVBOView);
+        mesh->DrawSubMeshes(commandList, batch.packetCount);
     }
 
     // 转换Shadow Map状态为着色器资源
@@ -278,8 +273,8 @@ void LightPass::RenderLighting(ID3D12GraphicsCommandList* commandList,
     commandList->SetPipelineState(pso);
 
     // 绑定常量缓冲区
-    if (m_sceneConstantBuffer) {
-        commandList->SetGraphicsRootConstantBufferView(0, m_sceneConstantBuffer->GetGPUVirtualAddress());
+    if (m_sceneCBAddress) {
+        commandList->SetGraphicsRootConstantBufferView(0, m_sceneCBAddress);
     }
 
     // 绑定SRV描述符堆
@@ -378,6 +373,7 @@ ID3D12PipelineState* LightPass::CreateShadowPSO(ID3D12RootSignature* rootSignatu
 
     psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
     psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_FRONT;  // 渲染背面，减少自阴影伪影
+    psoDesc.RasterizerState.DepthClipEnable = FALSE;  // 光源近平面之前的投射者深度钳制到0，不被裁掉（剔除时也不测近平面）
     psoDesc.RasterizerState.FrontCounterClockwise = FALSE;
     psoDesc.RasterizerState.DepthBias = 5000;
     psoDesc.RasterizerState.DepthBiasClamp = 0.0f;
@@ -399,7 +395,7 @@ ID3D12PipelineState* LightPass::CreateShadowPSO(ID3D12RootSignature* rootSignatu
     psoDesc.SampleDesc.Count = 1;
 
     ID3D12PipelineState* pso = nullptr;
-    HRESULT hr = gD3D12Device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pso));
+    HRESULT hr = PipelineStateCache::GetInstance().CreateGraphicsPipelineState(gD3D12Device, psoDesc, &pso);
     if (FAILED(hr)) {
         OutputDebugStringA("LightPass::CreateShadowPSO - Failed to create PSO\n");
         return nullptr;
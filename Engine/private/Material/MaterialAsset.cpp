@@ -0,0 +1,308 @@
+// MaterialAsset.cpp
+// 材质资产读写：XML源文件解析（MSXML）与.matbin烘焙格式
+
+#include "public/Material/MaterialAsset.h"
+#include "public/AssetBin.h"
+#include "public/PathUtils.h"
+#include <iostream>
+#include <sstream>
+#include <comdef.h>
+#include <msxml6.h>
+
+#pragma comment(lib, "msxml6.lib")
+
+// 辅助函数声明（与Shader.cpp中相同）
+extern std::string BSTRToString(BSTR bstr);
+
+namespace {
+    // XML中的类型名 -> 参数类型，未知类型返回false
+    bool ParseParameterType(const std::string& typeName, ShaderParameterType& outType) {
+        if (typeName == "Float") outType = ShaderParameterType::Float;
+        else if (typeName == "Int") outType = ShaderParameterType::Int;
+        else if (typeName == "Bool") outType = ShaderParameterType::Bool;
+        else if (typeName == "Vector4") outType = ShaderParameterType::Vector4;
+        else if (typeName == "Vector3") outType = ShaderParameterType::Vector3;
+        else return false;
+        return true;
+    }
+
+    // 读取节点的某个属性文本
+    std::string GetAttributeText(IXMLDOMNode* node, const char* attributeName) {
+        std::string text;
+        IXMLDOMNamedNodeMap* pAttrs = nullptr;
+        node->get_attributes(&pAttrs);
+        if (pAttrs) {
+            IXMLDOMNode* pAttr = nullptr;
+            pAttrs->getNamedItem(_bstr_t(attributeName), &pAttr);
+            if (pAttr) {
+                BSTR val = nullptr;
+                pAttr->get_text(&val);
+                text = BSTRToString(val);
+                SysFreeString(val);
+                pAttr->Release();
+            }
+            pAttrs->Release();
+        }
+        return text;
+    }
+
+    // 对groupTag节点下每个名为itemTag的子节点调用callback
+    template <typename Callback>
+    void ForEachChild(IXMLDOMElement* pRoot, const char* groupTag, const char* itemTag, Callback callback) {
+        IXMLDOMNodeList* pGroups = nullptr;
+        pRoot->getElementsByTagName(_bstr_t(groupTag), &pGroups);
+        if (!pGroups) return;
+
+        IXMLDOMNode* pGroup = nullptr;
+        pGroups->get_item(0, &pGroup);
+        if (pGroup) {
+            IXMLDOMNodeList* pChildren = nullptr;
+            pGroup->get_childNodes(&pChildren);
+            if (pChildren) {
+                long count = 0;
+                pChildren->get_length(&count);
+                for (long i = 0; i < count; i++) {
+                    IXMLDOMNode* pChild = nullptr;
+                    pChildren->get_item(i, &pChild);
+                    if (!pChild) continue;
+
+                    BSTR nodeName = nullptr;
+                    pChild->get_nodeName(&nodeName);
+                    if (BSTRToString(nodeName) == itemTag) {
+                        callback(pChild);
+                    }
+                    SysFreeString(nodeName);
+                    pChild->Release();
+                }
+                pChildren->Release();
+            }
+            pGroup->Release();
+        }
+        pGroups->Release();
+    }
+}
+
+bool MaterialAsset::Load(const std::wstring& materialPath, MaterialAssetData& outData, bool* outCooked) {
+    if (outCooked) {
+        *outCooked = false;
+    }
+
+    const std::wstring binPath = GetBinPath(materialPath);
+    if (IsAssetBinUpToDate(materialPath, binPath, kMaterialBinMagic, kMaterialBinVersion) &&
+        ReadBin(binPath, outData)) {
+        return true;
+    }
+
+    outData = MaterialAssetData();
+    if (!ParseXML(materialPath, outData)) {
+        return false;
+    }
+    if (outCooked) {
+        *outCooked = true;
+    }
+    if (!WriteBin(binPath, outData, materialPath)) {
+        std::cout << "MaterialAsset: failed to write " << WToA(binPath) << std::endl;
+    }
+    return true;
+}
+
+bool MaterialAsset::Cook(const std::wstring& materialPath) {
+    MaterialAssetData data;
+    if (!ParseXML(materialPath, data)) {
+        std::cout << "MaterialAsset::Cook - Failed to parse " << WToA(materialPath) << std::endl;
+        return false;
+    }
+    const std::wstring binPath = GetBinPath(materialPath);
+    if (!WriteBin(binPath, data, materialPath)) {
+        std::cout << "MaterialAsset::Cook - Failed to write " << WToA(binPath) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::wstring MaterialAsset::GetBinPath(const std::wstring& materialPath) {
+    size_t dotPos = materialPath.find_last_of(L'.');
+    size_t slashPos = materialPath.find_last_of(L"\\/");
+    if (dotPos == std::wstring::npos || (slashPos != std::wstring::npos && dotPos < slashPos)) {
+        return materialPath + L".matbin";
+    }
+    return materialPath.substr(0, dotPos) + L".matbin";
+}
+
+// ========== 烘焙格式 ==========
+// 布局：AssetBinHeader | name | shaderName | uint32 参数数 | 参数[] | uint32 纹理数 | 纹理[]
+// 参数：name | uint8 type | float[4] | int32；纹理：name | path
+
+bool MaterialAsset::ReadBin(const std::wstring& binPath, MaterialAssetData& outData) {
+    AssetBinReader reader;
+    if (!reader.Open(binPath, kMaterialBinMagic, kMaterialBinVersion)) {
+        return false;
+    }
+
+    MaterialAssetData data;
+    reader.ReadString(data.name);
+    reader.ReadString(data.shaderName);
+
+    uint32_t parameterCount = 0;
+    reader.Read(parameterCount);
+    for (uint32_t i = 0; i < parameterCount; ++i) {
+        MaterialAssetParameter param;
+        uint8_t type = 0;
+        if (!reader.ReadString(param.name) || !reader.Read(type) || !reader.Read(param.values) ||
+            !reader.Read(param.intValue)) {
+            break;
+        }
+        // 损坏或过期的文件可能带有枚举范围外的类型，下游按类型计算CB布局时无法处理，回退到源文件
+        if (type > (uint8_t)ShaderParameterType::Matrix4x4) {
+            std::cout << "MaterialAsset: invalid parameter type " << (int)type << " in " << WToA(binPath) << std::endl;
+            return false;
+        }
+        param.type = (ShaderParameterType)type;
+        data.parameters.push_back(param);
+    }
+
+    uint32_t textureCount = 0;
+    reader.Read(textureCount);
+    for (uint32_t i = 0; i < textureCount; ++i) {
+        MaterialAssetTexture texture;
+        if (!reader.ReadString(texture.name) || !reader.ReadWString(texture.path)) {
+            break;
+        }
+        data.textures.push_back(texture);
+    }
+
+    if (!reader.IsComplete()) {
+        std::cout << "MaterialAsset: corrupt matbin " << WToA(binPath) << std::endl;
+        return false;
+    }
+    outData = std::move(data);
+    return true;
+}
+
+bool MaterialAsset::WriteBin(const std::wstring& binPath, const MaterialAssetData& data, const std::wstring& sourcePath) {
+    AssetSourceInfo source;
+    if (!QueryAssetSourceInfo(sourcePath, true, source)) {
+        return false;
+    }
+
+    AssetBinWriter writer;
+    writer.WriteString(data.name);
+    writer.WriteString(data.shaderName);
+
+    writer.Write((uint32_t)data.parameters.size());
+    for (const MaterialAssetParameter& param : data.parameters) {
+        writer.WriteString(param.name);
+        writer.Write((uint8_t)param.type);
+        writer.Write(param.values);
+        writer.Write(param.intValue);
+    }
+
+    writer.Write((uint32_t)data.textures.size());
+    for (const MaterialAssetTexture& texture : data.textures) {
+        writer.WriteString(texture.name);
+        writer.WriteWString(texture.path);
+    }
+
+    return writer.Save(binPath, kMaterialBinMagic, kMaterialBinVersion, source);
+}
+
+// ========== XML源文件 ==========
+
+bool MaterialAsset::ParseXML(const std::wstring& materialPath, MaterialAssetData& outData) {
+    // 初始化COM（工作线程上每次调用各自初始化）
+    HRESULT hr = CoInitialize(nullptr);
+    bool comInitialized = SUCCEEDED(hr);
+
+    // 创建XML文档对象
+    IXMLDOMDocument2* pXMLDom = nullptr;
+    hr = CoCreateInstance(__uuidof(DOMDocument60), nullptr, CLSCTX_INPROC_SERVER,
+                          __uuidof(IXMLDOMDocument2), (void**)&pXMLDom);
+    if (FAILED(hr)) {
+        if (comInitialized) CoUninitialize();
+        return false;
+    }
+
+    // 加载XML文件
+    VARIANT_BOOL loadSuccess = VARIANT_FALSE;
+    VARIANT var;
+    VariantInit(&var);
+    var.vt = VT_BSTR;
+    var.bstrVal = SysAllocString(materialPath.c_str());
+    hr = pXMLDom->load(var, &loadSuccess);
+    VariantClear(&var);
+
+    IXMLDOMElement* pRoot = nullptr;
+    if (loadSuccess == VARIANT_TRUE) {
+        pXMLDom->get_documentElement(&pRoot);
+    }
+    if (!pRoot) {
+        pXMLDom->Release();
+        if (comInitialized) CoUninitialize();
+        return false;
+    }
+
+    // 材质名称
+    VARIANT varName;
+    VariantInit(&varName);
+    pRoot->getAttribute(_bstr_t("name"), &varName);
+    if (varName.vt == VT_BSTR && varName.bstrVal) {
+        outData.name = BSTRToString(varName.bstrVal);
+    }
+    VariantClear(&varName);
+
+    // Shader节点（材质引用的shader名称，shader指针由MaterialManager解析）
+    IXMLDOMNodeList* pShaderNodes = nullptr;
+    pRoot->getElementsByTagName(_bstr_t("Shader"), &pShaderNodes);
+    if (pShaderNodes) {
+        IXMLDOMNode* pShaderNode = nullptr;
+        pShaderNodes->get_item(0, &pShaderNode);
+        if (pShaderNode) {
+            BSTR shaderText = nullptr;
+            pShaderNode->get_text(&shaderText);
+            if (shaderText) {
+                outData.shaderName = BSTRToString(shaderText);
+                SysFreeString(shaderText);
+            }
+            pShaderNode->Release();
+        }
+        pShaderNodes->Release();
+    }
+
+    // Parameters（值用istringstream解析：格式错误时得到0而不是抛异常，工作线程上不能抛出）
+    ForEachChild(pRoot, "Parameters", "Parameter", [&](IXMLDOMNode* pParam) {
+        MaterialAssetParameter param;
+        param.name = GetAttributeText(pParam, "name");
+        if (!ParseParameterType(GetAttributeText(pParam, "type"), param.type)) {
+            return;
+        }
+
+        BSTR nodeText = nullptr;
+        pParam->get_text(&nodeText);
+        std::istringstream iss(BSTRToString(nodeText));
+        SysFreeString(nodeText);
+
+        if (param.type == ShaderParameterType::Int || param.type == ShaderParameterType::Bool) {
+            iss >> param.intValue;
+        } else {
+            iss >> param.values[0] >> param.values[1] >> param.values[2] >> param.values[3];
+        }
+        outData.parameters.push_back(param);
+    });
+
+    // Textures
+    ForEachChild(pRoot, "Textures", "Texture", [&](IXMLDOMNode* pTex) {
+        MaterialAssetTexture texture;
+        texture.name = GetAttributeText(pTex, "name");
+
+        BSTR nodeText = nullptr;
+        pTex->get_text(&nodeText);
+        texture.path = AToW(BSTRToString(nodeText));
+        SysFreeString(nodeText);
+        outData.textures.push_back(texture);
+    });
+
+    pRoot->Release();
+    pXMLDom->Release();
+    if (comInitialized) CoUninitialize();
+    return true;
+}
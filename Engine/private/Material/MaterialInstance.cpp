@@ -1,19 +1,13 @@
 #include "public/Material/MaterialInstance.h"
+#include "public/Material/MaterialAsset.h"
 #include "public/BattleFireDirect.h"
 #include "public/Scene.h"
 #include "public/Texture/TextureManager.h"
 #include "public/Texture/TextureAsset.h"
+#include "public/PathUtils.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
-#include <comdef.h>
-#include <msxml6.h>
-
-#pragma comment(lib, "msxml6.lib")
-
-// 辅助函数声明（与Shader.cpp中相同）
-extern std::string BSTRToString(BSTR bstr);
-extern std::wstring BSTRToWString(BSTR bstr);
 
 MaterialInstance::MaterialInstance(const std::string& name, Shader* shader)
     : m_name(name)
@@ -21,16 +15,22 @@ MaterialInstance::MaterialInstance(const std::string& name, Shader* shader)
     , m_constantBuffer(nullptr)
     , m_constantBufferData(nullptr)
     , m_mappedConstantBuffer(nullptr)
+    , m_constantBufferSize(0)
     , m_isDirty(true)
+    , m_dirtyBegin(0)
+    , m_dirtyEnd(0)
     , m_texturesDirty(false)
     , m_hasPendingTextures(false)
+    , m_variantKey(0)
+    , m_variantKeyDirty(true)
+    , m_variantKeyGlobalVersion(0)
 {
     if (m_shader) {
         // 分配CPU端缓冲区
-        int bufferSize = m_shader->GetConstantBufferSize();
-        if (bufferSize > 0) {
-            m_constantBufferData = new unsigned char[bufferSize];
-            memset(m_constantBufferData, 0, bufferSize);
+        m_constantBufferSize = m_shader->GetConstantBufferSize();
+        if (m_constantBufferSize > 0) {
+            m_constantBufferData = new unsigned char[m_constantBufferSize];
+            memset(m_constantBufferData, 0, m_constantBufferSize);
         }
 
         // 初始化默认参数
@@ -54,45 +54,53 @@ void MaterialInstance::InitializeDefaultParameters() {
     if (!m_shader) return;
 
     const auto& parameters = m_shader->GetParameters();
-    for (const auto& param : parameters) {
+    m_texturePaths.assign(parameters.size(), std::wstring());
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        const ShaderParameter& param = parameters[i];
+        MaterialParameterHandle handle;
+        handle.index = (int)i;
+        handle.byteOffset = param.byteOffset;
+        handle.type = param.type;
+
         switch (param.type) {
             case ShaderParameterType::Float:
-                m_floatParams[param.name] = param.defaultValue.floatVal;
+                SetFloat(handle, param.defaultValue.floatVal);
                 break;
             case ShaderParameterType::Vector4:
-                m_vectorParams[param.name] = param.defaultValue.vector4Val;
+                SetVector(handle, param.defaultValue.vector4Val);
                 break;
             case ShaderParameterType::Vector3:
-                m_vector3Params[param.name] = param.defaultValue.vector3Val;
+                SetVector3(handle, param.defaultValue.vector3Val);
                 break;
             case ShaderParameterType::Int:
-                m_intParams[param.name] = param.defaultValue.intVal;
+                SetInt(handle, param.defaultValue.intVal);
                 break;
             case ShaderParameterType::Bool:
-                m_boolParams[param.name] = param.defaultValue.boolVal;
+                SetBool(handle, param.defaultValue.boolVal);
                 break;
             case ShaderParameterType::Texture2D:
-            case ShaderParameterType::TextureCube:
-                m_textureParams[param.name] = param.defaultTexturePath;
+            case ShaderParameterType::TextureCube: {
+                m_texturePaths[i] = param.defaultTexturePath;
                 // Bindless模式：初始化默认SRV索引为0（指向默认纹理）
-                m_textureSRVIndices[param.name] = 0;
+                UINT srvIndex = 0;
+                WriteParameter(handle, param.type, &srvIndex, sizeof(srvIndex));
                 break;
+            }
             default:
                 break;
         }
     }
 
-    m_isDirty = true;
+    MarkDirty();
 }
 
 bool MaterialInstance::Initialize(ID3D12Device* device) {
     if (!m_shader || !device) return false;
 
-    int bufferSize = m_shader->GetConstantBufferSize();
-    if (bufferSize == 0) return true;  // 没有CB需求
+    if (m_constantBufferSize == 0) return true;  // 没有CB需求
 
     // 创建常量缓冲区（upload heap，可持续映射）
-    m_constantBuffer = CreateConstantBufferObject(bufferSize);
+    m_constantBuffer = CreateConstantBufferObject(m_constantBufferSize);
     if (!m_constantBuffer) {
         return false;
     }
@@ -104,70 +112,201 @@ bool MaterialInstance::Initialize(ID3D12Device* device) {
         return false;
     }
 
-    // 初始更新
+    // 初始更新：整个缓冲区
+    MarkDirty();
     UpdateConstantBuffer();
 
     return true;
 }
 
-void MaterialInstance::SetFloat(const std::string& name, float value) {
-    m_floatParams[name] = value;
+// ========== 参数句柄 ==========
+
+MaterialParameterHandle MaterialInstance::FindParameter(const std::string& name) const {
+    MaterialParameterHandle handle;
+    if (!m_shader) return handle;
+
+    const auto& parameters = m_shader->GetParameters();
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        if (parameters[i].name == name) {
+            handle.index = (int)i;
+            handle.byteOffset = parameters[i].byteOffset;
+            handle.type = parameters[i].type;
+            break;
+        }
+    }
+    return handle;
+}
+
+void MaterialInstance::MarkRangeDirty(int begin, int end) {
+    if (!m_isDirty || m_dirtyBegin >= m_dirtyEnd) {
+        m_dirtyBegin = begin;
+        m_dirtyEnd = end;
+    } else {
+        m_dirtyBegin = begin < m_dirtyBegin ? begin : m_dirtyBegin;
+        m_dirtyEnd = end > m_dirtyEnd ? end : m_dirtyEnd;
+    }
     m_isDirty = true;
 }
 
+bool MaterialInstance::WriteParameter(const MaterialParameterHandle& handle, ShaderParameterType type,
+                                      const void* data, int size) {
+    if (!handle.IsValid() || handle.type != type || !m_constantBufferData ||
+        handle.byteOffset < 0 || handle.byteOffset + size > m_constantBufferSize) {
+        return false;
+    }
+
+    unsigned char* dest = m_constantBufferData + handle.byteOffset;
+    if (memcmp(dest, data, size) == 0) return true;  // 值没变，不需要上传
+    memcpy(dest, data, size);
+    MarkRangeDirty(handle.byteOffset, handle.byteOffset + size);
+    return true;
+}
+
+bool MaterialInstance::ReadParameter(const MaterialParameterHandle& handle, ShaderParameterType type,
+                                     void* out, int size) const {
+    if (!handle.IsValid() || handle.type != type || !m_constantBufferData ||
+        handle.byteOffset < 0 || handle.byteOffset + size > m_constantBufferSize) {
+        return false;
+    }
+    memcpy(out, m_constantBufferData + handle.byteOffset, size);
+    return true;
+}
+
+void MaterialInstance::SetFloat(const MaterialParameterHandle& handle, float value) {
+    WriteParameter(handle, ShaderParameterType::Float, &value, sizeof(value));
+}
+
+void MaterialInstance::SetVector(const MaterialParameterHandle& handle, const XMFLOAT4& value) {
+    WriteParameter(handle, ShaderParameterType::Vector4, &value, sizeof(value));
+}
+
+void MaterialInstance::SetVector3(const MaterialParameterHandle& handle, const XMFLOAT3& value) {
+    WriteParameter(handle, ShaderParameterType::Vector3, &value, sizeof(value));
+}
+
+void MaterialInstance::SetInt(const MaterialParameterHandle& handle, int value) {
+    if (WriteParameter(handle, ShaderParameterType::Int, &value, sizeof(value))) {
+        m_variantKeyDirty = true;
+    }
+}
+
+void MaterialInstance::SetBool(const MaterialParameterHandle& handle, bool value) {
+    int intValue = value ? 1 : 0;  // HLSL中bool参数声明为int
+    if (WriteParameter(handle, ShaderParameterType::Bool, &intValue, sizeof(intValue))) {
+        m_variantKeyDirty = true;
+    }
+}
+
+float MaterialInstance::GetFloat(const MaterialParameterHandle& handle) const {
+    float value = 0.0f;
+    ReadParameter(handle, ShaderParameterType::Float, &value, sizeof(value));
+    return value;
+}
+
+XMFLOAT4 MaterialInstance::GetVector(const MaterialParameterHandle& handle) const {
+    XMFLOAT4 value(0, 0, 0, 0);
+    ReadParameter(handle, ShaderParameterType::Vector4, &value, sizeof(value));
+    return value;
+}
+
+XMFLOAT3 MaterialInstance::GetVector3(const MaterialParameterHandle& handle) const {
+    XMFLOAT3 value(0, 0, 0);
+    ReadParameter(handle, ShaderParameterType::Vector3, &value, sizeof(value));
+    return value;
+}
+
+int MaterialInstance::GetInt(const MaterialParameterHandle& handle) const {
+    int value = 0;
+    ReadParameter(handle, ShaderParameterType::Int, &value, sizeof(value));
+    return value;
+}
+
+bool MaterialInstance::GetBool(const MaterialParameterHandle& handle) const {
+    int value = 0;
+    ReadParameter(handle, ShaderParameterType::Bool, &value, sizeof(value));
+    return value != 0;
+}
+
+// ========== 按名字访问 ==========
+
+void MaterialInstance::SetFloat(const std::string& name, float value) {
+    SetFloat(FindParameter(name), value);
+}
+
 void MaterialInstance::SetVector(const std::string& name, const XMFLOAT4& value) {
-    m_vectorParams[name] = value;
-    m_isDirty = true;
+    SetVector(FindParameter(name), value);
 }
 
 void MaterialInstance::SetVector3(const std::string& name, const XMFLOAT3& value) {
-    m_vector3Params[name] = value;
-    m_isDirty = true;
+    SetVector3(FindParameter(name), value);
 }
 
 void MaterialInstance::SetInt(const std::string& name, int value) {
-    m_intParams[name] = value;
-    m_isDirty = true;
+    SetInt(FindParameter(name), value);
 }
 
 void MaterialInstance::SetBool(const std::string& name, bool value) {
-    m_boolParams[name] = value;
-    m_isDirty = true;
+    SetBool(FindParameter(name), value);
+}
+
+ShaderVariantKey MaterialInstance::GetVariantKey() const {
+    if (!m_shader) return 0;
+
+    // 只在绑定参数或全局关键字变化后重新计算
+    const uint32_t globalVersion = ShaderKeywordSpace::GetGlobalKeywordVersion();
+    if (!m_variantKeyDirty && m_variantKeyGlobalVersion == globalVersion) {
+        return m_variantKey;
+    }
+
+    const ShaderKeywordSpace& keywords = m_shader->GetKeywords();
+    std::vector<int> values;
+    for (const auto& binding : keywords.GetBindings()) {
+        values.push_back(binding.isBool ? (GetBool(binding.parameterName) ? 1 : 0) : GetInt(binding.parameterName));
+    }
+    m_variantKey = keywords.SelectVariant(values);
+    m_variantKeyDirty = false;
+    m_variantKeyGlobalVersion = globalVersion;
+    return m_variantKey;
+}
+
+ID3D12PipelineState* MaterialInstance::GetPSO(int passIndex) const {
+    if (!m_shader) return nullptr;
+    return m_shader->GetVariantPSO(passIndex, GetVariantKey());
 }
 
 void MaterialInstance::SetTexture(const std::string& name, const std::wstring& texturePath) {
-    m_textureParams[name] = texturePath;
-    m_isDirty = true;
+    MaterialParameterHandle handle = FindParameter(name);
+    if (handle.IsValid() && handle.index < (int)m_texturePaths.size()) {
+        m_texturePaths[handle.index] = texturePath;
+    }
 }
 
 float MaterialInstance::GetFloat(const std::string& name) const {
-    auto it = m_floatParams.find(name);
-    return (it != m_floatParams.end()) ? it->second : 0.0f;
+    return GetFloat(FindParameter(name));
 }
 
 XMFLOAT4 MaterialInstance::GetVector(const std::string& name) const {
-    auto it = m_vectorParams.find(name);
-    return (it != m_vectorParams.end()) ? it->second : XMFLOAT4(0, 0, 0, 0);
+    return GetVector(FindParameter(name));
 }
 
 XMFLOAT3 MaterialInstance::GetVector3(const std::string& name) const {
-    auto it = m_vector3Params.find(name);
-    return (it != m_vector3Params.end()) ? it->second : XMFLOAT3(0, 0, 0);
+    return GetVector3(FindParameter(name));
 }
 
 int MaterialInstance::GetInt(const std::string& name) const {
-    auto it = m_intParams.find(name);
-    return (it != m_intParams.end()) ? it->second : 0;
+    return GetInt(FindParameter(name));
 }
 
 bool MaterialInstance::GetBool(const std::string& name) const {
-    auto it = m_boolParams.find(name);
-    return (it != m_boolParams.end()) ? it->second : false;
+    return GetBool(FindParameter(name));
 }
 
 std::wstring MaterialInstance::GetTexture(const std::string& name) const {
-    auto it = m_textureParams.find(name);
-    return (it != m_textureParams.end()) ? it->second : L"";
+    MaterialParameterHandle handle = FindParameter(name);
+    if (handle.IsValid() && handle.index < (int)m_texturePaths.size()) {
+        return m_texturePaths[handle.index];
+    }
+    return L"";
 }
 
 void MaterialInstance::SetTextureResource(const std::string& name, ID3D12Resource* resource, int registerSlot) {
@@ -180,18 +319,24 @@ void MaterialInstance::SetTextureResource(const std::string& name, ID3D12Resourc
 }
 
 void MaterialInstance::SetTextureSRVIndex(const std::string& name, UINT srvIndex) {
-    m_textureSRVIndices[name] = srvIndex;
-    m_isDirty = true;  // 需要更新CB，因为纹理索引存储在CB中
+    // 纹理索引存储在CB中
+    MaterialParameterHandle handle = FindParameter(name);
+    if (!WriteParameter(handle, handle.type == ShaderParameterType::TextureCube ? ShaderParameterType::TextureCube
+                                                                              : ShaderParameterType::Texture2D,
+                        &srvIndex, sizeof(srvIndex))) {
+        return;
+    }
     std::cout << "MaterialInstance '" << m_name << "': Set texture '" << name
               << "' SRV index = " << srvIndex << " (Bindless)" << std::endl;
 }
 
 UINT MaterialInstance::GetTextureSRVIndex(const std::string& name) const {
-    auto it = m_textureSRVIndices.find(name);
-    if (it != m_textureSRVIndices.end()) {
-        return it->second;
-    }
-    return UINT_MAX;  // 无效索引
+    MaterialParameterHandle handle = FindParameter(name);
+    UINT srvIndex = UINT_MAX;  // 无效索引
+    ReadParameter(handle, handle.type == ShaderParameterType::TextureCube ? ShaderParameterType::TextureCube
+                                                                        : ShaderParameterType::Texture2D,
+                  &srvIndex, sizeof(srvIndex));
+    return srvIndex;
 }
 
 ID3D12Resource* MaterialInstance::GetTextureResource(const std::string& name) const {
@@ -246,81 +391,19 @@ void MaterialInstance::BindTextures(ID3D12Device* device, ID3D12DescriptorHeap*
     m_texturesDirty = false;
 }
 
-void MaterialInstance::PackConstantBuffer() {
-    if (!m_shader || !m_constantBufferData) return;
-
-    const auto& parameters = m_shader->GetParameters();
-    for (const auto& param : parameters) {
-        // 根据类型写入对应的值到指定偏移
-        unsigned char* dest = m_constantBufferData + param.byteOffset;
-
-        switch (param.type) {
-            case ShaderParameterType::Float: {
-                auto it = m_floatParams.find(param.name);
-                if (it != m_floatParams.end()) {
-                    *reinterpret_cast<float*>(dest) = it->second;
-                }
-                break;
-            }
-            case ShaderParameterType::Vector4: {
-                auto it = m_vectorParams.find(param.name);
-                if (it != m_vectorParams.end()) {
-                    *reinterpret_cast<XMFLOAT4*>(dest) = it->second;
-                }
-                break;
-            }
-            case ShaderParameterType::Vector3: {
-                auto it = m_vector3Params.find(param.name);
-                if (it != m_vector3Params.end()) {
-                    *reinterpret_cast<XMFLOAT3*>(dest) = it->second;
-                }
-                break;
-            }
-            case ShaderParameterType::Int: {
-                auto it = m_intParams.find(param.name);
-                if (it != m_intParams.end()) {
-                    *reinterpret_cast<int*>(dest) = it->second;
-                }
-                break;
-            }
-            case ShaderParameterType::Bool: {
-                auto it = m_boolParams.find(param.name);
-                if (it != m_boolParams.end()) {
-                    *reinterpret_cast<int*>(dest) = it->second ? 1 : 0;  // bool转int
-                }
-                break;
-            }
-            // Bindless纹理：将SRV索引写入CB
-            case ShaderParameterType::Texture2D:
-            case ShaderParameterType::TextureCube: {
-                auto it = m_textureSRVIndices.find(param.name);
-                if (it != m_textureSRVIndices.end()) {
-                    *reinterpret_cast<UINT*>(dest) = it->second;
-                } else {
-                    // 默认索引0（应该指向一个默认纹理）
-                    *reinterpret_cast<UINT*>(dest) = 0;
-                }
-                break;
-            }
-            default:
-                break;
-        }
-    }
-}
-
 void MaterialInstance::UpdateConstantBuffer() {
     if (!m_constantBuffer || !m_mappedConstantBuffer || !m_constantBufferData) {
         return;
     }
 
-    // 打包参数到CPU端缓冲区
-    PackConstantBuffer();
-
-    // 复制到GPU映射内存
-    int bufferSize = m_shader ? m_shader->GetConstantBufferSize() : 256;
-    memcpy(m_mappedConstantBuffer, m_constantBufferData, bufferSize);
+    // 参数写入时已经在CPU端缓冲区中，只复制修改过的范围
+    if (m_dirtyEnd > m_dirtyBegin) {
+        memcpy(static_cast<unsigned char*>(m_mappedConstantBuffer) + m_dirtyBegin,
+               m_constantBufferData + m_dirtyBegin, m_dirtyEnd - m_dirtyBegin);
+    }
 
     m_isDirty = false;
+    m_dirtyBegin = m_dirtyEnd = 0;
 }
 
 void MaterialInstance::Bind(ID3D12GraphicsCommandList* commandList,
@@ -344,241 +427,53 @@ void MaterialInstance::Bind(ID3D12GraphicsCommandList* commandList,
     // 纹理绑定将在MaterialManager中处理（需要访问descriptor heap）
 }
 
-bool MaterialInstance::LoadFromXML(const std::wstring& filePath) {
-    // 初始化COM
-    HRESULT hr = CoInitialize(nullptr);
-    bool comInitialized = SUCCEEDED(hr);
-
-    // 创建XML文档对象
-    IXMLDOMDocument2* pXMLDom = nullptr;
-    hr = CoCreateInstance(__uuidof(DOMDocument60), nullptr, CLSCTX_INPROC_SERVER,
-                          __uuidof(IXMLDOMDocument2), (void**)&pXMLDom);
-    if (FAILED(hr)) {
-        if (comInitialized) CoUninitialize();
-        return false;
-    }
-
-    // 加载XML文件
-    VARIANT_BOOL loadSuccess = VARIANT_FALSE;
-    VARIANT var;
-    VariantInit(&var);
-    var.vt = VT_BSTR;
-    var.bstrVal = SysAllocString(filePath.c_str());
-    hr = pXMLDom->load(var, &loadSuccess);
-    VariantClear(&var);
-
-    if (loadSuccess != VARIANT_TRUE) {
-        pXMLDom->Release();
-        if (comInitialized) CoUninitialize();
+bool MaterialInstance::LoadFromFile(const std::wstring& filePath) {
+    MaterialAssetData data;
+    if (!MaterialAsset::Load(filePath, data)) {
         return false;
     }
+    ApplyAssetData(data, filePath);
+    return true;
+}
 
-    // 获取根节点
-    IXMLDOMElement* pRoot = nullptr;
-    hr = pXMLDom->get_documentElement(&pRoot);
-    if (FAILED(hr) || !pRoot) {
-        pXMLDom->Release();
-        if (comInitialized) CoUninitialize();
-        return false;
+void MaterialInstance::ApplyAssetData(const MaterialAssetData& data, const std::wstring& filePath) {
+    if (!data.name.empty()) {
+        m_name = data.name;
     }
 
-    // 获取材质名称
-    VARIANT varName;
-    VariantInit(&varName);
-    pRoot->getAttribute(_bstr_t("name"), &varName);
-    if (varName.vt == VT_BSTR && varName.bstrVal) {
-        m_name = BSTRToString(varName.bstrVal);
-    }
-    VariantClear(&varName);
-
-    // 解析Shader节点（材质引用的shader名称）
-    // 注意：这里只读取shader名称，实际的shader指针应该由MaterialManager设置
-    std::string shaderName;
-    IXMLDOMNodeList* pShaderNodes = nullptr;
-    pRoot->getElementsByTagName(_bstr_t("Shader"), &pShaderNodes);
-    if (pShaderNodes) {
-        IXMLDOMNode* pShaderNode = nullptr;
-        pShaderNodes->get_item(0, &pShaderNode);
-        if (pShaderNode) {
-            BSTR shaderText = nullptr;
-            pShaderNode->get_text(&shaderText);
-            if (shaderText) {
-                shaderName = BSTRToString(shaderText);
-                std::cout << "Material references shader: " << shaderName << std::endl;
-                SysFreeString(shaderText);
-            }
-            pShaderNode->Release();
-        }
-        pShaderNodes->Release();
-    }
-
-    // 解析Parameters
-    IXMLDOMNodeList* pParameters = nullptr;
-    pRoot->getElementsByTagName(_bstr_t("Parameters"), &pParameters);
-    if (pParameters) {
-        IXMLDOMNode* pParametersNode = nullptr;
-        pParameters->get_item(0, &pParametersNode);
-        if (pParametersNode) {
-            IXMLDOMNodeList* pParamList = nullptr;
-            pParametersNode->get_childNodes(&pParamList);
-            if (pParamList) {
-                long paramCount = 0;
-                pParamList->get_length(&paramCount);
-                for (long i = 0; i < paramCount; i++) {
-                    IXMLDOMNode* pParam = nullptr;
-                    pParamList->get_item(i, &pParam);
-                    if (pParam) {
-                        BSTR nodeName = nullptr;
-                        pParam->get_nodeName(&nodeName);
-                        std::string nodeNameStr = BSTRToString(nodeName);
-
-                        if (nodeNameStr == "Parameter") {
-                            std::string paramName;
-                            std::string paramType;
-                            std::string paramValue;
-
-                            // 获取属性
-                            IXMLDOMNamedNodeMap* pAttrs = nullptr;
-                            pParam->get_attributes(&pAttrs);
-                            if (pAttrs) {
-                                IXMLDOMNode* pNameAttr = nullptr;
-                                pAttrs->getNamedItem(_bstr_t("name"), &pNameAttr);
-                                if (pNameAttr) {
-                                    BSTR val = nullptr;
-                                    pNameAttr->get_text(&val);
-                                    paramName = BSTRToString(val);
-                                    SysFreeString(val);
-                                    pNameAttr->Release();
-                                }
-
-                                IXMLDOMNode* pTypeAttr = nullptr;
-                                pAttrs->getNamedItem(_bstr_t("type"), &pTypeAttr);
-                                if (pTypeAttr) {
-                                    BSTR val = nullptr;
-                                    pTypeAttr->get_text(&val);
-                                    paramType = BSTRToString(val);
-                                    SysFreeString(val);
-                                    pTypeAttr->Release();
-                                }
-
-                                pAttrs->Release();
-                            }
-
-                            // 获取值
-                            BSTR nodeText = nullptr;
-                            pParam->get_text(&nodeText);
-                            paramValue = BSTRToString(nodeText);
-                            SysFreeString(nodeText);
-
-                            // 根据类型设置参数
-                            if (paramType == "Float") {
-                                SetFloat(paramName, std::stof(paramValue));
-                            } else if (paramType == "Int") {
-                                SetInt(paramName, std::stoi(paramValue));
-                            } else if (paramType == "Bool") {
-                                SetBool(paramName, std::stoi(paramValue) != 0);
-                            } else if (paramType == "Vector4") {
-                                std::istringstream iss(paramValue);
-                                XMFLOAT4 vec;
-                                iss >> vec.x >> vec.y >> vec.z >> vec.w;
-                                SetVector(paramName, vec);
-                            } else if (paramType == "Vector3") {
-                                std::istringstream iss(paramValue);
-                                XMFLOAT3 vec;
-                                iss >> vec.x >> vec.y >> vec.z;
-                                SetVector3(paramName, vec);
-                            }
-                        }
-
-                        SysFreeString(nodeName);
-                        pParam->Release();
-                    }
-                }
-                pParamList->Release();
-            }
-            pParametersNode->Release();
-        }
-        pParameters->Release();
-    }
-
-    // 解析Textures
-    IXMLDOMNodeList* pTextures = nullptr;
-    pRoot->getElementsByTagName(_bstr_t("Textures"), &pTextures);
-    if (pTextures) {
-        IXMLDOMNode* pTexturesNode = nullptr;
-        pTextures->get_item(0, &pTexturesNode);
-        if (pTexturesNode) {
-            IXMLDOMNodeList* pTexList = nullptr;
-            pTexturesNode->get_childNodes(&pTexList);
-            if (pTexList) {
-                long texCount = 0;
-                pTexList->get_length(&texCount);
-                for (long i = 0; i < texCount; i++) {
-                    IXMLDOMNode* pTex = nullptr;
-                    pTexList->get_item(i, &pTex);
-                    if (pTex) {
-                        BSTR nodeName = nullptr;
-                        pTex->get_nodeName(&nodeName);
-                        std::string nodeNameStr = BSTRToString(nodeName);
-
-                        if (nodeNameStr == "Texture") {
-                            std::string texName;
-
-                            // 获取name属性
-                            IXMLDOMNamedNodeMap* pAttrs = nullptr;
-                            pTex->get_attributes(&pAttrs);
-                            if (pAttrs) {
-                                IXMLDOMNode* pNameAttr = nullptr;
-                                pAttrs->getNamedItem(_bstr_t("name"), &pNameAttr);
-                                if (pNameAttr) {
-                                    BSTR val = nullptr;
-                                    pNameAttr->get_text(&val);
-                                    texName = BSTRToString(val);
-                                    SysFreeString(val);
-                                    pNameAttr->Release();
-                                }
-                                pAttrs->Release();
-                            }
-
-                            // 获取路径值
-                            BSTR nodeText = nullptr;
-                            pTex->get_text(&nodeText);
-                            std::string pathStr = BSTRToString(nodeText);
-
-                            // 转换为wstring
-                            int len = MultiByteToWideChar(CP_UTF8, 0, pathStr.c_str(), -1, nullptr, 0);
-                            std::wstring texPath;
-                            if (len > 0) {
-                                texPath.resize(len - 1);
-                                MultiByteToWideChar(CP_UTF8, 0, pathStr.c_str(), -1, &texPath[0], len);
-                            }
-
-                            SetTexture(texName, texPath);
-                            SysFreeString(nodeText);
-                        }
-
-                        SysFreeString(nodeName);
-                        pTex->Release();
-                    }
-                }
-                pTexList->Release();
-            }
-            pTexturesNode->Release();
+    for (const MaterialAssetParameter& param : data.parameters) {
+        switch (param.type) {
+            case ShaderParameterType::Float:
+                SetFloat(param.name, param.values[0]);
+                break;
+            case ShaderParameterType::Int:
+                SetInt(param.name, param.intValue);
+                break;
+            case ShaderParameterType::Bool:
+                SetBool(param.name, param.intValue != 0);
+                break;
+            case ShaderParameterType::Vector4:
+                SetVector(param.name, XMFLOAT4(param.values[0], param.values[1], param.values[2], param.values[3]));
+                break;
+            case ShaderParameterType::Vector3:
+                SetVector3(param.name, XMFLOAT3(param.values[0], param.values[1], param.values[2]));
+                break;
+            default:
+                break;
         }
-        pTextures->Release();
+    }
+    for (const MaterialAssetTexture& texture : data.textures) {
+        SetTexture(texture.name, texture.path);
     }
 
-    pRoot->Release();
-    pXMLDom->Release();
-    if (comInitialized) CoUninitialize();
-
+    m_filePath = filePath;
     // 如果有纹理路径，标记为待加载
-    if (!m_textureParams.empty()) {
-        m_hasPendingTextures = true;
+    for (const std::wstring& texPath : m_texturePaths) {
+        if (!texPath.empty()) {
+            m_hasPendingTextures = true;
+            break;
+        }
     }
-
-    m_isDirty = true;
-    return true;
 }
 
 bool MaterialInstance::SaveToXML(const std::wstring& filePath) {
@@ -597,61 +492,70 @@ bool MaterialInstance::SaveToXML(const std::wstring& filePath) {
     // 写入Parameters
     file << "  <Parameters>\n";
 
-    // Float参数
-    for (const auto& pair : m_floatParams) {
-        file << "    <Parameter name=\"" << pair.first << "\" type=\"Float\">"
-             << pair.second << "</Parameter>\n";
-    }
-
-    // Vector4参数
-    for (const auto& pair : m_vectorParams) {
-        file << "    <Parameter name=\"" << pair.first << "\" type=\"Vector4\">"
-             << pair.second.x << " " << pair.second.y << " "
-             << pair.second.z << " " << pair.second.w << "</Parameter>\n";
-    }
-
-    // Vector3参数
-    for (const auto& pair : m_vector3Params) {
-        file << "    <Parameter name=\"" << pair.first << "\" type=\"Vector3\">"
-             << pair.second.x << " " << pair.second.y << " "
-             << pair.second.z << "</Parameter>\n";
-    }
-
-    // Int参数
-    for (const auto& pair : m_intParams) {
-        file << "    <Parameter name=\"" << pair.first << "\" type=\"Int\">"
-             << pair.second << "</Parameter>\n";
-    }
+    // 按Shader参数表的顺序写出
+    const std::vector<ShaderParameter> noParameters;
+    const auto& parameters = m_shader ? m_shader->GetParameters() : noParameters;
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        const ShaderParameter& param = parameters[i];
+        MaterialParameterHandle handle;
+        handle.index = (int)i;
+        handle.byteOffset = param.byteOffset;
+        handle.type = param.type;
 
-    // Bool参数
-    for (const auto& pair : m_boolParams) {
-        file << "    <Parameter name=\"" << pair.first << "\" type=\"Bool\">"
-             << (pair.second ? "1" : "0") << "</Parameter>\n";
+        switch (param.type) {
+            case ShaderParameterType::Float:
+                file << "    <Parameter name=\"" << param.name << "\" type=\"Float\">"
+                     << GetFloat(handle) << "</Parameter>\n";
+                break;
+            case ShaderParameterType::Vector4: {
+                XMFLOAT4 value = GetVector(handle);
+                file << "    <Parameter name=\"" << param.name << "\" type=\"Vector4\">"
+                     << value.x << " " << value.y << " "
+                     << value.z << " " << value.w << "</Parameter>\n";
+                break;
+            }
+            case ShaderParameterType::Vector3: {
+                XMFLOAT3 value = GetVector3(handle);
+                file << "    <Parameter name=\"" << param.name << "\" type=\"Vector3\">"
+                     << value.x << " " << value.y << " "
+                     << value.z << "</Parameter>\n";
+                break;
+            }
+            case ShaderParameterType::Int:
+                file << "    <Parameter name=\"" << param.name << "\" type=\"Int\">"
+                     << GetInt(handle) << "</Parameter>\n";
+                break;
+            case ShaderParameterType::Bool:
+                file << "    <Parameter name=\"" << param.name << "\" type=\"Bool\">"
+                     << (GetBool(handle) ? "1" : "0") << "</Parameter>\n";
+                break;
+            default:
+                break;
+        }
     }
 
     file << "  </Parameters>\n";
 
     // 写入Textures
     file << "  <Textures>\n";
-    for (const auto& pair : m_textureParams) {
+    for (size_t i = 0; i < parameters.size() && i < m_texturePaths.size(); ++i) {
+        const ShaderParameter& param = parameters[i];
+        if (param.type != ShaderParameterType::Texture2D &&
+            param.type != ShaderParameterType::TextureCube) {
+            continue;
+        }
+
         // wstring转string
-        int len = WideCharToMultiByte(CP_UTF8, 0, pair.second.c_str(), -1, nullptr, 0, nullptr, nullptr);
+        const std::wstring& texPath = m_texturePaths[i];
+        int len = WideCharToMultiByte(CP_UTF8, 0, texPath.c_str(), -1, nullptr, 0, nullptr, nullptr);
         std::string pathStr;
         if (len > 0) {
             pathStr.resize(len - 1);
-            WideCharToMultiByte(CP_UTF8, 0, pair.second.c_str(), -1, &pathStr[0], len, nullptr, nullptr);
-        }
-
-        // 获取register slot（从shader参数中查找）
-        std::string slotStr = "t0";
-        if (m_shader) {
-            const ShaderParameter* param = m_shader->GetParameter(pair.first);
-            if (param) {
-                slotStr = "t" + std::to_string(param->registerSlot);
-            }
+            WideCharToMultiByte(CP_UTF8, 0, texPath.c_str(), -1, &pathStr[0], len, nullptr, nullptr);
         }
 
-        file << "    <Texture name=\"" << pair.first << "\" slot=\"" << slotStr << "\">"
+        std::string slotStr = "t" + std::to_string(param.registerSlot);
+        file << "    <Texture name=\"" << param.name << "\" slot=\"" << slotStr << "\">"
              << pathStr << "</Texture>\n";
     }
     file << "  </Textures>\n";
@@ -728,3 +632,110 @@ bool MaterialInstance::LoadTexturesFromPaths(ID3D12GraphicsCommandList* commandL
     return anyLoaded;
 }
 
+
+// ========== 热重载 ==========
+
+ID3D12Resource* MaterialInstance::OnShaderReloaded(ID3D12Device* device, const std::vector<ShaderParameter>& oldParameters) {
+    if (!m_shader) return nullptr;
+
+    // 旧布局下的参数值和纹理路径
+    std::vector<unsigned char> oldData(m_constantBufferData, m_constantBufferData + m_constantBufferSize);
+    std::vector<std::wstring> oldTexturePaths;
+    oldTexturePaths.swap(m_texturePaths);
+
+    ID3D12Resource* retiredBuffer = nullptr;
+    const int newSize = m_shader->GetConstantBufferSize();
+    if (newSize != m_constantBufferSize) {
+        delete[] m_constantBufferData;
+        m_constantBufferData = nullptr;
+        m_constantBufferSize = newSize;
+        if (newSize > 0) {
+            m_constantBufferData = new unsigned char[newSize];
+            memset(m_constantBufferData, 0, newSize);
+        }
+        // 旧的GPU常量缓冲区可能仍被在途帧引用，交给调用方延迟释放
+        retiredBuffer = m_constantBuffer;
+        m_constantBuffer = nullptr;
+        m_mappedConstantBuffer = nullptr;
+    }
+
+    // 新参数取默认值；名字和类型都没变的参数沿用旧值（纹理连同路径和SRV索引）
+    // 新布局中去掉的纹理不释放其Bindless槽位：在途帧可能仍在读取该槽位的描述符
+    InitializeDefaultParameters();
+    const auto& parameters = m_shader->GetParameters();
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        const ShaderParameter& param = parameters[i];
+        const bool isTexture = param.type == ShaderParameterType::Texture2D ||
+                               param.type == ShaderParameterType::TextureCube;
+        const int size = isTexture ? (int)sizeof(UINT) : ShaderParameter::GetTypeSizeInBytes(param.type);
+
+        for (size_t j = 0; j < oldParameters.size(); ++j) {
+            const ShaderParameter& oldParam = oldParameters[j];
+            if (oldParam.name != param.name || oldParam.type != param.type) continue;
+
+            if (size > 0 && param.byteOffset + size <= m_constantBufferSize &&
+                oldParam.byteOffset + size <= (int)oldData.size()) {
+                memcpy(m_constantBufferData + param.byteOffset, oldData.data() + oldParam.byteOffset, size);
+            }
+            if (isTexture && j < oldTexturePaths.size()) {
+                m_texturePaths[i] = oldTexturePaths[j];
+            }
+            break;
+        }
+    }
+
+    m_variantKeyDirty = true;
+    if (!m_constantBuffer && m_constantBufferSize > 0) {
+        Initialize(device);     // 按新大小创建并上传整个缓冲区
+    } else {
+        MarkDirty();
+    }
+    return retiredBuffer;
+}
+
+bool MaterialInstance::ReloadFromFile(const std::wstring& filePath) {
+    // 路径不变的纹理沿用原来的Bindless槽位
+    std::vector<std::wstring> oldTexturePaths = m_texturePaths;
+
+    // 文件中没有的参数保持当前值
+    if (!LoadFromFile(filePath)) {
+        std::cout << "MaterialInstance '" << m_name << "': failed to reload " << WToA(filePath) << std::endl;
+        return false;
+    }
+
+    const auto& parameters = m_shader->GetParameters();
+    for (size_t i = 0; i < parameters.size() && i < m_texturePaths.size(); ++i) {
+        if (i < oldTexturePaths.size() && m_texturePaths[i] == oldTexturePaths[i]) continue;
+
+        // 路径变了：释放旧槽位（调用方保证GPU空闲），SRV索引归零等待LoadTexturesFromPaths重新加载
+        UINT srvIndex = GetTextureSRVIndex(parameters[i].name);
+        if (srvIndex != 0 && srvIndex != UINT_MAX) {
+            Scene::FreeBindlessSRVSlot(srvIndex + 10);
+        }
+        SetTextureSRVIndex(parameters[i].name, 0);
+        m_hasPendingTextures = true;
+    }
+    return true;
+}
+
+bool MaterialInstance::RefreshTexture(const TextureAsset* texture) {
+    if (!m_shader || !texture || !texture->GetResource()) return false;
+
+    bool refreshed = false;
+    const auto& parameters = m_shader->GetParameters();
+    for (size_t i = 0; i < parameters.size() && i < m_texturePaths.size(); ++i) {
+        const ShaderParameter& param = parameters[i];
+        if (m_texturePaths[i].empty() ||
+            TextureManager::GetInstance().GetTextureByPath(m_texturePaths[i]) != texture) {
+            continue;
+        }
+
+        // 槽位不变，在原位置重建SRV指向新资源（材质常量缓冲区中的索引不需要更新）
+        UINT srvIndex = GetTextureSRVIndex(param.name);
+        if (srvIndex == 0 || srvIndex == UINT_MAX) continue;
+        Scene::CreateBindlessTextureSRV(srvIndex + 10, texture->GetResource());
+        SetTextureResource(param.name, texture->GetResource(), param.registerSlot);
+        refreshed = true;
+    }
+    return refreshed;
+}
@@ -1,11 +1,19 @@
 #include "public/Material/MaterialManager.h"
+#include "public/Material/MaterialAsset.h"
+#include "public/Material/ShaderCompileQueue.h"
+#include "public/Material/ShaderBytecodeCache.h"
+#include "public/Material/ShadingModelRegistry.h"
 #include "public/Texture/TextureManager.h"
 #include "public/Texture/TextureAsset.h"
 #include "public/Scene.h"
 #include "public/BattleFireDirect.h"
+#include "public/PipelineStateCache.h"
+#include "public/PathUtils.h"
+#include "public/ParallelFor.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
-#include <comdef.h>
-#include <msxml6.h>
 #include <fstream>
 #include <sstream>
 #include <ctime>
@@ -15,8 +23,6 @@
 
 #pragma comment(lib, "shlwapi.lib")
 
-#pragma comment(lib, "msxml6.lib")
-
 // 日志辅助函数
 static void LogMaterialError(const std::string& materialName, const std::string& message) {
     // 创建日志目录
@@ -93,6 +99,9 @@ bool MaterialManager::Initialize(ID3D12Device* device) {
 }
 
 void MaterialManager::Shutdown() {
+    // 还在编译的热重载版本
+    m_pendingShaderReloads.clear();
+
     // 清理所有材质
     m_materials.clear();
 
@@ -107,6 +116,12 @@ void MaterialManager::Shutdown() {
     }
     m_textures.clear();
 
+    // 调用前GPU已空闲
+    for (RetiredResource& retired : m_retiredResources) {
+        retired.resource->Release();
+    }
+    m_retiredResources.clear();
+
     m_device = nullptr;
 }
 
@@ -203,68 +218,130 @@ void MaterialManager::ClearShaderCache(const std::string& shaderName) {
 void MaterialManager::CompileAndCreateAllShadersPSO() {
     std::cout << "\n========== Compiling All Shaders ==========" << std::endl;
 
-    // 阶段1：先编译所有非Screen shader（注册ShadingModel）
-    std::cout << "\n[Phase 1] Compiling non-Screen shaders (registering ShadingModels)..." << std::endl;
+    // ShadingModel在LoadFromShaderFile解析时就已注册，Screen shader可以和其他shader在同一批编译
+    // Screen排在最后，保持原来的输出顺序
+    std::vector<Shader*> shaders;
+    Shader* screenShader = nullptr;
     for (auto& pair : m_shaders) {
-        Shader* shader = pair.second.get();
-        if (!shader) continue;
-
-        // 跳过 Screen shader
+        if (!pair.second) continue;
         if (pair.first == "Screen") {
-            std::cout << "Skipping Screen shader (will compile in Phase 2)" << std::endl;
-            continue;
+            screenShader = pair.second.get();
+        } else {
+            shaders.push_back(pair.second.get());
         }
+    }
+    if (screenShader) {
+        shaders.push_back(screenShader);
+    } else {
+        std::cout << "  Screen shader not found in cache" << std::endl;
+    }
 
-        std::cout << "Compiling: " << pair.first << std::endl;
-
-        // 编译shader（会注册ShadingModel）
-        if (shader->CompileShaders(m_device)) {
-            // 为每个Pass创建PSO
-            if (m_rootSignature) {
-                for (int i = 0; i < shader->GetPassCount(); i++) {
-                    if (!shader->CreatePSO(m_device, m_rootSignature, i)) {
-                        std::cout << "  Failed to create PSO for pass " << i << std::endl;
-                    } else {
-                        std::cout << "  PSO created for pass " << i << std::endl;
-                    }
-                }
+    // 所有(Shader, Pass, Stage)并行编译；某个shader的全部Stage回填后再为它创建PSO
+    ShaderCompileQueue::GetInstance().CompileShaders(shaders, [this](Shader* shader, bool success) {
+        if (!success) {
+            std::cout << "Failed to compile shader: " << shader->GetName() << std::endl;
+            return;
+        }
+        std::cout << "Compiled: " << shader->GetName() << std::endl;
+        if (!m_rootSignature) {
+            std::cout << "  WARNING: RootSignature not set, PSO creation skipped" << std::endl;
+            return;
+        }
+        for (int i = 0; i < shader->GetPassCount(); i++) {
+            if (!shader->CreatePSO(m_device, m_rootSignature, i)) {
+                std::cout << "  Failed to create PSO for pass " << i << std::endl;
             } else {
-                std::cout << "  WARNING: RootSignature not set, PSO creation skipped" << std::endl;
+                std::cout << "  PSO created for pass " << i << std::endl;
             }
-        } else {
-            std::cout << "  Failed to compile shader" << std::endl;
+        }
+    });
+
+    std::cout << "\n========== Compilation Complete ==========" << std::endl;
+}
+
+int MaterialManager::RecompileStaleShadingModels() {
+    const uint64_t setHash = ShadingModelRegistry::GetInstance().GetSetHash();
+    if (setHash == m_compiledShadingModelSetHash) return 0;
+    m_compiledShadingModelSetHash = setHash;
+
+    std::vector<Shader*> staleShaders;
+    for (auto& pair : m_shaders) {
+        if (pair.second && pair.second->IsShadingModelSetStale()) {
+            staleShaders.push_back(pair.second.get());
         }
     }
+    if (staleShaders.empty()) return 0;
 
-    // 阶段2：编译Screen shader（这时所有ShadingModel都已注册）
-    std::cout << "\n[Phase 2] Compiling Screen shader (with all ShadingModels registered)..." << std::endl;
-    auto screenIt = m_shaders.find("Screen");
-    if (screenIt != m_shaders.end()) {
-        Shader* screenShader = screenIt->second.get();
-        if (screenShader) {
-            std::cout << "Compiling: Screen" << std::endl;
-
-            if (screenShader->CompileShaders(m_device)) {
-                if (m_rootSignature) {
-                    for (int i = 0; i < screenShader->GetPassCount(); i++) {
-                        if (!screenShader->CreatePSO(m_device, m_rootSignature, i)) {
-                            std::cout << "  Failed to create PSO for pass " << i << std::endl;
-                        } else {
-                            std::cout << "  PSO created for pass " << i << std::endl;
-                        }
-                    }
-                } else {
-                    std::cout << "  WARNING: RootSignature not set, PSO creation skipped" << std::endl;
-                }
-            } else {
-                std::cout << "  Failed to compile Screen shader" << std::endl;
+    std::cout << "ShadingModel set changed (" << ShadingModelRegistry::GetInstance().GetModelCount()
+              << " models), recompiling " << staleShaders.size() << " deferred shaders" << std::endl;
+    ShaderCompileQueue::GetInstance().CompileShadersAsync(staleShaders, [this](Shader* shader, bool success) {
+        if (!success || !m_rootSignature) return;
+        for (int i = 0; i < shader->GetPassCount(); i++) {
+            if (!shader->CreatePSO(m_device, m_rootSignature, i)) {
+                std::cout << "  Failed to create PSO for " << shader->GetName() << " pass " << i << std::endl;
             }
         }
-    } else {
-        std::cout << "  Screen shader not found in cache" << std::endl;
+    });
+    return (int)staleShaders.size();
+}
+
+bool MaterialManager::PrecompileVariants(const std::wstring& manifestPath) {
+    std::vector<ShaderVariantRequest> requests;
+    auto addAllPasses = [&requests](Shader* shader, ShaderVariantKey key) {
+        for (int i = 0; i < shader->GetPassCount(); ++i) {
+            if (!shader->NeedsVariant(i, key)) continue;
+            ShaderVariantRequest request;
+            request.shader = shader;
+            request.passIndex = i;
+            request.key = key;
+            requests.push_back(request);
+        }
+    };
+
+    // 1. 变体清单（文件不存在时跳过）
+    std::ifstream manifest(manifestPath);
+    std::string line;
+    int lineNumber = 0;
+    while (manifest.is_open() && std::getline(manifest, line)) {
+        lineNumber++;
+        std::istringstream words(line);
+        std::string shaderName;
+        if (!(words >> shaderName) || shaderName[0] == '#') continue;
+
+        std::vector<std::string> keywords;
+        std::string keyword;
+        while (words >> keyword) keywords.push_back(keyword);
+
+        Shader* shader = GetShader(shaderName);
+        if (!shader) {
+            std::cout << "ShaderVariants.txt(" << lineNumber << "): unknown shader '" << shaderName << "'" << std::endl;
+            continue;
+        }
+        std::vector<std::string> unknown;
+        ShaderVariantKey key = shader->GetKeywords().MakeKey(keywords, &unknown);
+        for (const std::string& name : unknown) {
+            std::cout << "ShaderVariants.txt(" << lineNumber << "): shader '" << shaderName
+                      << "' has no keyword '" << name << "'" << std::endl;
+        }
+        addAllPasses(shader, key);
     }
 
-    std::cout << "\n========== Compilation Complete ==========" << std::endl;
+    // 2. 已加载材质和当前全局关键字对应的变体
+    for (auto& pair : m_materials) {
+        MaterialInstance* material = pair.second.get();
+        if (material && material->GetShader()) {
+            addAllPasses(material->GetShader(), material->GetVariantKey());
+        }
+    }
+    for (auto& pair : m_shaders) {
+        if (pair.second) {
+            addAllPasses(pair.second.get(), pair.second->GetVariantKey());
+        }
+    }
+
+    if (requests.empty()) return true;
+    std::cout << "\n========== Precompiling " << requests.size() << " Shader Variants ==========" << std::endl;
+    return ShaderCompileQueue::GetInstance().CompileVariants(requests);
 }
 
 const std::vector<std::string> MaterialManager::GetAllShaderNames() const {
@@ -277,131 +354,105 @@ const std::vector<std::string> MaterialManager::GetAllShaderNames() const {
 
 MaterialInstance* MaterialManager::LoadMaterial(const std::wstring& materialFilePath) {
     LogMaterialInfo("========== LoadMaterial START ==========");
-
-    // 转换路径为string用于日志
-    int pathLen = WideCharToMultiByte(CP_UTF8, 0, materialFilePath.c_str(), -1, nullptr, 0, nullptr, nullptr);
-    std::string pathStr;
-    if (pathLen > 0) {
-        pathStr.resize(pathLen - 1);
-        WideCharToMultiByte(CP_UTF8, 0, materialFilePath.c_str(), -1, &pathStr[0], pathLen, nullptr, nullptr);
-    }
-    LogMaterialInfo("Material file path: " + pathStr);
+    LogMaterialInfo("Material file path: " + WToA(materialFilePath));
 
     if (!m_device) {
         LogMaterialError("CRITICAL", "ERROR: MaterialManager device is NULL! Call Initialize() first.");
         return nullptr;
     }
 
-    LogMaterialInfo("Device is valid, parsing XML to get material name and shader reference...");
-
-    // 第一步：预解析XML以获取材质名和shader引用
-    std::string materialName;
-    std::string shaderName;
-
-    // 使用MSXML解析
-    HRESULT hr = CoInitialize(nullptr);
-    bool comInitialized = SUCCEEDED(hr);
-
-    IXMLDOMDocument2* pXMLDom = nullptr;
-    hr = CoCreateInstance(__uuidof(DOMDocument60), nullptr, CLSCTX_INPROC_SERVER,
-                          __uuidof(IXMLDOMDocument2), (void**)&pXMLDom);
-    if (SUCCEEDED(hr)) {
-        VARIANT_BOOL loadSuccess = VARIANT_FALSE;
-        VARIANT var;
-        VariantInit(&var);
-        var.vt = VT_BSTR;
-        var.bstrVal = SysAllocString(materialFilePath.c_str());
-        hr = pXMLDom->load(var, &loadSuccess);
-        VariantClear(&var);
-
-        if (loadSuccess == VARIANT_TRUE) {
-            IXMLDOMElement* pRoot = nullptr;
-            pXMLDom->get_documentElement(&pRoot);
-            if (pRoot) {
-                // 获取材质名
-                VARIANT varName;
-                VariantInit(&varName);
-                pRoot->getAttribute(_bstr_t("name"), &varName);
-                if (varName.vt == VT_BSTR && varName.bstrVal) {
-                    int len = WideCharToMultiByte(CP_UTF8, 0, varName.bstrVal, -1, nullptr, 0, nullptr, nullptr);
-                    if (len > 0) {
-                        materialName.resize(len - 1);
-                        WideCharToMultiByte(CP_UTF8, 0, varName.bstrVal, -1, &materialName[0], len, nullptr, nullptr);
-                    }
-                }
-                VariantClear(&varName);
-
-                // 获取shader引用
-                IXMLDOMNodeList* pShaderNodes = nullptr;
-                pRoot->getElementsByTagName(_bstr_t("Shader"), &pShaderNodes);
-                if (pShaderNodes) {
-                    IXMLDOMNode* pShaderNode = nullptr;
-                    pShaderNodes->get_item(0, &pShaderNode);
-                    if (pShaderNode) {
-                        BSTR shaderText = nullptr;
-                        pShaderNode->get_text(&shaderText);
-                        if (shaderText) {
-                            int len = WideCharToMultiByte(CP_UTF8, 0, shaderText, -1, nullptr, 0, nullptr, nullptr);
-                            if (len > 0) {
-                                shaderName.resize(len - 1);
-                                WideCharToMultiByte(CP_UTF8, 0, shaderText, -1, &shaderName[0], len, nullptr, nullptr);
-                            }
-                            SysFreeString(shaderText);
-                        }
-                        pShaderNode->Release();
-                    }
-                    pShaderNodes->Release();
-                }
-
-                pRoot->Release();
-            }
-        }
-        pXMLDom->Release();
+    // 读取材质数据（.matbin有效时不经过XML解析）
+    MaterialAssetData data;
+    bool cooked = false;
+    if (!MaterialAsset::Load(materialFilePath, data, &cooked)) {
+        LogMaterialError(GetMaterialNameFromPath(materialFilePath), "ERROR: Failed to read material file");
+        return nullptr;
     }
-    if (comInitialized) CoUninitialize();
+    LogMaterialInfo(std::string(cooked ? "Parsed XML and cooked matbin" : "Loaded matbin") +
+                    ". Material name: '" + data.name + "', Shader name: '" + data.shaderName + "'");
 
-    LogMaterialInfo("XML parsing completed. Material name: '" + materialName + "', Shader name: '" + shaderName + "'");
+    MaterialInstance* material = CreateMaterialFromAsset(materialFilePath, data);
+    if (material) {
+        LogMaterialSuccess(material->GetName(), data.shaderName);
+        LogMaterialInfo("========== LoadMaterial SUCCESS ==========");
+    }
+    return material;
+}
 
-    // 如果解析失败，使用文件名作为材质名
-    if (materialName.empty()) {
-        std::wstring fileName = materialFilePath;
-        size_t lastSlash = fileName.find_last_of(L"/\\");
-        if (lastSlash != std::wstring::npos) {
-            fileName = fileName.substr(lastSlash + 1);
-        }
-        size_t lastDot = fileName.find_last_of(L".");
-        if (lastDot != std::wstring::npos) {
-            fileName = fileName.substr(0, lastDot);
-        }
-        int len = WideCharToMultiByte(CP_UTF8, 0, fileName.c_str(), -1, nullptr, 0, nullptr, nullptr);
-        if (len > 0) {
-            materialName.resize(len - 1);
-            WideCharToMultiByte(CP_UTF8, 0, fileName.c_str(), -1, &materialName[0], len, nullptr, nullptr);
+std::vector<MaterialInstance*> MaterialManager::LoadMaterials(const std::vector<std::wstring>& materialFilePaths) {
+    std::vector<MaterialInstance*> materials(materialFilePaths.size(), nullptr);
+    if (!m_device) {
+        LogMaterialError("CRITICAL", "ERROR: MaterialManager device is NULL! Call Initialize() first.");
+        return materials;
+    }
+
+    // 1. 工作线程并行读取材质数据（只访问文件系统；过期的.matbin在各线程上重新烘焙）
+    const auto startTime = std::chrono::steady_clock::now();
+    std::vector<MaterialAssetData> assets(materialFilePaths.size());
+    std::vector<char> loaded(materialFilePaths.size(), 0);
+    std::atomic<int> cookedCount(0);
+    ParallelFor(materialFilePaths.size(), [&](size_t i) {
+        bool cooked = false;
+        loaded[i] = MaterialAsset::Load(materialFilePaths[i], assets[i], &cooked) ? 1 : 0;
+        if (cooked) ++cookedCount;
+    });
+    const auto readTime = std::chrono::steady_clock::now();
+
+    // 2. 主线程按原顺序创建实例（shader加载、GPU资源和纹理都在主线程）
+    int createdCount = 0;
+    for (size_t i = 0; i < materialFilePaths.size(); ++i) {
+        if (!loaded[i]) {
+            LogMaterialError(GetMaterialNameFromPath(materialFilePaths[i]), "ERROR: Failed to read material file");
+            continue;
         }
+        materials[i] = CreateMaterialFromAsset(materialFilePaths[i], assets[i]);
+        if (materials[i]) ++createdCount;
+    }
+    const auto endTime = std::chrono::steady_clock::now();
+
+    // 批量加载只写一条汇总日志（逐个材质打开日志文件的开销比读取材质本身还大）
+    std::ostringstream summary;
+    summary << "Loaded " << createdCount << "/" << materialFilePaths.size() << " materials ("
+            << cookedCount.load() << " cooked from XML): read "
+            << std::chrono::duration<double, std::milli>(readTime - startTime).count() << " ms, create "
+            << std::chrono::duration<double, std::milli>(endTime - readTime).count() << " ms";
+    std::cout << summary.str() << std::endl;
+    LogMaterialInfo(summary.str());
+    return materials;
+}
+
+std::string MaterialManager::GetMaterialNameFromPath(const std::wstring& materialFilePath) {
+    std::wstring fileName = materialFilePath;
+    size_t lastSlash = fileName.find_last_of(L"/\\");
+    if (lastSlash != std::wstring::npos) {
+        fileName = fileName.substr(lastSlash + 1);
     }
+    size_t lastDot = fileName.find_last_of(L".");
+    if (lastDot != std::wstring::npos) {
+        fileName = fileName.substr(0, lastDot);
+    }
+    return WToA(fileName);
+}
 
-    LogMaterialInfo("Final material name: '" + materialName + "'");
+MaterialInstance* MaterialManager::CreateMaterialFromAsset(const std::wstring& materialFilePath, const MaterialAssetData& data) {
+    // 文件中没有名称时使用文件名作为材质名
+    const std::string materialName = data.name.empty() ? GetMaterialNameFromPath(materialFilePath) : data.name;
+    const std::string& shaderName = data.shaderName;
 
     // 检查是否已加载
     auto it = m_materials.find(materialName);
     if (it != m_materials.end()) {
-        LogMaterialInfo("Material '" + materialName + "' found in cache, returning cached version");
         return it->second.get();
     }
 
-    LogMaterialInfo("Material not in cache, loading shader '" + shaderName + "'...");
-
-    // 第二步：加载shader
+    // 加载shader
     Shader* shader = nullptr;
     if (!shaderName.empty()) {
         shader = GetShader(shaderName);
         if (!shader) {
-            LogMaterialInfo("Shader '" + shaderName + "' not found in cache, loading from file...");
             // Shader未加载，尝试加载
             std::wstring shaderPath = L"Engine/Shader/" + std::wstring(shaderName.begin(), shaderName.end()) + L".shader";
             shader = LoadShader(shaderPath);
-        } else {
-            LogMaterialInfo("Shader '" + shaderName + "' found in cache");
         }
     }
 
@@ -410,18 +461,9 @@ MaterialInstance* MaterialManager::LoadMaterial(const std::wstring& materialFile
         return nullptr;
     }
 
-    LogMaterialInfo("Shader loaded successfully, creating material instance...");
-
-    // 第三步：创建材质实例
+    // 创建材质实例并应用参数
     auto material = std::make_unique<MaterialInstance>(materialName, shader);
-
-    // 从XML加载参数
-    if (!material->LoadFromXML(materialFilePath)) {
-        LogMaterialError(materialName, "ERROR: Failed to load material parameters from XML");
-        return nullptr;
-    }
-
-    LogMaterialInfo("Material parameters loaded from XML, initializing GPU resources...");
+    material->ApplyAssetData(data, materialFilePath);
 
     // 初始化GPU资源
     if (!material->Initialize(m_device)) {
@@ -429,49 +471,20 @@ MaterialInstance* MaterialManager::LoadMaterial(const std::wstring& materialFile
         return nullptr;
     }
 
-    LogMaterialInfo("GPU resources initialized successfully");
-
-    // 尝试加载材质中指定的纹理（如果commandList可用）
+    // 尝试加载材质中指定的纹理（如果commandList可用，否则之后再加载）
     extern ID3D12GraphicsCommandList* gCommandList;
     if (gCommandList) {
-        LogMaterialInfo("gCommandList is VALID, loading textures...");
-        if (material->LoadTexturesFromPaths(gCommandList)) {
-            LogMaterialInfo("Textures loaded successfully");
-        } else {
-            LogMaterialInfo("No textures loaded (may have no texture paths or already loaded)");
-        }
-    } else {
-        LogMaterialInfo("WARNING: gCommandList is NULL, textures will be loaded later when available");
+        material->LoadTexturesFromPaths(gCommandList);
     }
 
     MaterialInstance* materialPtr = material.get();
     m_materials[materialName] = std::move(material);
-
-    // 记录成功日志
-    LogMaterialSuccess(materialName, shaderName);
-    LogMaterialInfo("========== LoadMaterial SUCCESS ==========");
-
     return materialPtr;
 }
 
 MaterialInstance* MaterialManager::ReloadMaterial(const std::wstring& materialFilePath) {
     // 提取材质名称
-    std::wstring fileName = materialFilePath;
-    size_t lastSlash = fileName.find_last_of(L"/\\");
-    if (lastSlash != std::wstring::npos) {
-        fileName = fileName.substr(lastSlash + 1);
-    }
-    size_t lastDot = fileName.find_last_of(L".");
-    if (lastDot != std::wstring::npos) {
-        fileName = fileName.substr(0, lastDot);
-    }
-
-    std::string materialName;
-    int len = WideCharToMultiByte(CP_UTF8, 0, fileName.c_str(), -1, nullptr, 0, nullptr, nullptr);
-    if (len > 0) {
-        materialName.resize(len - 1);
-        WideCharToMultiByte(CP_UTF8, 0, fileName.c_str(), -1, &materialName[0], len, nullptr, nullptr);
-    }
+    std::string materialName = GetMaterialNameFromPath(materialFilePath);
 
     // 从缓存中移除旧材质
     auto it = m_materials.find(materialName);
@@ -483,6 +496,163 @@ MaterialInstance* MaterialManager::ReloadMaterial(const std::wstring& materialFi
     return LoadMaterial(materialFilePath);
 }
 
+// ========== 热重载 ==========
+
+bool MaterialManager::HotReloadShader(const std::wstring& shaderFilePath) {
+    const std::wstring key = NormalizePathKey(shaderFilePath);
+    for (auto& pair : m_shaders) {
+        Shader* shader = pair.second.get();
+        if (shader && !shader->GetFilePath().empty() && NormalizePathKey(shader->GetFilePath()) == key) {
+            return SubmitShaderReloads(std::vector<Shader*>(1, shader)) > 0;
+        }
+    }
+    return false;
+}
+
+std::vector<ShaderPassRef> MaterialManager::FindPassesIncluding(const std::wstring& includePath) const {
+    std::vector<ShaderPassRef> passes;
+    const std::wstring key = NormalizePathKey(includePath);
+    for (const auto& pair : m_shaders) {
+        if (!pair.second) continue;
+        for (int passIndex : pair.second->GetPassesIncluding(key)) {
+            ShaderPassRef ref;
+            ref.shader = pair.second.get();
+            ref.passIndex = passIndex;
+            passes.push_back(ref);
+        }
+    }
+    return passes;
+}
+
+int MaterialManager::HotReloadShadersIncluding(const std::wstring& includePath) {
+    // 内容缓存可能和修改前的时间戳相同（保存过快），先丢弃，编译和命中校验都读到新内容
+    ShaderBytecodeCache::GetInstance().InvalidateIncludeFile(includePath);
+
+    const std::vector<ShaderPassRef> passes = FindPassesIncluding(includePath);
+    std::vector<Shader*> targets;
+    for (const ShaderPassRef& ref : passes) {
+        if (!ref.shader->GetFilePath().empty() &&
+            std::find(targets.begin(), targets.end(), ref.shader) == targets.end()) {
+            targets.push_back(ref.shader);
+        }
+    }
+    if (targets.empty()) {
+        std::cout << "Hot reload: no compiled shader pass includes " << WToA(includePath) << std::endl;
+        return 0;
+    }
+
+    std::cout << "Hot reload: " << WToA(includePath) << " is included by " << passes.size()
+              << " passes in " << targets.size() << " shaders" << std::endl;
+    return SubmitShaderReloads(targets);
+}
+
+int MaterialManager::SubmitShaderReloads(const std::vector<Shader*>& targets) {
+    std::vector<Shader*> reloadedShaders;
+    for (Shader* target : targets) {
+        auto reloaded = std::make_unique<Shader>(target->GetName());
+        if (!reloaded->LoadFromShaderFile(target->GetFilePath())) {
+            std::cout << "Hot reload: failed to parse " << WToA(target->GetFilePath()) << ", keeping previous version" << std::endl;
+            continue;
+        }
+        // 同一shader上一次热重载还没编译完时直接替换（旧的临时Shader析构时取消其编译）
+        reloadedShaders.push_back(reloaded.get());
+        m_pendingShaderReloads[target] = std::move(reloaded);
+    }
+    if (reloadedShaders.empty()) return 0;
+
+    std::cout << "Hot reload: recompiling " << reloadedShaders.size() << " shaders" << std::endl;
+    ShaderCompileQueue::GetInstance().CompileShadersAsync(reloadedShaders, [this](Shader* shader, bool success) {
+        auto it = m_pendingShaderReloads.begin();
+        while (it != m_pendingShaderReloads.end() && it->second.get() != shader) ++it;
+        if (it == m_pendingShaderReloads.end()) return;
+
+        Shader* target = it->first;
+        std::unique_ptr<Shader> reloaded = std::move(it->second);
+        m_pendingShaderReloads.erase(it);
+        if (!success) {
+            std::cout << "Hot reload: " << target->GetName() << " failed to compile, keeping previous version" << std::endl;
+            return;
+        }
+        if (m_rootSignature) {
+            for (int i = 0; i < reloaded->GetPassCount(); i++) {
+                reloaded->CreatePSO(m_device, m_rootSignature, i);
+            }
+        }
+
+        // 旧版本独有的字节码（新版本里没有相同内容的）对应的PSO不会再被用到
+        std::vector<uint64_t> replacedHashes, currentHashes;
+        target->AppendBytecodeHashes(replacedHashes);
+        reloaded->AppendBytecodeHashes(currentHashes);
+        replacedHashes.erase(std::remove_if(replacedHashes.begin(), replacedHashes.end(), [&](uint64_t hash) {
+            return std::find(currentHashes.begin(), currentHashes.end(), hash) != currentHashes.end();
+        }), replacedHashes.end());
+
+        // 在录制本帧命令之前替换：之前的帧引用的常量缓冲区、PSO等提交的栅栏值完成后再释放
+        const std::vector<ShaderParameter> oldParameters = target->GetParameters();
+        target->AdoptReloaded(*reloaded);
+        const UINT64 fenceValue = GetSubmittedFenceValue();
+        const int evictedCount = PipelineStateCache::GetInstance().EvictShaders(replacedHashes, fenceValue);
+        int materialCount = 0;
+        for (auto& pair : m_materials) {
+            MaterialInstance* material = pair.second.get();
+            if (!material || material->GetShader() != target) continue;
+            RetiredResource retired;
+            retired.resource = material->OnShaderReloaded(m_device, oldParameters);
+            retired.fenceValue = fenceValue;
+            if (retired.resource) m_retiredResources.push_back(retired);
+            materialCount++;
+        }
+
+        // 编译期间又注册了新的ShadingModel：下次RecompileStaleShadingModels重新检查
+        if (target->IsShadingModelSetStale()) {
+            m_compiledShadingModelSetHash = 0;
+        }
+        std::cout << "Hot reloaded shader " << target->GetName() << " (" << materialCount << " materials, "
+                  << evictedCount << " PSOs evicted)" << std::endl;
+    });
+    return (int)reloadedShaders.size();
+}
+
+bool MaterialManager::HotReloadMaterial(const std::wstring& materialFilePath, ID3D12GraphicsCommandList* commandList) {
+    const std::wstring key = NormalizePathKey(materialFilePath);
+    for (auto& pair : m_materials) {
+        MaterialInstance* material = pair.second.get();
+        if (!material || material->GetFilePath().empty() || NormalizePathKey(material->GetFilePath()) != key) {
+            continue;
+        }
+        if (!material->ReloadFromFile(materialFilePath)) return false;
+        if (commandList && material->HasPendingTextures()) {
+            material->LoadTexturesFromPaths(commandList);
+        }
+        std::cout << "Hot reloaded material " << pair.first << std::endl;
+        return true;
+    }
+    return false;
+}
+
+int MaterialManager::RefreshTextureBindings(const TextureAsset* texture) {
+    int count = 0;
+    for (auto& pair : m_materials) {
+        if (pair.second && pair.second->RefreshTexture(texture)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void MaterialManager::ReleaseRetiredResources() {
+    const UINT64 completed = GetCompletedFenceValue();
+    for (size_t i = 0; i < m_retiredResources.size();) {
+        if (m_retiredResources[i].fenceValue <= completed) {
+            m_retiredResources[i].resource->Release();
+            m_retiredResources[i] = m_retiredResources.back();
+            m_retiredResources.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
 MaterialInstance* MaterialManager::CreateMaterial(const std::string& name, Shader* shader) {
     if (!m_device || !shader) return nullptr;
 
@@ -1,8 +1,14 @@
 #include "public/Material/Shader.h"
 #include "public/Material/ShaderParser.h"
+#include "public/Material/ShaderBytecodeCache.h"
+#include "public/Material/ShaderCompileQueue.h"
 #include "public/Material/MaterialManager.h"
+#include "public/Material/ShadingModelRegistry.h"
 #include "public/BattleFireDirect.h"
+#include "public/PipelineStateCache.h"
+#include "public/PathUtils.h"
 #include <d3dx12.h>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -14,70 +20,6 @@
 #pragma comment(lib, "msxml6.lib")
 #pragma comment(lib, "shlwapi.lib")
 
-// 全局ShadingModel收集器
-std::map<int, ShaderParser::ShadingModelDefinition> g_shadingModels;
-static bool g_screenNeedsRecompile = false;  // 标记Screen.hlsl是否需要重新编译
-static bool g_isRecompilingScreen = false;  // 防止递归：标记正在重新编译Screen shader
-
-// 全局函数实现：检查并重新编译Screen shader
-bool CheckAndRecompileScreen(ID3D12Device* device, ID3D12RootSignature* rootSig, MaterialManager* matMgr) {
-    // 如果正在重新编译Screen shader，跳过（防止递归）
-    if (g_isRecompilingScreen) {
-        return false;
-    }
-
-    std::cout << "[DEBUG] CheckAndRecompileScreen called. g_screenNeedsRecompile = " << g_screenNeedsRecompile << std::endl;
-    std::cout << "[DEBUG] g_shadingModels size = " << g_shadingModels.size() << std::endl;
-
-    if (!g_screenNeedsRecompile) {
-        std::cout << "[DEBUG] g_screenNeedsRecompile is false, skipping Screen recompile" << std::endl;
-        return false;  // 不需要重新编译
-    }
-
-    if (!matMgr) {
-        std::cout << "ERROR: MaterialManager is NULL, cannot update Screen shader" << std::endl;
-        return false;
-    }
-
-    std::cout << "========== Recompiling Screen shader with " << g_shadingModels.size() << " ShadingModels... ==========" << std::endl;
-
-    // 设置标志：正在重新编译Screen shader（防止递归）
-    g_isRecompilingScreen = true;
-
-    // 从MaterialManager的缓存中移除旧的Screen shader
-    std::cout << "[DEBUG] Clearing Screen shader cache..." << std::endl;
-    matMgr->ClearShaderCache("Screen");
-
-    // 直接调用LoadShader来重新加载Screen
-    // 这会触发编译并自动创建PSO，并存储到MaterialManager的缓存中
-    std::cout << "[DEBUG] Reloading Screen shader from file..." << std::endl;
-    Shader* newScreenShader = matMgr->LoadShader(L"Engine/Shader/Shadingmodel/Screen.shader");
-
-    // DEBUG: 立即检查Screen shader是否被缓存
-    std::ofstream debugLog("Engine/Shader/Shader_Cache/log/cache_debug.txt", std::ios::app);
-    if (debugLog.is_open()) {
-        debugLog << "[CheckAndRecompileScreen] After LoadShader, checking if Screen is cached..." << std::endl;
-        Shader* cachedScreen = matMgr->GetShader("Screen");
-        if (cachedScreen) {
-            debugLog << "[CheckAndRecompileScreen] SUCCESS: Screen shader IS in cache!" << std::endl;
-        } else {
-            debugLog << "[CheckAndRecompileScreen] ERROR: Screen shader NOT in cache after LoadShader!" << std::endl;
-        }
-    }
-
-    // 清除标志：Screen shader重新编译完成
-    g_isRecompilingScreen = false;
-
-    if (!newScreenShader) {
-        std::cout << "ERROR: Failed to reload Screen shader" << std::endl;
-        return false;
-    }
-
-    std::cout << "========== Screen shader recompiled successfully with " << g_shadingModels.size() << " ShadingModels ==========" << std::endl;
-    g_screenNeedsRecompile = false;
-    return true;
-}
-
 // 辅助函数：BSTR to std::string
 std::string BSTRToString(BSTR bstr) {
     if (!bstr) return "";
@@ -94,28 +36,6 @@ std::wstring BSTRToWString(BSTR bstr) {
     return std::wstring(bstr);
 }
 
-// 辅助函数：递归创建目录
-bool CreateDirectoryRecursive(const std::wstring& path) {
-    // 检查目录是否已存在
-    DWORD attribs = GetFileAttributesW(path.c_str());
-    if (attribs != INVALID_FILE_ATTRIBUTES && (attribs & FILE_ATTRIBUTE_DIRECTORY)) {
-        return true;  // 目录已存在
-    }
-
-    // 查找最后一个路径分隔符
-    size_t pos = path.find_last_of(L"\\/");
-    if (pos != std::wstring::npos) {
-        // 递归创建父目录
-        std::wstring parentPath = path.substr(0, pos);
-        if (!CreateDirectoryRecursive(parentPath)) {
-            return false;
-        }
-    }
-
-    // 创建当前目录
-    return CreateDirectoryW(path.c_str(), NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
-}
-
 Shader::Shader(const std::string& name)
     : m_name(name)
     , m_constantBufferSize(256)  // 默认256字节
@@ -133,6 +53,10 @@ Shader::Shader(const std::string& name)
 }
 
 Shader::~Shader() {
+    // 还没回填的异步编译不再写回这个Shader
+    ShaderCompileQueue::GetInstance().Cancel(this);
+    ReleaseVariants();
+
     // 清理所有Pass的PSO
     for (auto& pass : m_passes) {
         if (pass.pso) {
@@ -462,135 +386,240 @@ bool Shader::LoadFromXML(const std::wstring& filePath) {
 }
 
 bool Shader::CompileShaders(ID3D12Device* device) {
-    if (m_useGeneratedHLSL) {
-        // 编译所有Pass
-        for (size_t i = 0; i < m_passes.size(); ++i) {
-            auto& pass = m_passes[i];
-
-            std::cout << "Compiling Pass " << i << " (" << pass.name << ")..." << std::endl;
-
-            // 编译VS
-            ID3DBlob* vsBlob = nullptr;
-            ID3DBlob* errorBlob = nullptr;
-
-            HRESULT hr = D3DCompile(
-                pass.generatedHLSL.c_str(),
-                pass.generatedHLSL.size(),
-                nullptr,
-                nullptr,
-                D3D_COMPILE_STANDARD_FILE_INCLUDE,
-                pass.vsEntry.c_str(),
-                "vs_5_1",  // 升级到5.1以支持Bindless纹理(space语法)
-                D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
-                0,
-                &vsBlob,
-                &errorBlob
-            );
-
-            if (FAILED(hr)) {
-                if (errorBlob) {
-                    std::string errorMsg = (char*)errorBlob->GetBufferPointer();
-                    std::cout << "======================================" << std::endl;
-                    std::cout << "Vertex shader compilation FAILED (Pass " << pass.name << "): " << std::endl;
-                    std::cout << errorMsg << std::endl;
-                    std::cout << "======================================" << std::endl;
-
-                    // 输出错误到文件（使用Pass名称）
-                    std::ofstream errFile("Engine/Shader/" + pass.name + "_VS_Error.txt");
-                    if (errFile.is_open()) {
-                        errFile << errorMsg;
-                        errFile.close();
-                    }
+    // 所有Pass的VS/PS作为独立任务并行编译，完成后按Pass顺序回填
+    std::vector<ShaderCompileJob> jobs;
+    UpdateShadingModelSources();
+    AppendCompileJobs(jobs);
+    ShaderCompileQueue::GetInstance().Execute(jobs);
+    return ApplyCompileJobs(jobs.data(), jobs.size());
+}
 
-                    // 弹出MessageBox显示详细错误
-                    std::string title = "VS Compilation Error - " + pass.name;
-                    MessageBoxA(NULL, errorMsg.c_str(), title.c_str(), MB_OK | MB_ICONERROR);
+void Shader::AppendCompileJobs(std::vector<ShaderCompileJob>& outJobs) const {
+    if (!m_useGeneratedHLSL) return;  // 旧方式在ApplyCompileJobs中串行编译
 
-                    errorBlob->Release();
-                }
-                return false;
-            }
+    for (size_t i = 0; i < m_passes.size(); ++i) {
+        AppendPassCompileJobs(outJobs, (int)i, m_defaultVariantKey & m_passes[i].keywordMask, false);
+    }
+}
 
-            pass.vsBlob.Attach(vsBlob);
-            pass.vsBytecode.pShaderBytecode = vsBlob->GetBufferPointer();
-            pass.vsBytecode.BytecodeLength = vsBlob->GetBufferSize();
-
-            // 编译PS
-            ID3DBlob* psBlob = nullptr;
-            errorBlob = nullptr;
-
-            hr = D3DCompile(
-                pass.generatedHLSL.c_str(),
-                pass.generatedHLSL.size(),
-                nullptr,
-                nullptr,
-                D3D_COMPILE_STANDARD_FILE_INCLUDE,
-                pass.psEntry.c_str(),
-                "ps_5_1",  // 升级到5.1以支持Bindless纹理(space语法)
-                D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
-                0,
-                &psBlob,
-                &errorBlob
-            );
-
-            if (FAILED(hr)) {
-                if (errorBlob) {
-                    std::string errorMsg = (char*)errorBlob->GetBufferPointer();
-                    std::cout << "======================================" << std::endl;
-                    std::cout << "Pixel shader compilation FAILED (Pass " << pass.name << "): " << std::endl;
-                    std::cout << errorMsg << std::endl;
-                    std::cout << "======================================" << std::endl;
-
-                    // 输出错误到文件（使用Pass名称）
-                    std::ofstream errFile("Engine/Shader/" + pass.name + "_PS_Error.txt");
-                    if (errFile.is_open()) {
-                        errFile << errorMsg;
-                        errFile.close();
-                    }
+void Shader::AppendVariantCompileJobs(std::vector<ShaderCompileJob>& outJobs, int passIndex, ShaderVariantKey key) const {
+    if (!m_useGeneratedHLSL || passIndex < 0 || passIndex >= (int)m_passes.size()) return;
 
-                    // 弹出MessageBox显示详细错误
-                    std::string title = "PS Compilation Error - " + pass.name;
-                    MessageBoxA(NULL, errorMsg.c_str(), title.c_str(), MB_OK | MB_ICONERROR);
+    const ShaderVariantKey passKey = key & m_passes[passIndex].keywordMask;
+    AppendPassCompileJobs(outJobs, passIndex, passKey, !IsDefaultVariant(m_passes[passIndex], passKey));
+}
 
-                    errorBlob->Release();
-                }
-                return false;
-            }
+void Shader::AppendPassCompileJobs(std::vector<ShaderCompileJob>& outJobs, int passIndex,
+                                   ShaderVariantKey passKey, bool isVariant) const {
+    const PassInfo& pass = m_passes[passIndex];
+
+    ShaderCompileJob vsJob;
+    vsJob.shader = const_cast<Shader*>(this);
+    vsJob.passIndex = passIndex;
+    vsJob.stage = ShaderStage::Vertex;
+    vsJob.source = pass.generatedHLSL;
+    vsJob.sourceName = WToA(m_filePath);
+    vsJob.entryPoint = pass.vsEntry;
+    vsJob.target = "vs_5_1";  // 升级到5.1以支持Bindless纹理(space语法)
+    vsJob.isVariant = isVariant;
+    vsJob.variantKey = passKey;
+    m_keywords.GetDefines(passKey, pass.keywordMask, vsJob.defines);
+    outJobs.push_back(vsJob);
+
+    ShaderCompileJob psJob = vsJob;
+    psJob.stage = ShaderStage::Pixel;
+    psJob.entryPoint = pass.psEntry;
+    psJob.target = "ps_5_1";
+    outJobs.push_back(psJob);
+}
 
-            pass.psBlob.Attach(psBlob);
-            pass.psBytecode.pShaderBytecode = psBlob->GetBufferPointer();
-            pass.psBytecode.BytecodeLength = psBlob->GetBufferSize();
+bool Shader::ApplyCompileJobs(const ShaderCompileJob* jobs, size_t jobCount) {
+    if (!m_useGeneratedHLSL) {
+        return CompileLegacyShaders();
+    }
+
+    // 按Pass顺序、先VS后PS报告，多线程编译的输出顺序与串行编译一致
+    bool success = true;
+    for (size_t i = 0; i < jobCount; ++i) {
+        const ShaderCompileJob& job = jobs[i];
+        if (job.passIndex < 0 || job.passIndex >= (int)m_passes.size()) {
+            // 提交后Shader被重新加载，Pass数量变了；这批结果已过期
+            success = false;
+            continue;
+        }
+
+        PassInfo& pass = m_passes[job.passIndex];
+        const bool isVertex = job.stage == ShaderStage::Vertex;
+
+        if (job.isVariant) {
+            if (!ApplyVariantCompileJob(pass, job)) success = false;
+            continue;
+        }
 
+        if (i == 0 || jobs[i - 1].passIndex != job.passIndex) {
+            std::cout << "Compiling Pass " << job.passIndex << " (" << pass.name << ")..." << std::endl;
+            pass.includeFiles.clear();  // 默认变体重新编译：去掉源码里已经删除的include
+        }
+        // 失败时也记录，修好include后能找到这个Pass
+        RecordPassIncludes(pass, job);
+
+        if (FAILED(job.result) || !job.code) {
+            ReportCompileError(pass.name, isVertex, job.errors);
+            success = false;
+            continue;
+        }
+
+        if (isVertex) {
+            pass.vsBlob = job.code;
+            pass.vsBytecode.pShaderBytecode = job.code->GetBufferPointer();
+            pass.vsBytecode.BytecodeLength = job.code->GetBufferSize();
+        } else {
+            pass.psBlob = job.code;
+            pass.psBytecode.pShaderBytecode = job.code->GetBufferPointer();
+            pass.psBytecode.BytecodeLength = job.code->GetBufferSize();
             std::cout << "Pass " << pass.name << " compiled successfully." << std::endl;
         }
+    }
 
+    return success;
+}
+
+bool Shader::ApplyVariantCompileJob(PassInfo& pass, const ShaderCompileJob& job) {
+    auto it = pass.variants.find(job.variantKey);
+    if (it == pass.variants.end() || it->second.state != PassVariant::State::Compiling ||
+        job.source != pass.generatedHLSL) {
+        // 提交后Shader被重新加载、光照Pass换了着色模型集合（源码已变），或同一变体被重复提交，丢弃
         return true;
-    } else {
-        // 原有的文件编译方式（已废弃，保留向后兼容）
-        // 编译VS
-        D3D12_SHADER_BYTECODE vsBytecode;
-        CreateShaderFromFile(m_vsPath.c_str(), m_vsEntryPoint.c_str(), "vs_5_0", &vsBytecode);
-
-        // 检查VS编译是否成功
-        if (vsBytecode.pShaderBytecode == nullptr || vsBytecode.BytecodeLength == 0) {
-            return false;
+    }
+
+    PassVariant& variant = it->second;
+    const bool isVertex = job.stage == ShaderStage::Vertex;
+    RecordPassIncludes(pass, job);
+    const std::string variantName = pass.name + " [" + m_keywords.ToString(job.variantKey) + "]";
+    if (FAILED(job.result) || !job.code) {
+        // 变体失败时继续使用默认变体，只输出错误不弹窗
+        std::cout << (isVertex ? "Vertex" : "Pixel") << " shader variant compilation FAILED ("
+                  << m_name << " " << variantName << "):" << std::endl << job.errors << std::endl;
+        variant.state = PassVariant::State::Failed;
+        return false;
+    }
+
+    if (isVertex) {
+        variant.vsBlob = job.code;
+        return true;
+    }
+    variant.psBlob = job.code;
+    if (!variant.vsBlob) {
+        variant.state = PassVariant::State::Failed;
+        return false;
+    }
+
+    variant.state = PassVariant::State::Ready;
+    std::cout << "Shader variant " << m_name << " " << variantName << " compiled" << std::endl;
+    // 还没调用过CreatePSO时不知道根签名，PSO在第一次GetVariantPSO时创建
+    CreateVariantPSO(job.passIndex, variant);
+    return true;
+}
+
+void Shader::RecordPassIncludes(PassInfo& pass, const ShaderCompileJob& job) {
+    for (const std::string& include : job.includes) {
+        const std::wstring key = NormalizePathKey(AToW(include));
+        if (std::find(pass.includeFiles.begin(), pass.includeFiles.end(), key) == pass.includeFiles.end()) {
+            pass.includeFiles.push_back(key);
         }
+    }
+}
 
-        // 编译PS
-        D3D12_SHADER_BYTECODE psBytecode;
-        CreateShaderFromFile(m_psPath.c_str(), m_psEntryPoint.c_str(), "ps_5_0", &psBytecode);
+std::vector<int> Shader::GetPassesIncluding(const std::wstring& fileKey) const {
+    std::vector<int> passIndices;
+    for (size_t i = 0; i < m_passes.size(); ++i) {
+        const std::vector<std::wstring>& includeFiles = m_passes[i].includeFiles;
+        if (std::find(includeFiles.begin(), includeFiles.end(), fileKey) != includeFiles.end()) {
+            passIndices.push_back((int)i);
+        }
+    }
+    return passIndices;
+}
 
-        // 检查PS编译是否成功
-        if (psBytecode.pShaderBytecode == nullptr || psBytecode.BytecodeLength == 0) {
-            return false;
+void Shader::AppendBytecodeHashes(std::vector<uint64_t>& outHashes) const {
+    for (const auto& pass : m_passes) {
+        outHashes.push_back(PipelineStateCache::HashShaderBytecode(pass.vsBytecode));
+        outHashes.push_back(PipelineStateCache::HashShaderBytecode(pass.psBytecode));
+        for (const auto& pair : pass.variants) {
+            const PassVariant& variant = pair.second;
+            if (variant.vsBlob) {
+                outHashes.push_back(PipelineStateCache::HashShaderBytecode(
+                    { variant.vsBlob->GetBufferPointer(), variant.vsBlob->GetBufferSize() }));
+            }
+            if (variant.psBlob) {
+                outHashes.push_back(PipelineStateCache::HashShaderBytecode(
+                    { variant.psBlob->GetBufferPointer(), variant.psBlob->GetBufferSize() }));
+            }
         }
+    }
+}
 
-        // 保存bytecode（注意：这些bytecode由D3DCompileFromFile分配，需要保持）
-        m_vsBytecode = vsBytecode;
-        m_psBytecode = psBytecode;
+bool Shader::CreateVariantPSO(int passIndex, PassVariant& variant) {
+    if (variant.pso) return true;
+    if (!m_pipelineDevice || !m_pipelineRootSignature || !variant.vsBlob || !variant.psBlob) return false;
 
-        return true;
+    D3D12_SHADER_BYTECODE vs = { variant.vsBlob->GetBufferPointer(), variant.vsBlob->GetBufferSize() };
+    D3D12_SHADER_BYTECODE ps = { variant.psBlob->GetBufferPointer(), variant.psBlob->GetBufferSize() };
+    variant.pso = CreatePassPSO(m_pipelineDevice, m_pipelineRootSignature, passIndex, vs, ps);
+    if (!variant.pso) {
+        std::cout << "Failed to create PSO for shader variant of " << m_name << " Pass " << passIndex << std::endl;
+        variant.state = PassVariant::State::Failed;
+        return false;
+    }
+    return true;
+}
+
+void Shader::ReportCompileError(const std::string& passName, bool isVertex, const std::string& errorMsg) {
+    const char* stageName = isVertex ? "VS" : "PS";
+    std::cout << "======================================" << std::endl;
+    std::cout << (isVertex ? "Vertex" : "Pixel") << " shader compilation FAILED (Pass " << passName << "): " << std::endl;
+    std::cout << errorMsg << std::endl;
+    std::cout << "======================================" << std::endl;
+
+    if (errorMsg.empty()) return;
+
+    // 输出错误到文件（使用Pass名称）
+    std::ofstream errFile("Engine/Shader/" + passName + "_" + stageName + "_Error.txt");
+    if (errFile.is_open()) {
+        errFile << errorMsg;
+        errFile.close();
     }
+
+    // 弹出MessageBox显示详细错误
+    std::string title = std::string(stageName) + " Compilation Error - " + passName;
+    MessageBoxA(NULL, errorMsg.c_str(), title.c_str(), MB_OK | MB_ICONERROR);
+}
+
+bool Shader::CompileLegacyShaders() {
+    // 原有的文件编译方式（已废弃，保留向后兼容）
+    // 编译VS
+    D3D12_SHADER_BYTECODE vsBytecode;
+    CreateShaderFromFile(m_vsPath.c_str(), m_vsEntryPoint.c_str(), "vs_5_0", &vsBytecode);
+
+    // 检查VS编译是否成功
+    if (vsBytecode.pShaderBytecode == nullptr || vsBytecode.BytecodeLength == 0) {
+        return false;
+    }
+
+    // 编译PS
+    D3D12_SHADER_BYTECODE psBytecode;
+    CreateShaderFromFile(m_psPath.c_str(), m_psEntryPoint.c_str(), "ps_5_0", &psBytecode);
+
+    // 检查PS编译是否成功
+    if (psBytecode.pShaderBytecode == nullptr || psBytecode.BytecodeLength == 0) {
+        return false;
+    }
+
+    // 保存bytecode（注意：这些bytecode由D3DCompileFromFile分配，需要保持）
+    m_vsBytecode = vsBytecode;
+    m_psBytecode = psBytecode;
+
+    return true;
 }
 
 ID3D12PipelineState* Shader::CreatePSO(ID3D12Device* device, ID3D12RootSignature* rootSig, int passIndex) {
@@ -600,12 +629,30 @@ ID3D12PipelineState* Shader::CreatePSO(ID3D12Device* device, ID3D12RootSignature
     }
 
     auto& pass = m_passes[passIndex];
+    // 重新编译后再次创建：旧PSO仍由PipelineStateCache持有（热重载移除后由其延迟释放），GPU上正在使用的帧不受影响
+    if (pass.pso) {
+        pass.pso->Release();
+    }
+    pass.pso = CreatePassPSO(device, rootSig, passIndex, pass.vsBytecode, pass.psBytecode);
+
+    // 之后编译完成的变体用同样的设备和根签名创建PSO
+    m_pipelineDevice = device;
+    m_pipelineRootSignature = rootSig;
+
+    std::cout << "Created PSO for Pass " << passIndex << " (" << pass.name << ")" << std::endl;
+
+    return pass.pso;
+}
+
+ID3D12PipelineState* Shader::CreatePassPSO(ID3D12Device* device, ID3D12RootSignature* rootSig, int passIndex,
+                                           const D3D12_SHADER_BYTECODE& vs, const D3D12_SHADER_BYTECODE& ps) const {
+    ID3D12PipelineState* pso = nullptr;
 
     // 根据RenderQueue和Pass索引决定使用哪种PSO创建方式
     if (m_renderQueue == "Deferred") {
         if (passIndex == 0) {
             // Pass 0: GBuffer填充 - 使用scene mesh的input layout
-            pass.pso = CreateScenePSO(rootSig, pass.vsBytecode, pass.psBytecode);
+            pso = CreateScenePSO(rootSig, vs, ps);
         }
         else if (passIndex == 1) {
             // Pass 1: 延迟光照（ScreenPass）- 使用screen quad的input layout
@@ -617,8 +664,8 @@ ID3D12PipelineState* Shader::CreatePSO(ID3D12Device* device, ID3D12RootSignature
             D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc{};
             psoDesc.InputLayout = { screenInputLayout, _countof(screenInputLayout) };
             psoDesc.pRootSignature = rootSig;
-            psoDesc.VS = pass.vsBytecode;
-            psoDesc.PS = pass.psBytecode;
+            psoDesc.VS = vs;
+            psoDesc.PS = ps;
             psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
             psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;  // 全屏quad不需要背面剔除
 
@@ -642,17 +689,15 @@ ID3D12PipelineState* Shader::CreatePSO(ID3D12Device* device, ID3D12RootSignature
             psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;  // 交换链格式
             psoDesc.SampleDesc.Count = 1;
 
-            device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pass.pso));
+            PipelineStateCache::GetInstance().CreateGraphicsPipelineState(device, psoDesc, &pso);
         }
     }
     else {
         // Forward渲染：使用scene mesh的input layout
-        pass.pso = CreateScenePSO(rootSig, pass.vsBytecode, pass.psBytecode);
+        pso = CreateScenePSO(rootSig, vs, ps);
     }
 
-    std::cout << "Created PSO for Pass " << passIndex << " (" << pass.name << ")" << std::endl;
-
-    return pass.pso;
+    return pso;
 }
 
 const ShaderParameter* Shader::GetParameter(const std::string& name) const {
@@ -695,6 +740,7 @@ bool Shader::LoadFromShaderFile(const std::wstring& filePath) {
 
     // 获取shader名称
     m_name = parser.GetShaderName();
+    m_filePath = filePath;
 
     // 获取参数列表
     m_parameters = parser.GenerateShaderParameters();
@@ -705,28 +751,9 @@ bool Shader::LoadFromShaderFile(const std::wstring& filePath) {
     // 获取渲染队列类型（Shader级别）
     m_renderQueue = parser.GetRenderQueue();
 
-    // 如果定义了ShadingModel，注册到全局表
+    // 如果定义了ShadingModel，注册到全局表（延迟光照Pass在提交编译时按最新集合生成）
     if (parser.HasShadingModel()) {
-        const auto& sm = parser.GetShadingModel();
-        std::cout << "[DEBUG] Shader '" << m_name << "' has ShadingModel with ID " << sm.shadingModelID << std::endl;
-
-        if (g_shadingModels.find(sm.shadingModelID) == g_shadingModels.end()) {
-            g_shadingModels[sm.shadingModelID] = sm;
-            g_screenNeedsRecompile = true;  // 标记Screen需要重新编译
-
-            std::cout << "[DEBUG] NEW ShadingModel registered! Setting g_screenNeedsRecompile = true" << std::endl;
-            std::cout << "[DEBUG] Total ShadingModels now: " << g_shadingModels.size() << std::endl;
-
-            // 删除旧的Screen.hlsl缓存，强制重新生成
-            DeleteFileW(L"Engine/Shader/Shader_Cache/Screen.hlsl");
-
-            std::cout << "Registered ShadingModel ID " << sm.shadingModelID << " from " << m_name << std::endl;
-            std::cout << "Screen.hlsl will be regenerated with new ShadingModel" << std::endl;
-        } else {
-            std::cout << "[DEBUG] ShadingModel ID " << sm.shadingModelID << " already registered, skipping" << std::endl;
-        }
-    } else {
-        std::cout << "[DEBUG] Shader '" << m_name << "' has NO ShadingModel" << std::endl;
+        ShadingModelRegistry::GetInstance().Register(parser.GetShadingModel(), m_name);
     }
 
     // 获取所有Pass信息并保存到m_passes
@@ -736,9 +763,38 @@ bool Shader::LoadFromShaderFile(const std::wstring& filePath) {
         return false;
     }
 
-    // 清空旧的passes
+    // 清空旧的passes（变体属于旧的源码，一并释放）
+    ReleaseVariants();
     m_passes.clear();
 
+    // 关键字：每个Pass的multi_compile组注册到同一个关键字空间，Pass只记录自己声明的位
+    m_keywords.Clear();
+    std::vector<ShaderVariantKey> passKeywordMasks;
+    for (const auto& parserPass : parserPasses) {
+        ShaderVariantKey mask = 0;
+        for (const auto& group : parserPass.keywordGroups) {
+            mask |= m_keywords.AddGroup(group);
+        }
+        passKeywordMasks.push_back(mask);
+    }
+    for (const auto& prop : parser.GetProperties()) {
+        if (prop.keywords.empty()) continue;
+        if (prop.type != ShaderParameterType::Bool && prop.type != ShaderParameterType::Int) {
+            std::cout << "WARNING: keyword() on property '" << prop.name << "' ignored (only bool/int)" << std::endl;
+            continue;
+        }
+        ShaderKeywordSpace::Binding binding;
+        binding.parameterName = prop.name;
+        binding.isBool = prop.type == ShaderParameterType::Bool;
+        binding.keywords = prop.keywords;
+        m_keywords.AddBinding(binding);
+    }
+    m_defaultVariantKey = GetVariantKey();
+    if (!m_keywords.IsEmpty()) {
+        std::cout << "Shader '" << m_name << "' keywords: " << m_keywords.GetGroups().size()
+                  << " groups, default variant [" << m_keywords.ToString(m_defaultVariantKey) << "]" << std::endl;
+    }
+
     // 为每个Pass创建PassInfo
     for (size_t i = 0; i < parserPasses.size(); ++i) {
         const auto& parserPass = parserPasses[i];
@@ -747,163 +803,53 @@ bool Shader::LoadFromShaderFile(const std::wstring& filePath) {
         passInfo.name = parserPass.name;
         passInfo.vsEntry = parserPass.vsEntry;
         passInfo.psEntry = parserPass.psEntry;
+        passInfo.keywordMask = passKeywordMasks[i];
 
         // 生成完整的HLSL代码（包含自动生成的CB和纹理声明）
-        passInfo.generatedHLSL = parser.GenerateHLSLCode(static_cast<int>(i));
+        std::string hlsl = parser.GenerateHLSLCode(static_cast<int>(i));
+
+        // 延迟光照Pass（Screen shader自己的Pass，或Deferred shader自动附加的第二个Pass）：
+        // 所有Deferred shader共享同一份由着色模型集合生成的源码，调试输出为Screen.hlsl
+        passInfo.usesShadingModels = (m_name == "Screen" && i == 0) || (i == 1 && m_renderQueue == "Deferred");
+        if (passInfo.usesShadingModels) {
+            ShadingModelRegistry& registry = ShadingModelRegistry::GetInstance();
+            passInfo.lightingBaseHLSL = hlsl;
+            passInfo.generatedHLSL = registry.GetLightingSource(hlsl);
+            passInfo.shadingModelSetHash = registry.GetSetHash();
+            m_passes.push_back(passInfo);
+            continue;
+        }
+        passInfo.generatedHLSL = std::make_shared<std::string>(hlsl);
 
         // DEBUG: 输出生成的HLSL到文件以便检查
         std::wstring shaderNameW(m_name.begin(), m_name.end());
         std::wstring passNameW(passInfo.name.begin(), passInfo.name.end());
 
         std::wstring debugPath;
-        bool shouldWriteFile = true;
-
-        // 特殊处理：Sky shader 自己的 Pass 应该输出为 Sky.hlsl
         if (m_name == "Sky" && i == 0) {
             // Sky shader 的第一个Pass（也是唯一的Pass）：输出为统一的 Sky.hlsl
             debugPath = L"Engine/Shader/Shader_Cache/Sky.hlsl";
-            std::cout << "[DEBUG] Processing Sky shader, generating Sky.hlsl" << std::endl;
-        }
-        // 特殊处理：Screen shader 自己的 Pass 应该输出为 Screen.hlsl
-        else if (m_name == "Screen" && i == 0) {
-            // Screen shader 自己的第一个Pass（也是唯一的Pass）：输出为统一的 Screen.hlsl
-            debugPath = L"Engine/Shader/Shader_Cache/Screen.hlsl";
-
-            std::cout << "[DEBUG] Processing Screen shader, g_shadingModels.size() = " << g_shadingModels.size() << std::endl;
-
-            // 总是注入自定义ShadingModel到Screen.hlsl（移除 screenPassGenerated 检查）
-            if (!g_shadingModels.empty()) {
-                std::string& hlsl = passInfo.generatedHLSL;
-
-                std::cout << "[DEBUG] Injecting " << g_shadingModels.size() << " custom ShadingModels into Screen shader..." << std::endl;
-
-                // 1. 在 BRDF switch 函数前注入自定义BRDF函数
-                std::string brdfFunctions;
-                for (const auto& pair : g_shadingModels) {
-                    const auto& sm = pair.second;
-                    if (!sm.brdfFunctionCode.empty()) {
-                        brdfFunctions += "\n        // ShadingModel " + std::to_string(sm.shadingModelID) + "\n";
-                        brdfFunctions += "        " + sm.brdfFunctionCode + "\n";
-                    }
-                }
-
-                size_t brdfPos = hlsl.find("float3 BRDF(int shadingModelID");
-                if (brdfPos != std::string::npos) {
-                    hlsl.insert(brdfPos, brdfFunctions);
-                    std::cout << "[DEBUG] Injected BRDF functions at position " << brdfPos << std::endl;
-                } else {
-                    std::cout << "[ERROR] Could not find BRDF function insertion point!" << std::endl;
-                }
-
-                // 2. 在 switch 的 default 前添加 case
-                std::string cases;
-                for (const auto& pair : g_shadingModels) {
-                    const auto& sm = pair.second;
-                    cases += "case " + std::to_string(sm.shadingModelID) + ": return " + sm.brdfCall + ";\n                ";
-                }
-
-                size_t defaultPos = hlsl.find("default: return float3(0, 0, 0);");
-                if (defaultPos != std::string::npos) {
-                    hlsl.insert(defaultPos, cases);
-                    std::cout << "[DEBUG] Injected case statements at position " << defaultPos << std::endl;
-                } else {
-                    std::cout << "[ERROR] Could not find default case insertion point!" << std::endl;
-                }
-
-                std::cout << "========== Injected " << g_shadingModels.size() << " custom ShadingModels into Screen.hlsl ==========" << std::endl;
-            } else {
-                std::cout << "[WARNING] g_shadingModels is empty, no custom ShadingModels to inject!" << std::endl;
-            }
-        } else if (i == 0) {
-            // 第一个Pass（GBuffer填充）：每个材质一个文件，使用实际的Pass名称
-            debugPath = L"Engine/Shader/Shader_Cache/" + shaderNameW + L"_" + passNameW + L".hlsl";
-        } else if (i == 1 && m_renderQueue == "Deferred") {
-            // 第二个Pass（延迟光照）：全局统一的Screen.hlsl
-            debugPath = L"Engine/Shader/Shader_Cache/Screen.hlsl";
-
-            // 只写一次，除非有新的ShadingModel注册
-            static bool screenPassGenerated = false;
-            std::cout << "[DEBUG] Screen Pass generation check: screenPassGenerated=" << screenPassGenerated
-                      << ", g_screenNeedsRecompile=" << g_screenNeedsRecompile << std::endl;
-
-            if (screenPassGenerated && !g_screenNeedsRecompile) {
-                std::cout << "[DEBUG] Skipping Screen.hlsl regeneration (already generated and no new ShadingModels)" << std::endl;
-                shouldWriteFile = false;
-            } else {
-                std::cout << "[DEBUG] REGENERATING Screen.hlsl!" << std::endl;
-                screenPassGenerated = true;
-                // 注意：不要在这里重置 g_screenNeedsRecompile！
-                // 因为这里可能是在ToonPBR等shader首次加载时，Screen.hlsl被写入文件
-                // 但真正的Screen shader还没有被重新加载和编译
-                // 让 CheckAndRecompileScreen 在重新加载Screen shader后再重置flag
-
-                std::cout << "========== Regenerating Screen.hlsl with " << g_shadingModels.size() << " ShadingModels... ==========" << std::endl;
-
-                // 注入自定义ShadingModel到Screen.hlsl
-                if (!g_shadingModels.empty()) {
-                    std::string& hlsl = passInfo.generatedHLSL;
-
-                    // 1. 在 BRDF switch 函数前注入自定义BRDF函数
-                    std::string brdfFunctions;
-                    for (const auto& pair : g_shadingModels) {
-                        const auto& sm = pair.second;
-                        if (!sm.brdfFunctionCode.empty()) {
-                            brdfFunctions += "\n        // ShadingModel " + std::to_string(sm.shadingModelID) + "\n";
-                            brdfFunctions += "        " + sm.brdfFunctionCode + "\n";
-                        }
-                    }
-
-                    size_t brdfPos = hlsl.find("float3 BRDF(int shadingModelID");
-                    if (brdfPos != std::string::npos) {
-                        hlsl.insert(brdfPos, brdfFunctions);
-                        std::cout << "[DEBUG] Injected BRDF functions at position " << brdfPos << std::endl;
-                    } else {
-                        std::cout << "[ERROR] Could not find BRDF function insertion point!" << std::endl;
-                    }
-
-                    // 2. 在 switch 的 default 前添加 case
-                    std::string cases;
-                    for (const auto& pair : g_shadingModels) {
-                        const auto& sm = pair.second;
-                        cases += "case " + std::to_string(sm.shadingModelID) + ": return " + sm.brdfCall + ";\n                ";
-                    }
-
-                    size_t defaultPos = hlsl.find("default: return float3(0, 0, 0);");
-                    if (defaultPos != std::string::npos) {
-                        hlsl.insert(defaultPos, cases);
-                        std::cout << "[DEBUG] Injected case statements at position " << defaultPos << std::endl;
-                    } else {
-                        std::cout << "[ERROR] Could not find default case insertion point!" << std::endl;
-                    }
-
-                    std::cout << "========== Injected " << g_shadingModels.size() << " custom ShadingModels into Screen.hlsl ==========" << std::endl;
-                } else {
-                    std::cout << "[WARNING] g_shadingModels is empty, no custom ShadingModels to inject!" << std::endl;
-                }
-            }
         } else {
-            // 其他Pass
+            // 其他Pass：每个材质一个文件，使用实际的Pass名称
             debugPath = L"Engine/Shader/Shader_Cache/" + shaderNameW + L"_" + passNameW + L".hlsl";
         }
 
-        if (shouldWriteFile) {
-            // 确保目录存在 - 提取目录路径
-            size_t lastSlash = debugPath.find_last_of(L"\\/");
-            if (lastSlash != std::wstring::npos) {
-                std::wstring dirPath = debugPath.substr(0, lastSlash);
-                if (!CreateDirectoryRecursive(dirPath)) {
-                    std::wcout << L"WARNING: Failed to create directory: " << dirPath << std::endl;
-                }
+        // 确保目录存在 - 提取目录路径
+        size_t lastSlash = debugPath.find_last_of(L"\\/");
+        if (lastSlash != std::wstring::npos) {
+            std::wstring dirPath = debugPath.substr(0, lastSlash);
+            if (!CreateDirectoryRecursive(dirPath)) {
+                std::wcout << L"WARNING: Failed to create directory: " << dirPath << std::endl;
             }
+        }
 
-            std::ofstream debugFile(debugPath);
-            if (debugFile.is_open()) {
-                debugFile << passInfo.generatedHLSL;
-                debugFile.close();
-                std::wcout << L"DEBUG: Generated HLSL written to " << debugPath << std::endl;
-            } else {
-                std::wcout << L"ERROR: Failed to create file: " << debugPath << std::endl;
-            }
+        std::ofstream debugFile(debugPath);
+        if (debugFile.is_open()) {
+            debugFile << hlsl;
+            debugFile.close();
+            std::wcout << L"DEBUG: Generated HLSL written to " << debugPath << std::endl;
+        } else {
+            std::wcout << L"ERROR: Failed to create file: " << debugPath << std::endl;
         }
 
         m_passes.push_back(passInfo);
@@ -920,16 +866,14 @@ bool Shader::CompileHLSLString(const std::string& hlslCode, const std::string& e
     ID3DBlob* shaderBlob = nullptr;
     ID3DBlob* errorBlob = nullptr;
 
-    HRESULT hr = D3DCompile(
+    HRESULT hr = ShaderBytecodeCache::GetInstance().Compile(
         hlslCode.c_str(),
         hlslCode.size(),
         nullptr,  // source name
         nullptr,  // defines
-        D3D_COMPILE_STANDARD_FILE_INCLUDE,
         entryPoint.c_str(),
         target.c_str(),
-        D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
-        0,
+        ShaderBytecodeCache::GetDefaultCompileFlags(),
         &shaderBlob,
         &errorBlob
     );
@@ -964,6 +908,131 @@ ID3D12PipelineState* Shader::GetPSO(int passIndex) const {
     return m_passes[passIndex].pso;
 }
 
+// ========== 关键字变体 ==========
+
+ShaderVariantKey Shader::GetVariantKey() const {
+    std::vector<int> values;
+    for (const auto& binding : m_keywords.GetBindings()) {
+        const ShaderParameter* param = GetParameter(binding.parameterName);
+        int value = 0;
+        if (param) {
+            value = binding.isBool ? (param->defaultValue.boolVal ? 1 : 0) : param->defaultValue.intVal;
+        }
+        values.push_back(value);
+    }
+    return m_keywords.SelectVariant(values);
+}
+
+bool Shader::NeedsVariant(int passIndex, ShaderVariantKey key) const {
+    if (!m_useGeneratedHLSL || passIndex < 0 || passIndex >= (int)m_passes.size()) return false;
+    const PassInfo& pass = m_passes[passIndex];
+    const ShaderVariantKey passKey = key & pass.keywordMask;
+    return !IsDefaultVariant(pass, passKey) && pass.variants.find(passKey) == pass.variants.end();
+}
+
+bool Shader::RequestVariant(int passIndex, ShaderVariantKey key) {
+    if (!NeedsVariant(passIndex, key)) return false;
+
+    PassInfo& pass = m_passes[passIndex];
+    pass.variants[key & pass.keywordMask].state = PassVariant::State::Compiling;
+    return true;
+}
+
+ID3D12PipelineState* Shader::GetVariantPSO(int passIndex, ShaderVariantKey key) {
+    if (passIndex < 0 || passIndex >= (int)m_passes.size()) {
+        return nullptr;
+    }
+
+    PassInfo& pass = m_passes[passIndex];
+    const ShaderVariantKey passKey = key & pass.keywordMask;
+    if (IsDefaultVariant(pass, passKey)) {
+        return pass.pso;
+    }
+
+    auto it = pass.variants.find(passKey);
+    if (it == pass.variants.end()) {
+        // 第一次使用：异步编译，这期间用默认变体渲染
+        // 输出格式与变体清单一致，可以直接复制到ShaderVariants.txt中预编译
+        std::cout << "ShaderVariant: " << m_name << " " << m_keywords.ToString(key) << std::endl;
+        ShaderCompileQueue::GetInstance().CompileVariantAsync(this, passIndex, passKey);
+        return pass.pso;
+    }
+
+    PassVariant& variant = it->second;
+    if (variant.state != PassVariant::State::Ready || !CreateVariantPSO(passIndex, variant)) {
+        return pass.pso;
+    }
+    return variant.pso;
+}
+
+int Shader::GetVariantCount() const {
+    int count = 0;
+    for (const auto& pass : m_passes) {
+        count += (int)pass.variants.size();
+    }
+    return count;
+}
+
+void Shader::ReleaseVariants() {
+    for (auto& pass : m_passes) {
+        for (auto& pair : pass.variants) {
+            if (pair.second.pso) {
+                pair.second.pso->Release();
+                pair.second.pso = nullptr;
+            }
+        }
+        pass.variants.clear();
+    }
+}
+
+void Shader::AdoptReloaded(Shader& reloaded) {
+    // 还没回填的默认/变体编译属于旧的源码
+    ShaderCompileQueue::GetInstance().Cancel(this);
+
+    // 交换而不是复制：旧的Pass（含PSO和变体）由reloaded析构时释放
+    // 在途帧使用的旧PSO由PipelineStateCache::EvictShaders保留到栅栏完成；外部借用的PSO指针须在本帧重新获取
+    m_passes.swap(reloaded.m_passes);
+    m_parameters.swap(reloaded.m_parameters);
+    m_constantBufferSize = reloaded.m_constantBufferSize;
+    m_renderQueue = reloaded.m_renderQueue;
+    m_keywords = reloaded.m_keywords;
+    m_defaultVariantKey = reloaded.m_defaultVariantKey;
+    m_useGeneratedHLSL = reloaded.m_useGeneratedHLSL;
+    m_cullMode = reloaded.m_cullMode;
+    m_depthTest = reloaded.m_depthTest;
+    m_depthWrite = reloaded.m_depthWrite;
+    m_filePath = reloaded.m_filePath;
+    if (reloaded.m_pipelineDevice) {
+        m_pipelineDevice = reloaded.m_pipelineDevice;
+        m_pipelineRootSignature = reloaded.m_pipelineRootSignature;
+    }
+}
+
+bool Shader::IsShadingModelSetStale() const {
+    const uint64_t setHash = ShadingModelRegistry::GetInstance().GetSetHash();
+    for (const auto& pass : m_passes) {
+        if (pass.usesShadingModels && pass.shadingModelSetHash != setHash) return true;
+    }
+    return false;
+}
+
+bool Shader::UpdateShadingModelSources() {
+    ShadingModelRegistry& registry = ShadingModelRegistry::GetInstance();
+    bool changed = false;
+    for (auto& pass : m_passes) {
+        if (!pass.usesShadingModels || pass.shadingModelSetHash == registry.GetSetHash()) continue;
+
+        pass.generatedHLSL = registry.GetLightingSource(pass.lightingBaseHLSL);
+        pass.shadingModelSetHash = registry.GetSetHash();
+        for (auto& pair : pass.variants) {
+            if (pair.second.pso) pair.second.pso->Release();
+        }
+        pass.variants.clear();
+        changed = true;
+    }
+    return changed;
+}
+
 // 获取指定Pass的VS字节码
 const D3D12_SHADER_BYTECODE& Shader::GetVertexShaderBytecode(int passIndex) const {
     static D3D12_SHADER_BYTECODE empty = { nullptr, 0 };
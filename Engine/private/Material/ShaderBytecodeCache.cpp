@@ -0,0 +1,456 @@
+// ShaderBytecodeCache.cpp
+// 着色器字节码磁盘缓存实现
+
+#include "public/Material/ShaderBytecodeCache.h"
+#include "public/HashUtils.h"
+#include "public/PathUtils.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+#pragma comment(lib, "d3dcompiler.lib")
+
+static constexpr uint32_t kIndexMagic = 0x49435346;    // "FSCI"
+static constexpr uint32_t kIndexVersion = 3;            // 索引格式或键的组成变化时递增，旧缓存整体失效
+
+static uint64_t ComputeKey(const void* source, size_t sourceSize, const char* sourceName,
+                           const D3D_SHADER_MACRO* defines, const char* entryPoint, const char* target, UINT flags) {
+    XXH64Hasher hasher(((uint64_t)kIndexVersion << 32) | D3D_COMPILER_VERSION);
+    hasher.Update(source, sourceSize);
+    hasher.UpdateString(sourceName);
+    hasher.UpdateString(entryPoint);
+    hasher.UpdateString(target);
+    hasher.Update(&flags, sizeof(flags));
+    for (const D3D_SHADER_MACRO* define = defines; define && define->Name; ++define) {
+        hasher.UpdateString(define->Name);
+        hasher.UpdateString(define->Definition);
+    }
+    return hasher.Digest();
+}
+
+static bool ReadFileBytes(const std::wstring& path, std::string& outContent) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    outContent.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static std::string DirectoryOf(const char* path) {
+    if (!path) return "";
+    std::string text(path);
+    size_t slash = text.find_last_of("\\/");
+    return slash == std::string::npos ? "" : text.substr(0, slash + 1);
+}
+
+static bool IsAbsolutePath(const char* path) {
+    return path[0] == '\\' || path[0] == '/' || (path[0] != '\0' && path[1] == ':');
+}
+
+// 编译时记录实际打开的include文件；嵌套include相对于包含它的文件解析
+// 内容来自ShaderBytecodeCache的include缓存，同一文件被多个Pass/变体包含时只读一次盘
+class IncludeRecorder : public ID3DInclude {
+public:
+    explicit IncludeRecorder(const std::string& baseDirectory) : m_baseDirectory(baseDirectory) {}
+
+    HRESULT __stdcall Open(D3D_INCLUDE_TYPE includeType, LPCSTR fileName, LPCVOID parentData,
+                           LPCVOID* outData, UINT* outBytes) override {
+        (void)includeType;
+        std::string directory = m_baseDirectory;
+        for (const std::unique_ptr<OpenedFile>& opened : m_openedFiles) {
+            if (opened->content->data() == parentData) {
+                directory = opened->directory;
+                break;
+            }
+        }
+
+        std::string path = IsAbsolutePath(fileName) ? std::string(fileName) : directory + fileName;
+        std::unique_ptr<OpenedFile> opened(new OpenedFile());
+        ShaderBytecodeCache::IncludeRecord record;
+        record.path = path;
+        if (!ShaderBytecodeCache::GetInstance().LoadIncludeFile(path, opened->content, record.contentHash)) {
+            m_records.push_back(record);  // 打不开也记录：文件补上之后依赖它的Pass能被找到并重新编译
+            return E_FAIL;
+        }
+        opened->directory = DirectoryOf(path.c_str());
+        m_records.push_back(record);
+
+        *outData = opened->content->data();
+        *outBytes = (UINT)opened->content->size();
+        m_openedFiles.push_back(std::move(opened));
+        return S_OK;
+    }
+
+    HRESULT __stdcall Close(LPCVOID data) override {
+        (void)data;  // 内容由shared_ptr持有，编译结束后随对象一起释放引用
+        return S_OK;
+    }
+
+    const std::vector<ShaderBytecodeCache::IncludeRecord>& GetRecords() const { return m_records; }
+
+private:
+    struct OpenedFile {
+        std::string directory;
+        std::shared_ptr<const std::string> content;
+    };
+
+    std::string m_baseDirectory;
+    std::vector<std::unique_ptr<OpenedFile>> m_openedFiles;
+    std::vector<ShaderBytecodeCache::IncludeRecord> m_records;
+};
+
+// ========== 二进制读写辅助 ==========
+
+template <typename T>
+static void AppendPod(std::vector<uint8_t>& out, const T& value) {
+    const uint8_t* bytes = (const uint8_t*)&value;
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static bool ReadPod(const std::vector<uint8_t>& data, size_t& cursor, T& outValue) {
+    if (cursor + sizeof(T) > data.size()) return false;
+    memcpy(&outValue, data.data() + cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+static bool ReadWholeFile(const std::wstring& path, std::vector<uint8_t>& outData) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    outData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// ========== ShaderBytecodeCache ==========
+
+ShaderBytecodeCache& ShaderBytecodeCache::GetInstance() {
+    static ShaderBytecodeCache instance;
+    return instance;
+}
+
+UINT ShaderBytecodeCache::GetDefaultCompileFlags() {
+#ifdef _DEBUG
+    return D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+    return D3DCOMPILE_OPTIMIZATION_LEVEL3;
+#endif
+}
+
+bool ShaderBytecodeCache::Initialize(const std::wstring& directory) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_directory = directory;
+    if (!m_directory.empty() && m_directory.back() != L'\\' && m_directory.back() != L'/') {
+        m_directory += L"\\";
+    }
+    if (!CreateDirectoryRecursive(m_directory.substr(0, m_directory.size() - 1))) {
+        std::wcout << L"ShaderBytecodeCache: Failed to create directory " << m_directory << std::endl;
+        m_directory.clear();
+        return false;
+    }
+
+    m_indexPath = m_directory + L"shaders.idx";
+    DeleteFileW((m_directory + L"shaders.pack").c_str());  // 版本3之前不带代数的数据包
+    LoadIndex();
+    CompactIfNeeded();
+
+    std::cout << "ShaderBytecodeCache: " << m_entries.size() << " entries, "
+              << m_packData.size() / 1024 << " KB" << std::endl;
+    return true;
+}
+
+void ShaderBytecodeCache::Shutdown() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_directory.empty()) {
+        if (m_dirty && !WriteIndex()) {
+            std::cout << "ShaderBytecodeCache: Failed to write index" << std::endl;
+        }
+        std::cout << "ShaderBytecodeCache: " << m_hitCount << " hits, " << m_missCount
+                  << " compiled (" << m_compileTimeMs << " ms)" << std::endl;
+    }
+    m_entries.clear();
+    m_packData.clear();
+    m_packData.shrink_to_fit();
+    m_dirty = false;
+    m_retiredPackPath.clear();
+    m_directory.clear();
+
+    std::lock_guard<std::mutex> includeLock(m_includeMutex);
+    m_includeFiles.clear();
+}
+
+bool ShaderBytecodeCache::Flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_directory.empty() || !m_dirty) return true;
+    return WriteIndex();
+}
+
+std::wstring ShaderBytecodeCache::GetPackPath(uint32_t generation) const {
+    return m_directory + L"shaders_" + std::to_wstring(generation) + L".pack";
+}
+
+bool ShaderBytecodeCache::LoadIndex() {
+    m_entries.clear();
+    m_packData.clear();
+    m_dirty = false;
+    m_packGeneration = 0;
+
+    // 索引记录数据包的代数：压缩写出新一代数据包，索引切换之前旧的一代保持不变
+    std::vector<uint8_t> index;
+    bool indexValid = ReadWholeFile(m_indexPath, index);
+    size_t cursor = 0;
+    uint32_t magic = 0, version = 0, generation = 0, entryCount = 0;
+    if (indexValid) {
+        indexValid = ReadPod(index, cursor, magic) && magic == kIndexMagic &&
+                     ReadPod(index, cursor, version) && version == kIndexVersion &&
+                     ReadPod(index, cursor, generation) && ReadPod(index, cursor, entryCount);
+        if (!indexValid) {
+            std::cout << "ShaderBytecodeCache: Index format mismatch, cache discarded" << std::endl;
+        }
+    }
+    if (indexValid) m_packGeneration = generation;
+    m_packPath = GetPackPath(m_packGeneration);
+    ReadWholeFile(m_packPath, m_packData);
+    if (!indexValid) return false;
+
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        uint64_t key = 0;
+        Entry entry;
+        uint32_t includeCount = 0;
+        if (!ReadPod(index, cursor, key) || !ReadPod(index, cursor, entry.offset) ||
+            !ReadPod(index, cursor, entry.size) || !ReadPod(index, cursor, includeCount)) {
+            break;  // 索引被截断：保留已读到的条目
+        }
+
+        bool complete = true;
+        for (uint32_t j = 0; j < includeCount && complete; ++j) {
+            IncludeRecord record;
+            uint16_t pathLength = 0;
+            complete = ReadPod(index, cursor, record.contentHash) && ReadPod(index, cursor, pathLength) &&
+                       cursor + pathLength <= index.size();
+            if (complete) {
+                record.path.assign((const char*)index.data() + cursor, pathLength);
+                cursor += pathLength;
+                entry.includes.push_back(record);
+            }
+        }
+        if (!complete) break;
+
+        // 数据包比索引短（写入中途退出）时丢弃越界条目
+        if (entry.offset + entry.size <= m_packData.size()) {
+            m_entries[key] = entry;
+        }
+    }
+    return true;
+}
+
+bool ShaderBytecodeCache::WriteIndex() {
+    std::vector<uint8_t> index;
+    AppendPod(index, kIndexMagic);
+    AppendPod(index, kIndexVersion);
+    AppendPod(index, m_packGeneration);
+    AppendPod(index, (uint32_t)m_entries.size());
+    for (const auto& pair : m_entries) {
+        const Entry& entry = pair.second;
+        AppendPod(index, pair.first);
+        AppendPod(index, entry.offset);
+        AppendPod(index, entry.size);
+        AppendPod(index, (uint32_t)entry.includes.size());
+        for (const IncludeRecord& record : entry.includes) {
+            AppendPod(index, record.contentHash);
+            AppendPod(index, (uint16_t)record.path.size());
+            index.insert(index.end(), record.path.begin(), record.path.end());
+        }
+    }
+
+    if (!WriteFileAtomic(m_indexPath, index)) return false;
+    m_dirty = false;
+
+    // 索引已指向新一代数据包，压缩前的旧数据包不再被引用
+    if (!m_retiredPackPath.empty()) {
+        DeleteFileW(m_retiredPackPath.c_str());
+        m_retiredPackPath.clear();
+    }
+    return true;
+}
+
+void ShaderBytecodeCache::CompactIfNeeded() {
+    uint64_t liveBytes = 0;
+    for (const auto& pair : m_entries) liveBytes += pair.second.size;
+    uint64_t wastedBytes = m_packData.size() - liveBytes;
+    if (wastedBytes == 0 || wastedBytes < liveBytes) return;
+
+    std::vector<uint8_t> packed;
+    std::vector<uint64_t> newOffsets;
+    packed.reserve((size_t)liveBytes);
+    newOffsets.reserve(m_entries.size());
+    for (const auto& pair : m_entries) {
+        const Entry& entry = pair.second;
+        newOffsets.push_back(packed.size());
+        packed.insert(packed.end(), m_packData.begin() + (size_t)entry.offset,
+                      m_packData.begin() + (size_t)(entry.offset + entry.size));
+    }
+
+    // 写到新的文件名，由索引原子地切换过去：任何时刻中断，索引都指向一份完整的数据包
+    const uint32_t newGeneration = m_packGeneration + 1;
+    const std::wstring newPackPath = GetPackPath(newGeneration);
+    if (!WriteFileAtomic(newPackPath, packed)) {
+        std::cout << "ShaderBytecodeCache: Failed to write compacted pack" << std::endl;
+        return;
+    }
+
+    size_t i = 0;
+    for (auto& pair : m_entries) {
+        pair.second.offset = newOffsets[i++];
+    }
+    std::cout << "ShaderBytecodeCache: Compacted pack " << m_packData.size() / 1024 << " KB -> "
+              << packed.size() / 1024 << " KB" << std::endl;
+    m_packData.swap(packed);
+    m_retiredPackPath = m_packPath;
+    m_packPath = newPackPath;
+    m_packGeneration = newGeneration;
+    // 写索引失败时旧数据包保留，之后Flush/Shutdown写回成功再删除
+    m_dirty = true;
+    WriteIndex();
+}
+
+bool ShaderBytecodeCache::LoadIncludeFile(const std::string& path, std::shared_ptr<const std::string>& outContent,
+                                          uint64_t& outHash) {
+    const std::wstring widePath = AToW(path);
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExW(widePath.c_str(), GetFileExInfoStandard, &attributes)) {
+        return false;
+    }
+    const uint64_t size = ((uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+    const uint64_t writeTime = ((uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32) |
+                               attributes.ftLastWriteTime.dwLowDateTime;
+
+    const std::wstring key = NormalizePathKey(widePath);
+    {
+        std::lock_guard<std::mutex> lock(m_includeMutex);
+        auto it = m_includeFiles.find(key);
+        if (it != m_includeFiles.end() && it->second.size == size && it->second.writeTime == writeTime) {
+            outContent = it->second.content;
+            outHash = it->second.hash;
+            return true;
+        }
+    }
+
+    // 读文件不持锁；多个线程同时读同一个文件时后写入的覆盖，内容相同
+    std::shared_ptr<std::string> content = std::make_shared<std::string>();
+    if (!ReadFileBytes(widePath, *content)) {
+        return false;
+    }
+    IncludeFile file;
+    file.content = content;
+    file.hash = HashXXH64(content->data(), content->size());
+    file.size = size;
+    file.writeTime = writeTime;
+
+    std::lock_guard<std::mutex> lock(m_includeMutex);
+    m_includeFiles[key] = file;
+    outContent = file.content;
+    outHash = file.hash;
+    return true;
+}
+
+void ShaderBytecodeCache::InvalidateIncludeFile(const std::wstring& path) {
+    std::lock_guard<std::mutex> lock(m_includeMutex);
+    m_includeFiles.erase(NormalizePathKey(path));
+}
+
+bool ShaderBytecodeCache::AreIncludesUnchanged(const std::vector<IncludeRecord>& includes) {
+    std::shared_ptr<const std::string> content;
+    uint64_t hash = 0;
+    for (const IncludeRecord& record : includes) {
+        if (!LoadIncludeFile(record.path, content, hash) || hash != record.contentHash) return false;
+    }
+    return true;
+}
+
+void ShaderBytecodeCache::Store(uint64_t key, ID3DBlob* code, const std::vector<IncludeRecord>& includes) {
+    const uint8_t* bytes = (const uint8_t*)code->GetBufferPointer();
+    const size_t size = code->GetBufferSize();
+
+    std::ofstream file(m_packPath, std::ios::binary | std::ios::app);
+    if (!file.is_open()) return;
+    file.write((const char*)bytes, (std::streamsize)size);
+    if (!file.good()) return;
+    file.close();
+
+    Entry entry;
+    entry.offset = m_packData.size();
+    entry.size = (uint32_t)size;
+    entry.includes = includes;
+    m_packData.insert(m_packData.end(), bytes, bytes + size);
+    m_entries[key] = entry;
+    // 索引在一批编译结束时（Flush）或Shutdown时统一写回；字节码已追加到数据包，中途退出只丢失未写入索引的条目
+    m_dirty = true;
+}
+
+HRESULT ShaderBytecodeCache::Compile(const void* source, size_t sourceSize, const char* sourceName,
+                                     const D3D_SHADER_MACRO* defines, const char* entryPoint, const char* target,
+                                     UINT flags, ID3DBlob** outCode, ID3DBlob** outErrors,
+                                     std::vector<IncludeRecord>* outIncludes) {
+    if (outErrors) *outErrors = nullptr;
+    if (outIncludes) outIncludes->clear();
+
+    const uint64_t key = ComputeKey(source, sourceSize, sourceName, defines, entryPoint, target, flags);
+    bool cacheEnabled = false;
+    bool found = false;
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        cacheEnabled = !m_directory.empty();
+        auto it = m_entries.find(key);
+        if (cacheEnabled && it != m_entries.end()) {
+            entry = it->second;
+            found = true;
+        }
+    }
+
+    // include校验可能要读文件，不持锁，避免阻塞其他编译线程
+    if (found && AreIncludesUnchanged(entry.includes) && SUCCEEDED(D3DCreateBlob(entry.size, outCode))) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (entry.offset + entry.size <= m_packData.size()) {
+            memcpy((*outCode)->GetBufferPointer(), m_packData.data() + entry.offset, entry.size);
+            m_hitCount++;
+            if (outIncludes) *outIncludes = entry.includes;
+            return S_OK;
+        }
+        (*outCode)->Release();
+        *outCode = nullptr;
+    }
+
+    IncludeRecorder include(DirectoryOf(sourceName));
+    auto compileStart = std::chrono::high_resolution_clock::now();
+    HRESULT hr = D3DCompile(source, sourceSize, sourceName, defines, &include,
+                            entryPoint, target, flags, 0, outCode, outErrors);
+    auto compileEnd = std::chrono::high_resolution_clock::now();
+    if (outIncludes) *outIncludes = include.GetRecords();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_compileTimeMs += std::chrono::duration<double, std::milli>(compileEnd - compileStart).count();
+    m_missCount++;
+    if (SUCCEEDED(hr) && cacheEnabled && !m_directory.empty()) {
+        Store(key, *outCode, include.GetRecords());
+    }
+    return hr;
+}
+
+HRESULT ShaderBytecodeCache::CompileFromFile(const std::wstring& filePath, const D3D_SHADER_MACRO* defines,
+                                             const char* entryPoint, const char* target,
+                                             UINT flags, ID3DBlob** outCode, ID3DBlob** outErrors) {
+    if (outErrors) *outErrors = nullptr;
+
+    std::vector<uint8_t> source;
+    if (!ReadWholeFile(filePath, source)) {
+        std::wcout << L"ShaderBytecodeCache: Failed to open " << filePath << std::endl;
+        return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+    }
+
+    std::string sourceName = WToA(filePath);
+    return Compile(source.data(), source.size(), sourceName.c_str(), defines,
+                   entryPoint, target, flags, outCode, outErrors);
+}
@@ -0,0 +1,333 @@
+// ShaderCompileQueue.cpp
+// 着色器并行编译队列实现
+
+#include "public/Material/ShaderCompileQueue.h"
+#include "public/Material/ShaderBytecodeCache.h"
+#include "public/Material/Shader.h"
+#include <chrono>
+#include <iostream>
+#include <map>
+
+constexpr size_t ShaderCompileQueue::kNotShared;
+
+ShaderCompileQueue& ShaderCompileQueue::GetInstance() {
+    static ShaderCompileQueue instance;
+    return instance;
+}
+
+ShaderCompileQueue::~ShaderCompileQueue() {
+    Shutdown();
+}
+
+bool ShaderCompileQueue::Initialize(unsigned int workerCount) {
+    if (!m_workers.empty()) return true;
+
+    if (workerCount == 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    m_stopping = false;
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&ShaderCompileQueue::WorkerMain, this);
+    }
+
+    std::cout << "ShaderCompileQueue: " << workerCount << " worker threads" << std::endl;
+    return true;
+}
+
+void ShaderCompileQueue::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_taskAvailable.notify_all();
+    for (std::thread& worker : m_workers) {
+        if (worker.joinable()) worker.join();
+    }
+    m_workers.clear();
+
+    // 没有工作线程时剩余任务在这里执行完，保证异步批次里的blob都已释放引用
+    for (const std::shared_ptr<Batch>& batch : m_asyncBatches) {
+        WaitAndHelp(batch);
+    }
+    m_asyncBatches.clear();
+}
+
+// ========== 提交 ==========
+
+std::shared_ptr<ShaderCompileQueue::Batch> ShaderCompileQueue::CreateBatch(
+    const std::vector<Shader*>& shaders, const ShaderCompiledCallback& onCompiled) {
+    std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+    batch->onCompiled = onCompiled;
+    for (Shader* shader : shaders) {
+        if (!shader) continue;
+        batch->shaders.push_back(shader);
+        batch->jobOffsets.push_back(batch->jobs.size());
+        shader->UpdateShadingModelSources();
+        shader->AppendCompileJobs(batch->jobs);
+    }
+    batch->jobOffsets.push_back(batch->jobs.size());
+    return batch;
+}
+
+std::shared_ptr<ShaderCompileQueue::Batch> ShaderCompileQueue::CreateVariantBatch(
+    const std::vector<ShaderVariantRequest>& requests) {
+    std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+    for (const ShaderVariantRequest& request : requests) {
+        if (!request.shader || !request.shader->RequestVariant(request.passIndex, request.key)) continue;
+        batch->shaders.push_back(request.shader);
+        batch->jobOffsets.push_back(batch->jobs.size());
+        request.shader->AppendVariantCompileJobs(batch->jobs, request.passIndex, request.key);
+    }
+    batch->jobOffsets.push_back(batch->jobs.size());
+    return batch;
+}
+
+void ShaderCompileQueue::Enqueue(const std::shared_ptr<Batch>& batch) {
+    // 源码（同一共享对象）、include目录、入口、target和宏都相同的任务只执行一次，结果在回填前复制
+    // 各Deferred shader的延迟光照Pass共享ShadingModelRegistry生成的源码，一批中只编译一次
+    std::vector<size_t> uniqueJobs;
+    std::map<std::string, size_t> firstJobs;
+    batch->sharedWith.assign(batch->jobs.size(), kNotShared);
+    for (size_t i = 0; i < batch->jobs.size(); ++i) {
+        const ShaderCompileJob& job = batch->jobs[i];
+        const std::string includeDirectory = job.sourceName.substr(0, job.sourceName.find_last_of("\\/") + 1);
+        std::string key = std::to_string((uintptr_t)job.source.get()) + "|" + includeDirectory + "|" +
+                          job.entryPoint + "|" + job.target;
+        for (const std::string& define : job.defines) {
+            key += "|" + define;
+        }
+
+        auto inserted = firstJobs.insert(std::make_pair(key, i));
+        if (inserted.second) {
+            uniqueJobs.push_back(i);
+        } else {
+            batch->sharedWith[i] = inserted.first->second;
+        }
+    }
+    m_sharedJobCount += (int)(batch->jobs.size() - uniqueJobs.size());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        batch->remaining = (int)uniqueJobs.size();
+        for (size_t index : uniqueJobs) {
+            Task task;
+            task.job = &batch->jobs[index];
+            task.batch = batch;
+            m_tasks.push_back(task);
+        }
+    }
+    m_taskAvailable.notify_all();
+}
+
+void ShaderCompileQueue::CopySharedResults(Batch& batch) {
+    for (size_t i = 0; i < batch.sharedWith.size(); ++i) {
+        if (batch.sharedWith[i] == kNotShared) continue;
+        const ShaderCompileJob& source = batch.jobs[batch.sharedWith[i]];
+        ShaderCompileJob& job = batch.jobs[i];
+        job.result = source.result;
+        job.code = source.code;
+        job.errors = source.errors;
+        job.includes = source.includes;
+    }
+}
+
+bool ShaderCompileQueue::CompileShaders(const std::vector<Shader*>& shaders, const ShaderCompiledCallback& onCompiled) {
+    std::shared_ptr<Batch> batch = CreateBatch(shaders, onCompiled);
+
+    auto compileStart = std::chrono::high_resolution_clock::now();
+    Enqueue(batch);
+    WaitAndHelp(batch);
+    auto compileEnd = std::chrono::high_resolution_clock::now();
+
+    std::cout << "ShaderCompileQueue: " << batch->jobs.size() << " jobs from " << batch->shaders.size()
+              << " shaders in " << std::chrono::duration<double, std::milli>(compileEnd - compileStart).count()
+              << " ms (" << m_workers.size() + 1 << " threads)" << std::endl;
+
+    return FinalizeBatch(*batch);
+}
+
+void ShaderCompileQueue::CompileShadersAsync(const std::vector<Shader*>& shaders, const ShaderCompiledCallback& onCompiled) {
+    std::shared_ptr<Batch> batch = CreateBatch(shaders, onCompiled);
+    Enqueue(batch);
+    m_asyncBatches.push_back(batch);
+}
+
+void ShaderCompileQueue::ProcessCompleted() {
+    // 没有工作线程时不能指望后台完成，在这里执行
+    if (m_workers.empty() && !m_asyncBatches.empty()) {
+        WaitAndHelp(m_asyncBatches.front());
+    }
+
+    while (!m_asyncBatches.empty() && IsBatchDone(*m_asyncBatches.front())) {
+        std::shared_ptr<Batch> batch = m_asyncBatches.front();
+        m_asyncBatches.pop_front();
+        FinalizeBatch(*batch);
+    }
+}
+
+void ShaderCompileQueue::Execute(std::vector<ShaderCompileJob>& jobs) {
+    std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+    batch->jobs.swap(jobs);
+    Enqueue(batch);
+    WaitAndHelp(batch);
+    CopySharedResults(*batch);
+    jobs.swap(batch->jobs);
+    ShaderBytecodeCache::GetInstance().Flush();
+}
+
+bool ShaderCompileQueue::CompileVariants(const std::vector<ShaderVariantRequest>& requests) {
+    std::shared_ptr<Batch> batch = CreateVariantBatch(requests);
+    if (batch->shaders.empty()) return true;
+
+    auto compileStart = std::chrono::high_resolution_clock::now();
+    Enqueue(batch);
+    WaitAndHelp(batch);
+    auto compileEnd = std::chrono::high_resolution_clock::now();
+
+    std::cout << "ShaderCompileQueue: " << batch->shaders.size() << " variants (" << batch->jobs.size() << " jobs) in "
+              << std::chrono::duration<double, std::milli>(compileEnd - compileStart).count() << " ms" << std::endl;
+
+    return FinalizeBatch(*batch);
+}
+
+void ShaderCompileQueue::CompileVariantAsync(Shader* shader, int passIndex, ShaderVariantKey key) {
+    ShaderVariantRequest request;
+    request.shader = shader;
+    request.passIndex = passIndex;
+    request.key = key;
+
+    std::shared_ptr<Batch> batch = CreateVariantBatch(std::vector<ShaderVariantRequest>(1, request));
+    if (batch->shaders.empty()) return;
+    Enqueue(batch);
+    m_asyncBatches.push_back(batch);
+}
+
+void ShaderCompileQueue::Cancel(Shader* shader) {
+    // 任务执行时不访问Shader，只需要让回填跳过它
+    for (const std::shared_ptr<Batch>& batch : m_asyncBatches) {
+        for (Shader*& batchShader : batch->shaders) {
+            if (batchShader == shader) batchShader = nullptr;
+        }
+    }
+}
+
+int ShaderCompileQueue::GetPendingJobCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (int)m_tasks.size() + m_runningTasks;
+}
+
+// ========== 执行 ==========
+
+bool ShaderCompileQueue::IsBatchDone(const Batch& batch) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return batch.remaining == 0;
+}
+
+void ShaderCompileQueue::WaitAndHelp(const std::shared_ptr<Batch>& batch) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (batch->remaining > 0) {
+        if (m_tasks.empty()) {
+            // 剩余任务都在工作线程上执行
+            m_batchDone.wait(lock);
+            continue;
+        }
+
+        Task task = m_tasks.front();
+        m_tasks.pop_front();
+        m_runningTasks++;
+        lock.unlock();
+        RunTask(task);
+        lock.lock();
+    }
+}
+
+void ShaderCompileQueue::WorkerMain() {
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskAvailable.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) return;    // 停止前先把队列执行完
+            task = m_tasks.front();
+            m_tasks.pop_front();
+            m_runningTasks++;
+        }
+        RunTask(task);
+    }
+}
+
+void ShaderCompileQueue::RunTask(const Task& task) {
+    RunJob(*task.job);
+
+    bool batchDone = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_runningTasks--;
+        batchDone = --task.batch->remaining == 0;
+    }
+    if (batchDone) {
+        m_batchDone.notify_all();
+    }
+}
+
+void ShaderCompileQueue::RunJob(ShaderCompileJob& job) {
+    // 关键字宏，以{nullptr, nullptr}结尾
+    std::vector<D3D_SHADER_MACRO> defines;
+    for (const std::string& define : job.defines) {
+        defines.push_back({ define.c_str(), "1" });
+    }
+    defines.push_back({ nullptr, nullptr });
+
+    ID3DBlob* code = nullptr;
+    ID3DBlob* errors = nullptr;
+    std::vector<ShaderBytecodeCache::IncludeRecord> includes;
+    job.result = ShaderBytecodeCache::GetInstance().Compile(
+        job.source->c_str(),
+        job.source->size(),
+        job.sourceName.empty() ? nullptr : job.sourceName.c_str(),
+        defines.data(),
+        job.entryPoint.c_str(),
+        job.target.c_str(),
+        ShaderBytecodeCache::GetDefaultCompileFlags(),
+        &code,
+        &errors,
+        &includes
+    );
+
+    job.includes.clear();
+    for (const ShaderBytecodeCache::IncludeRecord& include : includes) {
+        job.includes.push_back(include.path);
+    }
+
+    job.code.Attach(code);
+    if (errors) {
+        job.errors.assign((const char*)errors->GetBufferPointer(), errors->GetBufferSize());
+        errors->Release();
+    }
+}
+
+// ========== 回填 ==========
+
+bool ShaderCompileQueue::FinalizeBatch(Batch& batch) {
+    CopySharedResults(batch);
+
+    bool allSucceeded = true;
+    for (size_t i = 0; i < batch.shaders.size(); ++i) {
+        Shader* shader = batch.shaders[i];
+        if (!shader) continue;     // 已被Cancel
+        size_t begin = batch.jobOffsets[i];
+        size_t end = batch.jobOffsets[i + 1];
+
+        bool success = shader->ApplyCompileJobs(batch.jobs.data() + begin, end - begin);
+        allSucceeded = allSucceeded && success;
+        if (batch.onCompiled) {
+            batch.onCompiled(shader, success);
+        }
+    }
+
+    // 这一批新编译的字节码一次写回索引
+    ShaderBytecodeCache::GetInstance().Flush();
+    return allSucceeded;
+}
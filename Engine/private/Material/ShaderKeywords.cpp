@@ -0,0 +1,154 @@
+// ShaderKeywords.cpp
+// 着色器关键字与变体键实现
+
+#include "public/Material/ShaderKeywords.h"
+#include <iostream>
+#include <set>
+
+static std::set<std::string> g_globalKeywords;
+static uint32_t g_globalKeywordVersion = 0;
+
+void ShaderKeywordSpace::Clear() {
+    m_groups.clear();
+    m_bindings.clear();
+    m_keywordBits.clear();
+    m_bitCount = 0;
+}
+
+ShaderVariantKey ShaderKeywordSpace::AddGroup(const std::vector<std::string>& keywords) {
+    for (const Group& group : m_groups) {
+        if (group.keywords == keywords) return group.mask;
+    }
+
+    Group group;
+    for (const std::string& keyword : keywords) {
+        int bit = -1;
+        if (keyword != "_") {
+            if (m_keywordBits.count(keyword)) {
+                std::cout << "ShaderKeywordSpace: Keyword '" << keyword
+                          << "' already declared in another multi_compile group, ignored" << std::endl;
+                continue;
+            }
+            if (m_bitCount >= kMaxShaderKeywords) {
+                std::cout << "ShaderKeywordSpace: More than " << kMaxShaderKeywords
+                          << " keywords, '" << keyword << "' ignored" << std::endl;
+                continue;
+            }
+            bit = m_bitCount++;
+            m_keywordBits[keyword] = bit;
+        }
+        group.keywords.push_back(keyword);
+        group.bits.push_back(bit);
+        if (bit >= 0) group.mask |= 1ull << bit;
+    }
+    if (group.keywords.empty()) return 0;
+    m_groups.push_back(group);
+    return group.mask;
+}
+
+void ShaderKeywordSpace::AddBinding(const Binding& binding) {
+    m_bindings.push_back(binding);
+}
+
+ShaderVariantKey ShaderKeywordSpace::SelectVariant(const std::vector<int>& bindingValues) const {
+    ShaderVariantKey key = 0;
+    for (const Group& group : m_groups) {
+        size_t choice = 0;
+        for (size_t i = 0; i < group.keywords.size(); ++i) {
+            if (group.bits[i] >= 0 && IsGlobalKeywordEnabled(group.keywords[i])) {
+                choice = i;
+                break;
+            }
+        }
+        if (group.bits[choice] >= 0) key |= 1ull << group.bits[choice];
+    }
+
+    // 材质参数覆盖它所在的组
+    for (size_t b = 0; b < m_bindings.size() && b < bindingValues.size(); ++b) {
+        const Binding& binding = m_bindings[b];
+        const int value = bindingValues[b];
+        if (binding.keywords.empty()) continue;
+
+        const size_t choice = binding.isBool ? 0 : (size_t)value;
+        if (!binding.isBool && (value < 0 || choice >= binding.keywords.size())) continue;
+
+        int bit = -1;
+        const Group* group = FindGroup(binding.keywords[choice], bit);
+        if (!group) continue;
+        if (!binding.isBool || value != 0) {
+            key = (key & ~group->mask) | (1ull << bit);
+        } else if (group->HasNone()) {
+            key &= ~group->mask;     // bool为假：该组不启用关键字
+        }
+    }
+    return key;
+}
+
+const ShaderKeywordSpace::Group* ShaderKeywordSpace::FindGroup(const std::string& keyword, int& outBit) const {
+    auto it = m_keywordBits.find(keyword);
+    if (it == m_keywordBits.end()) return nullptr;
+    outBit = it->second;
+    for (const Group& group : m_groups) {
+        if (group.mask & (1ull << outBit)) return &group;
+    }
+    return nullptr;
+}
+
+ShaderVariantKey ShaderKeywordSpace::MakeKey(const std::vector<std::string>& keywords, std::vector<std::string>* outUnknown) const {
+    ShaderVariantKey key = 0;
+    for (const Group& group : m_groups) {
+        if (group.bits[0] >= 0) key |= 1ull << group.bits[0];
+    }
+    for (const std::string& keyword : keywords) {
+        int bit = -1;
+        const Group* group = FindGroup(keyword, bit);
+        if (!group) {
+            if (outUnknown) outUnknown->push_back(keyword);
+            continue;
+        }
+        key = (key & ~group->mask) | (1ull << bit);
+    }
+    return key;
+}
+
+void ShaderKeywordSpace::GetDefines(ShaderVariantKey key, ShaderVariantKey passMask, std::vector<std::string>& outDefines) const {
+    for (const auto& pair : m_keywordBits) {
+        ShaderVariantKey bit = 1ull << pair.second;
+        if ((key & passMask & bit) != 0) {
+            outDefines.push_back(pair.first);
+        }
+    }
+}
+
+std::string ShaderKeywordSpace::ToString(ShaderVariantKey key) const {
+    // 按声明顺序输出，和.shader中的书写顺序一致
+    std::string text;
+    ShaderVariantKey written = 0;
+    for (const Group& group : m_groups) {
+        for (size_t i = 0; i < group.keywords.size(); ++i) {
+            if (group.bits[i] < 0) continue;
+            ShaderVariantKey bit = 1ull << group.bits[i];
+            if ((key & bit) && !(written & bit)) {
+                if (!text.empty()) text += " ";
+                text += group.keywords[i];
+                written |= bit;
+            }
+        }
+    }
+    return text;
+}
+
+// ========== 全局关键字 ==========
+
+void ShaderKeywordSpace::SetGlobalKeyword(const std::string& keyword, bool enabled) {
+    bool changed = enabled ? g_globalKeywords.insert(keyword).second : g_globalKeywords.erase(keyword) > 0;
+    if (changed) g_globalKeywordVersion++;
+}
+
+bool ShaderKeywordSpace::IsGlobalKeywordEnabled(const std::string& keyword) {
+    return g_globalKeywords.count(keyword) > 0;
+}
+
+uint32_t ShaderKeywordSpace::GetGlobalKeywordVersion() {
+    return g_globalKeywordVersion;
+}
@@ -1,7 +1,7 @@
 #include "public/Material/ShaderParser.h"
+#include "public/Material/ShaderSyntax.h"
 #include <fstream>
 #include <sstream>
-#include <regex>
 #include <iostream>
 
 #ifdef _WIN32
@@ -24,52 +24,71 @@ bool ShaderParser::ParseShaderFile(const std::wstring& filePath) {
     std::string content = buffer.str();
     file.close();
 
-    // 1. 解析Shader名称
-    std::regex shaderNameRegex("Shader\\s+\"([^\"]+)\"");
-    std::smatch match;
-    if (std::regex_search(content, match, shaderNameRegex)) {
-        m_shaderName = match[1].str();
-    } else {
-        std::cout << "Failed to find Shader name" << std::endl;
-        return false;
-    }
+    // 单遍词法/语法分析，结果是指向content的片段
+    ShaderSyntaxParser syntaxParser;
+    ShaderFileSyntax syntax;
+    bool parsed = syntaxParser.Parse(content.data(), content.size(), syntax);
 
-    // 2. 解析顶层RenderQueue（可选）
-    std::regex renderQueueRegex("RenderQueue\\s+\"([^\"]+)\"");
-    if (std::regex_search(content, match, renderQueueRegex)) {
-        m_renderQueue = match[1].str();
-    } else {
-        m_renderQueue = "Forward";  // 默认为Forward
+    // 输出格式 file(line,col): 与编译器一致，VS输出窗口可双击跳转
+    for (const ShaderSyntaxError& warning : syntax.warnings) {
+        std::wcout << filePath << L"(" << warning.line << L"," << warning.column << L"): ";
+        std::cout << "warning: " << warning.message << std::endl;
     }
-
-    // 3. 解析Properties块
-    size_t pos = content.find("Properties");
-    if (pos != std::string::npos) {
-        if (!ParseProperties(content, pos)) {
-            std::cout << "Failed to parse Properties block" << std::endl;
-            return false;
-        }
+    if (!parsed) {
+        const ShaderSyntaxError& error = syntaxParser.GetError();
+        std::wcout << filePath << L"(" << error.line << L"," << error.column << L"): ";
+        std::cout << "error: " << error.message << std::endl;
+        return false;
     }
 
-    // 4. 尝试解析ShadingModel块（可选，不存在也不报错）
-    pos = content.find("ShadingModel");
-    if (pos != std::string::npos) {
-        // 只有找到ShadingModel块时才解析
-        if (!ParseShadingModel(content, pos)) {
-            // 解析失败只警告，不影响整个shader加载
-            std::cout << "WARNING: Failed to parse ShadingModel block, skipping..." << std::endl;
-            m_hasShadingModel = false;
-        }
-    }
+    m_shaderName = syntax.name.ToString();
+    m_renderQueue = syntax.renderQueue.Empty() ? "Forward" : syntax.renderQueue.ToString();  // 默认为Forward
 
-    // 5. 解析Pass块
-    pos = 0;
-    while ((pos = content.find("Pass", pos)) != std::string::npos) {
-        if (!ParsePass(content, pos)) {
-            std::cout << "Failed to parse Pass block" << std::endl;
-            return false;
+    for (const ShaderPropertySyntax& propSyntax : syntax.properties) {
+        PropertyDefinition prop;
+        prop.name = propSyntax.name.ToString();
+        prop.type = ParseType(propSyntax.type.ToString());
+        prop.defaultValue = propSyntax.defaultValue.ToString();
+        prop.minValue = propSyntax.minValue;
+        prop.maxValue = propSyntax.maxValue;
+        prop.uiWidget = propSyntax.uiWidget.ToString();
+        prop.keywords = SplitKeywords(propSyntax.keywords.ToString());
+        // 对于纹理，没有{...}块
+        if (!propSyntax.hasAttributes &&
+            (prop.type == ShaderParameterType::Texture2D || prop.type == ShaderParameterType::TextureCube)) {
+            prop.uiWidget = "TexturePicker";
         }
-        pos++;
+        m_properties.push_back(prop);
+        std::cout << "ShaderParser: Parsed property '" << prop.name << "' type=" << (int)prop.type << std::endl;
+    }
+    if (!syntax.properties.empty()) {
+        std::cout << "ShaderParser: Total properties parsed: " << m_properties.size() << std::endl;
+    }
+
+    m_hasShadingModel = syntax.hasShadingModel;
+    if (m_hasShadingModel) {
+        m_shadingModel.shadingModelID = syntax.shadingModel.shadingModelID;
+        m_shadingModel.brdfCall = syntax.shadingModel.brdfCall.ToString();
+        m_shadingModel.brdfFunctionCode = syntax.shadingModel.brdfFunctionCode.ToString();
+        std::cout << "Parsed ShadingModel: ID=" << m_shadingModel.shadingModelID << std::endl;
+    }
+
+    for (const ShaderPassSyntax& passSyntax : syntax.passes) {
+        PassDefinition pass;
+        pass.name = passSyntax.name.Empty() ? "Pass" + std::to_string(m_passes.size()) : passSyntax.name.ToString();
+        pass.renderQueue = passSyntax.renderQueue.Empty() ? "Forward" : passSyntax.renderQueue.ToString();  // 默认前向渲染
+        pass.vsEntry = passSyntax.vertexEntry.ToString();
+        pass.psEntry = passSyntax.fragmentEntry.ToString();
+        // shader_feature没有构建期剔除，和multi_compile一样处理
+        for (const ShaderPragmaSyntax& pragma : passSyntax.pragmas) {
+            if (pragma.name.Equals("multi_compile") || pragma.name.Equals("shader_feature")) {
+                std::vector<std::string> group = SplitKeywords(pragma.args.ToString());
+                if (!group.empty()) pass.keywordGroups.push_back(group);
+            }
+        }
+        // 移除#pragma行，保留纯HLSL代码
+        ShaderSyntaxParser::StripPragmas(passSyntax, pass.hlslCode);
+        m_passes.push_back(pass);
     }
 
     if (m_passes.empty()) {
@@ -109,183 +128,6 @@ bool ShaderParser::ParseShaderFile(const std::wstring& filePath) {
     return true;
 }
 
-bool ShaderParser::ParseProperties(const std::string& content, size_t& pos) {
-    // 找到Properties块的开始和结束
-    size_t blockStart = content.find('{', pos);
-    if (blockStart == std::string::npos) return false;
-
-    size_t blockEnd = FindBlockEnd(content, blockStart);
-    if (blockEnd == std::string::npos) return false;
-
-    // 提取Properties块内容
-    std::string propertiesBlock = content.substr(blockStart + 1, blockEnd - blockStart - 1);
-
-    // 逐行解析
-    std::istringstream stream(propertiesBlock);
-    std::string line;
-    while (std::getline(stream, line)) {
-        // 查找 //# 标记的属性定义
-        if (line.find("//#") != std::string::npos) {
-            PropertyDefinition prop;
-            if (ParsePropertyLine(line, prop)) {
-                m_properties.push_back(prop);
-                std::cout << "ShaderParser: Parsed property '" << prop.name << "' type=" << (int)prop.type << std::endl;
-            }
-        }
-    }
-
-    std::cout << "ShaderParser: Total properties parsed: " << m_properties.size() << std::endl;
-    return true;
-}
-
-bool ShaderParser::ParsePass(const std::string& content, size_t& pos) {
-    PassDefinition pass;
-
-    // 找到Pass块的开始
-    size_t blockStart = content.find('{', pos);
-    if (blockStart == std::string::npos) return false;
-
-    size_t blockEnd = FindBlockEnd(content, blockStart);
-    if (blockEnd == std::string::npos) return false;
-
-    std::string passBlock = content.substr(blockStart + 1, blockEnd - blockStart - 1);
-
-    // 解析Pass Name（可选）
-    std::regex nameRegex("Name\\s+\"([^\"]+)\"");
-    std::smatch match;
-    if (std::regex_search(passBlock, match, nameRegex)) {
-        pass.name = match[1].str();
-    } else {
-        pass.name = "Pass" + std::to_string(m_passes.size());
-    }
-
-    // 解析RenderQueue（可选，默认为Forward）
-    std::regex queueRegex("RenderQueue\\s+\"([^\"]+)\"");
-    if (std::regex_search(passBlock, match, queueRegex)) {
-        pass.renderQueue = match[1].str();
-    } else {
-        pass.renderQueue = "Forward";  // 默认前向渲染
-    }
-
-    // 查找HLSLPROGRAM...ENDHLSL块
-    size_t hlslStart = passBlock.find("HLSLPROGRAM");
-    size_t hlslEnd = passBlock.find("ENDHLSL");
-
-    if (hlslStart == std::string::npos || hlslEnd == std::string::npos) {
-        std::cout << "HLSLPROGRAM block not found in Pass" << std::endl;
-        return false;
-    }
-
-    std::string hlslBlock = passBlock.substr(hlslStart + 11, hlslEnd - hlslStart - 11);
-
-    // 解析#pragma指令
-    std::regex vertexRegex("#pragma\\s+vertex\\s+(\\w+)");
-    std::regex fragmentRegex("#pragma\\s+fragment\\s+(\\w+)");
-
-    if (std::regex_search(hlslBlock, match, vertexRegex)) {
-        pass.vsEntry = match[1].str();
-    }
-
-    if (std::regex_search(hlslBlock, match, fragmentRegex)) {
-        pass.psEntry = match[1].str();
-    }
-
-    // 移除#pragma行，保留纯HLSL代码
-    std::regex pragmaRegex("#pragma[^\\n]*\\n");
-    pass.hlslCode = std::regex_replace(hlslBlock, pragmaRegex, "");
-
-    m_passes.push_back(pass);
-    pos = blockEnd;
-
-    return true;
-}
-
-bool ShaderParser::ParsePropertyLine(const std::string& line, PropertyDefinition& outProp) {
-    // 格式: //# <type> <name> {default(...), min(...), max(...), ui(...)};
-
-    // 移除 //# 前缀和分号
-    std::string trimmed = line;
-    size_t start = trimmed.find("//#");
-    if (start == std::string::npos) return false;
-    trimmed = trimmed.substr(start + 3);
-
-    // 移除分号
-    size_t semiPos = trimmed.find(';');
-    if (semiPos != std::string::npos) {
-        trimmed = trimmed.substr(0, semiPos);
-    }
-
-    // 解析类型和名称
-    std::regex typeNameRegex("\\s*(\\w+)\\s+(\\w+)");
-    std::smatch match;
-    if (!std::regex_search(trimmed, match, typeNameRegex)) {
-        return false;
-    }
-
-    std::string typeStr = match[1].str();
-    outProp.name = match[2].str();
-    outProp.type = ParseType(typeStr);
-
-    // 解析属性块 {...}
-    size_t braceStart = trimmed.find('{');
-    size_t braceEnd = trimmed.find('}');
-
-    if (braceStart != std::string::npos && braceEnd != std::string::npos) {
-        std::string attrs = trimmed.substr(braceStart + 1, braceEnd - braceStart - 1);
-
-        // 解析default
-        std::regex defaultRegex("default\\s*\\(\\s*([^)]+)\\s*\\)");
-        if (std::regex_search(attrs, match, defaultRegex)) {
-            outProp.defaultValue = match[1].str();
-        }
-
-        // 解析min
-        std::regex minRegex("min\\s*\\(\\s*([\\d.]+)\\s*\\)");
-        if (std::regex_search(attrs, match, minRegex)) {
-            outProp.minValue = std::stof(match[1].str());
-        }
-
-        // 解析max
-        std::regex maxRegex("max\\s*\\(\\s*([\\d.]+)\\s*\\)");
-        if (std::regex_search(attrs, match, maxRegex)) {
-            outProp.maxValue = std::stof(match[1].str());
-        }
-
-        // 解析ui
-        std::regex uiRegex("ui\\s*\\(\\s*(\\w+)\\s*\\)");
-        if (std::regex_search(attrs, match, uiRegex)) {
-            outProp.uiWidget = match[1].str();
-        }
-    } else {
-        // 对于纹理，没有{...}块
-        if (outProp.type == ShaderParameterType::Texture2D ||
-            outProp.type == ShaderParameterType::TextureCube) {
-            outProp.uiWidget = "TexturePicker";
-        }
-    }
-
-    return true;
-}
-
-size_t ShaderParser::FindBlockStart(const std::string& content, size_t pos, const std::string& blockName) {
-    size_t namePos = content.find(blockName, pos);
-    if (namePos == std::string::npos) return std::string::npos;
-    return content.find('{', namePos);
-}
-
-size_t ShaderParser::FindBlockEnd(const std::string& content, size_t pos) {
-    int braceCount = 1;
-    size_t i = pos + 1;
-
-    while (i < content.length() && braceCount > 0) {
-        if (content[i] == '{') braceCount++;
-        else if (content[i] == '}') braceCount--;
-        i++;
-    }
-
-    return (braceCount == 0) ? i - 1 : std::string::npos;
-}
-
 std::string ShaderParser::GenerateHLSLCode(int passIndex) const {
     if (passIndex < 0 || passIndex >= m_passes.size()) {
         return "";
@@ -364,6 +206,9 @@ std::string ShaderParser::GenerateHLSLCode(int passIndex) const {
             code << "    float4x4 CurrentViewProjectionMatrix;\n";  // TAA: 当前帧VP矩阵（不带Jitter，用于Motion Vector）
             code << "};\n\n";
 
+            // 注入逐实例数据（根签名Slot 3的根SRV，VS中按SV_InstanceID索引）
+            code << GenerateInstanceDataDeclaration() << "\n";
+
             // 注入材质常量缓冲区（b1）
             code << GenerateMaterialCB() << "\n\n";
 
@@ -454,6 +299,20 @@ std::string ShaderParser::GenerateHLSLCode(int passIndex) const {
     return code.str();
 }
 
+std::string ShaderParser::GenerateInstanceDataDeclaration() {
+    // 布局与C++端InstanceData一致（每个矩阵64字节，共192字节）
+    std::ostringstream decl;
+    decl << "// Auto-generated Instance Data\n";
+    decl << "struct InstanceData\n";
+    decl << "{\n";
+    decl << "    float4x4 ModelMatrix;\n";
+    decl << "    float4x4 IT_ModelMatrix;\n";
+    decl << "    float4x4 PreviousModelMatrix;\n";
+    decl << "};\n";
+    decl << "StructuredBuffer<InstanceData> g_InstanceData : register(t0, space1);\n";
+    return decl.str();
+}
+
 std::string ShaderParser::GenerateMaterialCB() const {
     if (m_properties.empty()) {
         return "";
@@ -675,6 +534,21 @@ std::vector<ShaderParameter> ShaderParser::GenerateShaderParameters() const {
     return params;
 }
 
+std::vector<std::string> ShaderParser::SplitKeywords(const std::string& text) {
+    std::vector<std::string> keywords;
+    std::string current;
+    for (char c : text) {
+        if (c == ' ' || c == '\t' || c == ',' || c == '\r' || c == '\n') {
+            if (!current.empty()) keywords.push_back(current);
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    if (!current.empty()) keywords.push_back(current);
+    return keywords;
+}
+
 ShaderParameterType ShaderParser::ParseType(const std::string& typeStr) const {
     if (typeStr == "float") return ShaderParameterType::Float;
     if (typeStr == "float2") return ShaderParameterType::Vector2;
@@ -700,58 +574,3 @@ int ShaderParser::GetTypeSize(ShaderParameterType type) const {
         default: return 0;
     }
 }
-
-bool ShaderParser::ParseShadingModel(const std::string& content, size_t& pos) {
-    // 找到ShadingModel块的开始
-    size_t blockStart = content.find('{', pos);
-    if (blockStart == std::string::npos) {
-        return false;
-    }
-
-    size_t blockEnd = FindBlockEnd(content, blockStart);
-    if (blockEnd == std::string::npos) {
-        return false;
-    }
-
-    std::string modelBlock = content.substr(blockStart + 1, blockEnd - blockStart - 1);
-
-    // 解析 shadingmodel=ID
-    std::regex idRegex("shadingmodel\\s*=\\s*(\\d+)");
-    std::smatch match;
-    if (!std::regex_search(modelBlock, match, idRegex)) {
-        return false;
-    }
-    m_shadingModel.shadingModelID = std::stoi(match[1].str());
-
-    // 解析 BRDF=调用
-    std::regex brdfCallRegex("BRDF\\s*=\\s*([^;]+);");
-    if (!std::regex_search(modelBlock, match, brdfCallRegex)) {
-        return false;
-    }
-    m_shadingModel.brdfCall = match[1].str();
-
-    // 去除空白
-    auto trim = [](std::string& s) {
-        s.erase(0, s.find_first_not_of(" \t\n\r"));
-        s.erase(s.find_last_not_of(" \t\n\r") + 1);
-    };
-    trim(m_shadingModel.brdfCall);
-
-    // 解析 BRDF{函数定义}
-    size_t brdfBlockPos = modelBlock.find("BRDF");
-    brdfBlockPos = modelBlock.find("BRDF", brdfBlockPos + 4); // 跳过第一个BRDF=
-    if (brdfBlockPos != std::string::npos) {
-        size_t brdfStart = modelBlock.find('{', brdfBlockPos);
-        if (brdfStart != std::string::npos) {
-            size_t brdfEnd = FindBlockEnd(modelBlock, brdfStart);
-            if (brdfEnd != std::string::npos) {
-                m_shadingModel.brdfFunctionCode = modelBlock.substr(brdfStart + 1, brdfEnd - brdfStart - 1);
-                trim(m_shadingModel.brdfFunctionCode);
-            }
-        }
-    }
-
-    m_hasShadingModel = true;
-    std::cout << "Parsed ShadingModel: ID=" << m_shadingModel.shadingModelID << std::endl;
-    return true;
-}
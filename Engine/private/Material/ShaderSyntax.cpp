@@ -0,0 +1,589 @@
+// ShaderSyntax.cpp
+// .shader文件词法/语法分析实现
+
+#include "public/Material/ShaderSyntax.h"
+#include <cstdlib>
+#include <cstring>
+
+static bool IsIdentifierStart(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static bool IsIdentifierChar(char c) {
+    return IsIdentifierStart(c) || (c >= '0' && c <= '9');
+}
+
+static bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+static ShaderSpan MakeSpan(const char* begin, const char* end) {
+    ShaderSpan span;
+    span.data = begin;
+    span.size = (size_t)(end - begin);
+    return span;
+}
+
+static ShaderSpan Trim(ShaderSpan span) {
+    const char* begin = span.data;
+    const char* end = span.data + span.size;
+    while (begin < end && IsSpace(*begin)) ++begin;
+    while (end > begin && IsSpace(end[-1])) --end;
+    return MakeSpan(begin, end);
+}
+
+// 跳过从p开始的注释或字符串，返回其后的位置；p处不是注释/字符串时返回p
+static const char* SkipCommentOrString(const char* p, const char* end) {
+    if (*p == '/' && p + 1 < end) {
+        if (p[1] == '/') {
+            const char* lineEnd = (const char*)memchr(p, '\n', (size_t)(end - p));
+            return lineEnd ? lineEnd : end;
+        }
+        if (p[1] == '*') {
+            for (const char* q = p + 2; q + 1 < end; ++q) {
+                if (q[0] == '*' && q[1] == '/') return q + 2;
+            }
+            return end;
+        }
+    }
+    if (*p == '"') {
+        for (const char* q = p + 1; q < end; ++q) {
+            if (*q == '\\' && q + 1 < end) { ++q; continue; }
+            if (*q == '"' || *q == '\n') return q + 1;
+        }
+        return end;
+    }
+    return p;
+}
+
+// 数值转换：片段不以'\0'结尾，先拷贝到栈上
+static bool ParseFloat(ShaderSpan text, float& outValue) {
+    char buffer[64];
+    if (text.Empty() || text.size >= sizeof(buffer)) return false;
+    memcpy(buffer, text.data, text.size);
+    buffer[text.size] = '\0';
+    char* parseEnd = nullptr;
+    outValue = strtof(buffer, &parseEnd);
+    return parseEnd == buffer + text.size;
+}
+
+static bool ParseInt(ShaderSpan text, int& outValue) {
+    char buffer[32];
+    if (text.Empty() || text.size >= sizeof(buffer)) return false;
+    memcpy(buffer, text.data, text.size);
+    buffer[text.size] = '\0';
+    char* parseEnd = nullptr;
+    outValue = (int)strtol(buffer, &parseEnd, 10);
+    return parseEnd == buffer + text.size;
+}
+
+bool ShaderSpan::Equals(const char* literal) const {
+    size_t length = strlen(literal);
+    return length == size && (size == 0 || memcmp(data, literal, size) == 0);
+}
+
+// ========== ShaderLexer ==========
+
+ShaderLexer::ShaderLexer(const char* begin, const char* end, uint32_t line, uint32_t column)
+    : m_cursor(begin), m_end(end), m_line(line), m_column(column) {
+    // 跳过文件开头的UTF-8 BOM
+    if (line == 1 && column == 1 && end - begin >= 3 &&
+        (unsigned char)begin[0] == 0xEF && (unsigned char)begin[1] == 0xBB && (unsigned char)begin[2] == 0xBF) {
+        m_cursor += 3;
+    }
+}
+
+void ShaderLexer::Advance(size_t count) {
+    const char* target = m_cursor + count;
+    if (target > m_end) target = m_end;
+    while (m_cursor < target) {
+        const char* newline = (const char*)memchr(m_cursor, '\n', (size_t)(target - m_cursor));
+        if (!newline) {
+            m_column += (uint32_t)(target - m_cursor);
+            m_cursor = target;
+            break;
+        }
+        m_line++;
+        m_column = 1;
+        m_cursor = newline + 1;
+    }
+}
+
+bool ShaderLexer::SkipComment() {
+    if (m_cursor + 1 >= m_end || m_cursor[0] != '/') return false;
+    // //# 是属性标注，不是注释
+    if (m_cursor[1] == '/' && m_cursor + 2 < m_end && m_cursor[2] == '#') return false;
+    if (m_cursor[1] != '/' && m_cursor[1] != '*') return false;
+
+    Advance((size_t)(SkipCommentOrString(m_cursor, m_end) - m_cursor));
+    return true;
+}
+
+void ShaderLexer::SkipWhitespaceAndComments() {
+    for (;;) {
+        while (m_cursor < m_end && IsSpace(*m_cursor)) {
+            if (*m_cursor == '\n') {
+                m_line++;
+                m_column = 1;
+            } else {
+                m_column++;
+            }
+            m_cursor++;
+        }
+        if (!SkipComment()) break;
+    }
+}
+
+ShaderToken ShaderLexer::Next() {
+    SkipWhitespaceAndComments();
+
+    ShaderToken token;
+    token.line = m_line;
+    token.column = m_column;
+    if (m_cursor >= m_end) {
+        token.type = ShaderTokenType::End;
+        return token;
+    }
+
+    const char* start = m_cursor;
+    const char c = *start;
+
+    if (c == '/' && start + 2 < m_end && start[1] == '/' && start[2] == '#') {
+        const char* lineEnd = (const char*)memchr(start, '\n', (size_t)(m_end - start));
+        if (!lineEnd) lineEnd = m_end;
+        token.type = ShaderTokenType::Annotation;
+        // 只去掉行尾空白（含\r），开头保留，标注内容再分析时列号才对得上
+        const char* textEnd = lineEnd;
+        while (textEnd > start + 3 && IsSpace(textEnd[-1])) --textEnd;
+        token.text = MakeSpan(start + 3, textEnd);
+        Advance((size_t)(lineEnd - start));
+        return token;
+    }
+
+    if (IsIdentifierStart(c)) {
+        const char* p = start + 1;
+        while (p < m_end && IsIdentifierChar(*p)) ++p;
+        token.type = ShaderTokenType::Identifier;
+        token.text = MakeSpan(start, p);
+        Advance((size_t)(p - start));
+        return token;
+    }
+
+    if (IsDigit(c) || ((c == '-' || c == '.') && start + 1 < m_end && IsDigit(start[1]))) {
+        const char* p = start + 1;
+        while (p < m_end && (IsDigit(*p) || *p == '.')) ++p;
+        token.type = ShaderTokenType::Number;
+        token.text = MakeSpan(start, p);
+        Advance((size_t)(p - start));
+        return token;
+    }
+
+    if (c == '"') {
+        const char* p = start + 1;
+        while (p < m_end && *p != '"' && *p != '\n') ++p;
+        if (p >= m_end || *p != '"') {
+            // 未闭合的字符串：停在行尾，报告为无效token
+            token.type = ShaderTokenType::Invalid;
+            token.text = MakeSpan(start, p);
+            Advance((size_t)(p - start));
+            return token;
+        }
+        token.type = ShaderTokenType::String;
+        token.text = MakeSpan(start + 1, p);
+        Advance((size_t)(p + 1 - start));
+        return token;
+    }
+
+    token.type = (c != '\0' && strchr("{}(),;=", c)) ? ShaderTokenType::Punct : ShaderTokenType::Invalid;
+    token.punct = c;
+    token.text = MakeSpan(start, start + 1);
+    Advance(1);
+    return token;
+}
+
+ShaderToken ShaderLexer::Peek() {
+    const char* cursor = m_cursor;
+    uint32_t line = m_line;
+    uint32_t column = m_column;
+    ShaderToken token = Next();
+    m_cursor = cursor;
+    m_line = line;
+    m_column = column;
+    return token;
+}
+
+bool ShaderLexer::ReadRawUntilWord(const char* word, ShaderSpan& outText) {
+    const size_t wordLength = strlen(word);
+    const char* p = m_cursor;
+    while (p < m_end) {
+        const char* skipped = SkipCommentOrString(p, m_end);
+        if (skipped != p) {
+            p = skipped;
+            continue;
+        }
+        // 标识符和数字整段跳过，保证只在词边界上匹配
+        if (IsIdentifierChar(*p)) {
+            const char* wordEnd = p + 1;
+            while (wordEnd < m_end && IsIdentifierChar(*wordEnd)) ++wordEnd;
+            if ((size_t)(wordEnd - p) == wordLength && memcmp(p, word, wordLength) == 0) {
+                outText = MakeSpan(m_cursor, p);
+                Advance((size_t)(wordEnd - m_cursor));
+                return true;
+            }
+            p = wordEnd;
+            continue;
+        }
+        ++p;
+    }
+    return false;
+}
+
+bool ShaderLexer::ReadRawBlock(ShaderSpan& outBody) {
+    int depth = 1;
+    const char* p = m_cursor;
+    while (p < m_end) {
+        const char* skipped = SkipCommentOrString(p, m_end);
+        if (skipped != p) {
+            p = skipped;
+            continue;
+        }
+        if (*p == '{') {
+            depth++;
+        } else if (*p == '}' && --depth == 0) {
+            outBody = MakeSpan(m_cursor, p);
+            Advance((size_t)(p + 1 - m_cursor));
+            return true;
+        }
+        ++p;
+    }
+    return false;
+}
+
+bool ShaderLexer::ReadRawUntilChar(char c, ShaderSpan& outText) {
+    const char* found = (const char*)memchr(m_cursor, c, (size_t)(m_end - m_cursor));
+    if (!found) return false;
+    outText = MakeSpan(m_cursor, found);
+    Advance((size_t)(found - m_cursor));
+    return true;
+}
+
+// ========== ShaderSyntaxParser ==========
+
+bool ShaderSyntaxParser::Parse(const char* source, size_t length, ShaderFileSyntax& outFile) {
+    m_error = ShaderSyntaxError();
+    outFile = ShaderFileSyntax();
+    ShaderLexer lexer(source, source + length);
+    return ParseFile(lexer, outFile);
+}
+
+bool ShaderSyntaxParser::Fail(uint32_t line, uint32_t column, const std::string& message) {
+    m_error.line = line;
+    m_error.column = column;
+    m_error.message = message;
+    return false;
+}
+
+bool ShaderSyntaxParser::Fail(const ShaderToken& token, const std::string& message) {
+    std::string fullMessage = message;
+    if (token.type == ShaderTokenType::End) {
+        fullMessage += " (found end of input)";
+    } else {
+        const size_t kMaxShown = 32;
+        ShaderSpan shown = token.text;
+        if (shown.size > kMaxShown) shown.size = kMaxShown;
+        fullMessage += " (found '";
+        fullMessage.append(shown.data, shown.size);
+        fullMessage += token.text.size > kMaxShown ? "...')" : "')";
+    }
+    return Fail(token.line, token.column, fullMessage);
+}
+
+bool ShaderSyntaxParser::Expect(ShaderLexer& lexer, char punct, const char* context) {
+    ShaderToken token = lexer.Next();
+    if (token.IsPunct(punct)) return true;
+    return Fail(token, std::string("expected '") + punct + "' " + context);
+}
+
+bool ShaderSyntaxParser::ExpectString(ShaderLexer& lexer, ShaderSpan& outText, const char* context) {
+    ShaderToken token = lexer.Next();
+    if (token.type == ShaderTokenType::String) {
+        outText = token.text;
+        return true;
+    }
+    if (token.type == ShaderTokenType::Invalid && token.text.size > 0 && token.text.data[0] == '"') {
+        return Fail(token.line, token.column, "unterminated string");
+    }
+    return Fail(token, std::string("expected quoted string ") + context);
+}
+
+bool ShaderSyntaxParser::ParseFile(ShaderLexer& lexer, ShaderFileSyntax& outFile) {
+    ShaderToken token = lexer.Next();
+    if (!token.IsIdentifier("Shader")) return Fail(token, "expected 'Shader'");
+    if (!ExpectString(lexer, outFile.name, "after 'Shader'")) return false;
+    if (!Expect(lexer, '{', "to open the Shader block")) return false;
+
+    for (;;) {
+        token = lexer.Next();
+        if (token.IsPunct('}')) break;
+
+        if (token.type == ShaderTokenType::End) {
+            return Fail(token, "Shader block is not closed");
+        } else if (token.IsIdentifier("RenderQueue")) {
+            if (!ExpectString(lexer, outFile.renderQueue, "after 'RenderQueue'")) return false;
+        } else if (token.IsIdentifier("Properties")) {
+            if (!ParseProperties(lexer, outFile)) return false;
+        } else if (token.IsIdentifier("ShadingModel")) {
+            if (!ParseShadingModel(lexer, outFile)) return false;
+        } else if (token.IsIdentifier("Pass")) {
+            if (!ParsePass(lexer, token, outFile)) return false;
+        } else if (token.type == ShaderTokenType::Annotation) {
+            ShaderSyntaxError warning;
+            warning.line = token.line;
+            warning.column = token.column;
+            warning.message = "property annotation outside Properties block is ignored";
+            outFile.warnings.push_back(warning);
+        } else if (!token.IsPunct(';')) {
+            return Fail(token, "unexpected token in Shader block");
+        }
+    }
+
+    token = lexer.Next();
+    if (token.type != ShaderTokenType::End) {
+        return Fail(token, "unexpected content after the Shader block");
+    }
+    return true;
+}
+
+bool ShaderSyntaxParser::ParseProperties(ShaderLexer& lexer, ShaderFileSyntax& outFile) {
+    if (!Expect(lexer, '{', "after 'Properties'")) return false;
+
+    for (;;) {
+        ShaderToken token = lexer.Next();
+        if (token.IsPunct('}')) return true;
+        if (token.type == ShaderTokenType::End) {
+            return Fail(token, "Properties block is not closed");
+        }
+        if (token.type != ShaderTokenType::Annotation) {
+            return Fail(token, "expected '//#' property annotation in Properties block");
+        }
+
+        ShaderPropertySyntax prop;
+        if (!ParsePropertyAnnotation(token, prop)) return false;
+        outFile.properties.push_back(prop);
+    }
+}
+
+bool ShaderSyntaxParser::ParsePropertyAnnotation(const ShaderToken& annotation, ShaderPropertySyntax& outProp) {
+    // 标注内容按同一套词法再分析一次，行列号接着原文件算
+    ShaderLexer lexer(annotation.text.data, annotation.text.data + annotation.text.size,
+                      annotation.line, annotation.column + 3);
+    outProp.line = annotation.line;
+
+    ShaderToken token = lexer.Next();
+    if (token.type != ShaderTokenType::Identifier) return Fail(token, "expected property type after '//#'");
+    outProp.type = token.text;
+
+    token = lexer.Next();
+    if (token.type != ShaderTokenType::Identifier) return Fail(token, "expected property name");
+    outProp.name = token.text;
+
+    token = lexer.Next();
+    if (token.IsPunct('{')) {
+        outProp.hasAttributes = true;
+        token = lexer.Next();
+        while (!token.IsPunct('}')) {
+            if (token.type != ShaderTokenType::Identifier) return Fail(token, "expected property attribute name");
+            ShaderSpan attribute = token.text;
+
+            if (!Expect(lexer, '(', "after property attribute name")) return false;
+            ShaderSpan value;
+            if (!lexer.ReadRawUntilChar(')', value)) {
+                return Fail(lexer.GetLine(), lexer.GetColumn(), "missing ')' in property attribute");
+            }
+            lexer.Next();  // ')'
+            value = Trim(value);
+
+            if (attribute.Equals("default")) {
+                outProp.defaultValue = value;
+            } else if (attribute.Equals("min")) {
+                if (!ParseFloat(value, outProp.minValue)) return Fail(token, "invalid number in min()");
+            } else if (attribute.Equals("max")) {
+                if (!ParseFloat(value, outProp.maxValue)) return Fail(token, "invalid number in max()");
+            } else if (attribute.Equals("ui")) {
+                outProp.uiWidget = value;
+            } else if (attribute.Equals("keyword")) {
+                outProp.keywords = value;
+            }
+            // 未知属性忽略，便于以后扩展
+
+            token = lexer.Next();
+            if (token.IsPunct(',')) {
+                token = lexer.Next();
+            } else if (!token.IsPunct('}')) {
+                return Fail(token, "expected ',' or '}' in property attributes");
+            }
+        }
+        token = lexer.Next();
+    }
+
+    if (token.IsPunct(';')) token = lexer.Next();
+    if (token.type != ShaderTokenType::End) {
+        return Fail(token, "unexpected content after property declaration");
+    }
+    return true;
+}
+
+bool ShaderSyntaxParser::ParseShadingModel(ShaderLexer& lexer, ShaderFileSyntax& outFile) {
+    if (!Expect(lexer, '{', "after 'ShadingModel'")) return false;
+
+    const uint32_t bodyLine = lexer.GetLine();
+    const uint32_t bodyColumn = lexer.GetColumn();
+    ShaderSpan body;
+    if (!lexer.ReadRawBlock(body)) {
+        return Fail(bodyLine, bodyColumn, "ShadingModel block is not closed");
+    }
+
+    // 块内容有误只记警告，不影响整个shader加载
+    ShaderLexer bodyLexer(body.data, body.data + body.size, bodyLine, bodyColumn);
+    ShaderShadingModelSyntax model;
+    if (ParseShadingModelBody(bodyLexer, model)) {
+        outFile.hasShadingModel = true;
+        outFile.shadingModel = model;
+    } else {
+        outFile.warnings.push_back(m_error);
+        m_error = ShaderSyntaxError();
+    }
+    return true;
+}
+
+bool ShaderSyntaxParser::ParseShadingModelBody(ShaderLexer& lexer, ShaderShadingModelSyntax& outModel) {
+    ShaderToken token = lexer.Next();
+    if (!token.IsIdentifier("shadingmodel")) return Fail(token, "expected 'shadingmodel=<id>' in ShadingModel block");
+    if (!Expect(lexer, '=', "after 'shadingmodel'")) return false;
+
+    token = lexer.Next();
+    if (token.type != ShaderTokenType::Number || !ParseInt(token.text, outModel.shadingModelID)) {
+        return Fail(token, "expected integer shading model id");
+    }
+    if (lexer.Peek().IsPunct(';')) lexer.Next();
+
+    token = lexer.Next();
+    if (!token.IsIdentifier("BRDF")) return Fail(token, "expected 'BRDF=<call>;' in ShadingModel block");
+    if (!Expect(lexer, '=', "after 'BRDF'")) return false;
+
+    ShaderSpan call;
+    const uint32_t callLine = lexer.GetLine();
+    const uint32_t callColumn = lexer.GetColumn();
+    if (!lexer.ReadRawUntilChar(';', call)) return Fail(callLine, callColumn, "missing ';' after BRDF call");
+    lexer.Next();  // ';'
+    outModel.brdfCall = Trim(call);
+    if (outModel.brdfCall.Empty()) return Fail(callLine, callColumn, "empty BRDF call");
+
+    token = lexer.Next();
+    if (token.IsIdentifier("BRDF")) {
+        if (!Expect(lexer, '{', "to open the BRDF function block")) return false;
+        ShaderSpan code;
+        if (!lexer.ReadRawBlock(code)) return Fail(token, "BRDF function block is not closed");
+        outModel.brdfFunctionCode = Trim(code);
+        token = lexer.Next();
+    }
+
+    if (token.type != ShaderTokenType::End) {
+        return Fail(token, "unexpected token in ShadingModel block");
+    }
+    return true;
+}
+
+bool ShaderSyntaxParser::ParsePass(ShaderLexer& lexer, const ShaderToken& keyword, ShaderFileSyntax& outFile) {
+    ShaderPassSyntax pass;
+    pass.line = keyword.line;
+    if (!Expect(lexer, '{', "after 'Pass'")) return false;
+
+    bool hasHlsl = false;
+    for (;;) {
+        ShaderToken token = lexer.Next();
+        if (token.IsPunct('}')) break;
+
+        if (token.type == ShaderTokenType::End) {
+            return Fail(token, "Pass block is not closed");
+        } else if (token.IsIdentifier("Name")) {
+            if (!ExpectString(lexer, pass.name, "after 'Name'")) return false;
+        } else if (token.IsIdentifier("RenderQueue")) {
+            if (!ExpectString(lexer, pass.renderQueue, "after 'RenderQueue'")) return false;
+        } else if (token.IsIdentifier("HLSLPROGRAM")) {
+            if (hasHlsl) return Fail(token, "Pass has more than one HLSLPROGRAM block");
+            pass.hlslLine = lexer.GetLine();
+            if (!lexer.ReadRawUntilWord("ENDHLSL", pass.hlsl)) {
+                return Fail(token, "HLSLPROGRAM without matching ENDHLSL");
+            }
+            hasHlsl = true;
+        } else if (!token.IsPunct(';')) {
+            return Fail(token, "unexpected token in Pass block");
+        }
+    }
+
+    if (!hasHlsl) {
+        return Fail(keyword.line, keyword.column, "HLSLPROGRAM block not found in Pass");
+    }
+
+    ParsePragmas(pass);
+    outFile.passes.push_back(pass);
+    return true;
+}
+
+void ShaderSyntaxParser::ParsePragmas(ShaderPassSyntax& pass) {
+    static const char kPragma[] = "#pragma";
+    const size_t kPragmaLength = sizeof(kPragma) - 1;
+
+    const char* p = pass.hlsl.data;
+    const char* end = pass.hlsl.data + pass.hlsl.size;
+    uint32_t line = pass.hlslLine;
+    while (p < end) {
+        const char* lineEnd = (const char*)memchr(p, '\n', (size_t)(end - p));
+        const char* nextLine = lineEnd ? lineEnd + 1 : end;
+        if (!lineEnd) lineEnd = end;
+
+        // 只识别行首（可有缩进）的预处理指令
+        const char* q = p;
+        while (q < lineEnd && (*q == ' ' || *q == '\t')) ++q;
+        if ((size_t)(lineEnd - q) > kPragmaLength && memcmp(q, kPragma, kPragmaLength) == 0 &&
+            (q[kPragmaLength] == ' ' || q[kPragmaLength] == '\t')) {
+            ShaderPragmaSyntax pragma;
+            pragma.line = line;
+            pragma.directive = MakeSpan(q, nextLine);
+
+            const char* nameBegin = q + kPragmaLength;
+            while (nameBegin < lineEnd && (*nameBegin == ' ' || *nameBegin == '\t')) ++nameBegin;
+            const char* nameEnd = nameBegin;
+            while (nameEnd < lineEnd && IsIdentifierChar(*nameEnd)) ++nameEnd;
+            pragma.name = MakeSpan(nameBegin, nameEnd);
+            pragma.args = Trim(MakeSpan(nameEnd, lineEnd));
+
+            if (pragma.name.Equals("vertex") || pragma.name.Equals("fragment")) {
+                const char* entryEnd = pragma.args.data;
+                while (entryEnd < pragma.args.data + pragma.args.size && IsIdentifierChar(*entryEnd)) ++entryEnd;
+                ShaderSpan entry = MakeSpan(pragma.args.data, entryEnd);
+                if (pragma.name.Equals("vertex")) pass.vertexEntry = entry;
+                else pass.fragmentEntry = entry;
+            }
+            pass.pragmas.push_back(pragma);
+        }
+
+        p = nextLine;
+        line++;
+    }
+}
+
+void ShaderSyntaxParser::StripPragmas(const ShaderPassSyntax& pass, std::string& out) {
+    out.reserve(out.size() + pass.hlsl.size);
+    const char* p = pass.hlsl.data;
+    for (const ShaderPragmaSyntax& pragma : pass.pragmas) {
+        out.append(p, (size_t)(pragma.directive.data - p));
+        p = pragma.directive.data + pragma.directive.size;
+    }
+    out.append(p, (size_t)(pass.hlsl.data + pass.hlsl.size - p));
+}
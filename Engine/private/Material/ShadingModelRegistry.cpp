@@ -0,0 +1,116 @@
+// ShadingModelRegistry.cpp
+// 着色模型注册表实现
+
+#include "public/Material/ShadingModelRegistry.h"
+#include "public/HashUtils.h"
+#include "public/PathUtils.h"
+#include <fstream>
+#include <iostream>
+
+ShadingModelRegistry& ShadingModelRegistry::GetInstance() {
+    static ShadingModelRegistry instance;
+    return instance;
+}
+
+ShadingModelRegistry::ShadingModelRegistry() {
+    UpdateSetHash();
+}
+
+bool ShadingModelRegistry::Register(const ShaderParser::ShadingModelDefinition& model, const std::string& ownerName) {
+    auto it = m_models.find(model.shadingModelID);
+    if (it != m_models.end()) {
+        Entry& entry = it->second;
+        if (entry.ownerName != ownerName) {
+            if (entry.model.brdfCall != model.brdfCall || entry.model.brdfFunctionCode != model.brdfFunctionCode) {
+                std::cout << "WARNING: ShadingModel ID " << model.shadingModelID << " of '" << ownerName
+                          << "' already registered by '" << entry.ownerName << "', ignored" << std::endl;
+            }
+            return false;
+        }
+        if (entry.model.brdfCall == model.brdfCall && entry.model.brdfFunctionCode == model.brdfFunctionCode) {
+            return false;
+        }
+        entry.model = model;
+    } else {
+        Entry entry;
+        entry.model = model;
+        entry.ownerName = ownerName;
+        m_models[model.shadingModelID] = entry;
+    }
+
+    UpdateSetHash();
+    std::cout << "Registered ShadingModel ID " << model.shadingModelID << " from " << ownerName
+              << " (" << m_models.size() << " models, set " << HashToHexString(m_setHash) << ")" << std::endl;
+    return true;
+}
+
+void ShadingModelRegistry::UpdateSetHash() {
+    XXH64Hasher hasher;
+    for (const auto& pair : m_models) {
+        const ShaderParser::ShadingModelDefinition& model = pair.second.model;
+        hasher.Update(&model.shadingModelID, sizeof(model.shadingModelID));
+        hasher.Update(model.brdfCall.c_str(), model.brdfCall.size() + 1);
+        hasher.Update(model.brdfFunctionCode.c_str(), model.brdfFunctionCode.size() + 1);
+    }
+    m_setHash = hasher.Digest();
+}
+
+std::shared_ptr<const std::string> ShadingModelRegistry::GetLightingSource(const std::string& baseHLSL) {
+    const uint64_t key = HashXXH64(baseHLSL.data(), baseHLSL.size(), m_setHash);
+    auto it = m_sources.find(key);
+    if (it != m_sources.end()) {
+        return it->second;
+    }
+
+    std::shared_ptr<const std::string> source = std::make_shared<std::string>(InjectModels(baseHLSL));
+    m_sources[key] = source;
+
+    // 调试输出：最近生成的延迟光照源码
+    const std::wstring debugPath = L"Engine/Shader/Shader_Cache/Screen.hlsl";
+    CreateDirectoryRecursive(L"Engine/Shader/Shader_Cache");
+    std::ofstream debugFile(debugPath);
+    if (debugFile.is_open()) {
+        debugFile << *source;
+    }
+
+    std::cout << "Generated deferred lighting HLSL with " << m_models.size() << " ShadingModels (set "
+              << HashToHexString(m_setHash) << ")" << std::endl;
+    return source;
+}
+
+std::string ShadingModelRegistry::InjectModels(const std::string& baseHLSL) const {
+    std::string hlsl = baseHLSL;
+    if (m_models.empty()) return hlsl;
+
+    // 1. 在 BRDF switch 函数前注入自定义BRDF函数
+    std::string brdfFunctions;
+    for (const auto& pair : m_models) {
+        const ShaderParser::ShadingModelDefinition& model = pair.second.model;
+        if (!model.brdfFunctionCode.empty()) {
+            brdfFunctions += "\n        // ShadingModel " + std::to_string(model.shadingModelID) + "\n";
+            brdfFunctions += "        " + model.brdfFunctionCode + "\n";
+        }
+    }
+
+    size_t brdfPos = hlsl.find("float3 BRDF(int shadingModelID");
+    if (brdfPos == std::string::npos) {
+        std::cout << "[ERROR] Could not find BRDF function insertion point!" << std::endl;
+        return hlsl;
+    }
+    hlsl.insert(brdfPos, brdfFunctions);
+
+    // 2. 在 switch 的 default 前添加 case
+    std::string cases;
+    for (const auto& pair : m_models) {
+        const ShaderParser::ShadingModelDefinition& model = pair.second.model;
+        cases += "case " + std::to_string(model.shadingModelID) + ": return " + model.brdfCall + ";\n                ";
+    }
+
+    size_t defaultPos = hlsl.find("default: return float3(0, 0, 0);");
+    if (defaultPos == std::string::npos) {
+        std::cout << "[ERROR] Could not find default case insertion point!" << std::endl;
+        return hlsl;
+    }
+    hlsl.insert(defaultPos, cases);
+    return hlsl;
+}
@@ -0,0 +1,249 @@
+// MeshBin.cpp
+// 烘焙网格格式读写
+
+#include "public/Mesh/MeshBin.h"
+#include "public/HashUtils.h"
+#include "public/PathUtils.h"
+#include <cstddef>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+inline uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void CopyBounds(const MeshBounds& bounds, float outMin[3], float outMax[3], float outCenter[3], float& outRadius) {
+    for (int i = 0; i < 3; ++i) {
+        outMin[i] = bounds.min[i];
+        outMax[i] = bounds.max[i];
+        outCenter[i] = bounds.center[i];
+    }
+    outRadius = bounds.radius;
+}
+
+} // namespace
+
+bool QueryMeshSourceInfo(const std::wstring& sourcePath, bool computeHash, MeshBinSourceInfo& outInfo) {
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExW(sourcePath.c_str(), GetFileExInfoStandard, &attributes)) {
+        return false;
+    }
+
+    outInfo.size = ((uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+    outInfo.writeTime = ((uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32) |
+                        attributes.ftLastWriteTime.dwLowDateTime;
+    outInfo.hash = 0;
+
+    if (computeHash) {
+        return HashFileXXH64(sourcePath, outInfo.hash);
+    }
+    return true;
+}
+
+// ========== 内存映射读取 ==========
+
+bool MeshBinFile::Open(const std::wstring& filePath) {
+    Close();
+
+    m_file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(MeshBinHeader)) {
+        Close();
+        return false;
+    }
+    m_size = (uint64_t)fileSize.QuadPart;
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        Close();
+        return false;
+    }
+
+    m_view = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_view) {
+        Close();
+        return false;
+    }
+
+    // 校验文件头和各数据块范围
+    const MeshBinHeader* header = GetHeader();
+    bool valid = header->magic == kMeshBinMagic &&
+                 header->version == kMeshBinVersion &&
+                 header->vertexStride == sizeof(StaticMeshComponentVertexData) &&
+                 header->fileSize == m_size &&
+                 header->subMeshTableOffset + (uint64_t)header->subMeshCount * sizeof(MeshBinSubMesh) <= m_size &&
+                 header->vertexDataOffset + (uint64_t)header->vertexCount * header->vertexStride <= m_size &&
+                 header->indexDataOffset + (uint64_t)header->indexCount * sizeof(unsigned int) <= m_size;
+
+    // 校验子网格范围，避免损坏的文件在绘制时越界读取索引缓冲
+    // 索引值在烘焙时（Write）已校验，逐个扫描索引只在Debug构建中进行，不放在加载热路径上
+    if (valid) {
+        const MeshBinSubMesh* subMeshes = GetSubMeshes();
+        for (uint32_t i = 0; valid && i < header->subMeshCount; ++i) {
+            valid = (uint64_t)subMeshes[i].indexOffset + subMeshes[i].indexCount <= header->indexCount;
+        }
+#ifdef _DEBUG
+        const unsigned int* indices = GetIndices();
+        for (uint32_t i = 0; valid && i < header->indexCount; ++i) {
+            valid = indices[i] < header->vertexCount;
+        }
+#endif
+    }
+    if (!valid) {
+        char msg[512];
+        sprintf_s(msg, "MeshBinFile::Open - Invalid or outdated meshbin: %S\n", filePath.c_str());
+        OutputDebugStringA(msg);
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MeshBinFile::Close() {
+    if (m_view) {
+        UnmapViewOfFile(m_view);
+        m_view = nullptr;
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+    m_size = 0;
+}
+
+const MeshBinSubMesh* MeshBinFile::GetSubMeshes() const {
+    return m_view ? reinterpret_cast<const MeshBinSubMesh*>(m_view + GetHeader()->subMeshTableOffset) : nullptr;
+}
+
+const StaticMeshComponentVertexData* MeshBinFile::GetVertices() const {
+    return m_view ? reinterpret_cast<const StaticMeshComponentVertexData*>(m_view + GetHeader()->vertexDataOffset) : nullptr;
+}
+
+const unsigned int* MeshBinFile::GetIndices() const {
+    return m_view ? reinterpret_cast<const unsigned int*>(m_view + GetHeader()->indexDataOffset) : nullptr;
+}
+
+MeshBounds MeshBinFile::GetBounds() const {
+    MeshBounds bounds;
+    if (!m_view) {
+        return bounds;
+    }
+    const MeshBinHeader* header = GetHeader();
+    for (int i = 0; i < 3; ++i) {
+        bounds.min[i] = header->boundsMin[i];
+        bounds.max[i] = header->boundsMax[i];
+        bounds.center[i] = header->sphereCenter[i];
+    }
+    bounds.radius = header->sphereRadius;
+    return bounds;
+}
+
+MeshBounds MeshBinFile::ToBounds(const MeshBinSubMesh& subMesh) {
+    MeshBounds bounds;
+    for (int i = 0; i < 3; ++i) {
+        bounds.min[i] = subMesh.boundsMin[i];
+        bounds.max[i] = subMesh.boundsMax[i];
+        bounds.center[i] = subMesh.sphereCenter[i];
+    }
+    bounds.radius = subMesh.sphereRadius;
+    return bounds;
+}
+
+// ========== 写出 ==========
+
+bool MeshBinFile::Write(const std::wstring& filePath, const MeshImportData& data, const MeshBinSourceInfo& source) {
+    // 烘焙时校验子网格范围和索引值，加载时不再逐个扫描索引
+    const uint64_t vertexCount = data.vertices.size();
+    for (const MeshSubMeshData& subMesh : data.subMeshes) {
+        if ((uint64_t)subMesh.indexOffset + subMesh.indexCount > data.indices.size()) {
+            OutputDebugStringA("MeshBinFile::Write - Submesh index range out of bounds\n");
+            return false;
+        }
+    }
+    for (unsigned int index : data.indices) {
+        if (index >= vertexCount) {
+            OutputDebugStringA("MeshBinFile::Write - Index out of vertex range\n");
+            return false;
+        }
+    }
+
+    MeshBinHeader header = {};
+    header.magic = kMeshBinMagic;
+    header.version = kMeshBinVersion;
+    header.vertexStride = sizeof(StaticMeshComponentVertexData);
+    header.vertexCount = (uint32_t)data.vertices.size();
+    header.indexCount = (uint32_t)data.indices.size();
+    header.subMeshCount = (uint32_t)data.subMeshes.size();
+
+    // 布局：Header | SubMeshTable | (对齐) VertexBlob | (对齐) IndexBlob
+    header.subMeshTableOffset = sizeof(MeshBinHeader);
+    uint64_t cursor = header.subMeshTableOffset + (uint64_t)header.subMeshCount * sizeof(MeshBinSubMesh);
+    header.vertexDataOffset = AlignUp(cursor, kMeshBinBlobAlignment);
+    cursor = header.vertexDataOffset + (uint64_t)header.vertexCount * header.vertexStride;
+    header.indexDataOffset = AlignUp(cursor, kMeshBinBlobAlignment);
+    header.fileSize = header.indexDataOffset + (uint64_t)header.indexCount * sizeof(unsigned int);
+
+    CopyBounds(data.bounds, header.boundsMin, header.boundsMax, header.sphereCenter, header.sphereRadius);
+    header.source = source;
+
+    std::vector<MeshBinSubMesh> subMeshTable(data.subMeshes.size());
+    for (size_t i = 0; i < data.subMeshes.size(); ++i) {
+        const MeshSubMeshData& src = data.subMeshes[i];
+        MeshBinSubMesh& dst = subMeshTable[i];
+        memset(&dst, 0, sizeof(dst));
+        strncpy_s(dst.name, src.name.c_str(), _TRUNCATE);
+        dst.indexOffset = src.indexOffset;
+        dst.indexCount = src.indexCount;
+        CopyBounds(src.bounds, dst.boundsMin, dst.boundsMax, dst.sphereCenter, dst.sphereRadius);
+    }
+
+    size_t pos = filePath.find_last_of(L"\\/");
+    if (pos != std::wstring::npos) {
+        CreateDirectoryRecursive(filePath.substr(0, pos));
+    }
+
+    const char padding[kMeshBinBlobAlignment] = {};
+    const uint64_t tableEnd = header.subMeshTableOffset + subMeshTable.size() * sizeof(MeshBinSubMesh);
+    const uint64_t vertexEnd = header.vertexDataOffset + (uint64_t)data.vertices.size() * sizeof(StaticMeshComponentVertexData);
+    const FileChunk chunks[] = {
+        { &header, sizeof(header) },
+        { subMeshTable.data(), subMeshTable.size() * sizeof(MeshBinSubMesh) },
+        { padding, (size_t)(header.vertexDataOffset - tableEnd) },
+        { data.vertices.data(), data.vertices.size() * sizeof(StaticMeshComponentVertexData) },
+        { padding, (size_t)(header.indexDataOffset - vertexEnd) },
+        { data.indices.data(), data.indices.size() * sizeof(unsigned int) },
+    };
+    return WriteFileAtomic(filePath, chunks, _countof(chunks));
+}
+
+bool MeshBinFile::ReadHeader(const std::wstring& filePath, MeshBinHeader& outHeader) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.read(reinterpret_cast<char*>(&outHeader), sizeof(outHeader));
+    return file.gcount() == sizeof(outHeader) &&
+           outHeader.magic == kMeshBinMagic &&
+           outHeader.version == kMeshBinVersion;
+}
+
+bool MeshBinFile::UpdateSourceInfo(const std::wstring& filePath, const MeshBinSourceInfo& source) {
+    std::fstream file(filePath, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.seekp(offsetof(MeshBinHeader, source));
+    file.write(reinterpret_cast<const char*>(&source), sizeof(source));
+    return file.good();
+}
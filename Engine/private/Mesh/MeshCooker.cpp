@@ -0,0 +1,77 @@
+// MeshCooker.cpp
+// 网格烘焙实现
+
+#include "public/Mesh/MeshCooker.h"
+#include "public/Mesh/MeshBin.h"
+#include "public/StaticMeshComponent.h"
+#include "public/HashUtils.h"
+#include "public/PathUtils.h"
+#include <chrono>
+#include <iostream>
+
+bool MeshCooker::Cook(const std::wstring& fbxPath, const std::wstring& meshBinPath) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    MeshBinSourceInfo source;
+    if (!QueryMeshSourceInfo(fbxPath, true, source)) {
+        char msg[512];
+        sprintf_s(msg, "MeshCooker::Cook - Source not found: %S\n", fbxPath.c_str());
+        OutputDebugStringA(msg);
+        return false;
+    }
+
+    MeshImportData data;
+    if (!StaticMeshComponent::ImportFBX(WToA(fbxPath).c_str(), data)) {
+        return false;
+    }
+
+    if (!MeshBinFile::Write(meshBinPath, data, source)) {
+        char msg[512];
+        sprintf_s(msg, "MeshCooker::Cook - Failed to write: %S\n", meshBinPath.c_str());
+        OutputDebugStringA(msg);
+        return false;
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double cookTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+    char msg[512];
+    sprintf_s(msg, "[MeshCooker] Cooked %S: %zu vertices, %zu indices, %zu submeshes, %.1f ms\n",
+        meshBinPath.c_str(), data.vertices.size(), data.indices.size(), data.subMeshes.size(), cookTimeMs);
+    OutputDebugStringA(msg);
+    std::cout << msg;
+    return true;
+}
+
+bool MeshCooker::CookIfStale(const std::wstring& fbxPath, const std::wstring& meshBinPath, bool* outCooked) {
+    if (outCooked) {
+        *outCooked = false;
+    }
+
+    MeshBinSourceInfo current;
+    if (!QueryMeshSourceInfo(fbxPath, false, current)) {
+        // 没有源文件（只发布了烘焙结果）时，只要.meshbin有效即可
+        MeshBinHeader header;
+        return MeshBinFile::ReadHeader(meshBinPath, header);
+    }
+
+    MeshBinHeader header;
+    if (MeshBinFile::ReadHeader(meshBinPath, header)) {
+        if (header.source.size == current.size && header.source.writeTime == current.writeTime) {
+            return true;
+        }
+
+        // 时间戳变了但内容可能没变（例如重新检出），比较内容哈希
+        if (header.source.size == current.size && HashFileXXH64(fbxPath, current.hash) &&
+            current.hash == header.source.hash) {
+            MeshBinFile::UpdateSourceInfo(meshBinPath, current);
+            return true;
+        }
+    }
+
+    bool cooked = Cook(fbxPath, meshBinPath);
+    if (outCooked) {
+        *outCooked = cooked;
+    }
+    return cooked;
+}
@@ -0,0 +1,202 @@
+// MeshManager.cpp
+// 共享网格缓存实现
+
+#include "public/Mesh/MeshManager.h"
+#include "public/Mesh/MeshBin.h"
+#include "public/StaticMeshComponent.h"
+#include "public/Actor.h"
+#include "public/HashUtils.h"
+#include "public/PathUtils.h"
+#include "public/BattleFireDirect.h"
+#include <iostream>
+
+MeshManager& MeshManager::GetInstance() {
+    static MeshManager instance;
+    return instance;
+}
+
+MeshManager::~MeshManager() {
+    Shutdown();
+}
+
+std::string MeshManager::BuildKey(const std::wstring& sourcePath) {
+    std::wstring canonical = NormalizePathKey(sourcePath);
+
+    MeshBinSourceInfo info;
+    if (!QueryMeshSourceInfo(canonical, false, info)) {
+        // 源文件不存在时只按路径索引，加载失败由LoadMesh处理
+        return WToA(canonical);
+    }
+
+    SourceHash& cached = m_sourceHashes[canonical];
+    if (cached.hash == 0 || cached.size != info.size || cached.writeTime != info.writeTime) {
+        cached.size = info.size;
+        cached.writeTime = info.writeTime;
+        HashFileXXH64(canonical, cached.hash);
+    }
+
+    return WToA(canonical) + "|" + HashToHexString(cached.hash);
+}
+
+StaticMeshComponent* MeshManager::Acquire(const MeshAssetInfo& meshInfo, ID3D12GraphicsCommandList* commandList) {
+    // 以几何源文件作为身份：FBX优先，只发布了烘焙结果时使用.meshbin
+    std::wstring enginePath = GetEnginePath();
+    std::wstring sourcePath;
+    if (!meshInfo.fbxPath.empty()) {
+        sourcePath = enginePath + std::wstring(meshInfo.fbxPath.begin(), meshInfo.fbxPath.end());
+    }
+    if (sourcePath.empty() || GetFileAttributesW(sourcePath.c_str()) == INVALID_FILE_ATTRIBUTES) {
+        std::string meshBinRelative = meshInfo.GetMeshBinPath();
+        if (!meshBinRelative.empty()) {
+            sourcePath = enginePath + std::wstring(meshBinRelative.begin(), meshBinRelative.end());
+        }
+    }
+    if (sourcePath.empty()) {
+        OutputDebugStringA("MeshManager::Acquire - Mesh asset has no geometry source\n");
+        return nullptr;
+    }
+
+    std::string key = BuildKey(sourcePath);
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        it->second.refCount++;
+        return it->second.mesh;
+    }
+
+    StaticMeshComponent* mesh = LoadMesh(meshInfo, commandList);
+    if (!mesh) {
+        return nullptr;
+    }
+
+    MeshEntry& entry = m_entries[key];
+    entry.key = key;
+    entry.mesh = mesh;
+    entry.refCount = 1;
+    m_meshToKey[mesh] = key;
+
+    char msg[512];
+    sprintf_s(msg, "[MeshManager] Loaded '%s' (%d unique meshes)\n", key.c_str(), (int)m_entries.size());
+    OutputDebugStringA(msg);
+    return mesh;
+}
+
+void MeshManager::AddRef(StaticMeshComponent* mesh) {
+    auto it = m_meshToKey.find(mesh);
+    if (it != m_meshToKey.end()) {
+        m_entries[it->second].refCount++;
+    }
+}
+
+void MeshManager::Release(StaticMeshComponent* mesh) {
+    if (!mesh) {
+        return;
+    }
+
+    auto keyIt = m_meshToKey.find(mesh);
+    if (keyIt == m_meshToKey.end()) {
+        return;
+    }
+
+    auto entryIt = m_entries.find(keyIt->second);
+    if (entryIt == m_entries.end()) {
+        m_meshToKey.erase(keyIt);
+        return;
+    }
+
+    if (--entryIt->second.refCount <= 0) {
+        char msg[512];
+        sprintf_s(msg, "[MeshManager] Unloaded '%s'\n", entryIt->first.c_str());
+        OutputDebugStringA(msg);
+
+        // 在途帧可能还在使用VBO/IBO（本帧也可能已录制了引用它的绘制），等本帧提交的栅栏值完成后再销毁
+        RetiredMesh retired;
+        retired.mesh = entryIt->second.mesh;
+        retired.fenceValue = GetSubmittedFenceValue() + 1;
+        m_retiredMeshes.push_back(retired);
+
+        m_entries.erase(entryIt);
+        m_meshToKey.erase(keyIt);
+    }
+}
+
+void MeshManager::ReleaseRetiredResources() {
+    const UINT64 completed = GetCompletedFenceValue();
+    for (size_t i = 0; i < m_retiredMeshes.size();) {
+        if (m_retiredMeshes[i].fenceValue <= completed) {
+            delete m_retiredMeshes[i].mesh;
+            m_retiredMeshes[i] = m_retiredMeshes.back();
+            m_retiredMeshes.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+void MeshManager::Shutdown() {
+    for (auto& pair : m_entries) {
+        delete pair.second.mesh;
+    }
+    m_entries.clear();
+    m_meshToKey.clear();
+    m_sourceHashes.clear();
+
+    // 调用前GPU已空闲
+    for (RetiredMesh& retired : m_retiredMeshes) {
+        delete retired.mesh;
+    }
+    m_retiredMeshes.clear();
+}
+
+int MeshManager::GetTotalReferenceCount() const {
+    int total = 0;
+    for (const auto& pair : m_entries) {
+        total += pair.second.refCount;
+    }
+    return total;
+}
+
+uint64_t MeshManager::GetGPUMemoryUsage() const {
+    uint64_t total = 0;
+    for (const auto& pair : m_entries) {
+        const StaticMeshComponent* mesh = pair.second.mesh;
+        if (mesh->mVBO) total += mesh->mVBO->GetDesc().Width;
+        if (mesh->mIBO) total += mesh->mIBO->GetDesc().Width;
+    }
+    return total;
+}
+
+StaticMeshComponent* MeshManager::LoadMesh(const MeshAssetInfo& meshInfo, ID3D12GraphicsCommandList* commandList) {
+    char msg[512];
+    std::wstring enginePath = GetEnginePath();
+    std::wstring fbxPath;
+    if (!meshInfo.fbxPath.empty()) {
+        fbxPath = enginePath + std::wstring(meshInfo.fbxPath.begin(), meshInfo.fbxPath.end());
+    }
+
+    std::string meshBinRelative = meshInfo.GetMeshBinPath();
+    if (!meshBinRelative.empty()) {
+        std::wstring meshBinPath = enginePath + std::wstring(meshBinRelative.begin(), meshBinRelative.end());
+        sprintf_s(msg, "  MeshBin path: %S\n", meshBinPath.c_str());
+        OutputDebugStringA(msg);
+
+        StaticMeshComponent* mesh = new StaticMeshComponent();
+        if (mesh->InitFromMeshBin(commandList, meshBinPath, fbxPath)) {
+            return mesh;
+        }
+        delete mesh;
+        OutputDebugStringA("  MeshBin load failed, falling back to FBX import\n");
+    }
+
+    if (fbxPath.empty()) {
+        return nullptr;
+    }
+
+    // 回退：直接导入FBX（FBX加载需要char*）
+    sprintf_s(msg, "  FBX path: %S\n", fbxPath.c_str());
+    OutputDebugStringA(msg);
+
+    StaticMeshComponent* mesh = new StaticMeshComponent();
+    mesh->InitFromFile(commandList, WToA(fbxPath).c_str());
+    return mesh;
+}
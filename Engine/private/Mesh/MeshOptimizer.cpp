@@ -0,0 +1,395 @@
+// MeshOptimizer.cpp
+// 网格索引优化实现
+
+#include "public/Mesh/MeshOptimizer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+// ========== Forsyth 评分参数 ==========
+constexpr int kForsythCacheSize = 32;
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kLastTriScore = 0.75f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+
+float ForsythVertexScore(int cachePosition, unsigned int activeTriCount) {
+    if (activeTriCount == 0) {
+        return -1.0f;  // 已无剩余三角形
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // 刚使用过的三角形顶点固定分值，避免总是选择同一条带
+            score = kLastTriScore;
+        } else {
+            const float scaler = 1.0f / (kForsythCacheSize - 3);
+            score = 1.0f - (cachePosition - 3) * scaler;
+            score = powf(score, kCacheDecayPower);
+        }
+    }
+
+    // 剩余三角形越少越优先，尽早消灭孤立顶点
+    score += kValenceBoostScale * powf((float)activeTriCount, -kValenceBoostPower);
+    return score;
+}
+
+} // namespace
+
+// ========== 缓存统计 ==========
+
+MeshCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<unsigned int>& indices,
+                                                 unsigned int vertexCount,
+                                                 unsigned int cacheSize) {
+    MeshCacheStats stats;
+    if (indices.size() < 3 || vertexCount == 0 || cacheSize == 0) {
+        return stats;
+    }
+
+    // FIFO缓存：记录每个顶点进入缓存时的时间戳
+    std::vector<unsigned int> cacheTimestamps(vertexCount, 0);
+    unsigned int timestamp = cacheSize + 1;
+    unsigned int misses = 0;
+
+    for (unsigned int index : indices) {
+        if (index >= vertexCount) {
+            continue;
+        }
+        if (timestamp - cacheTimestamps[index] > cacheSize) {
+            cacheTimestamps[index] = timestamp++;
+            ++misses;
+        }
+    }
+
+    // 统计实际被引用的顶点数
+    std::vector<bool> used(vertexCount, false);
+    unsigned int usedCount = 0;
+    for (unsigned int index : indices) {
+        if (index < vertexCount && !used[index]) {
+            used[index] = true;
+            ++usedCount;
+        }
+    }
+
+    stats.acmr = (float)misses / (float)(indices.size() / 3);
+    stats.atvr = usedCount > 0 ? (float)misses / (float)usedCount : 0.0f;
+    return stats;
+}
+
+// ========== 顶点缓存优化（Forsyth） ==========
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, unsigned int vertexCount) {
+    const size_t triCount = indices.size() / 3;
+    if (triCount == 0 || vertexCount == 0) {
+        return;
+    }
+
+    // 构建顶点->三角形邻接表
+    std::vector<unsigned int> activeTriCount(vertexCount, 0);
+    for (size_t i = 0; i < triCount * 3; ++i) {
+        ++activeTriCount[indices[i]];
+    }
+
+    std::vector<unsigned int> triOffsets(vertexCount + 1, 0);
+    for (unsigned int v = 0; v < vertexCount; ++v) {
+        triOffsets[v + 1] = triOffsets[v] + activeTriCount[v];
+    }
+
+    std::vector<unsigned int> vertexTris(triCount * 3);
+    std::vector<unsigned int> fillCursor(triOffsets.begin(), triOffsets.end() - 1);
+    for (size_t t = 0; t < triCount; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            unsigned int v = indices[t * 3 + k];
+            vertexTris[fillCursor[v]++] = (unsigned int)t;
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (unsigned int v = 0; v < vertexCount; ++v) {
+        vertexScore[v] = ForsythVertexScore(-1, activeTriCount[v]);
+    }
+
+    std::vector<float> triScore(triCount);
+    std::vector<bool> triEmitted(triCount, false);
+    for (size_t t = 0; t < triCount; ++t) {
+        triScore[t] = vertexScore[indices[t * 3]] +
+                      vertexScore[indices[t * 3 + 1]] +
+                      vertexScore[indices[t * 3 + 2]];
+    }
+
+    // 初始选择得分最高的三角形
+    size_t bestTri = 0;
+    for (size_t t = 1; t < triCount; ++t) {
+        if (triScore[t] > triScore[bestTri]) {
+            bestTri = t;
+        }
+    }
+
+    std::vector<unsigned int> output;
+    output.reserve(triCount * 3);
+
+    // 多留3个位置用于新三角形挤出的顶点
+    unsigned int cache[kForsythCacheSize + 3];
+    int cacheCount = 0;
+    size_t scanCursor = 0;
+
+    for (size_t emitted = 0; emitted < triCount; ++emitted) {
+        if (bestTri == SIZE_MAX) {
+            // 缓存中的顶点已无剩余三角形，顺序查找下一个未输出的三角形
+            while (triEmitted[scanCursor]) {
+                ++scanCursor;
+            }
+            bestTri = scanCursor;
+        }
+
+        triEmitted[bestTri] = true;
+        const unsigned int* tri = &indices[bestTri * 3];
+        output.push_back(tri[0]);
+        output.push_back(tri[1]);
+        output.push_back(tri[2]);
+
+        // 从邻接表移除该三角形
+        for (int k = 0; k < 3; ++k) {
+            unsigned int v = tri[k];
+            unsigned int* begin = &vertexTris[triOffsets[v]];
+            unsigned int* end = begin + activeTriCount[v];
+            unsigned int* it = std::find(begin, end, (unsigned int)bestTri);
+            if (it != end) {
+                *it = *(end - 1);
+                --activeTriCount[v];
+            }
+        }
+
+        // 新三角形顶点放到缓存最前，其余顶点后移
+        unsigned int newCache[kForsythCacheSize + 3];
+        int newCount = 0;
+        for (int k = 0; k < 3; ++k) {
+            newCache[newCount++] = tri[k];
+        }
+        for (int i = 0; i < cacheCount; ++i) {
+            unsigned int v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                newCache[newCount++] = v;
+            }
+        }
+
+        // 重新计算缓存内顶点得分（被挤出的顶点cachePosition置为-1）
+        for (int i = 0; i < newCount; ++i) {
+            unsigned int v = newCache[i];
+            cachePosition[v] = i < kForsythCacheSize ? i : -1;
+            vertexScore[v] = ForsythVertexScore(cachePosition[v], activeTriCount[v]);
+        }
+
+        // 更新受影响三角形得分，并选出下一个最佳三角形
+        bestTri = SIZE_MAX;
+        float bestScore = -1.0f;
+        for (int i = 0; i < newCount; ++i) {
+            unsigned int v = newCache[i];
+            for (unsigned int j = 0; j < activeTriCount[v]; ++j) {
+                unsigned int t = vertexTris[triOffsets[v] + j];
+                float score = vertexScore[indices[t * 3]] +
+                              vertexScore[indices[t * 3 + 1]] +
+                              vertexScore[indices[t * 3 + 2]];
+                triScore[t] = score;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTri = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, kForsythCacheSize);
+        memcpy(cache, newCache, sizeof(unsigned int) * cacheCount);
+    }
+
+    // 不足一个三角形的尾部索引原样保留
+    for (size_t i = triCount * 3; i < indices.size(); ++i) {
+        output.push_back(indices[i]);
+    }
+    indices.swap(output);
+}
+
+// ========== Overdraw优化 ==========
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<unsigned int>& indices,
+                                     const std::vector<StaticMeshComponentVertexData>& vertices,
+                                     float threshold) {
+    const size_t triCount = indices.size() / 3;
+    const unsigned int vertexCount = (unsigned int)vertices.size();
+    if (triCount < 2 || vertexCount == 0) {
+        return;
+    }
+
+    // 在缓存断点处切簇：三角形的3个顶点全部未命中，说明开始了新区域
+    // 簇内保持Forsyth顺序，只调整簇之间的顺序，缓存效率基本不受影响
+    const unsigned int cacheSize = 16;
+    const size_t minClusterTris = 16;
+    std::vector<size_t> clusterStarts;
+    {
+        std::vector<unsigned int> cacheTimestamps(vertexCount, 0);
+        unsigned int timestamp = cacheSize + 1;
+        size_t lastStart = 0;
+        clusterStarts.push_back(0);
+        for (size_t t = 0; t < triCount; ++t) {
+            int misses = 0;
+            for (int k = 0; k < 3; ++k) {
+                unsigned int v = indices[t * 3 + k];
+                if (timestamp - cacheTimestamps[v] > cacheSize) {
+                    cacheTimestamps[v] = timestamp++;
+                    ++misses;
+                }
+            }
+            if (misses == 3 && t - lastStart >= minClusterTris) {
+                clusterStarts.push_back(t);
+                lastStart = t;
+            }
+        }
+    }
+    if (clusterStarts.size() < 2) {
+        return;
+    }
+
+    // 网格中心（按三角形面积加权）
+    auto triangleCentroidAndNormal = [&](size_t t, float centroid[3], float normal[3]) {
+        const float* p0 = vertices[indices[t * 3]].mPosition;
+        const float* p1 = vertices[indices[t * 3 + 1]].mPosition;
+        const float* p2 = vertices[indices[t * 3 + 2]].mPosition;
+        for (int a = 0; a < 3; ++a) {
+            centroid[a] = (p0[a] + p1[a] + p2[a]) / 3.0f;
+        }
+        float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+        // 面积加权法线（未归一化，长度为两倍面积）
+        normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+    };
+
+    float meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+    float meshArea = 0.0f;
+    for (size_t t = 0; t < triCount; ++t) {
+        float c[3], n[3];
+        triangleCentroidAndNormal(t, c, n);
+        float area = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        for (int a = 0; a < 3; ++a) {
+            meshCentroid[a] += c[a] * area;
+        }
+        meshArea += area;
+    }
+    if (meshArea <= 0.0f) {
+        return;
+    }
+    for (int a = 0; a < 3; ++a) {
+        meshCentroid[a] /= meshArea;
+    }
+
+    // 簇排序键：dot(簇中心 - 网格中心, 簇平均法线)，越朝外越先画
+    const size_t clusterCount = clusterStarts.size();
+    clusterStarts.push_back(triCount);
+    std::vector<float> clusterSortKey(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        float centroid[3] = { 0.0f, 0.0f, 0.0f };
+        float normal[3] = { 0.0f, 0.0f, 0.0f };
+        float area = 0.0f;
+        for (size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t) {
+            float tc[3], tn[3];
+            triangleCentroidAndNormal(t, tc, tn);
+            float triArea = sqrtf(tn[0] * tn[0] + tn[1] * tn[1] + tn[2] * tn[2]);
+            for (int a = 0; a < 3; ++a) {
+                centroid[a] += tc[a] * triArea;
+                normal[a] += tn[a];
+            }
+            area += triArea;
+        }
+        if (area > 0.0f) {
+            for (int a = 0; a < 3; ++a) {
+                centroid[a] /= area;
+            }
+        }
+        float normalLen = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (normalLen > 0.0f) {
+            for (int a = 0; a < 3; ++a) {
+                normal[a] /= normalLen;
+            }
+        }
+        clusterSortKey[c] = (centroid[0] - meshCentroid[0]) * normal[0] +
+                            (centroid[1] - meshCentroid[1]) * normal[1] +
+                            (centroid[2] - meshCentroid[2]) * normal[2];
+    }
+
+    std::vector<size_t> clusterOrder(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        clusterOrder[c] = c;
+    }
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&](size_t a, size_t b) {
+        return clusterSortKey[a] > clusterSortKey[b];
+    });
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    for (size_t c : clusterOrder) {
+        output.insert(output.end(),
+            indices.begin() + clusterStarts[c] * 3,
+            indices.begin() + clusterStarts[c + 1] * 3);
+    }
+    for (size_t i = triCount * 3; i < indices.size(); ++i) {
+        output.push_back(indices[i]);
+    }
+
+    // 簇重排导致缓存效率明显变差时放弃
+    MeshCacheStats inputStats = AnalyzeVertexCache(indices, vertexCount, cacheSize);
+    MeshCacheStats outputStats = AnalyzeVertexCache(output, vertexCount, cacheSize);
+    if (outputStats.acmr <= inputStats.acmr * threshold) {
+        indices.swap(output);
+    }
+}
+
+// ========== 顶点读取优化 ==========
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<StaticMeshComponentVertexData>& vertices,
+                                        std::vector<unsigned int>& indices) {
+    const unsigned int invalid = 0xFFFFFFFFu;
+    std::vector<unsigned int> remap(vertices.size(), invalid);
+    std::vector<StaticMeshComponentVertexData> output;
+    output.reserve(vertices.size());
+
+    for (unsigned int& index : indices) {
+        if (index >= vertices.size()) {
+            continue;
+        }
+        if (remap[index] == invalid) {
+            remap[index] = (unsigned int)output.size();
+            output.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    // 未被引用的顶点直接丢弃
+    vertices.swap(output);
+}
+
+void MeshOptimizer::Optimize(std::vector<StaticMeshComponentVertexData>& vertices,
+                             std::vector<unsigned int>& indices,
+                             MeshOptimizeStats* outStats) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    const unsigned int vertexCount = (unsigned int)vertices.size();
+
+    if (outStats) {
+        outStats->before = AnalyzeVertexCache(indices, vertexCount);
+    }
+
+    OptimizeVertexCache(indices, vertexCount);
+    OptimizeOverdraw(indices, vertices);
+    OptimizeVertexFetch(vertices, indices);
+
+    if (outStats) {
+        auto endTime = std::chrono::high_resolution_clock::now();
+        outStats->after = AnalyzeVertexCache(indices, (unsigned int)vertices.size());
+        outStats->optimizeTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    }
+}
@@ -0,0 +1,132 @@
+// MeshWelder.cpp
+// 顶点焊接实现（开放寻址哈希表）
+
+#include "public/Mesh/MeshWelder.h"
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+constexpr int kWeldKeyCount = 16;  // 4个float4属性
+constexpr uint32_t kEmptySlot = 0xFFFFFFFFu;
+
+struct WeldKey {
+    uint32_t v[kWeldKeyCount];
+};
+
+// 把一个float量化成整数键
+// epsilon为0或输入非有限值（NaN/Inf）时直接使用位模式（把-0归一到+0，避免相同数值落在不同桶里）
+// 量化结果先夹到int32范围再转换，坐标很大或epsilon很小时不会溢出
+inline uint32_t QuantizeFloat(float value, float epsilon) {
+    if (epsilon > 0.0f && std::isfinite(value)) {
+        double q = std::floor((double)value / (double)epsilon + 0.5);
+        if (q < (double)INT32_MIN) { q = (double)INT32_MIN; }
+        if (q > (double)INT32_MAX) { q = (double)INT32_MAX; }
+        return (uint32_t)(int32_t)q;
+    }
+    if (value == 0.0f) {
+        value = 0.0f;
+    }
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline void BuildKey(const StaticMeshComponentVertexData& vtx, const MeshWeldSettings& settings, WeldKey& key) {
+    for (int i = 0; i < 4; ++i) {
+        key.v[i] = QuantizeFloat(vtx.mPosition[i], settings.positionEpsilon);
+        key.v[4 + i] = QuantizeFloat(vtx.mTexcoord[i], settings.texcoordEpsilon);
+        key.v[8 + i] = QuantizeFloat(vtx.mNormal[i], settings.normalEpsilon);
+        key.v[12 + i] = QuantizeFloat(vtx.mTangent[i], settings.tangentEpsilon);
+    }
+}
+
+inline uint32_t HashKey(const WeldKey& key) {
+    // FNV-1a + murmur3 finalizer
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < kWeldKeyCount; ++i) {
+        h = (h ^ key.v[i]) * 16777619u;
+    }
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+inline bool KeyEqual(const WeldKey& a, const WeldKey& b) {
+    return memcmp(a.v, b.v, sizeof(a.v)) == 0;
+}
+
+} // namespace
+
+bool MeshWelder::Weld(const std::vector<StaticMeshComponentVertexData>& inVertices,
+                      const std::vector<unsigned int>& inIndices,
+                      const MeshWeldSettings& settings,
+                      std::vector<StaticMeshComponentVertexData>& outVertices,
+                      std::vector<unsigned int>& outIndices,
+                      MeshWeldStats* outStats) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    const size_t vertexCount = inVertices.size();
+    for (unsigned int index : inIndices) {
+        if (index >= vertexCount) {
+            return false;
+        }
+    }
+
+    // 哈希表容量：不小于2倍顶点数的2的幂
+    size_t capacity = 16;
+    while (capacity < vertexCount * 2) {
+        capacity <<= 1;
+    }
+    const size_t mask = capacity - 1;
+
+    std::vector<uint32_t> table(capacity, kEmptySlot);
+    std::vector<WeldKey> uniqueKeys;
+    std::vector<unsigned int> remap(vertexCount);
+    std::vector<StaticMeshComponentVertexData> uniqueVertices;
+    uniqueKeys.reserve(vertexCount);
+    uniqueVertices.reserve(vertexCount);
+
+    WeldKey key;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        BuildKey(inVertices[i], settings, key);
+
+        size_t slot = HashKey(key) & mask;
+        while (true) {
+            uint32_t entry = table[slot];
+            if (entry == kEmptySlot) {
+                entry = (uint32_t)uniqueVertices.size();
+                table[slot] = entry;
+                uniqueKeys.push_back(key);
+                uniqueVertices.push_back(inVertices[i]);
+                remap[i] = entry;
+                break;
+            }
+            if (KeyEqual(uniqueKeys[entry], key)) {
+                remap[i] = entry;
+                break;
+            }
+            slot = (slot + 1) & mask;  // 线性探测
+        }
+    }
+
+    outIndices.resize(inIndices.size());
+    for (size_t i = 0; i < inIndices.size(); ++i) {
+        outIndices[i] = remap[inIndices[i]];
+    }
+    outVertices.swap(uniqueVertices);
+
+    if (outStats) {
+        auto endTime = std::chrono::high_resolution_clock::now();
+        outStats->inputVertexCount = (unsigned int)vertexCount;
+        outStats->outputVertexCount = (unsigned int)outVertices.size();
+        outStats->indexCount = (unsigned int)outIndices.size();
+        outStats->weldTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    }
+    return true;
+}
@@ -0,0 +1,332 @@
+// PipelineStateCache.cpp
+// 图形管线状态缓存实现
+
+#include "public/PipelineStateCache.h"
+#include "public/BattleFireDirect.h"
+#include "public/HashUtils.h"
+#include "public/PathUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static constexpr uint32_t kLibraryMagic = 0x4C505346;   // "FSPL"
+static constexpr uint32_t kLibraryVersion = 1;          // 文件头或键的组成变化时递增，旧管线库整体失效
+
+// ========== 管线描述哈希 ==========
+// 逐字段哈希：描述中有指针（字节码、输入布局），结构体里也有对齐填充，不能整体按字节哈希
+
+template <typename T>
+static void HashValue(XXH64Hasher& hasher, const T& value) {
+    hasher.Update(&value, sizeof(T));
+}
+
+static void HashBytecode(XXH64Hasher& hasher, const D3D12_SHADER_BYTECODE& bytecode) {
+    const uint64_t size = bytecode.pShaderBytecode ? bytecode.BytecodeLength : 0;
+    HashValue(hasher, size);
+    if (size > 0) {
+        hasher.Update(bytecode.pShaderBytecode, (size_t)size);
+    }
+}
+
+static void HashBlendState(XXH64Hasher& hasher, const D3D12_BLEND_DESC& blend) {
+    HashValue(hasher, blend.AlphaToCoverageEnable);
+    HashValue(hasher, blend.IndependentBlendEnable);
+    for (const D3D12_RENDER_TARGET_BLEND_DESC& rt : blend.RenderTarget) {
+        HashValue(hasher, rt.BlendEnable);
+        HashValue(hasher, rt.LogicOpEnable);
+        HashValue(hasher, rt.SrcBlend);
+        HashValue(hasher, rt.DestBlend);
+        HashValue(hasher, rt.BlendOp);
+        HashValue(hasher, rt.SrcBlendAlpha);
+        HashValue(hasher, rt.DestBlendAlpha);
+        HashValue(hasher, rt.BlendOpAlpha);
+        HashValue(hasher, rt.LogicOp);
+        HashValue(hasher, rt.RenderTargetWriteMask);
+    }
+}
+
+static void HashStencilOp(XXH64Hasher& hasher, const D3D12_DEPTH_STENCILOP_DESC& op) {
+    HashValue(hasher, op.StencilFailOp);
+    HashValue(hasher, op.StencilDepthFailOp);
+    HashValue(hasher, op.StencilPassOp);
+    HashValue(hasher, op.StencilFunc);
+}
+
+static void HashDepthStencilState(XXH64Hasher& hasher, const D3D12_DEPTH_STENCIL_DESC& depthStencil) {
+    HashValue(hasher, depthStencil.DepthEnable);
+    HashValue(hasher, depthStencil.DepthWriteMask);
+    HashValue(hasher, depthStencil.DepthFunc);
+    HashValue(hasher, depthStencil.StencilEnable);
+    HashValue(hasher, depthStencil.StencilReadMask);
+    HashValue(hasher, depthStencil.StencilWriteMask);
+    HashStencilOp(hasher, depthStencil.FrontFace);
+    HashStencilOp(hasher, depthStencil.BackFace);
+}
+
+static void HashInputLayout(XXH64Hasher& hasher, const D3D12_INPUT_LAYOUT_DESC& layout) {
+    const UINT count = layout.pInputElementDescs ? layout.NumElements : 0;
+    HashValue(hasher, count);
+    for (UINT i = 0; i < count; ++i) {
+        const D3D12_INPUT_ELEMENT_DESC& element = layout.pInputElementDescs[i];
+        hasher.UpdateString(element.SemanticName);
+        HashValue(hasher, element.SemanticIndex);
+        HashValue(hasher, element.Format);
+        HashValue(hasher, element.InputSlot);
+        HashValue(hasher, element.AlignedByteOffset);
+        HashValue(hasher, element.InputSlotClass);
+        HashValue(hasher, element.InstanceDataStepRate);
+    }
+}
+
+static std::wstring KeyToName(uint64_t key) {
+    std::string hex = HashToHexString(key);
+    return std::wstring(hex.begin(), hex.end());
+}
+
+// ========== PipelineStateCache ==========
+
+PipelineStateCache& PipelineStateCache::GetInstance() {
+    static PipelineStateCache instance;
+    return instance;
+}
+
+bool PipelineStateCache::Initialize(ID3D12Device* device, const std::wstring& filePath) {
+    if (!device) return false;
+    m_filePath = filePath;
+
+    size_t slash = m_filePath.find_last_of(L"\\/");
+    if (slash != std::wstring::npos && !CreateDirectoryRecursive(m_filePath.substr(0, slash))) {
+        std::wcout << L"PipelineStateCache: Failed to create directory for " << m_filePath << std::endl;
+    }
+
+    Microsoft::WRL::ComPtr<ID3D12Device1> device1;
+    if (FAILED(device->QueryInterface(IID_PPV_ARGS(&device1)))) {
+        std::cout << "PipelineStateCache: ID3D12Device1 not available, in-process cache only" << std::endl;
+        return false;
+    }
+
+    // 文件格式：magic + version + 管线库序列化数据
+    std::vector<uint8_t> fileData;
+    {
+        std::ifstream file(m_filePath, std::ios::binary);
+        if (file.is_open()) {
+            fileData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+    }
+
+    const size_t headerSize = sizeof(uint32_t) * 2;
+    uint32_t magic = 0, version = 0;
+    if (fileData.size() > headerSize) {
+        memcpy(&magic, fileData.data(), sizeof(magic));
+        memcpy(&version, fileData.data() + sizeof(magic), sizeof(version));
+    }
+    if (magic == kLibraryMagic && version == kLibraryVersion) {
+        m_libraryData.assign(fileData.begin() + headerSize, fileData.end());
+        HRESULT hr = device1->CreatePipelineLibrary(m_libraryData.data(), m_libraryData.size(), IID_PPV_ARGS(&m_library));
+        if (FAILED(hr)) {
+            // 驱动或显卡变化后旧数据不可用
+            std::cout << "PipelineStateCache: Pipeline library discarded (HRESULT 0x" << std::hex << hr << std::dec << ")" << std::endl;
+            m_library.Reset();
+            m_libraryData.clear();
+        }
+    } else if (!fileData.empty()) {
+        std::cout << "PipelineStateCache: Library format mismatch, cache discarded" << std::endl;
+    }
+
+    if (!m_library) {
+        HRESULT hr = device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&m_library));
+        if (FAILED(hr)) {
+            std::cout << "PipelineStateCache: CreatePipelineLibrary failed, in-process cache only" << std::endl;
+            m_library.Reset();
+            return false;
+        }
+        m_libraryDirty = true;  // 旧文件作废，退出时重写
+    }
+
+    std::cout << "PipelineStateCache: Pipeline library " << m_libraryData.size() / 1024 << " KB" << std::endl;
+    return true;
+}
+
+void PipelineStateCache::Shutdown() {
+    if (m_library && m_libraryDirty && !SaveLibrary()) {
+        std::cout << "PipelineStateCache: Failed to write pipeline library" << std::endl;
+    }
+    if (m_hitCount + m_libraryHitCount + m_missCount > 0) {
+        std::cout << "PipelineStateCache: " << m_hitCount << " hits, " << m_libraryHitCount << " from library, "
+                  << m_missCount << " created (" << m_createTimeMs << " ms)" << std::endl;
+    }
+
+    // 设备释放前GPU已空闲
+    m_pipelines.clear();
+    m_retiredPipelines.clear();
+    m_rootSignatures.clear();
+    m_library.Reset();
+    m_libraryData.clear();
+    m_libraryData.shrink_to_fit();
+    m_libraryDirty = false;
+}
+
+bool PipelineStateCache::SaveLibrary() {
+    const size_t size = m_library->GetSerializedSize();
+    std::vector<uint8_t> data(sizeof(uint32_t) * 2 + size);
+    memcpy(data.data(), &kLibraryMagic, sizeof(uint32_t));
+    memcpy(data.data() + sizeof(uint32_t), &kLibraryVersion, sizeof(uint32_t));
+    if (FAILED(m_library->Serialize(data.data() + sizeof(uint32_t) * 2, size))) {
+        return false;
+    }
+
+    if (!WriteFileAtomic(m_filePath, data)) {
+        return false;
+    }
+
+    std::cout << "PipelineStateCache: Wrote pipeline library " << size / 1024 << " KB" << std::endl;
+    m_libraryDirty = false;
+    return true;
+}
+
+void PipelineStateCache::RegisterRootSignature(ID3D12RootSignature* rootSignature, const void* serializedData, size_t size) {
+    if (!rootSignature || !serializedData || size == 0) return;
+
+    RootSignatureRecord& record = m_rootSignatures[rootSignature];
+    record.rootSignature = rootSignature;
+    record.hash = HashXXH64(serializedData, size, kLibraryVersion);
+    record.persistent = true;
+}
+
+const PipelineStateCache::RootSignatureRecord& PipelineStateCache::GetRootSignatureRecord(ID3D12RootSignature* rootSignature) {
+    auto it = m_rootSignatures.find(rootSignature);
+    if (it != m_rootSignatures.end()) return it->second;
+
+    RootSignatureRecord& record = m_rootSignatures[rootSignature];
+    record.rootSignature = rootSignature;
+    uintptr_t address = (uintptr_t)rootSignature;
+    record.hash = HashXXH64(&address, sizeof(address), 0);
+    record.persistent = false;
+    return record;
+}
+
+uint64_t PipelineStateCache::ComputeKey(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc,
+                                        const RootSignatureRecord& rootSignature) const {
+    XXH64Hasher hasher(((uint64_t)kLibraryVersion << 32) | sizeof(D3D12_GRAPHICS_PIPELINE_STATE_DESC));
+    HashValue(hasher, rootSignature.hash);
+    HashBytecode(hasher, desc.VS);
+    HashBytecode(hasher, desc.PS);
+    HashBytecode(hasher, desc.DS);
+    HashBytecode(hasher, desc.HS);
+    HashBytecode(hasher, desc.GS);
+    HashBlendState(hasher, desc.BlendState);
+    HashValue(hasher, desc.SampleMask);
+    HashValue(hasher, desc.RasterizerState);   // 全是4字节字段，没有填充
+    HashDepthStencilState(hasher, desc.DepthStencilState);
+    HashInputLayout(hasher, desc.InputLayout);
+    HashValue(hasher, desc.IBStripCutValue);
+    HashValue(hasher, desc.PrimitiveTopologyType);
+    HashValue(hasher, desc.NumRenderTargets);
+    for (DXGI_FORMAT format : desc.RTVFormats) {
+        HashValue(hasher, format);
+    }
+    HashValue(hasher, desc.DSVFormat);
+    HashValue(hasher, desc.SampleDesc.Count);
+    HashValue(hasher, desc.SampleDesc.Quality);
+    HashValue(hasher, desc.NodeMask);
+    HashValue(hasher, desc.Flags);
+    return hasher.Digest();
+}
+
+HRESULT PipelineStateCache::CreateGraphicsPipelineState(ID3D12Device* device, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc,
+                                                        ID3D12PipelineState** outPSO) {
+    if (!device || !outPSO) return E_INVALIDARG;
+    *outPSO = nullptr;
+
+    // Stream Output和外部缓存的PSO数据不参与缓存，直接创建
+    if (desc.StreamOutput.NumEntries > 0 || desc.CachedPSO.pCachedBlob) {
+        m_missCount++;
+        return device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(outPSO));
+    }
+
+    const RootSignatureRecord& rootSignature = GetRootSignatureRecord(desc.pRootSignature);
+    const uint64_t key = ComputeKey(desc, rootSignature);
+
+    auto it = m_pipelines.find(key);
+    if (it != m_pipelines.end()) {
+        m_hitCount++;
+        *outPSO = it->second.pso.Get();
+        (*outPSO)->AddRef();
+        return S_OK;
+    }
+
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> pso;
+    const bool useLibrary = m_library && rootSignature.persistent;
+    const std::wstring name = useLibrary ? KeyToName(key) : std::wstring();
+
+    // 管线库会校验描述是否与存储时一致，不一致返回E_INVALIDARG
+    if (useLibrary && SUCCEEDED(m_library->LoadGraphicsPipeline(name.c_str(), &desc, IID_PPV_ARGS(&pso)))) {
+        m_libraryHitCount++;
+    } else {
+        auto createStart = std::chrono::high_resolution_clock::now();
+        HRESULT hr = device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&pso));
+        auto createEnd = std::chrono::high_resolution_clock::now();
+        m_createTimeMs += std::chrono::duration<double, std::milli>(createEnd - createStart).count();
+        m_missCount++;
+        if (FAILED(hr)) {
+            return hr;
+        }
+
+        // 同名条目已存在（键冲突或描述不一致）时StorePipeline失败，只影响下次启动是否命中
+        if (useLibrary && SUCCEEDED(m_library->StorePipeline(name.c_str(), pso.Get()))) {
+            m_libraryDirty = true;
+        }
+    }
+
+    PipelineEntry& entry = m_pipelines[key];
+    entry.pso = pso;
+    entry.vsHash = HashShaderBytecode(desc.VS);
+    entry.psHash = HashShaderBytecode(desc.PS);
+    *outPSO = pso.Detach();
+    return S_OK;
+}
+
+// ========== 热重载 ==========
+
+uint64_t PipelineStateCache::HashShaderBytecode(const D3D12_SHADER_BYTECODE& bytecode) {
+    if (!bytecode.pShaderBytecode || bytecode.BytecodeLength == 0) return 0;
+    return HashXXH64(bytecode.pShaderBytecode, bytecode.BytecodeLength);
+}
+
+int PipelineStateCache::EvictShaders(const std::vector<uint64_t>& shaderHashes, UINT64 fenceValue) {
+    if (shaderHashes.empty()) return 0;
+
+    auto isEvicted = [&](uint64_t hash) {
+        return hash != 0 && std::find(shaderHashes.begin(), shaderHashes.end(), hash) != shaderHashes.end();
+    };
+
+    int count = 0;
+    for (auto it = m_pipelines.begin(); it != m_pipelines.end();) {
+        if (isEvicted(it->second.vsHash) || isEvicted(it->second.psHash)) {
+            RetiredPipeline retired;
+            retired.pso = std::move(it->second.pso);
+            retired.fenceValue = fenceValue;
+            m_retiredPipelines.push_back(std::move(retired));
+            it = m_pipelines.erase(it);
+            count++;
+        } else {
+            ++it;
+        }
+    }
+    m_evictCount += count;
+    return count;
+}
+
+void PipelineStateCache::ReleaseRetiredPipelines() {
+    const UINT64 completed = GetCompletedFenceValue();
+    for (size_t i = 0; i < m_retiredPipelines.size();) {
+        if (m_retiredPipelines[i].fenceValue <= completed) {
+            m_retiredPipelines[i] = std::move(m_retiredPipelines.back());
+            m_retiredPipelines.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
@@ -4,6 +4,11 @@
 #include "public/Texture/TexturePreviewPanel.h"
 #include "public/Texture/TextureManager.h"
 #include "public/PathUtils.h"
+#include "public/Texture/TextureAsset.h"
+#include "public/Material/MaterialAsset.h"
+#include "public/ParallelFor.h"
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <windows.h>
 #include <shlwapi.h>
@@ -19,6 +24,43 @@ namespace {
                extension == ".dds" || extension == ".bmp" || extension == ".tga" ||
                extension == ".hdr" || extension == ".ast";
     }
+
+    // 小写扩展名（UTF-8，含点）
+    std::string GetLowerExtension(const std::wstring& path) {
+        std::string extension = WToA(PathFindExtensionW(path.c_str()));
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        return extension;
+    }
+
+    void AddUnique(std::vector<std::wstring>& paths, const std::wstring& path) {
+        if (std::find(paths.begin(), paths.end(), path) == paths.end()) {
+            paths.push_back(path);
+        }
+    }
+
+    bool EndsWithNoCase(const std::wstring& str, const std::wstring& suffix) {
+        return str.size() >= suffix.size() &&
+               _wcsicmp(str.c_str() + str.size() - suffix.size(), suffix.c_str()) == 0;
+    }
+
+    // 递归收集目录下以suffix结尾的文件（不区分大小写）
+    void CollectFiles(const std::wstring& directory, const std::wstring& suffix, std::vector<std::wstring>& outPaths) {
+        WIN32_FIND_DATAW findData;
+        HANDLE hFind = FindFirstFileW((directory + L"*").c_str(), &findData);
+        if (hFind == INVALID_HANDLE_VALUE) return;
+
+        do {
+            std::wstring fileName = findData.cFileName;
+            if (fileName == L"." || fileName == L"..") continue;
+
+            if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+                CollectFiles(directory + fileName + L"\\", suffix, outPaths);
+            } else if (EndsWithNoCase(fileName, suffix)) {
+                outPaths.push_back(directory + fileName);
+            }
+        } while (FindNextFileW(hFind, &findData));
+        FindClose(hFind);
+    }
 }
 
 ResourceManager& ResourceManager::GetInstance() {
@@ -385,6 +427,24 @@ void ResourceManager::ShowResourceWindow(bool* open) {
     ImGui::Text("Total Shaders Found: %d", GetTotalShaderCount());
     ImGui::Text("Total Materials Found: %d", GetTotalMaterialCount());
     ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Note: Resources are loaded automatically at startup");
+
+    bool hotReload = IsHotReloadEnabled();
+    if (ImGui::Checkbox("Hot Reload", &hotReload)) {
+        if (hotReload) {
+            StartHotReload();
+        } else {
+            StopHotReload();
+        }
+    }
+    ImGui::SameLine();
+    ImGui::Text("%d reloaded, %d shaders compiling", m_hotReloadCount,
+                MaterialManager::GetInstance().GetPendingShaderReloadCount());
+    if (ImGui::Button("Cook Assets")) {
+        CookAssets();
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Convert all .material / .texture.ast files to binary .matbin / .texbin");
+    }
     ImGui::Separator();
 
     // 文件树显示
@@ -408,3 +468,110 @@ void ResourceManager::ShowResourceWindow(bool* open) {
 
     ImGui::End();
 }
+
+// ========== 热重载 ==========
+
+bool ResourceManager::StartHotReload() {
+    std::vector<std::wstring> directories;
+    directories.push_back(m_contentPath);
+    directories.push_back(m_enginePath);
+    return m_fileWatcher.Start(directories);
+}
+
+void ResourceManager::StopHotReload() {
+    m_fileWatcher.Stop();
+    m_pendingTextureReloads.clear();
+    m_pendingMaterialReloads.clear();
+}
+
+void ResourceManager::PollFileChanges() {
+    std::vector<std::wstring> changedPaths;
+    if (!m_fileWatcher.PollChanges(changedPaths)) return;
+
+    std::vector<std::wstring> includePaths;
+    std::vector<std::wstring> shaderPaths;
+    for (const std::wstring& path : changedPaths) {
+        // 引擎自己写出的生成代码、编译缓存和纹理缓存
+        const std::wstring key = NormalizePathKey(path);
+        if (key.find(L"\\shader_cache\\") != std::wstring::npos ||
+            key.find(L"\\texturecache\\") != std::wstring::npos) {
+            continue;
+        }
+
+        const std::string extension = GetLowerExtension(path);
+        if (extension == ".shader") {
+            AddUnique(shaderPaths, path);
+        } else if (extension == ".hlsl" || extension == ".hlsli") {
+            AddUnique(includePaths, path);
+        } else if (extension == ".material") {
+            AddUnique(m_pendingMaterialReloads, path);
+        } else if (IsTextureFile(extension)) {
+            // .ast只有.texture.ast是纹理（.shader.ast是旧格式shader）
+            if (extension == ".ast" && key.find(L".texture.ast") == std::wstring::npos) continue;
+            AddUnique(m_pendingTextureReloads, path);
+        }
+    }
+
+    // 依赖关系：include -> 编译时包含它的shader（include图由字节码缓存记录）；shader -> 使用它的材质
+    // （原Shader对象接管新版本，材质指针不变）。同一shader重复提交时后一次替换前一次
+    MaterialManager& materialManager = MaterialManager::GetInstance();
+    for (const std::wstring& path : includePaths) {
+        m_hotReloadCount += materialManager.HotReloadShadersIncluding(path);
+    }
+    for (const std::wstring& path : shaderPaths) {
+        if (materialManager.HotReloadShader(path)) {
+            m_hotReloadCount++;
+        }
+    }
+}
+
+void ResourceManager::ProcessPendingReloads(ID3D12GraphicsCommandList* commandList) {
+    MaterialManager& materialManager = MaterialManager::GetInstance();
+    TextureManager::GetInstance().SetCommandList(commandList);
+
+    // 纹理 -> 引用它的材质：原槽位重建SRV，Actor持有的材质不变
+    for (const std::wstring& path : m_pendingTextureReloads) {
+        std::vector<TextureAsset*> reloaded;
+        TextureManager::GetInstance().ReloadTexturesFromFile(path, reloaded);
+        for (TextureAsset* texture : reloaded) {
+            int materialCount = materialManager.RefreshTextureBindings(texture);
+            std::cout << "Hot reload: texture " << texture->GetName() << " (" << materialCount << " materials)" << std::endl;
+            m_hotReloadCount++;
+        }
+    }
+
+    for (const std::wstring& path : m_pendingMaterialReloads) {
+        if (materialManager.HotReloadMaterial(path, commandList)) {
+            m_hotReloadCount++;
+        }
+    }
+
+    m_pendingTextureReloads.clear();
+    m_pendingMaterialReloads.clear();
+}
+
+// ========== 资产烘焙 ==========
+
+int ResourceManager::CookAssets() {
+    const auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::wstring> materialPaths;
+    std::vector<std::wstring> texturePaths;
+    for (const std::wstring& root : { GetContentPath(), GetEnginePath() }) {
+        CollectFiles(root, L".material", materialPaths);
+        CollectFiles(root, L".texture.ast", texturePaths);
+    }
+
+    std::atomic<int> failedCount(0);
+    ParallelFor(materialPaths.size(), [&](size_t i) {
+        if (!MaterialAsset::Cook(materialPaths[i])) ++failedCount;
+    });
+    ParallelFor(texturePaths.size(), [&](size_t i) {
+        if (!TextureAsset::CookAssetFile(texturePaths[i])) ++failedCount;
+    });
+
+    const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Cooked " << materialPaths.size() << " materials and " << texturePaths.size() << " texture assets in "
+              << elapsedMs << " ms (" << failedCount.load() << " failed)" << std::endl;
+    return failedCount.load();
+}
@@ -4,6 +4,8 @@
 #include "public/Material/MaterialInstance.h"
 #include "public/Material/MaterialManager.h"
 #include "public/Material/Shader.h"
+#include "public/Mesh/MeshManager.h"
+#include "public/UploadAllocator.h"
 #include <DirectXMath.h>
 #include <windows.h>
 #include <iostream>
@@ -16,10 +18,14 @@
 #include <wrl.h>
 #include <stdexcept>
 #include <string>
+#include <chrono>
+#include <algorithm>
 #include <DDSTextureLoader\DDSTextureLoader12.h>
 #include <d3d12.h>
 #include <d3dx12.h>
 #include "public/PathUtils.h"
+#include "public/Texture/TextureCompressor.h"
+#include "public/Texture/TextureManager.h"
 
 #pragma comment(lib, "shlwapi.lib")
 
@@ -32,28 +38,10 @@ Scene::Scene(int viewportWidth, int viewportHeight)
     m_camera(DirectX::XMConvertToRadians(45.0f), (float)viewportWidth / (float)viewportHeight, 0.1f, 1000.0f),
     m_lightRotation(0.0f, 0.0f, 0.0f),
     m_lightDirection(-1.0f, -1.0f, 1.0f), m_textureLoaded(false), m_textureLoadSuccess(false){
-    m_constantBuffer = nullptr;
     m_texBuffer = nullptr;
-
-    m_constantBuffer = CreateConstantBufferObject(sizeof(SceneCBData));  // 使用共享CB结构体大小
-    // 初始化时映射一次（持久映射）
-    if (m_constantBuffer) {
-        D3D12_RANGE readRange = { 0, 0 };
-        m_constantBuffer->Map(0, &readRange, &m_mappedConstantBuffer);
-    }
 }
 
 Scene::~Scene() {
-    // 只在缓冲区存在且已映射时才执行Unmap
-    if ( m_mappedConstantBuffer) {
-        m_constantBuffer->Unmap(0, nullptr);
-        m_mappedConstantBuffer = nullptr;
-    }
-
-    if (m_constantBuffer) {
-        m_constantBuffer->Release();
-        m_constantBuffer = nullptr;
-    }
     for (auto rt : m_offscreenRTs) {
         if (rt) rt->Release();
     }
@@ -138,7 +126,7 @@ std::unordered_map<std::string, std::unique_ptr<Texture>> textures; // 示例纹
 HRESULT InitCOM() {
     return CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
 }
-// 加载PNG并保存为临时DDS
+// 加载PNG（或.hdr）并保存为临时DDS：LDR压缩为BC3 sRGB，.hdr压缩为BC6H，都使用引擎块编码器
 HRESULT ConvertPNGToDDS(const wchar_t* pngPath, Texture* Tex) {
     DirectX::ScratchImage image;
     HRESULT hr;
@@ -150,24 +138,13 @@ HRESULT ConvertPNGToDDS(const wchar_t* pngPath, Texture* Tex) {
     PathRemoveExtensionW(ddsPath);
     wcscat_s(ddsPath, MAX_PATH, L".dds");
     
-    // 1. 加载PNG图像
-    hr = DirectX::LoadFromWICFile(pngPath, DirectX::WIC_FLAGS_NONE, nullptr, image);
-    if (FAILED(hr)) {
-        _com_error err(hr);
-        OutputDebugStringW(err.ErrorMessage());
-        return hr;
+    // 1. 加载源图像
+    const bool isHDR = _wcsicmp(PathFindExtensionW(pngPath), L".hdr") == 0;
+    if (isHDR) {
+        hr = DirectX::LoadFromHDRFile(pngPath, nullptr, image);
+    } else {
+        hr = DirectX::LoadFromWICFile(pngPath, DirectX::WIC_FLAGS_NONE, nullptr, image);
     }
-
-    DirectX::ScratchImage mipChain;
-    // 2. 生成Mipmap链
-    hr = DirectX::GenerateMipMaps(
-        image.GetImages(),         // 输入图像
-        image.GetImageCount(),     // 图像数量
-        image.GetMetadata(),       // 元数据
-        DirectX::TEX_FILTER_DEFAULT, // 默认滤波算法
-        0,                         // 0表示生成完整Mipmap链
-        mipChain                   // 输出Mipmap链
-    );
     if (FAILED(hr)) {
         _com_error err(hr);
         OutputDebugStringW(err.ErrorMessage());
@@ -175,23 +152,17 @@ HRESULT ConvertPNGToDDS(const wchar_t* pngPath, Texture* Tex) {
     }
 
     DirectX::ScratchImage compressedImage;
-    // 3. 压缩格式
-    hr = DirectX::Compress(
-        mipChain.GetImages(),      // 输入Mipmap链图像
-        mipChain.GetImageCount(),  // 图像数量
-        mipChain.GetMetadata(),    // 元数据
-        DXGI_FORMAT_BC3_UNORM_SRGB,     // 压缩格式
-        DirectX::TEX_COMPRESS_DEFAULT, // 默认压缩设置
-        0.5f,                      // BC1阈值(BC7中未使用，但需提供)
-        compressedImage            // 输出压缩后的图像
-    );
-    if (FAILED(hr)) {
-        _com_error err(hr);
-        OutputDebugStringW(err.ErrorMessage());
-        return hr;
+    // 2. 生成Mipmap链并逐级压缩（BC3_UNORM_SRGB / BC6H_UF16），sRGB贴图在线性空间滤波
+    const TextureCompressionFormat format = isHDR ? TextureCompressionFormat::BC6H : TextureCompressionFormat::BC3;
+    MipGenerateSettings mipSettings;
+    mipSettings.sRGB = !isHDR;
+    if (!TextureCompressor::GetInstance().GenerateMipsAndCompress(image, format, !isHDR, TextureCompressionQuality::Normal,
+                                                                  mipSettings, compressedImage)) {
+        OutputDebugStringW(L"ConvertPNGToDDS: compression failed\n");
+        return E_FAIL;
     }
 
-    // 4. 保存为DDS文件 (自动添加DX10头部)
+    // 3. 保存为DDS文件 (自动添加DX10头部)
     hr = DirectX::SaveToDDSFile(
         compressedImage.GetImages(),
         compressedImage.GetImageCount(),
@@ -566,12 +537,6 @@ bool Scene::Initialize(ID3D12GraphicsCommandList* commandList) {
         m_staticMesh.InitFromFile(commandList, modelPath);
     }
 
-    // 常量缓冲区已在构造函数中创建和映射，这里只需检查是否有效
-    if (!m_constantBuffer || !m_mappedConstantBuffer) {
-        MessageBoxA(NULL, "常量缓冲区未正确初始化", "错误", MB_OK | MB_ICONERROR);
-        return false;
-    }
-
     // 1. 创建RTV描述符堆（用于4个离屏RT）
     D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
     rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
@@ -664,26 +629,206 @@ void Scene::Update(float deltaTime) {
         m_camera.GetNearPlane(), m_camera.GetFarPlane(),
         currentViewProjMatrix, m_shadowMode, m_giType);
 
-    // 使用持久映射，直接memcpy到映射内存
-    if (m_mappedConstantBuffer) {
-        memcpy(m_mappedConstantBuffer, &m_cbData, sizeof(SceneCBData));
+    // 每帧只写一次，从逐帧上传分配器取新地址（GPU仍在读取的旧帧数据不会被覆盖）
+    m_sceneCBAddress = LinearUploadAllocator::GetInstance().AllocateConstants(&m_cbData, sizeof(SceneCBData));
+
+    // 视锥剔除：相机视锥 + 阴影正交视锥
+    CullActors(currentViewProjMatrix, lightViewProjMatrix);
+    m_frameIndex++;
+
+    // 更新可见Actor的实例数据（每帧每个Actor只更新一次，上一帧矩阵用于Motion Vector）
+    // 相机可见列表全部更新；阴影投影者中已在相机列表里的跳过
+    const size_t cameraVisibleCount = m_visibleActors.size();
+    for (size_t i = 0; i < cameraVisibleCount + m_shadowCasterActors.size(); ++i) {
+        Actor* actor;
+        if (i < cameraVisibleCount) {
+            actor = m_visibleActors[i];
+        } else {
+            actor = m_shadowCasterActors[i - cameraVisibleCount];
+            int proxy = actor->GetSpatialProxy();
+            if (proxy >= 0 && m_cameraVisibleMask[proxy]) continue;
+        }
+        actor->UpdateInstanceData(m_frameIndex);
     }
 
-    // 更新所有Actor的CB（确保在任何Pass之前CB已准备好）
-    for (Actor* actor : m_actors) {
-        if (!actor) continue;
-        actor->UpdateConstantBuffer(viewMatrix, projectionMatrix,
-            normalizedLightDir, m_camera.GetPosition(),
-            m_skylightIntensity, m_skylightColor,
-            invProjMatrix, invViewMatrix,
-            lightViewProjMatrix, m_previousViewProjectionMatrix,
-            m_jitterOffset, m_previousJitterOffset,
-            m_viewportWidth, m_viewportHeight,
-            m_camera.GetNearPlane(), m_camera.GetFarPlane(),
-            currentViewProjMatrix, m_shadowMode, m_giType);
+    // 构建BasePass/阴影的绘制列表和实例批次，并写入实例缓冲（确保在任何Pass之前准备好）
+    BuildDrawLists(viewMatrix);
+
+    // 按本帧可见Actor请求纹理mip（常驻变化在之后的帧开始前执行）
+    RequestTextureStreaming();
+}
+
+void Scene::RequestTextureStreaming() {
+    TextureManager& textureManager = TextureManager::GetInstance();
+    if (!textureManager.IsStreamingEnabled() || m_viewportHeight <= 0) return;
+
+    // 距离d处一个像素对应的世界尺寸为 2 * d * tan(fov / 2) / 屏幕高度
+    const float tanHalfFov = tanf(m_camera.GetFov() * 0.5f);
+    const float nearZ = m_camera.GetNearPlane();
+    const DirectX::XMFLOAT3 eye = m_camera.GetPosition();
+
+    // 同一材质取所有可见Actor中最大的屏幕尺寸，每个材质的纹理只查找一次
+    m_streamingScreenSizes.clear();
+    for (Actor* actor : m_visibleActors) {
+        StaticMeshComponent* mesh = actor->GetMesh();
+        MaterialInstance* material = actor->GetMaterial();
+        if (!mesh || !material || mesh->mUVDensity <= 0.0f) continue;
+
+        const MeshBounds& bounds = actor->GetWorldBounds();
+        const float dx = bounds.center[0] - eye.x;
+        const float dy = bounds.center[1] - eye.y;
+        const float dz = bounds.center[2] - eye.z;
+        const float distance = (std::max)(nearZ, sqrtf(dx * dx + dy * dy + dz * dz) - bounds.radius);
+
+        // 缩放越大UV在世界空间越稀疏，取最大分量（偏清晰）
+        const DirectX::XMFLOAT3 scale = actor->GetScale();
+        const float maxScale = (std::max)(fabsf(scale.x), (std::max)(fabsf(scale.y), fabsf(scale.z)));
+        const float uvPerWorld = mesh->mUVDensity / (std::max)(maxScale, 1e-4f);
+        const float pixelsPerUV = (float)m_viewportHeight / (2.0f * distance * tanHalfFov * uvPerWorld);
+
+        float& screenSize = m_streamingScreenSizes[material];
+        screenSize = (std::max)(screenSize, pixelsPerUV);
+    }
+
+    for (const auto& pair : m_streamingScreenSizes) {
+        for (const std::wstring& path : pair.first->GetTexturePaths()) {
+            if (path.empty()) continue;
+            TextureAsset* texture = textureManager.GetTextureByPath(path);
+            if (texture) textureManager.RequestStreaming(texture, pair.second);
+        }
     }
 }
 
+void Scene::CullActors(const DirectX::XMMATRIX& cameraViewProj, const DirectX::XMMATRIX& lightViewProj) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    m_visibleActors.clear();
+    m_shadowCasterActors.clear();
+
+    // 本帧移动过的Actor同步到索引（包围盒仍在胖包围盒内时不改动树）
+    m_spatialIndex.Flush();
+
+    int meshActorCount = 0;
+    if (!m_frustumCullingEnabled) {
+        // 关闭剔除时全部可见（用于对比）
+        for (Actor* actor : m_actors) {
+            if (!actor->GetMesh()) continue;
+            m_visibleActors.push_back(actor);
+            m_shadowCasterActors.push_back(actor);
+        }
+        meshActorCount = (int)m_visibleActors.size();
+    } else if (m_spatialIndexEnabled) {
+        Frustum cameraFrustum = Frustum::FromViewProjection(cameraViewProj);
+        Frustum lightFrustum = Frustum::FromShadowViewProjection(lightViewProj);
+        m_spatialIndex.QueryFrustum(cameraFrustum, m_visibleActors);
+        m_spatialIndex.QueryFrustum(lightFrustum, m_shadowCasterActors);
+        for (Actor* actor : m_actors) {
+            if (actor->GetMesh()) meshActorCount++;
+        }
+    } else {
+        m_culler.Gather(m_actors);
+        m_culler.Cull(Frustum::FromViewProjection(cameraViewProj), CULL_VIEW_CAMERA, m_visibleActors);
+        m_culler.Cull(Frustum::FromShadowViewProjection(lightViewProj), CULL_VIEW_SHADOW, m_shadowCasterActors);
+        meshActorCount = m_culler.GetCount();
+    }
+
+    // 标记相机可见（Update中据此跳过重复的CB更新）
+    m_cameraVisibleMask.assign(m_spatialIndex.GetTree().GetNodeCapacity(), 0);
+    for (Actor* actor : m_visibleActors) {
+        int proxy = actor->GetSpatialProxy();
+        if (proxy >= 0) m_cameraVisibleMask[proxy] = 1;
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    m_cullingStats.totalCount = meshActorCount;
+    m_cullingStats.cameraVisibleCount = (int)m_visibleActors.size();
+    m_cullingStats.shadowVisibleCount = (int)m_shadowCasterActors.size();
+    m_cullingStats.cullTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+void Scene::BuildDrawLists(const DirectX::XMMATRIX& viewMatrix) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // BasePass：按PSO/材质/网格/深度排序，Shader没有编译PSO时pipelineState为空（Render中使用默认PSO）
+    const float nearPlane = m_camera.GetNearPlane();
+    const float farPlane = m_camera.GetFarPlane();
+    m_drawList.Reset();
+    for (Actor* actor : m_visibleActors) {
+        MaterialInstance* material = actor->GetMaterial();
+        if (!material || !material->GetShader()) {
+            material = nullptr;
+        }
+        ID3D12PipelineState* actorPSO = material ? material->GetPSO(0) : nullptr;
+
+        // 包围盒中心的视空间深度，归一化到[near, far]
+        const MeshBounds& bounds = actor->GetWorldBounds();
+        DirectX::XMVECTOR center = DirectX::XMVectorSet(
+            (bounds.min[0] + bounds.max[0]) * 0.5f,
+            (bounds.min[1] + bounds.max[1]) * 0.5f,
+            (bounds.min[2] + bounds.max[2]) * 0.5f, 1.0f);
+        float viewDepth = DirectX::XMVectorGetZ(DirectX::XMVector3TransformCoord(center, viewMatrix));
+        float depth01 = (viewDepth - nearPlane) / (farPlane - nearPlane);
+
+        m_drawList.Add(actorPSO, material, actor->GetMesh(), depth01, actor);
+    }
+    m_drawList.Sort();
+
+    // 阴影：PSO固定，只按网格合批
+    m_shadowDrawList.Reset();
+    for (Actor* actor : m_shadowCasterActors) {
+        m_shadowDrawList.Add(nullptr, nullptr, actor->GetMesh(), 0.0f, actor);
+    }
+    m_shadowDrawList.Sort();
+
+    // 关闭实例化时每个批次只有一个实例（用于对比DrawCall数量）
+    const uint32_t maxBatchSize = m_instancingEnabled ? 0 : 1;
+    m_drawList.BuildBatches(m_drawBatches, maxBatchSize);
+    m_shadowDrawList.BuildBatches(m_shadowBatches, maxBatchSize);
+
+    // 实例数据按绘制包顺序写入：BasePass在前，阴影在后；没有Actor时写入一个单位矩阵供旧的单Mesh渲染使用
+    const uint32_t baseCount = (uint32_t)m_drawList.GetCount();
+    const uint32_t shadowCount = (uint32_t)m_shadowDrawList.GetCount();
+    const uint32_t totalCount = baseCount + shadowCount;
+    UploadAllocation allocation;
+    const uint32_t allocCount = totalCount > 0 ? totalCount : 1;
+    if (!LinearUploadAllocator::GetInstance().Allocate(sizeof(InstanceData) * allocCount,
+            D3D12_RAW_UAV_SRV_BYTE_ALIGNMENT, allocation)) {
+        OutputDebugStringA("Scene::BuildDrawLists - Failed to allocate instance data\n");
+        m_instanceDataAddress = 0;
+        m_drawBatches.clear();
+        m_shadowBatches.clear();
+        return;
+    }
+    m_instanceDataAddress = allocation.gpuAddress;
+    InstanceData* instances = static_cast<InstanceData*>(allocation.cpuAddress);
+
+    if (totalCount == 0) {
+        InstanceData& identity = instances[0];
+        DirectX::XMStoreFloat4x4(&identity.modelMatrix, DirectX::XMMatrixIdentity());
+        identity.normalMatrix = identity.modelMatrix;
+        identity.prevModelMatrix = identity.modelMatrix;
+    }
+    for (uint32_t i = 0; i < baseCount; ++i) {
+        const Actor* actor = static_cast<const Actor*>(m_drawList.GetPacket(i).userData);
+        instances[i] = actor->GetInstanceData();
+    }
+    for (uint32_t i = 0; i < shadowCount; ++i) {
+        const Actor* actor = static_cast<const Actor*>(m_shadowDrawList.GetPacket(i).userData);
+        instances[baseCount + i] = actor->GetInstanceData();
+    }
+    for (DrawBatch& batch : m_shadowBatches) {
+        batch.firstInstance += baseCount;
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    m_drawListBuildTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS Scene::GetInstanceDataAddress(uint32_t firstInstance) const {
+    if (!m_instanceDataAddress) return 0;
+    return m_instanceDataAddress + (UINT64)firstInstance * sizeof(InstanceData);
+}
+
 // TAA: 更新上一帧的 ViewProjection 矩阵（在帧结束时调用）
 void Scene::UpdatePreviousViewProjectionMatrix() {
     DirectX::XMMATRIX viewMatrix = m_camera.GetViewMatrix();
@@ -730,9 +875,6 @@ void Scene::Render(ID3D12GraphicsCommandList* commandList, ID3D12PipelineState*
 
     commandList->SetGraphicsRootSignature(rootSignature);
 
-    // 注意：不在这里绑定常量缓冲区，而是在每个Actor渲染前绑定
-    // 这样可以确保每次绑定时GPU读取的是最新的CB数据
-
     // 根据SRV堆状态决定设置哪些堆
 
     CD3DX12_GPU_DESCRIPTOR_HANDLE texHandle(srvHeap->GetGPUDescriptorHandleForHeapStart());
@@ -752,116 +894,60 @@ void Scene::Render(ID3D12GraphicsCommandList* commandList, ID3D12PipelineState*
     //  绘制逻辑（使用当前PSO和根签名）
     commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    // 【新增】多Actor支持：遍历所有Actor，每个Actor使用其对应的Material进行渲染
+    // 场景CB（b0，Update中已填充）所有绘制共享，逐Actor的变换来自实例缓冲（Slot 3）
+    D3D12_GPU_VIRTUAL_ADDRESS sceneCBAddress = m_sceneCBAddress;
+
+    // pso由调用方每帧从Shader取得（热重载后旧PSO会被释放），为空时跳过使用它的绘制
+    // 【新增】多Actor支持：按Update中构建的批次绘制，同PSO/材质/网格的Actor合并为一次实例化DrawCall
     // 如果没有Actor，则回退到旧的单Mesh渲染方式
     if (!m_actors.empty()) {
-        // 准备CB参数（所有Actor共享的场景级参数）
-        DirectX::XMMATRIX viewMatrix = m_camera.GetViewMatrix();
-        DirectX::XMMATRIX projMatrix = m_camera.GetProjectionMatrix();
-
-        // TAA: 应用Jitter到投影矩阵（与UpdateSceneCB中相同的逻辑）
-        if (m_jitterOffset.x != 0.0f || m_jitterOffset.y != 0.0f) {
-            float jitterOffsetX = m_jitterOffset.x * 2.0f / static_cast<float>(m_viewportWidth);
-            float jitterOffsetY = m_jitterOffset.y * 2.0f / static_cast<float>(m_viewportHeight);
-            // DirectXMath使用行主序，投影矩阵的[2,0]和[2,1]元素控制NDC的x和y偏移
-            projMatrix.r[2].m128_f32[0] += jitterOffsetX;
-            projMatrix.r[2].m128_f32[1] += jitterOffsetY;
-        }
-
-        DirectX::XMFLOAT3 cameraPos = m_camera.GetPosition();
-
-        // 归一化光照方向
-        DirectX::XMVECTOR lightDirVec = DirectX::XMLoadFloat3(&m_lightDirection);
-        lightDirVec = DirectX::XMVector3Normalize(lightDirVec);
-        DirectX::XMFLOAT3 normalizedLightDir;
-        DirectX::XMStoreFloat3(&normalizedLightDir, lightDirVec);
-
-        // 计算逆矩阵
-        DirectX::XMVECTOR projDeterminant, viewDeterminant;
-        DirectX::XMMATRIX invProjMatrix = DirectX::XMMatrixInverse(&projDeterminant, projMatrix);
-        DirectX::XMMATRIX invViewMatrix = DirectX::XMMatrixInverse(&viewDeterminant, viewMatrix);
-
-        // 计算LightViewProjMatrix（LiSPSM）
-        DirectX::XMMATRIX lightViewProjMatrix = CalculateLiSPSMMatrix(lightDirVec, viewMatrix, projMatrix);
-
-        // TAA: 计算当前帧的ViewProjectionMatrix（不带Jitter，用于Motion Vector）
-        DirectX::XMMATRIX currentViewProjMatrix = m_camera.GetViewMatrix() * m_camera.GetProjectionMatrix();
-
-        // 获取相机的近远平面
-        float nearPlane = m_camera.GetNearPlane();
-        float farPlane = m_camera.GetFarPlane();
-
-        for (Actor* actor : m_actors) {
-            if (!actor) continue;
-
-            StaticMeshComponent* mesh = actor->GetMesh();
-            if (!mesh) continue;
-
-            // 调试输出：显示当前Actor的Transform
-            DirectX::XMFLOAT3 pos = actor->GetPosition();
-            char debugMsg[256];
-            sprintf_s(debugMsg, "Rendering Actor '%s' at position (%.2f, %.2f, %.2f)\n",
-                     actor->GetName().c_str(), pos.x, pos.y, pos.z);
-            OutputDebugStringA(debugMsg);
-
-            // CRITICAL: 获取Actor的Material并设置对应的PSO
-            // 每个Actor可能使用不同的Material（不同的Shader），因此需要切换PSO
-            MaterialInstance* material = actor->GetMaterial();
-            if (material && material->GetShader()) {
-                Shader* shader = material->GetShader();
-
-                // 获取该Shader的Pass 0的PSO（GBuffer Pass）
-                ID3D12PipelineState* actorPSO = shader->GetPSO(0);
-                if (actorPSO) {
-                    commandList->SetPipelineState(actorPSO);
-                } else {
-                    // 如果Actor的Shader没有编译PSO，使用传入的默认PSO
-                    commandList->SetPipelineState(pso);
-                }
+        m_drawStateCache.Reset();
+        for (const DrawBatch& batch : m_drawBatches) {
+            const DrawPacket& packet = m_drawList.GetPacket(batch.firstPacket);
+            StaticMeshComponent* mesh = const_cast<StaticMeshComponent*>(static_cast<const StaticMeshComponent*>(packet.mesh));
+            MaterialInstance* material = const_cast<MaterialInstance*>(static_cast<const MaterialInstance*>(packet.material));
+
+            // 每个Material可能使用不同的Shader，Shader没有编译PSO时使用传入的默认PSO
+            ID3D12PipelineState* batchPSO = packet.pipelineState
+                ? static_cast<ID3D12PipelineState*>(const_cast<void*>(packet.pipelineState)) : pso;
+            if (!batchPSO) continue;
+            if (m_drawStateCache.SetPipelineState(batchPSO)) {
+                commandList->SetPipelineState(batchPSO);
+            }
 
-                // 绑定Material的常量缓冲区（b1，材质参数）
+            // 绑定Material的常量缓冲区（b1，材质参数）
+            // Bindless纹理系统：纹理索引已经通过MaterialInstance的CB传递给Shader
+            // 注意：全局SRV堆（TextureManager的堆）需要在渲染开始前设置
+            if (material && m_drawStateCache.SetMaterial(material)) {
                 // 首先检查是否有待加载的纹理
                 if (material->HasPendingTextures()) {
                     material->LoadTexturesFromPaths(commandList);
                 }
                 material->Bind(commandList, rootSignature, 2);
+            }
+
+            if (m_drawStateCache.SetObjectConstants(sceneCBAddress)) {
+                commandList->SetGraphicsRootConstantBufferView(0, sceneCBAddress);
+            }
 
-                // Bindless纹理系统：不再需要每帧重新绑定纹理到固定槽位
-                // 纹理索引已经通过MaterialInstance的CB传递给Shader
-                // Shader使用动态索引从全局纹理数组中采样
-                // 注意：全局SRV堆（TextureManager的堆）需要在渲染开始前设置
-            } else {
-                // 如果Actor没有Material，使用传入的默认PSO
-                commandList->SetPipelineState(pso);
+            if (m_drawStateCache.SetVertexBuffer(mesh)) {
+                commandList->IASetVertexBuffers(0, 1, &mesh->mVBOView);
             }
 
-            // SOLUTION B: 更新Actor独立的CB并绑定（包含TAA参数）
-            actor->UpdateConstantBuffer(viewMatrix, projMatrix,
-                                       normalizedLightDir, cameraPos,
-                                       m_skylightIntensity, m_skylightColor,
-                                       invProjMatrix, invViewMatrix,
-                                       lightViewProjMatrix,
-                                       m_previousViewProjectionMatrix,
-                                       m_jitterOffset, m_previousJitterOffset,
-                                       m_viewportWidth, m_viewportHeight,
-                                       nearPlane, farPlane,
-                                       currentViewProjMatrix, m_shadowMode, m_giType);
-
-            // 调试：输出CB的GPU地址，确认每个Actor使用不同的CB
-            char cbMsg[256];
-            sprintf_s(cbMsg, "  Actor CB GPU Address: 0x%llX\n",
-                     actor->GetConstantBuffer()->GetGPUVirtualAddress());
-            OutputDebugStringA(cbMsg);
-
-            // 绑定Actor的CB（b0）
-            commandList->SetGraphicsRootConstantBufferView(0, actor->GetConstantBuffer()->GetGPUVirtualAddress());
-
-            // 渲染当前Actor的Mesh（一个DrawCall）
-            mesh->Render(commandList, rootSignature);
+            // 本批次的实例数据（VS中SV_InstanceID从0开始，直接偏移根SRV地址）
+            commandList->SetGraphicsRootShaderResourceView(3, GetInstanceDataAddress(batch.firstInstance));
+            mesh->DrawSubMeshes(commandList, batch.packetCount);
+            m_drawStateCache.CountDraw((int)batch.packetCount);
         }
-    } else {
-        // 旧的单Mesh渲染方式（向后兼容）
+
+        m_drawStats = m_drawStateCache.GetStats();
+        m_drawStats.sortTimeMs = m_drawListBuildTimeMs;
+    } else if (pso) {
+        // 旧的单Mesh渲染方式（向后兼容），实例缓冲中是一个单位矩阵
+        m_drawStats = DrawSubmitStats();
         commandList->SetPipelineState(pso);
+        commandList->SetGraphicsRootConstantBufferView(0, sceneCBAddress);
+        commandList->SetGraphicsRootShaderResourceView(3, GetInstanceDataAddress(0));
         m_staticMesh.Render(commandList, rootSignature);
     }
 
@@ -974,10 +1060,41 @@ DirectX::XMMATRIX Scene::CalculateStandardShadowMatrix(const DirectX::XMVECTOR&
 
 Actor* Scene::CreateActor(const std::string& name) {
     Actor* actor = new Actor(name);
-    m_actors.push_back(actor);
+    AddActor(actor);
     return actor;
 }
 
+void Scene::AddActor(Actor* actor) {
+    if (!actor) return;
+    m_actors.push_back(actor);
+    m_spatialIndex.Insert(actor);
+}
+
+Actor* Scene::PickActor(float ndcX, float ndcY) {
+    using namespace DirectX;
+
+    // 反投影近/远平面上的点得到世界空间射线
+    XMMATRIX viewProj = m_camera.GetViewMatrix() * m_camera.GetProjectionMatrix();
+    XMMATRIX invViewProj = XMMatrixInverse(nullptr, viewProj);
+    XMVECTOR nearPoint = XMVector3TransformCoord(XMVectorSet(ndcX, ndcY, 0.0f, 1.0f), invViewProj);
+    XMVECTOR farPoint = XMVector3TransformCoord(XMVectorSet(ndcX, ndcY, 1.0f, 1.0f), invViewProj);
+    XMVECTOR ray = XMVectorSubtract(farPoint, nearPoint);
+    float rayLength = XMVectorGetX(XMVector3Length(ray));
+    if (rayLength <= 0.0f) return nullptr;
+
+    XMFLOAT3 origin, direction;
+    XMStoreFloat3(&origin, nearPoint);
+    XMStoreFloat3(&direction, XMVectorScale(ray, 1.0f / rayLength));
+
+    m_spatialIndex.Flush();
+    return m_spatialIndex.RayCast(origin, direction, rayLength);
+}
+
+void Scene::QueryActorsInAABB(const SpatialAABB& aabb, std::vector<Actor*>& outActors) {
+    m_spatialIndex.Flush();
+    m_spatialIndex.QueryAABB(aabb, outActors);
+}
+
 bool Scene::LoadActorFromMeshFile(const std::wstring& meshFilePath, ID3D12GraphicsCommandList* commandList) {
     OutputDebugStringA("Scene::LoadActorFromMeshFile - Start\n");
     char msg[512];
@@ -986,7 +1103,6 @@ bool Scene::LoadActorFromMeshFile(const std::wstring& meshFilePath, ID3D12Graphi
 
     // 创建Actor
     Actor* actor = new Actor("Sphere");
-    actor->CreateConstantBuffer(gD3D12Device);  // Create independent CB
 
     // 加载.mesh文件
     if (!actor->LoadFromMeshFile(meshFilePath)) {
@@ -995,32 +1111,12 @@ bool Scene::LoadActorFromMeshFile(const std::wstring& meshFilePath, ID3D12Graphi
         return false;
     }
 
-    // 从.mesh文件信息中加载FBX
+    // 从共享网格缓存获取（相同几何源只加载一次，.meshbin优先）
     const MeshAssetInfo& meshInfo = actor->GetMeshAssetInfo();
-
-    // 将相对路径转换为绝对路径
-    std::wstring fbxPath = GetEnginePath();
-    std::string fbxPathStr = meshInfo.fbxPath;
-    fbxPath += std::wstring(fbxPathStr.begin(), fbxPathStr.end());
-
-    sprintf_s(msg, "  FBX path: %S\n", fbxPath.c_str());
-    OutputDebugStringA(msg);
-
-    // 将wstring转换为string (FBX加载需要char*)
-    std::string fbxPathAnsi(fbxPath.begin(), fbxPath.end());
-
-    sprintf_s(msg, "  FBX path (ANSI): %s\n", fbxPathAnsi.c_str());
-    OutputDebugStringA(msg);
-
-    // 加载FBX文件到StaticMeshComponent
-    StaticMeshComponent* mesh = new StaticMeshComponent();
-
-    OutputDebugStringA("  Calling InitFromFile...\n");
-    mesh->InitFromFile(commandList, fbxPathAnsi.c_str());
-    OutputDebugStringA("  InitFromFile completed\n");
+    StaticMeshComponent* mesh = MeshManager::GetInstance().Acquire(meshInfo, commandList);
 
     actor->SetMesh(mesh);
-    m_actors.push_back(actor);
+    AddActor(actor);
 
     OutputDebugStringA("Scene::LoadActorFromMeshFile - Success\n");
     return true;
@@ -1029,6 +1125,9 @@ bool Scene::LoadActorFromMeshFile(const std::wstring& meshFilePath, ID3D12Graphi
 void Scene::RemoveActor(Actor* actor) {
     auto it = std::find(m_actors.begin(), m_actors.end(), actor);
     if (it != m_actors.end()) {
+        // 剔除结果在下一次Update前仍可能被使用，先移除引用
+        m_visibleActors.erase(std::remove(m_visibleActors.begin(), m_visibleActors.end(), actor), m_visibleActors.end());
+        m_shadowCasterActors.erase(std::remove(m_shadowCasterActors.begin(), m_shadowCasterActors.end(), actor), m_shadowCasterActors.end());
         delete *it;
         m_actors.erase(it);
     }
@@ -1081,12 +1180,7 @@ static bool FinalizeAndAddActor(Actor* actor, const std::string& actorName,
     }
 
     const MeshAssetInfo& meshInfo = actor->GetMeshAssetInfo();
-    std::wstring fbxPath = GetEnginePath();
-    fbxPath += std::wstring(meshInfo.fbxPath.begin(), meshInfo.fbxPath.end());
-    std::string fbxPathAnsi(fbxPath.begin(), fbxPath.end());
-
-    StaticMeshComponent* mesh = new StaticMeshComponent();
-    mesh->InitFromFile(commandList, fbxPathAnsi.c_str());
+    StaticMeshComponent* mesh = MeshManager::GetInstance().Acquire(meshInfo, commandList);
     actor->SetMesh(mesh);
 
     if (!materialName.empty()) {
@@ -1119,6 +1213,9 @@ bool Scene::LoadLevel(const std::wstring& levelFilePath, ID3D12GraphicsCommandLi
     }
 
     // Clear existing actors
+    m_visibleActors.clear();
+    m_shadowCasterActors.clear();
+    m_spatialIndex.Clear();
     for (Actor* actor : m_actors) {
         delete actor;
     }
@@ -1173,7 +1270,6 @@ bool Scene::LoadLevel(const std::wstring& levelFilePath, ID3D12GraphicsCommandLi
             if (key == "Name") {
                 actorName = value;
                 currentActor = new Actor(actorName);
-                currentActor->CreateConstantBuffer(gD3D12Device);
             } else if (key == "MeshAsset") {
                 meshAssetPath = value;
             } else if (key == "Material") {
@@ -1196,7 +1292,15 @@ bool Scene::LoadLevel(const std::wstring& levelFilePath, ID3D12GraphicsCommandLi
 
     file.close();
 
-    sprintf_s(msg, "Scene::LoadLevel - Loaded %d actors\n", (int)m_actors.size());
+    // 批量加入空间索引后整体重建，比逐个插入得到的树更平衡
+    for (Actor* actor : m_actors) {
+        m_spatialIndex.Insert(actor);
+    }
+    m_spatialIndex.Rebuild();
+
+    sprintf_s(msg, "Scene::LoadLevel - Loaded %d actors, %d unique meshes (%.2f MB GPU)\n", (int)m_actors.size(),
+        MeshManager::GetInstance().GetUniqueMeshCount(),
+        MeshManager::GetInstance().GetGPUMemoryUsage() / (1024.0 * 1024.0));
     OutputDebugStringA(msg);
 
     return true;
@@ -128,8 +128,8 @@ void ScreenPass::Render(ID3D12GraphicsCommandList* cmdList,
     cmdList->SetGraphicsRootSignature(rootSig);
     cmdList->SetPipelineState(pso);
 
-    if (m_sceneConstantBuffer) {
-        cmdList->SetGraphicsRootConstantBufferView(0, m_sceneConstantBuffer->GetGPUVirtualAddress());
+    if (m_sceneCBAddress) {
+        cmdList->SetGraphicsRootConstantBufferView(0, m_sceneCBAddress);
     }
 
     ID3D12DescriptorHeap* heaps[] = { m_srvHeap.Get() };
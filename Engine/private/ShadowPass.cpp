@@ -4,6 +4,7 @@
 #include "public/Scene.h"
 #include "public/Actor.h"
 #include "public/StaticMeshComponent.h"
+#include "public/PipelineStateCache.h"
 #include <d3dx12.h>
 #include <stdexcept>
 
@@ -156,6 +157,7 @@ ID3D12PipelineState* ShadowPass::CreateShadowPSO(ID3D12RootSignature* rootSignat
     // 光栅化状态 - 关键：设置深度偏移防止Shadow Acne
     psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
     psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+    psoDesc.RasterizerState.DepthClipEnable = FALSE;  // 光源近平面之前的投射者深度钳制到0，不被裁掉（剔除时也不测近平面）
     psoDesc.RasterizerState.FrontCounterClockwise = FALSE;
     // 深度偏移参数（防止Shadow Acne）
     psoDesc.RasterizerState.DepthBias = 100000;           // 固定偏移量
@@ -181,7 +183,7 @@ ID3D12PipelineState* ShadowPass::CreateShadowPSO(ID3D12RootSignature* rootSignat
     psoDesc.SampleDesc.Count = 1;
 
     ID3D12PipelineState* pso = nullptr;
-    HRESULT hr = gD3D12Device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pso));
+    HRESULT hr = PipelineStateCache::GetInstance().CreateGraphicsPipelineState(gD3D12Device, psoDesc, &pso);
     if (FAILED(hr)) {
         OutputDebugStringA("ShadowPass::CreateShadowPSO - Failed to create PSO\n");
         return nullptr;
@@ -228,29 +230,23 @@ void ShadowPass::Render(ID3D12GraphicsCommandList* commandList,
     commandList->SetPipelineState(pso);
 
     // 5. 绑定场景常量缓冲区（包含LightViewProjectionMatrix）
-    if (m_sceneConstantBuffer) {
-        commandList->SetGraphicsRootConstantBufferView(0, m_sceneConstantBuffer->GetGPUVirtualAddress());
+    if (m_sceneCBAddress) {
+        commandList->SetGraphicsRootConstantBufferView(0, m_sceneCBAddress);
     }
 
     // 6. 设置图元拓扑
     commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    // 7. 渲染所有Actor
-    std::vector<Actor*>& actors = scene->GetActors();
-    for (Actor* actor : actors) {
-        if (!actor) continue;
+    // 7. 渲染阴影正交视锥内的Actor（Scene::Update中已剔除）
+    // 同一Mesh的投影者合并为一次实例化绘制，实例数据由Scene写入实例缓冲（Slot 3）
+    const DrawList& shadowDrawList = scene->GetShadowDrawList();
+    for (const DrawBatch& batch : scene->GetShadowBatches()) {
+        const DrawPacket& packet = shadowDrawList.GetPacket(batch.firstPacket);
+        StaticMeshComponent* mesh = const_cast<StaticMeshComponent*>(static_cast<const StaticMeshComponent*>(packet.mesh));
 
-        StaticMeshComponent* mesh = actor->GetMesh();
-        if (!mesh) continue;
-
-        // 绑定Actor的常量缓冲区（包含ModelMatrix）
-        ID3D12Resource* actorCB = actor->GetConstantBuffer();
-        if (actorCB) {
-            commandList->SetGraphicsRootConstantBufferView(0, actorCB->GetGPUVirtualAddress());
-        }
-
-        // 渲染mesh
-        mesh->Render(commandList, rootSignature);
+        commandList->SetGraphicsRootShaderResourceView(3, scene->GetInstanceDataAddress(batch.firstInstance));
+        commandList->IASetVertexBuffers(0, 1, &mesh->mVBOView);
+        mesh->DrawSubMeshes(commandList, batch.packetCount);
     }
 
     // 8. 转换Shadow Map状态为着色器资源（供后续Pass采样）
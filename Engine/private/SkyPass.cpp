@@ -1,5 +1,6 @@
 // SkyPass.cpp
 #include "public/SkyPass.h"
+#include "public/PipelineStateCache.h"
 #include <d3dx12.h>
 #include <DirectXMath.h>
 #include <stdexcept>
@@ -169,8 +170,8 @@ void SkyPass::Render(ID3D12GraphicsCommandList* cmdList,
     cmdList->SetPipelineState(pso);
 
     // 绑定场景常量缓冲区（根参数0，包含矩阵和相机位置）
-    if (m_sceneConstantBuffer) {
-        cmdList->SetGraphicsRootConstantBufferView(0, m_sceneConstantBuffer->GetGPUVirtualAddress());
+    if (m_sceneCBAddress) {
+        cmdList->SetGraphicsRootConstantBufferView(0, m_sceneCBAddress);
     }
 
     // 绑定SRV堆
@@ -221,7 +222,7 @@ ID3D12PipelineState* SkyPass::CreatePSO(ID3D12RootSignature* rootSig,
     psoDesc.SampleDesc.Count = 1;
 
     ID3D12PipelineState* pso = nullptr;
-    HRESULT hr = gD3D12Device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pso));
+    HRESULT hr = PipelineStateCache::GetInstance().CreateGraphicsPipelineState(gD3D12Device, psoDesc, &pso);
     if (FAILED(hr)) {
         return nullptr;
     }
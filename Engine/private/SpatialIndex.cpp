@@ -0,0 +1,726 @@
+// SpatialIndex.cpp
+// 场景空间索引实现
+
+#define NOMINMAX
+
+#include "public/SpatialIndex.h"
+#include "public/Actor.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace DirectX;
+
+// ========== DynamicAABBTree ==========
+
+DynamicAABBTree::DynamicAABBTree() {
+    m_nodes.reserve(16);
+}
+
+int DynamicAABBTree::AllocateNode() {
+    if (m_freeList == NullNode) {
+        m_nodes.emplace_back();
+        int nodeId = (int)m_nodes.size() - 1;
+        m_nodes[nodeId].height = 0;
+        return nodeId;
+    }
+
+    int nodeId = m_freeList;
+    m_freeList = m_nodes[nodeId].parent;
+    TreeNode& node = m_nodes[nodeId];
+    node.parent = NullNode;
+    node.child1 = NullNode;
+    node.child2 = NullNode;
+    node.height = 0;
+    node.userData = nullptr;
+    return nodeId;
+}
+
+void DynamicAABBTree::FreeNode(int nodeId) {
+    m_nodes[nodeId].parent = m_freeList;
+    m_nodes[nodeId].height = -1;
+    m_nodes[nodeId].userData = nullptr;
+    m_freeList = nodeId;
+}
+
+int DynamicAABBTree::CreateProxy(const SpatialAABB& aabb, void* userData) {
+    int proxyId = AllocateNode();
+
+    TreeNode& node = m_nodes[proxyId];
+    for (int i = 0; i < 3; ++i) {
+        node.aabb.min[i] = aabb.min[i] - m_margin;
+        node.aabb.max[i] = aabb.max[i] + m_margin;
+    }
+    node.userData = userData;
+    node.height = 0;
+
+    InsertLeaf(proxyId);
+    m_proxyCount++;
+    return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(int proxyId) {
+    RemoveLeaf(proxyId);
+    FreeNode(proxyId);
+    m_proxyCount--;
+}
+
+bool DynamicAABBTree::MoveProxy(int proxyId, const SpatialAABB& aabb) {
+    const SpatialAABB& fat = m_nodes[proxyId].aabb;
+    if (fat.Contains(aabb)) {
+        // 物体缩小后胖包围盒可能过大，超过4倍外扩量时也重新插入
+        SpatialAABB huge;
+        for (int i = 0; i < 3; ++i) {
+            huge.min[i] = aabb.min[i] - 4.0f * m_margin;
+            huge.max[i] = aabb.max[i] + 4.0f * m_margin;
+        }
+        if (huge.Contains(fat)) {
+            return false;
+        }
+    }
+
+    RemoveLeaf(proxyId);
+    for (int i = 0; i < 3; ++i) {
+        m_nodes[proxyId].aabb.min[i] = aabb.min[i] - m_margin;
+        m_nodes[proxyId].aabb.max[i] = aabb.max[i] + m_margin;
+    }
+    InsertLeaf(proxyId);
+    return true;
+}
+
+void DynamicAABBTree::Clear() {
+    m_nodes.clear();
+    m_root = NullNode;
+    m_freeList = NullNode;
+    m_proxyCount = 0;
+}
+
+void DynamicAABBTree::Rebuild() {
+    if (m_root == NullNode) return;
+
+    // 收集叶子，释放所有内部节点
+    std::vector<int> leaves;
+    leaves.reserve(m_proxyCount);
+    m_freeList = NullNode;
+    for (int i = (int)m_nodes.size() - 1; i >= 0; --i) {
+        if (m_nodes[i].height < 0) {
+            FreeNode(i);
+        } else if (m_nodes[i].IsLeaf()) {
+            m_nodes[i].parent = NullNode;
+            leaves.push_back(i);
+        } else {
+            FreeNode(i);
+        }
+    }
+
+    m_root = BuildTopDown(leaves.data(), (int)leaves.size());
+    m_nodes[m_root].parent = NullNode;
+}
+
+int DynamicAABBTree::BuildTopDown(int* leaves, int count) {
+    if (count == 1) {
+        return leaves[0];
+    }
+
+    // 按质心包围盒最长轴的中位数划分
+    float centroidMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float centroidMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (int i = 0; i < count; ++i) {
+        const SpatialAABB& aabb = m_nodes[leaves[i]].aabb;
+        for (int k = 0; k < 3; ++k) {
+            float c = aabb.min[k] + aabb.max[k];
+            centroidMin[k] = std::min(centroidMin[k], c);
+            centroidMax[k] = std::max(centroidMax[k], c);
+        }
+    }
+    int axis = 0;
+    for (int k = 1; k < 3; ++k) {
+        if (centroidMax[k] - centroidMin[k] > centroidMax[axis] - centroidMin[axis]) axis = k;
+    }
+
+    int mid = count / 2;
+    std::nth_element(leaves, leaves + mid, leaves + count, [&](int a, int b) {
+        return m_nodes[a].aabb.min[axis] + m_nodes[a].aabb.max[axis] <
+               m_nodes[b].aabb.min[axis] + m_nodes[b].aabb.max[axis];
+    });
+
+    int child1 = BuildTopDown(leaves, mid);
+    int child2 = BuildTopDown(leaves + mid, count - mid);
+
+    int parent = AllocateNode();
+    TreeNode& node = m_nodes[parent];
+    node.child1 = child1;
+    node.child2 = child2;
+    node.aabb = SpatialAABB::Union(m_nodes[child1].aabb, m_nodes[child2].aabb);
+    node.height = 1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+    m_nodes[child1].parent = parent;
+    m_nodes[child2].parent = parent;
+    return parent;
+}
+
+void DynamicAABBTree::InsertLeaf(int leaf) {
+    if (m_root == NullNode) {
+        m_root = leaf;
+        m_nodes[leaf].parent = NullNode;
+        return;
+    }
+
+    // 沿SAH代价最小的方向下降，找到最佳兄弟节点
+    SpatialAABB leafAABB = m_nodes[leaf].aabb;
+    int index = m_root;
+    while (!m_nodes[index].IsLeaf()) {
+        const TreeNode& node = m_nodes[index];
+        int child1 = node.child1;
+        int child2 = node.child2;
+
+        float area = node.aabb.SurfaceArea();
+        float combinedArea = SpatialAABB::Union(node.aabb, leafAABB).SurfaceArea();
+
+        // 在此处新建父节点的代价
+        float cost = 2.0f * combinedArea;
+        // 继续下降时祖先包围盒增大的代价
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int child) {
+            const TreeNode& c = m_nodes[child];
+            float unionArea = SpatialAABB::Union(leafAABB, c.aabb).SurfaceArea();
+            if (c.IsLeaf()) {
+                return unionArea + inheritanceCost;
+            }
+            return (unionArea - c.aabb.SurfaceArea()) + inheritanceCost;
+        };
+        float cost1 = descendCost(child1);
+        float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    int sibling = index;
+
+    // 新建父节点（AllocateNode可能扩容m_nodes，之后再取引用）
+    int oldParent = m_nodes[sibling].parent;
+    int newParent = AllocateNode();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].userData = nullptr;
+    m_nodes[newParent].aabb = SpatialAABB::Union(leafAABB, m_nodes[sibling].aabb);
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+    m_nodes[newParent].child1 = sibling;
+    m_nodes[newParent].child2 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    if (oldParent != NullNode) {
+        if (m_nodes[oldParent].child1 == sibling) {
+            m_nodes[oldParent].child1 = newParent;
+        } else {
+            m_nodes[oldParent].child2 = newParent;
+        }
+    } else {
+        m_root = newParent;
+    }
+
+    RefitAncestors(m_nodes[leaf].parent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int leaf) {
+    if (leaf == m_root) {
+        m_root = NullNode;
+        return;
+    }
+
+    int parent = m_nodes[leaf].parent;
+    int grandParent = m_nodes[parent].parent;
+    int sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    if (grandParent != NullNode) {
+        // 用兄弟节点替换父节点
+        if (m_nodes[grandParent].child1 == parent) {
+            m_nodes[grandParent].child1 = sibling;
+        } else {
+            m_nodes[grandParent].child2 = sibling;
+        }
+        m_nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        RefitAncestors(grandParent);
+    } else {
+        m_root = sibling;
+        m_nodes[sibling].parent = NullNode;
+        FreeNode(parent);
+    }
+    m_nodes[leaf].parent = NullNode;
+}
+
+void DynamicAABBTree::RefitAncestors(int nodeId) {
+    int index = nodeId;
+    while (index != NullNode) {
+        index = Balance(index);
+
+        TreeNode& node = m_nodes[index];
+        const TreeNode& child1 = m_nodes[node.child1];
+        const TreeNode& child2 = m_nodes[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.aabb = SpatialAABB::Union(child1.aabb, child2.aabb);
+
+        index = node.parent;
+    }
+}
+
+// 若A的左右子树高度差超过1，做一次旋转，返回旋转后该位置的节点
+int DynamicAABBTree::Balance(int iA) {
+    TreeNode* A = &m_nodes[iA];
+    if (A->IsLeaf() || A->height < 2) {
+        return iA;
+    }
+
+    int iB = A->child1;
+    int iC = A->child2;
+    TreeNode* B = &m_nodes[iB];
+    TreeNode* C = &m_nodes[iC];
+
+    int balance = C->height - B->height;
+
+    // C上提
+    if (balance > 1) {
+        int iF = C->child1;
+        int iG = C->child2;
+        TreeNode* F = &m_nodes[iF];
+        TreeNode* G = &m_nodes[iG];
+
+        C->child1 = iA;
+        C->parent = A->parent;
+        A->parent = iC;
+
+        if (C->parent != NullNode) {
+            if (m_nodes[C->parent].child1 == iA) {
+                m_nodes[C->parent].child1 = iC;
+            } else {
+                m_nodes[C->parent].child2 = iC;
+            }
+        } else {
+            m_root = iC;
+        }
+
+        if (F->height > G->height) {
+            C->child2 = iF;
+            A->child2 = iG;
+            G->parent = iA;
+            A->aabb = SpatialAABB::Union(B->aabb, G->aabb);
+            C->aabb = SpatialAABB::Union(A->aabb, F->aabb);
+            A->height = 1 + std::max(B->height, G->height);
+            C->height = 1 + std::max(A->height, F->height);
+        } else {
+            C->child2 = iG;
+            A->child2 = iF;
+            F->parent = iA;
+            A->aabb = SpatialAABB::Union(B->aabb, F->aabb);
+            C->aabb = SpatialAABB::Union(A->aabb, G->aabb);
+            A->height = 1 + std::max(B->height, F->height);
+            C->height = 1 + std::max(A->height, G->height);
+        }
+        return iC;
+    }
+
+    // B上提
+    if (balance < -1) {
+        int iD = B->child1;
+        int iE = B->child2;
+        TreeNode* D = &m_nodes[iD];
+        TreeNode* E = &m_nodes[iE];
+
+        B->child1 = iA;
+        B->parent = A->parent;
+        A->parent = iB;
+
+        if (B->parent != NullNode) {
+            if (m_nodes[B->parent].child1 == iA) {
+                m_nodes[B->parent].child1 = iB;
+            } else {
+                m_nodes[B->parent].child2 = iB;
+            }
+        } else {
+            m_root = iB;
+        }
+
+        if (D->height > E->height) {
+            B->child2 = iD;
+            A->child1 = iE;
+            E->parent = iA;
+            A->aabb = SpatialAABB::Union(C->aabb, E->aabb);
+            B->aabb = SpatialAABB::Union(A->aabb, D->aabb);
+            A->height = 1 + std::max(C->height, E->height);
+            B->height = 1 + std::max(A->height, D->height);
+        } else {
+            B->child2 = iE;
+            A->child1 = iD;
+            D->parent = iA;
+            A->aabb = SpatialAABB::Union(C->aabb, D->aabb);
+            B->aabb = SpatialAABB::Union(A->aabb, E->aabb);
+            A->height = 1 + std::max(C->height, D->height);
+            B->height = 1 + std::max(A->height, E->height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+// ========== ActorSpatialIndex ==========
+
+namespace {
+
+bool FrustumContainsAABB(const Frustum& frustum, const SpatialAABB& aabb) {
+    // 运算顺序与FrustumCuller::CullSoA一致，保证边界上的结果相同
+    float cx = (aabb.min[0] + aabb.max[0]) * 0.5f, ex = (aabb.max[0] - aabb.min[0]) * 0.5f;
+    float cy = (aabb.min[1] + aabb.max[1]) * 0.5f, ey = (aabb.max[1] - aabb.min[1]) * 0.5f;
+    float cz = (aabb.min[2] + aabb.max[2]) * 0.5f, ez = (aabb.max[2] - aabb.min[2]) * 0.5f;
+    for (const XMFLOAT4& plane : frustum.planes) {
+        float d = (cx * plane.x + cy * plane.y) + (cz * plane.z + plane.w);
+        float r = (ex * fabsf(plane.x) + ey * fabsf(plane.y)) + ez * fabsf(plane.z);
+        if (d + r < 0.0f) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+SpatialAABB ActorSpatialIndex::ToAABB(const MeshBounds& bounds) {
+    SpatialAABB aabb;
+    for (int i = 0; i < 3; ++i) {
+        aabb.min[i] = bounds.min[i];
+        aabb.max[i] = bounds.max[i];
+    }
+    return aabb;
+}
+
+void ActorSpatialIndex::Insert(Actor* actor) {
+    if (!actor || actor->m_spatialIndex) return;
+
+    actor->m_spatialIndex = this;
+    const SpatialAABB bounds = ToAABB(actor->GetWorldBounds());
+    actor->m_spatialProxy = m_tree.CreateProxy(bounds, actor);
+    actor->m_spatialDirty = false;
+    SetBounds(actor->m_spatialProxy, bounds);
+}
+
+void ActorSpatialIndex::SetBounds(int proxyId, const SpatialAABB& bounds) {
+    if (proxyId >= (int)m_bounds.size()) {
+        m_bounds.resize(m_tree.GetNodeCapacity());
+    }
+    m_bounds[proxyId] = bounds;
+}
+
+void ActorSpatialIndex::Remove(Actor* actor) {
+    if (!actor || actor->m_spatialIndex != this) return;
+
+    if (actor->m_spatialDirty) {
+        m_dirtyActors.erase(std::remove(m_dirtyActors.begin(), m_dirtyActors.end(), actor), m_dirtyActors.end());
+    }
+    m_tree.DestroyProxy(actor->m_spatialProxy);
+    actor->m_spatialIndex = nullptr;
+    actor->m_spatialProxy = -1;
+    actor->m_spatialDirty = false;
+}
+
+void ActorSpatialIndex::MarkDirty(Actor* actor) {
+    if (!actor || actor->m_spatialIndex != this || actor->m_spatialDirty) return;
+
+    actor->m_spatialDirty = true;
+    m_dirtyActors.push_back(actor);
+}
+
+int ActorSpatialIndex::Flush() {
+    int moved = 0;
+    for (Actor* actor : m_dirtyActors) {
+        actor->m_spatialDirty = false;
+        const SpatialAABB bounds = ToAABB(actor->GetWorldBounds());
+        SetBounds(actor->m_spatialProxy, bounds);
+        if (m_tree.MoveProxy(actor->m_spatialProxy, bounds)) {
+            moved++;
+        }
+    }
+    m_dirtyActors.clear();
+    return moved;
+}
+
+void ActorSpatialIndex::Rebuild() {
+    Flush();
+    m_tree.Rebuild();
+}
+
+void ActorSpatialIndex::Clear() {
+    // 断开Actor到索引的引用（Actor可能比索引活得久），只有叶子节点的userData非空
+    for (int i = 0; i < m_tree.GetNodeCapacity(); ++i) {
+        Actor* actor = static_cast<Actor*>(m_tree.GetUserData(i));
+        if (actor) {
+            actor->m_spatialIndex = nullptr;
+            actor->m_spatialProxy = -1;
+            actor->m_spatialDirty = false;
+        }
+    }
+    m_dirtyActors.clear();
+    m_bounds.clear();
+    m_tree.Clear();
+}
+
+void ActorSpatialIndex::QueryFrustum(const Frustum& frustum, std::vector<Actor*>& outActors) const {
+    // 胖包围盒命中后再用紧包围盒精确测试，结果与FrustumCuller一致
+    m_tree.QueryFrustum(frustum, [&](int proxyId) {
+        Actor* actor = static_cast<Actor*>(m_tree.GetUserData(proxyId));
+        if (actor->GetMesh() && FrustumContainsAABB(frustum, m_bounds[proxyId])) {
+            outActors.push_back(actor);
+        }
+    });
+}
+
+void ActorSpatialIndex::QueryAABB(const SpatialAABB& aabb, std::vector<Actor*>& outActors) const {
+    m_tree.QueryAABB(aabb, [&](int proxyId) {
+        Actor* actor = static_cast<Actor*>(m_tree.GetUserData(proxyId));
+        if (m_bounds[proxyId].Overlaps(aabb)) {
+            outActors.push_back(actor);
+        }
+    });
+}
+
+Actor* ActorSpatialIndex::RayCast(const XMFLOAT3& origin, const XMFLOAT3& direction,
+                                  float maxDistance, float* outDistance) const {
+    float o[3] = { origin.x, origin.y, origin.z };
+    float d[3] = { direction.x, direction.y, direction.z };
+    float invDir[3];
+    for (int i = 0; i < 3; ++i) {
+        invDir[i] = d[i] != 0.0f ? 1.0f / d[i] : 1e30f;
+    }
+
+    Actor* closest = nullptr;
+    float closestDistance = maxDistance;
+    m_tree.RayCast(o, d, maxDistance, [&](int proxyId, float currentMax) {
+        Actor* actor = static_cast<Actor*>(m_tree.GetUserData(proxyId));
+        if (!actor->GetMesh()) return currentMax;
+
+        // 胖包围盒命中后再用紧包围盒精确求交
+        float tHit;
+        if (m_bounds[proxyId].RayIntersect(o, invDir, currentMax, tHit) && tHit < closestDistance) {
+            closest = actor;
+            closestDistance = tHit;
+            return tHit;
+        }
+        return currentMax;
+    });
+
+    if (closest && outDistance) {
+        *outDistance = closestDistance;
+    }
+    return closest;
+}
+
+// ========== 对比测试 ==========
+
+namespace {
+
+using BenchClock = std::chrono::high_resolution_clock;
+
+double ElapsedMs(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+} // namespace
+
+void RunSpatialIndexBenchmark(int actorCount, SpatialBenchmarkResult& outResult) {
+    outResult = SpatialBenchmarkResult();
+    outResult.actorCount = actorCount;
+
+    // 关卡式分布：包围盒散布在XZ平面上，密度与数量无关
+    std::mt19937 rng(12345);
+    float worldHalfSize = 5.0f * sqrtf((float)actorCount);
+    std::uniform_real_distribution<float> posXZ(-worldHalfSize, worldHalfSize);
+    std::uniform_real_distribution<float> posY(0.0f, 20.0f);
+    std::uniform_real_distribution<float> size(0.5f, 4.0f);
+
+    std::vector<SpatialAABB> boxes(actorCount);
+    for (SpatialAABB& box : boxes) {
+        float c[3] = { posXZ(rng), posY(rng), posXZ(rng) };
+        for (int i = 0; i < 3; ++i) {
+            float h = size(rng) * 0.5f;
+            box.min[i] = c[i] - h;
+            box.max[i] = c[i] + h;
+        }
+    }
+
+    // 暴力遍历使用与FrustumCuller相同的SoA布局
+    size_t padded = ((size_t)actorCount + 3) & ~(size_t)3;
+    std::vector<float> cx(padded, 0.0f), cy(padded, 0.0f), cz(padded, 0.0f);
+    std::vector<float> ex(padded, 0.0f), ey(padded, 0.0f), ez(padded, 0.0f);
+    auto writeSoA = [&](int i) {
+        cx[i] = (boxes[i].min[0] + boxes[i].max[0]) * 0.5f; ex[i] = (boxes[i].max[0] - boxes[i].min[0]) * 0.5f;
+        cy[i] = (boxes[i].min[1] + boxes[i].max[1]) * 0.5f; ey[i] = (boxes[i].max[1] - boxes[i].min[1]) * 0.5f;
+        cz[i] = (boxes[i].min[2] + boxes[i].max[2]) * 0.5f; ez[i] = (boxes[i].max[2] - boxes[i].min[2]) * 0.5f;
+    };
+    for (int i = 0; i < actorCount; ++i) writeSoA(i);
+
+    // 建树
+    auto start = BenchClock::now();
+    DynamicAABBTree tree;
+    std::vector<int> proxies(actorCount);
+    for (int i = 0; i < actorCount; ++i) {
+        proxies[i] = tree.CreateProxy(boxes[i], reinterpret_cast<void*>((intptr_t)i));
+    }
+    outResult.treeBuildMs = ElapsedMs(start);
+
+    start = BenchClock::now();
+    tree.Rebuild();
+    outResult.treeRebuildMs = ElapsedMs(start);
+
+    // 1%的包围盒小幅移动
+    std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> pick(0, actorCount - 1);
+    int moveCount = std::max(1, actorCount / 100);
+    start = BenchClock::now();
+    for (int m = 0; m < moveCount; ++m) {
+        int i = pick(rng);
+        float offset[3] = { jitter(rng), jitter(rng) * 0.2f, jitter(rng) };
+        for (int k = 0; k < 3; ++k) {
+            boxes[i].min[k] += offset[k];
+            boxes[i].max[k] += offset[k];
+        }
+        tree.MoveProxy(proxies[i], boxes[i]);
+    }
+    outResult.treeUpdateMs = ElapsedMs(start);
+    for (int i = 0; i < actorCount; ++i) writeSoA(i);
+    outResult.treeHeight = tree.GetHeight();
+
+    // 视锥：站在地图中央附近的透视相机
+    const int frustumQueries = 20;
+    std::vector<uint32_t> bruteVisible, treeVisible;
+    double bruteTotal = 0.0, treeTotal = 0.0;
+    for (int q = 0; q < frustumQueries; ++q) {
+        float yaw = XM_2PI * q / frustumQueries;
+        XMVECTOR eye = XMVectorSet(posXZ(rng) * 0.5f, 10.0f, posXZ(rng) * 0.5f, 1.0f);
+        XMVECTOR dir = XMVectorSet(sinf(yaw), -0.2f, cosf(yaw), 0.0f);
+        XMMATRIX view = XMMatrixLookToLH(eye, dir, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        XMMATRIX proj = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 300.0f);
+        Frustum frustum = Frustum::FromViewProjection(view * proj);
+
+        bruteVisible.clear();
+        start = BenchClock::now();
+        FrustumCuller::CullSoA(frustum, cx.data(), cy.data(), cz.data(), ex.data(), ey.data(), ez.data(),
+                               (size_t)actorCount, bruteVisible);
+        bruteTotal += ElapsedMs(start);
+
+        // 树查询输出胖包围盒命中的叶子，再用紧包围盒过滤（与暴力遍历结果可比）
+        treeVisible.clear();
+        start = BenchClock::now();
+        tree.QueryFrustum(frustum, [&](int proxyId) {
+            int i = (int)reinterpret_cast<intptr_t>(tree.GetUserData(proxyId));
+            if (FrustumContainsAABB(frustum, boxes[i])) {
+                treeVisible.push_back((uint32_t)i);
+            }
+        });
+        treeTotal += ElapsedMs(start);
+
+        std::sort(treeVisible.begin(), treeVisible.end());
+        if (treeVisible != bruteVisible) {
+            outResult.resultsMatch = false;
+        }
+        outResult.visibleCount += (int)bruteVisible.size();
+    }
+    outResult.bruteFrustumMs = bruteTotal / frustumQueries;
+    outResult.treeFrustumMs = treeTotal / frustumQueries;
+    outResult.visibleCount /= frustumQueries;
+
+    // 射线拾取：从高处斜向下
+    const int rayQueries = 100;
+    bruteTotal = treeTotal = 0.0;
+    for (int q = 0; q < rayQueries; ++q) {
+        float origin[3] = { posXZ(rng), 50.0f, posXZ(rng) };
+        float dir[3] = { jitter(rng), -1.0f, jitter(rng) };
+        float len = sqrtf(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+        float invDir[3];
+        for (int k = 0; k < 3; ++k) {
+            dir[k] /= len;
+            invDir[k] = 1.0f / dir[k];
+        }
+        const float maxDistance = 1000.0f;
+
+        int bruteHit = -1;
+        float bruteT = maxDistance;
+        start = BenchClock::now();
+        for (int i = 0; i < actorCount; ++i) {
+            float t;
+            if (boxes[i].RayIntersect(origin, invDir, bruteT, t) && t < bruteT) {
+                bruteT = t;
+                bruteHit = i;
+            }
+        }
+        bruteTotal += ElapsedMs(start);
+
+        int treeHit = -1;
+        float treeT = maxDistance;
+        start = BenchClock::now();
+        tree.RayCast(origin, dir, maxDistance, [&](int proxyId, float currentMax) {
+            int i = (int)reinterpret_cast<intptr_t>(tree.GetUserData(proxyId));
+            float t;
+            if (boxes[i].RayIntersect(origin, invDir, currentMax, t) && t < treeT) {
+                treeT = t;
+                treeHit = i;
+                return t;
+            }
+            return currentMax;
+        });
+        treeTotal += ElapsedMs(start);
+
+        if (bruteHit != treeHit && fabsf(bruteT - treeT) > 1e-4f) {
+            outResult.resultsMatch = false;
+        }
+    }
+    outResult.bruteRayMs = bruteTotal / rayQueries;
+    outResult.treeRayMs = treeTotal / rayQueries;
+
+    // 范围查询：编辑器框选/触发器大小的区域
+    const int aabbQueries = 100;
+    std::vector<int> bruteHits, treeHits;
+    bruteTotal = treeTotal = 0.0;
+    for (int q = 0; q < aabbQueries; ++q) {
+        SpatialAABB query;
+        float c[3] = { posXZ(rng), 10.0f, posXZ(rng) };
+        for (int k = 0; k < 3; ++k) {
+            query.min[k] = c[k] - 15.0f;
+            query.max[k] = c[k] + 15.0f;
+        }
+
+        bruteHits.clear();
+        start = BenchClock::now();
+        for (int i = 0; i < actorCount; ++i) {
+            if (boxes[i].Overlaps(query)) bruteHits.push_back(i);
+        }
+        bruteTotal += ElapsedMs(start);
+
+        treeHits.clear();
+        start = BenchClock::now();
+        tree.QueryAABB(query, [&](int proxyId) {
+            int i = (int)reinterpret_cast<intptr_t>(tree.GetUserData(proxyId));
+            if (boxes[i].Overlaps(query)) treeHits.push_back(i);
+        });
+        treeTotal += ElapsedMs(start);
+
+        std::sort(treeHits.begin(), treeHits.end());
+        if (treeHits != bruteHits) {
+            outResult.resultsMatch = false;
+        }
+    }
+    outResult.bruteAABBMs = bruteTotal / aabbQueries;
+    outResult.treeAABBMs = treeTotal / aabbQueries;
+
+    char msg[512];
+    sprintf_s(msg, "[SpatialIndex] %d boxes: build %.2f ms, rebuild %.2f ms, update %.3f ms, height %d | frustum brute %.3f / tree %.3f ms"
+                   " | ray brute %.4f / tree %.4f ms | aabb brute %.4f / tree %.4f ms | %s\n",
+        actorCount, outResult.treeBuildMs, outResult.treeRebuildMs, outResult.treeUpdateMs, outResult.treeHeight,
+        outResult.bruteFrustumMs, outResult.treeFrustumMs, outResult.bruteRayMs, outResult.treeRayMs,
+        outResult.bruteAABBMs, outResult.treeAABBMs, outResult.resultsMatch ? "match" : "MISMATCH");
+    OutputDebugStringA(msg);
+    std::cout << msg;
+}
@@ -1,4 +1,5 @@
 #include "public/SsgiPass.h"
+#include "public/UploadAllocator.h"
 #include <d3dx12.h>
 #include <stdexcept>
 #include <vector>
@@ -21,7 +22,6 @@ bool SsgiPass::Initialize(int viewportWidth, int viewportHeight) {
 
     CreateRenderTargets();
     CreateSRVHeap();
-    CreateConstantBuffer();
     CreateDefaultBlackTexture();
     CreateNoiseTexture();
 
@@ -107,10 +107,13 @@ void SsgiPass::CreateRenderTargets() {
     gD3D12Device->CreateRenderTargetView(m_historyRT2.Get(), nullptr, rtvHandle);
 }
 
+// 每个在途帧独占一段SRV：history每帧交替，覆盖上一帧仍在使用的描述符会读错历史
+static constexpr UINT kSrvsPerFrame = 16;
+
 void SsgiPass::CreateSRVHeap() {
     D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
     srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    srvHeapDesc.NumDescriptors = 32;
+    srvHeapDesc.NumDescriptors = kSrvsPerFrame * kFramesInFlight;
     srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
 
     HRESULT hr = gD3D12Device->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&m_srvHeap));
@@ -119,21 +122,6 @@ void SsgiPass::CreateSRVHeap() {
     }
 }
 
-void SsgiPass::CreateConstantBuffer() {
-    UINT cbSize = (sizeof(SsgiConstants) + 255) & ~255;
-    CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
-    CD3DX12_RESOURCE_DESC bufDesc = CD3DX12_RESOURCE_DESC::Buffer(cbSize);
-
-    HRESULT hr = gD3D12Device->CreateCommittedResource(
-        &heapProps, D3D12_HEAP_FLAG_NONE, &bufDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-        IID_PPV_ARGS(&m_ssgiConstantBuffer));
-
-    if (FAILED(hr)) {
-        throw std::runtime_error("SsgiPass: Failed to create constant buffer");
-    }
-}
-
 void SsgiPass::CreateDefaultBlackTexture() {
     D3D12_RESOURCE_DESC texDesc = {};
     texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
@@ -282,11 +270,8 @@ void SsgiPass::UpdateConstants() {
     constants.depthThickness = 0.02f;
     constants.temporalBlend = (m_frameCounter == 0) ? 0.0f : 0.95f;  // 提高到0.95，配合更大的抖动
 
-    UINT8* pData;
-    CD3DX12_RANGE readRange(0, 0);
-    m_ssgiConstantBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pData));
-    memcpy(pData, &constants, sizeof(SsgiConstants));
-    m_ssgiConstantBuffer->Unmap(0, nullptr);
+    // 每帧从上传环中分配，避免覆盖GPU仍在读取的上一帧常量
+    m_ssgiCBAddress = LinearUploadAllocator::GetInstance().AllocateConstants(&constants, sizeof(SsgiConstants));
 }
 
 void SsgiPass::SetViewportAndScissor(ID3D12GraphicsCommandList* cmdList) {
@@ -404,7 +389,8 @@ void SsgiPass::Render(ID3D12GraphicsCommandList* cmdList,
     // ========== SSGI Raw Pass (低分辨率，带temporal accumulation) ==========
     SetViewportAndScissor(cmdList); // 设置低分辨率viewport
 
-    const UINT kRaymarchSrvStart = 0;
+    const UINT frameSrvBase = GetFrameIndex() * kSrvsPerFrame;
+    const UINT kRaymarchSrvStart = frameSrvBase + 0;
     CreateRaymarchInputSRVs(m_depthMaxPingRT.Get(), baseColorRT, normalRT, depthBuffer, historyRT, velocityRT, kRaymarchSrvStart);
     transition(m_ssgiRawRT.Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
     {
@@ -415,8 +401,8 @@ void SsgiPass::Render(ID3D12GraphicsCommandList* cmdList,
 
         cmdList->SetGraphicsRootSignature(rootSig);
         cmdList->SetPipelineState(ssgiPso);
-        if (m_sceneConstantBuffer) cmdList->SetGraphicsRootConstantBufferView(0, m_sceneConstantBuffer->GetGPUVirtualAddress());
-        cmdList->SetGraphicsRootConstantBufferView(2, m_ssgiConstantBuffer->GetGPUVirtualAddress());
+        if (m_sceneCBAddress) cmdList->SetGraphicsRootConstantBufferView(0, m_sceneCBAddress);
+        cmdList->SetGraphicsRootConstantBufferView(2, m_ssgiCBAddress);
 
         ID3D12DescriptorHeap* heaps[] = { m_srvHeap.Get() };
         cmdList->SetDescriptorHeaps(_countof(heaps), heaps);
@@ -450,7 +436,7 @@ void SsgiPass::Render(ID3D12GraphicsCommandList* cmdList,
     D3D12_RECT fullScissor = { 0, 0, m_viewportWidth, m_viewportHeight };
     cmdList->RSSetScissorRects(1, &fullScissor);
 
-    const UINT kUpsampleSrvStart = 11;
+    const UINT kUpsampleSrvStart = frameSrvBase + 11;
     CreateBlurInputSRV(m_ssgiRawRT.Get(), depthBuffer, kUpsampleSrvStart);
     transition(m_ssgiBlurTempRT.Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
     {
@@ -461,8 +447,8 @@ void SsgiPass::Render(ID3D12GraphicsCommandList* cmdList,
 
         cmdList->SetGraphicsRootSignature(rootSig);
         cmdList->SetPipelineState(upsamplePso);
-        if (m_sceneConstantBuffer) cmdList->SetGraphicsRootConstantBufferView(0, m_sceneConstantBuffer->GetGPUVirtualAddress());
-        cmdList->SetGraphicsRootConstantBufferView(2, m_ssgiConstantBuffer->GetGPUVirtualAddress());
+        if (m_sceneCBAddress) cmdList->SetGraphicsRootConstantBufferView(0, m_sceneCBAddress);
+        cmdList->SetGraphicsRootConstantBufferView(2, m_ssgiCBAddress);
 
         ID3D12DescriptorHeap* heaps[] = { m_srvHeap.Get() };
         cmdList->SetDescriptorHeaps(_countof(heaps), heaps);
@@ -478,8 +464,8 @@ void SsgiPass::Render(ID3D12GraphicsCommandList* cmdList,
     transition(m_ssgiBlurTempRT.Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
     // ========== 横向模糊 Pass (全分辨率) ==========
-    const UINT kBlurHSrvStart = 7;
-    const UINT kBlurVSrvStart = 9;
+    const UINT kBlurHSrvStart = frameSrvBase + 7;
+    const UINT kBlurVSrvStart = frameSrvBase + 9;
     CreateBlurInputSRV(m_ssgiBlurTempRT.Get(), depthBuffer, kBlurHSrvStart);
     transition(m_ssgiFinalRT.Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
     {
@@ -490,8 +476,8 @@ void SsgiPass::Render(ID3D12GraphicsCommandList* cmdList,
 
         cmdList->SetGraphicsRootSignature(rootSig);
         cmdList->SetPipelineState(blurHPso);
-        if (m_sceneConstantBuffer) cmdList->SetGraphicsRootConstantBufferView(0, m_sceneConstantBuffer->GetGPUVirtualAddress());
-        cmdList->SetGraphicsRootConstantBufferView(2, m_ssgiConstantBuffer->GetGPUVirtualAddress());
+        if (m_sceneCBAddress) cmdList->SetGraphicsRootConstantBufferView(0, m_sceneCBAddress);
+        cmdList->SetGraphicsRootConstantBufferView(2, m_ssgiCBAddress);
 
         ID3D12DescriptorHeap* heaps[] = { m_srvHeap.Get() };
         cmdList->SetDescriptorHeaps(_countof(heaps), heaps);
@@ -517,8 +503,8 @@ void SsgiPass::Render(ID3D12GraphicsCommandList* cmdList,
 
         cmdList->SetGraphicsRootSignature(rootSig);
         cmdList->SetPipelineState(blurVPso);
-        if (m_sceneConstantBuffer) cmdList->SetGraphicsRootConstantBufferView(0, m_sceneConstantBuffer->GetGPUVirtualAddress());
-        cmdList->SetGraphicsRootConstantBufferView(2, m_ssgiConstantBuffer->GetGPUVirtualAddress());
+        if (m_sceneCBAddress) cmdList->SetGraphicsRootConstantBufferView(0, m_sceneCBAddress);
+        cmdList->SetGraphicsRootConstantBufferView(2, m_ssgiCBAddress);
 
         ID3D12DescriptorHeap* heaps[] = { m_srvHeap.Get() };
         cmdList->SetDescriptorHeaps(_countof(heaps), heaps);
@@ -2,6 +2,8 @@
 #include "public/StaticMeshComponent.h"
 #include "public/BattleFireDirect.h"
 #include "public/Material/MaterialInstance.h"
+#include "public/Mesh/MeshBin.h"
+#include "public/Mesh/MeshCooker.h"
 #include <assert.h>
 #include <iostream>
 #include <fbxsdk.h>
@@ -56,17 +58,17 @@ void StaticMeshComponent::SetVertexTangent(int inIndex, float inX, float inY, fl
     }
 }
 
-void StaticMeshComponent::InitFromFile(ID3D12GraphicsCommandList* inCommandList, const char* inFilePath) {
+bool StaticMeshComponent::ImportFBX(const char* inFilePath, MeshImportData& outData, MeshWeldStats* outWeldStats) {
     if (GetFileAttributesA(inFilePath) == INVALID_FILE_ATTRIBUTES) {
         std::string errorMsg = "FBX File Not Found: " + std::string(inFilePath);
         MessageBoxA(NULL, errorMsg.c_str(), "File Error", MB_OK | MB_ICONERROR);
-        return;
+        return false;
     }
 
     FbxManager* fbxManager = FbxManager::Create();
     if (!fbxManager) {
         MessageBoxA(NULL, "Failed to create FBX Manager", "FBX Error", MB_OK | MB_ICONERROR);
-        return;
+        return false;
     }
 
     FbxIOSettings* ioSettings = FbxIOSettings::Create(fbxManager, IOSROOT);
@@ -97,7 +99,7 @@ void StaticMeshComponent::InitFromFile(ID3D12GraphicsCommandList* inCommandList,
         MessageBoxA(NULL, errorMsg.c_str(), "FBX Error", MB_OK | MB_ICONERROR);
         importer->Destroy();
         fbxManager->Destroy();
-        return;
+        return false;
     }
 
     FbxScene* scene = FbxScene::Create(fbxManager, "Scene");
@@ -105,7 +107,7 @@ void StaticMeshComponent::InitFromFile(ID3D12GraphicsCommandList* inCommandList,
         MessageBoxA(NULL, "Failed to create FBX Scene", "FBX Error", MB_OK | MB_ICONERROR);
         importer->Destroy();
         fbxManager->Destroy();
-        return;
+        return false;
     }
 
     if (!importer->Import(scene)) {
@@ -114,10 +116,11 @@ void StaticMeshComponent::InitFromFile(ID3D12GraphicsCommandList* inCommandList,
         scene->Destroy();
         importer->Destroy();
         fbxManager->Destroy();
-        return;
+        return false;
     }
 
-    if (!ParseFBXScene(scene, inCommandList)) {
+    bool parsed = ParseFBXScene(scene, outData, outWeldStats);
+    if (!parsed) {
         MessageBoxA(NULL, "Failed to parse FBX Scene", "FBX Error", MB_OK | MB_ICONERROR);
     }
 
@@ -125,43 +128,146 @@ void StaticMeshComponent::InitFromFile(ID3D12GraphicsCommandList* inCommandList,
     scene->Destroy();
     fbxManager->Destroy();
 
-    if (mVertexCount > 0 && mVertexData) {
-        mVBO = CreateBufferObject(inCommandList, mVertexData,
-            sizeof(StaticMeshComponentVertexData) * mVertexCount,
-            D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    if (!parsed || outData.vertices.empty() || outData.indices.empty()) {
+        return false;
+    }
 
-        mVBOView.BufferLocation = mVBO->GetGPUVirtualAddress();
-        mVBOView.StrideInBytes = sizeof(StaticMeshComponentVertexData);
-        mVBOView.SizeInBytes = sizeof(StaticMeshComponentVertexData) * mVertexCount;
+    // 整体包围体由各子网格合并
+    outData.bounds = outData.subMeshes[0].bounds;
+    for (size_t i = 1; i < outData.subMeshes.size(); ++i) {
+        outData.bounds = MergeMeshBounds(outData.bounds, outData.subMeshes[i].bounds);
     }
+    return true;
 }
 
-bool StaticMeshComponent::ParseFBXScene(FbxScene* pScene, ID3D12GraphicsCommandList* inCommandList) {
+void StaticMeshComponent::InitFromFile(ID3D12GraphicsCommandList* inCommandList, const char* inFilePath) {
+    MeshImportData data;
+    mImportStats = MeshWeldStats();
+    if (!ImportFBX(inFilePath, data, &mImportStats)) {
+        return;
+    }
+
+    if (!UploadGeometry(inCommandList, data.vertices.data(), (unsigned int)data.vertices.size(),
+                        data.indices.data(), (unsigned int)data.indices.size())) {
+        return;
+    }
+    for (const MeshSubMeshData& subMesh : data.subMeshes) {
+        AddSubMesh(subMesh.name, subMesh.indexOffset, subMesh.indexCount, subMesh.bounds);
+    }
+    mBounds = data.bounds;
+}
+
+bool StaticMeshComponent::InitFromMeshBin(ID3D12GraphicsCommandList* inCommandList, const std::wstring& meshBinPath,
+                                          const std::wstring& fbxSourcePath) {
+    if (!fbxSourcePath.empty()) {
+        MeshCooker::CookIfStale(fbxSourcePath, meshBinPath);
+    }
+
+    MeshBinFile file;
+    bool opened = file.Open(meshBinPath);
+    // 文件头有效但内容损坏时CookIfStale不会重新烘焙，有源文件则强制重新烘焙一次
+    if (!opened && !fbxSourcePath.empty() && MeshCooker::Cook(fbxSourcePath, meshBinPath)) {
+        opened = file.Open(meshBinPath);
+    }
+    if (!opened) {
+        char msg[512];
+        sprintf_s(msg, "StaticMeshComponent::InitFromMeshBin - Failed to open %S\n", meshBinPath.c_str());
+        OutputDebugStringA(msg);
+        return false;
+    }
+
+    // 映射的数据块直接交给上传路径，不做逐顶点解析
+    const MeshBinHeader* header = file.GetHeader();
+    if (!UploadGeometry(inCommandList, file.GetVertices(), header->vertexCount,
+                        file.GetIndices(), header->indexCount)) {
+        return false;
+    }
+
+    const MeshBinSubMesh* subMeshes = file.GetSubMeshes();
+    for (uint32_t i = 0; i < header->subMeshCount; ++i) {
+        AddSubMesh(subMeshes[i].name, subMeshes[i].indexOffset, subMeshes[i].indexCount,
+                   MeshBinFile::ToBounds(subMeshes[i]));
+    }
+    mBounds = file.GetBounds();
+
+    // CreateBufferObject已把数据拷进上传堆，这里可以直接解除映射
+    file.Close();
+    return true;
+}
+
+bool StaticMeshComponent::UploadGeometry(ID3D12GraphicsCommandList* inCommandList,
+                                         const StaticMeshComponentVertexData* vertices, unsigned int vertexCount,
+                                         const unsigned int* indices, unsigned int indexCount) {
+    if (!vertices || !indices || vertexCount == 0 || indexCount == 0) {
+        return false;
+    }
+
+    mVertexCount = (int)vertexCount;
+    mVBO = CreateBufferObject(inCommandList, const_cast<StaticMeshComponentVertexData*>(vertices),
+        sizeof(StaticMeshComponentVertexData) * vertexCount,
+        D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+
+    mVBOView.BufferLocation = mVBO->GetGPUVirtualAddress();
+    mVBOView.StrideInBytes = sizeof(StaticMeshComponentVertexData);
+    mVBOView.SizeInBytes = sizeof(StaticMeshComponentVertexData) * vertexCount;
+
+    mIBO = CreateBufferObject(inCommandList, const_cast<unsigned int*>(indices),
+        sizeof(unsigned int) * indexCount,
+        D3D12_RESOURCE_STATE_INDEX_BUFFER);
+
+    mUVDensity = ComputeMeshUVDensity(vertices, indices, indexCount);
+    return mIBO != nullptr;
+}
+
+void StaticMeshComponent::AddSubMesh(const std::string& name, unsigned int indexOffset, unsigned int indexCount,
+                                     const MeshBounds& bounds) {
+    if (!mIBO || indexCount == 0) {
+        return;
+    }
+
+    SubMesh* subMesh = new SubMesh();
+    subMesh->mIndexCount = (int)indexCount;
+    subMesh->mStartIndex = indexOffset;
+    subMesh->mBounds = bounds;
+    subMesh->mIBView.BufferLocation = mIBO->GetGPUVirtualAddress() + sizeof(unsigned int) * (UINT64)indexOffset;
+    subMesh->mIBView.Format = DXGI_FORMAT_R32_UINT;
+    subMesh->mIBView.SizeInBytes = sizeof(unsigned int) * indexCount;
+
+    // FBX里节点可能重名，重名时追加序号避免覆盖
+    std::string key = name;
+    for (int suffix = 1; mSubMeshes.find(key) != mSubMeshes.end(); ++suffix) {
+        key = name + "_" + std::to_string(suffix);
+    }
+    mSubMeshes[key] = subMesh;
+}
+
+bool StaticMeshComponent::ParseFBXScene(FbxScene* pScene, MeshImportData& outData, MeshWeldStats* outWeldStats) {
     if (!pScene) return false;
 
     FbxNode* rootNode = pScene->GetRootNode();
     if (rootNode) {
-        ProcessFBXNode(rootNode, inCommandList);
+        ProcessFBXNode(rootNode, outData, outWeldStats);
     }
     return true;
 }
 
-void StaticMeshComponent::ProcessFBXNode(FbxNode* pNode, ID3D12GraphicsCommandList* inCommandList) {
+void StaticMeshComponent::ProcessFBXNode(FbxNode* pNode, MeshImportData& outData, MeshWeldStats* outWeldStats) {
     if (!pNode) return;
 
     for (int i = 0; i < pNode->GetNodeAttributeCount(); ++i) {
         FbxNodeAttribute* attr = pNode->GetNodeAttributeByIndex(i);
         if (attr && attr->GetAttributeType() == FbxNodeAttribute::eMesh) {
-            ProcessFBXMesh(static_cast<FbxMesh*>(attr), pNode->GetName(), inCommandList);
+            ProcessFBXMesh(static_cast<FbxMesh*>(attr), pNode->GetName(), outData, outWeldStats);
         }
     }
 
     for (int i = 0; i < pNode->GetChildCount(); ++i) {
-        ProcessFBXNode(pNode->GetChild(i), inCommandList);
+        ProcessFBXNode(pNode->GetChild(i), outData, outWeldStats);
     }
 }
 
-void StaticMeshComponent::ProcessFBXMesh(FbxMesh* pMesh, const std::string& nodeName, ID3D12GraphicsCommandList* inCommandList) {
+void StaticMeshComponent::ProcessFBXMesh(FbxMesh* pMesh, const std::string& nodeName, MeshImportData& outData,
+                                         MeshWeldStats* outWeldStats) {
     if (!pMesh) return;
 
     std::vector<StaticMeshComponentVertexData> vertices;
@@ -273,21 +379,58 @@ void StaticMeshComponent::ProcessFBXMesh(FbxMesh* pMesh, const std::string& node
         }
     }
 
+    // === 顶点焊接：合并重复顶点并重映射索引 ===
+    MeshWeldSettings weldSettings;
+    MeshWeldStats weldStats;
+    if (MeshWelder::Weld(vertices, indices, weldSettings, vertices, indices, &weldStats)) {
+        if (outWeldStats) {
+            outWeldStats->inputVertexCount += weldStats.inputVertexCount;
+            outWeldStats->outputVertexCount += weldStats.outputVertexCount;
+            outWeldStats->indexCount += weldStats.indexCount;
+            outWeldStats->weldTimeMs += weldStats.weldTimeMs;
+        }
+
+        char msg[256];
+        sprintf_s(msg, "[StaticMesh] Weld '%s': %u -> %u vertices, %u indices, %.3f ms\n",
+            nodeName.c_str(), weldStats.inputVertexCount, weldStats.outputVertexCount,
+            weldStats.indexCount, weldStats.weldTimeMs);
+        OutputDebugStringA(msg);
+        std::cout << msg;
+    }
+
+    // === 索引优化：顶点缓存重排 + Overdraw簇排序 + 顶点读取重排 ===
+    MeshOptimizeStats optimizeStats;
+    MeshOptimizer::Optimize(vertices, indices, &optimizeStats);
+    {
+        char msg[256];
+        sprintf_s(msg, "[StaticMesh] Optimize '%s': ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, %.3f ms\n",
+            nodeName.c_str(), optimizeStats.before.acmr, optimizeStats.after.acmr,
+            optimizeStats.before.atvr, optimizeStats.after.atvr, optimizeStats.optimizeTimeMs);
+        OutputDebugStringA(msg);
+        std::cout << msg;
+    }
+
+    if (indices.empty()) {
+        return;
+    }
+
     // === ���õ���� ===
-    SetVertexCount((int)vertices.size());
-    memcpy(mVertexData, vertices.data(), sizeof(StaticMeshComponentVertexData) * vertices.size());
+    // 合并到共享顶点数组，索引加上顶点基址
+    unsigned int baseVertex = (unsigned int)outData.vertices.size();
+    unsigned int indexOffset = (unsigned int)outData.indices.size();
+    outData.vertices.insert(outData.vertices.end(), vertices.begin(), vertices.end());
 
     // === �������������� ===
-    SubMesh* subMesh = new SubMesh();
-    subMesh->mIndexCount = (int)indices.size();
-    subMesh->mIBO = CreateBufferObject(inCommandList, indices.data(),
-        sizeof(unsigned int) * (int)indices.size(),
-        D3D12_RESOURCE_STATE_INDEX_BUFFER);
+    for (unsigned int index : indices) {
+        outData.indices.push_back(index + baseVertex);
+    }
 
-    subMesh->mIBView.BufferLocation = subMesh->mIBO->GetGPUVirtualAddress();
-    subMesh->mIBView.Format = DXGI_FORMAT_R32_UINT;
-    subMesh->mIBView.SizeInBytes = sizeof(unsigned int) * (UINT)indices.size();
-    mSubMeshes[nodeName] = subMesh;
+    MeshSubMeshData subMesh;
+    subMesh.name = nodeName;
+    subMesh.indexOffset = indexOffset;
+    subMesh.indexCount = (unsigned int)indices.size();
+    subMesh.bounds = ComputeMeshBounds(outData.vertices.data(), outData.indices.data() + indexOffset, indices.size());
+    outData.subMeshes.push_back(subMesh);
 }
 
 
@@ -306,9 +449,13 @@ void StaticMeshComponent::Render(ID3D12GraphicsCommandList* inCommandList, ID3D1
     }
 
     // ��Ⱦ����������
+    DrawSubMeshes(inCommandList);
+}
+
+void StaticMeshComponent::DrawSubMeshes(ID3D12GraphicsCommandList* inCommandList, UINT instanceCount) {
     for (auto& pair : mSubMeshes) {
         SubMesh* subMesh = pair.second;
         inCommandList->IASetIndexBuffer(&subMesh->mIBView);
-        inCommandList->DrawIndexedInstanced(subMesh->mIndexCount, 1, 0, 0, 0);
+        inCommandList->DrawIndexedInstanced(subMesh->mIndexCount, instanceCount, 0, 0, 0);
     }
 }
\ No newline at end of file
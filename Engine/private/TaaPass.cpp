@@ -1,5 +1,6 @@
 #include "public/TaaPass.h"
 #include "public/Settings.h"
+#include "public/UploadAllocator.h"
 #include <d3dx12.h>
 #include <stdexcept>
 #include <iostream>
@@ -19,21 +20,6 @@ bool TaaPass::Initialize(int viewportWidth, int viewportHeight) {
     CreateRenderTargets();
     CreateSRVHeap();
 
-    // 创建 TAA 常量缓冲区
-    UINT cbSize = (sizeof(TaaConstants) + 255) & ~255;
-    CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
-    CD3DX12_RESOURCE_DESC bufDesc = CD3DX12_RESOURCE_DESC::Buffer(cbSize);
-
-    HRESULT hr = gD3D12Device->CreateCommittedResource(
-        &heapProps, D3D12_HEAP_FLAG_NONE, &bufDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-        IID_PPV_ARGS(&m_taaConstantBuffer));
-
-    if (FAILED(hr)) {
-        std::cout << "TaaPass: Failed to create constant buffer" << std::endl;
-        return false;
-    }
-
     std::cout << "TaaPass initialized: " << viewportWidth << "x" << viewportHeight << std::endl;
     return true;
 }
@@ -102,10 +88,15 @@ void TaaPass::CreateRenderTargets() {
     gD3D12Device->CreateRenderTargetView(m_historyRT2.Get(), nullptr, rtvHandle);
 }
 
+static constexpr UINT kSrvsPerFrame = 5;
+static constexpr UINT kCopySrvIndex = 4;
+
 void TaaPass::CreateSRVHeap() {
     D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
     srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    srvHeapDesc.NumDescriptors = 4;
+    // 每个在途帧一段：0-3 TAA输入（当前帧/历史/MotionVector/深度），4 复制到交换链的源
+    // 复制使用独立槽位，历史缓冲每帧交替，同一帧和上一帧的绘制引用的描述符都不会被覆盖
+    srvHeapDesc.NumDescriptors = kSrvsPerFrame * kFramesInFlight;
     srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
 
     HRESULT hr = gD3D12Device->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&m_srvHeap));
@@ -122,7 +113,8 @@ void TaaPass::CreateVertexBuffer() {
 void TaaPass::CreateInputSRVs(ID3D12Resource* currentColorRT,
                                ID3D12Resource* motionVectorRT,
                                ID3D12Resource* depthBuffer) {
-    CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(m_srvHeap->GetCPUDescriptorHandleForHeapStart());
+    CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(m_srvHeap->GetCPUDescriptorHandleForHeapStart(),
+                                            GetFrameIndex() * kSrvsPerFrame, m_srvDescriptorSize);
 
     D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
     srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
@@ -172,28 +164,30 @@ void TaaPass::UpdateTaaConstants() {
                                         static_cast<float>(m_viewportHeight));
     taaConstants.blendFactor = m_firstFrame ? 0.0f : m_blendFactor;
 
-    UINT8* pData;
-    CD3DX12_RANGE readRange(0, 0);
-    m_taaConstantBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pData));
-    memcpy(pData, &taaConstants, sizeof(TaaConstants));
-    m_taaConstantBuffer->Unmap(0, nullptr);
+    // 每帧从上传环中分配：Render和RenderToSwapChain各写一次，不覆盖GPU仍在读取的在途帧常量
+    m_taaCBAddress = LinearUploadAllocator::GetInstance().AllocateConstants(&taaConstants, sizeof(TaaConstants));
 }
 
 // ========== 绑定共享渲染状态 ==========
 static void BindTaaRenderState(ID3D12GraphicsCommandList* cmdList,
     ID3D12PipelineState* pso, ID3D12RootSignature* rootSig,
-    ID3D12Resource* sceneCB, ID3D12DescriptorHeap* srvHeap) {
+    D3D12_GPU_VIRTUAL_ADDRESS sceneCBAddress, D3D12_GPU_VIRTUAL_ADDRESS taaCBAddress,
+    ID3D12DescriptorHeap* srvHeap, UINT srvStartIndex, UINT srvDescriptorSize) {
     cmdList->SetGraphicsRootSignature(rootSig);
     cmdList->SetPipelineState(pso);
 
-    if (sceneCB) {
-        cmdList->SetGraphicsRootConstantBufferView(0, sceneCB->GetGPUVirtualAddress());
+    if (sceneCBAddress) {
+        cmdList->SetGraphicsRootConstantBufferView(0, sceneCBAddress);
+    }
+    // TAA常量（b1，root parameter index 2）
+    if (taaCBAddress) {
+        cmdList->SetGraphicsRootConstantBufferView(2, taaCBAddress);
     }
 
     ID3D12DescriptorHeap* heaps[] = { srvHeap };
     cmdList->SetDescriptorHeaps(_countof(heaps), heaps);
 
-    CD3DX12_GPU_DESCRIPTOR_HANDLE srvGpuHandle(srvHeap->GetGPUDescriptorHandleForHeapStart());
+    CD3DX12_GPU_DESCRIPTOR_HANDLE srvGpuHandle(srvHeap->GetGPUDescriptorHandleForHeapStart(), srvStartIndex, srvDescriptorSize);
     cmdList->SetGraphicsRootDescriptorTable(1, srvGpuHandle);
 
     D3D12_VERTEX_BUFFER_VIEW vbv;
@@ -231,7 +225,7 @@ void TaaPass::Render(ID3D12GraphicsCommandList* cmdList,
     cmdList->OMSetRenderTargets(1, &historyRtvHandle, FALSE, nullptr);
 
     SetViewportAndScissor(cmdList);
-    BindTaaRenderState(cmdList, pso, rootSig, m_sceneConstantBuffer, m_srvHeap.Get());
+    BindTaaRenderState(cmdList, pso, rootSig, m_sceneCBAddress, m_taaCBAddress, m_srvHeap.Get(), GetFrameIndex() * kSrvsPerFrame, m_srvDescriptorSize);
     cmdList->DrawInstanced(6, 1, 0, 0);
 
     // 恢复资源状态
@@ -351,7 +345,7 @@ void TaaPass::RenderToSwapChain(ID3D12GraphicsCommandList* cmdList,
     cmdList->OMSetRenderTargets(1, &historyRtvHandle, FALSE, nullptr);
 
     SetViewportAndScissor(cmdList);
-    BindTaaRenderState(cmdList, pso, rootSig, m_sceneConstantBuffer, m_srvHeap.Get());
+    BindTaaRenderState(cmdList, pso, rootSig, m_sceneCBAddress, m_taaCBAddress, m_srvHeap.Get(), GetFrameIndex() * kSrvsPerFrame, m_srvDescriptorSize);
     cmdList->DrawInstanced(6, 1, 0, 0);
 
     // 历史缓冲转为SRV
@@ -374,7 +368,8 @@ void TaaPass::CopyToSwapChain(ID3D12GraphicsCommandList* cmdList,
     ID3D12Resource* currentHistoryRT = m_useHistory2 ? m_historyRT.Get() : m_historyRT2.Get();
 
     // 为复制操作创建SRV
-    CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(m_srvHeap->GetCPUDescriptorHandleForHeapStart());
+    const UINT copySrvIndex = GetFrameIndex() * kSrvsPerFrame + kCopySrvIndex;
+    CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(m_srvHeap->GetCPUDescriptorHandleForHeapStart(), copySrvIndex, m_srvDescriptorSize);
     D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
     srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
     srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
@@ -386,7 +381,7 @@ void TaaPass::CopyToSwapChain(ID3D12GraphicsCommandList* cmdList,
     cmdList->OMSetRenderTargets(1, &swapChainRTV, FALSE, nullptr);
 
     SetViewportAndScissor(cmdList);
-    BindTaaRenderState(cmdList, copyPso, rootSig, nullptr, m_srvHeap.Get());
+    BindTaaRenderState(cmdList, copyPso, rootSig, 0, 0, m_srvHeap.Get(), copySrvIndex, m_srvDescriptorSize);
     cmdList->DrawInstanced(6, 1, 0, 0);
 }
 
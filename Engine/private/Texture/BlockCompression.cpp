@@ -0,0 +1,1017 @@
+// BlockCompression.cpp
+// BC1/BC3/BC5 CPU编码器实现（BC7/BC6H在BlockCompressionBC67.cpp），表面编码/解码与性能测试
+// 颜色块：端点（包围盒或主成分方向）→ 量化到565 → 选择索引 → 按索引最小二乘求解新端点，迭代到误差不再下降
+// 单通道块（BC3 Alpha、BC5）：同样的流程，8值/6值两种模式取误差小的
+// 纯色块：查最优单色端点表（与stb_dxt/DirectXTex相同的做法），所有质量档位都使用
+
+#include "public/Texture/BlockCompression.h"
+#include "public/ParallelFor.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BC_SIMD_AVX2 1
+#elif defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BC_SIMD_SSE2 1
+#endif
+
+namespace {
+    // 每个线程至少分到的块数，小mip不值得启动线程
+    constexpr size_t kMinBlocksPerThread = 256;
+
+    // 颜色块按通道分开存放，索引选择一次处理4个（SSE2）或8个（AVX2）像素
+    struct alignas(32) ColorBlock {
+        float r[16];
+        float g[16];
+        float b[16];
+    };
+
+    struct Color3 {
+        float r, g, b;
+    };
+
+    // 每种质量档位的最小二乘修正次数
+    int GetRefineIterations(BlockEncodeQuality quality) {
+        switch (quality) {
+        case BlockEncodeQuality::Fast:   return 0;
+        case BlockEncodeQuality::Normal: return 1;
+        case BlockEncodeQuality::High:   return 3;
+        default:                         return 4;
+        }
+    }
+
+    float Clamp255(float value) {
+        return std::min(255.0f, std::max(0.0f, value));
+    }
+
+    // ========== 565量化 ==========
+
+    uint16_t PackRGB565(const Color3& color) {
+        const int r = (int)(Clamp255(color.r) * 31.0f / 255.0f + 0.5f);
+        const int g = (int)(Clamp255(color.g) * 63.0f / 255.0f + 0.5f);
+        const int b = (int)(Clamp255(color.b) * 31.0f / 255.0f + 0.5f);
+        return (uint16_t)((r << 11) | (g << 5) | b);
+    }
+
+    void UnpackRGB565(uint16_t packed, int& r, int& g, int& b) {
+        const int r5 = (packed >> 11) & 31;
+        const int g6 = (packed >> 5) & 63;
+        const int b5 = packed & 31;
+        r = (r5 << 3) | (r5 >> 2);
+        g = (g6 << 2) | (g6 >> 4);
+        b = (b5 << 3) | (b5 >> 2);
+    }
+
+    // 解码器的调色板（整数舍入与DirectXTex的浮点插值结果一致），编码和解码共用
+    // threeColor：c0 <= c1时的3色模式，索引3为透明黑
+    void BuildColorPalette(uint16_t c0, uint16_t c1, bool threeColor, int palette[4][3]) {
+        UnpackRGB565(c0, palette[0][0], palette[0][1], palette[0][2]);
+        UnpackRGB565(c1, palette[1][0], palette[1][1], palette[1][2]);
+        for (int ch = 0; ch < 3; ++ch) {
+            const int a = palette[0][ch];
+            const int b = palette[1][ch];
+            if (threeColor) {
+                palette[2][ch] = (a + b + 1) / 2;
+                palette[3][ch] = 0;
+            } else {
+                palette[2][ch] = (2 * a + b + 1) / 3;
+                palette[3][ch] = (a + 2 * b + 1) / 3;
+            }
+        }
+    }
+
+    // ========== 索引选择 ==========
+
+    // 每个像素选最近的调色板颜色，返回总平方误差
+    float SelectColorIndices(const ColorBlock& block, const Color3* palette, int paletteCount, uint8_t indices[16]) {
+        float totalError = 0.0f;
+#if defined(BC_SIMD_AVX2)
+        for (int i = 0; i < 16; i += 8) {
+            const __m256 r = _mm256_load_ps(block.r + i);
+            const __m256 g = _mm256_load_ps(block.g + i);
+            const __m256 b = _mm256_load_ps(block.b + i);
+            __m256 bestError = _mm256_set1_ps(FLT_MAX);
+            __m256i bestIndex = _mm256_setzero_si256();
+            for (int p = 0; p < paletteCount; ++p) {
+                const __m256 dr = _mm256_sub_ps(r, _mm256_set1_ps(palette[p].r));
+                const __m256 dg = _mm256_sub_ps(g, _mm256_set1_ps(palette[p].g));
+                const __m256 db = _mm256_sub_ps(b, _mm256_set1_ps(palette[p].b));
+                const __m256 error = _mm256_add_ps(_mm256_mul_ps(dr, dr),
+                                                   _mm256_add_ps(_mm256_mul_ps(dg, dg), _mm256_mul_ps(db, db)));
+                const __m256i closer = _mm256_castps_si256(_mm256_cmp_ps(error, bestError, _CMP_LT_OQ));
+                bestError = _mm256_min_ps(error, bestError);
+                bestIndex = _mm256_or_si256(_mm256_and_si256(closer, _mm256_set1_epi32(p)),
+                                            _mm256_andnot_si256(closer, bestIndex));
+            }
+            alignas(32) float errors[8];
+            alignas(32) int32_t selected[8];
+            _mm256_store_ps(errors, bestError);
+            _mm256_store_si256((__m256i*)selected, bestIndex);
+            for (int k = 0; k < 8; ++k) {
+                indices[i + k] = (uint8_t)selected[k];
+                totalError += errors[k];
+            }
+        }
+#elif defined(BC_SIMD_SSE2)
+        for (int i = 0; i < 16; i += 4) {
+            const __m128 r = _mm_load_ps(block.r + i);
+            const __m128 g = _mm_load_ps(block.g + i);
+            const __m128 b = _mm_load_ps(block.b + i);
+            __m128 bestError = _mm_set1_ps(FLT_MAX);
+            __m128i bestIndex = _mm_setzero_si128();
+            for (int p = 0; p < paletteCount; ++p) {
+                const __m128 dr = _mm_sub_ps(r, _mm_set1_ps(palette[p].r));
+                const __m128 dg = _mm_sub_ps(g, _mm_set1_ps(palette[p].g));
+                const __m128 db = _mm_sub_ps(b, _mm_set1_ps(palette[p].b));
+                const __m128 error = _mm_add_ps(_mm_mul_ps(dr, dr), _mm_add_ps(_mm_mul_ps(dg, dg), _mm_mul_ps(db, db)));
+                const __m128i closer = _mm_castps_si128(_mm_cmplt_ps(error, bestError));
+                bestError = _mm_min_ps(error, bestError);
+                bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(p)), _mm_andnot_si128(closer, bestIndex));
+            }
+            alignas(16) float errors[4];
+            alignas(16) int32_t selected[4];
+            _mm_store_ps(errors, bestError);
+            _mm_store_si128((__m128i*)selected, bestIndex);
+            for (int k = 0; k < 4; ++k) {
+                indices[i + k] = (uint8_t)selected[k];
+                totalError += errors[k];
+            }
+        }
+#else
+        for (int i = 0; i < 16; ++i) {
+            float bestError = FLT_MAX;
+            int bestIndex = 0;
+            for (int p = 0; p < paletteCount; ++p) {
+                const float dr = block.r[i] - palette[p].r;
+                const float dg = block.g[i] - palette[p].g;
+                const float db = block.b[i] - palette[p].b;
+                const float error = dr * dr + dg * dg + db * db;
+                if (error < bestError) {
+                    bestError = error;
+                    bestIndex = p;
+                }
+            }
+            indices[i] = (uint8_t)bestIndex;
+            totalError += bestError;
+        }
+#endif
+        return totalError;
+    }
+
+    // ========== 纯色块 ==========
+
+    // 最优单色端点：对8位值v，5位/6位端点(e0, e1)使4色模式的索引2（(2 * c0 + c1 + 1) / 3）最接近v
+    // 误差相同时取两端点相距近的，不同解码器的插值舍入差异对它影响最小
+    struct SingleColorEntry {
+        uint8_t e0;
+        uint8_t e1;
+    };
+
+    struct SingleColorTables {
+        SingleColorEntry table5[256];
+        SingleColorEntry table6[256];
+
+        SingleColorTables() {
+            Build(5, table5);
+            Build(6, table6);
+        }
+
+        static int Expand(int value, int bits) {
+            return bits == 5 ? (value << 3) | (value >> 2) : (value << 2) | (value >> 4);
+        }
+
+        static void Build(int bits, SingleColorEntry table[256]) {
+            const int maxValue = (1 << bits) - 1;
+            for (int v = 0; v < 256; ++v) {
+                int bestError = INT_MAX;
+                int bestSpread = INT_MAX;
+                for (int e0 = 0; e0 <= maxValue; ++e0) {
+                    const int a = Expand(e0, bits);
+                    for (int e1 = 0; e1 <= maxValue; ++e1) {
+                        const int b = Expand(e1, bits);
+                        const int error = std::abs((2 * a + b + 1) / 3 - v);
+                        const int spread = std::abs(a - b);
+                        if (error < bestError || (error == bestError && spread < bestSpread)) {
+                            bestError = error;
+                            bestSpread = spread;
+                            table[v].e0 = (uint8_t)e0;
+                            table[v].e1 = (uint8_t)e1;
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    const SingleColorTables& GetSingleColorTables() {
+        static const SingleColorTables tables;  // 首次使用时构建（线程安全的局部静态）
+        return tables;
+    }
+
+    // 16个像素颜色相同时返回true
+    bool IsSingleColor(const ColorBlock& block) {
+        for (int i = 1; i < 16; ++i) {
+            if (block.r[i] != block.r[0] || block.g[i] != block.g[0] || block.b[i] != block.b[0]) return false;
+        }
+        return true;
+    }
+
+    // ========== 颜色块 ==========
+
+    struct ColorCandidate {
+        uint16_t c0 = 0;
+        uint16_t c1 = 0;
+        bool threeColor = false;
+        uint8_t indices[16] = {};
+        float error = FLT_MAX;
+    };
+
+    void EvaluateColorCandidate(const ColorBlock& block, uint16_t c0, uint16_t c1, bool threeColor, ColorCandidate& out) {
+        int palette[4][3];
+        BuildColorPalette(c0, c1, threeColor, palette);
+        Color3 colors[4];
+        for (int p = 0; p < 4; ++p) {
+            colors[p] = { (float)palette[p][0], (float)palette[p][1], (float)palette[p][2] };
+        }
+        out.c0 = c0;
+        out.c1 = c1;
+        out.threeColor = threeColor;
+        // 3色模式不使用索引3（透明黑），不透明纹理采样时Alpha会变成0
+        out.error = SelectColorIndices(block, colors, threeColor ? 3 : 4, out.indices);
+    }
+
+    // 包围盒对角线作为端点；按协方差符号选择对角线方向，再向内收缩1/16减小量化误差
+    void ComputeBoundingBoxEndpoints(const ColorBlock& block, Color3& outStart, Color3& outEnd) {
+        Color3 minColor = { 255.0f, 255.0f, 255.0f };
+        Color3 maxColor = { 0.0f, 0.0f, 0.0f };
+        Color3 mean = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; ++i) {
+            minColor.r = std::min(minColor.r, block.r[i]);
+            minColor.g = std::min(minColor.g, block.g[i]);
+            minColor.b = std::min(minColor.b, block.b[i]);
+            maxColor.r = std::max(maxColor.r, block.r[i]);
+            maxColor.g = std::max(maxColor.g, block.g[i]);
+            maxColor.b = std::max(maxColor.b, block.b[i]);
+            mean.r += block.r[i];
+            mean.g += block.g[i];
+            mean.b += block.b[i];
+        }
+        mean.r /= 16.0f;
+        mean.g /= 16.0f;
+        mean.b /= 16.0f;
+
+        float covRG = 0.0f, covRB = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            covRG += (block.r[i] - mean.r) * (block.g[i] - mean.g);
+            covRB += (block.r[i] - mean.r) * (block.b[i] - mean.b);
+        }
+        if (covRG < 0.0f) std::swap(minColor.g, maxColor.g);
+        if (covRB < 0.0f) std::swap(minColor.b, maxColor.b);
+
+        const float inset = 1.0f / 16.0f;
+        outStart = { maxColor.r - (maxColor.r - minColor.r) * inset,
+                     maxColor.g - (maxColor.g - minColor.g) * inset,
+                     maxColor.b - (maxColor.b - minColor.b) * inset };
+        outEnd = { minColor.r + (maxColor.r - minColor.r) * inset,
+                   minColor.g + (maxColor.g - minColor.g) * inset,
+                   minColor.b + (maxColor.b - minColor.b) * inset };
+    }
+
+    // 协方差矩阵的主特征向量（幂迭代）作为拟合直线，像素投影的两端作为端点
+    void ComputePrincipalEndpoints(const ColorBlock& block, Color3& outStart, Color3& outEnd) {
+        Color3 mean = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; ++i) {
+            mean.r += block.r[i];
+            mean.g += block.g[i];
+            mean.b += block.b[i];
+        }
+        mean.r /= 16.0f;
+        mean.g /= 16.0f;
+        mean.b /= 16.0f;
+
+        float cov[6] = {};  // rr rg rb gg gb bb
+        for (int i = 0; i < 16; ++i) {
+            const float r = block.r[i] - mean.r;
+            const float g = block.g[i] - mean.g;
+            const float b = block.b[i] - mean.b;
+            cov[0] += r * r;
+            cov[1] += r * g;
+            cov[2] += r * b;
+            cov[3] += g * g;
+            cov[4] += g * b;
+            cov[5] += b * b;
+        }
+
+        float axis[3] = { 1.0f, 1.0f, 1.0f };
+        for (int iteration = 0; iteration < 8; ++iteration) {
+            const float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+            const float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+            const float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+            const float scale = std::max(std::fabs(x), std::max(std::fabs(y), std::fabs(z)));
+            if (scale < 1e-6f) break;  // 所有像素相同（或都在均值附近），保留上一个方向
+            axis[0] = x / scale;
+            axis[1] = y / scale;
+            axis[2] = z / scale;
+        }
+
+        const float lengthSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+        float minT = 0.0f, maxT = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            const float t = ((block.r[i] - mean.r) * axis[0] + (block.g[i] - mean.g) * axis[1] +
+                             (block.b[i] - mean.b) * axis[2]) / lengthSq;
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+        outStart = { mean.r + axis[0] * maxT, mean.g + axis[1] * maxT, mean.b + axis[2] * maxT };
+        outEnd = { mean.r + axis[0] * minT, mean.g + axis[1] * minT, mean.b + axis[2] * minT };
+    }
+
+    // 固定索引求解端点：每个像素 x ≈ w*c0 + (1-w)*c1，对c0/c1做最小二乘
+    bool RefineColorEndpoints(const ColorBlock& block, const uint8_t indices[16], bool threeColor,
+                              Color3& outC0, Color3& outC1) {
+        static const float kFourColorWeights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+        static const float kThreeColorWeights[4] = { 1.0f, 0.0f, 0.5f, 0.0f };
+        const float* weights = threeColor ? kThreeColorWeights : kFourColorWeights;
+
+        float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+        Color3 ax = { 0.0f, 0.0f, 0.0f };
+        Color3 bx = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; ++i) {
+            if (threeColor && indices[i] == 3) continue;
+            const float a = weights[indices[i]];
+            const float b = 1.0f - a;
+            aa += a * a;
+            bb += b * b;
+            ab += a * b;
+            ax.r += a * block.r[i];
+            ax.g += a * block.g[i];
+            ax.b += a * block.b[i];
+            bx.r += b * block.r[i];
+            bx.g += b * block.g[i];
+            bx.b += b * block.b[i];
+        }
+
+        const float det = aa * bb - ab * ab;
+        if (std::fabs(det) < 1e-6f) return false;  // 所有像素选了同一个索引
+        const float inv = 1.0f / det;
+        outC0 = { (ax.r * bb - bx.r * ab) * inv, (ax.g * bb - bx.g * ab) * inv, (ax.b * bb - bx.b * ab) * inv };
+        outC1 = { (bx.r * aa - ax.r * ab) * inv, (bx.g * aa - ax.g * ab) * inv, (bx.b * aa - ax.b * ab) * inv };
+        return true;
+    }
+
+    void RefineColorCandidate(const ColorBlock& block, int iterations, ColorCandidate& best) {
+        for (int iteration = 0; iteration < iterations && best.error > 0.0f; ++iteration) {
+            Color3 c0, c1;
+            if (!RefineColorEndpoints(block, best.indices, best.threeColor, c0, c1)) break;
+
+            ColorCandidate candidate;
+            EvaluateColorCandidate(block, PackRGB565(c0), PackRGB565(c1), best.threeColor, candidate);
+            if (candidate.error >= best.error) break;
+            best = candidate;
+        }
+    }
+
+    // 逐个把量化后的端点通道±1，保留使误差下降的改动（Ultra档位）
+    void SearchColorNeighborhood(const ColorBlock& block, ColorCandidate& best) {
+        static const int kShifts[3] = { 11, 5, 0 };
+        static const int kMasks[3] = { 31, 63, 31 };
+        bool improved = true;
+        for (int pass = 0; pass < 4 && improved && best.error > 0.0f; ++pass) {
+            improved = false;
+            for (int endpoint = 0; endpoint < 2; ++endpoint) {
+                for (int ch = 0; ch < 3; ++ch) {
+                    for (int delta = -1; delta <= 1; delta += 2) {
+                        uint16_t endpoints[2] = { best.c0, best.c1 };
+                        const int value = ((endpoints[endpoint] >> kShifts[ch]) & kMasks[ch]) + delta;
+                        if (value < 0 || value > kMasks[ch]) continue;
+                        endpoints[endpoint] = (uint16_t)((endpoints[endpoint] & ~(kMasks[ch] << kShifts[ch])) |
+                                                         (value << kShifts[ch]));
+
+                        ColorCandidate candidate;
+                        EvaluateColorCandidate(block, endpoints[0], endpoints[1], best.threeColor, candidate);
+                        if (candidate.error < best.error) {
+                            best = candidate;
+                            improved = true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // 按解码器的模式约定写出：4色模式需要c0 > c1，3色模式需要c0 <= c1
+    void WriteColorBlock(const ColorCandidate& candidate, uint8_t out[8]) {
+        uint16_t c0 = candidate.c0;
+        uint16_t c1 = candidate.c1;
+        uint8_t indices[16];
+        memcpy(indices, candidate.indices, sizeof(indices));
+
+        if (!candidate.threeColor) {
+            if (c0 < c1) {
+                std::swap(c0, c1);
+                for (uint8_t& index : indices) index ^= 1;  // 0<->1，2<->3
+            } else if (c0 == c1) {
+                memset(indices, 0, sizeof(indices));     // 两端相同时解码为3色模式，只用索引0
+            }
+        } else if (c0 > c1) {
+            std::swap(c0, c1);
+            for (uint8_t& index : indices) {
+                if (index < 2) index ^= 1;
+            }
+        }
+
+        uint32_t bits = 0;
+        for (int i = 0; i < 16; ++i) {
+            bits |= (uint32_t)indices[i] << (i * 2);
+        }
+        out[0] = (uint8_t)(c0 & 0xFF);
+        out[1] = (uint8_t)(c0 >> 8);
+        out[2] = (uint8_t)(c1 & 0xFF);
+        out[3] = (uint8_t)(c1 >> 8);
+        for (int i = 0; i < 4; ++i) {
+            out[4 + i] = (uint8_t)(bits >> (i * 8));
+        }
+    }
+
+    // allowThreeColor：BC1可以用3色模式；BC2/BC3的颜色块总是按4色模式解码
+    void EncodeColorBlock(const ColorBlock& block, BlockEncodeQuality quality, bool allowThreeColor, uint8_t out[8]) {
+        if (IsSingleColor(block)) {
+            const SingleColorTables& tables = GetSingleColorTables();
+            const SingleColorEntry& r = tables.table5[(int)block.r[0]];
+            const SingleColorEntry& g = tables.table6[(int)block.g[0]];
+            const SingleColorEntry& b = tables.table5[(int)block.b[0]];
+            ColorCandidate single;
+            EvaluateColorCandidate(block, (uint16_t)((r.e0 << 11) | (g.e0 << 5) | b.e0),
+                                   (uint16_t)((r.e1 << 11) | (g.e1 << 5) | b.e1), false, single);
+            WriteColorBlock(single, out);
+            return;
+        }
+
+        Color3 start, end;
+        if (quality == BlockEncodeQuality::Fast) {
+            ComputeBoundingBoxEndpoints(block, start, end);
+        } else {
+            ComputePrincipalEndpoints(block, start, end);
+        }
+        const uint16_t c0 = PackRGB565(start);
+        const uint16_t c1 = PackRGB565(end);
+        const int iterations = GetRefineIterations(quality);
+
+        ColorCandidate best;
+        EvaluateColorCandidate(block, c0, c1, false, best);
+        RefineColorCandidate(block, iterations, best);
+
+        if (allowThreeColor && quality >= BlockEncodeQuality::High && best.error > 0.0f) {
+            ColorCandidate threeColor;
+            EvaluateColorCandidate(block, c0, c1, true, threeColor);
+            RefineColorCandidate(block, iterations, threeColor);
+            if (threeColor.error < best.error) {
+                best = threeColor;
+            }
+        }
+
+        if (quality == BlockEncodeQuality::Ultra) {
+            SearchColorNeighborhood(block, best);
+        }
+        WriteColorBlock(best, out);
+    }
+
+    // ========== 单通道块（BC4：BC3的Alpha、BC5的R/G） ==========
+
+    // a0 > a1：8值模式（6个插值）；否则6值模式（4个插值 + 0 + 255）
+    void BuildAlphaPalette(int a0, int a1, int palette[8]) {
+        palette[0] = a0;
+        palette[1] = a1;
+        if (a0 > a1) {
+            for (int i = 1; i < 7; ++i) {
+                palette[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+            }
+        } else {
+            for (int i = 1; i < 5; ++i) {
+                palette[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    struct AlphaCandidate {
+        int a0 = 0;
+        int a1 = 0;
+        uint8_t indices[16] = {};
+        float error = FLT_MAX;
+    };
+
+    // 模式由a0/a1的大小关系决定（与解码器一致）
+    void EvaluateAlphaCandidate(const float values[16], int a0, int a1, AlphaCandidate& out) {
+        int palette[8];
+        BuildAlphaPalette(a0, a1, palette);
+        out.a0 = a0;
+        out.a1 = a1;
+        out.error = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            float bestError = FLT_MAX;
+            int bestIndex = 0;
+            for (int p = 0; p < 8; ++p) {
+                const float diff = values[i] - (float)palette[p];
+                const float error = diff * diff;
+                if (error < bestError) {
+                    bestError = error;
+                    bestIndex = p;
+                }
+            }
+            out.indices[i] = (uint8_t)bestIndex;
+            out.error += bestError;
+        }
+    }
+
+    int RoundAlpha(float value) {
+        return (int)(Clamp255(value) + 0.5f);
+    }
+
+    // 固定索引对两个端点做最小二乘；6值模式的索引6/7是常数0/255，不参与求解
+    bool RefineAlphaEndpoints(const float values[16], const AlphaCandidate& candidate, float& outA0, float& outA1) {
+        const bool eightValues = candidate.a0 > candidate.a1;
+        float aa = 0.0f, bb = 0.0f, ab = 0.0f, ax = 0.0f, bx = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            const int index = candidate.indices[i];
+            float a;
+            if (index == 0) {
+                a = 1.0f;
+            } else if (index == 1) {
+                a = 0.0f;
+            } else if (eightValues) {
+                a = (float)(8 - index) / 7.0f;
+            } else if (index < 6) {
+                a = (float)(6 - index) / 5.0f;
+            } else {
+                continue;
+            }
+            const float b = 1.0f - a;
+            aa += a * a;
+            bb += b * b;
+            ab += a * b;
+            ax += a * values[i];
+            bx += b * values[i];
+        }
+
+        const float det = aa * bb - ab * ab;
+        if (std::fabs(det) < 1e-6f) return false;
+        outA0 = (ax * bb - bx * ab) / det;
+        outA1 = (bx * aa - ax * ab) / det;
+        return true;
+    }
+
+    void RefineAlphaCandidate(const float values[16], int iterations, AlphaCandidate& best) {
+        for (int iteration = 0; iteration < iterations && best.error > 0.0f; ++iteration) {
+            float a0, a1;
+            if (!RefineAlphaEndpoints(values, best, a0, a1)) break;
+
+            // 保持原来的模式：8值模式a0在上，6值模式a0在下
+            int e0 = RoundAlpha(a0);
+            int e1 = RoundAlpha(a1);
+            if ((best.a0 > best.a1) != (e0 > e1)) std::swap(e0, e1);
+
+            AlphaCandidate candidate;
+            EvaluateAlphaCandidate(values, e0, e1, candidate);
+            if (candidate.error >= best.error) break;
+            best = candidate;
+        }
+    }
+
+    void EncodeAlphaBlock(const float values[16], BlockEncodeQuality quality, uint8_t out[8]) {
+        float minValue = 255.0f, maxValue = 0.0f;
+        float innerMin = 255.0f, innerMax = 0.0f;  // 不含0和255（6值模式可以精确表示这两个值）
+        for (int i = 0; i < 16; ++i) {
+            minValue = std::min(minValue, values[i]);
+            maxValue = std::max(maxValue, values[i]);
+            if (values[i] > 0.5f && values[i] < 254.5f) {
+                innerMin = std::min(innerMin, values[i]);
+                innerMax = std::max(innerMax, values[i]);
+            }
+        }
+        const int iterations = GetRefineIterations(quality);
+
+        AlphaCandidate best;
+        EvaluateAlphaCandidate(values, RoundAlpha(maxValue), RoundAlpha(minValue), best);
+        RefineAlphaCandidate(values, iterations, best);
+
+        if (quality >= BlockEncodeQuality::High && best.error > 0.0f && innerMin <= innerMax) {
+            AlphaCandidate sixValues;
+            EvaluateAlphaCandidate(values, RoundAlpha(innerMin), RoundAlpha(innerMax), sixValues);
+            RefineAlphaCandidate(values, iterations, sixValues);
+            if (sixValues.error < best.error) {
+                best = sixValues;
+            }
+        }
+
+        if (quality == BlockEncodeQuality::Ultra && best.error > 0.0f) {
+            const AlphaCandidate center = best;
+            for (int d0 = -2; d0 <= 2; ++d0) {
+                for (int d1 = -2; d1 <= 2; ++d1) {
+                    const int a0 = center.a0 + d0;
+                    const int a1 = center.a1 + d1;
+                    if (a0 < 0 || a0 > 255 || a1 < 0 || a1 > 255) continue;
+                    AlphaCandidate candidate;
+                    EvaluateAlphaCandidate(values, a0, a1, candidate);
+                    if (candidate.error < best.error) {
+                        best = candidate;
+                    }
+                }
+            }
+        }
+
+        uint64_t bits = 0;
+        for (int i = 0; i < 16; ++i) {
+            bits |= (uint64_t)best.indices[i] << (i * 3);
+        }
+        out[0] = (uint8_t)best.a0;
+        out[1] = (uint8_t)best.a1;
+        for (int i = 0; i < 6; ++i) {
+            out[2 + i] = (uint8_t)(bits >> (i * 8));
+        }
+    }
+
+    // ========== 解码 ==========
+
+    void DecodeColorBlock(const uint8_t* in, bool forceFourColor, uint8_t outRGBA[64]) {
+        const uint16_t c0 = (uint16_t)(in[0] | (in[1] << 8));
+        const uint16_t c1 = (uint16_t)(in[2] | (in[3] << 8));
+        const bool threeColor = !forceFourColor && c0 <= c1;
+        int palette[4][3];
+        BuildColorPalette(c0, c1, threeColor, palette);
+
+        const uint32_t bits = (uint32_t)in[4] | ((uint32_t)in[5] << 8) | ((uint32_t)in[6] << 16) | ((uint32_t)in[7] << 24);
+        for (int i = 0; i < 16; ++i) {
+            const int index = (bits >> (i * 2)) & 3;
+            outRGBA[i * 4 + 0] = (uint8_t)palette[index][0];
+            outRGBA[i * 4 + 1] = (uint8_t)palette[index][1];
+            outRGBA[i * 4 + 2] = (uint8_t)palette[index][2];
+            outRGBA[i * 4 + 3] = (threeColor && index == 3) ? 0 : 255;
+        }
+    }
+
+    void DecodeAlphaBlock(const uint8_t* in, uint8_t outValues[16]) {
+        int palette[8];
+        BuildAlphaPalette(in[0], in[1], palette);
+        uint64_t bits = 0;
+        for (int i = 0; i < 6; ++i) {
+            bits |= (uint64_t)in[2 + i] << (i * 8);
+        }
+        for (int i = 0; i < 16; ++i) {
+            outValues[i] = (uint8_t)palette[(bits >> (i * 3)) & 7];
+        }
+    }
+
+    void DecodeBlock(BlockFormat format, const uint8_t* in, uint8_t outRGBA[64]) {
+        uint8_t values[16];
+        switch (format) {
+        case BlockFormat::BC1:
+            DecodeColorBlock(in, false, outRGBA);
+            break;
+        case BlockFormat::BC3:
+            DecodeColorBlock(in + 8, true, outRGBA);
+            DecodeAlphaBlock(in, values);
+            for (int i = 0; i < 16; ++i) outRGBA[i * 4 + 3] = values[i];
+            break;
+        case BlockFormat::BC5:
+            DecodeAlphaBlock(in, values);
+            for (int i = 0; i < 16; ++i) outRGBA[i * 4 + 0] = values[i];
+            DecodeAlphaBlock(in + 8, values);
+            for (int i = 0; i < 16; ++i) {
+                outRGBA[i * 4 + 1] = values[i];
+                outRGBA[i * 4 + 2] = 0;
+                outRGBA[i * 4 + 3] = 255;
+            }
+            break;
+        case BlockFormat::BC7:
+            DecodeBC7Block(in, outRGBA);
+            break;
+        case BlockFormat::BC6H: {
+            float hdr[64];
+            DecodeBC6HBlock(in, hdr);
+            for (int i = 0; i < 64; ++i) {
+                outRGBA[i] = (uint8_t)(std::min(1.0f, std::max(0.0f, hdr[i])) * 255.0f + 0.5f);
+            }
+            break;
+        }
+        }
+    }
+
+    // 读取一个4x4块，超出图像的像素复制边缘
+    void LoadBlock(const uint8_t* rgba, uint32_t width, uint32_t height, size_t rowPitch,
+                   uint32_t blockX, uint32_t blockY, uint8_t outRGBA[64]) {
+        for (uint32_t y = 0; y < 4; ++y) {
+            const uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+            const uint8_t* row = rgba + sourceY * rowPitch;
+            for (uint32_t x = 0; x < 4; ++x) {
+                const uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+                memcpy(outRGBA + (y * 4 + x) * 4, row + sourceX * 4, 4);
+            }
+        }
+    }
+
+    void LoadBlockHDR(const float* rgba, uint32_t width, uint32_t height, size_t rowPitch,
+                      uint32_t blockX, uint32_t blockY, float outRGBA[64]) {
+        for (uint32_t y = 0; y < 4; ++y) {
+            const uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+            const float* row = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(rgba) + sourceY * rowPitch);
+            for (uint32_t x = 0; x < 4; ++x) {
+                const uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+                memcpy(outRGBA + (y * 4 + x) * 4, row + sourceX * 4, 4 * sizeof(float));
+            }
+        }
+    }
+
+    // 按块数限制线程数：小图不值得分给所有线程
+    unsigned int GetEncodeThreadCount(uint32_t blocksX, uint32_t blocksY, unsigned int settingsMaxThreads) {
+        unsigned int maxThreads = (unsigned int)std::max<size_t>(1, (size_t)blocksX * blocksY / kMinBlocksPerThread);
+        if (settingsMaxThreads > 0) {
+            maxThreads = std::min(maxThreads, settingsMaxThreads);
+        }
+        return maxThreads;
+    }
+}
+
+size_t GetBlockBytes(BlockFormat format) {
+    return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+size_t GetBlockRowPitch(BlockFormat format, uint32_t width) {
+    return (size_t)std::max(1u, (width + 3) / 4) * GetBlockBytes(format);
+}
+
+size_t GetEncodedSurfaceSize(BlockFormat format, uint32_t width, uint32_t height) {
+    return GetBlockRowPitch(format, width) * std::max(1u, (height + 3) / 4);
+}
+
+void EncodeBlock(BlockFormat format, const uint8_t rgba[64], BlockEncodeQuality quality, uint8_t* out) {
+    ColorBlock colors;
+    float values[16];
+    switch (format) {
+    case BlockFormat::BC1:
+    case BlockFormat::BC3:
+        for (int i = 0; i < 16; ++i) {
+            colors.r[i] = rgba[i * 4 + 0];
+            colors.g[i] = rgba[i * 4 + 1];
+            colors.b[i] = rgba[i * 4 + 2];
+        }
+        if (format == BlockFormat::BC1) {
+            EncodeColorBlock(colors, quality, true, out);
+        } else {
+            for (int i = 0; i < 16; ++i) values[i] = rgba[i * 4 + 3];
+            EncodeAlphaBlock(values, quality, out);
+            EncodeColorBlock(colors, quality, false, out + 8);
+        }
+        break;
+    case BlockFormat::BC5:
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int i = 0; i < 16; ++i) values[i] = rgba[i * 4 + ch];
+            EncodeAlphaBlock(values, quality, out + ch * 8);
+        }
+        break;
+    case BlockFormat::BC7:
+        EncodeBC7Block(rgba, quality, out);
+        break;
+    case BlockFormat::BC6H: {
+        float hdr[64];
+        for (int i = 0; i < 64; ++i) hdr[i] = rgba[i] / 255.0f;
+        EncodeBC6HBlock(hdr, quality, out);
+        break;
+    }
+    }
+}
+
+void EncodeSurface(const uint8_t* rgba, uint32_t width, uint32_t height, size_t rowPitch,
+                   const BlockEncodeSettings& settings, uint8_t* outBlocks) {
+    if (width == 0 || height == 0) return;
+
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    const size_t blockBytes = GetBlockBytes(settings.format);
+    const size_t blockRowPitch = GetBlockRowPitch(settings.format, width);
+    const unsigned int maxThreads = GetEncodeThreadCount(blocksX, blocksY, settings.maxThreads);
+
+    // 一行块是一个任务：同一行的源像素连续，线程之间不共享输出
+    ParallelFor(blocksY, [&](size_t blockY) {
+        uint8_t pixels[64];
+        uint8_t* outRow = outBlocks + blockY * blockRowPitch;
+        for (uint32_t blockX = 0; blockX < blocksX; ++blockX) {
+            LoadBlock(rgba, width, height, rowPitch, blockX, (uint32_t)blockY, pixels);
+            EncodeBlock(settings.format, pixels, settings.quality, outRow + blockX * blockBytes);
+        }
+    }, maxThreads);
+}
+
+void DecodeSurface(const uint8_t* blocks, BlockFormat format, uint32_t width, uint32_t height,
+                   uint8_t* outRGBA, size_t outRowPitch) {
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    const size_t blockBytes = GetBlockBytes(format);
+    const size_t blockRowPitch = GetBlockRowPitch(format, width);
+
+    uint8_t pixels[64];
+    for (uint32_t blockY = 0; blockY < blocksY; ++blockY) {
+        for (uint32_t blockX = 0; blockX < blocksX; ++blockX) {
+            DecodeBlock(format, blocks + blockY * blockRowPitch + blockX * blockBytes, pixels);
+            for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; ++y) {
+                const uint32_t columns = std::min(4u, width - blockX * 4);
+                memcpy(outRGBA + (blockY * 4 + y) * outRowPitch + blockX * 16, pixels + y * 16, columns * 4);
+            }
+        }
+    }
+}
+
+double ComputeBlockPSNR(BlockFormat format, const uint8_t* reference, size_t referenceRowPitch,
+                        const uint8_t* decoded, size_t decodedRowPitch, uint32_t width, uint32_t height) {
+    const int channelCount = format == BlockFormat::BC5 ? 2 :
+        ((format == BlockFormat::BC3 || format == BlockFormat::BC7) ? 4 : 3);
+    double squaredError = 0.0;
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint8_t* a = reference + y * referenceRowPitch;
+        const uint8_t* b = decoded + y * decodedRowPitch;
+        for (uint32_t x = 0; x < width; ++x) {
+            for (int ch = 0; ch < channelCount; ++ch) {
+                const double diff = (double)a[x * 4 + ch] - (double)b[x * 4 + ch];
+                squaredError += diff * diff;
+            }
+        }
+    }
+
+    const double sampleCount = (double)width * height * channelCount;
+    if (sampleCount == 0.0 || squaredError == 0.0) return 99.0;
+    const double mse = squaredError / sampleCount;
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+// ========== HDR（BC6H） ==========
+
+void EncodeSurfaceHDR(const float* rgba, uint32_t width, uint32_t height, size_t rowPitch,
+                      const BlockEncodeSettings& settings, uint8_t* outBlocks) {
+    if (width == 0 || height == 0) return;
+
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    const size_t blockRowPitch = GetBlockRowPitch(BlockFormat::BC6H, width);
+    const unsigned int maxThreads = GetEncodeThreadCount(blocksX, blocksY, settings.maxThreads);
+
+    ParallelFor(blocksY, [&](size_t blockY) {
+        float pixels[64];
+        uint8_t* outRow = outBlocks + blockY * blockRowPitch;
+        for (uint32_t blockX = 0; blockX < blocksX; ++blockX) {
+            LoadBlockHDR(rgba, width, height, rowPitch, blockX, (uint32_t)blockY, pixels);
+            EncodeBC6HBlock(pixels, settings.quality, outRow + blockX * 16);
+        }
+    }, maxThreads);
+}
+
+void DecodeSurfaceHDR(const uint8_t* blocks, uint32_t width, uint32_t height, float* outRGBA, size_t outRowPitch) {
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    const size_t blockRowPitch = GetBlockRowPitch(BlockFormat::BC6H, width);
+
+    float pixels[64];
+    uint8_t* outBytes = reinterpret_cast<uint8_t*>(outRGBA);
+    for (uint32_t blockY = 0; blockY < blocksY; ++blockY) {
+        for (uint32_t blockX = 0; blockX < blocksX; ++blockX) {
+            DecodeBC6HBlock(blocks + blockY * blockRowPitch + blockX * 16, pixels);
+            for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; ++y) {
+                const uint32_t columns = std::min(4u, width - blockX * 4);
+                memcpy(outBytes + (blockY * 4 + y) * outRowPitch + blockX * 4 * 4 * sizeof(float),
+                       pixels + y * 16, columns * 4 * sizeof(float));
+            }
+        }
+    }
+}
+
+double ComputeHDRPSNR(const float* reference, size_t referenceRowPitch,
+                      const float* decoded, size_t decodedRowPitch, uint32_t width, uint32_t height) {
+    const uint8_t* referenceBytes = reinterpret_cast<const uint8_t*>(reference);
+    const uint8_t* decodedBytes = reinterpret_cast<const uint8_t*>(decoded);
+    double squaredError = 0.0;
+    for (uint32_t y = 0; y < height; ++y) {
+        const float* a = reinterpret_cast<const float*>(referenceBytes + y * referenceRowPitch);
+        const float* b = reinterpret_cast<const float*>(decodedBytes + y * decodedRowPitch);
+        for (uint32_t x = 0; x < width; ++x) {
+            for (int ch = 0; ch < 3; ++ch) {
+                const double va = std::max(0.0, (double)a[x * 4 + ch]);
+                const double vb = std::max(0.0, (double)b[x * 4 + ch]);
+                const double diff = va / (1.0 + va) - vb / (1.0 + vb);
+                squaredError += diff * diff;
+            }
+        }
+    }
+
+    const double sampleCount = (double)width * height * 3;
+    if (sampleCount == 0.0 || squaredError == 0.0) return 99.0;
+    return 10.0 * std::log10(sampleCount / squaredError);
+}
+
+// ========== 性能与质量测试 ==========
+
+namespace {
+    // 固定种子的整数哈希噪声，结果与平台无关
+    uint32_t HashNoise(uint32_t x, uint32_t y, uint32_t seed) {
+        uint32_t h = x * 0x8DA6B343u ^ y * 0xD8163841u ^ seed * 0xCB1AB31Fu;
+        h ^= h >> 13;
+        h *= 0x5BD1E995u;
+        return h ^ (h >> 15);
+    }
+
+    // LDR测试图：平滑渐变、低幅噪声、每64像素一条硬边，Alpha为对角渐变
+    void MakeBenchmarkImageLDR(uint32_t size, std::vector<uint8_t>& outRGBA) {
+        outRGBA.resize((size_t)size * size * 4);
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                uint8_t* pixel = &outRGBA[((size_t)y * size + x) * 4];
+                const int noise = (int)(HashNoise(x, y, 1) & 15) - 8;
+                const bool edge = ((x / 64) + (y / 64)) & 1;
+                const int r = (int)(x * 255 / std::max(1u, size - 1)) + noise;
+                const int g = (int)(y * 255 / std::max(1u, size - 1)) + noise;
+                const int b = edge ? 200 + noise : 40 + noise;
+                pixel[0] = (uint8_t)std::min(255, std::max(0, r));
+                pixel[1] = (uint8_t)std::min(255, std::max(0, g));
+                pixel[2] = (uint8_t)std::min(255, std::max(0, b));
+                pixel[3] = (uint8_t)((x + y) * 255 / std::max(1u, 2 * size - 2));
+            }
+        }
+    }
+
+    // HDR测试图：地平线渐变的天空加几个亮度到几百的光源
+    void MakeBenchmarkImageHDR(uint32_t size, std::vector<float>& outRGBA) {
+        outRGBA.resize((size_t)size * size * 4);
+        const float suns[3][3] = { { 0.3f, 0.25f, 400.0f }, { 0.7f, 0.4f, 40.0f }, { 0.5f, 0.8f, 4.0f } };
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                float* pixel = &outRGBA[((size_t)y * size + x) * 4];
+                const float u = (float)x / size, v = (float)y / size;
+                const float noise = (float)(HashNoise(x, y, 2) & 255) / 255.0f * 0.02f;
+                float light = 0.0f;
+                for (const auto& sun : suns) {
+                    const float dx = u - sun[0], dy = v - sun[1];
+                    light += sun[2] / (1.0f + 4000.0f * (dx * dx + dy * dy));
+                }
+                pixel[0] = 0.2f + 0.8f * v + light + noise;
+                pixel[1] = 0.4f + 0.6f * v + light * 0.9f + noise;
+                pixel[2] = 1.0f + 0.5f * (1.0f - v) + light * 0.7f + noise;
+                pixel[3] = 1.0f;
+            }
+        }
+    }
+}
+
+void RunBlockEncoderBenchmark(uint32_t size, std::vector<BlockEncoderBenchmarkResult>& outResults) {
+    outResults.clear();
+    size = std::max(4u, size);
+
+    std::vector<uint8_t> ldr;
+    std::vector<float> hdr;
+    MakeBenchmarkImageLDR(size, ldr);
+    MakeBenchmarkImageHDR(size, hdr);
+
+    const BlockFormat formats[] = { BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC5, BlockFormat::BC7, BlockFormat::BC6H };
+    const BlockEncodeQuality qualities[] = { BlockEncodeQuality::Fast, BlockEncodeQuality::Normal,
+                                             BlockEncodeQuality::High, BlockEncodeQuality::Ultra };
+    for (BlockFormat format : formats) {
+        std::vector<uint8_t> blocks(GetEncodedSurfaceSize(format, size, size));
+        for (BlockEncodeQuality quality : qualities) {
+            BlockEncodeSettings settings;
+            settings.format = format;
+            settings.quality = quality;
+
+            const auto start = std::chrono::high_resolution_clock::now();
+            if (format == BlockFormat::BC6H) {
+                EncodeSurfaceHDR(hdr.data(), size, size, (size_t)size * 4 * sizeof(float), settings, blocks.data());
+            } else {
+                EncodeSurface(ldr.data(), size, size, (size_t)size * 4, settings, blocks.data());
+            }
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            BlockEncoderBenchmarkResult result;
+            result.format = format;
+            result.quality = quality;
+            result.width = size;
+            result.height = size;
+            result.encodeMs = std::chrono::duration<double, std::milli>(end - start).count();
+            result.megapixelsPerSecond = (double)size * size / std::max(result.encodeMs, 1e-3) / 1000.0;
+            if (format == BlockFormat::BC6H) {
+                std::vector<float> decoded(hdr.size());
+                DecodeSurfaceHDR(blocks.data(), size, size, decoded.data(), (size_t)size * 4 * sizeof(float));
+                result.psnr = ComputeHDRPSNR(hdr.data(), (size_t)size * 4 * sizeof(float),
+                                             decoded.data(), (size_t)size * 4 * sizeof(float), size, size);
+            } else {
+                std::vector<uint8_t> decoded(ldr.size());
+                DecodeSurface(blocks.data(), format, size, size, decoded.data(), (size_t)size * 4);
+                result.psnr = ComputeBlockPSNR(format, ldr.data(), (size_t)size * 4, decoded.data(), (size_t)size * 4, size, size);
+            }
+            outResults.push_back(result);
+        }
+    }
+}
@@ -0,0 +1,1360 @@
+// BlockCompressionBC67.cpp
+// BC7/BC6H CPU编码器实现（只尝试部分模式，面向导入速度）
+// BC7：不透明块尝试模式6/1/3（Ultra再加三子集的0/2），带Alpha的块尝试6/5/7；分区先按主轴拟合残差估计，只对最好的几个完整编码
+// BC6H（无符号）：端点在半精度位模式空间（近似对数）里拟合，单区域模式11~14，High以上加双区域模式
+// 解码器支持两种格式的全部模式
+
+#include "public/Texture/BlockCompression.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BC67_SIMD_AVX2 1
+#elif defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BC67_SIMD_SSE2 1
+#endif
+
+namespace {
+    // ========== 规范常量 ==========
+
+    const int kWeights2[4] = { 0, 21, 43, 64 };
+    const int kWeights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+    const int kWeights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    const int* GetWeights(int indexBits) {
+        return indexBits == 2 ? kWeights2 : (indexBits == 3 ? kWeights3 : kWeights4);
+    }
+
+    int Interpolate(int a, int b, int weight) {
+        return (a * (64 - weight) + b * weight + 32) >> 6;
+    }
+
+    // 分区表（D3D11规范）：每像素2位，像素i所属子集为 (table >> (2 * i)) & 3
+    // BC6H的32种双区域分区是kPartitions2的前32项
+    const uint32_t kPartitions2[64] = {
+        0x50505050, 0x40404040, 0x54545454, 0x54505040, 0x50404000, 0x55545450, 0x55545040, 0x54504000,
+        0x50400000, 0x55555450, 0x55544000, 0x54400000, 0x55555440, 0x55550000, 0x55555500, 0x55000000,
+        0x55150100, 0x00004054, 0x15010000, 0x00405054, 0x00004050, 0x15050100, 0x05010000, 0x40505054,
+        0x00404050, 0x05010100, 0x14141414, 0x05141450, 0x01155440, 0x00555500, 0x15014054, 0x05414150,
+        0x44444444, 0x55005500, 0x11441144, 0x05055050, 0x05500550, 0x11114444, 0x41144114, 0x44111144,
+        0x15055054, 0x01055040, 0x05041050, 0x05455150, 0x14414114, 0x50050550, 0x41411414, 0x00141400,
+        0x00041504, 0x00105410, 0x10541000, 0x04150400, 0x50410514, 0x41051450, 0x05415014, 0x14054150,
+        0x41050514, 0x41505014, 0x40011554, 0x54150140, 0x50505500, 0x00555050, 0x15151010, 0x54540404,
+    };
+
+    const uint32_t kPartitions3[64] = {
+        0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+        0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+        0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+        0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+        0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+        0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+        0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+        0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+    };
+
+    // 子集1（以及子集2）的锚点像素；子集0的锚点总是像素0
+    const uint8_t kAnchors2[64] = {
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+        15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+        15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+         6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+    };
+
+    const uint8_t kAnchors3[64][2] = {
+        {  3, 15 }, {  3,  8 }, { 15,  8 }, { 15,  3 }, {  8, 15 }, {  3, 15 }, { 15,  3 }, { 15,  8 },
+        {  8, 15 }, {  8, 15 }, {  6, 15 }, {  6, 15 }, {  6, 15 }, {  5, 15 }, {  3, 15 }, {  3,  8 },
+        {  3, 15 }, {  3,  8 }, {  8, 15 }, { 15,  3 }, {  3, 15 }, {  3,  8 }, {  6, 15 }, { 10,  8 },
+        {  5,  3 }, {  8, 15 }, {  8,  6 }, {  6, 10 }, {  8, 15 }, {  5, 15 }, { 15, 10 }, { 15,  8 },
+        {  8, 15 }, { 15,  3 }, {  3, 15 }, {  5, 10 }, {  6, 10 }, { 10,  8 }, {  8,  9 }, { 15, 10 },
+        { 15,  6 }, {  3, 15 }, { 15,  8 }, {  5, 15 }, { 15,  3 }, { 15,  6 }, { 15,  6 }, { 15,  8 },
+        {  3, 15 }, { 15,  3 }, {  5, 15 }, {  5, 15 }, {  5, 15 }, {  8, 15 }, {  5, 15 }, { 10, 15 },
+        {  5, 15 }, { 10, 15 }, {  8, 15 }, { 13, 15 }, { 15,  3 }, { 12, 15 }, {  3, 15 }, {  3,  8 },
+    };
+
+    int GetSubset(int subsetCount, int partition, int pixel) {
+        if (subsetCount == 1) return 0;
+        const uint32_t table = subsetCount == 2 ? kPartitions2[partition] : kPartitions3[partition];
+        return (int)((table >> (pixel * 2)) & 3);
+    }
+
+    // 每种分区每个子集的像素掩码，第一次使用时从分区表展开
+    struct SubsetMaskTable {
+        uint16_t masks[2][64][3];   // [双子集/三子集][分区][子集]
+
+        SubsetMaskTable() {
+            memset(masks, 0, sizeof(masks));
+            for (int table = 0; table < 2; ++table) {
+                for (int partition = 0; partition < 64; ++partition) {
+                    for (int i = 0; i < 16; ++i) {
+                        masks[table][partition][GetSubset(table + 2, partition, i)] |= (uint16_t)(1 << i);
+                    }
+                }
+            }
+        }
+    };
+
+    uint16_t GetSubsetMask(int subsetCount, int partition, int subset) {
+        if (subsetCount == 1) return 0xFFFF;
+        static const SubsetMaskTable table;
+        return table.masks[subsetCount - 2][partition][subset];
+    }
+
+    int GetAnchor(int subsetCount, int partition, int subset) {
+        if (subset == 0) return 0;
+        return subsetCount == 2 ? kAnchors2[partition] : kAnchors3[partition][subset - 1];
+    }
+
+    bool IsAnchor(int subsetCount, int partition, int pixel) {
+        for (int subset = 0; subset < subsetCount; ++subset) {
+            if (GetAnchor(subsetCount, partition, subset) == pixel) return true;
+        }
+        return false;
+    }
+
+    // ========== 128位块读写（低位在前） ==========
+
+    class BlockBits {
+    public:
+        BlockBits() = default;
+        explicit BlockBits(const uint8_t in[16]) { memcpy(m_words, in, sizeof(m_words)); }
+
+        void Write(uint32_t value, int count) {
+            for (int i = 0; i < count; ++i, ++m_position) {
+                if ((value >> i) & 1) {
+                    m_words[m_position >> 6] |= 1ull << (m_position & 63);
+                }
+            }
+        }
+
+        uint32_t Read(int count) {
+            uint32_t value = 0;
+            for (int i = 0; i < count && m_position < 128; ++i, ++m_position) {
+                value |= (uint32_t)((m_words[m_position >> 6] >> (m_position & 63)) & 1) << i;
+            }
+            return value;
+        }
+
+        void Store(uint8_t out[16]) const { memcpy(out, m_words, sizeof(m_words)); }
+
+    private:
+        uint64_t m_words[2] = { 0, 0 };
+        int m_position = 0;
+    };
+
+    // ========== 索引选择 ==========
+
+    // 按通道分开存放的16个像素，索引选择一次处理4个（SSE2）或8个（AVX2）像素
+    struct alignas(32) PixelBlock {
+        float c[4][16];
+    };
+
+    // 每个像素选最近的调色板项（只比较从firstChannel开始的channelCount个通道），errors为每个像素的平方误差
+    void SelectPaletteIndices(const PixelBlock& block, int firstChannel, int channelCount,
+                              const float (*palette)[4], int paletteCount, uint8_t indices[16], float errors[16]) {
+        const int lastChannel = firstChannel + channelCount;
+#if defined(BC67_SIMD_AVX2)
+        for (int i = 0; i < 16; i += 8) {
+            __m256 values[4];
+            for (int ch = firstChannel; ch < lastChannel; ++ch) {
+                values[ch] = _mm256_load_ps(block.c[ch] + i);
+            }
+            __m256 bestError = _mm256_set1_ps(FLT_MAX);
+            __m256i bestIndex = _mm256_setzero_si256();
+            for (int p = 0; p < paletteCount; ++p) {
+                __m256 diff = _mm256_sub_ps(values[firstChannel], _mm256_set1_ps(palette[p][firstChannel]));
+                __m256 error = _mm256_mul_ps(diff, diff);
+                for (int ch = firstChannel + 1; ch < lastChannel; ++ch) {
+                    diff = _mm256_sub_ps(values[ch], _mm256_set1_ps(palette[p][ch]));
+                    error = _mm256_add_ps(error, _mm256_mul_ps(diff, diff));
+                }
+                const __m256i closer = _mm256_castps_si256(_mm256_cmp_ps(error, bestError, _CMP_LT_OQ));
+                bestError = _mm256_min_ps(error, bestError);
+                bestIndex = _mm256_or_si256(_mm256_and_si256(closer, _mm256_set1_epi32(p)),
+                                            _mm256_andnot_si256(closer, bestIndex));
+            }
+            alignas(32) int32_t selected[8];
+            _mm256_storeu_ps(errors + i, bestError);
+            _mm256_store_si256((__m256i*)selected, bestIndex);
+            for (int k = 0; k < 8; ++k) indices[i + k] = (uint8_t)selected[k];
+        }
+#elif defined(BC67_SIMD_SSE2)
+        for (int i = 0; i < 16; i += 4) {
+            __m128 values[4];
+            for (int ch = firstChannel; ch < lastChannel; ++ch) {
+                values[ch] = _mm_load_ps(block.c[ch] + i);
+            }
+            __m128 bestError = _mm_set1_ps(FLT_MAX);
+            __m128i bestIndex = _mm_setzero_si128();
+            for (int p = 0; p < paletteCount; ++p) {
+                __m128 diff = _mm_sub_ps(values[firstChannel], _mm_set1_ps(palette[p][firstChannel]));
+                __m128 error = _mm_mul_ps(diff, diff);
+                for (int ch = firstChannel + 1; ch < lastChannel; ++ch) {
+                    diff = _mm_sub_ps(values[ch], _mm_set1_ps(palette[p][ch]));
+                    error = _mm_add_ps(error, _mm_mul_ps(diff, diff));
+                }
+                const __m128i closer = _mm_castps_si128(_mm_cmplt_ps(error, bestError));
+                bestError = _mm_min_ps(error, bestError);
+                bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(p)), _mm_andnot_si128(closer, bestIndex));
+            }
+            alignas(16) int32_t selected[4];
+            _mm_storeu_ps(errors + i, bestError);
+            _mm_store_si128((__m128i*)selected, bestIndex);
+            for (int k = 0; k < 4; ++k) indices[i + k] = (uint8_t)selected[k];
+        }
+#else
+        for (int i = 0; i < 16; ++i) {
+            float bestError = FLT_MAX;
+            int bestIndex = 0;
+            for (int p = 0; p < paletteCount; ++p) {
+                float diff = block.c[firstChannel][i] - palette[p][firstChannel];
+                float error = diff * diff;
+                for (int ch = firstChannel + 1; ch < lastChannel; ++ch) {
+                    diff = block.c[ch][i] - palette[p][ch];
+                    error = error + diff * diff;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    bestIndex = p;
+                }
+            }
+            indices[i] = (uint8_t)bestIndex;
+            errors[i] = bestError;
+        }
+#endif
+    }
+
+    float SumMasked(const float errors[16], uint16_t mask) {
+        float total = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            if (mask & (1 << i)) total += errors[i];
+        }
+        return total;
+    }
+
+    // ========== 端点拟合 ==========
+
+    // 对称矩阵的主特征向量（幂迭代），矩阵接近0时返回false
+    bool ComputePrincipalAxis(const float matrix[4][4], int size, float axis[4]) {
+        int largest = 0;
+        for (int i = 1; i < size; ++i) {
+            if (matrix[i][i] > matrix[largest][largest]) largest = i;
+        }
+        if (matrix[largest][largest] <= 1e-6f) return false;
+
+        for (int i = 0; i < size; ++i) axis[i] = matrix[largest][i];
+        for (int iteration = 0; iteration < 6; ++iteration) {
+            float next[4] = {};
+            float scale = 0.0f;
+            for (int i = 0; i < size; ++i) {
+                for (int j = 0; j < size; ++j) next[i] += matrix[i][j] * axis[j];
+                scale = std::max(scale, std::fabs(next[i]));
+            }
+            if (scale < 1e-12f) return false;
+            for (int i = 0; i < size; ++i) axis[i] = next[i] / scale;
+        }
+        return true;
+    }
+
+    // mask中像素的主轴端点：均值沿主成分方向延伸到投影的最小/最大值（通道按绝对下标存放）
+    void ComputeAxisEndpoints(const PixelBlock& block, uint16_t mask, int firstChannel, int channelCount,
+                              float maxValue, float outStart[4], float outEnd[4]) {
+        const int lastChannel = firstChannel + channelCount;
+        float mean[4] = {};
+        int count = 0;
+        for (int i = 0; i < 16; ++i) {
+            if (!(mask & (1 << i))) continue;
+            for (int ch = firstChannel; ch < lastChannel; ++ch) mean[ch] += block.c[ch][i];
+            ++count;
+        }
+        for (int ch = firstChannel; ch < lastChannel; ++ch) {
+            mean[ch] /= (float)std::max(count, 1);
+            outStart[ch] = mean[ch];
+            outEnd[ch] = mean[ch];
+        }
+
+        float covariance[4][4] = {};
+        for (int i = 0; i < 16; ++i) {
+            if (!(mask & (1 << i))) continue;
+            for (int a = 0; a < channelCount; ++a) {
+                const float da = block.c[firstChannel + a][i] - mean[firstChannel + a];
+                for (int b = a; b < channelCount; ++b) {
+                    covariance[a][b] += da * (block.c[firstChannel + b][i] - mean[firstChannel + b]);
+                }
+            }
+        }
+        for (int a = 0; a < channelCount; ++a) {
+            for (int b = 0; b < a; ++b) covariance[a][b] = covariance[b][a];
+        }
+
+        float axis[4];
+        if (!ComputePrincipalAxis(covariance, channelCount, axis)) return;   // 所有像素相同
+
+        float lengthSq = 0.0f;
+        for (int a = 0; a < channelCount; ++a) lengthSq += axis[a] * axis[a];
+        float minT = 0.0f, maxT = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            if (!(mask & (1 << i))) continue;
+            float t = 0.0f;
+            for (int a = 0; a < channelCount; ++a) t += (block.c[firstChannel + a][i] - mean[firstChannel + a]) * axis[a];
+            t /= lengthSq;
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+        for (int a = 0; a < channelCount; ++a) {
+            const int ch = firstChannel + a;
+            outStart[ch] = std::min(maxValue, std::max(0.0f, mean[ch] + axis[a] * minT));
+            outEnd[ch] = std::min(maxValue, std::max(0.0f, mean[ch] + axis[a] * maxT));
+        }
+    }
+
+    // 固定索引求解端点：x ≈ (1-t)*e0 + t*e1（t为索引权重/64），对e0/e1做最小二乘；所有像素权重相同时返回false
+    bool SolveEndpoints(const PixelBlock& block, uint16_t mask, int firstChannel, int channelCount, const int* weights,
+                        const uint8_t indices[16], float maxValue, float outStart[4], float outEnd[4]) {
+        const int lastChannel = firstChannel + channelCount;
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float ax[4] = {}, bx[4] = {};
+        for (int i = 0; i < 16; ++i) {
+            if (!(mask & (1 << i))) continue;
+            const float t = (float)weights[indices[i]] / 64.0f;
+            const float s = 1.0f - t;
+            aa += s * s;
+            ab += s * t;
+            bb += t * t;
+            for (int ch = firstChannel; ch < lastChannel; ++ch) {
+                ax[ch] += s * block.c[ch][i];
+                bx[ch] += t * block.c[ch][i];
+            }
+        }
+
+        const float det = aa * bb - ab * ab;
+        if (std::fabs(det) < 1e-6f) return false;
+        const float inv = 1.0f / det;
+        for (int ch = firstChannel; ch < lastChannel; ++ch) {
+            outStart[ch] = std::min(maxValue, std::max(0.0f, (ax[ch] * bb - bx[ch] * ab) * inv));
+            outEnd[ch] = std::min(maxValue, std::max(0.0f, (bx[ch] * aa - ax[ch] * ab) * inv));
+        }
+        return true;
+    }
+
+    // ========== 分区估计 ==========
+
+    // 每种分区的估计误差：各子集相对主轴直线的残差平方和（协方差矩阵的迹减去最大特征值），只用于给分区排序
+    // 每个像素的一阶/二阶矩先算好，子集1/2按掩码累加，子集0用整块的和减去
+    // 最大特征值不逐个子集迭代：取整块主轴方向上的Rayleigh商与最大对角元中较大的一个（都是它的下界）
+    void EstimatePartitionErrors(const PixelBlock& block, int channelCount, int subsetCount, int partitionCount,
+                                 float outErrors[64]) {
+        // 计数 + 4个和 + 10个乘积，补齐到16个以便编译器按向量累加
+        constexpr int kMoments = 16;
+        alignas(32) float moments[16][kMoments] = {};
+        alignas(32) float total[kMoments] = {};
+        for (int i = 0; i < 16; ++i) {
+            int m = 0;
+            moments[i][m++] = 1.0f;
+            for (int a = 0; a < channelCount; ++a) moments[i][m++] = block.c[a][i];
+            for (int a = 0; a < channelCount; ++a) {
+                for (int b = a; b < channelCount; ++b) moments[i][m++] = block.c[a][i] * block.c[b][i];
+            }
+            for (int k = 0; k < kMoments; ++k) total[k] += moments[i][k];
+        }
+
+        float blockCovariance[4][4];
+        for (int a = 0, m = 1 + channelCount; a < channelCount; ++a) {
+            for (int b = a; b < channelCount; ++b, ++m) {
+                blockCovariance[a][b] = total[m] - total[1 + a] * total[1 + b] / 16.0f;
+                blockCovariance[b][a] = blockCovariance[a][b];
+            }
+        }
+        float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        ComputePrincipalAxis(blockCovariance, channelCount, axis);
+        float axisLengthSq = 0.0f;
+        for (int a = 0; a < channelCount; ++a) axisLengthSq += axis[a] * axis[a];
+
+        for (int partition = 0; partition < partitionCount; ++partition) {
+            alignas(32) float sums[3][kMoments] = {};
+            for (int subset = 1; subset < subsetCount; ++subset) {
+                const uint16_t mask = GetSubsetMask(subsetCount, partition, subset);
+                for (int i = 0; i < 16; ++i) {
+                    if (!(mask & (1 << i))) continue;
+                    for (int k = 0; k < kMoments; ++k) sums[subset][k] += moments[i][k];
+                }
+            }
+            for (int k = 0; k < kMoments; ++k) sums[0][k] = total[k] - sums[1][k] - sums[2][k];
+
+            float error = 0.0f;
+            for (int subset = 0; subset < subsetCount; ++subset) {
+                const float count = sums[subset][0];
+                if (count < 1.5f) continue;
+                const float inverseCount = 1.0f / count;
+                const float* mean = sums[subset] + 1;
+                const float* product = sums[subset] + 1 + channelCount;
+                float trace = 0.0f, largestDiagonal = 0.0f, projected = 0.0f;
+                for (int a = 0, m = 0; a < channelCount; ++a) {
+                    for (int b = a; b < channelCount; ++b, ++m) {
+                        const float covariance = product[m] - mean[a] * mean[b] * inverseCount;
+                        projected += (a == b ? 1.0f : 2.0f) * covariance * axis[a] * axis[b];
+                        if (a == b) {
+                            trace += covariance;
+                            largestDiagonal = std::max(largestDiagonal, covariance);
+                        }
+                    }
+                }
+                const float eigenvalue = std::max(largestDiagonal, projected / axisLengthSq);
+                error += std::max(0.0f, trace - eigenvalue);
+            }
+            outErrors[partition] = error;
+        }
+    }
+
+    // 按估计误差从小到大排列分区号
+    void SortPartitions(const float errors[64], int partitionCount, int order[64]) {
+        for (int i = 0; i < partitionCount; ++i) order[i] = i;
+        std::sort(order, order + partitionCount, [&](int a, int b) {
+            return errors[a] < errors[b] || (errors[a] == errors[b] && a < b);
+        });
+    }
+
+    // ========== BC7 ==========
+
+    enum : uint8_t { kNoPBit = 0, kSharedPBit = 1, kUniquePBit = 2 };
+
+    struct BC7ModeInfo {
+        uint8_t subsetCount;
+        uint8_t partitionBits;
+        uint8_t rotationBits;
+        uint8_t indexSelectionBits;
+        uint8_t colorBits;
+        uint8_t alphaBits;              // 0：没有Alpha端点，解码为255
+        uint8_t pbitType;               // P位同时作用于颜色和Alpha
+        uint8_t indexBits;
+        uint8_t secondaryIndexBits;     // 模式4/5的第二组索引
+    };
+
+    const BC7ModeInfo kBC7Modes[8] = {
+        { 3, 4, 0, 0, 4, 0, kUniquePBit, 3, 0 },
+        { 2, 6, 0, 0, 6, 0, kSharedPBit, 3, 0 },
+        { 3, 6, 0, 0, 5, 0, kNoPBit,     2, 0 },
+        { 2, 6, 0, 0, 7, 0, kUniquePBit, 2, 0 },
+        { 1, 0, 2, 1, 5, 6, kNoPBit,     2, 3 },
+        { 1, 0, 2, 0, 7, 8, kNoPBit,     2, 2 },
+        { 1, 0, 0, 0, 7, 7, kUniquePBit, 4, 0 },
+        { 2, 6, 0, 0, 5, 5, kUniquePBit, 2, 0 },
+    };
+
+    struct BC7Block {
+        int mode = 6;
+        int partition = 0;
+        int rotation = 0;               // 1/2/3：解码后交换Alpha与R/G/B
+        int indexSelection = 0;         // 模式4：1表示颜色用第二组（3位）索引
+        int endpoints[3][2][4] = {};    // [子集][端点][通道]，量化值（不含P位）
+        int pbits[3][2] = {};
+        uint8_t indices[16] = {};
+        uint8_t secondaryIndices[16] = {};
+    };
+
+    void WriteBC7Block(const BC7Block& block, uint8_t out[16]) {
+        const BC7ModeInfo& info = kBC7Modes[block.mode];
+        BlockBits bits;
+        bits.Write(1u << block.mode, block.mode + 1);
+        bits.Write((uint32_t)block.partition, info.partitionBits);
+        bits.Write((uint32_t)block.rotation, info.rotationBits);
+        bits.Write((uint32_t)block.indexSelection, info.indexSelectionBits);
+        for (int ch = 0; ch < 3; ++ch) {
+            for (int subset = 0; subset < info.subsetCount; ++subset) {
+                bits.Write((uint32_t)block.endpoints[subset][0][ch], info.colorBits);
+                bits.Write((uint32_t)block.endpoints[subset][1][ch], info.colorBits);
+            }
+        }
+        if (info.alphaBits) {
+            for (int subset = 0; subset < info.subsetCount; ++subset) {
+                bits.Write((uint32_t)block.endpoints[subset][0][3], info.alphaBits);
+                bits.Write((uint32_t)block.endpoints[subset][1][3], info.alphaBits);
+            }
+        }
+        for (int subset = 0; subset < info.subsetCount; ++subset) {
+            if (info.pbitType == kUniquePBit) {
+                bits.Write((uint32_t)block.pbits[subset][0], 1);
+                bits.Write((uint32_t)block.pbits[subset][1], 1);
+            } else if (info.pbitType == kSharedPBit) {
+                bits.Write((uint32_t)block.pbits[subset][0], 1);
+            }
+        }
+        // 锚点像素的索引最高位隐含为0，少存一位
+        for (int i = 0; i < 16; ++i) {
+            bits.Write(block.indices[i], info.indexBits - (IsAnchor(info.subsetCount, block.partition, i) ? 1 : 0));
+        }
+        if (info.secondaryIndexBits) {
+            for (int i = 0; i < 16; ++i) {
+                bits.Write(block.secondaryIndices[i], info.secondaryIndexBits - (i == 0 ? 1 : 0));
+            }
+        }
+        bits.Store(out);
+    }
+
+    bool ReadBC7Block(const uint8_t in[16], BC7Block& block) {
+        BlockBits bits(in);
+        int mode = 0;
+        while (mode < 8 && bits.Read(1) == 0) ++mode;
+        if (mode == 8) return false;    // 保留的模式
+
+        const BC7ModeInfo& info = kBC7Modes[mode];
+        block.mode = mode;
+        block.partition = (int)bits.Read(info.partitionBits);
+        block.rotation = (int)bits.Read(info.rotationBits);
+        block.indexSelection = (int)bits.Read(info.indexSelectionBits);
+        for (int ch = 0; ch < 3; ++ch) {
+            for (int subset = 0; subset < info.subsetCount; ++subset) {
+                block.endpoints[subset][0][ch] = (int)bits.Read(info.colorBits);
+                block.endpoints[subset][1][ch] = (int)bits.Read(info.colorBits);
+            }
+        }
+        if (info.alphaBits) {
+            for (int subset = 0; subset < info.subsetCount; ++subset) {
+                block.endpoints[subset][0][3] = (int)bits.Read(info.alphaBits);
+                block.endpoints[subset][1][3] = (int)bits.Read(info.alphaBits);
+            }
+        }
+        for (int subset = 0; subset < info.subsetCount; ++subset) {
+            if (info.pbitType == kUniquePBit) {
+                block.pbits[subset][0] = (int)bits.Read(1);
+                block.pbits[subset][1] = (int)bits.Read(1);
+            } else if (info.pbitType == kSharedPBit) {
+                block.pbits[subset][0] = block.pbits[subset][1] = (int)bits.Read(1);
+            }
+        }
+        for (int i = 0; i < 16; ++i) {
+            block.indices[i] = (uint8_t)bits.Read(info.indexBits - (IsAnchor(info.subsetCount, block.partition, i) ? 1 : 0));
+        }
+        if (info.secondaryIndexBits) {
+            for (int i = 0; i < 16; ++i) {
+                block.secondaryIndices[i] = (uint8_t)bits.Read(info.secondaryIndexBits - (i == 0 ? 1 : 0));
+            }
+        }
+        return true;
+    }
+
+    // 量化值（加P位）扩展到8位：高位复制到低位
+    int ExpandEndpoint(int value, int bits, int pbit) {
+        if (pbit >= 0) {
+            value = (value << 1) | pbit;
+            ++bits;
+        }
+        value <<= 8 - bits;
+        return value | (value >> bits);
+    }
+
+    // 0~255的值量化到bits位（pbit >= 0时附加该P位），取扩展后最接近的量化值
+    int QuantizeEndpoint(float value, int bits, int pbit) {
+        const int maxValue = (1 << bits) - 1;
+        const int totalBits = pbit >= 0 ? bits + 1 : bits;
+        const float scaled = value * (float)((1 << totalBits) - 1) / 255.0f;
+        const int guess = pbit >= 0 ? (int)std::floor((scaled - pbit) * 0.5f + 0.5f) : (int)std::floor(scaled + 0.5f);
+
+        int best = 0;
+        float bestError = FLT_MAX;
+        for (int q = std::max(0, guess - 1); q <= std::min(maxValue, guess + 1); ++q) {
+            const float error = std::fabs((float)ExpandEndpoint(q, bits, pbit) - value);
+            if (error < bestError) {
+                bestError = error;
+                best = q;
+            }
+        }
+        return best;
+    }
+
+    // 一个子集（或模式5的颜色/Alpha部分）的编码格式
+    struct SubsetFormat {
+        int firstChannel = 0;
+        int channelCount = 3;
+        int bits[4] = {};               // 每通道端点位数（不含P位）
+        int pbitType = kNoPBit;
+        int indexBits = 2;
+        bool forceOpaque = false;       // 不透明块：P位固定为1，Alpha端点还原为255
+    };
+
+    struct SubsetResult {
+        int endpoints[2][4] = {};
+        int pbits[2] = { 0, 0 };
+        float error = FLT_MAX;
+    };
+
+    struct BC7SearchParams {
+        int refineIterations;
+        bool searchPBits;               // P位逐个组合完整评估（否则按端点量化误差选）
+        int partitionCandidates;        // 双子集模式完整编码的分区数（0：只用单子集模式）
+        bool useMode3;
+        bool allRotations;              // 模式5尝试全部4种通道交换
+        int threeSubsetCandidates;      // 三子集模式（0/2）完整编码的分区数
+        float skipPartitionError;       // 单子集模式的每像素平方误差不超过该值时不再搜索分区
+    };
+
+    BC7SearchParams GetBC7SearchParams(BlockEncodeQuality quality) {
+        switch (quality) {
+        case BlockEncodeQuality::Fast:   return { 0, false, 0, false, false, 0, 0.0f };
+        case BlockEncodeQuality::Normal: return { 1, false, 2, false, false, 0, 8.0f };
+        case BlockEncodeQuality::High:   return { 2, true, 6, true, true, 0, 2.0f };
+        default:                         return { 3, true, 16, true, true, 6, 0.0f };
+        }
+    }
+
+    float PBitError(const float value[4], const SubsetFormat& format, int pbit) {
+        float error = 0.0f;
+        for (int ch = format.firstChannel; ch < format.firstChannel + format.channelCount; ++ch) {
+            const int bits = format.bits[ch];
+            const float diff = (float)ExpandEndpoint(QuantizeEndpoint(value[ch], bits, pbit), bits, pbit) - value[ch];
+            error += diff * diff;
+        }
+        return error;
+    }
+
+    // 量化后的端点生成调色板并选索引，返回mask内的误差
+    float EvaluateQuantized(const PixelBlock& block, uint16_t mask, const SubsetFormat& format,
+                            const int endpoints[2][4], const int pbits[2], uint8_t indices[16]) {
+        const int lastChannel = format.firstChannel + format.channelCount;
+        const int* weights = GetWeights(format.indexBits);
+        int expanded[2][4] = {};
+        for (int k = 0; k < 2; ++k) {
+            const int pbit = format.pbitType == kNoPBit ? -1 : pbits[k];
+            for (int ch = format.firstChannel; ch < lastChannel; ++ch) {
+                expanded[k][ch] = ExpandEndpoint(endpoints[k][ch], format.bits[ch], pbit);
+            }
+        }
+
+        float palette[16][4] = {};
+        const int paletteCount = 1 << format.indexBits;
+        for (int p = 0; p < paletteCount; ++p) {
+            for (int ch = format.firstChannel; ch < lastChannel; ++ch) {
+                palette[p][ch] = (float)Interpolate(expanded[0][ch], expanded[1][ch], weights[p]);
+            }
+        }
+
+        alignas(32) float errors[16];
+        SelectPaletteIndices(block, format.firstChannel, format.channelCount, palette, paletteCount, indices, errors);
+        return SumMasked(errors, mask);
+    }
+
+    // 量化一对浮点端点并评估（P位按格式枚举或估计），比best好时替换best和bestIndices
+    void TryEndpoints(const PixelBlock& block, uint16_t mask, const SubsetFormat& format, const float start[4],
+                      const float end[4], bool searchPBits, SubsetResult& best, uint8_t bestIndices[16]) {
+        int candidates[4][2] = {};
+        int candidateCount = 1;
+        if (format.pbitType == kNoPBit) {
+            candidates[0][0] = candidates[0][1] = -1;
+        } else if (format.forceOpaque) {
+            candidates[0][0] = candidates[0][1] = 1;
+        } else if (searchPBits) {
+            candidateCount = format.pbitType == kSharedPBit ? 2 : 4;
+            for (int i = 0; i < candidateCount; ++i) {
+                candidates[i][0] = format.pbitType == kSharedPBit ? i : (i & 1);
+                candidates[i][1] = format.pbitType == kSharedPBit ? i : (i >> 1);
+            }
+        } else if (format.pbitType == kSharedPBit) {
+            const int pbit = PBitError(start, format, 1) + PBitError(end, format, 1) <
+                             PBitError(start, format, 0) + PBitError(end, format, 0) ? 1 : 0;
+            candidates[0][0] = candidates[0][1] = pbit;
+        } else {
+            candidates[0][0] = PBitError(start, format, 1) < PBitError(start, format, 0) ? 1 : 0;
+            candidates[0][1] = PBitError(end, format, 1) < PBitError(end, format, 0) ? 1 : 0;
+        }
+
+        const float* values[2] = { start, end };
+        for (int c = 0; c < candidateCount; ++c) {
+            SubsetResult candidate;
+            for (int k = 0; k < 2; ++k) {
+                candidate.pbits[k] = std::max(0, candidates[c][k]);
+                for (int ch = format.firstChannel; ch < format.firstChannel + format.channelCount; ++ch) {
+                    candidate.endpoints[k][ch] = QuantizeEndpoint(values[k][ch], format.bits[ch], candidates[c][k]);
+                }
+            }
+            uint8_t indices[16];
+            candidate.error = EvaluateQuantized(block, mask, format, candidate.endpoints, candidate.pbits, indices);
+            if (candidate.error < best.error) {
+                best = candidate;
+                memcpy(bestIndices, indices, 16);
+            }
+        }
+    }
+
+    // 编码mask中的像素：主轴端点 -> 量化 -> 选索引，再按索引最小二乘修正，直到误差不再下降
+    float EncodeSubset(const PixelBlock& block, uint16_t mask, const SubsetFormat& format, const BC7SearchParams& params,
+                       SubsetResult& out, uint8_t indices[16]) {
+        float start[4] = {}, end[4] = {};
+        ComputeAxisEndpoints(block, mask, format.firstChannel, format.channelCount, 255.0f, start, end);
+        out = SubsetResult();
+        TryEndpoints(block, mask, format, start, end, params.searchPBits, out, indices);
+
+        const int* weights = GetWeights(format.indexBits);
+        for (int iteration = 0; iteration < params.refineIterations && out.error > 0.0f; ++iteration) {
+            const float previousError = out.error;
+            if (!SolveEndpoints(block, mask, format.firstChannel, format.channelCount, weights, indices, 255.0f, start, end)) break;
+            TryEndpoints(block, mask, format, start, end, params.searchPBits, out, indices);
+            if (out.error >= previousError) break;
+        }
+        return out.error;
+    }
+
+    // 锚点像素的索引最高位必须为0：否则交换两个端点并反转子集内的全部索引（插值权重对称，解码结果不变）
+    void FixAnchor(uint16_t mask, int anchor, int indexBits, SubsetResult& result, uint8_t indices[16]) {
+        const int maxIndex = (1 << indexBits) - 1;
+        if (indices[anchor] <= (maxIndex >> 1)) return;
+        for (int ch = 0; ch < 4; ++ch) std::swap(result.endpoints[0][ch], result.endpoints[1][ch]);
+        std::swap(result.pbits[0], result.pbits[1]);
+        for (int i = 0; i < 16; ++i) {
+            if (mask & (1 << i)) indices[i] = (uint8_t)(maxIndex - indices[i]);
+        }
+    }
+
+    // 模式0/1/2/3/6/7：颜色（和Alpha）共用一组索引，误差不低于bestError时提前放弃
+    void TryBC7Mode(const PixelBlock& block, int mode, int partition, bool opaque, const BC7SearchParams& params,
+                    BC7Block& best, float& bestError) {
+        const BC7ModeInfo& info = kBC7Modes[mode];
+        SubsetFormat format;
+        format.channelCount = info.alphaBits ? 4 : 3;
+        format.bits[0] = format.bits[1] = format.bits[2] = info.colorBits;
+        format.bits[3] = info.alphaBits;
+        format.pbitType = info.pbitType;
+        format.indexBits = info.indexBits;
+        format.forceOpaque = opaque && info.alphaBits > 0;
+
+        BC7Block candidate;
+        candidate.mode = mode;
+        candidate.partition = partition;
+        float error = 0.0f;
+        for (int subset = 0; subset < info.subsetCount; ++subset) {
+            const uint16_t mask = GetSubsetMask(info.subsetCount, partition, subset);
+            SubsetResult result;
+            uint8_t indices[16];
+            error += EncodeSubset(block, mask, format, params, result, indices);
+            if (error >= bestError) return;
+
+            FixAnchor(mask, GetAnchor(info.subsetCount, partition, subset), info.indexBits, result, indices);
+            memcpy(candidate.endpoints[subset], result.endpoints, sizeof(result.endpoints));
+            candidate.pbits[subset][0] = result.pbits[0];
+            candidate.pbits[subset][1] = result.pbits[1];
+            for (int i = 0; i < 16; ++i) {
+                if (mask & (1 << i)) candidate.indices[i] = indices[i];
+            }
+        }
+        best = candidate;
+        bestError = error;
+    }
+
+    // 模式5：RGB 7位与Alpha 8位各用一组2位索引；rotation把某个颜色通道换到独立的Alpha位置
+    void TryBC7Mode5(const PixelBlock& block, int rotation, const BC7SearchParams& params, BC7Block& best, float& bestError) {
+        PixelBlock rotated = block;
+        if (rotation > 0) {
+            std::swap(rotated.c[rotation - 1], rotated.c[3]);
+        }
+
+        SubsetFormat colorFormat;
+        colorFormat.bits[0] = colorFormat.bits[1] = colorFormat.bits[2] = 7;
+        SubsetFormat alphaFormat;
+        alphaFormat.firstChannel = 3;
+        alphaFormat.channelCount = 1;
+        alphaFormat.bits[3] = 8;
+
+        SubsetResult color, alpha;
+        uint8_t colorIndices[16], alphaIndices[16];
+        float error = EncodeSubset(rotated, 0xFFFF, colorFormat, params, color, colorIndices);
+        if (error >= bestError) return;
+        error += EncodeSubset(rotated, 0xFFFF, alphaFormat, params, alpha, alphaIndices);
+        if (error >= bestError) return;
+
+        FixAnchor(0xFFFF, 0, 2, color, colorIndices);
+        FixAnchor(0xFFFF, 0, 2, alpha, alphaIndices);
+        BC7Block candidate;
+        candidate.mode = 5;
+        candidate.rotation = rotation;
+        for (int k = 0; k < 2; ++k) {
+            for (int ch = 0; ch < 3; ++ch) candidate.endpoints[0][k][ch] = color.endpoints[k][ch];
+            candidate.endpoints[0][k][3] = alpha.endpoints[k][3];
+        }
+        memcpy(candidate.indices, colorIndices, 16);
+        memcpy(candidate.secondaryIndices, alphaIndices, 16);
+        best = candidate;
+        bestError = error;
+    }
+
+    // ========== BC6H ==========
+
+    // 半精度位模式 <-> float：BC6H UF16只有非负有限值
+    float HalfToFloat(uint16_t half) {
+        const uint32_t exponent = (half >> 10) & 0x1F;
+        uint32_t mantissa = half & 0x3FF;
+        uint32_t bits;
+        if (exponent == 0) {
+            if (mantissa == 0) {
+                bits = 0;
+            } else {
+                // 非规格化数：规格化尾数
+                uint32_t e = 113;
+                while (!(mantissa & 0x400)) {
+                    mantissa <<= 1;
+                    --e;
+                }
+                bits = (e << 23) | ((mantissa & 0x3FF) << 13);
+            }
+        } else if (exponent == 31) {
+            bits = 0x7F800000 | (mantissa << 13);
+        } else {
+            bits = ((exponent + 112) << 23) | (mantissa << 13);
+        }
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // 负值和NaN按0，超出范围按最大有限值65504（0x7BFF）
+    uint16_t FloatToHalf(float value) {
+        if (!(value > 0.0f)) return 0;
+        if (value >= 65504.0f) return 0x7BFF;
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        if (bits < 0x38800000) {
+            // 非规格化的半精度数
+            const uint32_t shift = 113 - (bits >> 23);
+            if (shift > 24) return 0;
+            bits = (0x800000 | (bits & 0x7FFFFF)) >> shift;
+        } else {
+            bits += 0xC8000000;     // 指数偏移从127改为15
+        }
+        return (uint16_t)(((bits + 0x0FFF + ((bits >> 13) & 1)) >> 13) & 0x7FFF);
+    }
+
+    constexpr float kMaxHalfBits = 31743.0f;    // 0x7BFF
+
+    struct BC6HModeInfo {
+        uint8_t modeValue;      // 块头的模式位
+        uint8_t modeBits;       // 2或5
+        uint8_t regionCount;
+        bool transformed;       // X/Y/Z存为相对W的有符号差值
+        uint8_t indexBits;
+        uint8_t endpointBits;   // 端点精度（W的位数）
+        uint8_t deltaBits[3];   // X/Y/Z每通道的存储位数
+    };
+
+    // 下标0~13对应规范中的模式1~14
+    const BC6HModeInfo kBC6HModes[14] = {
+        { 0x00, 2, 2, true,  3, 10, { 5, 5, 5 } },
+        { 0x01, 2, 2, true,  3, 7,  { 6, 6, 6 } },
+        { 0x02, 5, 2, true,  3, 11, { 5, 4, 4 } },
+        { 0x06, 5, 2, true,  3, 11, { 4, 5, 4 } },
+        { 0x0A, 5, 2, true,  3, 11, { 4, 4, 5 } },
+        { 0x0E, 5, 2, true,  3, 9,  { 5, 5, 5 } },
+        { 0x12, 5, 2, true,  3, 8,  { 6, 5, 5 } },
+        { 0x16, 5, 2, true,  3, 8,  { 5, 6, 5 } },
+        { 0x1A, 5, 2, true,  3, 8,  { 5, 5, 6 } },
+        { 0x1E, 5, 2, false, 3, 6,  { 6, 6, 6 } },
+        { 0x03, 5, 1, false, 4, 10, { 10, 10, 10 } },
+        { 0x07, 5, 1, true,  4, 11, { 9, 9, 9 } },
+        { 0x0B, 5, 1, true,  4, 12, { 8, 8, 8 } },
+        { 0x0F, 5, 1, true,  4, 16, { 4, 4, 4 } },
+    };
+
+    constexpr int kBC6HRawSingleRegionMode = 10;    // 模式11：10位端点，不做差值，总能表示
+
+    // 块头字段：端点（W/X/Y/Z = 区域0起点/终点、区域1起点/终点）| 通道，或分区号
+    enum : uint8_t { kR = 0, kG = 1, kB = 2, kW = 0, kX = 4, kY = 8, kZ = 12, kShape = 16 };
+
+    // 块头中紧接模式位的一段连续位：字段的第firstBit位起count位，从低到高
+    struct BC6HBitRun {
+        uint8_t field;
+        uint8_t firstBit;
+        uint8_t count;          // 0：结束
+    };
+
+    const BC6HBitRun kBC6HLayouts[14][25] = {
+        // 模式1 (0x00) - 10 5 5 5
+        {
+            { kY | kG, 4, 1 }, { kY | kB, 4, 1 }, { kZ | kB, 4, 1 }, { kW | kR, 0, 10 }, { kW | kG, 0, 10 },
+            { kW | kB, 0, 10 }, { kX | kR, 0, 5 }, { kZ | kG, 4, 1 }, { kY | kG, 0, 4 }, { kX | kG, 0, 5 },
+            { kZ | kB, 0, 1 }, { kZ | kG, 0, 4 }, { kX | kB, 0, 5 }, { kZ | kB, 1, 1 }, { kY | kB, 0, 4 },
+            { kY | kR, 0, 5 }, { kZ | kB, 2, 1 }, { kZ | kR, 0, 5 }, { kZ | kB, 3, 1 }, { kShape, 0, 5 },
+        },
+        // 模式2 (0x01) - 7 6 6 6
+        {
+            { kY | kG, 5, 1 }, { kZ | kG, 4, 2 }, { kW | kR, 0, 7 }, { kZ | kB, 0, 2 }, { kY | kB, 4, 1 },
+            { kW | kG, 0, 7 }, { kY | kB, 5, 1 }, { kZ | kB, 2, 1 }, { kY | kG, 4, 1 }, { kW | kB, 0, 7 },
+            { kZ | kB, 3, 1 }, { kZ | kB, 5, 1 }, { kZ | kB, 4, 1 }, { kX | kR, 0, 6 }, { kY | kG, 0, 4 },
+            { kX | kG, 0, 6 }, { kZ | kG, 0, 4 }, { kX | kB, 0, 6 }, { kY | kB, 0, 4 }, { kY | kR, 0, 6 },
+            { kZ | kR, 0, 6 }, { kShape, 0, 5 },
+        },
+        // 模式3 (0x02) - 11 5 4 4
+        {
+            { kW | kR, 0, 10 }, { kW | kG, 0, 10 }, { kW | kB, 0, 10 }, { kX | kR, 0, 5 }, { kW | kR, 10, 1 },
+            { kY | kG, 0, 4 }, { kX | kG, 0, 4 }, { kW | kG, 10, 1 }, { kZ | kB, 0, 1 }, { kZ | kG, 0, 4 },
+            { kX | kB, 0, 4 }, { kW | kB, 10, 1 }, { kZ | kB, 1, 1 }, { kY | kB, 0, 4 }, { kY | kR, 0, 5 },
+            { kZ | kB, 2, 1 }, { kZ | kR, 0, 5 }, { kZ | kB, 3, 1 }, { kShape, 0, 5 },
+        },
+        // 模式4 (0x06) - 11 4 5 4
+        {
+            { kW | kR, 0, 10 }, { kW | kG, 0, 10 }, { kW | kB, 0, 10 }, { kX | kR, 0, 4 }, { kW | kR, 10, 1 },
+            { kZ | kG, 4, 1 }, { kY | kG, 0, 4 }, { kX | kG, 0, 5 }, { kW | kG, 10, 1 }, { kZ | kG, 0, 4 },
+            { kX | kB, 0, 4 }, { kW | kB, 10, 1 }, { kZ | kB, 1, 1 }, { kY | kB, 0, 4 }, { kY | kR, 0, 4 },
+            { kZ | kB, 0, 1 }, { kZ | kB, 2, 1 }, { kZ | kR, 0, 4 }, { kY | kG, 4, 1 }, { kZ | kB, 3, 1 },
+            { kShape, 0, 5 },
+        },
+        // 模式5 (0x0a) - 11 4 4 5
+        {
+            { kW | kR, 0, 10 }, { kW | kG, 0, 10 }, { kW | kB, 0, 10 }, { kX | kR, 0, 4 }, { kW | kR, 10, 1 },
+            { kY | kB, 4, 1 }, { kY | kG, 0, 4 }, { kX | kG, 0, 4 }, { kW | kG, 10, 1 }, { kZ | kB, 0, 1 },
+            { kZ | kG, 0, 4 }, { kX | kB, 0, 5 }, { kW | kB, 10, 1 }, { kY | kB, 0, 4 }, { kY | kR, 0, 4 },
+            { kZ | kB, 1, 2 }, { kZ | kR, 0, 4 }, { kZ | kB, 4, 1 }, { kZ | kB, 3, 1 }, { kShape, 0, 5 },
+        },
+        // 模式6 (0x0e) - 9 5 5 5
+        {
+            { kW | kR, 0, 9 }, { kY | kB, 4, 1 }, { kW | kG, 0, 9 }, { kY | kG, 4, 1 }, { kW | kB, 0, 9 },
+            { kZ | kB, 4, 1 }, { kX | kR, 0, 5 }, { kZ | kG, 4, 1 }, { kY | kG, 0, 4 }, { kX | kG, 0, 5 },
+            { kZ | kB, 0, 1 }, { kZ | kG, 0, 4 }, { kX | kB, 0, 5 }, { kZ | kB, 1, 1 }, { kY | kB, 0, 4 },
+            { kY | kR, 0, 5 }, { kZ | kB, 2, 1 }, { kZ | kR, 0, 5 }, { kZ | kB, 3, 1 }, { kShape, 0, 5 },
+        },
+        // 模式7 (0x12) - 8 6 5 5
+        {
+            { kW | kR, 0, 8 }, { kZ | kG, 4, 1 }, { kY | kB, 4, 1 }, { kW | kG, 0, 8 }, { kZ | kB, 2, 1 },
+            { kY | kG, 4, 1 }, { kW | kB, 0, 8 }, { kZ | kB, 3, 2 }, { kX | kR, 0, 6 }, { kY | kG, 0, 4 },
+            { kX | kG, 0, 5 }, { kZ | kB, 0, 1 }, { kZ | kG, 0, 4 }, { kX | kB, 0, 5 }, { kZ | kB, 1, 1 },
+            { kY | kB, 0, 4 }, { kY | kR, 0, 6 }, { kZ | kR, 0, 6 }, { kShape, 0, 5 },
+        },
+        // 模式8 (0x16) - 8 5 6 5
+        {
+            { kW | kR, 0, 8 }, { kZ | kB, 0, 1 }, { kY | kB, 4, 1 }, { kW | kG, 0, 8 }, { kY | kG, 5, 1 },
+            { kY | kG, 4, 1 }, { kW | kB, 0, 8 }, { kZ | kG, 5, 1 }, { kZ | kB, 4, 1 }, { kX | kR, 0, 5 },
+            { kZ | kG, 4, 1 }, { kY | kG, 0, 4 }, { kX | kG, 0, 6 }, { kZ | kG, 0, 4 }, { kX | kB, 0, 5 },
+            { kZ | kB, 1, 1 }, { kY | kB, 0, 4 }, { kY | kR, 0, 5 }, { kZ | kB, 2, 1 }, { kZ | kR, 0, 5 },
+            { kZ | kB, 3, 1 }, { kShape, 0, 5 },
+        },
+        // 模式9 (0x1a) - 8 5 5 6
+        {
+            { kW | kR, 0, 8 }, { kZ | kB, 1, 1 }, { kY | kB, 4, 1 }, { kW | kG, 0, 8 }, { kY | kB, 5, 1 },
+            { kY | kG, 4, 1 }, { kW | kB, 0, 8 }, { kZ | kB, 5, 1 }, { kZ | kB, 4, 1 }, { kX | kR, 0, 5 },
+            { kZ | kG, 4, 1 }, { kY | kG, 0, 4 }, { kX | kG, 0, 5 }, { kZ | kB, 0, 1 }, { kZ | kG, 0, 4 },
+            { kX | kB, 0, 6 }, { kY | kB, 0, 4 }, { kY | kR, 0, 5 }, { kZ | kB, 2, 1 }, { kZ | kR, 0, 5 },
+            { kZ | kB, 3, 1 }, { kShape, 0, 5 },
+        },
+        // 模式10 (0x1e) - 6 6 6 6
+        {
+            { kW | kR, 0, 6 }, { kZ | kG, 4, 1 }, { kZ | kB, 0, 2 }, { kY | kB, 4, 1 }, { kW | kG, 0, 6 },
+            { kY | kG, 5, 1 }, { kY | kB, 5, 1 }, { kZ | kB, 2, 1 }, { kY | kG, 4, 1 }, { kW | kB, 0, 6 },
+            { kZ | kG, 5, 1 }, { kZ | kB, 3, 1 }, { kZ | kB, 5, 1 }, { kZ | kB, 4, 1 }, { kX | kR, 0, 6 },
+            { kY | kG, 0, 4 }, { kX | kG, 0, 6 }, { kZ | kG, 0, 4 }, { kX | kB, 0, 6 }, { kY | kB, 0, 4 },
+            { kY | kR, 0, 6 }, { kZ | kR, 0, 6 }, { kShape, 0, 5 },
+        },
+        // 模式11 (0x03) - 10 10
+        {
+            { kW | kR, 0, 10 }, { kW | kG, 0, 10 }, { kW | kB, 0, 10 }, { kX | kR, 0, 10 }, { kX | kG, 0, 10 },
+            { kX | kB, 0, 10 },
+        },
+        // 模式12 (0x07) - 11 9
+        {
+            { kW | kR, 0, 10 }, { kW | kG, 0, 10 }, { kW | kB, 0, 10 }, { kX | kR, 0, 9 }, { kW | kR, 10, 1 },
+            { kX | kG, 0, 9 }, { kW | kG, 10, 1 }, { kX | kB, 0, 9 }, { kW | kB, 10, 1 },
+        },
+        // 模式13 (0x0b) - 12 8
+        {
+            { kW | kR, 0, 10 }, { kW | kG, 0, 10 }, { kW | kB, 0, 10 }, { kX | kR, 0, 8 }, { kW | kR, 11, 1 },
+            { kW | kR, 10, 1 }, { kX | kG, 0, 8 }, { kW | kG, 11, 1 }, { kW | kG, 10, 1 }, { kX | kB, 0, 8 },
+            { kW | kB, 11, 1 }, { kW | kB, 10, 1 },
+        },
+        // 模式14 (0x0f) - 16 4
+        {
+            { kW | kR, 0, 10 }, { kW | kG, 0, 10 }, { kW | kB, 0, 10 }, { kX | kR, 0, 4 }, { kW | kR, 15, 1 },
+            { kW | kR, 14, 1 }, { kW | kR, 13, 1 }, { kW | kR, 12, 1 }, { kW | kR, 11, 1 }, { kW | kR, 10, 1 },
+            { kX | kG, 0, 4 }, { kW | kG, 15, 1 }, { kW | kG, 14, 1 }, { kW | kG, 13, 1 }, { kW | kG, 12, 1 },
+            { kW | kG, 11, 1 }, { kW | kG, 10, 1 }, { kX | kB, 0, 4 }, { kW | kB, 15, 1 }, { kW | kB, 14, 1 },
+            { kW | kB, 13, 1 }, { kW | kB, 12, 1 }, { kW | kB, 11, 1 }, { kW | kB, 10, 1 },
+        },
+    };
+
+    struct BC6HBlock {
+        int mode = kBC6HRawSingleRegionMode;
+        int shape = 0;
+        int endpoints[4][3] = {};       // W X Y Z，量化值（差值变换之前）
+        uint8_t indices[16] = {};
+    };
+
+    void WriteBC6HBlock(const BC6HBlock& block, uint8_t out[16]) {
+        const BC6HModeInfo& info = kBC6HModes[block.mode];
+        int fields[4][3];
+        for (int e = 0; e < 4; ++e) {
+            for (int ch = 0; ch < 3; ++ch) {
+                fields[e][ch] = block.endpoints[e][ch];
+                if (info.transformed && e > 0) {
+                    fields[e][ch] = (fields[e][ch] - block.endpoints[0][ch]) & ((1 << info.deltaBits[ch]) - 1);
+                }
+            }
+        }
+
+        BlockBits bits;
+        bits.Write(info.modeValue, info.modeBits);
+        for (const BC6HBitRun* run = kBC6HLayouts[block.mode]; run->count; ++run) {
+            const int value = run->field == kShape ? block.shape : fields[run->field >> 2][run->field & 3];
+            bits.Write((uint32_t)value >> run->firstBit, run->count);
+        }
+        for (int i = 0; i < 16; ++i) {
+            bits.Write(block.indices[i], info.indexBits - (IsAnchor(info.regionCount, block.shape, i) ? 1 : 0));
+        }
+        bits.Store(out);
+    }
+
+    bool ReadBC6HBlock(const uint8_t in[16], BC6HBlock& block) {
+        BlockBits bits(in);
+        uint32_t modeValue = bits.Read(2);
+        if (modeValue > 1) {
+            modeValue |= bits.Read(3) << 2;
+        }
+        int mode = -1;
+        for (int m = 0; m < 14; ++m) {
+            if (kBC6HModes[m].modeValue == modeValue) mode = m;
+        }
+        if (mode < 0) return false;     // 保留的模式
+
+        const BC6HModeInfo& info = kBC6HModes[mode];
+        int fields[4][3] = {};
+        int shape = 0;
+        for (const BC6HBitRun* run = kBC6HLayouts[mode]; run->count; ++run) {
+            const int value = (int)(bits.Read(run->count) << run->firstBit);
+            if (run->field == kShape) {
+                shape |= value;
+            } else {
+                fields[run->field >> 2][run->field & 3] |= value;
+            }
+        }
+
+        block.mode = mode;
+        block.shape = shape;
+        const int endpointMask = (1 << info.endpointBits) - 1;
+        for (int e = 0; e < 4; ++e) {
+            for (int ch = 0; ch < 3; ++ch) {
+                int value = fields[e][ch];
+                if (info.transformed && e > 0) {
+                    // 差值按符号扩展后加到W上，结果按端点精度回绕
+                    const int deltaBits = info.deltaBits[ch];
+                    if (value & (1 << (deltaBits - 1))) value -= 1 << deltaBits;
+                    value = (fields[0][ch] + value) & endpointMask;
+                }
+                block.endpoints[e][ch] = value;
+            }
+        }
+        for (int i = 0; i < 16; ++i) {
+            block.indices[i] = (uint8_t)bits.Read(info.indexBits - (IsAnchor(info.regionCount, shape, i) ? 1 : 0));
+        }
+        return true;
+    }
+
+    int UnquantizeBC6H(int value, int bits) {
+        if (bits >= 15) return value;
+        if (value == 0) return 0;
+        if (value == (1 << bits) - 1) return 0xFFFF;
+        return ((value << 16) + 0x8000) >> bits;
+    }
+
+    // 插值结果缩放到半精度位模式（无符号：乘31/64）
+    int FinishUnquantizeBC6H(int value) {
+        return (value * 31) >> 6;
+    }
+
+    // 半精度位模式空间的值 -> bits位端点，取还原后最接近的量化值
+    int QuantizeBC6H(float value, int bits) {
+        const int maxValue = (1 << bits) - 1;
+        const float unquantized = value * 64.0f / 31.0f;
+        const int guess = bits >= 15 ? (int)(unquantized + 0.5f)
+                                     : (int)std::floor(unquantized * (float)(1 << bits) / 65536.0f);
+
+        int best = 0;
+        float bestError = FLT_MAX;
+        for (int q = std::max(0, guess - 1); q <= std::min(maxValue, guess + 1); ++q) {
+            const float error = std::fabs((float)FinishUnquantizeBC6H(UnquantizeBC6H(q, bits)) - value);
+            if (error < bestError) {
+                bestError = error;
+                best = q;
+            }
+        }
+        return best;
+    }
+
+    struct BC6HSearchParams {
+        int refineIterations;
+        bool allSingleRegionModes;      // false时只用模式11
+        int shapeCandidates;            // 双区域模式完整编码的分区数（0：只用单区域模式）
+        bool allTwoRegionModes;         // false时只用精度分布均匀的模式1/2/6/10
+    };
+
+    BC6HSearchParams GetBC6HSearchParams(BlockEncodeQuality quality) {
+        switch (quality) {
+        case BlockEncodeQuality::Fast:   return { 0, false, 0, false };
+        case BlockEncodeQuality::Normal: return { 1, true, 0, false };
+        case BlockEncodeQuality::High:   return { 2, true, 4, false };
+        default:                         return { 3, true, 8, true };
+        }
+    }
+
+    // 量化端点生成调色板并选索引，返回区域内误差（半精度位模式空间）
+    float EvaluateBC6HRegion(const PixelBlock& block, uint16_t mask, const BC6HModeInfo& info,
+                             const int endpoints[2][3], uint8_t indices[16]) {
+        const int* weights = GetWeights(info.indexBits);
+        int a[3], b[3];
+        for (int ch = 0; ch < 3; ++ch) {
+            a[ch] = UnquantizeBC6H(endpoints[0][ch], info.endpointBits);
+            b[ch] = UnquantizeBC6H(endpoints[1][ch], info.endpointBits);
+        }
+
+        float palette[16][4] = {};
+        const int paletteCount = 1 << info.indexBits;
+        for (int p = 0; p < paletteCount; ++p) {
+            for (int ch = 0; ch < 3; ++ch) {
+                palette[p][ch] = (float)FinishUnquantizeBC6H(Interpolate(a[ch], b[ch], weights[p]));
+            }
+        }
+
+        alignas(32) float errors[16];
+        SelectPaletteIndices(block, 0, 3, palette, paletteCount, indices, errors);
+        return SumMasked(errors, mask);
+    }
+
+    // 差值变换的模式：X/Y/Z相对W的差值必须能用有符号的deltaBits位表示
+    bool DeltasFit(const BC6HBlock& block, const BC6HModeInfo& info) {
+        for (int e = 1; e < info.regionCount * 2; ++e) {
+            for (int ch = 0; ch < 3; ++ch) {
+                const int delta = block.endpoints[e][ch] - block.endpoints[0][ch];
+                const int limit = 1 << (info.deltaBits[ch] - 1);
+                if (delta < -limit || delta >= limit) return false;
+            }
+        }
+        return true;
+    }
+
+    // 用一种模式编码：initial为每个区域的浮点端点，量化后按索引最小二乘修正；差值放不下时放弃这个模式
+    void TryBC6HMode(const PixelBlock& block, int mode, int shape, const float initial[2][2][4], int refineIterations,
+                     BC6HBlock& best, float& bestError) {
+        const BC6HModeInfo& info = kBC6HModes[mode];
+        const int* weights = GetWeights(info.indexBits);
+        const int maxIndex = (1 << info.indexBits) - 1;
+
+        BC6HBlock candidate;
+        candidate.mode = mode;
+        candidate.shape = shape;
+        float error = 0.0f;
+        for (int region = 0; region < info.regionCount; ++region) {
+            const uint16_t mask = info.regionCount == 1 ? (uint16_t)0xFFFF : GetSubsetMask(2, shape, region);
+            float start[4], end[4];
+            memcpy(start, initial[region][0], sizeof(start));
+            memcpy(end, initial[region][1], sizeof(end));
+
+            int endpoints[2][3];
+            for (int ch = 0; ch < 3; ++ch) {
+                endpoints[0][ch] = QuantizeBC6H(start[ch], info.endpointBits);
+                endpoints[1][ch] = QuantizeBC6H(end[ch], info.endpointBits);
+            }
+            uint8_t indices[16];
+            float regionError = EvaluateBC6HRegion(block, mask, info, endpoints, indices);
+
+            for (int iteration = 0; iteration < refineIterations && regionError > 0.0f; ++iteration) {
+                if (!SolveEndpoints(block, mask, 0, 3, weights, indices, kMaxHalfBits, start, end)) break;
+                int refined[2][3];
+                for (int ch = 0; ch < 3; ++ch) {
+                    refined[0][ch] = QuantizeBC6H(start[ch], info.endpointBits);
+                    refined[1][ch] = QuantizeBC6H(end[ch], info.endpointBits);
+                }
+                uint8_t refinedIndices[16];
+                const float refinedError = EvaluateBC6HRegion(block, mask, info, refined, refinedIndices);
+                if (refinedError >= regionError) break;
+                regionError = refinedError;
+                memcpy(endpoints, refined, sizeof(endpoints));
+                memcpy(indices, refinedIndices, sizeof(indices));
+            }
+
+            error += regionError;
+            if (error >= bestError) return;
+
+            // 锚点索引最高位为0（与BC7相同，交换端点不改变解码结果）
+            if (indices[GetAnchor(info.regionCount, shape, region)] > (maxIndex >> 1)) {
+                for (int ch = 0; ch < 3; ++ch) std::swap(endpoints[0][ch], endpoints[1][ch]);
+                for (int i = 0; i < 16; ++i) {
+                    if (mask & (1 << i)) indices[i] = (uint8_t)(maxIndex - indices[i]);
+                }
+            }
+            memcpy(candidate.endpoints[region * 2], endpoints, sizeof(endpoints));
+            for (int i = 0; i < 16; ++i) {
+                if (mask & (1 << i)) candidate.indices[i] = indices[i];
+            }
+        }
+
+        if (info.transformed && !DeltasFit(candidate, info)) return;
+        best = candidate;
+        bestError = error;
+    }
+}
+
+// ========== BC7 ==========
+
+void EncodeBC7Block(const uint8_t rgba[64], BlockEncodeQuality quality, uint8_t out[16]) {
+    PixelBlock block;
+    bool opaque = true;
+    for (int i = 0; i < 16; ++i) {
+        for (int ch = 0; ch < 4; ++ch) block.c[ch][i] = rgba[i * 4 + ch];
+        opaque = opaque && rgba[i * 4 + 3] == 255;
+    }
+    const BC7SearchParams params = GetBC7SearchParams(quality);
+
+    // 模式6（单子集、4位索引）适合大多数块，先得到一个误差上限，后面的模式超过它就提前放弃
+    BC7Block best;
+    float bestError = FLT_MAX;
+    TryBC7Mode(block, 6, 0, opaque, params, best, bestError);
+
+    if (!opaque && params.partitionCandidates > 0) {
+        const int rotationCount = params.allRotations ? 4 : 1;
+        for (int rotation = 0; rotation < rotationCount && bestError > 0.0f; ++rotation) {
+            TryBC7Mode5(block, rotation, params, best, bestError);
+        }
+    }
+
+    if (params.partitionCandidates > 0 && bestError > params.skipPartitionError * 16.0f) {
+        float estimates[64];
+        int order[64];
+        EstimatePartitionErrors(block, opaque ? 3 : 4, 2, 64, estimates);
+        SortPartitions(estimates, 64, order);
+        for (int k = 0; k < params.partitionCandidates && bestError > 0.0f; ++k) {
+            if (opaque) {
+                TryBC7Mode(block, 1, order[k], opaque, params, best, bestError);
+                if (params.useMode3) TryBC7Mode(block, 3, order[k], opaque, params, best, bestError);
+            } else {
+                TryBC7Mode(block, 7, order[k], opaque, params, best, bestError);
+            }
+        }
+
+        // 三子集模式只用于不透明块；模式0只有前16种分区
+        if (opaque && params.threeSubsetCandidates > 0 && bestError > 0.0f) {
+            EstimatePartitionErrors(block, 3, 3, 64, estimates);
+            SortPartitions(estimates, 64, order);
+            for (int k = 0; k < params.threeSubsetCandidates && bestError > 0.0f; ++k) {
+                TryBC7Mode(block, 2, order[k], opaque, params, best, bestError);
+            }
+            SortPartitions(estimates, 16, order);
+            for (int k = 0; k < params.threeSubsetCandidates && bestError > 0.0f; ++k) {
+                TryBC7Mode(block, 0, order[k], opaque, params, best, bestError);
+            }
+        }
+    }
+
+    WriteBC7Block(best, out);
+}
+
+void DecodeBC7Block(const uint8_t in[16], uint8_t outRGBA[64]) {
+    BC7Block block;
+    if (!ReadBC7Block(in, block)) {
+        memset(outRGBA, 0, 64);
+        return;
+    }
+
+    const BC7ModeInfo& info = kBC7Modes[block.mode];
+    int endpoints[3][2][4];
+    for (int subset = 0; subset < info.subsetCount; ++subset) {
+        for (int k = 0; k < 2; ++k) {
+            const int pbit = info.pbitType == kNoPBit ? -1 : block.pbits[subset][k];
+            for (int ch = 0; ch < 3; ++ch) {
+                endpoints[subset][k][ch] = ExpandEndpoint(block.endpoints[subset][k][ch], info.colorBits, pbit);
+            }
+            endpoints[subset][k][3] = info.alphaBits ? ExpandEndpoint(block.endpoints[subset][k][3], info.alphaBits, pbit) : 255;
+        }
+    }
+
+    for (int i = 0; i < 16; ++i) {
+        const int subset = GetSubset(info.subsetCount, block.partition, i);
+        int colorIndex = block.indices[i], colorBits = info.indexBits;
+        int alphaIndex = block.indices[i], alphaBits = info.indexBits;
+        if (info.secondaryIndexBits) {
+            if (block.indexSelection) {
+                colorIndex = block.secondaryIndices[i];
+                colorBits = info.secondaryIndexBits;
+            } else {
+                alphaIndex = block.secondaryIndices[i];
+                alphaBits = info.secondaryIndexBits;
+            }
+        }
+
+        int pixel[4];
+        const int colorWeight = GetWeights(colorBits)[colorIndex];
+        for (int ch = 0; ch < 3; ++ch) {
+            pixel[ch] = Interpolate(endpoints[subset][0][ch], endpoints[subset][1][ch], colorWeight);
+        }
+        pixel[3] = Interpolate(endpoints[subset][0][3], endpoints[subset][1][3], GetWeights(alphaBits)[alphaIndex]);
+        if (block.rotation > 0) {
+            std::swap(pixel[block.rotation - 1], pixel[3]);
+        }
+        for (int ch = 0; ch < 4; ++ch) outRGBA[i * 4 + ch] = (uint8_t)pixel[ch];
+    }
+}
+
+// ========== BC6H ==========
+
+void EncodeBC6HBlock(const float rgba[64], BlockEncodeQuality quality, uint8_t out[16]) {
+    // 在半精度位模式空间里拟合：与解码器的插值空间一致，误差近似相对误差
+    PixelBlock block;
+    for (int i = 0; i < 16; ++i) {
+        for (int ch = 0; ch < 3; ++ch) block.c[ch][i] = (float)FloatToHalf(rgba[i * 4 + ch]);
+        block.c[3][i] = 0.0f;
+    }
+    const BC6HSearchParams params = GetBC6HSearchParams(quality);
+
+    BC6HBlock best;
+    float bestError = FLT_MAX;
+    float initial[2][2][4] = {};
+    ComputeAxisEndpoints(block, 0xFFFF, 0, 3, kMaxHalfBits, initial[0][0], initial[0][1]);
+    TryBC6HMode(block, kBC6HRawSingleRegionMode, 0, initial, params.refineIterations, best, bestError);
+    if (params.allSingleRegionModes) {
+        for (int mode = kBC6HRawSingleRegionMode + 1; mode < 14 && bestError > 0.0f; ++mode) {
+            TryBC6HMode(block, mode, 0, initial, params.refineIterations, best, bestError);
+        }
+    }
+
+    if (params.shapeCandidates > 0 && bestError > 0.0f) {
+        static const int kUniformTwoRegionModes[4] = { 9, 0, 1, 5 };
+        float estimates[64];
+        int order[64];
+        EstimatePartitionErrors(block, 3, 2, 32, estimates);
+        SortPartitions(estimates, 32, order);
+        for (int k = 0; k < params.shapeCandidates && bestError > 0.0f; ++k) {
+            const int shape = order[k];
+            for (int region = 0; region < 2; ++region) {
+                ComputeAxisEndpoints(block, GetSubsetMask(2, shape, region), 0, 3, kMaxHalfBits,
+                                     initial[region][0], initial[region][1]);
+            }
+            const int modeCount = params.allTwoRegionModes ? 10 : 4;
+            for (int m = 0; m < modeCount && bestError > 0.0f; ++m) {
+                const int mode = params.allTwoRegionModes ? m : kUniformTwoRegionModes[m];
+                TryBC6HMode(block, mode, shape, initial, params.refineIterations, best, bestError);
+            }
+        }
+    }
+
+    WriteBC6HBlock(best, out);
+}
+
+void DecodeBC6HBlock(const uint8_t in[16], float outRGBA[64]) {
+    BC6HBlock block;
+    if (!ReadBC6HBlock(in, block)) {
+        // 规范要求保留模式解码为不透明黑
+        for (int i = 0; i < 16; ++i) {
+            outRGBA[i * 4 + 0] = outRGBA[i * 4 + 1] = outRGBA[i * 4 + 2] = 0.0f;
+            outRGBA[i * 4 + 3] = 1.0f;
+        }
+        return;
+    }
+
+    const BC6HModeInfo& info = kBC6HModes[block.mode];
+    const int* weights = GetWeights(info.indexBits);
+    for (int i = 0; i < 16; ++i) {
+        const int region = GetSubset(info.regionCount, block.shape, i);
+        const int weight = weights[block.indices[i]];
+        for (int ch = 0; ch < 3; ++ch) {
+            const int a = UnquantizeBC6H(block.endpoints[region * 2][ch], info.endpointBits);
+            const int b = UnquantizeBC6H(block.endpoints[region * 2 + 1][ch], info.endpointBits);
+            outRGBA[i * 4 + ch] = HalfToFloat((uint16_t)FinishUnquantizeBC6H(Interpolate(a, b, weight)));
+        }
+        outRGBA[i * 4 + 3] = 1.0f;
+    }
+}
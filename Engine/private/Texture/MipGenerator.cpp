@@ -0,0 +1,386 @@
+// MipGenerator.cpp
+// mip链生成实现：每级先水平后垂直两遍可分离滤波（权重按输出位置预先算好），两遍都按行块并行
+// 水平一遍每像素一个float4（SSE2）；垂直一遍按整行连续的浮点数累加（AVX2一次8个、SSE2一次4个）
+// 各条路径的乘加顺序相同，结果与指令集和线程数无关
+
+#include "public/Texture/MipGenerator.h"
+#include "public/ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MIP_SIMD_AVX2 1
+#define MIP_SIMD_SSE2 1
+#elif defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MIP_SIMD_SSE2 1
+#endif
+
+namespace {
+    // 每个任务处理的行数；像素少于kMinPixelsPerThread * 线程数时减少线程
+    constexpr uint32_t kRowsPerTask = 16;
+    constexpr size_t kMinPixelsPerThread = 32 * 1024;
+
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr float kWindowedFilterRadius = 3.0f;   // Kaiser/Lanczos的半径（以输出像素为单位）
+    constexpr double kKaiserAlpha = 4.0;
+
+    unsigned int GetThreadCount(size_t pixelCount, unsigned int settingsMaxThreads) {
+        unsigned int maxThreads = (unsigned int)std::max<size_t>(1, pixelCount / kMinPixelsPerThread);
+        if (settingsMaxThreads > 0) {
+            maxThreads = std::min(maxThreads, settingsMaxThreads);
+        }
+        return maxThreads;
+    }
+
+    // 按kRowsPerTask行一组分给ParallelFor，func(rowBegin, rowEnd)
+    template <typename Func>
+    void ForEachRowBand(uint32_t rowCount, size_t pixelCount, unsigned int maxThreads, Func func) {
+        const uint32_t bandCount = (rowCount + kRowsPerTask - 1) / kRowsPerTask;
+        ParallelFor(bandCount, [&](size_t band) {
+            const uint32_t rowBegin = (uint32_t)band * kRowsPerTask;
+            func(rowBegin, std::min(rowCount, rowBegin + kRowsPerTask));
+        }, GetThreadCount(pixelCount, maxThreads));
+    }
+
+    // ========== 滤波器 ==========
+
+    double Sinc(double x) {
+        if (std::fabs(x) < 1e-8) return 1.0;
+        return std::sin(kPi * x) / (kPi * x);
+    }
+
+    // 第一类零阶修正贝塞尔函数（级数展开）
+    double BesselI0(double x) {
+        double sum = 1.0, term = 1.0;
+        const double halfSq = x * x * 0.25;
+        for (int k = 1; k < 32 && term > sum * 1e-12; ++k) {
+            term *= halfSq / ((double)k * k);
+            sum += term;
+        }
+        return sum;
+    }
+
+    // x为到输出像素中心的距离（输出像素为单位）
+    double EvaluateWindowedFilter(MipFilter filter, double x) {
+        const double t = x / kWindowedFilterRadius;
+        if (t <= -1.0 || t >= 1.0) return 0.0;
+        if (filter == MipFilter::Lanczos) {
+            return Sinc(x) * Sinc(t);
+        }
+        return Sinc(x) * BesselI0(kKaiserAlpha * std::sqrt(1.0 - t * t)) / BesselI0(kKaiserAlpha);
+    }
+
+    // 一个方向上每个输出像素的源下标和权重（每个输出tapCount个，边缘按环绕或夹取映射）
+    struct FilterTaps {
+        int tapCount = 0;
+        std::vector<int> indices;
+        std::vector<float> weights;
+    };
+
+    void BuildFilterTaps(MipFilter filter, uint32_t sourceSize, uint32_t outSize, bool wrap, FilterTaps& outTaps) {
+        const double scale = (double)sourceSize / outSize;
+        const double support = (filter == MipFilter::Box ? 0.5 : kWindowedFilterRadius) * scale;
+
+        int tapCount = 1;
+        for (uint32_t i = 0; i < outSize; ++i) {
+            const double center = (i + 0.5) * scale;
+            tapCount = std::max(tapCount, (int)(std::ceil(center + support) - std::floor(center - support)));
+        }
+
+        outTaps.tapCount = tapCount;
+        outTaps.indices.assign((size_t)outSize * tapCount, 0);
+        outTaps.weights.assign((size_t)outSize * tapCount, 0.0f);
+        std::vector<double> weights(tapCount);
+        for (uint32_t i = 0; i < outSize; ++i) {
+            const double center = (i + 0.5) * scale;
+            const int first = (int)std::floor(center - support);
+            double sum = 0.0;
+            for (int k = 0; k < tapCount; ++k) {
+                const int s = first + k;
+                if (filter == MipFilter::Box) {
+                    // 源像素[s, s+1]与输出像素覆盖范围的重叠长度
+                    weights[k] = std::max(0.0, std::min(s + 1.0, center + support) - std::max((double)s, center - support));
+                } else {
+                    weights[k] = EvaluateWindowedFilter(filter, (s + 0.5 - center) / scale);
+                }
+                sum += weights[k];
+
+                const int n = (int)sourceSize;
+                outTaps.indices[(size_t)i * tapCount + k] = wrap ? ((s % n) + n) % n : std::min(n - 1, std::max(0, s));
+            }
+            for (int k = 0; k < tapCount; ++k) {
+                outTaps.weights[(size_t)i * tapCount + k] = (float)(weights[k] / sum);
+            }
+        }
+    }
+
+    // ========== 两遍滤波 ==========
+
+    // 水平一遍：source的[rowBegin, rowEnd)行，每行sourceWidth像素 -> outWidth像素
+    void FilterRowsHorizontal(const float* source, uint32_t sourceWidth, uint32_t outWidth, const FilterTaps& taps,
+                              uint32_t rowBegin, uint32_t rowEnd, float* out) {
+        const int tapCount = taps.tapCount;
+        for (uint32_t y = rowBegin; y < rowEnd; ++y) {
+            const float* row = source + (size_t)y * sourceWidth * 4;
+            float* outRow = out + (size_t)y * outWidth * 4;
+            for (uint32_t x = 0; x < outWidth; ++x) {
+                const int* indices = &taps.indices[(size_t)x * tapCount];
+                const float* weights = &taps.weights[(size_t)x * tapCount];
+#if defined(MIP_SIMD_SSE2)
+                __m128 sum = _mm_mul_ps(_mm_loadu_ps(row + indices[0] * 4), _mm_set1_ps(weights[0]));
+                for (int k = 1; k < tapCount; ++k) {
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(row + indices[k] * 4), _mm_set1_ps(weights[k])));
+                }
+                _mm_storeu_ps(outRow + x * 4, sum);
+#else
+                for (int ch = 0; ch < 4; ++ch) {
+                    float sum = row[indices[0] * 4 + ch] * weights[0];
+                    for (int k = 1; k < tapCount; ++k) {
+                        sum = sum + row[indices[k] * 4 + ch] * weights[k];
+                    }
+                    outRow[x * 4 + ch] = sum;
+                }
+#endif
+            }
+        }
+    }
+
+    // 垂直一遍：输出行是若干源行的加权和，整行浮点数连续处理
+    void FilterRowsVertical(const float* source, uint32_t width, const FilterTaps& taps,
+                            uint32_t rowBegin, uint32_t rowEnd, float* out) {
+        const int tapCount = taps.tapCount;
+        const size_t rowFloats = (size_t)width * 4;
+        for (uint32_t y = rowBegin; y < rowEnd; ++y) {
+            const int* indices = &taps.indices[(size_t)y * tapCount];
+            const float* weights = &taps.weights[(size_t)y * tapCount];
+            float* outRow = out + (size_t)y * rowFloats;
+            size_t i = 0;
+#if defined(MIP_SIMD_AVX2)
+            for (; i + 8 <= rowFloats; i += 8) {
+                __m256 sum = _mm256_mul_ps(_mm256_loadu_ps(source + indices[0] * rowFloats + i), _mm256_set1_ps(weights[0]));
+                for (int k = 1; k < tapCount; ++k) {
+                    sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(source + indices[k] * rowFloats + i),
+                                                           _mm256_set1_ps(weights[k])));
+                }
+                _mm256_storeu_ps(outRow + i, sum);
+            }
+#endif
+#if defined(MIP_SIMD_SSE2)
+            for (; i + 4 <= rowFloats; i += 4) {
+                __m128 sum = _mm_mul_ps(_mm_loadu_ps(source + indices[0] * rowFloats + i), _mm_set1_ps(weights[0]));
+                for (int k = 1; k < tapCount; ++k) {
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(source + indices[k] * rowFloats + i), _mm_set1_ps(weights[k])));
+                }
+                _mm_storeu_ps(outRow + i, sum);
+            }
+#endif
+            for (; i < rowFloats; ++i) {
+                float sum = source[indices[0] * rowFloats + i] * weights[0];
+                for (int k = 1; k < tapCount; ++k) {
+                    sum = sum + source[indices[k] * rowFloats + i] * weights[k];
+                }
+                outRow[i] = sum;
+            }
+        }
+    }
+
+    // 法线解码到[-1,1]后归一化再编码回[0,1]；长度接近0（相反方向抵消）时取+Z
+    void RenormalizeNormals(float* pixels, size_t pixelCount) {
+        for (size_t i = 0; i < pixelCount; ++i) {
+            float* p = pixels + i * 4;
+            const float x = p[0] * 2.0f - 1.0f, y = p[1] * 2.0f - 1.0f, z = p[2] * 2.0f - 1.0f;
+            const float length = std::sqrt(x * x + y * y + z * z);
+            if (length < 1e-6f) {
+                p[0] = 0.5f;
+                p[1] = 0.5f;
+                p[2] = 1.0f;
+                continue;
+            }
+            const float inverse = 0.5f / length;
+            p[0] = x * inverse + 0.5f;
+            p[1] = y * inverse + 0.5f;
+            p[2] = z * inverse + 0.5f;
+        }
+    }
+
+    // ========== sRGB ==========
+
+    // sRGB <-> 线性的查找表：解码256项；编码按线性值量化到1/65535（8位结果的误差小于0.05）
+    struct SRGBTables {
+        static constexpr int kEncodeSteps = 65535;
+        float toLinear[256];
+        std::vector<uint8_t> fromLinear;
+
+        SRGBTables() : fromLinear(kEncodeSteps + 1) {
+            for (int i = 0; i < 256; ++i) {
+                const double c = i / 255.0;
+                toLinear[i] = (float)(c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+            }
+            for (int i = 0; i <= kEncodeSteps; ++i) {
+                const double c = (double)i / kEncodeSteps;
+                const double encoded = c <= 0.0031308 ? c * 12.92 : 1.055 * std::pow(c, 1.0 / 2.4) - 0.055;
+                fromLinear[i] = (uint8_t)std::min(255.0, std::floor(encoded * 255.0 + 0.5));
+            }
+        }
+    };
+
+    const SRGBTables& GetSRGBTables() {
+        static const SRGBTables tables;
+        return tables;
+    }
+
+    uint8_t ToUNorm8(float value) {
+        return (uint8_t)(std::min(1.0f, std::max(0.0f, value)) * 255.0f + 0.5f);
+    }
+}
+
+const char* GetMipFilterName(MipFilter filter) {
+    switch (filter) {
+    case MipFilter::Box:     return "Box";
+    case MipFilter::Kaiser:  return "Kaiser";
+    case MipFilter::Lanczos: return "Lanczos";
+    default:                 return "Unknown";
+    }
+}
+
+uint32_t GetMipLevelCount(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1u, width / 2);
+        height = std::max(1u, height / 2);
+        ++levels;
+    }
+    return levels;
+}
+
+void LoadMipImage(const uint8_t* rgba, uint32_t width, uint32_t height, size_t rowPitch,
+                  const MipGenerateSettings& settings, MipImage& outImage) {
+    outImage.width = width;
+    outImage.height = height;
+    outImage.pixels.resize((size_t)width * height * 4);
+
+    const bool linearize = settings.sRGB && !settings.normalMap;
+    const float* toLinear = GetSRGBTables().toLinear;
+    ForEachRowBand(height, (size_t)width * height, settings.maxThreads, [&](uint32_t rowBegin, uint32_t rowEnd) {
+        for (uint32_t y = rowBegin; y < rowEnd; ++y) {
+            const uint8_t* row = rgba + y * rowPitch;
+            float* outRow = outImage.pixels.data() + (size_t)y * width * 4;
+            for (uint32_t i = 0; i < width * 4; ++i) {
+                outRow[i] = (linearize && (i & 3) != 3) ? toLinear[row[i]] : row[i] / 255.0f;
+            }
+        }
+    });
+}
+
+void LoadMipImage(const float* rgba, uint32_t width, uint32_t height, size_t rowPitch, MipImage& outImage) {
+    outImage.width = width;
+    outImage.height = height;
+    outImage.pixels.resize((size_t)width * height * 4);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(rgba);
+    for (uint32_t y = 0; y < height; ++y) {
+        memcpy(outImage.pixels.data() + (size_t)y * width * 4, bytes + y * rowPitch, (size_t)width * 4 * sizeof(float));
+    }
+}
+
+void StoreMipImage(const MipImage& image, const MipGenerateSettings& settings, uint8_t* outRGBA, size_t rowPitch) {
+    const bool encodeSRGB = settings.sRGB && !settings.normalMap;
+    const SRGBTables& tables = GetSRGBTables();
+    ForEachRowBand(image.height, (size_t)image.width * image.height, settings.maxThreads, [&](uint32_t rowBegin, uint32_t rowEnd) {
+        for (uint32_t y = rowBegin; y < rowEnd; ++y) {
+            const float* row = image.pixels.data() + (size_t)y * image.width * 4;
+            uint8_t* outRow = outRGBA + y * rowPitch;
+            for (uint32_t i = 0; i < image.width * 4; ++i) {
+                if (encodeSRGB && (i & 3) != 3) {
+                    const float value = std::min(1.0f, std::max(0.0f, row[i]));
+                    outRow[i] = tables.fromLinear[(int)(value * SRGBTables::kEncodeSteps + 0.5f)];
+                } else {
+                    outRow[i] = ToUNorm8(row[i]);
+                }
+            }
+        }
+    });
+}
+
+void DownsampleMip(const MipImage& source, const MipGenerateSettings& settings, MipImage& outImage) {
+    const uint32_t outWidth = std::max(1u, source.width / 2);
+    const uint32_t outHeight = std::max(1u, source.height / 2);
+
+    FilterTaps horizontalTaps, verticalTaps;
+    BuildFilterTaps(settings.filter, source.width, outWidth, settings.wrap, horizontalTaps);
+    BuildFilterTaps(settings.filter, source.height, outHeight, settings.wrap, verticalTaps);
+
+    // 水平一遍：source.height行 x outWidth，垂直一遍：outHeight行 x outWidth
+    std::vector<float> horizontal((size_t)outWidth * source.height * 4);
+    const size_t sourcePixels = (size_t)source.width * source.height;
+    ForEachRowBand(source.height, sourcePixels, settings.maxThreads, [&](uint32_t rowBegin, uint32_t rowEnd) {
+        FilterRowsHorizontal(source.pixels.data(), source.width, outWidth, horizontalTaps, rowBegin, rowEnd, horizontal.data());
+    });
+
+    outImage.width = outWidth;
+    outImage.height = outHeight;
+    outImage.pixels.resize((size_t)outWidth * outHeight * 4);
+    ForEachRowBand(outHeight, sourcePixels / 2, settings.maxThreads, [&](uint32_t rowBegin, uint32_t rowEnd) {
+        FilterRowsVertical(horizontal.data(), outWidth, verticalTaps, rowBegin, rowEnd, outImage.pixels.data());
+        if (settings.normalMap) {
+            RenormalizeNormals(outImage.pixels.data() + (size_t)rowBegin * outWidth * 4, (size_t)(rowEnd - rowBegin) * outWidth);
+        }
+    });
+}
+
+float ComputeAlphaCoverage(const MipImage& image, float cutoff) {
+    const size_t pixelCount = (size_t)image.width * image.height;
+    size_t passing = 0;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        if (image.pixels[i * 4 + 3] >= cutoff) ++passing;
+    }
+    return pixelCount > 0 ? (float)passing / pixelCount : 0.0f;
+}
+
+void ScaleAlphaToCoverage(MipImage& image, float cutoff, float targetCoverage) {
+    const size_t pixelCount = (size_t)image.width * image.height;
+    const size_t passing = (size_t)(targetCoverage * pixelCount + 0.5f);
+    if (pixelCount == 0 || passing == 0 || cutoff <= 0.0f) return;
+
+    // 第(pixelCount - passing)小的Alpha作为新阈值：>= 它的像素正好约passing个，把它缩放到cutoff
+    std::vector<float> alphas(pixelCount);
+    for (size_t i = 0; i < pixelCount; ++i) alphas[i] = image.pixels[i * 4 + 3];
+    const size_t rank = pixelCount - std::min(passing, pixelCount);
+    std::nth_element(alphas.begin(), alphas.begin() + rank, alphas.end());
+    const float threshold = alphas[rank];
+    if (threshold <= 0.0f) return;
+
+    // 略微放大，避免阈值像素乘回来后因舍入落到cutoff以下
+    const float scale = cutoff / threshold * 1.0001f;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        float& alpha = image.pixels[i * 4 + 3];
+        alpha = std::min(1.0f, alpha * scale);
+    }
+}
+
+void GenerateMipChain(MipImage top, const MipGenerateSettings& settings,
+                      const std::function<void(uint32_t level, const MipImage& image)>& callback) {
+    uint32_t levelCount = GetMipLevelCount(top.width, top.height);
+    if (settings.maxMipLevels > 0) {
+        levelCount = std::min(levelCount, settings.maxMipLevels);
+    }
+
+    const bool preserveCoverage = settings.alphaCutoff > 0.0f;
+    const float coverage = preserveCoverage ? ComputeAlphaCoverage(top, settings.alphaCutoff) : 0.0f;
+
+    // 下一级从未缩放的本级生成，覆盖率修正只作用于交给callback的结果，误差不会逐级累积
+    MipImage current = std::move(top);
+    MipImage next;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        if (level + 1 < levelCount) {
+            DownsampleMip(current, settings, next);
+        }
+        if (level > 0 && preserveCoverage) {
+            ScaleAlphaToCoverage(current, settings.alphaCutoff, coverage);
+        }
+        callback(level, current);
+        std::swap(current, next);
+    }
+}
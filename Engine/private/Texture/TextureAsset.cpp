@@ -7,27 +7,28 @@
 #include "public/Texture/TextureAsset.h"
 #include "public/Texture/TextureManager.h"
 #include "public/Texture/TextureCompressor.h"
+#include "public/Texture/TextureCacheIndex.h"
+#include "public/Texture/TextureStreaming.h"
+#include "public/HashUtils.h"
 #include "public/BattleFireDirect.h"
+#include "public/AssetBin.h"
+#include "public/PathUtils.h"
 #include <d3dx12.h>
 #include <DirectXTex/DirectXTex.h>
 #include <comdef.h>
 #include <msxml6.h>
 #include <shlwapi.h>
+#include <cstring>
 #include <fstream>
-#include <sstream>
 #include <iostream>
-#include <iomanip>
 #include <algorithm>
 
 #pragma comment(lib, "msxml6.lib")
 #pragma comment(lib, "shlwapi.lib")
 
-// MD5哈希计算（简化版，用于缓存验证）
-#include <wincrypt.h>
-#pragma comment(lib, "advapi32.lib")
-
-// 静态变量初始化：默认使用NVTT压缩
-bool TextureAsset::s_useNVTT = true;
+constexpr uint32_t kTextureBinMagic = 0x58455446;    // "FTEX"
+constexpr uint32_t kTextureBinVersion = 2;
+constexpr uint32_t kTextureCookVersion = 1;         // 编码器或mip生成器的输出变化时递增，旧的烘焙结果不再命中
 
 namespace {
     // BSTR转std::string辅助函数
@@ -65,41 +66,38 @@ namespace {
         return result;
     }
 
-    // 计算文件MD5哈希
-    std::string CalculateFileMD5(const std::wstring& filePath) {
-        HANDLE hFile = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ,
-            nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
-        if (hFile == INVALID_HANDLE_VALUE) return "";
-
-        HCRYPTPROV hProv = 0;
-        HCRYPTHASH hHash = 0;
-        std::string result;
-
-        if (CryptAcquireContext(&hProv, nullptr, nullptr, PROV_RSA_FULL, CRYPT_VERIFYCONTEXT)) {
-            if (CryptCreateHash(hProv, CALG_MD5, 0, 0, &hHash)) {
-                BYTE buffer[8192];
-                DWORD bytesRead;
-                while (ReadFile(hFile, buffer, sizeof(buffer), &bytesRead, nullptr) && bytesRead > 0) {
-                    CryptHashData(hHash, buffer, bytesRead, 0);
-                }
+    // 读取parent下第一个名为tag的元素的文本，不存在时返回false
+    bool ReadElementText(IXMLDOMElement* parent, const char* tag, std::string& outText) {
+        IXMLDOMNodeList* pList = nullptr;
+        parent->getElementsByTagName(_bstr_t(tag), &pList);
+        if (!pList) return false;
 
-                BYTE hash[16];
-                DWORD hashLen = 16;
-                if (CryptGetHashParam(hHash, HP_HASHVAL, hash, &hashLen, 0)) {
-                    std::ostringstream oss;
-                    for (int i = 0; i < 16; i++) {
-                        oss << std::hex << std::setfill('0') << std::setw(2) << (int)hash[i];
-                    }
-                    result = oss.str();
-                }
-                CryptDestroyHash(hHash);
+        bool found = false;
+        IXMLDOMNode* pNode = nullptr;
+        pList->get_item(0, &pNode);
+        if (pNode) {
+            BSTR val = nullptr;
+            pNode->get_text(&val);
+            if (val) {
+                outText = BSTRToString(val);
+                SysFreeString(val);
+                found = true;
             }
-            CryptReleaseContext(hProv, 0);
+            pNode->Release();
         }
-
-        CloseHandle(hFile);
-        return result;
+        pList->Release();
+        return found;
     }
+
+    // 烘焙键的组成：源文件内容 + 影响烘焙结果的全部设置（按字节哈希，填充字节清零）
+    struct TextureCookKey {
+        uint64_t contentHash;
+        uint32_t cookVersion;
+        uint8_t type, format, quality, generateMips;
+        uint8_t sRGB, mipFilter, normalMap, mipSRGB;
+        uint8_t mipWrap, blockEncoder, padding[2];
+        float alphaCutoff;
+    };
 }
 
 // ========== 构造和析构 ==========
@@ -154,6 +152,17 @@ const char* TextureAsset::GetTypeName(TextureType type) {
     }
 }
 
+MipGenerateSettings TextureAsset::GetMipGenerateSettings() const {
+    MipGenerateSettings settings;
+    settings.filter = m_desc.mipFilter;
+    settings.normalMap = m_desc.normalMap;
+    settings.sRGB = m_desc.sRGB && !m_desc.normalMap && m_desc.format != TextureCompressionFormat::BC6H;
+    settings.alphaCutoff = m_desc.alphaCutoff;
+    settings.wrap = m_desc.type == TextureType::Texture2D &&
+                    m_desc.addressU == TextureAddressMode::Wrap && m_desc.addressV == TextureAddressMode::Wrap;
+    return settings;
+}
+
 size_t TextureAsset::CalculateMemorySize(UINT width, UINT height, UINT mipLevels,
                                           TextureCompressionFormat format) {
     size_t totalSize = 0;
@@ -187,24 +196,62 @@ size_t TextureAsset::CalculateMemorySize(UINT width, UINT height, UINT mipLevels
 // ========== 文件操作 ==========
 
 bool TextureAsset::LoadFromAssetFile(const std::wstring& assetPath) {
-    std::cout << "TextureAsset::LoadFromAssetFile - START: " << WStringToString(assetPath) << std::endl;
     m_assetPath = assetPath;
-    bool result = ParseAssetXML(assetPath);
-    std::cout << "TextureAsset::LoadFromAssetFile - END: " << (result ? "SUCCESS" : "FAILED") << std::endl;
-    return result;
+
+    const std::wstring binPath = GetAssetBinPath(assetPath);
+    bool result = IsAssetBinUpToDate(assetPath, binPath, kTextureBinMagic, kTextureBinVersion) &&
+                  ReadAssetBin(binPath);
+    if (!result) {
+        std::cout << "TextureAsset::LoadFromAssetFile - parsing XML: " << WStringToString(assetPath) << std::endl;
+        result = ParseAssetXML(assetPath);
+        if (result && !WriteAssetBin(binPath, assetPath)) {
+            std::cout << "TextureAsset: failed to write " << WStringToString(binPath) << std::endl;
+        }
+    }
+    if (!result) {
+        std::cout << "TextureAsset::LoadFromAssetFile - FAILED: " << WStringToString(assetPath) << std::endl;
+        return false;
+    }
+
+    ValidateCache();
+    return true;
 }
 
 bool TextureAsset::SaveAssetFile(const std::wstring& assetPath) {
     m_assetPath = assetPath;
-    return WriteAssetXML(assetPath);
+    if (!WriteAssetXML(assetPath)) {
+        return false;
+    }
+    WriteAssetBin(GetAssetBinPath(assetPath), assetPath);
+    return true;
+}
+
+std::wstring TextureAsset::GetAssetBinPath(const std::wstring& assetPath) {
+    static const std::wstring kAssetSuffix = L".texture.ast";
+    if (assetPath.size() >= kAssetSuffix.size() &&
+        _wcsicmp(assetPath.c_str() + assetPath.size() - kAssetSuffix.size(), kAssetSuffix.c_str()) == 0) {
+        return assetPath.substr(0, assetPath.size() - kAssetSuffix.size()) + L".texbin";
+    }
+    return assetPath + L".texbin";
+}
+
+bool TextureAsset::CookAssetFile(const std::wstring& assetPath) {
+    TextureAsset asset("");
+    if (!asset.ParseAssetXML(assetPath)) {
+        std::cout << "TextureAsset::CookAssetFile - Failed to parse " << WStringToString(assetPath) << std::endl;
+        return false;
+    }
+    if (!asset.WriteAssetBin(GetAssetBinPath(assetPath), assetPath)) {
+        std::cout << "TextureAsset::CookAssetFile - Failed to write " << WStringToString(assetPath) << std::endl;
+        return false;
+    }
+    return true;
 }
 
 bool TextureAsset::ImportFromSource(const std::wstring& sourcePath, const TextureAssetDesc& desc) {
     m_sourcePath = sourcePath;
     m_desc = desc;
-    m_sourceHash = CalculateSourceHash(sourcePath);
-    m_cacheDdsPath = GenerateCachePath();
-    m_cacheValid = false;
+    ValidateCache();
 
     // 提取文件名作为资产名（如果未设置）
     if (m_name.empty()) {
@@ -223,6 +270,11 @@ bool TextureAsset::ImportFromSource(const std::wstring& sourcePath, const Textur
 bool TextureAsset::LoadToGPU(ID3D12Device* device, ID3D12GraphicsCommandList* commandList) {
     if (m_isLoaded) return true;
 
+    // 资产在缓存索引初始化之前加载时还没有缓存路径
+    if (m_cacheDdsPath.empty()) {
+        ValidateCache();
+    }
+
     // 优先从缓存加载
     if (m_cacheValid && PathFileExistsW(m_cacheDdsPath.c_str())) {
         if (LoadDDSFromCache(device, commandList)) {
@@ -252,6 +304,16 @@ void TextureAsset::UnloadFromGPU() {
         m_srvIndex = UINT_MAX;
     }
 
+    // 注销流送（固定标记保留，重新加载后仍然有效）
+    if (m_streamingId >= 0) {
+        TextureManager::GetInstance().UnregisterStreaming(this);
+    }
+    m_streamable = false;
+    m_residentMip = 0;
+    m_streamingTailMip = 0;
+    m_streamingResource.Reset();
+    m_streamingUploadHeap.Reset();
+
     m_resource.Reset();
     m_uploadHeap.Reset();
     m_srvCPU = {};
@@ -259,6 +321,21 @@ void TextureAsset::UnloadFromGPU() {
     m_isLoaded = false;
 }
 
+bool TextureAsset::ReloadFromDisk(ID3D12Device* device, ID3D12GraphicsCommandList* commandList) {
+    if (!m_assetPath.empty()) {
+        // 资产文件重新加载时会按源文件哈希重新验证缓存
+        if (!LoadFromAssetFile(m_assetPath)) return false;
+    } else if (!m_sourcePath.empty()) {
+        TextureAssetDesc desc = m_desc;
+        ImportFromSource(m_sourcePath, desc);
+    } else {
+        return false;
+    }
+
+    UnloadFromGPU();
+    return LoadToGPU(device, commandList);
+}
+
 bool TextureAsset::LoadSourceToGPU(ID3D12Device* device, ID3D12GraphicsCommandList* commandList) {
     if (m_isLoaded) return true;
 
@@ -361,10 +438,9 @@ bool TextureAsset::LoadSourceToGPU(ID3D12Device* device, ID3D12GraphicsCommandLi
 bool TextureAsset::ApplyCompression(TextureCompressionFormat format,
                                      ID3D12Device* device,
                                      ID3D12GraphicsCommandList* commandList) {
-    // 设置新格式
+    // 设置新格式（缓存键随之变化，这组设置烘焙过时直接加载）
     m_desc.format = format;
-    m_cacheValid = false;
-    m_cacheDdsPath = GenerateCachePath();
+    ValidateCache();
 
     // 卸载当前资源
     UnloadFromGPU();
@@ -374,8 +450,8 @@ bool TextureAsset::ApplyCompression(TextureCompressionFormat format,
         return LoadSourceToGPU(device, commandList);
     }
 
-    // 执行压缩并加载
-    return LoadAndCompressSource(device, commandList);
+    // 命中缓存时加载，否则压缩并加载
+    return LoadToGPU(device, commandList);
 }
 
 bool TextureAsset::Recompress(TextureCompressionFormat newFormat,
@@ -383,7 +459,7 @@ bool TextureAsset::Recompress(TextureCompressionFormat newFormat,
                                ID3D12GraphicsCommandList* commandList) {
     // 更新格式
     m_desc.format = newFormat;
-    m_cacheValid = false;
+    ValidateCache();
 
     // 卸载并重新加载
     UnloadFromGPU();
@@ -392,44 +468,37 @@ bool TextureAsset::Recompress(TextureCompressionFormat newFormat,
 
 // ========== 内部实现 ==========
 
-std::string TextureAsset::CalculateSourceHash(const std::wstring& path) {
-    return CalculateFileMD5(path);
-}
-
 std::wstring TextureAsset::GenerateCachePath() {
-    if (m_sourceHash.empty()) {
-        m_sourceHash = CalculateSourceHash(m_sourcePath);
-    }
-
-    // 在源图片同目录下创建TextureCache文件夹
-    // 获取源文件所在目录
-    std::wstring sourceDir = m_sourcePath;
-    size_t lastSlash = sourceDir.find_last_of(L"\\/");
-    if (lastSlash != std::wstring::npos) {
-        sourceDir = sourceDir.substr(0, lastSlash + 1);
-    }
-
-    // 获取源文件名（不含扩展名）
-    std::wstring fileName = m_sourcePath;
-    if (lastSlash != std::wstring::npos) {
-        fileName = fileName.substr(lastSlash + 1);
+    // 源文件内容哈希经缓存索引获取：大小和修改时间不变时不读文件
+    uint64_t contentHash = 0;
+    if (!TextureCacheIndex::GetInstance().GetSourceHash(m_sourcePath, contentHash)) {
+        std::cout << "TextureAsset: failed to hash source " << WStringToString(m_sourcePath) << std::endl;
+        return L"";
     }
-    size_t dotPos = fileName.find_last_of(L'.');
-    if (dotPos != std::wstring::npos) {
-        fileName = fileName.substr(0, dotPos);
-    }
-
-    // 创建TextureCache目录路径
-    std::wstring cacheDir = sourceDir + L"TextureCache\\";
-
-    // 确保目录存在
-    CreateDirectoryW(cacheDir.c_str(), nullptr);
-
-    // 返回缓存文件路径：源目录/TextureCache/原文件名.dds
-    return cacheDir + fileName + L".dds";
+    m_sourceHash = HashToHexString(contentHash);
+
+    const MipGenerateSettings mipSettings = GetMipGenerateSettings();
+    TextureCookKey key;
+    memset(&key, 0, sizeof(key));
+    key.contentHash = contentHash;
+    key.cookVersion = kTextureCookVersion;
+    key.type = (uint8_t)m_desc.type;
+    key.format = (uint8_t)m_desc.format;
+    key.quality = (uint8_t)m_desc.quality;
+    key.generateMips = m_desc.generateMips ? 1 : 0;
+    key.sRGB = m_desc.sRGB ? 1 : 0;
+    key.mipFilter = (uint8_t)mipSettings.filter;
+    key.normalMap = mipSettings.normalMap ? 1 : 0;
+    key.mipSRGB = mipSettings.sRGB ? 1 : 0;
+    key.mipWrap = mipSettings.wrap ? 1 : 0;
+    key.blockEncoder = TextureCompressor::GetInstance().GetUseBlockEncoder() ? 1 : 0;
+    key.alphaCutoff = mipSettings.alphaCutoff;
+
+    // 缓存目录\<烘焙键>.dds
+    return TextureCacheIndex::GetInstance().GetCookedPath(HashXXH64(&key, sizeof(key)));
 }
 
-bool TextureAsset::LoadDDSFromCache(ID3D12Device* device, ID3D12GraphicsCommandList* commandList) {
+bool TextureAsset::LoadDDSFromCache(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, UINT firstMip) {
     // 使用DirectXTex加载DDS
     DirectX::TexMetadata metadata;
     DirectX::ScratchImage scratchImage;
@@ -448,19 +517,38 @@ bool TextureAsset::LoadDDSFromCache(ID3D12Device* device, ID3D12GraphicsCommandL
 
     bool bIsCube = (metadata.miscFlags & DirectX::TEX_MISC_TEXTURECUBE) != 0;
 
-    // 手动创建纹理资源
+    // 只有带mip的单张2D纹理参与流送（立方体贴图和数组总是完整加载）
+    const bool streamable = m_desc.type == TextureType::Texture2D && !bIsCube &&
+                            metadata.dimension == DirectX::TEX_DIMENSION_TEXTURE2D &&
+                            metadata.arraySize == 1 && metadata.mipLevels > 1;
+    const UINT mipLevels = static_cast<UINT>(metadata.mipLevels);
+    const UINT tailMip = streamable ?
+        ::GetStreamingTailMip(static_cast<uint32_t>(metadata.width), static_cast<uint32_t>(metadata.height), mipLevels,
+                            TextureManager::GetInstance().GetStreamingTailSize(), DirectX::IsCompressed(metadata.format)) : 0;
+    const bool initialLoad = firstMip == UINT_MAX;
+    if (initialLoad) {
+        firstMip = tailMip;
+    } else if (!streamable) {
+        std::cout << "Texture is not streamable: " << m_name << std::endl;
+        return false;
+    }
+    firstMip = std::min(firstMip, tailMip);
+
+    // 手动创建纹理资源：顶层为firstMip
     D3D12_RESOURCE_DESC texDesc = {};
     texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-    texDesc.Width = static_cast<UINT64>(metadata.width);
-    texDesc.Height = static_cast<UINT>(metadata.height);
+    texDesc.Width = static_cast<UINT64>(std::max<size_t>(1, metadata.width >> firstMip));
+    texDesc.Height = static_cast<UINT>(std::max<size_t>(1, metadata.height >> firstMip));
     texDesc.DepthOrArraySize = static_cast<UINT16>(metadata.arraySize);
-    texDesc.MipLevels = static_cast<UINT16>(metadata.mipLevels);
+    texDesc.MipLevels = static_cast<UINT16>(mipLevels - firstMip);
     texDesc.Format = metadata.format;
     texDesc.SampleDesc.Count = 1;
     texDesc.SampleDesc.Quality = 0;
     texDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
     texDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
+    // 先建到局部变量，全部成功后再替换：流送重建失败时保留原资源
+    ComPtr<ID3D12Resource> resource;
     CD3DX12_HEAP_PROPERTIES defaultHeapProps(D3D12_HEAP_TYPE_DEFAULT);
     hr = device->CreateCommittedResource(
         &defaultHeapProps,
@@ -468,7 +556,7 @@ bool TextureAsset::LoadDDSFromCache(ID3D12Device* device, ID3D12GraphicsCommandL
         &texDesc,
         D3D12_RESOURCE_STATE_COPY_DEST,
         nullptr,
-        IID_PPV_ARGS(&m_resource)
+        IID_PPV_ARGS(&resource)
     );
 
     if (FAILED(hr)) {
@@ -476,24 +564,27 @@ bool TextureAsset::LoadDDSFromCache(ID3D12Device* device, ID3D12GraphicsCommandL
         return false;
     }
 
-    // 手动准备子资源数据
+    // 手动准备子资源数据（子资源顺序：数组元素 -> mip）
     std::vector<D3D12_SUBRESOURCE_DATA> subresources;
-    subresources.reserve(scratchImage.GetImageCount());
-
-    const DirectX::Image* images = scratchImage.GetImages();
-    for (size_t i = 0; i < scratchImage.GetImageCount(); ++i) {
-        D3D12_SUBRESOURCE_DATA subresource = {};
-        subresource.pData = images[i].pixels;
-        subresource.RowPitch = static_cast<LONG_PTR>(images[i].rowPitch);
-        subresource.SlicePitch = static_cast<LONG_PTR>(images[i].slicePitch);
-        subresources.push_back(subresource);
+    subresources.reserve(metadata.arraySize * (mipLevels - firstMip));
+
+    for (size_t item = 0; item < metadata.arraySize; ++item) {
+        for (size_t mip = firstMip; mip < mipLevels; ++mip) {
+            const DirectX::Image* image = scratchImage.GetImage(mip, item, 0);
+            D3D12_SUBRESOURCE_DATA subresource = {};
+            subresource.pData = image->pixels;
+            subresource.RowPitch = static_cast<LONG_PTR>(image->rowPitch);
+            subresource.SlicePitch = static_cast<LONG_PTR>(image->slicePitch);
+            subresources.push_back(subresource);
+        }
     }
 
     // 计算上传堆大小
     UINT64 uploadHeapSize = GetRequiredIntermediateSize(
-        m_resource.Get(), 0, static_cast<UINT>(subresources.size()));
+        resource.Get(), 0, static_cast<UINT>(subresources.size()));
 
     // 创建上传堆
+    ComPtr<ID3D12Resource> uploadHeap;
     CD3DX12_HEAP_PROPERTIES uploadHeapProps(D3D12_HEAP_TYPE_UPLOAD);
     CD3DX12_RESOURCE_DESC uploadResourceDesc = CD3DX12_RESOURCE_DESC::Buffer(uploadHeapSize);
 
@@ -503,7 +594,7 @@ bool TextureAsset::LoadDDSFromCache(ID3D12Device* device, ID3D12GraphicsCommandL
         &uploadResourceDesc,
         D3D12_RESOURCE_STATE_GENERIC_READ,
         nullptr,
-        IID_PPV_ARGS(&m_uploadHeap)
+        IID_PPV_ARGS(&uploadHeap)
     );
 
     if (FAILED(hr)) {
@@ -514,8 +605,8 @@ bool TextureAsset::LoadDDSFromCache(ID3D12Device* device, ID3D12GraphicsCommandL
     // 上传数据
     UpdateSubresources(
         commandList,
-        m_resource.Get(),
-        m_uploadHeap.Get(),
+        resource.Get(),
+        uploadHeap.Get(),
         0, 0,
         static_cast<UINT>(subresources.size()),
         subresources.data()
@@ -523,63 +614,81 @@ bool TextureAsset::LoadDDSFromCache(ID3D12Device* device, ID3D12GraphicsCommandL
 
     // 资源状态转换
     CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-        m_resource.Get(),
+        resource.Get(),
         D3D12_RESOURCE_STATE_COPY_DEST,
         D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
     );
     commandList->ResourceBarrier(1, &barrier);
 
-    // 更新运行时信息
+    if (!initialLoad) {
+        // 流送：当前资源在上传完成前继续使用，之后由CommitStreamedMips替换
+        m_streamingResource = resource;
+        m_streamingUploadHeap = uploadHeap;
+        m_streamingMip = firstMip;
+        return true;
+    }
+
+    m_resource = resource;
+    m_uploadHeap = uploadHeap;
+    m_streamingResource.Reset();
+    m_streamingUploadHeap.Reset();
+    m_streamable = streamable;
+    m_residentMip = firstMip;
+    m_streamingTailMip = tailMip;
+
+    // 更新运行时信息（宽高和mip级数为完整纹理，占用为常驻部分）
     m_runtimeInfo.width = static_cast<UINT>(metadata.width);
     m_runtimeInfo.height = static_cast<UINT>(metadata.height);
-    m_runtimeInfo.mipLevels = static_cast<UINT>(metadata.mipLevels);
+    m_runtimeInfo.mipLevels = mipLevels;
     m_runtimeInfo.format = metadata.format;
     m_runtimeInfo.arraySize = static_cast<UINT>(metadata.arraySize);
     m_runtimeInfo.memorySize = CalculateMemorySize(
-        m_runtimeInfo.width, m_runtimeInfo.height,
-        m_runtimeInfo.mipLevels, m_desc.format);
+        static_cast<UINT>(texDesc.Width), texDesc.Height,
+        mipLevels - firstMip, m_desc.format);
 
-    // 创建SRV
+    // 创建SRV（重新加载时沿用原槽位）
     CreateSRV(device);
 
+    if (m_streamable) {
+        TextureManager::GetInstance().RegisterStreaming(this);
+    }
     std::cout << "Loaded texture from cache: " << m_name
-              << " (" << m_runtimeInfo.width << "x" << m_runtimeInfo.height << ")" << std::endl;
+              << " (" << m_runtimeInfo.width << "x" << m_runtimeInfo.height;
+    if (firstMip > 0) {
+        std::cout << ", streaming from mip " << firstMip;
+    }
+    std::cout << ")" << std::endl;
 
     return true;
 }
 
-bool TextureAsset::LoadAndCompressSource(ID3D12Device* device, ID3D12GraphicsCommandList* commandList) {
-    // Debug output
-    std::cout << "LoadAndCompressSource called:" << std::endl;
-    std::cout << "  s_useNVTT = " << (s_useNVTT ? "true" : "false") << std::endl;
-    std::cout << "  format = " << GetFormatName(m_desc.format) << std::endl;
-    std::cout << "  sourcePath = " << WStringToString(m_sourcePath) << std::endl;
-
-    // 如果启用NVTT压缩且需要压缩，优先使用NVTT
-    if (s_useNVTT && m_desc.format != TextureCompressionFormat::None) {
-        TextureCompressor& compressor = TextureCompressor::GetInstance();
-        std::cout << "  NVTT available = " << (compressor.IsNVTTAvailable() ? "true" : "false") << std::endl;
-        if (compressor.IsNVTTAvailable()) {
-            std::cout << "Using NVIDIA Texture Tools for compression (Quality: "
-                      << TextureCompressor::GetNVTTQualityName(compressor.GetNVTTQuality()) << ")..." << std::endl;
-
-            // 确保缓存目录存在
-            std::wstring cacheDir = m_cacheDdsPath.substr(0, m_cacheDdsPath.find_last_of(L"\\/"));
-            CreateDirectoryW(cacheDir.c_str(), nullptr);
-
-            // 使用NVTT压缩，传入当前质量设置
-            if (compressor.CompressWithNVTT(m_sourcePath, m_cacheDdsPath,
-                                            m_desc.format, m_desc.generateMips, m_desc.sRGB,
-                                            compressor.GetNVTTQuality())) {
-                m_cacheValid = true;
-                std::cout << "NVTT compression successful, loading from cache..." << std::endl;
-                return LoadDDSFromCache(device, commandList);
-            }
-            std::cout << "NVTT compression failed, falling back to DirectXTex..." << std::endl;
-        }
-    }
+bool TextureAsset::StreamMips(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, UINT firstMip) {
+    if (!m_isLoaded || !m_streamable || m_streamingResource.Get()) return false;
+    if (firstMip == m_residentMip) return true;
+    return LoadDDSFromCache(device, commandList, firstMip);
+}
 
-    // 使用DirectXTex加载源文件（回退方案或不需要压缩时）
+bool TextureAsset::CommitStreamedMips(ID3D12Device* device, std::vector<ComPtr<ID3D12Resource>>& outReplaced) {
+    if (!m_streamingResource.Get()) return false;
+
+    // 调用方保证没有在途帧：旧资源交给调用方释放，上传堆的拷贝都已执行完
+    outReplaced.push_back(m_resource);
+    m_resource = m_streamingResource;
+    m_streamingResource.Reset();
+    m_uploadHeap.Reset();
+    m_streamingUploadHeap.Reset();
+    m_residentMip = m_streamingMip;
+
+    m_runtimeInfo.memorySize = CalculateMemorySize(
+        std::max(1u, m_runtimeInfo.width >> m_residentMip), std::max(1u, m_runtimeInfo.height >> m_residentMip),
+        m_runtimeInfo.mipLevels - m_residentMip, m_desc.format);
+
+    CreateSRV(device);
+    return true;
+}
+
+bool TextureAsset::LoadAndCompressSource(ID3D12Device* device, ID3D12GraphicsCommandList* commandList) {
+    // 使用DirectXTex加载源文件
     DirectX::ScratchImage sourceImage;
     DirectX::TexMetadata metadata;
     HRESULT hr;
@@ -604,45 +713,48 @@ bool TextureAsset::LoadAndCompressSource(ID3D12Device* device, ID3D12GraphicsCom
         return false;
     }
 
-    // 生成Mipmap（如果需要）
-    DirectX::ScratchImage mipChain;
-    if (m_desc.generateMips && metadata.mipLevels == 1) {
-        hr = DirectX::GenerateMipMaps(
-            sourceImage.GetImages(), sourceImage.GetImageCount(), sourceImage.GetMetadata(),
-            DirectX::TEX_FILTER_DEFAULT, 0, mipChain);
-        if (SUCCEEDED(hr)) {
-            sourceImage = std::move(mipChain);
+    // 生成Mipmap（如果需要）：引擎mip生成器逐级生成，每级直接交给块编码器压缩
+    DirectX::ScratchImage compressedImage;
+    bool processed = false;
+    if (m_desc.generateMips && metadata.mipLevels == 1 && !DirectX::IsCompressed(metadata.format) &&
+        metadata.dimension != DirectX::TEX_DIMENSION_TEXTURE3D) {
+        if (TextureCompressor::GetInstance().GenerateMipsAndCompress(sourceImage, m_desc.format, m_desc.sRGB, m_desc.quality,
+                                                                     GetMipGenerateSettings(), compressedImage)) {
+            sourceImage = std::move(compressedImage);
             metadata = sourceImage.GetMetadata();
+            processed = true;
+        }
+        else {
+            std::cout << "Mip generation failed, compressing top level only" << std::endl;
         }
     }
 
-    // 压缩（如果需要）
-    DirectX::ScratchImage compressedImage;
-    DXGI_FORMAT targetFormat = GetDXGIFormat(m_desc.format, m_desc.sRGB);
-
-    if (m_desc.format != TextureCompressionFormat::None &&
+    // 压缩（如果需要，且上面没有生成mip）
+    if (!processed && m_desc.format != TextureCompressionFormat::None &&
         !DirectX::IsCompressed(metadata.format)) {
-        hr = DirectX::Compress(
-            sourceImage.GetImages(), sourceImage.GetImageCount(), sourceImage.GetMetadata(),
-            targetFormat,
-            DirectX::TEX_COMPRESS_DEFAULT | DirectX::TEX_COMPRESS_PARALLEL,
-            DirectX::TEX_THRESHOLD_DEFAULT,
-            compressedImage
-        );
-        if (SUCCEEDED(hr)) {
+        if (TextureCompressor::GetInstance().CompressCPU(sourceImage, m_desc.format, m_desc.sRGB,
+                                                         m_desc.quality, compressedImage)) {
             sourceImage = std::move(compressedImage);
             metadata = sourceImage.GetMetadata();
         }
         else {
-            std::cout << "Compression failed, using uncompressed. HRESULT: " << hr << std::endl;
+            std::cout << "Compression failed, using uncompressed" << std::endl;
         }
     }
 
     // 保存到缓存DDS
-    hr = DirectX::SaveToDDSFile(
+    if (m_cacheDdsPath.empty()) {
+        std::cout << "No texture cache path for: " << m_name << std::endl;
+        return false;
+    }
+    DirectX::Blob ddsBlob;
+    hr = DirectX::SaveToDDSMemory(
         sourceImage.GetImages(), sourceImage.GetImageCount(), sourceImage.GetMetadata(),
-        DirectX::DDS_FLAGS_NONE, m_cacheDdsPath.c_str()
+        DirectX::DDS_FLAGS_NONE, ddsBlob
     );
+    if (SUCCEEDED(hr) && !WriteFileAtomic(m_cacheDdsPath, ddsBlob.GetBufferPointer(), ddsBlob.GetBufferSize())) {
+        hr = HRESULT_FROM_WIN32(GetLastError());
+    }
 
     if (SUCCEEDED(hr)) {
         m_cacheValid = true;
@@ -657,8 +769,10 @@ bool TextureAsset::LoadAndCompressSource(ID3D12Device* device, ID3D12GraphicsCom
 }
 
 void TextureAsset::CreateSRV(ID3D12Device* device) {
-    // 分配SRV槽位
-    m_srvIndex = TextureManager::GetInstance().AllocateSRVIndex();
+    // 分配SRV槽位（已有槽位时在原位置重建）
+    if (m_srvIndex == UINT_MAX) {
+        m_srvIndex = TextureManager::GetInstance().AllocateSRVIndex();
+    }
     if (m_srvIndex == UINT_MAX) {
         std::cout << "Failed to allocate SRV index" << std::endl;
         return;
@@ -676,7 +790,7 @@ void TextureAsset::CreateSRV(ID3D12Device* device) {
     switch (m_desc.type) {
     case TextureType::Texture2D:
         srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MipLevels = m_runtimeInfo.mipLevels;
+        srvDesc.Texture2D.MipLevels = m_runtimeInfo.mipLevels - m_residentMip;
         srvDesc.Texture2D.MostDetailedMip = 0;
         break;
 
@@ -871,6 +985,20 @@ bool TextureAsset::ParseAssetXML(const std::wstring& xmlPath) {
                     }
                     pSRGBList->Release();
                 }
+
+                // mip生成设置（旧资产没有这些节点时保持默认值）
+                std::string text;
+                if (ReadElementText(pCompElem, "MipFilter", text)) {
+                    if (text == "Box") m_desc.mipFilter = MipFilter::Box;
+                    else if (text == "Lanczos") m_desc.mipFilter = MipFilter::Lanczos;
+                    else m_desc.mipFilter = MipFilter::Kaiser;
+                }
+                if (ReadElementText(pCompElem, "NormalMap", text)) {
+                    m_desc.normalMap = (text == "true");
+                }
+                if (ReadElementText(pCompElem, "AlphaCutoff", text)) {
+                    m_desc.alphaCutoff = std::max(0.0f, strtof(text.c_str(), nullptr));
+                }
                 pCompElem->Release();
             }
             pComp->Release();
@@ -955,19 +1083,97 @@ bool TextureAsset::ParseAssetXML(const std::wstring& xmlPath) {
     pRoot->Release();
     pDoc->Release();
     if (comInitialized) CoUninitialize();
+    return true;
+}
 
-    // 验证缓存
-    if (m_cacheValid && !m_sourceHash.empty() && !m_sourcePath.empty()) {
-        std::string currentHash = CalculateSourceHash(m_sourcePath);
-        if (currentHash != m_sourceHash) {
-            m_cacheValid = false;  // 源文件已更改
-            std::cout << "Cache invalidated: source file changed" << std::endl;
-        }
+void TextureAsset::ValidateCache() {
+    // 只发布了烘焙结果（没有源文件）时沿用记录的缓存路径
+    if (m_sourcePath.empty() || !PathFileExistsW(m_sourcePath.c_str())) {
+        return;
     }
 
+    // 缓存路径由源文件内容和当前设置决定：任一变化都会换到另一个文件，文件存在即有效
+    m_cacheDdsPath = GenerateCachePath();
+    m_cacheValid = !m_cacheDdsPath.empty() && PathFileExistsW(m_cacheDdsPath.c_str());
+}
+
+// ========== 烘焙格式 ==========
+// 布局：AssetBinHeader | name | sourcePath | sourceHash | uint8 type, format, quality, generateMips, sRGB
+//       | uint8 mipFilter, normalMap | float alphaCutoff | ddsPath | uint8 cacheValid
+
+bool TextureAsset::ReadAssetBin(const std::wstring& binPath) {
+    AssetBinReader reader;
+    if (!reader.Open(binPath, kTextureBinMagic, kTextureBinVersion)) {
+        return false;
+    }
+
+    std::string name;
+    std::wstring sourcePath;
+    std::string sourceHash;
+    std::wstring cacheDdsPath;
+    uint8_t type = 0, format = 0, quality = 0, generateMips = 0, sRGB = 0, cacheValid = 0;
+    uint8_t mipFilter = 0, normalMap = 0;
+    float alphaCutoff = 0.0f;
+    reader.ReadString(name);
+    reader.ReadWString(sourcePath);
+    reader.ReadString(sourceHash);
+    reader.Read(type);
+    reader.Read(format);
+    reader.Read(quality);
+    reader.Read(generateMips);
+    reader.Read(sRGB);
+    reader.Read(mipFilter);
+    reader.Read(normalMap);
+    reader.Read(alphaCutoff);
+    reader.ReadWString(cacheDdsPath);
+    reader.Read(cacheValid);
+    // 枚举值超出范围（文件损坏或过期）时同样视为损坏，回退到XML
+    if (!reader.IsComplete() || type > (uint8_t)TextureType::Texture2DArray ||
+        format > (uint8_t)TextureCompressionFormat::BC6H || quality > (uint8_t)TextureCompressionQuality::Ultra ||
+        mipFilter > (uint8_t)MipFilter::Lanczos) {
+        std::cout << "TextureAsset: corrupt texbin " << WStringToString(binPath) << std::endl;
+        return false;
+    }
+
+    if (!name.empty()) m_name = name;
+    m_sourcePath = sourcePath;
+    m_sourceHash = sourceHash;
+    m_desc.type = (TextureType)type;
+    m_desc.format = (TextureCompressionFormat)format;
+    m_desc.quality = (TextureCompressionQuality)quality;
+    m_desc.generateMips = generateMips != 0;
+    m_desc.sRGB = sRGB != 0;
+    m_desc.mipFilter = (MipFilter)mipFilter;
+    m_desc.normalMap = normalMap != 0;
+    m_desc.alphaCutoff = alphaCutoff;
+    m_cacheDdsPath = cacheDdsPath;
+    m_cacheValid = cacheValid != 0;
     return true;
 }
 
+bool TextureAsset::WriteAssetBin(const std::wstring& binPath, const std::wstring& xmlPath) {
+    AssetSourceInfo source;
+    if (!QueryAssetSourceInfo(xmlPath, true, source)) {
+        return false;
+    }
+
+    AssetBinWriter writer;
+    writer.WriteString(m_name);
+    writer.WriteWString(m_sourcePath);
+    writer.WriteString(m_sourceHash);
+    writer.Write((uint8_t)m_desc.type);
+    writer.Write((uint8_t)m_desc.format);
+    writer.Write((uint8_t)m_desc.quality);
+    writer.Write((uint8_t)(m_desc.generateMips ? 1 : 0));
+    writer.Write((uint8_t)(m_desc.sRGB ? 1 : 0));
+    writer.Write((uint8_t)m_desc.mipFilter);
+    writer.Write((uint8_t)(m_desc.normalMap ? 1 : 0));
+    writer.Write(m_desc.alphaCutoff);
+    writer.WriteWString(m_cacheDdsPath);
+    writer.Write((uint8_t)(m_cacheValid ? 1 : 0));
+    return writer.Save(binPath, kTextureBinMagic, kTextureBinVersion, source);
+}
+
 bool TextureAsset::WriteAssetXML(const std::wstring& xmlPath) {
     std::wofstream file(xmlPath);
     if (!file.is_open()) {
@@ -992,6 +1198,9 @@ bool TextureAsset::WriteAssetXML(const std::wstring& xmlPath) {
     file << L"    <Format>" << StringToWString(GetFormatName(m_desc.format)) << L"</Format>\n";
     file << L"    <GenerateMips>" << (m_desc.generateMips ? L"true" : L"false") << L"</GenerateMips>\n";
     file << L"    <sRGB>" << (m_desc.sRGB ? L"true" : L"false") << L"</sRGB>\n";
+    file << L"    <MipFilter>" << StringToWString(GetMipFilterName(m_desc.mipFilter)) << L"</MipFilter>\n";
+    file << L"    <NormalMap>" << (m_desc.normalMap ? L"true" : L"false") << L"</NormalMap>\n";
+    file << L"    <AlphaCutoff>" << m_desc.alphaCutoff << L"</AlphaCutoff>\n";
     file << L"  </Compression>\n";
 
     // Cache
@@ -0,0 +1,170 @@
+// TextureCacheIndex.cpp
+// 纹理烘焙缓存索引实现
+
+#include "public/Texture/TextureCacheIndex.h"
+#include "public/AssetBin.h"
+#include "public/HashUtils.h"
+#include "public/PathUtils.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+    constexpr uint32_t kIndexMagic = 0x49435446;    // "FTCI"
+    constexpr uint32_t kIndexVersion = 1;
+
+    template <typename T>
+    void AppendPod(std::vector<uint8_t>& out, const T& value) {
+        const uint8_t* bytes = (const uint8_t*)&value;
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    bool ReadPod(const std::vector<uint8_t>& data, size_t& cursor, T& outValue) {
+        if (cursor + sizeof(T) > data.size()) return false;
+        memcpy(&outValue, data.data() + cursor, sizeof(T));
+        cursor += sizeof(T);
+        return true;
+    }
+}
+
+TextureCacheIndex& TextureCacheIndex::GetInstance() {
+    static TextureCacheIndex instance;
+    return instance;
+}
+
+bool TextureCacheIndex::Initialize(const std::wstring& directory) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_directory = directory;
+    if (!m_directory.empty() && m_directory.back() != L'\\' && m_directory.back() != L'/') {
+        m_directory += L"\\";
+    }
+    if (!CreateDirectoryRecursive(m_directory.substr(0, m_directory.size() - 1))) {
+        std::wcout << L"TextureCacheIndex: Failed to create directory " << m_directory << std::endl;
+        m_directory.clear();
+        return false;
+    }
+
+    m_indexPath = m_directory + L"textures.idx";
+    LoadIndex();
+    std::cout << "TextureCacheIndex: " << m_sources.size() << " source files indexed" << std::endl;
+    return true;
+}
+
+void TextureCacheIndex::Shutdown() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_directory.empty()) {
+        if (m_dirty && !WriteIndex()) {
+            std::cout << "TextureCacheIndex: Failed to write index" << std::endl;
+        }
+        std::cout << "TextureCacheIndex: " << m_reusedCount << " source hashes reused, "
+                  << m_hashedCount << " computed" << std::endl;
+    }
+    m_sources.clear();
+    m_dirty = false;
+    m_directory.clear();
+}
+
+bool TextureCacheIndex::Flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_directory.empty() || !m_dirty) return true;
+    return WriteIndex();
+}
+
+bool TextureCacheIndex::LoadIndex() {
+    m_sources.clear();
+    m_dirty = false;
+
+    std::vector<uint8_t> index;
+    {
+        std::ifstream file(m_indexPath, std::ios::binary);
+        if (!file.is_open()) return false;
+        index.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    size_t cursor = 0;
+    uint32_t magic = 0, version = 0, entryCount = 0;
+    if (!ReadPod(index, cursor, magic) || magic != kIndexMagic ||
+        !ReadPod(index, cursor, version) || version != kIndexVersion ||
+        !ReadPod(index, cursor, entryCount)) {
+        std::cout << "TextureCacheIndex: Index format mismatch, source hashes discarded" << std::endl;
+        return false;
+    }
+
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        SourceRecord record;
+        uint16_t pathLength = 0;
+        if (!ReadPod(index, cursor, record.size) || !ReadPod(index, cursor, record.writeTime) ||
+            !ReadPod(index, cursor, record.hash) || !ReadPod(index, cursor, pathLength) ||
+            cursor + pathLength > index.size()) {
+            break;  // 索引被截断：保留已读到的记录
+        }
+        std::string path((const char*)index.data() + cursor, pathLength);
+        cursor += pathLength;
+        m_sources[AToW(path)] = record;
+    }
+    return true;
+}
+
+bool TextureCacheIndex::WriteIndex() {
+    std::vector<uint8_t> index;
+    AppendPod(index, kIndexMagic);
+    AppendPod(index, kIndexVersion);
+    AppendPod(index, (uint32_t)m_sources.size());
+    for (const auto& pair : m_sources) {
+        const std::string path = WToA(pair.first);
+        AppendPod(index, pair.second.size);
+        AppendPod(index, pair.second.writeTime);
+        AppendPod(index, pair.second.hash);
+        AppendPod(index, (uint16_t)path.size());
+        index.insert(index.end(), path.begin(), path.end());
+    }
+
+    if (!WriteFileAtomic(m_indexPath, index)) {
+        return false;
+    }
+    m_dirty = false;
+    return true;
+}
+
+bool TextureCacheIndex::GetSourceHash(const std::wstring& sourcePath, uint64_t& outHash) {
+    AssetSourceInfo info;
+    if (!QueryAssetSourceInfo(sourcePath, false, info)) {
+        return false;
+    }
+
+    const std::wstring key = NormalizePathKey(sourcePath);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_sources.find(key);
+        if (it != m_sources.end() && it->second.size == info.size && it->second.writeTime == info.writeTime) {
+            outHash = it->second.hash;
+            ++m_reusedCount;
+            return true;
+        }
+    }
+
+    // 读文件不持锁
+    if (!HashFileXXH64(sourcePath, info.hash)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_hashedCount;
+    if (!m_directory.empty()) {
+        SourceRecord& record = m_sources[key];
+        record.size = info.size;
+        record.writeTime = info.writeTime;
+        record.hash = info.hash;
+        m_dirty = true;
+    }
+    outHash = info.hash;
+    return true;
+}
+
+std::wstring TextureCacheIndex::GetCookedPath(uint64_t cookKey) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_directory.empty()) return L"";
+    return m_directory + AToW(HashToHexString(cookKey)) + L".dds";
+}
@@ -4,12 +4,65 @@
 #define NOMINMAX
 
 #include "public/Texture/TextureCompressor.h"
+#include "public/Material/ShaderBytecodeCache.h"
 #include "public/BattleFireDirect.h"
 #include "public/PathUtils.h"
 #include <d3dx12.h>
 #include <d3dcompiler.h>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <algorithm>
+#include <vector>
+
+namespace {
+    // 按扩展名选择DirectXTex的加载函数
+    HRESULT LoadSourceImage(const std::wstring& sourcePath, DirectX::TexMetadata& metadata, DirectX::ScratchImage& image) {
+        size_t dotPos = sourcePath.find_last_of(L'.');
+        std::wstring ext = dotPos == std::wstring::npos ? L"" : sourcePath.substr(dotPos);
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::towlower);
+
+        if (ext == L".dds") {
+            return DirectX::LoadFromDDSFile(sourcePath.c_str(), DirectX::DDS_FLAGS_NONE, &metadata, image);
+        }
+        if (ext == L".hdr") {
+            return DirectX::LoadFromHDRFile(sourcePath.c_str(), &metadata, image);
+        }
+        return DirectX::LoadFromWICFile(sourcePath.c_str(), DirectX::WIC_FLAGS_NONE, &metadata, image);
+    }
+
+    bool ToBlockFormat(TextureCompressionFormat format, BlockFormat& outFormat) {
+        switch (format) {
+        case TextureCompressionFormat::BC1: outFormat = BlockFormat::BC1; return true;
+        case TextureCompressionFormat::BC3: outFormat = BlockFormat::BC3; return true;
+        case TextureCompressionFormat::BC5: outFormat = BlockFormat::BC5; return true;
+        case TextureCompressionFormat::BC7: outFormat = BlockFormat::BC7; return true;
+        case TextureCompressionFormat::BC6H: outFormat = BlockFormat::BC6H; return true;
+        default:                            return false;
+        }
+    }
+
+    // 引擎编码器和mip生成器的输入：HDR（floatInput）为RGBA32F，其余为RGBA8；已经是该格式（含sRGB）时直接使用，字节按原样编码
+    HRESULT ConvertForBlockEncoder(const DirectX::ScratchImage& source, bool floatInput,
+                                   DirectX::ScratchImage& converted, const DirectX::ScratchImage*& outImage) {
+        const DXGI_FORMAT format = source.GetMetadata().format;
+        DXGI_FORMAT target = DXGI_FORMAT_R32G32B32A32_FLOAT;
+        if (!floatInput) {
+            if (format == DXGI_FORMAT_R8G8B8A8_UNORM || format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) {
+                outImage = &source;
+                return S_OK;
+            }
+            // 保持sRGB标记一致，避免Convert做伽马转换
+            target = DirectX::IsSRGB(format) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+        } else if (format == DXGI_FORMAT_R32G32B32A32_FLOAT) {
+            outImage = &source;
+            return S_OK;
+        }
+        outImage = &converted;
+        return DirectX::Convert(source.GetImages(), source.GetImageCount(), source.GetMetadata(), target,
+                                DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, converted);
+    }
+}
 
 // ========== 单例实现 ==========
 
@@ -74,11 +127,6 @@ bool TextureCompressor::Initialize(ID3D12Device* device) {
 
     m_device = device;
 
-    // 设置NVTT路径（在项目根目录的 Tools/ 下查找）
-    if (m_nvttPath.empty()) {
-        m_nvttPath = GetProjectRoot() + L"Tools\\NVIDIA Texture Tools\\nvtt_export.exe";
-    }
-
     // 编译计算着色器
     if (!CompileComputeShaders()) {
         std::cout << "TextureCompressor: Failed to compile compute shaders" << std::endl;
@@ -126,20 +174,16 @@ void TextureCompressor::Shutdown() {
 // ========== 内部初始化 ==========
 
 bool TextureCompressor::CompileComputeShaders() {
-    UINT compileFlags = 0;
-#ifdef _DEBUG
-    compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
-#endif
+    UINT compileFlags = ShaderBytecodeCache::GetDefaultCompileFlags();
 
     ComPtr<ID3DBlob> errorBlob;
     HRESULT hr;
 
     // 编译BC1压缩着色器
-    hr = D3DCompileFromFile(
-        L"Engine/Shader/Compression/BC1Compress.hlsl",
-        nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE,
+    hr = ShaderBytecodeCache::GetInstance().CompileFromFile(
+        L"Engine/Shader/Compression/BC1Compress.hlsl", nullptr,
         "CSMain", "cs_5_0",
-        compileFlags, 0,
+        compileFlags,
         &m_bc1ShaderBlob, &errorBlob
     );
     if (FAILED(hr)) {
@@ -150,11 +194,10 @@ bool TextureCompressor::CompileComputeShaders() {
     }
 
     // 编译BC3压缩着色器
-    hr = D3DCompileFromFile(
-        L"Engine/Shader/Compression/BC3Compress.hlsl",
-        nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE,
+    hr = ShaderBytecodeCache::GetInstance().CompileFromFile(
+        L"Engine/Shader/Compression/BC3Compress.hlsl", nullptr,
         "CSMain", "cs_5_0",
-        compileFlags, 0,
+        compileFlags,
         &m_bc3ShaderBlob, &errorBlob
     );
     if (FAILED(hr)) {
@@ -164,11 +207,10 @@ bool TextureCompressor::CompileComputeShaders() {
     }
 
     // 编译BC5压缩着色器
-    hr = D3DCompileFromFile(
-        L"Engine/Shader/Compression/BC5Compress.hlsl",
-        nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE,
+    hr = ShaderBytecodeCache::GetInstance().CompileFromFile(
+        L"Engine/Shader/Compression/BC5Compress.hlsl", nullptr,
         "CSMain", "cs_5_0",
-        compileFlags, 0,
+        compileFlags,
         &m_bc5ShaderBlob, &errorBlob
     );
     if (FAILED(hr)) {
@@ -517,6 +559,10 @@ bool TextureCompressor::CompressCPU(const DirectX::ScratchImage& sourceImage,
         return false;
     }
 
+    if (m_useBlockEncoder && SupportsBlockEncoder(format)) {
+        return CompressWithBlockEncoder(sourceImage, format, sRGB, quality, outCompressedImage);
+    }
+
     // 设置压缩标志
     DirectX::TEX_COMPRESS_FLAGS compressFlags = DirectX::TEX_COMPRESS_PARALLEL;
 
@@ -563,48 +609,24 @@ bool TextureCompressor::CompressAndSaveDDS(const std::wstring& sourcePath,
     // 加载源文件
     DirectX::ScratchImage sourceImage;
     DirectX::TexMetadata metadata;
-    HRESULT hr;
-
-    // 获取文件扩展名
-    std::wstring ext = sourcePath.substr(sourcePath.find_last_of(L'.'));
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::towlower);
-
-    if (ext == L".dds") {
-        hr = DirectX::LoadFromDDSFile(sourcePath.c_str(), DirectX::DDS_FLAGS_NONE, &metadata, sourceImage);
-    }
-    else if (ext == L".hdr") {
-        hr = DirectX::LoadFromHDRFile(sourcePath.c_str(), &metadata, sourceImage);
-    }
-    else {
-        hr = DirectX::LoadFromWICFile(sourcePath.c_str(), DirectX::WIC_FLAGS_NONE, &metadata, sourceImage);
-    }
-
+    HRESULT hr = LoadSourceImage(sourcePath, metadata, sourceImage);
     if (FAILED(hr)) {
         std::cout << "Failed to load source image" << std::endl;
         return false;
     }
 
-    // 生成mipmap（如果需要）
-    DirectX::ScratchImage mipChain;
-    if (generateMips && metadata.mipLevels == 1) {
-        hr = DirectX::GenerateMipMaps(
-            sourceImage.GetImages(),
-            sourceImage.GetImageCount(),
-            sourceImage.GetMetadata(),
-            DirectX::TEX_FILTER_DEFAULT,
-            0,  // 生成完整mipchain
-            mipChain
-        );
-
-        if (SUCCEEDED(hr)) {
-            sourceImage = std::move(mipChain);
-            metadata = sourceImage.GetMetadata();
+    // 生成mipmap（如果需要），生成时逐级压缩
+    DirectX::ScratchImage compressedImage;
+    if (generateMips && metadata.mipLevels == 1 && metadata.dimension != DirectX::TEX_DIMENSION_TEXTURE3D) {
+        MipGenerateSettings mipSettings;
+        mipSettings.sRGB = sRGB;
+        mipSettings.wrap = !metadata.IsCubemap();
+        if (!GenerateMipsAndCompress(sourceImage, format, sRGB, quality, mipSettings, compressedImage)) {
+            std::cout << "Compression failed" << std::endl;
+            return false;
         }
     }
-
-    // 压缩
-    DirectX::ScratchImage compressedImage;
-    if (format != TextureCompressionFormat::None) {
+    else if (format != TextureCompressionFormat::None) {
         if (!CompressCPU(sourceImage, format, sRGB, quality, compressedImage)) {
             std::cout << "Compression failed" << std::endl;
             return false;
@@ -632,150 +654,288 @@ bool TextureCompressor::CompressAndSaveDDS(const std::wstring& sourcePath,
     return true;
 }
 
-// ========== NVIDIA Texture Tools 压缩 ==========
+// ========== 引擎CPU编码器 ==========
+
+bool TextureCompressor::SupportsBlockEncoder(TextureCompressionFormat format) {
+    BlockFormat blockFormat;
+    return ToBlockFormat(format, blockFormat);
+}
 
-const char* TextureCompressor::GetNVTTQualityName(NVTTQuality quality) {
+BlockEncodeQuality TextureCompressor::GetBlockEncodeQuality(TextureCompressionQuality quality) {
     switch (quality) {
-    case NVTTQuality::Fastest:    return "Fastest";
-    case NVTTQuality::Normal:     return "Normal";
-    case NVTTQuality::Production: return "Production";
-    case NVTTQuality::Highest:    return "Highest";
-    default:                      return "Unknown";
+    case TextureCompressionQuality::Fast:   return BlockEncodeQuality::Fast;
+    case TextureCompressionQuality::Normal: return BlockEncodeQuality::Normal;
+    case TextureCompressionQuality::High:   return BlockEncodeQuality::High;
+    default:                                return BlockEncodeQuality::Ultra;
     }
 }
 
-bool TextureCompressor::IsNVTTAvailable() const {
-    // 检查nvtt_export.exe是否存在
-    DWORD attrs = GetFileAttributesW(m_nvttPath.c_str());
-    bool available = (attrs != INVALID_FILE_ATTRIBUTES && !(attrs & FILE_ATTRIBUTE_DIRECTORY));
-
-    // Debug output
-    std::wcout << L"IsNVTTAvailable: checking path: " << m_nvttPath << std::endl;
-    std::cout << "  File attributes: " << attrs << " (INVALID=" << INVALID_FILE_ATTRIBUTES << ")" << std::endl;
-    std::cout << "  Result: " << (available ? "available" : "not available") << std::endl;
-
-    return available;
+const char* TextureCompressor::GetQualityName(TextureCompressionQuality quality) {
+    switch (quality) {
+    case TextureCompressionQuality::Fast:   return "Fast";
+    case TextureCompressionQuality::Normal: return "Normal";
+    case TextureCompressionQuality::High:   return "High";
+    case TextureCompressionQuality::Ultra:  return "Ultra";
+    default:                                return "Unknown";
+    }
 }
 
-bool TextureCompressor::CompressWithNVTT(const std::wstring& sourcePath,
-                                          const std::wstring& outputDdsPath,
-                                          TextureCompressionFormat format,
-                                          bool generateMips,
-                                          bool sRGB,
-                                          NVTTQuality quality) {
-    // 检查NVTT是否可用
-    if (!IsNVTTAvailable()) {
-        std::cout << "NVTT not available, falling back to DirectXTex" << std::endl;
-        return CompressAndSaveDDS(sourcePath, outputDdsPath, format, generateMips, sRGB,
-                                  TextureCompressionQuality::High);
+bool TextureCompressor::CompressWithBlockEncoder(const DirectX::ScratchImage& sourceImage,
+                                                  TextureCompressionFormat format,
+                                                  bool sRGB,
+                                                  TextureCompressionQuality quality,
+                                                  DirectX::ScratchImage& outCompressedImage) {
+    BlockEncodeSettings settings;
+    if (!ToBlockFormat(format, settings.format)) {
+        return false;
     }
+    settings.quality = GetBlockEncodeQuality(quality);
 
-    // 构建命令行参数
-    // nvtt_export.exe 命令行格式:
-    // nvtt_export.exe -o output.dds --format bc3 [--mips] [--srgb] input.png
-
-    std::wstring formatArg;
-    switch (format) {
-    case TextureCompressionFormat::BC1:
-        formatArg = L"bc1";
-        break;
-    case TextureCompressionFormat::BC3:
-        formatArg = L"bc3";
-        break;
-    case TextureCompressionFormat::BC5:
-        formatArg = L"bc5";
-        break;
-    case TextureCompressionFormat::BC7:
-        formatArg = L"bc7";
-        break;
-    case TextureCompressionFormat::BC6H:
-        formatArg = L"bc6h";
-        break;
-    default:
-        formatArg = L"bc3";  // 默认BC3
-        break;
+    if (DirectX::IsCompressed(sourceImage.GetMetadata().format)) {
+        std::cout << "Block encoder: source image is already compressed" << std::endl;
+        return false;
     }
 
-    // 构建完整命令行
-    std::wstring cmdLine = L"\"" + m_nvttPath + L"\" ";
-    cmdLine += L"-o \"" + outputDdsPath + L"\" ";
-    cmdLine += L"--format " + formatArg + L" ";
-
-    if (generateMips) {
-        cmdLine += L"--mips ";
+    DirectX::ScratchImage converted;
+    const DirectX::ScratchImage* rgbaImage = nullptr;
+    HRESULT hr = ConvertForBlockEncoder(sourceImage, settings.format == BlockFormat::BC6H, converted, rgbaImage);
+    if (FAILED(hr)) {
+        std::cout << "Block encoder: failed to convert source image: " << std::hex << hr << std::dec << std::endl;
+        return false;
     }
 
-    if (sRGB) {
-        cmdLine += L"--srgb ";
+    // 与源图相同的mip/数组布局，只换成压缩格式
+    DirectX::TexMetadata metadata = rgbaImage->GetMetadata();
+    metadata.format = GetCompressedFormat(format, sRGB);
+    hr = outCompressedImage.Initialize(metadata);
+    if (FAILED(hr)) {
+        std::cout << "Block encoder: failed to allocate output image: " << std::hex << hr << std::dec << std::endl;
+        return false;
     }
 
-    // 使用传入的质量参数
-    cmdLine += L"--quality " + std::to_wstring(static_cast<int>(quality)) + L" ";
-
-    cmdLine += L"\"" + sourcePath + L"\"";
+    auto encodeStart = std::chrono::high_resolution_clock::now();
+    const DirectX::Image* sourceImages = rgbaImage->GetImages();
+    const DirectX::Image* destImages = outCompressedImage.GetImages();
+    for (size_t i = 0; i < rgbaImage->GetImageCount(); ++i) {
+        const DirectX::Image& source = sourceImages[i];
+        const DirectX::Image& dest = destImages[i];
+        if (dest.rowPitch != GetBlockRowPitch(settings.format, (uint32_t)source.width)) {
+            std::cout << "Block encoder: unexpected row pitch for image " << i << std::endl;
+            outCompressedImage.Release();
+            return false;
+        }
+        if (settings.format == BlockFormat::BC6H) {
+            EncodeSurfaceHDR(reinterpret_cast<const float*>(source.pixels), (uint32_t)source.width,
+                             (uint32_t)source.height, source.rowPitch, settings, dest.pixels);
+        } else {
+            EncodeSurface(source.pixels, (uint32_t)source.width, (uint32_t)source.height, source.rowPitch,
+                          settings, dest.pixels);
+        }
+    }
+    auto encodeEnd = std::chrono::high_resolution_clock::now();
 
-    std::wcout << L"Running NVTT: " << cmdLine << std::endl;
+    std::cout << "Block encoder: " << TextureAsset::GetFormatName(format) << " (" << GetQualityName(quality) << ") "
+              << metadata.width << "x" << metadata.height << ", " << rgbaImage->GetImageCount() << " images in "
+              << std::chrono::duration<double, std::milli>(encodeEnd - encodeStart).count() << " ms" << std::endl;
+    return true;
+}
 
-    // 创建进程
-    STARTUPINFOW si = { sizeof(si) };
-    PROCESS_INFORMATION pi = {};
+bool TextureCompressor::GenerateMipsAndCompress(const DirectX::ScratchImage& sourceImage,
+                                                 TextureCompressionFormat format,
+                                                 bool sRGB,
+                                                 TextureCompressionQuality quality,
+                                                 const MipGenerateSettings& mipSettings,
+                                                 DirectX::ScratchImage& outImage) {
+    const DirectX::TexMetadata& sourceMetadata = sourceImage.GetMetadata();
+    if (DirectX::IsCompressed(sourceMetadata.format) || sourceMetadata.dimension == DirectX::TEX_DIMENSION_TEXTURE3D) {
+        std::cout << "Mip generator: source must be an uncompressed 2D texture, array or cubemap" << std::endl;
+        return false;
+    }
 
-    si.dwFlags = STARTF_USESHOWWINDOW;
-    si.wShowWindow = SW_HIDE;  // 隐藏窗口
+    // HDR源（BC6H，或不压缩的浮点源）按RGBA32F滤波，本身就是线性值
+    const bool isHDR = format == TextureCompressionFormat::BC6H ||
+        (format == TextureCompressionFormat::None &&
+         DirectX::FormatDataType(sourceMetadata.format) == DirectX::FORMAT_TYPE_FLOAT);
+    MipGenerateSettings settings = mipSettings;
+    if (isHDR) {
+        settings.sRGB = false;
+    }
 
-    // 需要可修改的命令行缓冲区
-    std::vector<wchar_t> cmdBuffer(cmdLine.begin(), cmdLine.end());
-    cmdBuffer.push_back(L'\0');
+    BlockEncodeSettings blockSettings;
+    const bool encodeDirectly = m_useBlockEncoder && ToBlockFormat(format, blockSettings.format);
+    blockSettings.quality = GetBlockEncodeQuality(quality);
+    if (format != TextureCompressionFormat::None && GetCompressedFormat(format, sRGB) == DXGI_FORMAT_UNKNOWN) {
+        std::cout << "Unknown compression format" << std::endl;
+        return false;
+    }
 
-    BOOL success = CreateProcessW(
-        nullptr,           // 应用程序名（使用命令行）
-        cmdBuffer.data(),  // 命令行
-        nullptr,           // 进程安全属性
-        nullptr,           // 线程安全属性
-        FALSE,             // 不继承句柄
-        CREATE_NO_WINDOW,  // 不创建窗口
-        nullptr,           // 使用父进程环境
-        nullptr,           // 使用父进程目录
-        &si,
-        &pi
-    );
+    DirectX::ScratchImage converted;
+    const DirectX::ScratchImage* topImage = nullptr;
+    HRESULT hr = ConvertForBlockEncoder(sourceImage, isHDR, converted, topImage);
+    if (FAILED(hr)) {
+        std::cout << "Mip generator: failed to convert source image: " << std::hex << hr << std::dec << std::endl;
+        return false;
+    }
 
-    if (!success) {
-        DWORD error = GetLastError();
-        std::cout << "Failed to start NVTT process, error: " << error << std::endl;
-        std::cout << "Falling back to DirectXTex" << std::endl;
-        return CompressAndSaveDDS(sourcePath, outputDdsPath, format, generateMips, sRGB,
-                                  TextureCompressionQuality::High);
+    // 输出：完整mip链，直接编码时为压缩格式，否则为未压缩的RGBA
+    DirectX::TexMetadata metadata = topImage->GetMetadata();
+    metadata.mipLevels = GetMipLevelCount((uint32_t)metadata.width, (uint32_t)metadata.height);
+    if (settings.maxMipLevels > 0) {
+        metadata.mipLevels = std::min<size_t>(metadata.mipLevels, settings.maxMipLevels);
+    }
+    if (encodeDirectly) {
+        metadata.format = GetCompressedFormat(format, sRGB);
+    } else if (isHDR) {
+        metadata.format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    } else {
+        metadata.format = sRGB ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+    const bool needsCompressCPU = !encodeDirectly && format != TextureCompressionFormat::None;
+    DirectX::ScratchImage uncompressedChain;
+    DirectX::ScratchImage& target = needsCompressCPU ? uncompressedChain : outImage;
+    hr = target.Initialize(metadata);
+    if (FAILED(hr)) {
+        std::cout << "Mip generator: failed to allocate output image: " << std::hex << hr << std::dec << std::endl;
+        return false;
     }
 
-    // 等待进程完成（最多60秒）
-    DWORD waitResult = WaitForSingleObject(pi.hProcess, 60000);
+    auto generateStart = std::chrono::high_resolution_clock::now();
+    std::vector<uint8_t> ldrPixels;
+    for (size_t item = 0; item < metadata.arraySize; ++item) {
+        const DirectX::Image& top = *topImage->GetImage(0, item, 0);
+        MipImage mip;
+        if (isHDR) {
+            LoadMipImage(reinterpret_cast<const float*>(top.pixels), (uint32_t)top.width, (uint32_t)top.height,
+                         top.rowPitch, mip);
+        } else {
+            LoadMipImage(top.pixels, (uint32_t)top.width, (uint32_t)top.height, top.rowPitch, settings, mip);
+        }
 
-    DWORD exitCode = 0;
-    GetExitCodeProcess(pi.hProcess, &exitCode);
+        GenerateMipChain(std::move(mip), settings, [&](uint32_t level, const MipImage& image) {
+            const DirectX::Image& dest = *target.GetImage(level, item, 0);
+            const size_t floatRowPitch = (size_t)image.width * 4 * sizeof(float);
+            if (encodeDirectly && isHDR) {
+                EncodeSurfaceHDR(image.pixels.data(), image.width, image.height, floatRowPitch, blockSettings, dest.pixels);
+            } else if (encodeDirectly) {
+                ldrPixels.resize((size_t)image.width * image.height * 4);
+                StoreMipImage(image, settings, ldrPixels.data(), (size_t)image.width * 4);
+                EncodeSurface(ldrPixels.data(), image.width, image.height, (size_t)image.width * 4, blockSettings, dest.pixels);
+            } else if (isHDR) {
+                for (uint32_t y = 0; y < image.height; ++y) {
+                    memcpy(dest.pixels + y * dest.rowPitch, image.pixels.data() + (size_t)y * image.width * 4, floatRowPitch);
+                }
+            } else {
+                StoreMipImage(image, settings, dest.pixels, dest.rowPitch);
+            }
+        });
+    }
+    auto generateEnd = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Mip generator: " << GetMipFilterName(settings.filter) << " " << metadata.width << "x" << metadata.height
+              << ", " << metadata.mipLevels << " levels x " << metadata.arraySize << " images"
+              << (encodeDirectly ? " (encoded per level)" : "") << " in "
+              << std::chrono::duration<double, std::milli>(generateEnd - generateStart).count() << " ms" << std::endl;
+
+    if (needsCompressCPU) {
+        return CompressCPU(uncompressedChain, format, sRGB, quality, outImage);
+    }
+    return true;
+}
 
-    CloseHandle(pi.hProcess);
-    CloseHandle(pi.hThread);
+bool TextureCompressor::CompareWithDirectXTex(const std::wstring& sourcePath,
+                                               TextureCompressionFormat format,
+                                               TextureCompressionQuality quality,
+                                               BlockEncoderComparison& outResult) {
+    BlockEncodeSettings settings;
+    if (!ToBlockFormat(format, settings.format)) {
+        std::cout << "Encoder comparison only supports BC1/BC3/BC5/BC7/BC6H" << std::endl;
+        return false;
+    }
+    settings.quality = GetBlockEncodeQuality(quality);
 
-    if (waitResult == WAIT_TIMEOUT) {
-        std::cout << "NVTT process timed out" << std::endl;
+    DirectX::ScratchImage sourceImage;
+    DirectX::TexMetadata metadata;
+    HRESULT hr = LoadSourceImage(sourcePath, metadata, sourceImage);
+    if (FAILED(hr) || DirectX::IsCompressed(metadata.format)) {
+        std::cout << "Encoder comparison: failed to load uncompressed source " << WToA(sourcePath) << std::endl;
         return false;
     }
 
-    if (exitCode != 0) {
-        std::cout << "NVTT process failed with exit code: " << exitCode << std::endl;
-        std::cout << "Falling back to DirectXTex" << std::endl;
-        return CompressAndSaveDDS(sourcePath, outputDdsPath, format, generateMips, sRGB,
-                                  TextureCompressionQuality::High);
+    DirectX::ScratchImage converted;
+    const DirectX::ScratchImage* rgbaImage = nullptr;
+    if (FAILED(ConvertForBlockEncoder(sourceImage, settings.format == BlockFormat::BC6H, converted, rgbaImage))) {
+        std::cout << "Encoder comparison: failed to convert source image" << std::endl;
+        return false;
     }
+    const DirectX::Image& reference = *rgbaImage->GetImage(0, 0, 0);
+    const uint32_t width = (uint32_t)reference.width;
+    const uint32_t height = (uint32_t)reference.height;
+
+    outResult = BlockEncoderComparison();
+    outResult.width = width;
+    outResult.height = height;
+
+    // 引擎编码器（BC6H解码为RGBA32F，用色调映射后的PSNR）
+    const bool isHDR = settings.format == BlockFormat::BC6H;
+    const float* referenceHDR = reinterpret_cast<const float*>(reference.pixels);
+    std::vector<uint8_t> blocks(GetEncodedSurfaceSize(settings.format, width, height));
+    auto encodeStart = std::chrono::high_resolution_clock::now();
+    if (isHDR) {
+        EncodeSurfaceHDR(referenceHDR, width, height, reference.rowPitch, settings, blocks.data());
+    } else {
+        EncodeSurface(reference.pixels, width, height, reference.rowPitch, settings, blocks.data());
+    }
+    auto encodeEnd = std::chrono::high_resolution_clock::now();
+    outResult.engineMs = std::chrono::duration<double, std::milli>(encodeEnd - encodeStart).count();
+    if (isHDR) {
+        std::vector<float> decoded((size_t)width * height * 4);
+        DecodeSurfaceHDR(blocks.data(), width, height, decoded.data(), (size_t)width * 4 * sizeof(float));
+        outResult.enginePSNR = ComputeHDRPSNR(referenceHDR, reference.rowPitch, decoded.data(),
+                                              (size_t)width * 4 * sizeof(float), width, height);
+    } else {
+        std::vector<uint8_t> decoded((size_t)width * height * 4);
+        DecodeSurface(blocks.data(), settings.format, width, height, decoded.data(), (size_t)width * 4);
+        outResult.enginePSNR = ComputeBlockPSNR(settings.format, reference.pixels, reference.rowPitch,
+                                                decoded.data(), (size_t)width * 4, width, height);
+    }
+
+    // DirectXTex：使用均匀的通道权重，与PSNR的度量一致
+    const bool sRGB = DirectX::IsSRGB(reference.format);
+    DirectX::ScratchImage compressed;
+    encodeStart = std::chrono::high_resolution_clock::now();
+    hr = DirectX::Compress(reference, GetCompressedFormat(format, sRGB),
+                           DirectX::TEX_COMPRESS_PARALLEL | DirectX::TEX_COMPRESS_UNIFORM,
+                           DirectX::TEX_THRESHOLD_DEFAULT, compressed);
+    encodeEnd = std::chrono::high_resolution_clock::now();
+    if (FAILED(hr)) {
+        std::cout << "Encoder comparison: DirectXTex compression failed: " << std::hex << hr << std::dec << std::endl;
+        return false;
+    }
+    outResult.directXTexMs = std::chrono::duration<double, std::milli>(encodeEnd - encodeStart).count();
 
-    // 验证输出文件是否存在
-    DWORD attrs = GetFileAttributesW(outputDdsPath.c_str());
-    if (attrs == INVALID_FILE_ATTRIBUTES) {
-        std::cout << "NVTT output file not found" << std::endl;
+    DXGI_FORMAT decompressedFormat = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    if (!isHDR) {
+        decompressedFormat = DirectX::IsSRGB(compressed.GetMetadata().format) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+                                                                              : DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+    DirectX::ScratchImage decompressed;
+    hr = DirectX::Decompress(*compressed.GetImage(0, 0, 0), decompressedFormat, decompressed);
+    if (FAILED(hr)) {
+        std::cout << "Encoder comparison: DirectXTex decompression failed: " << std::hex << hr << std::dec << std::endl;
         return false;
     }
+    const DirectX::Image& directXTexDecoded = *decompressed.GetImage(0, 0, 0);
+    if (isHDR) {
+        outResult.directXTexPSNR = ComputeHDRPSNR(referenceHDR, reference.rowPitch,
+                                                  reinterpret_cast<const float*>(directXTexDecoded.pixels),
+                                                  directXTexDecoded.rowPitch, width, height);
+    } else {
+        outResult.directXTexPSNR = ComputeBlockPSNR(settings.format, reference.pixels, reference.rowPitch,
+                                                    directXTexDecoded.pixels, directXTexDecoded.rowPitch, width, height);
+    }
 
-    std::wcout << L"NVTT compression successful: " << outputDdsPath << std::endl;
+    std::cout << "Encoder comparison " << TextureAsset::GetFormatName(format) << " (" << GetQualityName(quality) << ") "
+              << width << "x" << height << ": engine " << outResult.enginePSNR << " dB / " << outResult.engineMs
+              << " ms, DirectXTex " << outResult.directXTexPSNR << " dB / " << outResult.directXTexMs << " ms" << std::endl;
     return true;
 }
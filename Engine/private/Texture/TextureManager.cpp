@@ -5,7 +5,9 @@
 
 #include "public/Texture/TextureManager.h"
 #include "public/Texture/TextureCompressor.h"
+#include "public/Texture/TextureCacheIndex.h"
 #include "public/BattleFireDirect.h"
+#include "public/PathUtils.h"
 #include <d3dx12.h>
 #include <iostream>
 #include <algorithm>
@@ -42,6 +44,8 @@ TextureManager& TextureManager::GetInstance() {
 }
 
 TextureManager::TextureManager() {
+    m_streamer.SetBudget(kDefaultStreamingBudget);
+    m_streamer.SetMaxUploadBytes(kStreamingUploadPerUpdate);
 }
 
 TextureManager::~TextureManager() {
@@ -79,6 +83,9 @@ bool TextureManager::Initialize(ID3D12Device* device) {
         }
     }
 
+    // 源文件哈希索引和烘焙结果都在这个目录下
+    TextureCacheIndex::GetInstance().Initialize(m_cacheDir);
+
     std::wcout << L"TextureManager cache dir: " << m_cacheDir << std::endl;
     std::cout << "TextureManager initialized with " << MAX_TEXTURES << " SRV slots" << std::endl;
     return true;
@@ -88,9 +95,19 @@ void TextureManager::Shutdown() {
     // 卸载所有纹理
     UnloadAllTextures();
 
+    // 调用前GPU已空闲
+    {
+        std::lock_guard<std::mutex> lock(m_streamingMutex);
+        m_streamingUploads.clear();
+        m_pendingStreamingActions.clear();
+    }
+
     // 释放压缩器
     m_compressor.reset();
 
+    // 写回源文件哈希索引
+    TextureCacheIndex::GetInstance().Shutdown();
+
     // 释放SRV堆
     m_srvHeap.Reset();
 
@@ -322,6 +339,30 @@ TextureAsset* TextureManager::GetTextureByPath(const std::wstring& path) {
     return nullptr;
 }
 
+int TextureManager::ReloadTexturesFromFile(const std::wstring& changedPath, std::vector<TextureAsset*>& outReloaded) {
+    std::lock_guard<std::mutex> lock(m_textureMutex);
+
+    const std::wstring changedKey = NormalizePathKey(changedPath);
+    int count = 0;
+    for (auto& pair : m_textures) {
+        TextureAsset* texture = pair.second.get();
+        if (!texture) continue;
+        // .texture.ast改了设置，或者它引用的源图片被重新保存
+        const bool matches = (!texture->GetAssetPath().empty() && NormalizePathKey(texture->GetAssetPath()) == changedKey) ||
+                             (!texture->GetSourcePath().empty() && NormalizePathKey(texture->GetSourcePath()) == changedKey);
+        if (!matches) continue;
+
+        if (!m_commandList || !texture->ReloadFromDisk(m_device, m_commandList)) {
+            std::cout << "TextureManager: Failed to reload texture '" << pair.first << "'" << std::endl;
+            continue;
+        }
+        std::cout << "TextureManager: Reloaded texture '" << pair.first << "'" << std::endl;
+        outReloaded.push_back(texture);
+        count++;
+    }
+    return count;
+}
+
 // ========== 纹理卸载 ==========
 
 void TextureManager::UnloadTexture(const std::string& name) {
@@ -400,6 +441,159 @@ bool TextureManager::ValidateCache(const std::wstring& assetPath) {
     return false;
 }
 
+// ========== 纹理流送 ==========
+
+void TextureManager::SetStreamingBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_streamingMutex);
+    m_streamer.SetBudget(bytes);
+}
+
+size_t TextureManager::GetStreamingBudget() const {
+    std::lock_guard<std::mutex> lock(m_streamingMutex);
+    return (size_t)m_streamer.GetBudget();
+}
+
+void TextureManager::RegisterStreaming(TextureAsset* texture) {
+    if (!texture || !texture->IsStreamable()) return;
+
+    StreamingTextureDesc desc;
+    desc.width = texture->GetWidth();
+    desc.height = texture->GetHeight();
+    desc.tailMip = texture->GetStreamingTailMip();
+    desc.residentMip = texture->GetResidentMip();
+    desc.pinned = texture->IsStreamingPinned();
+    for (UINT mip = 0; mip < texture->GetMipLevels(); ++mip) {
+        desc.mipBytes.push_back(TextureAsset::CalculateMemorySize(
+            std::max(1u, desc.width >> mip), std::max(1u, desc.height >> mip), 1, texture->GetCompressionFormat()));
+    }
+
+    std::lock_guard<std::mutex> lock(m_streamingMutex);
+    const int oldId = texture->GetStreamingId();
+    if (oldId >= 0 && oldId < (int)m_streamingTextures.size() && m_streamingTextures[oldId] == texture) {
+        m_streamer.Unregister(oldId);
+        m_streamingTextures[oldId] = nullptr;
+    }
+    const int id = m_streamer.Register(desc);
+    if (id >= (int)m_streamingTextures.size()) {
+        m_streamingTextures.resize(id + 1, nullptr);
+    }
+    m_streamingTextures[id] = texture;
+    texture->SetStreamingId(id);
+}
+
+void TextureManager::UnregisterStreaming(TextureAsset* texture) {
+    if (!texture) return;
+
+    std::lock_guard<std::mutex> lock(m_streamingMutex);
+    const int id = texture->GetStreamingId();
+    if (id >= 0 && id < (int)m_streamingTextures.size() && m_streamingTextures[id] == texture) {
+        m_streamer.Unregister(id);
+        m_streamingTextures[id] = nullptr;
+    }
+    texture->SetStreamingId(-1);
+
+    // 未完成的上传随纹理一起丢弃（卸载纹理前GPU已空闲）
+    m_streamingUploads.erase(std::remove_if(m_streamingUploads.begin(), m_streamingUploads.end(),
+        [texture](const StreamingUpload& upload) { return upload.texture == texture; }), m_streamingUploads.end());
+}
+
+void TextureManager::SetStreamingPinned(TextureAsset* texture, bool pinned) {
+    if (!texture) return;
+
+    std::lock_guard<std::mutex> lock(m_streamingMutex);
+    texture->SetStreamingPinned(pinned);
+    m_streamer.SetPinned(texture->GetStreamingId(), pinned);
+}
+
+void TextureManager::RequestStreaming(TextureAsset* texture, float pixelsPerUV) {
+    if (!texture || texture->GetStreamingId() < 0) return;
+
+    std::lock_guard<std::mutex> lock(m_streamingMutex);
+    m_streamer.RequestScreenSize(texture->GetStreamingId(), pixelsPerUV);
+}
+
+bool TextureManager::UpdateStreaming() {
+    if (!m_streamingEnabled) return false;
+
+    std::lock_guard<std::mutex> lock(m_streamingMutex);
+    if (!m_pendingStreamingActions.empty()) return true;
+    if (++m_streamingFrame < kStreamingUpdateInterval) return false;
+    // 上一批上传切换之前不计算新的变化（决策基于常驻mip，切换后才更新）
+    if (!m_streamingUploads.empty()) return false;
+    m_streamingFrame = 0;
+
+    m_streamer.Update(m_pendingStreamingActions);
+    return !m_pendingStreamingActions.empty();
+}
+
+int TextureManager::ApplyStreaming(ID3D12GraphicsCommandList* commandList, std::vector<TextureAsset*>& outChanged) {
+    const UINT64 completed = GetCompletedFenceValue();
+
+    // 纹理重建和切换时不持锁（首次加载会回调RegisterStreaming）
+    std::vector<StreamingUpload> finished;
+    std::vector<std::pair<TextureAsset*, StreamingAction>> work;
+    {
+        std::lock_guard<std::mutex> lock(m_streamingMutex);
+        // 切换会在原槽位重写着色器可见的SRV，在途帧的命令列表仍在读这些描述符（重写属于未定义行为）
+        // 所以有上传完成时等所有已提交的帧执行完，再一起切换：上传都录制在之前的帧，此时全部完成
+        // 最多等一帧，且上一批切换之前UpdateStreaming不会计算新的变化，至多每kStreamingUpdateInterval帧一次
+        bool anyFinished = false;
+        for (const StreamingUpload& upload : m_streamingUploads) {
+            if (upload.fenceValue <= completed) anyFinished = true;
+        }
+        if (anyFinished) {
+            WaitForFenceValue(GetSubmittedFenceValue());
+            finished.swap(m_streamingUploads);
+        }
+
+        for (const StreamingAction& action : m_pendingStreamingActions) {
+            if (action.textureId < 0 || action.textureId >= (int)m_streamingTextures.size()) continue;
+            // 计算之后纹理被卸载或重新登记时跳过
+            TextureAsset* texture = m_streamingTextures[action.textureId];
+            if (texture && texture->GetResidentMip() == action.fromMip) work.push_back(std::make_pair(texture, action));
+        }
+        m_pendingStreamingActions.clear();
+    }
+    if (!commandList || !m_device) return 0;
+
+    // 切换：GPU已空闲，在录制本帧命令之前替换，被替换的资源没有在途帧引用，直接释放
+    int count = 0;
+    for (const StreamingUpload& upload : finished) {
+        std::vector<ComPtr<ID3D12Resource>> replaced;
+        if (!upload.texture->CommitStreamedMips(m_device, replaced)) continue;
+
+        std::lock_guard<std::mutex> lock(m_streamingMutex);
+        m_streamer.SetResidentMip(upload.textureId, upload.texture->GetResidentMip());
+        outChanged.push_back(upload.texture);
+        count++;
+    }
+
+    // 上传：录制到本帧命令列表，本帧提交的栅栏值完成后切换
+    const UINT64 uploadFence = GetSubmittedFenceValue() + 1;
+    for (const auto& item : work) {
+        TextureAsset* texture = item.first;
+        const StreamingAction& action = item.second;
+        if (!texture->StreamMips(m_device, commandList, action.toMip)) {
+            std::cout << "TextureManager: Failed to stream mips of '" << texture->GetName() << "'" << std::endl;
+            continue;
+        }
+        if (!texture->HasPendingStreamedMips()) continue;
+
+        std::lock_guard<std::mutex> lock(m_streamingMutex);
+        StreamingUpload upload;
+        upload.texture = texture;
+        upload.textureId = action.textureId;
+        upload.fenceValue = uploadFence;
+        m_streamingUploads.push_back(upload);
+    }
+    return count;
+}
+
+StreamingStats TextureManager::GetStreamingStats() const {
+    std::lock_guard<std::mutex> lock(m_streamingMutex);
+    return m_streamer.GetStats();
+}
+
 // ========== 统计信息 ==========
 
 size_t TextureManager::GetTotalMemoryUsage() const {
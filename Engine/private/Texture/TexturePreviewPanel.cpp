@@ -6,6 +6,8 @@
 #include "public/Texture/TexturePreviewPanel.h"
 #include "public/Texture/TextureManager.h"
 #include "public/Texture/TextureCompressor.h"
+#include "public/Material/ShaderBytecodeCache.h"
+#include "public/PipelineStateCache.h"
 #include "public/BattleFireDirect.h"
 #include "imgui.h"
 #include <d3dx12.h>
@@ -246,11 +248,11 @@ bool TexturePreviewPanel::CreatePreviewShaders() {
 
     // 编译顶点着色器
     ComPtr<ID3DBlob> errorBlob;
-    HRESULT hr = D3DCompile(
+    HRESULT hr = ShaderBytecodeCache::GetInstance().Compile(
         shaderCode, strlen(shaderCode),
-        "PreviewShader", nullptr, nullptr,
+        "PreviewShader", nullptr,
         "VSMain", "vs_5_0",
-        D3DCOMPILE_OPTIMIZATION_LEVEL3, 0,
+        D3DCOMPILE_OPTIMIZATION_LEVEL3,
         &m_vsBlob, &errorBlob);
 
     if (FAILED(hr)) {
@@ -261,11 +263,11 @@ bool TexturePreviewPanel::CreatePreviewShaders() {
     }
 
     // 编译像素着色器
-    hr = D3DCompile(
+    hr = ShaderBytecodeCache::GetInstance().Compile(
         shaderCode, strlen(shaderCode),
-        "PreviewShader", nullptr, nullptr,
+        "PreviewShader", nullptr,
         "PSMain", "ps_5_0",
-        D3DCOMPILE_OPTIMIZATION_LEVEL3, 0,
+        D3DCOMPILE_OPTIMIZATION_LEVEL3,
         &m_psBlob, &errorBlob);
 
     if (FAILED(hr)) {
@@ -330,6 +332,8 @@ bool TexturePreviewPanel::CreatePreviewRootSignature() {
         std::cout << "Failed to create root signature" << std::endl;
         return false;
     }
+    PipelineStateCache::GetInstance().RegisterRootSignature(m_previewRootSignature.Get(),
+        signature->GetBufferPointer(), signature->GetBufferSize());
 
     return true;
 }
@@ -356,7 +360,7 @@ bool TexturePreviewPanel::CreatePreviewPSO() {
     psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
     psoDesc.SampleDesc.Count = 1;
 
-    HRESULT hr = m_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_previewPSO));
+    HRESULT hr = PipelineStateCache::GetInstance().CreateGraphicsPipelineState(m_device, psoDesc, &m_previewPSO);
     if (FAILED(hr)) {
         std::cout << "Failed to create preview PSO" << std::endl;
         return false;
@@ -442,9 +446,14 @@ void TexturePreviewPanel::RenderTextureToPreviewRT() {
 // ========== 纹理设置 ==========
 
 void TexturePreviewPanel::SetTexture(TextureAsset* texture) {
+    // 预览中的纹理固定为完整mip链，不参与流送丢弃
+    if (m_currentTexture && m_currentTexture != texture) {
+        TextureManager::GetInstance().SetStreamingPinned(m_currentTexture, false);
+    }
     m_currentTexture = texture;
 
     if (texture) {
+        TextureManager::GetInstance().SetStreamingPinned(texture, true);
         CreatePreviewSRV();
         m_showWindow = true;
 
@@ -456,6 +465,17 @@ void TexturePreviewPanel::SetTexture(TextureAsset* texture) {
 
         // 同步压缩格式选择
         m_selectedFormat = texture->GetCompressionFormat();
+        m_selectedQuality = texture->GetDesc().quality;
+        m_mipFilter = texture->GetDesc().mipFilter;
+        m_normalMap = texture->GetDesc().normalMap;
+        m_alphaCutoff = texture->GetDesc().alphaCutoff;
+        m_hasEncoderComparison = false;
+    }
+}
+
+void TexturePreviewPanel::OnTextureResourceChanged(TextureAsset* texture) {
+    if (texture && texture == m_currentTexture) {
+        CreatePreviewSRV();
     }
 }
 
@@ -797,6 +817,9 @@ void TexturePreviewPanel::RenderInfoPanel() {
     ImGui::Text("Width: %u", m_currentTexture->GetWidth());
     ImGui::Text("Height: %u", m_currentTexture->GetHeight());
     ImGui::Text("Mip Levels: %u", m_currentTexture->GetMipLevels());
+    if (m_currentTexture->IsStreamable()) {
+        ImGui::Text("Resident Mips: %u-%u", m_currentTexture->GetResidentMip(), m_currentTexture->GetMipLevels() - 1);
+    }
     ImGui::Unindent();
 
     ImGui::Spacing();
@@ -833,43 +856,32 @@ void TexturePreviewPanel::RenderCompressionSettings() {
         return;
     }
 
-    // NVTT 开关
-    bool useNVTT = TextureAsset::GetUseNVTT();
-    if (ImGui::Checkbox("Use NVIDIA Texture Tools", &useNVTT)) {
-        TextureAsset::SetUseNVTT(useNVTT);
+    // 引擎编码器开关
+    TextureCompressor& compressor = TextureCompressor::GetInstance();
+    bool useBlockEncoder = compressor.GetUseBlockEncoder();
+    if (ImGui::Checkbox("Use Engine Block Encoder", &useBlockEncoder)) {
+        compressor.SetUseBlockEncoder(useBlockEncoder);
     }
     if (ImGui::IsItemHovered()) {
-        ImGui::SetTooltip("Use NVIDIA Texture Tools for high-quality compression.\nFalls back to DirectXTex if NVTT is unavailable.");
+        ImGui::SetTooltip("Encode all BC formats in-process with the engine encoder.\nWhen unchecked, DirectXTex is used instead.");
     }
 
-    // 显示NVTT状态
-    if (useNVTT) {
-        if (TextureCompressor::GetInstance().IsNVTTAvailable()) {
-            ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "NVTT: Available");
-
-            // NVTT质量选择
-            const char* qualityNames[] = { "Fastest", "Normal", "Production", "Highest" };
-            int currentQuality = static_cast<int>(TextureCompressor::GetInstance().GetNVTTQuality());
-            if (ImGui::Combo("Quality", &currentQuality, qualityNames, IM_ARRAYSIZE(qualityNames))) {
-                TextureCompressor::GetInstance().SetNVTTQuality(
-                    static_cast<TextureCompressor::NVTTQuality>(currentQuality));
-            }
+    // 质量选择
+    const char* qualityNames[] = { "Fast", "Normal", "High", "Ultra" };
+    int currentQuality = static_cast<int>(m_selectedQuality);
+    if (ImGui::Combo("Quality", &currentQuality, qualityNames, IM_ARRAYSIZE(qualityNames))) {
+        m_selectedQuality = static_cast<TextureCompressionQuality>(currentQuality);
+    }
 
-            // 质量说明
-            const char* qualityDesc = "";
-            switch (static_cast<TextureCompressor::NVTTQuality>(currentQuality)) {
-            case TextureCompressor::NVTTQuality::Fastest:    qualityDesc = "Fast compression, lower quality"; break;
-            case TextureCompressor::NVTTQuality::Normal:     qualityDesc = "Balanced speed and quality"; break;
-            case TextureCompressor::NVTTQuality::Production: qualityDesc = "High quality (recommended)"; break;
-            case TextureCompressor::NVTTQuality::Highest:    qualityDesc = "Best quality, slowest"; break;
-            }
-            ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "%s", qualityDesc);
-        } else {
-            ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "NVTT: Not Found (using DirectXTex)");
-        }
-    } else {
-        ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "Using DirectXTex");
+    // 质量说明
+    const char* qualityDesc = "";
+    switch (m_selectedQuality) {
+    case TextureCompressionQuality::Fast:   qualityDesc = "Bounding box endpoints, fastest"; break;
+    case TextureCompressionQuality::Normal: qualityDesc = "Principal axis fit, balanced"; break;
+    case TextureCompressionQuality::High:   qualityDesc = "Iterative refinement, more block modes"; break;
+    case TextureCompressionQuality::Ultra:  qualityDesc = "Endpoint search, best quality, slowest"; break;
     }
+    ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "%s", qualityDesc);
 
     ImGui::Spacing();
     ImGui::Separator();
@@ -902,10 +914,50 @@ void TexturePreviewPanel::RenderCompressionSettings() {
     ImGui::Checkbox("Generate Mipmaps", &m_generateMips);
     ImGui::Checkbox("sRGB Color Space", &m_sRGB);
 
+    // mip生成设置
+    if (m_generateMips) {
+        const char* mipFilterNames[] = { "Box", "Kaiser", "Lanczos" };
+        int currentMipFilter = static_cast<int>(m_mipFilter);
+        if (ImGui::Combo("Mip Filter", &currentMipFilter, mipFilterNames, IM_ARRAYSIZE(mipFilterNames))) {
+            m_mipFilter = static_cast<MipFilter>(currentMipFilter);
+        }
+        ImGui::Checkbox("Normal Map", &m_normalMap);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Renormalize normals in every mip level (no sRGB conversion).");
+        }
+        ImGui::SliderFloat("Alpha Cutoff", &m_alphaCutoff, 0.0f, 1.0f, m_alphaCutoff > 0.0f ? "%.2f" : "Off");
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Alpha test threshold: scale alpha per mip to keep the same coverage as the top level.");
+        }
+    }
+
     ImGui::Spacing();
     ImGui::Separator();
 
-    bool hasChanges = (m_selectedFormat != m_currentTexture->GetCompressionFormat());
+    // 引擎编码器与DirectXTex对比（源图顶层mip）
+    if (TextureCompressor::SupportsBlockEncoder(m_selectedFormat) && !m_currentTexture->GetSourcePath().empty()) {
+        if (ImGui::Button("Compare with DirectXTex", ImVec2(-1, 0))) {
+            m_hasEncoderComparison = compressor.CompareWithDirectXTex(
+                m_currentTexture->GetSourcePath(), m_selectedFormat, m_selectedQuality, m_encoderComparison);
+        }
+        if (m_hasEncoderComparison) {
+            const double megapixels = (double)m_encoderComparison.width * m_encoderComparison.height / 1000000.0;
+            ImGui::Text("%ux%u", m_encoderComparison.width, m_encoderComparison.height);
+            ImGui::Text("Engine:     %.2f dB, %.1f ms (%.1f Mpix/s)", m_encoderComparison.enginePSNR,
+                        m_encoderComparison.engineMs, megapixels * 1000.0 / std::max(m_encoderComparison.engineMs, 0.001));
+            ImGui::Text("DirectXTex: %.2f dB, %.1f ms (%.1f Mpix/s)", m_encoderComparison.directXTexPSNR,
+                        m_encoderComparison.directXTexMs, megapixels * 1000.0 / std::max(m_encoderComparison.directXTexMs, 0.001));
+        }
+        ImGui::Spacing();
+        ImGui::Separator();
+    }
+
+    const TextureAssetDesc& desc = m_currentTexture->GetDesc();
+    bool hasChanges = (m_selectedFormat != m_currentTexture->GetCompressionFormat()) ||
+                      (m_selectedQuality != desc.quality) ||
+                      (m_mipFilter != desc.mipFilter) ||
+                      (m_normalMap != desc.normalMap) ||
+                      (m_alphaCutoff != desc.alphaCutoff);
 
     if (hasChanges) {
         ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.6f, 0.2f, 1.0f));
@@ -919,6 +971,13 @@ void TexturePreviewPanel::RenderCompressionSettings() {
         if (device && cmdList) {
             m_currentTexture->SetGenerateMips(m_generateMips);
             m_currentTexture->SetSRGB(m_sRGB);
+            m_currentTexture->SetCompressionQuality(m_selectedQuality);
+            m_currentTexture->SetMipFilter(m_mipFilter);
+            m_currentTexture->SetNormalMap(m_normalMap);
+            m_currentTexture->SetAlphaCutoff(m_alphaCutoff);
+
+            // 旧纹理资源可能仍被在途帧引用，替换前等待GPU完成
+            WaitForCompletionOfCommandList();
 
             if (m_currentTexture->ApplyCompression(m_selectedFormat, device, cmdList)) {
                 std::cout << "Compression applied: " << formatNames[currentFormat] << std::endl;
@@ -0,0 +1,279 @@
+// TextureStreaming.cpp
+// 纹理流送策略实现：目标mip先取请求与当前常驻中更清晰的一级（不需要的高mip在预算内保留，避免来回加载），
+// 超出预算时每次从丢弃优先级最高的纹理去掉最精细的一级，直到回到预算内
+
+#include "public/Texture/TextureStreaming.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace {
+    uint32_t MipDimension(uint32_t size, uint32_t mip) {
+        return std::max(1u, size >> mip);
+    }
+
+    // 丢弃候选：多余的高mip（比本轮需要的更清晰）优先，其次还没加载的mip（放弃加载，不让已常驻的纹理来回换出换入），
+    // 再次最久未请求，最后丢弃一级省下的字节多
+    struct EvictCandidate {
+        int textureId;
+        bool surplus;
+        bool notResident;
+        uint64_t lastRequestRound;
+        uint64_t savings;
+    };
+
+    struct EvictLess {
+        // priority_queue顶部为最先丢弃的候选
+        bool operator()(const EvictCandidate& a, const EvictCandidate& b) const {
+            if (a.surplus != b.surplus) return !a.surplus;
+            if (a.notResident != b.notResident) return !a.notResident;
+            if (a.lastRequestRound != b.lastRequestRound) return a.lastRequestRound > b.lastRequestRound;
+            if (a.savings != b.savings) return a.savings < b.savings;
+            return a.textureId > b.textureId;
+        }
+    };
+}
+
+uint32_t GetStreamingTailMip(uint32_t width, uint32_t height, uint32_t mipCount, uint32_t tailSize, bool blockCompressed) {
+    if (tailSize == 0 || mipCount == 0) return 0;
+
+    uint32_t tail = 0;
+    while (tail + 1 < mipCount && std::max(MipDimension(width, tail), MipDimension(height, tail)) > tailSize) {
+        ++tail;
+    }
+
+    if (blockCompressed) {
+        // 资源顶层的宽高必须是4的倍数；某一级不满足后更粗的级别也不能作为顶层（否则中间级别的尺寸对不上）
+        uint32_t limit = 0;
+        while (limit + 1 < mipCount &&
+               MipDimension(width, limit + 1) % 4 == 0 && MipDimension(height, limit + 1) % 4 == 0) {
+            ++limit;
+        }
+        tail = std::min(tail, limit);
+    }
+    return tail;
+}
+
+uint32_t ComputeStreamingMip(uint32_t width, uint32_t height, uint32_t mipCount, float pixelsPerUV, float mipBias) {
+    if (mipCount == 0) return 0;
+    const uint32_t coarsest = mipCount - 1;
+    if (!(pixelsPerUV > 0.0f)) return coarsest;
+
+    const float texelsPerPixel = (float)std::max(width, height) / pixelsPerUV;
+    const float mip = std::floor(std::log2(texelsPerPixel) + mipBias);
+    if (!(mip > 0.0f)) return 0;
+    return mip >= (float)coarsest ? coarsest : (uint32_t)mip;
+}
+
+// ========== 注册 ==========
+
+int TextureStreamer::Register(const StreamingTextureDesc& desc) {
+    int id;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    } else {
+        id = (int)m_entries.size();
+        m_entries.push_back(Entry());
+    }
+
+    Entry& entry = m_entries[id];
+    entry = Entry();
+    entry.active = true;
+    entry.pinned = desc.pinned;
+    entry.width = desc.width;
+    entry.height = desc.height;
+    entry.mipCount = std::max(1u, (uint32_t)desc.mipBytes.size());
+    entry.tailMip = std::min(desc.tailMip, entry.mipCount - 1);
+    entry.residentMip = std::min(desc.residentMip, entry.tailMip);
+    entry.requestedMip = entry.tailMip;
+    entry.lastRequestRound = 0;
+
+    entry.bytesFrom.assign(entry.mipCount + 1, 0);
+    for (uint32_t mip = (uint32_t)desc.mipBytes.size(); mip-- > 0;) {
+        entry.bytesFrom[mip] = entry.bytesFrom[mip + 1] + desc.mipBytes[mip];
+    }
+
+    m_stats.residentBytes += entry.bytesFrom[entry.residentMip];
+    m_stats.textureCount++;
+    return id;
+}
+
+void TextureStreamer::Unregister(int textureId) {
+    if (!IsRegistered(textureId)) return;
+
+    Entry& entry = m_entries[textureId];
+    m_stats.residentBytes -= entry.bytesFrom[entry.residentMip];
+    m_stats.textureCount--;
+    entry = Entry();
+    m_freeIds.push_back(textureId);
+}
+
+bool TextureStreamer::IsRegistered(int textureId) const {
+    return textureId >= 0 && textureId < (int)m_entries.size() && m_entries[textureId].active;
+}
+
+void TextureStreamer::SetPinned(int textureId, bool pinned) {
+    if (IsRegistered(textureId)) {
+        m_entries[textureId].pinned = pinned;
+    }
+}
+
+// ========== 反馈 ==========
+
+void TextureStreamer::Request(int textureId, uint32_t mip) {
+    if (!IsRegistered(textureId)) return;
+
+    Entry& entry = m_entries[textureId];
+    mip = std::min(mip, entry.tailMip);
+    if (entry.lastRequestRound != m_round) {
+        entry.lastRequestRound = m_round;
+        entry.requestedMip = mip;
+    } else {
+        entry.requestedMip = std::min(entry.requestedMip, mip);
+    }
+}
+
+void TextureStreamer::RequestScreenSize(int textureId, float pixelsPerUV, float mipBias) {
+    if (!IsRegistered(textureId)) return;
+
+    const Entry& entry = m_entries[textureId];
+    Request(textureId, ComputeStreamingMip(entry.width, entry.height, entry.mipCount, pixelsPerUV, mipBias));
+}
+
+uint32_t TextureStreamer::GetWantedMip(const Entry& entry) const {
+    if (entry.pinned) return 0;
+    return entry.lastRequestRound == m_round ? entry.requestedMip : entry.tailMip;
+}
+
+// ========== 常驻决策 ==========
+
+void TextureStreamer::Update(std::vector<StreamingAction>& outActions) {
+    std::vector<uint32_t> targets(m_entries.size(), 0);
+    uint64_t totalBytes = 0;
+    uint64_t requestedBytes = 0;
+
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const Entry& entry = m_entries[i];
+        if (!entry.active) continue;
+        const uint32_t wanted = GetWantedMip(entry);
+        targets[i] = std::min(wanted, entry.residentMip);
+        totalBytes += entry.bytesFrom[targets[i]];
+        requestedBytes += entry.bytesFrom[wanted];
+    }
+
+    // 超出预算：逐级丢弃，固定的纹理和尾部mip不参与
+    const uint64_t budget = m_stats.budgetBytes;
+    if (budget > 0 && totalBytes > budget) {
+        std::priority_queue<EvictCandidate, std::vector<EvictCandidate>, EvictLess> candidates;
+        auto pushCandidate = [&](int id) {
+            const Entry& entry = m_entries[id];
+            const uint32_t target = targets[id];
+            if (entry.pinned || target >= entry.tailMip) return;
+            EvictCandidate candidate;
+            candidate.textureId = id;
+            candidate.surplus = target < GetWantedMip(entry);
+            candidate.notResident = target < entry.residentMip;
+            candidate.lastRequestRound = entry.lastRequestRound;
+            candidate.savings = entry.bytesFrom[target] - entry.bytesFrom[target + 1];
+            candidates.push(candidate);
+        };
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            if (m_entries[i].active) pushCandidate((int)i);
+        }
+
+        while (totalBytes > budget && !candidates.empty()) {
+            const EvictCandidate candidate = candidates.top();
+            candidates.pop();
+            targets[candidate.textureId]++;
+            totalBytes -= candidate.savings;
+            pushCandidate(candidate.textureId);
+        }
+    }
+
+    // 丢弃：不需要上传新数据，全部列出
+    std::vector<int> loads;
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const Entry& entry = m_entries[i];
+        if (!entry.active || targets[i] == entry.residentMip) continue;
+        if (targets[i] < entry.residentMip) {
+            loads.push_back((int)i);
+            continue;
+        }
+        StreamingAction action;
+        action.textureId = (int)i;
+        action.fromMip = entry.residentMip;
+        action.toMip = targets[i];
+        action.bytes = entry.bytesFrom[targets[i]];
+        outActions.push_back(action);
+    }
+
+    // 加载：固定的纹理优先，其次与需要相差级数多的，再次上传量小的
+    std::sort(loads.begin(), loads.end(), [&](int a, int b) {
+        const Entry& ea = m_entries[a];
+        const Entry& eb = m_entries[b];
+        if (ea.pinned != eb.pinned) return ea.pinned;
+        const uint32_t gapA = ea.residentMip - targets[a];
+        const uint32_t gapB = eb.residentMip - targets[b];
+        if (gapA != gapB) return gapA > gapB;
+        if (ea.bytesFrom[targets[a]] != eb.bytesFrom[targets[b]]) return ea.bytesFrom[targets[a]] < eb.bytesFrom[targets[b]];
+        return a < b;
+    });
+
+    // 重建资源时整个常驻范围都要重新上传，按变化后的常驻字节数计上传量
+    uint64_t uploadBytes = 0;
+    int issued = 0;
+    int pending = 0;
+    for (int id : loads) {
+        const uint64_t bytes = m_entries[id].bytesFrom[targets[id]];
+        if (m_maxUploadBytes > 0 && issued > 0 && uploadBytes + bytes > m_maxUploadBytes) {
+            pending++;
+            continue;
+        }
+        StreamingAction action;
+        action.textureId = id;
+        action.fromMip = m_entries[id].residentMip;
+        action.toMip = targets[id];
+        action.bytes = bytes;
+        outActions.push_back(action);
+        uploadBytes += bytes;
+        issued++;
+    }
+
+    // 因预算而达不到请求的纹理也算作待加载
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const Entry& entry = m_entries[i];
+        if (entry.active && targets[i] > GetWantedMip(entry)) pending++;
+    }
+
+    m_stats.requestedBytes = requestedBytes;
+    m_stats.pendingLoads = pending;
+    m_round++;
+}
+
+void TextureStreamer::SetResidentMip(int textureId, uint32_t mip) {
+    if (!IsRegistered(textureId)) return;
+
+    Entry& entry = m_entries[textureId];
+    mip = std::min(mip, entry.mipCount - 1);
+    if (mip == entry.residentMip) return;
+
+    if (mip < entry.residentMip) {
+        m_stats.loadCount++;
+    } else {
+        m_stats.evictCount++;
+    }
+    m_stats.residentBytes -= entry.bytesFrom[entry.residentMip];
+    m_stats.residentBytes += entry.bytesFrom[mip];
+    entry.residentMip = mip;
+}
+
+uint32_t TextureStreamer::GetResidentMip(int textureId) const {
+    return IsRegistered(textureId) ? m_entries[textureId].residentMip : 0;
+}
+
+uint64_t TextureStreamer::GetResidentBytes(int textureId) const {
+    if (!IsRegistered(textureId)) return 0;
+    const Entry& entry = m_entries[textureId];
+    return entry.bytesFrom[entry.residentMip];
+}
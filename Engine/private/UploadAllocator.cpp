@@ -0,0 +1,212 @@
+// UploadAllocator.cpp
+// 逐帧线性上传分配器实现
+
+#include "public/UploadAllocator.h"
+#include "public/BattleFireDirect.h"
+#include <cstring>
+
+LinearUploadAllocator& LinearUploadAllocator::GetInstance() {
+    static LinearUploadAllocator instance;
+    return instance;
+}
+
+LinearUploadAllocator::~LinearUploadAllocator() {
+    Shutdown();
+}
+
+bool LinearUploadAllocator::Initialize(ID3D12Device* device, uint64_t capacity) {
+    m_device = device;
+    return CreateBuffer(capacity);
+}
+
+void LinearUploadAllocator::Shutdown() {
+    for (RetiredBuffer& retired : m_retiredBuffers) {
+        retired.resource->Unmap(0, nullptr);
+        retired.resource->Release();
+    }
+    m_retiredBuffers.clear();
+
+    if (m_buffer) {
+        m_buffer->Unmap(0, nullptr);
+        m_buffer->Release();
+        m_buffer = nullptr;
+    }
+    m_mappedData = nullptr;
+    m_gpuBase = 0;
+    m_capacity = 0;
+    m_head = m_tail = 0;
+    m_usedBytes = m_frameBytes = 0;
+    m_pendingFrames.clear();
+}
+
+bool LinearUploadAllocator::CreateBuffer(uint64_t capacity) {
+    if (!m_device) return false;
+
+    D3D12_HEAP_PROPERTIES heapProperties = {};
+    heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width = capacity;
+    desc.Height = 1;
+    desc.DepthOrArraySize = 1;
+    desc.MipLevels = 1;
+    desc.Format = DXGI_FORMAT_UNKNOWN;
+    desc.SampleDesc.Count = 1;
+    desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+    ID3D12Resource* buffer = nullptr;
+    if (FAILED(m_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &desc,
+            D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&buffer)))) {
+        OutputDebugStringA("LinearUploadAllocator - Failed to create upload buffer\n");
+        return false;
+    }
+
+    // 持久映射，GPU只读，CPU不读取
+    D3D12_RANGE readRange = { 0, 0 };
+    void* mapped = nullptr;
+    if (FAILED(buffer->Map(0, &readRange, &mapped))) {
+        OutputDebugStringA("LinearUploadAllocator - Failed to map upload buffer\n");
+        buffer->Release();
+        return false;
+    }
+    buffer->SetName(L"FrameUploadRing");
+
+    m_buffer = buffer;
+    m_mappedData = (uint8_t*)mapped;
+    m_gpuBase = buffer->GetGPUVirtualAddress();
+    m_capacity = capacity;
+    m_head = m_tail = 0;
+    m_usedBytes = 0;
+    return true;
+}
+
+void LinearUploadAllocator::BeginFrame() {
+    RetireFrames(false);
+}
+
+void LinearUploadAllocator::EndFrame(uint64_t fenceValue) {
+    if (m_frameBytes > 0) {
+        FrameMarker marker;
+        marker.fenceValue = fenceValue;
+        marker.endOffset = m_head;
+        marker.bytes = m_frameBytes;
+        m_pendingFrames.push_back(marker);
+    }
+    for (RetiredBuffer& retired : m_retiredBuffers) {
+        if (retired.fenceValue == 0) retired.fenceValue = fenceValue;
+    }
+
+    m_lastFrameBytes = m_frameTotalBytes;
+    if (m_frameTotalBytes > m_peakFrameBytes) m_peakFrameBytes = m_frameTotalBytes;
+    m_frameBytes = 0;
+    m_frameTotalBytes = 0;
+}
+
+void LinearUploadAllocator::RetireFrames(bool wait) {
+    uint64_t completed = GetCompletedFenceValue();
+    if (wait && !m_pendingFrames.empty() && completed < m_pendingFrames.front().fenceValue) {
+        WaitForFenceValue(m_pendingFrames.front().fenceValue);
+        completed = GetCompletedFenceValue();
+    }
+
+    while (!m_pendingFrames.empty() && m_pendingFrames.front().fenceValue <= completed) {
+        m_tail = m_pendingFrames.front().endOffset;
+        m_usedBytes -= m_pendingFrames.front().bytes;
+        m_pendingFrames.pop_front();
+    }
+
+    for (size_t i = 0; i < m_retiredBuffers.size();) {
+        RetiredBuffer& retired = m_retiredBuffers[i];
+        if (retired.fenceValue != 0 && retired.fenceValue <= completed) {
+            retired.resource->Unmap(0, nullptr);
+            retired.resource->Release();
+            m_retiredBuffers[i] = m_retiredBuffers.back();
+            m_retiredBuffers.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+bool LinearUploadAllocator::TryAllocate(uint64_t size, uint64_t alignment, uint64_t& outOffset) {
+    if (m_usedBytes == 0) {
+        m_head = m_tail = 0;
+    }
+
+    uint64_t aligned = (m_head + alignment - 1) & ~(alignment - 1);
+    uint64_t consumed = 0;
+    if (m_usedBytes == 0 || m_head > m_tail) {
+        // 空闲区为 [head, capacity) 和 [0, tail)
+        if (aligned + size <= m_capacity) {
+            outOffset = aligned;
+            consumed = aligned + size - m_head;
+        } else if (size <= m_tail) {
+            // 回绕到开头，尾部剩余空间算作本帧占用
+            outOffset = 0;
+            consumed = (m_capacity - m_head) + size;
+        } else {
+            return false;
+        }
+    } else if (m_head < m_tail) {
+        // 空闲区为 [head, tail)
+        if (aligned + size > m_tail) return false;
+        outOffset = aligned;
+        consumed = aligned + size - m_head;
+    } else {
+        return false;  // head == tail 且有占用：环已满
+    }
+
+    m_head = outOffset + size;
+    m_usedBytes += consumed;
+    m_frameBytes += consumed;
+    m_frameTotalBytes += consumed;
+    return true;
+}
+
+bool LinearUploadAllocator::Allocate(uint64_t size, uint64_t alignment, UploadAllocation& outAllocation) {
+    if (!m_buffer || size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        return false;
+    }
+
+    uint64_t offset = 0;
+    while (!TryAllocate(size, alignment, offset)) {
+        if (!m_pendingFrames.empty()) {
+            RetireFrames(true);
+            continue;
+        }
+
+        // 只剩当前帧仍不够：换一块更大的上传堆，旧堆等本帧执行完再释放
+        uint64_t newCapacity = m_capacity * 2;
+        while (newCapacity < size + alignment) newCapacity *= 2;
+
+        char msg[128];
+        sprintf_s(msg, "LinearUploadAllocator - Growing upload ring %llu KB -> %llu KB\n",
+            m_capacity / 1024, newCapacity / 1024);
+        OutputDebugStringA(msg);
+
+        RetiredBuffer retired;
+        retired.resource = m_buffer;
+        m_retiredBuffers.push_back(retired);
+        m_buffer = nullptr;
+        m_frameBytes = 0;
+        if (!CreateBuffer(newCapacity)) {
+            return false;
+        }
+    }
+
+    outAllocation.cpuAddress = m_mappedData + offset;
+    outAllocation.gpuAddress = m_gpuBase + offset;
+    outAllocation.size = size;
+    return true;
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS LinearUploadAllocator::AllocateConstants(const void* data, uint64_t size) {
+    UploadAllocation allocation;
+    if (!Allocate(size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT, allocation)) {
+        return 0;
+    }
+    memcpy(allocation.cpuAddress, data, (size_t)size);
+    return allocation.gpuAddress;
+}
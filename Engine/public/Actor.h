@@ -4,10 +4,12 @@
 #include <DirectXMath.h>
 #include <d3d12.h>
 #include "BattleFireDirect.h"
+#include "Mesh/MeshTypes.h"
 
 // Forward declarations
 class StaticMeshComponent;
 class MaterialInstance;
+class ActorSpatialIndex;
 
 // Actor Transform information
 struct Transform {
@@ -28,8 +30,12 @@ struct Transform {
 struct MeshAssetInfo {
     std::string meshName;
     std::string fbxPath;              // Relative path, e.g. "Content/Actor/FBX/sphere.fbx"
+    std::string meshBinPath;          // Cooked mesh, e.g. "Content/Actor/MeshBin/sphere.meshbin" (optional)
     std::string defaultMaterial;      // Default material name, e.g. "DefaultPBR"
 
+    // Cooked mesh path; defaults to fbxPath with a .meshbin extension when not specified
+    std::string GetMeshBinPath() const;
+
     // Serialization/Deserialization
     bool SaveToFile(const std::wstring& filepath) const;
     bool LoadFromFile(const std::wstring& filepath);
@@ -46,7 +52,7 @@ public:
 
     // Transform operations
     void SetTransform(const Transform& transform);
-    Transform& GetTransform() { return m_transform; }
+    Transform& GetTransform() { OnBoundsChanged(); return m_transform; }
     const Transform& GetTransform() const { return m_transform; }
 
     void SetPosition(const DirectX::XMFLOAT3& pos);
@@ -68,24 +74,20 @@ public:
     const MeshAssetInfo& GetMeshAssetInfo() const { return m_meshAssetInfo; }
 
     // Setter
-    void SetMesh(StaticMeshComponent* mesh) { m_mesh = mesh; }
+    // mesh须已从MeshManager获取引用（Acquire/AddRef），原来的mesh释放引用
+    void SetMesh(StaticMeshComponent* mesh);
     void SetMaterial(MaterialInstance* material) { m_material = material; }
 
-    // Constant Buffer管理
-    ID3D12Resource* GetConstantBuffer() const { return m_constantBuffer; }
-    void CreateConstantBuffer(ID3D12Device* device);
-    void UpdateConstantBuffer(const DirectX::XMMATRIX& viewMatrix, const DirectX::XMMATRIX& projMatrix,
-                             const DirectX::XMFLOAT3& lightDir, const DirectX::XMFLOAT3& cameraPos,
-                             float skylightIntensity, const DirectX::XMFLOAT3& skylightColor,
-                             const DirectX::XMMATRIX& invProjMatrix, const DirectX::XMMATRIX& invViewMatrix,
-                             const DirectX::XMMATRIX& lightViewProjMatrix,
-                             const DirectX::XMMATRIX& previousViewProjMatrix,
-                             const DirectX::XMFLOAT2& jitterOffset, const DirectX::XMFLOAT2& previousJitterOffset,
-                             int viewportWidth, int viewportHeight,
-                             float nearPlane, float farPlane,
-                             const DirectX::XMMATRIX& currentViewProjMatrix,
-                             int shadowMode = 2,
-                             int giType = 0);
+    // 逐实例数据（实例化绘制用），每帧调用一次：上一帧的ModelMatrix保留为prevModelMatrix
+    // frameIndex为Scene的帧序号；上一帧没有更新（不可见）时上一帧矩阵不可信，视为静止
+    void UpdateInstanceData(uint64_t frameIndex);
+    const InstanceData& GetInstanceData() const { return m_instanceData; }
+
+    // 世界空间包围体（Mesh局部包围体经Transform变换，Transform或Mesh变化后惰性重算）
+    const MeshBounds& GetWorldBounds();
+
+    // 空间索引代理ID（未加入索引时为-1）
+    int GetSpatialProxy() const { return m_spatialProxy; }
 
     // Is selected (for editor)
     bool IsSelected() const { return m_isSelected; }
@@ -100,10 +102,22 @@ private:
     StaticMeshComponent* m_mesh;
     MaterialInstance* m_material;
 
-    // Constant Buffer（每个Actor独立）
-    ID3D12Resource* m_constantBuffer;
-    void* m_mappedConstantBuffer;
-    SceneCBData m_cbData;  // 使用共享CB结构体
+    // 实例数据（由Scene写入实例缓冲，替代原来每个Actor独立的SceneCBData）
+    InstanceData m_instanceData;
+    uint64_t m_instanceDataFrame = 0;  // 最近一次UpdateInstanceData的帧序号（0表示从未更新）
+
+    // 世界空间包围体缓存
+    MeshBounds m_worldBounds;
+    bool m_worldBoundsDirty = true;
+    void UpdateWorldBounds();
+    // Transform/Mesh变化：标记包围体过期，并登记到空间索引等待更新
+    void OnBoundsChanged();
+
+    // 空间索引（由ActorSpatialIndex维护）
+    friend class ActorSpatialIndex;
+    ActorSpatialIndex* m_spatialIndex = nullptr;
+    int m_spatialProxy = -1;
+    bool m_spatialDirty = false;
 
     // Editor state
     bool m_isSelected;
@@ -0,0 +1,87 @@
+// AssetBin.h
+// 烘焙资产通用部分（材质.matbin、纹理.texbin）：文件头（魔数、格式版本、源文件信息）+ 顺序读写的数据块
+// 字符串按"uint32长度 + UTF-8字节"存储；读取只有一次文件读和内存拷贝，不依赖COM，可在任意线程调用
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// 源文件信息（用于判断烘焙结果是否过期）
+struct AssetSourceInfo {
+    uint64_t hash = 0;       // 源文件内容XXH64
+    uint64_t size = 0;       // 源文件大小
+    uint64_t writeTime = 0;  // 源文件最后修改时间（FILETIME）
+};
+
+// 文件头
+struct AssetBinHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t payloadSize;    // 文件头之后的数据字节数
+    AssetSourceInfo source;
+};
+static_assert(sizeof(AssetBinHeader) == 40, "AssetBinHeader layout changed, bump asset format versions");
+
+// 读取源文件大小和修改时间，computeHash为true时同时计算内容哈希
+bool QueryAssetSourceInfo(const std::wstring& sourcePath, bool computeHash, AssetSourceInfo& outInfo);
+
+// 只读取文件头并校验魔数和版本
+bool ReadAssetBinHeader(const std::wstring& binPath, uint32_t magic, uint32_t version, AssetBinHeader& outHeader);
+
+// 烘焙文件是否可以直接使用（规则同MeshCooker::CookIfStale）：
+// 1. 没有源文件（只发布了烘焙结果）时，烘焙文件有效即可
+// 2. 源文件大小和修改时间与记录一致：直接使用
+// 3. 不一致时比较内容哈希：相同则原地刷新记录的时间戳，不同则过期
+bool IsAssetBinUpToDate(const std::wstring& sourcePath, const std::wstring& binPath, uint32_t magic, uint32_t version);
+
+// 顺序写出数据，Save时加上文件头并原子替换目标文件
+class AssetBinWriter {
+public:
+    template <typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "AssetBinWriter::Write requires a POD type");
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        m_payload.insert(m_payload.end(), bytes, bytes + sizeof(T));
+    }
+    void WriteString(const std::string& str);
+    void WriteWString(const std::wstring& str);     // 转为UTF-8存储
+
+    bool Save(const std::wstring& filePath, uint32_t magic, uint32_t version, const AssetSourceInfo& source) const;
+
+private:
+    std::vector<uint8_t> m_payload;
+};
+
+// 整块读入后顺序解析；任何一次越界读取之后IsComplete都返回false
+class AssetBinReader {
+public:
+    // 读入文件并校验魔数、版本和数据长度
+    bool Open(const std::wstring& filePath, uint32_t magic, uint32_t version);
+    const AssetBinHeader& GetHeader() const { return m_header; }
+
+    template <typename T>
+    bool Read(T& outValue) {
+        static_assert(std::is_trivially_copyable<T>::value, "AssetBinReader::Read requires a POD type");
+        if (m_failed || m_payload.size() - m_cursor < sizeof(T)) {
+            m_failed = true;
+            return false;
+        }
+        memcpy(&outValue, m_payload.data() + m_cursor, sizeof(T));
+        m_cursor += sizeof(T);
+        return true;
+    }
+    bool ReadString(std::string& outStr);
+    bool ReadWString(std::wstring& outStr);
+
+    // 数据恰好读完且没有越界（数据有多余字节说明格式不匹配）
+    bool IsComplete() const { return !m_failed && m_cursor == m_payload.size(); }
+
+private:
+    AssetBinHeader m_header = {};
+    std::vector<uint8_t> m_payload;
+    size_t m_cursor = 0;
+    bool m_failed = false;
+};
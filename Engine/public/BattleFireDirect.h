@@ -34,11 +34,13 @@ ID3D12RootSignature* InitRootSignature();
 // inMainFunctionName: 着色器入口函数名
 // inTarget: 着色器目标版本，如"vs_5_0","ps_5_0","vs_4_0"
 // inShader: 输出的着色器字节码
+// inDefines: 预处理宏（以{nullptr, nullptr}结尾），可为空
 void CreateShaderFromFile(
     LPCTSTR inShaderFilePath,
     const char* inMainFunctionName,
     const char* inTarget,
-    D3D12_SHADER_BYTECODE* inShader);
+    D3D12_SHADER_BYTECODE* inShader,
+    const D3D_SHADER_MACRO* inDefines = nullptr);
 
 // 创建常量缓冲区对象
 // inDataLen: 缓冲区数据长度
@@ -77,15 +79,39 @@ ID3D12GraphicsCommandList* GetCommandList();
 // 获取命令分配器
 ID3D12CommandAllocator* GetCommandAllocator();
 
-// 等待命令列表执行完成
+// 等待命令列表执行完成（等待所有已提交的工作，包括在途的帧）
 void WaitForCompletionOfCommandList();
 
 // 刷新GPU命令队列（用于分辨率变更等需要完全同步的场景）
 void FlushGPU();
 
+// 最后一次提交（EndCommandList）的栅栏值 / GPU已完成的栅栏值
+UINT64 GetSubmittedFenceValue();
+UINT64 GetCompletedFenceValue();
+
+// 等待GPU执行到指定栅栏值
+void WaitForFenceValue(UINT64 fenceValue);
+
 // 结束命令列表并执行
 void EndCommandList();
 
+// ========== 帧上下文 ==========
+// 每帧使用独立的命令分配器，整帧只录制并提交一次命令列表；
+// BeginFrame只等待kFramesInFlight帧之前使用同一上下文的那一帧，CPU录制第N+1帧与GPU执行第N帧重叠
+constexpr UINT kFramesInFlight = 2;
+
+// 开始一帧：等待当前帧上下文上次提交的工作完成，重置其命令分配器并打开命令列表
+ID3D12GraphicsCommandList* BeginFrame(ID3D12PipelineState* inInitialPSO = nullptr);
+
+// 结束一帧：关闭并提交命令列表，记录本帧栅栏值，切换到下一个帧上下文
+void EndFrame();
+
+// 当前帧上下文下标 [0, kFramesInFlight)
+UINT GetFrameIndex();
+
+// 上一次BeginFrame中等待GPU的时间（毫秒），接近0表示GPU没有拖慢CPU
+double GetFrameWaitTimeMs();
+
 void BeginOffscreen(ID3D12GraphicsCommandList* commandList);
 
 // 开始渲染到交换链
@@ -138,7 +164,7 @@ ID3D12PipelineState* CreateFullscreenPSO(
 // ========== 共享 CB 结构体 ==========
 
 // 场景常量缓冲区数据布局（176 floats = 704 bytes）
-// Scene::Update() 和 Actor::UpdateConstantBuffer() 共用
+// Scene::Update() 填充，所有Pass共享（逐Actor变换在InstanceData中）
 struct SceneCBData {
     DirectX::XMFLOAT4X4 projMatrix;           // [0-15]
     DirectX::XMFLOAT4X4 viewMatrix;           // [16-31]
@@ -160,7 +186,15 @@ struct SceneCBData {
     float padding[3];                          // [173-175]
 };
 
-// 填充 SceneCBData（共享逻辑，Scene和Actor都调用）
+// 逐实例数据（48 floats = 192 bytes），与Shader中的StructuredBuffer<InstanceData>一致
+// 实例化绘制时通过根签名Slot 3绑定，VS按SV_InstanceID索引
+struct InstanceData {
+    DirectX::XMFLOAT4X4 modelMatrix;          // [0-15]
+    DirectX::XMFLOAT4X4 normalMatrix;         // [16-31]
+    DirectX::XMFLOAT4X4 prevModelMatrix;      // [32-47] 上一帧ModelMatrix（Motion Vector）
+};
+
+// 填充 SceneCBData（Scene::Update调用）
 void FillSceneCBData(SceneCBData& out,
     const DirectX::XMMATRIX& viewMatrix,
     const DirectX::XMMATRIX& projMatrix,
@@ -52,6 +52,9 @@ public:
     float GetNearPlane() const { return m_nearZ; }
     float GetFarPlane() const { return m_farZ; }
 
+    // 垂直视野角度（弧度，用于纹理流送估算屏幕尺寸）
+    float GetFov() const { return m_fov; }
+
 private:
     DirectX::XMFLOAT3 m_position;       // 相机位置
     DirectX::XMFLOAT3 m_rotation;       // 相机旋转角度（俯仰、偏航、翻滚）
@@ -0,0 +1,107 @@
+// DrawList.h
+// 绘制列表 — 每帧按64位排序键（PSO/材质/网格/深度）基数排序，提交时跳过与上一次相同的渲染状态
+// 模块只处理不透明句柄，不依赖D3D，可以单独测试
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 绘制包：排序键 + 提交时需要的状态句柄
+struct DrawPacket {
+    uint64_t sortKey = 0;
+    const void* pipelineState = nullptr;
+    const void* material = nullptr;
+    const void* mesh = nullptr;
+    void* userData = nullptr;       // 调用方数据（Scene中为Actor*）
+};
+
+// 绘制批次：排序后PSO/材质/网格都相同的连续绘制包，可合并为一次实例化绘制
+struct DrawBatch {
+    uint32_t firstPacket = 0;
+    uint32_t packetCount = 0;
+    uint32_t firstInstance = 0;     // 在实例缓冲中的起始下标（实例按绘制包顺序写入时等于firstPacket）
+};
+
+class DrawList {
+public:
+    // 排序键布局（高位优先）：PSO 12位 | 材质 16位 | 网格 20位 | 深度 16位
+    static constexpr int PipelineBits = 12;
+    static constexpr int MaterialBits = 16;
+    static constexpr int MeshBits = 20;
+    static constexpr int DepthBits = 16;
+
+    // 清空绘制包和本帧的句柄ID表
+    void Reset();
+
+    // 添加绘制包；depth01为归一化视深度[0,1]，同状态内从前往后排列（利于Early-Z）
+    void Add(const void* pipelineState, const void* material, const void* mesh, float depth01, void* userData);
+
+    // 按排序键升序排列（稳定）
+    void Sort();
+
+    // 把排序后的连续同状态绘制包合并为批次（Sort之后调用）；maxBatchSize为0时不限制
+    void BuildBatches(std::vector<DrawBatch>& outBatches, uint32_t maxBatchSize = 0) const;
+
+    size_t GetCount() const { return m_packets.size(); }
+    const DrawPacket& GetPacket(size_t index) const { return m_packets[index]; }
+    const std::vector<DrawPacket>& GetPackets() const { return m_packets; }
+
+    static uint64_t MakeSortKey(uint32_t pipelineId, uint32_t materialId, uint32_t meshId, uint32_t depthBucket);
+    static uint32_t QuantizeDepth(float depth01);
+
+    // LSD基数排序（每趟8位，所有元素该字节相同的趟直接跳过），结果写回packets；scratch至少count个元素
+    static void RadixSort(DrawPacket* packets, DrawPacket* scratch, size_t count);
+
+private:
+    // 句柄按本帧首次出现顺序分配紧凑ID；超出位宽时截断到最大值（只影响合批，提交时按实际句柄判断）
+    static uint32_t Intern(std::unordered_map<const void*, uint32_t>& ids, const void* handle, int bits);
+
+    std::vector<DrawPacket> m_packets;
+    std::vector<DrawPacket> m_scratch;
+    std::unordered_map<const void*, uint32_t> m_pipelineIds;
+    std::unordered_map<const void*, uint32_t> m_materialIds;
+    std::unordered_map<const void*, uint32_t> m_meshIds;
+};
+
+// 提交统计：Set表示实际调用次数，Skipped表示与上一次相同而省掉的调用
+struct DrawSubmitStats {
+    int drawCount = 0;
+    int instanceCount = 0;          // 所有DrawCall的实例总数（即合批前的绘制数）
+    int pipelineSets = 0;
+    int pipelineSkipped = 0;
+    int materialSets = 0;
+    int materialSkipped = 0;
+    int objectCBSets = 0;
+    int objectCBSkipped = 0;
+    int vertexBufferSets = 0;
+    int vertexBufferSkipped = 0;
+    double sortTimeMs = 0.0;
+
+    int GetStateChanges() const { return pipelineSets + materialSets + objectCBSets + vertexBufferSets; }
+    int GetEliminated() const { return pipelineSkipped + materialSkipped + objectCBSkipped + vertexBufferSkipped; }
+};
+
+// 渲染状态缓存：记录命令列表上最后一次设置的状态，各Set函数返回true表示需要实际调用D3D接口
+class DrawStateCache {
+public:
+    // 命令列表重置或根签名变化后调用（之前的绑定全部失效），同时清空统计
+    void Reset();
+
+    bool SetPipelineState(const void* pipelineState);
+    bool SetMaterial(const void* material);
+    bool SetObjectConstants(uint64_t gpuAddress);
+    bool SetVertexBuffer(const void* mesh);
+    void CountDraw(int instanceCount = 1) { m_stats.drawCount++; m_stats.instanceCount += instanceCount; }
+
+    DrawSubmitStats& GetStats() { return m_stats; }
+    const DrawSubmitStats& GetStats() const { return m_stats; }
+
+private:
+    const void* m_pipelineState = nullptr;
+    const void* m_material = nullptr;
+    uint64_t m_objectConstants = 0;
+    const void* m_vertexBuffer = nullptr;
+    DrawSubmitStats m_stats;
+};
@@ -0,0 +1,52 @@
+// FileWatcher.h
+// 文件变更监视 — 后台线程用ReadDirectoryChangesW递归监视目录，同一文件的连续修改合并（防抖）后交给主线程
+
+#pragma once
+#include <windows.h>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class FileWatcher {
+public:
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // 开始递归监视目录（路径以分隔符结尾）；不存在的目录跳过，全部失败时返回false
+    bool Start(const std::vector<std::wstring>& directories);
+    void Stop();
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // 最后一次修改后静默超过该时间才报告（编辑器保存时常连续写入多次）
+    void SetDebounceMs(int debounceMs) { m_debounceMs = debounceMs; }
+
+    // 取出已稳定的变更文件（完整路径），主线程每帧调用；没有变更时返回false
+    bool PollChanges(std::vector<std::wstring>& outPaths);
+
+private:
+    struct WatchedDirectory {
+        std::wstring path;
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped = {};
+        bool readPending = false;       // 有未完成的重叠读取
+        std::vector<DWORD> buffer;      // FILE_NOTIFY_INFORMATION要求DWORD对齐
+    };
+
+    void WatchThread();
+    bool IssueRead(WatchedDirectory& directory);
+    void ParseNotifications(const WatchedDirectory& directory, DWORD bytes);
+
+    std::vector<WatchedDirectory> m_directories;
+    std::thread m_thread;
+    HANDLE m_stopEvent = nullptr;
+    int m_debounceMs = 300;
+
+    std::mutex m_mutex;
+    std::map<std::wstring, std::chrono::steady_clock::time_point> m_pendingChanges;  // 路径 -> 最后修改时间
+};
@@ -0,0 +1,63 @@
+// FrustumCulling.h
+// 视锥剔除 — Actor世界包围盒按SoA排列，SSE一次测试4个AABB，输出可见列表
+
+#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+class Actor;
+
+// 视锥：6个平面，法线朝内（ax + by + cz + d >= 0 为内侧）
+struct Frustum {
+    DirectX::XMFLOAT4 planes[6];
+
+    // 从ViewProj矩阵提取平面（D3D裁剪空间z∈[0,1]，透视/正交投影通用）
+    static Frustum FromViewProjection(const DirectX::XMMATRIX& viewProj);
+
+    // 阴影投射者用：去掉近平面，光源与视锥之间的物体（在光源近平面之后）仍然投射阴影
+    static Frustum FromShadowViewProjection(const DirectX::XMMATRIX& lightViewProj);
+};
+
+// 剔除统计
+struct CullingStats {
+    int totalCount = 0;
+    int cameraVisibleCount = 0;
+    int shadowVisibleCount = 0;
+    double cullTimeMs = 0.0;
+};
+
+// 可见性标记位（同一Actor可能同时对相机和光源可见）
+enum CullingViewBit : uint8_t {
+    CULL_VIEW_CAMERA = 1 << 0,
+    CULL_VIEW_SHADOW = 1 << 1,
+};
+
+class FrustumCuller {
+public:
+    // 收集Actor的世界包围盒到SoA数组（跳过无Mesh的Actor），同时清空可见性标记
+    void Gather(const std::vector<Actor*>& actors);
+
+    // 对已收集的包围盒做视锥测试，可见Actor按原顺序追加到outVisible，并在标记中置viewBit
+    void Cull(const Frustum& frustum, uint8_t viewBit, std::vector<Actor*>& outVisible);
+
+    int GetCount() const { return (int)m_actors.size(); }
+    Actor* GetActor(int index) const { return m_actors[index]; }
+    uint8_t GetVisibilityMask(int index) const { return m_visibilityMask[index]; }
+
+    // SoA包围盒视锥测试核心：数组长度需补齐到4的倍数，可见下标（< count）追加到outIndices
+    static void CullSoA(const Frustum& frustum,
+                        const float* centerX, const float* centerY, const float* centerZ,
+                        const float* extentX, const float* extentY, const float* extentZ,
+                        size_t count, std::vector<uint32_t>& outIndices);
+
+private:
+    std::vector<Actor*> m_actors;
+    std::vector<uint8_t> m_visibilityMask;
+
+    // SoA：AABB中心和半长，长度补齐到4的倍数
+    std::vector<float> m_centerX, m_centerY, m_centerZ;
+    std::vector<float> m_extentX, m_extentY, m_extentZ;
+
+    std::vector<uint32_t> m_visibleIndices;
+};
@@ -35,7 +35,7 @@ public:
     bool Initialize(int viewportWidth, int viewportHeight);
 
     // 设置场景常量缓冲区
-    void SetSceneConstantBuffer(ID3D12Resource* sceneCB) { m_sceneConstantBuffer = sceneCB; }
+    void SetSceneConstantBuffer(D3D12_GPU_VIRTUAL_ADDRESS sceneCBAddress) { m_sceneCBAddress = sceneCBAddress; }
 
     // 渲染GTAO（包括AO计算 + 空间模糊）
     void Render(ID3D12GraphicsCommandList* cmdList,
@@ -115,13 +115,10 @@ private:
     // 创建SRV堆
     void CreateSRVHeap();
 
-    // 创建GTAO常量缓冲区
-    void CreateConstantBuffer();
-
     // 创建默认白色纹理（GTAO关闭时使用，AO=1表示无遮蔽）
     void CreateDefaultWhiteTexture();
 
-    // 更新GTAO常量缓冲区
+    // 更新GTAO常量（写入本帧上传内存）
     void UpdateConstants();
 
     // 为AO计算Pass创建输入SRV
@@ -156,10 +153,10 @@ private:
     UINT m_srvDescriptorSize = 0;
 
     // 场景常量缓冲区
-    ID3D12Resource* m_sceneConstantBuffer = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS m_sceneCBAddress = 0;
 
-    // GTAO 常量缓冲区
-    ComPtr<ID3D12Resource> m_gtaoConstantBuffer;
+    // GTAO 常量缓冲区（本帧GPU地址）
+    D3D12_GPU_VIRTUAL_ADDRESS m_gtaoCBAddress = 0;
 
     // 默认白色纹理（GTAO关闭时作为fallback，AO=1无遮蔽）
     ComPtr<ID3D12Resource> m_defaultWhiteTexture;
@@ -0,0 +1,35 @@
+// HashUtils.h
+// 哈希工具 — XXH64（用于资源烘焙缓存的源文件校验、内容寻址等）
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// 一次性计算XXH64
+uint64_t HashXXH64(const void* data, size_t length, uint64_t seed = 0);
+
+// 流式XXH64（大文件分块计算，结果与一次性计算一致）
+class XXH64Hasher {
+public:
+    explicit XXH64Hasher(uint64_t seed = 0);
+
+    void Reset(uint64_t seed = 0);
+    void Update(const void* data, size_t length);
+    // 组合缓存键时哈希字符串字段：含结尾'\0'，避免相邻字段拼接后相同（"ab"+"c"与"a"+"bc"）；nullptr按空串处理
+    void UpdateString(const char* text);
+    uint64_t Digest() const;
+
+private:
+    uint64_t m_v[4];
+    uint64_t m_seed;
+    uint64_t m_totalLength;
+    uint8_t m_buffer[32];
+    size_t m_bufferSize;
+};
+
+// 计算文件内容的XXH64，失败返回false
+bool HashFileXXH64(const std::wstring& filePath, uint64_t& outHash);
+
+// 64位哈希转16位十六进制字符串（用于缓存文件名）
+std::string HashToHexString(uint64_t hash);
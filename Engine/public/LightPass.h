@@ -14,7 +14,7 @@ public:
     ~LightPass();
 
     // 设置场景的常量缓冲区
-    void SetSceneConstantBuffer(ID3D12Resource* sceneCB) { m_sceneConstantBuffer = sceneCB; }
+    void SetSceneConstantBuffer(D3D12_GPU_VIRTUAL_ADDRESS sceneCBAddress) { m_sceneCBAddress = sceneCBAddress; }
 
     bool Initialize(ID3D12GraphicsCommandList* commandList);
 
@@ -84,6 +84,6 @@ private:
     ComPtr<ID3D12DescriptorHeap> m_srvHeap;
     UINT m_srvDescriptorSize;
 
-    // 引用Scene的常量缓冲区，不拥有所有权
-    ID3D12Resource* m_sceneConstantBuffer = nullptr;
+    // Scene本帧场景常量缓冲的GPU地址（每帧Update后设置）
+    D3D12_GPU_VIRTUAL_ADDRESS m_sceneCBAddress = 0;
 };
@@ -0,0 +1,50 @@
+// MaterialAsset.h
+// 材质资产 — 可编辑的XML（.material）与烘焙格式（.matbin）共用的中间表示
+// 运行时只读.matbin（不依赖COM，可多线程并行）；.matbin缺失或过期时才用MSXML解析源文件并重新烘焙
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Shader.h"
+
+constexpr uint32_t kMaterialBinMagic = 0x54414D46;   // "FMAT"
+constexpr uint32_t kMaterialBinVersion = 1;
+
+struct MaterialAssetParameter {
+    std::string name;
+    ShaderParameterType type = ShaderParameterType::Float;
+    float values[4] = { 0.0f, 0.0f, 0.0f, 0.0f };   // Float/Vector3/Vector4
+    int32_t intValue = 0;                           // Int/Bool
+};
+
+struct MaterialAssetTexture {
+    std::string name;
+    std::wstring path;
+};
+
+struct MaterialAssetData {
+    std::string name;           // 为空时使用文件名
+    std::string shaderName;
+    std::vector<MaterialAssetParameter> parameters;
+    std::vector<MaterialAssetTexture> textures;
+};
+
+class MaterialAsset {
+public:
+    // 加载材质数据：.matbin有效时直接读取，否则解析源文件并写出.matbin（写出失败不影响本次加载）
+    // 只访问文件系统，可在工作线程调用；outCooked：本次是否解析了源文件
+    static bool Load(const std::wstring& materialPath, MaterialAssetData& outData, bool* outCooked = nullptr);
+
+    // 离线烘焙：解析源文件并写出.matbin（不检查是否过期）
+    static bool Cook(const std::wstring& materialPath);
+
+    // 烘焙文件路径：替换最后一个扩展名（RedMetal.material -> RedMetal.matbin）
+    static std::wstring GetBinPath(const std::wstring& materialPath);
+
+    // 用MSXML解析XML源文件
+    static bool ParseXML(const std::wstring& materialPath, MaterialAssetData& outData);
+
+    static bool ReadBin(const std::wstring& binPath, MaterialAssetData& outData);
+    static bool WriteBin(const std::wstring& binPath, const MaterialAssetData& data, const std::wstring& sourcePath);
+};
@@ -2,6 +2,7 @@
 #include <d3d12.h>
 #include <string>
 #include <map>
+#include <vector>
 #include <DirectXMath.h>
 #include "Shader.h"
 #include <wrl/client.h>
@@ -9,18 +10,47 @@
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 
+class TextureAsset;
+struct MaterialAssetData;
+
+// 参数句柄：按名字在Shader参数表中解析一次，之后按偏移直接读写常量缓冲区数据
+struct MaterialParameterHandle {
+    int index = -1;                 // Shader参数表中的下标
+    int byteOffset = 0;             // 在材质常量缓冲区中的偏移（纹理为SRV索引的偏移）
+    ShaderParameterType type = ShaderParameterType::Float;
+
+    bool IsValid() const { return index >= 0; }
+};
+
 class MaterialInstance {
 public:
     MaterialInstance(const std::string& name, Shader* shader);
     ~MaterialInstance();
 
-    // 从XML文件加载材质实例
-    bool LoadFromXML(const std::wstring& filePath);
+    // 从材质文件加载参数（优先读取烘焙的.matbin，见MaterialAsset）
+    bool LoadFromFile(const std::wstring& filePath);
+    // 应用已解析的材质数据（批量加载时数据在工作线程解析，实例在主线程创建）
+    void ApplyAssetData(const MaterialAssetData& data, const std::wstring& filePath);
 
     // 保存材质实例到XML文件
     bool SaveToXML(const std::wstring& filePath);
 
-    // 参数设置方法
+    // 解析参数句柄（不存在时返回无效句柄）；每帧更新的参数应先解析句柄再用句柄设置
+    MaterialParameterHandle FindParameter(const std::string& name) const;
+
+    // 按句柄设置/获取：直接写入常量缓冲区数据，类型不匹配时忽略
+    void SetFloat(const MaterialParameterHandle& handle, float value);
+    void SetVector(const MaterialParameterHandle& handle, const XMFLOAT4& value);
+    void SetVector3(const MaterialParameterHandle& handle, const XMFLOAT3& value);
+    void SetInt(const MaterialParameterHandle& handle, int value);
+    void SetBool(const MaterialParameterHandle& handle, bool value);
+    float GetFloat(const MaterialParameterHandle& handle) const;
+    XMFLOAT4 GetVector(const MaterialParameterHandle& handle) const;
+    XMFLOAT3 GetVector3(const MaterialParameterHandle& handle) const;
+    int GetInt(const MaterialParameterHandle& handle) const;
+    bool GetBool(const MaterialParameterHandle& handle) const;
+
+    // 按名字设置（编辑器和加载使用，每次调用查找一次参数表）
     void SetFloat(const std::string& name, float value);
     void SetVector(const std::string& name, const XMFLOAT4& value);
     void SetVector3(const std::string& name, const XMFLOAT3& value);
@@ -34,7 +64,6 @@ public:
     // Bindless纹理：设置纹理的SRV索引（在全局SRV堆中的索引）
     void SetTextureSRVIndex(const std::string& name, UINT srvIndex);
     UINT GetTextureSRVIndex(const std::string& name) const;
-    const std::map<std::string, UINT>& GetTextureSRVIndices() const { return m_textureSRVIndices; }
 
     // 参数获取方法
     float GetFloat(const std::string& name) const;
@@ -43,11 +72,13 @@ public:
     int GetInt(const std::string& name) const;
     bool GetBool(const std::string& name) const;
     std::wstring GetTexture(const std::string& name) const;
+    // 全部纹理路径，按Shader参数表下标索引（非纹理参数为空）
+    const std::vector<std::wstring>& GetTexturePaths() const { return m_texturePaths; }
     ID3D12Resource* GetTextureResource(const std::string& name) const;
 
     // GPU资源管理
     bool Initialize(ID3D12Device* device);
-    void UpdateConstantBuffer();  // 打包参数到常量缓冲区
+    void UpdateConstantBuffer();  // 把修改过的字节范围复制到GPU常量缓冲区
     void Bind(ID3D12GraphicsCommandList* commandList,
               ID3D12RootSignature* rootSig,
               int materialCBSlot);  // 绑定材质到渲染管线
@@ -58,13 +89,18 @@ public:
     // 获取材质纹理资源映射（用于渲染时绑定）
     const std::map<int, ID3D12Resource*>& GetTextureResources() const { return m_textureResources; }
 
+    // 关键字变体：由keyword()绑定的bool/int参数和全局关键字决定
+    ShaderVariantKey GetVariantKey() const;
+    // 当前变体的PSO（变体还在编译时为默认变体的PSO），只在本帧有效（见Shader::GetPSO）
+    ID3D12PipelineState* GetPSO(int passIndex = 0) const;
+
     // Getter方法
     Shader* GetShader() const { return m_shader; }
     const std::string& GetName() const { return m_name; }
     ID3D12Resource* GetConstantBuffer() const { return m_constantBuffer; }
 
-    // 标记材质为脏（需要更新CB）
-    void MarkDirty() { m_isDirty = true; }
+    // 标记材质为脏（整个CB需要更新）
+    void MarkDirty() { MarkRangeDirty(0, m_constantBufferSize); }
     bool IsDirty() const { return m_isDirty; }
 
     // 标记纹理为脏（需要重新绑定SRV）
@@ -78,34 +114,50 @@ public:
     // 检查是否有未加载的纹理
     bool HasPendingTextures() const { return m_hasPendingTextures; }
 
+    // ========== 热重载 ==========
+
+    // 来源文件（LoadFromFile的路径，代码创建的材质为空）
+    const std::wstring& GetFilePath() const { return m_filePath; }
+    // Shader接管了重新编译的版本后调用：按新参数表重建常量缓冲区，同名同类型的参数保留原值
+    // 缓冲区大小变化时返回被替换的GPU常量缓冲区，由调用方在GPU用完后释放
+    ID3D12Resource* OnShaderReloaded(ID3D12Device* device, const std::vector<ShaderParameter>& oldParameters);
+    // 原地重新读取材质文件（Actor持有的指针不变）；路径变化的纹理标记为待加载，调用前GPU须空闲
+    bool ReloadFromFile(const std::wstring& filePath);
+    // 纹理重新上传后，在原Bindless槽位重建引用它的SRV；返回是否引用了该纹理
+    bool RefreshTexture(const TextureAsset* texture);
+
 private:
     std::string m_name;
+    std::wstring m_filePath;
     Shader* m_shader;  // 引用的shader（不拥有所有权）
 
-    // CPU端参数存储
-    std::map<std::string, float> m_floatParams;
-    std::map<std::string, XMFLOAT4> m_vectorParams;
-    std::map<std::string, XMFLOAT3> m_vector3Params;
-    std::map<std::string, int> m_intParams;
-    std::map<std::string, bool> m_boolParams;
-    std::map<std::string, std::wstring> m_textureParams;  // 纹理路径
-
-    // Bindless纹理：存储纹理名称到SRV索引的映射
-    std::map<std::string, UINT> m_textureSRVIndices;  // textureName -> SRV index in global heap
+    // CPU端参数存储：数值参数和Bindless纹理的SRV索引都直接存放在m_constantBufferData中（与CB布局一致）
+    std::vector<std::wstring> m_texturePaths;  // 纹理路径，按Shader参数表下标索引（非纹理参数为空）
 
     // 纹理GPU资源（按寄存器槽位索引）- 保留用于兼容
     std::map<int, ID3D12Resource*> m_textureResources;  // registerSlot -> Resource
 
     // GPU资源
     ID3D12Resource* m_constantBuffer;        // 材质常量缓冲区 (b1)
-    unsigned char* m_constantBufferData;     // CPU端缓冲区数据（用于打包）
+    unsigned char* m_constantBufferData;     // CPU端缓冲区数据，参数的唯一存储
     void* m_mappedConstantBuffer;            // 映射的CB指针
+    int m_constantBufferSize;
 
     bool m_isDirty;  // 标记是否需要更新CB
+    int m_dirtyBegin;  // 需要复制到GPU的字节范围[m_dirtyBegin, m_dirtyEnd)
+    int m_dirtyEnd;
     bool m_texturesDirty;  // 标记纹理是否需要重新绑定
     bool m_hasPendingTextures;  // 标记是否有待加载的纹理
 
+    // 变体键缓存
+    mutable ShaderVariantKey m_variantKey;
+    mutable bool m_variantKeyDirty;
+    mutable uint32_t m_variantKeyGlobalVersion;
+
     // 内部辅助函数
-    void PackConstantBuffer();  // 将参数打包到CB
     void InitializeDefaultParameters();  // 从shader初始化默认值
+    void MarkRangeDirty(int begin, int end);
+    // 写入/读取一个参数：type与句柄不符或超出CB范围时返回false
+    bool WriteParameter(const MaterialParameterHandle& handle, ShaderParameterType type, const void* data, int size);
+    bool ReadParameter(const MaterialParameterHandle& handle, ShaderParameterType type, void* out, int size) const;
 };
@@ -6,6 +6,14 @@
 #include "Shader.h"
 #include "MaterialInstance.h"
 
+struct MaterialAssetData;
+
+// 依赖某个include文件的Pass
+struct ShaderPassRef {
+    Shader* shader = nullptr;
+    int passIndex = 0;
+};
+
 class MaterialManager {
 public:
     // 获取单例实例
@@ -25,9 +33,16 @@ public:
     const std::vector<std::string> GetAllShaderNames() const;
     void ClearShaderCache(const std::string& shaderName);  // 清除指定shader的缓存
     void CompileAndCreateAllShadersPSO();  // 编译所有shader并创建PSO（在所有shader加载完后调用）
+    // 同步预编译关键字变体：变体清单（每行"Shader名 关键字..."，#开头为注释）和已加载材质当前使用的变体
+    bool PrecompileVariants(const std::wstring& manifestPath);
+    // 着色模型集合变化后（运行时加载了带新ShadingModel的shader），延迟光照Pass过期的shader合成一批异步重新编译
+    // 每帧调用一次：一帧内加载的多个shader只触发一次编译，共享的光照源码在批次中只编译一次；返回提交的shader数
+    int RecompileStaleShadingModels();
 
     // Material管理
     MaterialInstance* LoadMaterial(const std::wstring& materialFilePath);
+    // 批量加载：材质文件在工作线程并行读取，实例按原顺序在主线程创建；返回值与输入一一对应（失败为nullptr）
+    std::vector<MaterialInstance*> LoadMaterials(const std::vector<std::wstring>& materialFilePaths);
     MaterialInstance* CreateMaterial(const std::string& name, Shader* shader);
     MaterialInstance* GetMaterial(const std::string& name);
     bool SaveMaterial(MaterialInstance* material, const std::wstring& filePath);
@@ -36,6 +51,24 @@ public:
     // 重新加载材质（强制从文件加载，忽略缓存）
     MaterialInstance* ReloadMaterial(const std::wstring& materialFilePath);
 
+    // ========== 热重载（文件监视触发） ==========
+
+    // 重新解析.shader到临时Shader并提交后台编译；编译成功后在帧边界（ProcessCompleted）由原Shader接管，
+    // 使用它的材质按新参数表重建常量缓冲区。编译失败时保留旧版本。没有加载过的shader返回false
+    bool HotReloadShader(const std::wstring& shaderFilePath);
+    // 编译时记录的include依赖：哪些已加载shader的哪些Pass（直接或嵌套）包含了该文件
+    std::vector<ShaderPassRef> FindPassesIncluding(const std::wstring& includePath) const;
+    // include文件变化时只重新加载依赖它的shader，返回提交的shader数
+    // 这些shader的其他Pass源码和依赖都没变，命中字节码缓存，实际只重新编译包含该文件的Pass
+    int HotReloadShadersIncluding(const std::wstring& includePath);
+    // 原地重新读取材质文件并加载新引用的纹理（调用前GPU须空闲，commandList须已打开）
+    bool HotReloadMaterial(const std::wstring& materialFilePath, ID3D12GraphicsCommandList* commandList);
+    // 纹理重新上传后更新引用它的材质的SRV，返回受影响的材质数
+    int RefreshTextureBindings(const TextureAsset* texture);
+    int GetPendingShaderReloadCount() const { return (int)m_pendingShaderReloads.size(); }
+    // 释放热重载替换下来、GPU已用完的资源（每帧调用）
+    void ReleaseRetiredResources();
+
     // Texture管理（暂时简化，后续可与Scene的纹理系统集成）
     ID3D12Resource* LoadTexture(const std::wstring& texturePath);
 
@@ -49,12 +82,29 @@ private:
     MaterialManager(const MaterialManager&) = delete;
     MaterialManager& operator=(const MaterialManager&) = delete;
 
+    // 由已读取的材质数据创建实例（同名材质已加载时直接返回）
+    MaterialInstance* CreateMaterialFromAsset(const std::wstring& materialFilePath, const MaterialAssetData& data);
+    static std::string GetMaterialNameFromPath(const std::wstring& materialFilePath);
+
+    // 重新解析targets并合成一批异步编译，返回提交的shader数
+    int SubmitShaderReloads(const std::vector<Shader*>& targets);
+
     ID3D12Device* m_device;
     ID3D12RootSignature* m_rootSignature;
 
     // Shader和Material存储
     std::map<std::string, std::unique_ptr<Shader>> m_shaders;
     std::map<std::string, std::unique_ptr<MaterialInstance>> m_materials;
+    uint64_t m_compiledShadingModelSetHash = 0;  // 上次检查时的着色模型集合
+
+    // 热重载：正在后台编译的新版本（原Shader -> 重新解析的临时Shader）
+    std::map<Shader*, std::unique_ptr<Shader>> m_pendingShaderReloads;
+    // 被替换的材质常量缓冲区，等提交时的栅栏值完成后释放
+    struct RetiredResource {
+        ID3D12Resource* resource = nullptr;
+        UINT64 fenceValue = 0;
+    };
+    std::vector<RetiredResource> m_retiredResources;
 
     // 纹理缓存
     std::map<std::wstring, ID3D12Resource*> m_textures;
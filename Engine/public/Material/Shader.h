@@ -4,16 +4,15 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 #include "ShaderParameter.h"
+#include "ShaderKeywords.h"
 #include <wrl/client.h>
 
 using Microsoft::WRL::ComPtr;
 
 // Forward declaration
-class MaterialManager;
-
-// 全局函数：检查是否需要重新编译Screen shader
-bool CheckAndRecompileScreen(ID3D12Device* device, ID3D12RootSignature* rootSig, MaterialManager* matMgr);
+struct ShaderCompileJob;
 
 class Shader {
 public:
@@ -26,18 +25,31 @@ public:
     // 从Unity风格shader文件加载（新方式）
     bool LoadFromShaderFile(const std::wstring& filePath);
 
-    // 编译shader（VS和PS）- 编译所有Pass
+    // 热重载：接管另一个Shader（同一文件重新解析并编译完成）的参数、Pass、字节码和PSO
+    // 本对象的指针保持不变，引用它的材质和渲染Pass不需要更新；旧的Pass和变体交给reloaded随其析构释放
+    void AdoptReloaded(Shader& reloaded);
+
+    // 编译shader（VS和PS）- 编译所有Pass，各Pass的VS/PS通过ShaderCompileQueue并行编译
     bool CompileShaders(ID3D12Device* device);
 
-    // 创建PSO（为指定Pass创建PSO）
+    // 并行编译接口（ShaderCompileQueue使用）：生成每个Pass的VS/PS编译任务，任务完成后在主线程回填
+    void AppendCompileJobs(std::vector<ShaderCompileJob>& outJobs) const;
+    // 生成指定Pass的变体编译任务（key会按Pass声明的关键字截取）
+    void AppendVariantCompileJobs(std::vector<ShaderCompileJob>& outJobs, int passIndex, ShaderVariantKey key) const;
+    bool ApplyCompileJobs(const ShaderCompileJob* jobs, size_t jobCount);
+
+    // 创建PSO（为指定Pass创建PSO），返回值与GetPSO相同，不增加引用
     ID3D12PipelineState* CreatePSO(ID3D12Device* device, ID3D12RootSignature* rootSig, int passIndex = 0);
 
     // Getter方法
     const std::string& GetName() const { return m_name; }
+    const std::wstring& GetFilePath() const { return m_filePath; }  // .shader文件路径（旧XML方式为空）
     const std::vector<ShaderParameter>& GetParameters() const { return m_parameters; }
     const ShaderParameter* GetParameter(const std::string& name) const;
     int GetConstantBufferSize() const { return m_constantBufferSize; }
-    ID3D12PipelineState* GetPSO(int passIndex = 0) const;  // 获取指定Pass的PSO
+    // 获取指定Pass的PSO（默认变体）。PSO由Shader持有，返回的指针只在本帧有效：
+    // 热重载（AdoptReloaded）会释放旧的Pass，不要跨帧保存，需要保存时自行AddRef
+    ID3D12PipelineState* GetPSO(int passIndex = 0) const;
     int GetPassCount() const { return static_cast<int>(m_passes.size()); }  // 获取Pass数量
     std::string GetPassName(int passIndex) const {
         if (passIndex >= 0 && passIndex < static_cast<int>(m_passes.size())) {
@@ -50,22 +62,69 @@ public:
     const std::string& GetRenderQueue() const { return m_renderQueue; }
     bool IsDeferredShader() const { return m_renderQueue == "Deferred"; }
 
+    // ========== 关键字变体 ==========
+
+    const ShaderKeywordSpace& GetKeywords() const { return m_keywords; }
+    // 加载时按参数默认值和全局关键字选出的变体，CompileShaders/CreatePSO编译的就是它
+    ShaderVariantKey GetDefaultVariantKey() const { return m_defaultVariantKey; }
+    // 按参数默认值和当前全局关键字选择变体（没有材质实例的Pass使用，如延迟光照）
+    ShaderVariantKey GetVariantKey() const;
+    // 获取变体的PSO：第一次使用时提交异步编译，编译完成前返回默认变体的PSO（生命周期同GetPSO）
+    ID3D12PipelineState* GetVariantPSO(int passIndex, ShaderVariantKey key);
+    // 变体是否需要编译（不是默认变体且还没有提交过）
+    bool NeedsVariant(int passIndex, ShaderVariantKey key) const;
+    // 标记变体为编译中（ShaderCompileQueue提交前调用），不需要编译时返回false
+    bool RequestVariant(int passIndex, ShaderVariantKey key);
+    int GetVariantCount() const;
+
+    // ========== 着色模型（延迟光照Pass） ==========
+
+    // 延迟光照Pass的源码由旧的着色模型集合生成（之后又注册了新的ShadingModel）
+    bool IsShadingModelSetStale() const;
+    // 按当前着色模型集合更新延迟光照Pass的源码，该Pass的变体一并作废；返回是否有变化
+    // ShaderCompileQueue提交编译前调用，保证编译的总是最新集合
+    bool UpdateShadingModelSources();
+
+    // ========== include依赖 ==========
+
+    // 编译时打开过该文件（#include，含嵌套）的Pass下标；fileKey为NormalizePathKey后的路径
+    // 只包含已编译过的Pass（默认变体和已编译的关键字变体）
+    std::vector<int> GetPassesIncluding(const std::wstring& fileKey) const;
+
+    // 所有Pass和已编译变体的VS/PS字节码哈希（PipelineStateCache::HashShaderBytecode），热重载时据此移除旧PSO
+    void AppendBytecodeHashes(std::vector<uint64_t>& outHashes) const;
+
     // 为了向后兼容，这些方法返回Pass 0的字节码
     const D3D12_SHADER_BYTECODE& GetVertexShaderBytecode(int passIndex = 0) const;
     const D3D12_SHADER_BYTECODE& GetPixelShaderBytecode(int passIndex = 0) const;
 
 private:
+    // 非默认变体的编译结果
+    struct PassVariant {
+        enum class State { Compiling, Ready, Failed };
+        State state = State::Compiling;
+        ComPtr<ID3DBlob> vsBlob;
+        ComPtr<ID3DBlob> psBlob;
+        ID3D12PipelineState* pso = nullptr;
+    };
+
     // Pass信息结构
     struct PassInfo {
         std::string name;
         std::string vsEntry;
         std::string psEntry;
-        std::string generatedHLSL;
+        std::shared_ptr<const std::string> generatedHLSL;  // 编译任务共享这份源码
+        bool usesShadingModels = false;     // 延迟光照Pass：源码由ShadingModelRegistry生成
+        std::string lightingBaseHLSL;       // 注入着色模型前的源码
+        uint64_t shadingModelSetHash = 0;   // generatedHLSL对应的着色模型集合
         ComPtr<ID3DBlob> vsBlob;
         ComPtr<ID3DBlob> psBlob;
         D3D12_SHADER_BYTECODE vsBytecode;
         D3D12_SHADER_BYTECODE psBytecode;
         ID3D12PipelineState* pso;  // PSO（由外部管理生命周期）
+        ShaderVariantKey keywordMask = 0;   // Pass声明的关键字
+        std::map<ShaderVariantKey, PassVariant> variants;  // 按 key & keywordMask 索引
+        std::vector<std::wstring> includeFiles;  // 编译依赖的include（NormalizePathKey，默认变体与各变体的并集）
 
         PassInfo() : pso(nullptr) {
             vsBytecode = { nullptr, 0 };
@@ -74,6 +133,7 @@ private:
     };
 
     std::string m_name;
+    std::wstring m_filePath;         // LoadFromShaderFile的文件路径
     std::wstring m_vsPath;           // VS shader路径（旧方式）
     std::wstring m_psPath;           // PS shader路径（旧方式）
     std::string m_vsEntryPoint;      // VS入口点（旧方式）
@@ -89,6 +149,13 @@ private:
     // 渲染队列类型
     std::string m_renderQueue = "Forward";  // "Deferred" 或 "Forward"
 
+    // 关键字变体
+    ShaderKeywordSpace m_keywords;
+    ShaderVariantKey m_defaultVariantKey = 0;
+    // CreatePSO时记录，变体编译完成后用同样的设备和根签名创建PSO
+    ID3D12Device* m_pipelineDevice = nullptr;
+    ID3D12RootSignature* m_pipelineRootSignature = nullptr;
+
     // 渲染状态
     D3D12_CULL_MODE m_cullMode;
     bool m_depthTest;
@@ -107,6 +174,26 @@ private:
     // 计算常量缓冲区总大小（256字节对齐）
     int CalculateConstantBufferSize();
 
+    // 按Pass的RenderQueue和索引创建PSO（默认变体和关键字变体共用）
+    ID3D12PipelineState* CreatePassPSO(ID3D12Device* device, ID3D12RootSignature* rootSig, int passIndex,
+                                       const D3D12_SHADER_BYTECODE& vs, const D3D12_SHADER_BYTECODE& ps) const;
+    // passKey为按Pass截取后的变体键
+    bool IsDefaultVariant(const PassInfo& pass, ShaderVariantKey passKey) const {
+        return passKey == (m_defaultVariantKey & pass.keywordMask);
+    }
+    void AppendPassCompileJobs(std::vector<ShaderCompileJob>& outJobs, int passIndex,
+                               ShaderVariantKey passKey, bool isVariant) const;
+    bool ApplyVariantCompileJob(PassInfo& pass, const ShaderCompileJob& job);
+    // 把编译任务打开的include并入Pass的依赖列表
+    static void RecordPassIncludes(PassInfo& pass, const ShaderCompileJob& job);
+    bool CreateVariantPSO(int passIndex, PassVariant& variant);
+    void ReleaseVariants();
+
+    // 旧方式：从m_vsPath/m_psPath串行编译
+    bool CompileLegacyShaders();
+    // 输出编译错误（控制台、错误文件、MessageBox）
+    void ReportCompileError(const std::string& passName, bool isVertex, const std::string& errorMsg);
+
     // 编译HLSL字符串（新增）
     bool CompileHLSLString(const std::string& hlslCode, const std::string& entryPoint,
                           const std::string& target, D3D12_SHADER_BYTECODE* outBytecode);
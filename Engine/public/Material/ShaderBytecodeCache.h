@@ -0,0 +1,110 @@
+// ShaderBytecodeCache.h
+// 着色器字节码磁盘缓存 — 以源码/入口/target/编译选项/宏定义的XXH64为键，字节码顺序追加到数据包，索引文件记录位置和依赖的include
+// 热启动时命中缓存直接读取字节码，跳过D3DCompile
+// Compile/CompileFromFile可在多个编译线程上同时调用（D3DCompile在锁外执行）
+// include文件内容按路径缓存在内存中（大小/修改时间不变时不再读盘），编译和命中校验共用
+
+#pragma once
+#include <d3d12.h>
+#include <d3dcompiler.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ShaderBytecodeCache {
+public:
+    // 依赖的include文件（解析后的路径 + 内容哈希），命中时逐个校验
+    struct IncludeRecord {
+        std::string path;
+        uint64_t contentHash = 0;
+    };
+
+    static ShaderBytecodeCache& GetInstance();
+
+    ShaderBytecodeCache(const ShaderBytecodeCache&) = delete;
+    ShaderBytecodeCache& operator=(const ShaderBytecodeCache&) = delete;
+
+    // 加载目录下的索引和数据包（目录不存在时创建）；未初始化时Compile只编译不缓存
+    bool Initialize(const std::wstring& directory);
+    void Shutdown();
+
+    // 有新条目时写回索引（每批编译结束时调用，Shutdown时也会写回）
+    bool Flush();
+
+    // 与D3DCompile参数一致；sourceName用于错误信息和#include的相对路径，可为nullptr
+    // outIncludes：这次编译依赖的include文件（含嵌套；命中缓存时为记录的依赖），编译失败时也会填写
+    HRESULT Compile(const void* source, size_t sourceSize, const char* sourceName,
+                    const D3D_SHADER_MACRO* defines, const char* entryPoint, const char* target,
+                    UINT flags, ID3DBlob** outCode, ID3DBlob** outErrors,
+                    std::vector<IncludeRecord>* outIncludes = nullptr);
+
+    // 读取文件后走Compile，#include相对于该文件所在目录
+    HRESULT CompileFromFile(const std::wstring& filePath, const D3D_SHADER_MACRO* defines,
+                            const char* entryPoint, const char* target,
+                            UINT flags, ID3DBlob** outCode, ID3DBlob** outErrors);
+
+    // 读取include文件（经内存缓存），outHash为内容哈希；可在编译线程上并发调用
+    bool LoadIncludeFile(const std::string& path, std::shared_ptr<const std::string>& outContent, uint64_t& outHash);
+    // 文件监视发现include被修改时调用：丢弃缓存的内容，下次使用时重新读取（不依赖修改时间的精度）
+    void InvalidateIncludeFile(const std::wstring& path);
+
+    // 默认编译选项：Debug构建保留调试信息、关闭优化；Release构建使用O3
+    static UINT GetDefaultCompileFlags();
+
+    // ========== 统计信息 ==========
+
+    int GetHitCount() const { std::lock_guard<std::mutex> lock(m_mutex); return m_hitCount; }
+    int GetMissCount() const { std::lock_guard<std::mutex> lock(m_mutex); return m_missCount; }
+    // 未命中时D3DCompile的累计耗时（多线程编译时为各线程耗时之和）
+    double GetCompileTimeMs() const { std::lock_guard<std::mutex> lock(m_mutex); return m_compileTimeMs; }
+    size_t GetEntryCount() const { std::lock_guard<std::mutex> lock(m_mutex); return m_entries.size(); }
+    size_t GetIncludeFileCount() const { std::lock_guard<std::mutex> lock(m_includeMutex); return m_includeFiles.size(); }
+
+private:
+    ShaderBytecodeCache() = default;
+    ~ShaderBytecodeCache() = default;
+
+    struct Entry {
+        uint64_t offset = 0;        // 在数据包中的偏移
+        uint32_t size = 0;
+        std::vector<IncludeRecord> includes;
+    };
+
+    bool LoadIndex();
+    bool WriteIndex();
+    // 失效的字节码超过一半时把存活的字节码写到新一代数据包，再写索引切换过去
+    void CompactIfNeeded();
+    std::wstring GetPackPath(uint32_t generation) const;
+    // 缓存的include文件；size/writeTime与磁盘一致时内容有效
+    struct IncludeFile {
+        std::shared_ptr<const std::string> content;
+        uint64_t hash = 0;
+        uint64_t size = 0;
+        uint64_t writeTime = 0;
+    };
+
+    // 依赖的include文件内容是否都未变化（经include缓存，不持m_mutex调用）
+    bool AreIncludesUnchanged(const std::vector<IncludeRecord>& includes);
+    // 调用方需持有m_mutex
+    void Store(uint64_t key, ID3DBlob* code, const std::vector<IncludeRecord>& includes);
+
+    std::wstring m_directory;
+    std::wstring m_indexPath;
+    std::wstring m_packPath;          // 当前一代数据包（shaders_<代数>.pack）
+    uint32_t m_packGeneration = 0;    // 数据包代数，记录在索引中，每次压缩加一
+    std::wstring m_retiredPackPath;   // 压缩前的数据包，索引切换成功后删除
+    std::unordered_map<uint64_t, Entry> m_entries;
+    std::vector<uint8_t> m_packData;  // 数据包全部内容（字节码很小，启动时一次读入；运行中只追加，已有条目的偏移不变）
+    bool m_dirty = false;             // 有未写回索引的条目
+    mutable std::mutex m_mutex;       // 保护条目表、数据包和统计
+
+    std::unordered_map<std::wstring, IncludeFile> m_includeFiles;  // 键为NormalizePathKey后的路径
+    mutable std::mutex m_includeMutex;  // 只保护m_includeFiles，读文件时不持锁
+
+    int m_hitCount = 0;
+    int m_missCount = 0;
+    double m_compileTimeMs = 0.0;
+};
@@ -0,0 +1,146 @@
+// ShaderCompileQueue.h
+// 着色器并行编译队列 — 每个(Shader, Pass, Stage)是一个独立的编译任务，由工作线程池执行
+// 字节码回填、错误报告和PSO创建都在主线程按提交顺序进行，结果与串行编译一致
+
+#pragma once
+#include <d3d12.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <wrl/client.h>
+#include "ShaderKeywords.h"
+
+class Shader;
+
+enum class ShaderStage : uint8_t {
+    Vertex,
+    Pixel
+};
+
+// 编译任务：源码是提交时的副本（同一Pass的VS/PS共享），执行期间Shader可以继续被修改
+struct ShaderCompileJob {
+    Shader* shader = nullptr;
+    int passIndex = 0;
+    ShaderStage stage = ShaderStage::Vertex;
+    std::shared_ptr<const std::string> source;
+    std::string sourceName;             // .shader文件路径：#include相对于它所在目录解析
+    std::string entryPoint;
+    std::string target;
+    std::vector<std::string> defines;   // 启用的关键字，按值"1"定义
+    bool isVariant = false;             // 非默认变体：结果写入Pass的变体表
+    ShaderVariantKey variantKey = 0;    // 按Pass截取后的变体键
+
+    // 执行结果
+    HRESULT result = E_PENDING;
+    Microsoft::WRL::ComPtr<ID3DBlob> code;
+    std::string errors;
+    std::vector<std::string> includes;  // 依赖的include文件（含嵌套），失败时为已打开的部分
+};
+
+// 一个关键字变体（Shader的一个Pass）
+struct ShaderVariantRequest {
+    Shader* shader = nullptr;
+    int passIndex = 0;
+    ShaderVariantKey key = 0;
+};
+
+class ShaderCompileQueue {
+public:
+    // 某个Shader的所有任务都已回填后调用（主线程），success为false时错误已报告
+    using ShaderCompiledCallback = std::function<void(Shader* shader, bool success)>;
+
+    static ShaderCompileQueue& GetInstance();
+
+    ShaderCompileQueue(const ShaderCompileQueue&) = delete;
+    ShaderCompileQueue& operator=(const ShaderCompileQueue&) = delete;
+
+    // 启动工作线程；workerCount为0时取硬件线程数-1（主线程等待时也执行任务）
+    // 未初始化时所有任务在调用线程上串行执行
+    bool Initialize(unsigned int workerCount = 0);
+    // 执行完队列中剩余的任务后退出工作线程；未回填的异步批次直接丢弃
+    void Shutdown();
+
+    // 同步编译一组Shader：全部任务完成后按shaders顺序回填，每个Shader回填后调用onCompiled
+    // 返回是否全部成功
+    bool CompileShaders(const std::vector<Shader*>& shaders, const ShaderCompiledCallback& onCompiled = nullptr);
+
+    // 异步编译：立即返回，任务完成后由ProcessCompleted回填并回调
+    // Shader销毁时自动Cancel，不会回调；同一Shader的多个批次按提交顺序回填，最后提交的生效
+    void CompileShadersAsync(const std::vector<Shader*>& shaders, const ShaderCompiledCallback& onCompiled = nullptr);
+
+    // 主线程每帧调用：按提交顺序回填已完成的异步批次（前面的批次未完成时后面的批次等待）
+    void ProcessCompleted();
+
+    // 执行一组任务并等待完成（Shader::CompileShaders使用），结果写回jobs
+    void Execute(std::vector<ShaderCompileJob>& jobs);
+
+    // 同步编译一组关键字变体（变体清单预编译），已编译或已提交的变体跳过；返回是否全部成功
+    bool CompileVariants(const std::vector<ShaderVariantRequest>& requests);
+    // 异步编译一个变体（第一次使用时），由ProcessCompleted回填
+    void CompileVariantAsync(Shader* shader, int passIndex, ShaderVariantKey key);
+
+    // Shader销毁前调用：丢弃它还没回填的异步结果
+    void Cancel(Shader* shader);
+
+    // ========== 统计信息 ==========
+
+    unsigned int GetWorkerCount() const { return (unsigned int)m_workers.size(); }
+    int GetPendingJobCount() const;     // 排队中 + 执行中
+    int GetPendingBatchCount() const { return (int)m_asyncBatches.size(); }
+    // 与同批次其他任务完全相同、直接复用结果的任务数（累计）
+    int GetSharedJobCount() const { return m_sharedJobCount; }
+
+private:
+    ShaderCompileQueue() = default;
+    ~ShaderCompileQueue();
+
+    // 一次提交：jobs按shaders顺序连续排列，shader i的任务为[jobOffsets[i], jobOffsets[i+1])
+    // 变体批次中同一个Shader可以出现多次；被Cancel的Shader置空，回填时跳过
+    struct Batch {
+        std::vector<ShaderCompileJob> jobs;
+        std::vector<Shader*> shaders;
+        std::vector<size_t> jobOffsets;
+        ShaderCompiledCallback onCompiled;
+        std::vector<size_t> sharedWith;  // 与之相同的先前任务下标，kNotShared表示自己执行
+        int remaining = 0;              // 未完成的任务数（m_mutex保护）
+    };
+
+    static constexpr size_t kNotShared = (size_t)-1;
+
+    struct Task {
+        ShaderCompileJob* job = nullptr;
+        std::shared_ptr<Batch> batch;
+    };
+
+    std::shared_ptr<Batch> CreateBatch(const std::vector<Shader*>& shaders, const ShaderCompiledCallback& onCompiled);
+    std::shared_ptr<Batch> CreateVariantBatch(const std::vector<ShaderVariantRequest>& requests);
+    void Enqueue(const std::shared_ptr<Batch>& batch);
+    // 把执行过的任务结果复制给与之相同的任务
+    static void CopySharedResults(Batch& batch);
+    // 等待批次完成，等待期间主线程也从队列取任务执行
+    void WaitAndHelp(const std::shared_ptr<Batch>& batch);
+    void RunTask(const Task& task);
+    void WorkerMain();
+    // 主线程：按顺序回填字节码、报告错误、触发回调
+    bool FinalizeBatch(Batch& batch);
+    bool IsBatchDone(const Batch& batch) const;
+
+    static void RunJob(ShaderCompileJob& job);
+
+    std::vector<std::thread> m_workers;
+    std::deque<Task> m_tasks;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    std::condition_variable m_batchDone;
+    int m_runningTasks = 0;
+    bool m_stopping = false;
+    int m_sharedJobCount = 0;           // 只在主线程访问
+
+    std::deque<std::shared_ptr<Batch>> m_asyncBatches;  // 只在主线程访问
+};
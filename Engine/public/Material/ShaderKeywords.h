@@ -0,0 +1,74 @@
+// ShaderKeywords.h
+// 着色器关键字与变体键 — .shader中 #pragma multi_compile 声明的每个关键字占变体键的一位
+// 同一组关键字互斥（"_"表示该组不启用关键字）；组由材质参数（keyword属性）、全局关键字或默认值选择
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// 变体键：启用的关键字位集合
+typedef uint64_t ShaderVariantKey;
+
+static constexpr int kMaxShaderKeywords = 64;
+
+class ShaderKeywordSpace {
+public:
+    // 关键字组：keywords[i]对应bits[i]，"_"的位为-1
+    struct Group {
+        std::vector<std::string> keywords;
+        std::vector<int> bits;
+        ShaderVariantKey mask = 0;
+
+        bool HasNone() const {
+            for (int bit : bits) if (bit < 0) return true;
+            return false;
+        }
+    };
+
+    // 材质参数到关键字的绑定：bool参数为真时启用keywords[0]、为假时该组不启用；int参数按值选择keywords[value]
+    struct Binding {
+        std::string parameterName;
+        bool isBool = true;
+        std::vector<std::string> keywords;
+    };
+
+    void Clear();
+
+    // 添加关键字组（已有相同关键字的组时直接返回它），返回组的位掩码
+    // 一个关键字只能属于一个组；关键字超过64个时后面的忽略
+    ShaderVariantKey AddGroup(const std::vector<std::string>& keywords);
+    void AddBinding(const Binding& binding);
+
+    const std::vector<Group>& GetGroups() const { return m_groups; }
+    const std::vector<Binding>& GetBindings() const { return m_bindings; }
+    bool IsEmpty() const { return m_groups.empty(); }
+
+    // 按绑定参数的取值（与GetBindings()一一对应）和全局关键字计算变体键；未绑定、未被全局启用的组取第一个关键字
+    ShaderVariantKey SelectVariant(const std::vector<int>& bindingValues) const;
+
+    // 由关键字名列表得到变体键（变体清单用）；未列出的组取第一个关键字，未知关键字写入outUnknown
+    ShaderVariantKey MakeKey(const std::vector<std::string>& keywords, std::vector<std::string>* outUnknown = nullptr) const;
+
+    // 生成编译宏：只包含passMask中的关键字（Pass没有声明的关键字不影响它的字节码）
+    void GetDefines(ShaderVariantKey key, ShaderVariantKey passMask, std::vector<std::string>& outDefines) const;
+
+    // "KEYWORD_A KEYWORD_B"，没有启用的关键字时为空串
+    std::string ToString(ShaderVariantKey key) const;
+
+    // ========== 全局关键字（场景级开关，如SSGI） ==========
+
+    static void SetGlobalKeyword(const std::string& keyword, bool enabled);
+    static bool IsGlobalKeywordEnabled(const std::string& keyword);
+    // 全局关键字每次变化加一，缓存变体键的一方据此判断是否需要重新计算
+    static uint32_t GetGlobalKeywordVersion();
+
+private:
+    const Group* FindGroup(const std::string& keyword, int& outBit) const;
+
+    std::vector<Group> m_groups;
+    std::vector<Binding> m_bindings;
+    std::map<std::string, int> m_keywordBits;  // 关键字 -> 位
+    int m_bitCount = 0;
+};
@@ -14,6 +14,7 @@ public:
         float minValue = 0.0f;
         float maxValue = 1.0f;
         std::string uiWidget;  // "Slider", "ColorPicker", "TexturePicker"
+        std::vector<std::string> keywords;  // keyword(...)：bool为真时启用keywords[0]，int按值选择
     };
 
     struct PassDefinition {
@@ -22,6 +23,7 @@ public:
         std::string psEntry;  // pixel shader入口点
         std::string hlslCode; // HLSL代码（去掉标记后的纯代码）
         std::string renderQueue;  // "Deferred" 或 "Forward"
+        std::vector<std::vector<std::string>> keywordGroups;  // #pragma multi_compile 声明的关键字组
     };
 
     struct ShadingModelDefinition {
@@ -33,7 +35,7 @@ public:
     ShaderParser();
     ~ShaderParser() = default;
 
-    // 解析Unity风格的shader文件
+    // 解析Unity风格的shader文件（语法分析见ShaderSyntax，出错时输出 file(line,col): error: ...）
     bool ParseShaderFile(const std::wstring& filePath);
 
     // Getters
@@ -59,20 +61,14 @@ private:
     bool m_hasShadingModel = false;
     ShadingModelDefinition m_shadingModel;
 
-    // 解析辅助函数
-    bool ParseProperties(const std::string& content, size_t& pos);
-    bool ParsePass(const std::string& content, size_t& pos);
-    bool ParsePropertyLine(const std::string& line, PropertyDefinition& outProp);
-    bool ParseShadingModel(const std::string& content, size_t& pos);
-
-    // 查找标记位置
-    size_t FindBlockStart(const std::string& content, size_t pos, const std::string& blockName);
-    size_t FindBlockEnd(const std::string& content, size_t pos);
-
     // 生成代码辅助
+    static std::string GenerateInstanceDataDeclaration();
     std::string GenerateMaterialCB() const;
     std::string GenerateTextureDeclarations() const;
 
+    // 按空白或逗号拆分关键字列表
+    static std::vector<std::string> SplitKeywords(const std::string& text);
+
     // 类型解析
     ShaderParameterType ParseType(const std::string& typeStr) const;
     int GetTypeSize(ShaderParameterType type) const;
@@ -0,0 +1,157 @@
+// ShaderSyntax.h
+// .shader文件的词法/语法分析 — 递归下降，单遍扫描源文本，结果都是指向源文本的片段（不逐Token分配内存）
+// 只依赖标准库，可以脱离Windows/D3D单独编译（模糊测试、基准测试）
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 源文本片段（项目按C++14编译，没有std::string_view）
+struct ShaderSpan {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    bool Empty() const { return size == 0; }
+    bool Equals(const char* literal) const;
+    std::string ToString() const { return std::string(data ? data : "", size); }
+};
+
+enum class ShaderTokenType : uint8_t {
+    End,
+    Identifier,     // [A-Za-z_][A-Za-z0-9_]*
+    String,         // "..."，text不含引号
+    Number,         // 整数或小数
+    Punct,          // { } ( ) , ; =
+    Annotation,     // //# 属性标注，text为 //# 之后到行尾的内容
+    Invalid
+};
+
+struct ShaderToken {
+    ShaderTokenType type = ShaderTokenType::End;
+    char punct = 0;
+    ShaderSpan text;
+    uint32_t line = 1;
+    uint32_t column = 1;
+
+    bool IsPunct(char c) const { return type == ShaderTokenType::Punct && punct == c; }
+    bool IsIdentifier(const char* word) const { return type == ShaderTokenType::Identifier && text.Equals(word); }
+};
+
+// 词法分析器：跳过空白和普通注释（//、/* */），行列号从1开始，列按字节计
+class ShaderLexer {
+public:
+    ShaderLexer(const char* begin, const char* end, uint32_t line = 1, uint32_t column = 1);
+
+    ShaderToken Next();
+    ShaderToken Peek();
+
+    // 原样读取到整词word为止（跳过注释中的同名词），读取后位于word之后；用于 HLSLPROGRAM ... ENDHLSL
+    bool ReadRawUntilWord(const char* word, ShaderSpan& outText);
+    // 已读入'{'后原样读取到配对的'}'（注释和字符串中的括号不计），读取后位于'}'之后
+    bool ReadRawBlock(ShaderSpan& outBody);
+    // 原样读取到字符c（不含），读取后位于c上
+    bool ReadRawUntilChar(char c, ShaderSpan& outText);
+
+    uint32_t GetLine() const { return m_line; }
+    uint32_t GetColumn() const { return m_column; }
+
+private:
+    void Advance(size_t count);
+    void SkipWhitespaceAndComments();
+    bool SkipComment();
+
+    const char* m_cursor;
+    const char* m_end;
+    uint32_t m_line;
+    uint32_t m_column;
+};
+
+struct ShaderSyntaxError {
+    uint32_t line = 0;
+    uint32_t column = 0;
+    std::string message;
+};
+
+// //# <type> <name> {default(...), min(...), max(...), ui(...), keyword(...)};
+struct ShaderPropertySyntax {
+    ShaderSpan type;
+    ShaderSpan name;
+    ShaderSpan defaultValue;        // 括号内原文（去掉首尾空白）
+    ShaderSpan uiWidget;
+    ShaderSpan keywords;            // keyword(...)括号内原文：bool参数为真时启用的关键字，int参数按值选择第几个
+    float minValue = 0.0f;
+    float maxValue = 1.0f;
+    bool hasAttributes = false;     // 是否带 {...} 属性块
+    uint32_t line = 0;
+};
+
+// HLSL中的 #pragma <name> <args>
+struct ShaderPragmaSyntax {
+    ShaderSpan name;
+    ShaderSpan args;                // 去掉首尾空白
+    ShaderSpan directive;           // 从#pragma到行尾（含换行），剥离时整段删除
+    uint32_t line = 0;
+};
+
+struct ShaderPassSyntax {
+    ShaderSpan name;
+    ShaderSpan renderQueue;
+    ShaderSpan hlsl;                // HLSLPROGRAM与ENDHLSL之间的原文
+    ShaderSpan vertexEntry;
+    ShaderSpan fragmentEntry;
+    std::vector<ShaderPragmaSyntax> pragmas;
+    uint32_t line = 0;
+    uint32_t hlslLine = 0;          // hlsl第一个字符所在行
+};
+
+struct ShaderShadingModelSyntax {
+    int shadingModelID = 0;
+    ShaderSpan brdfCall;
+    ShaderSpan brdfFunctionCode;
+};
+
+struct ShaderFileSyntax {
+    ShaderSpan name;
+    ShaderSpan renderQueue;
+    std::vector<ShaderPropertySyntax> properties;
+    std::vector<ShaderPassSyntax> passes;
+    bool hasShadingModel = false;
+    ShaderShadingModelSyntax shadingModel;
+    std::vector<ShaderSyntaxError> warnings;    // 不影响加载的问题（如ShadingModel块解析失败）
+};
+
+// 语法：
+//   File         := 'Shader' String '{' { Item } '}'
+//   Item         := 'RenderQueue' String | Properties | ShadingModel | Pass
+//   Properties   := 'Properties' '{' { Annotation } '}'
+//   ShadingModel := 'ShadingModel' '{' 'shadingmodel' '=' Number ';' 'BRDF' '=' Raw ';' [ 'BRDF' '{' Raw '}' ] '}'
+//   Pass         := 'Pass' '{' { 'Name' String | 'RenderQueue' String | 'HLSLPROGRAM' Raw 'ENDHLSL' } '}'
+class ShaderSyntaxParser {
+public:
+    // 解析失败返回false，GetError()给出第一个错误的行列号；source需在outFile使用期间保持有效
+    bool Parse(const char* source, size_t length, ShaderFileSyntax& outFile);
+
+    const ShaderSyntaxError& GetError() const { return m_error; }
+
+    // 删除hlsl中的#pragma指令行，其余原样追加到out
+    static void StripPragmas(const ShaderPassSyntax& pass, std::string& out);
+
+private:
+    bool ParseFile(ShaderLexer& lexer, ShaderFileSyntax& outFile);
+    bool ParseProperties(ShaderLexer& lexer, ShaderFileSyntax& outFile);
+    bool ParsePropertyAnnotation(const ShaderToken& annotation, ShaderPropertySyntax& outProp);
+    bool ParseShadingModel(ShaderLexer& lexer, ShaderFileSyntax& outFile);
+    bool ParseShadingModelBody(ShaderLexer& lexer, ShaderShadingModelSyntax& outModel);
+    bool ParsePass(ShaderLexer& lexer, const ShaderToken& keyword, ShaderFileSyntax& outFile);
+    void ParsePragmas(ShaderPassSyntax& pass);
+
+    bool Expect(ShaderLexer& lexer, char punct, const char* context);
+    bool ExpectString(ShaderLexer& lexer, ShaderSpan& outText, const char* context);
+    // 记录错误并返回false；带token的版本在消息后附上实际读到的内容
+    bool Fail(const ShaderToken& token, const std::string& message);
+    bool Fail(uint32_t line, uint32_t column, const std::string& message);
+
+    ShaderSyntaxError m_error;
+};
@@ -0,0 +1,47 @@
+// ShadingModelRegistry.h
+// 着色模型注册表 — 各.shader的ShadingModel块按ID排序组成规范集合，延迟光照Pass（Screen.shader）的HLSL由集合生成
+// 生成的源码按(基础源码, 集合哈希)缓存并共享：各Deferred shader的光照Pass拿到同一份源码，同一编译批次中只编译一次
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "ShaderParser.h"
+
+class ShadingModelRegistry {
+public:
+    static ShadingModelRegistry& GetInstance();
+
+    ShadingModelRegistry(const ShadingModelRegistry&) = delete;
+    ShadingModelRegistry& operator=(const ShadingModelRegistry&) = delete;
+
+    // 注册着色模型，返回集合是否变化
+    // 同一shader重新注册时替换定义；ID已被其他shader占用时保留先注册的并警告
+    bool Register(const ShaderParser::ShadingModelDefinition& model, const std::string& ownerName);
+
+    // 集合哈希：由排序后的ID和BRDF代码决定，与注册顺序无关
+    uint64_t GetSetHash() const { return m_setHash; }
+    size_t GetModelCount() const { return m_models.size(); }
+
+    // 把当前集合注入延迟光照Pass的HLSL（BRDF函数 + switch分支）
+    // 同一(基础源码, 集合)返回同一个共享对象
+    std::shared_ptr<const std::string> GetLightingSource(const std::string& baseHLSL);
+
+private:
+    ShadingModelRegistry();
+    ~ShadingModelRegistry() = default;
+
+    void UpdateSetHash();
+    std::string InjectModels(const std::string& baseHLSL) const;
+
+    struct Entry {
+        ShaderParser::ShadingModelDefinition model;
+        std::string ownerName;
+    };
+
+    std::map<int, Entry> m_models;      // 按ID排序
+    uint64_t m_setHash;
+    std::unordered_map<uint64_t, std::shared_ptr<const std::string>> m_sources;  // 基础源码哈希 + 集合哈希 -> 生成的源码
+};
@@ -0,0 +1,98 @@
+// MeshBin.h
+// 烘焙网格格式（.meshbin）：文件头 + 子网格表 + 对齐的顶点/索引数据块 + 包围体
+// 加载时整文件内存映射，数据块直接交给上传路径，不做逐顶点解析
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <windows.h>
+#include "MeshTypes.h"
+
+constexpr uint32_t kMeshBinMagic = 0x48534D46;    // "FMSH"
+constexpr uint32_t kMeshBinVersion = 2;      // 2：索引值改为烘焙时校验
+constexpr uint32_t kMeshBinBlobAlignment = 64;    // 数据块按64字节对齐
+
+// 源文件信息（用于判断烘焙结果是否过期）
+struct MeshBinSourceInfo {
+    uint64_t hash = 0;       // 源文件内容XXH64
+    uint64_t size = 0;       // 源文件大小
+    uint64_t writeTime = 0;  // 源文件最后修改时间（FILETIME）
+};
+
+// 文件头
+struct MeshBinHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexStride;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t subMeshCount;
+
+    uint64_t subMeshTableOffset;
+    uint64_t vertexDataOffset;
+    uint64_t indexDataOffset;
+    uint64_t fileSize;
+
+    float boundsMin[3];
+    float boundsMax[3];
+    float sphereCenter[3];
+    float sphereRadius;
+
+    MeshBinSourceInfo source;
+};
+static_assert(sizeof(MeshBinHeader) == 120, "MeshBinHeader layout changed, bump kMeshBinVersion");
+
+// 子网格表项
+struct MeshBinSubMesh {
+    char name[64];
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    float boundsMin[3];
+    float boundsMax[3];
+    float sphereCenter[3];
+    float sphereRadius;
+};
+static_assert(sizeof(MeshBinSubMesh) == 112, "MeshBinSubMesh layout changed, bump kMeshBinVersion");
+
+// 读取源文件大小和修改时间，computeHash为true时同时计算内容哈希
+bool QueryMeshSourceInfo(const std::wstring& sourcePath, bool computeHash, MeshBinSourceInfo& outInfo);
+
+// 内存映射的.meshbin文件（只读）
+class MeshBinFile {
+public:
+    MeshBinFile() = default;
+    ~MeshBinFile() { Close(); }
+
+    MeshBinFile(const MeshBinFile&) = delete;
+    MeshBinFile& operator=(const MeshBinFile&) = delete;
+
+    // 映射文件并校验文件头和子网格范围（索引值只在Debug构建中逐个校验）
+    bool Open(const std::wstring& filePath);
+    void Close();
+    bool IsOpen() const { return m_view != nullptr; }
+
+    const MeshBinHeader* GetHeader() const { return reinterpret_cast<const MeshBinHeader*>(m_view); }
+    const MeshBinSubMesh* GetSubMeshes() const;
+    const StaticMeshComponentVertexData* GetVertices() const;
+    const unsigned int* GetIndices() const;
+    MeshBounds GetBounds() const;
+
+    // 写出烘焙结果（子网格范围或索引越界时拒绝写出）
+    static bool Write(const std::wstring& filePath, const MeshImportData& data, const MeshBinSourceInfo& source);
+
+    // 只读取文件头（不映射整个文件）
+    static bool ReadHeader(const std::wstring& filePath, MeshBinHeader& outHeader);
+
+    // 原地更新文件头中的源文件信息（内容哈希未变、仅时间戳变化时使用，避免重新烘焙）
+    static bool UpdateSourceInfo(const std::wstring& filePath, const MeshBinSourceInfo& source);
+
+    // 子网格表项转包围体
+    static MeshBounds ToBounds(const MeshBinSubMesh& subMesh);
+
+private:
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+    const uint8_t* m_view = nullptr;
+    uint64_t m_size = 0;
+};
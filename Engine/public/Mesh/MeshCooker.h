@@ -0,0 +1,18 @@
+// MeshCooker.h
+// 网格烘焙：FBX -> .meshbin（离线步骤，只有源文件内容哈希变化时才重新导入FBX）
+
+#pragma once
+
+#include <string>
+
+class MeshCooker {
+public:
+    // 从FBX导入并写出.meshbin
+    static bool Cook(const std::wstring& fbxPath, const std::wstring& meshBinPath);
+
+    // 检查.meshbin是否过期，过期则重新烘焙
+    // 1. 源文件大小和修改时间与记录一致：直接复用
+    // 2. 不一致时计算源文件内容哈希：哈希相同只刷新记录的时间戳，不同才重新烘焙
+    // outCooked：本次是否实际执行了烘焙
+    static bool CookIfStale(const std::wstring& fbxPath, const std::wstring& meshBinPath, bool* outCooked = nullptr);
+};
@@ -0,0 +1,77 @@
+// MeshManager.h
+// 共享网格缓存 — 引用相同几何源的Actor共用一份VBO/IBO，按规范化路径+内容哈希索引，引用计数释放
+
+#pragma once
+
+#include <d3d12.h>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct MeshAssetInfo;
+class StaticMeshComponent;
+
+class MeshManager {
+public:
+    static MeshManager& GetInstance();
+
+    MeshManager(const MeshManager&) = delete;
+    MeshManager& operator=(const MeshManager&) = delete;
+
+    // 获取网格（引用计数+1）：缓存命中直接返回，否则从.meshbin/FBX加载并上传
+    StaticMeshComponent* Acquire(const MeshAssetInfo& meshInfo, ID3D12GraphicsCommandList* commandList);
+
+    // 增加引用（同一网格被另一个持有者共享时使用）
+    void AddRef(StaticMeshComponent* mesh);
+
+    // 释放引用，计数归零时移出缓存，GPU资源等在途帧完成后由ReleaseRetiredResources销毁；不在缓存中的网格直接忽略
+    void Release(StaticMeshComponent* mesh);
+
+    // 销毁引用归零、GPU已用完的网格（每帧调用）
+    void ReleaseRetiredResources();
+
+    // 释放所有网格（程序退出时调用，需保证GPU已空闲）
+    void Shutdown();
+
+    // ========== 统计信息 ==========
+
+    int GetUniqueMeshCount() const { return (int)m_entries.size(); }
+    int GetTotalReferenceCount() const;
+    uint64_t GetGPUMemoryUsage() const;
+
+private:
+    MeshManager() = default;
+    ~MeshManager();
+
+    struct MeshEntry {
+        std::string key;
+        StaticMeshComponent* mesh = nullptr;
+        int refCount = 0;
+    };
+
+    // 源文件内容哈希缓存（大小和修改时间不变时不重复计算）
+    struct SourceHash {
+        uint64_t size = 0;
+        uint64_t writeTime = 0;
+        uint64_t hash = 0;
+    };
+
+    // 生成缓存键：规范化源路径 + 内容哈希
+    std::string BuildKey(const std::wstring& sourcePath);
+
+    // 实际加载（.meshbin优先，失败回退FBX导入）
+    static StaticMeshComponent* LoadMesh(const MeshAssetInfo& meshInfo, ID3D12GraphicsCommandList* commandList);
+
+    std::map<std::string, MeshEntry> m_entries;
+    std::unordered_map<StaticMeshComponent*, std::string> m_meshToKey;
+    std::map<std::wstring, SourceHash> m_sourceHashes;
+
+    // 引用归零的网格，等释放时的栅栏值完成后销毁
+    struct RetiredMesh {
+        StaticMeshComponent* mesh = nullptr;
+        UINT64 fenceValue = 0;
+    };
+    std::vector<RetiredMesh> m_retiredMeshes;
+};
@@ -0,0 +1,49 @@
+// MeshOptimizer.h
+// 网格索引优化：顶点缓存重排（Forsyth）、Overdraw簇排序、顶点读取顺序重排
+
+#pragma once
+
+#include <vector>
+#include "MeshTypes.h"
+
+// 顶点缓存统计
+// ACMR：每三角形平均缓存未命中数（越低越好，理论下限约0.5）
+// ATVR：每唯一顶点平均变换次数（越接近1越好）
+struct MeshCacheStats {
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+// 优化统计（导入时输出，便于对比优化前后）
+struct MeshOptimizeStats {
+    MeshCacheStats before;
+    MeshCacheStats after;
+    double optimizeTimeMs = 0.0;
+};
+
+class MeshOptimizer {
+public:
+    // 模拟FIFO后变换缓存，统计ACMR/ATVR
+    static MeshCacheStats AnalyzeVertexCache(const std::vector<unsigned int>& indices,
+                                             unsigned int vertexCount,
+                                             unsigned int cacheSize = 16);
+
+    // Forsyth线性时间顶点缓存优化，重排三角形顺序
+    static void OptimizeVertexCache(std::vector<unsigned int>& indices, unsigned int vertexCount);
+
+    // Overdraw优化：按缓存断点切簇，簇按朝外程度排序（先画外侧面）
+    // threshold：允许ACMR相对输入变差的比例，超出则保持输入顺序
+    // 需在OptimizeVertexCache之后调用
+    static void OptimizeOverdraw(std::vector<unsigned int>& indices,
+                                 const std::vector<StaticMeshComponentVertexData>& vertices,
+                                 float threshold = 1.05f);
+
+    // 顶点读取优化：按索引首次引用顺序重排顶点，并重映射索引
+    static void OptimizeVertexFetch(std::vector<StaticMeshComponentVertexData>& vertices,
+                                    std::vector<unsigned int>& indices);
+
+    // 依次执行以上三步，并输出优化前后的缓存统计
+    static void Optimize(std::vector<StaticMeshComponentVertexData>& vertices,
+                         std::vector<unsigned int>& indices,
+                         MeshOptimizeStats* outStats = nullptr);
+};
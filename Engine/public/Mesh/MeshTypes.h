@@ -0,0 +1,134 @@
+// MeshTypes.h
+// 网格顶点等基础数据类型（不依赖D3D12/FBX SDK，供导入、优化、烘焙等离线流程共用）
+#pragma once
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// 场景Mesh顶点格式（64字节，与CreateScenePSO的输入布局一致）
+struct StaticMeshComponentVertexData {
+    float mPosition[4];
+    float mTexcoord[4];
+    float mNormal[4];
+    float mTangent[4];
+
+    bool operator==(const StaticMeshComponentVertexData& other) const {
+        return memcmp(mPosition, other.mPosition, sizeof(mPosition)) == 0 &&
+            memcmp(mTexcoord, other.mTexcoord, sizeof(mTexcoord)) == 0 &&
+            memcmp(mNormal, other.mNormal, sizeof(mNormal)) == 0 &&
+            memcmp(mTangent, other.mTangent, sizeof(mTangent)) == 0;
+    }
+};
+
+// 包围体（局部空间）
+struct MeshBounds {
+    float min[3] = { 0.0f, 0.0f, 0.0f };
+    float max[3] = { 0.0f, 0.0f, 0.0f };
+    float center[3] = { 0.0f, 0.0f, 0.0f };  // 包围球中心（取AABB中心）
+    float radius = 0.0f;
+};
+
+// 导入后的子网格描述（索引区间位于合并后的索引数组中）
+struct MeshSubMeshData {
+    std::string name;
+    unsigned int indexOffset = 0;
+    unsigned int indexCount = 0;
+    MeshBounds bounds;
+};
+
+// CPU侧网格数据（FBX导入结果 / 烘焙输入）
+// 所有子网格共用一个顶点数组，索引已加上各自的顶点基址
+struct MeshImportData {
+    std::vector<StaticMeshComponentVertexData> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<MeshSubMeshData> subMeshes;
+    MeshBounds bounds;
+};
+
+// 计算一组顶点（按索引引用）的包围体
+inline MeshBounds ComputeMeshBounds(const StaticMeshComponentVertexData* vertices,
+                                    const unsigned int* indices, size_t indexCount) {
+    MeshBounds bounds;
+    if (indexCount == 0) {
+        return bounds;
+    }
+
+    const float* p0 = vertices[indices[0]].mPosition;
+    for (int a = 0; a < 3; ++a) {
+        bounds.min[a] = p0[a];
+        bounds.max[a] = p0[a];
+    }
+    for (size_t i = 1; i < indexCount; ++i) {
+        const float* p = vertices[indices[i]].mPosition;
+        for (int a = 0; a < 3; ++a) {
+            if (p[a] < bounds.min[a]) bounds.min[a] = p[a];
+            if (p[a] > bounds.max[a]) bounds.max[a] = p[a];
+        }
+    }
+
+    for (int a = 0; a < 3; ++a) {
+        bounds.center[a] = (bounds.min[a] + bounds.max[a]) * 0.5f;
+    }
+    float radiusSq = 0.0f;
+    for (size_t i = 0; i < indexCount; ++i) {
+        const float* p = vertices[indices[i]].mPosition;
+        float dx = p[0] - bounds.center[0];
+        float dy = p[1] - bounds.center[1];
+        float dz = p[2] - bounds.center[2];
+        float d = dx * dx + dy * dy + dz * dz;
+        if (d > radiusSq) radiusSq = d;
+    }
+    bounds.radius = sqrtf(radiusSq);
+    return bounds;
+}
+
+// 合并两个包围体
+inline MeshBounds MergeMeshBounds(const MeshBounds& a, const MeshBounds& b) {
+    MeshBounds bounds;
+    for (int i = 0; i < 3; ++i) {
+        bounds.min[i] = a.min[i] < b.min[i] ? a.min[i] : b.min[i];
+        bounds.max[i] = a.max[i] > b.max[i] ? a.max[i] : b.max[i];
+        bounds.center[i] = (bounds.min[i] + bounds.max[i]) * 0.5f;
+    }
+    // 球半径取能包住两个子球的保守值
+    float radius = 0.0f;
+    const MeshBounds* parts[2] = { &a, &b };
+    for (const MeshBounds* part : parts) {
+        float dx = part->center[0] - bounds.center[0];
+        float dy = part->center[1] - bounds.center[1];
+        float dz = part->center[2] - bounds.center[2];
+        float r = sqrtf(dx * dx + dy * dy + dz * dz) + part->radius;
+        if (r > radius) radius = r;
+    }
+    bounds.radius = radius;
+    return bounds;
+}
+
+// 纹理坐标密度：sqrt(UV面积之和 / 局部空间三角形面积之和)，即局部空间每单位长度跨过的UV单位数
+// 纹理流送按它和屏幕尺寸估算需要的mip；没有有效三角形时返回0
+inline float ComputeMeshUVDensity(const StaticMeshComponentVertexData* vertices,
+                                  const unsigned int* indices, size_t indexCount) {
+    double worldArea = 0.0;
+    double uvArea = 0.0;
+    for (size_t i = 0; i + 2 < indexCount; i += 3) {
+        const StaticMeshComponentVertexData& v0 = vertices[indices[i]];
+        const StaticMeshComponentVertexData& v1 = vertices[indices[i + 1]];
+        const StaticMeshComponentVertexData& v2 = vertices[indices[i + 2]];
+
+        const float e1[3] = { v1.mPosition[0] - v0.mPosition[0], v1.mPosition[1] - v0.mPosition[1], v1.mPosition[2] - v0.mPosition[2] };
+        const float e2[3] = { v2.mPosition[0] - v0.mPosition[0], v2.mPosition[1] - v0.mPosition[1], v2.mPosition[2] - v0.mPosition[2] };
+        const float cx = e1[1] * e2[2] - e1[2] * e2[1];
+        const float cy = e1[2] * e2[0] - e1[0] * e2[2];
+        const float cz = e1[0] * e2[1] - e1[1] * e2[0];
+        worldArea += 0.5 * sqrt((double)cx * cx + (double)cy * cy + (double)cz * cz);
+
+        const float u1 = v1.mTexcoord[0] - v0.mTexcoord[0], t1 = v1.mTexcoord[1] - v0.mTexcoord[1];
+        const float u2 = v2.mTexcoord[0] - v0.mTexcoord[0], t2 = v2.mTexcoord[1] - v0.mTexcoord[1];
+        uvArea += 0.5 * fabs((double)u1 * t2 - (double)u2 * t1);
+    }
+    if (worldArea <= 0.0 || uvArea <= 0.0) {
+        return 0.0f;
+    }
+    return (float)sqrt(uvArea / worldArea);
+}
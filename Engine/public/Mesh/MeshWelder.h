@@ -0,0 +1,37 @@
+// MeshWelder.h
+// 顶点焊接：合并FBX导入产生的重复顶点，生成唯一顶点表和重映射后的索引
+
+#pragma once
+
+#include <vector>
+#include "MeshTypes.h"
+
+// 焊接参数（各属性的量化精度，0表示按位精确比较）
+struct MeshWeldSettings {
+    float positionEpsilon = 0.0f;
+    float texcoordEpsilon = 0.0f;
+    float normalEpsilon = 0.0f;
+    float tangentEpsilon = 0.0f;
+};
+
+// 焊接统计
+struct MeshWeldStats {
+    unsigned int inputVertexCount = 0;
+    unsigned int outputVertexCount = 0;
+    unsigned int indexCount = 0;
+    double weldTimeMs = 0.0;
+};
+
+class MeshWelder {
+public:
+    // 焊接顶点
+    // 输入：原始顶点和索引（索引指向inVertices）
+    // 输出：唯一顶点表（保持首次出现的顺序）和重映射后的索引
+    // 允许outIndices与inIndices为同一个vector
+    static bool Weld(const std::vector<StaticMeshComponentVertexData>& inVertices,
+                     const std::vector<unsigned int>& inIndices,
+                     const MeshWeldSettings& settings,
+                     std::vector<StaticMeshComponentVertexData>& outVertices,
+                     std::vector<unsigned int>& outIndices,
+                     MeshWeldStats* outStats = nullptr);
+};
@@ -0,0 +1,36 @@
+// ParallelFor.h
+// 简单并行循环 — 临时线程按原子计数领取下标，适合加载/烘焙这类一次性的批量任务（常驻任务用各自的线程池）
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// 对[0, count)的每个下标调用func(index)，调用线程也参与；func必须可以并发执行
+// maxThreads为0时使用全部硬件线程
+template <typename Func>
+void ParallelFor(size_t count, Func func, unsigned int maxThreads = 0) {
+    if (count == 0) return;
+
+    unsigned int threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 4;
+    if (maxThreads > 0) threadCount = std::min(threadCount, maxThreads);
+    threadCount = (unsigned int)std::min<size_t>(threadCount, count);
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t index = next++; index < count; index = next++) {
+            func(index);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
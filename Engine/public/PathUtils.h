@@ -2,7 +2,10 @@
 // 项目路径工具 — 通过exe位置动态推算项目根目录，消除硬编码绝对路径
 
 #pragma once
+#include <cstdint>
 #include <string>
+#include <vector>
+#include <cwctype>
 #include <windows.h>
 
 // 获取项目根目录（FEngine/）
@@ -76,3 +79,84 @@ inline std::string WToA(const std::wstring& wstr) {
     WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, &result[0], len, nullptr, nullptr);
     return result;
 }
+
+// string(UTF-8) 转 wstring
+inline std::wstring AToW(const std::string& str) {
+    if (str.empty()) return L"";
+    int len = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
+    std::wstring result(len - 1, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, &result[0], len);
+    return result;
+}
+
+// 递归创建目录（已存在视为成功）
+inline bool CreateDirectoryRecursive(const std::wstring& path) {
+    DWORD attribs = GetFileAttributesW(path.c_str());
+    if (attribs != INVALID_FILE_ATTRIBUTES && (attribs & FILE_ATTRIBUTE_DIRECTORY)) {
+        return true;
+    }
+
+    size_t pos = path.find_last_of(L"\\/");
+    if (pos != std::wstring::npos) {
+        if (!CreateDirectoryRecursive(path.substr(0, pos))) {
+            return false;
+        }
+    }
+
+    return CreateDirectoryW(path.c_str(), NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+// 路径比较键：转为绝对路径，统一反斜杠并转小写（NTFS路径不区分大小写）
+inline std::wstring NormalizePathKey(const std::wstring& path) {
+    if (path.empty()) return L"";
+    wchar_t fullPath[MAX_PATH];
+    DWORD len = GetFullPathNameW(path.c_str(), MAX_PATH, fullPath, nullptr);
+    std::wstring key = (len > 0 && len < MAX_PATH) ? std::wstring(fullPath, len) : path;
+    for (wchar_t& c : key) {
+        c = (c == L'/') ? L'\\' : towlower(c);
+    }
+    return key;
+}
+
+// 写入文件的一段数据（WriteFileAtomic按顺序拼接）
+struct FileChunk {
+    const void* data;
+    size_t size;
+};
+
+// 原子写文件：先写<path>.tmp再替换，中途失败或退出不会留下半个文件；失败时删除临时文件
+inline bool WriteFileAtomic(const std::wstring& path, const FileChunk* chunks, size_t chunkCount) {
+    const std::wstring tempPath = path + L".tmp";
+    HANDLE file = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    bool ok = true;
+    for (size_t i = 0; i < chunkCount && ok; ++i) {
+        const char* bytes = static_cast<const char*>(chunks[i].data);
+        size_t remaining = chunks[i].size;
+        while (ok && remaining > 0) {
+            // WriteFile单次最多写DWORD范围，大块分段
+            const DWORD toWrite = remaining > 0x40000000 ? 0x40000000 : (DWORD)remaining;
+            DWORD written = 0;
+            ok = WriteFile(file, bytes, toWrite, &written, nullptr) && written == toWrite;
+            bytes += written;
+            remaining -= written;
+        }
+    }
+    CloseHandle(file);
+
+    if (ok && MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        return true;
+    }
+    DeleteFileW(tempPath.c_str());
+    return false;
+}
+
+inline bool WriteFileAtomic(const std::wstring& path, const void* data, size_t size) {
+    const FileChunk chunk = { data, size };
+    return WriteFileAtomic(path, &chunk, 1);
+}
+
+inline bool WriteFileAtomic(const std::wstring& path, const std::vector<uint8_t>& bytes) {
+    return WriteFileAtomic(path, bytes.data(), bytes.size());
+}
@@ -0,0 +1,96 @@
+// PipelineStateCache.h
+// 图形管线状态缓存 — 以完整管线描述（根签名、着色器字节码、输入布局、RT格式、光栅化/深度/混合状态）的64位哈希为键
+// 进程内相同描述只创建一次PSO；新建的PSO存入ID3D12PipelineLibrary并序列化到磁盘，热启动时跳过驱动编译
+// 热重载替换掉的着色器对应的PSO从缓存移除，等引用它的帧在GPU上完成后再释放
+// 只在主线程调用
+
+#pragma once
+#include <d3d12.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wrl/client.h>
+
+class PipelineStateCache {
+public:
+    static PipelineStateCache& GetInstance();
+
+    PipelineStateCache(const PipelineStateCache&) = delete;
+    PipelineStateCache& operator=(const PipelineStateCache&) = delete;
+
+    // 加载磁盘上的管线库（文件不存在、格式或驱动不匹配时新建空库）
+    // 未初始化或设备不支持管线库时只做进程内去重
+    bool Initialize(ID3D12Device* device, const std::wstring& filePath);
+    // 有新增PSO时写回磁盘，然后释放缓存持有的PSO和根签名引用（设备释放前调用）
+    void Shutdown();
+
+    // 登记根签名的序列化数据：按内容参与哈希，跨进程稳定
+    // 未登记的根签名按指针参与哈希，只在进程内去重，不写入管线库
+    void RegisterRootSignature(ID3D12RootSignature* rootSignature, const void* serializedData, size_t size);
+
+    // 与ID3D12Device::CreateGraphicsPipelineState用法一致：返回的PSO已AddRef，调用方照常Release
+    // 缓存的引用只用于去重，不保证PSO存活：需要长期保存PSO的调用方必须持有这里返回的引用
+    HRESULT CreateGraphicsPipelineState(ID3D12Device* device, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc,
+                                        ID3D12PipelineState** outPSO);
+
+    // ========== 热重载 ==========
+
+    // 着色器字节码内容哈希（与EvictShaders的参数对应），空字节码返回0
+    static uint64_t HashShaderBytecode(const D3D12_SHADER_BYTECODE& bytecode);
+    // 移除VS或PS字节码哈希在shaderHashes中的条目，缓存持有的引用在fenceValue完成后释放；返回移除数量
+    // 只覆盖已提交的帧：之后仍要使用这些PSO的地方（如从Shader::GetPSO借用的指针）必须在热重载后重新获取
+    int EvictShaders(const std::vector<uint64_t>& shaderHashes, UINT64 fenceValue);
+    // 释放GPU已用完的被移除PSO（每帧调用）
+    void ReleaseRetiredPipelines();
+
+    // ========== 统计信息 ==========
+
+    int GetHitCount() const { return m_hitCount; }                // 进程内去重命中
+    int GetLibraryHitCount() const { return m_libraryHitCount; }  // 从管线库加载
+    int GetMissCount() const { return m_missCount; }              // 由驱动创建
+    double GetCreateTimeMs() const { return m_createTimeMs; }     // 未命中时的累计创建耗时
+    size_t GetEntryCount() const { return m_pipelines.size(); }
+    int GetEvictCount() const { return m_evictCount; }            // 热重载累计移除
+    bool HasLibrary() const { return m_library.Get() != nullptr; }
+
+private:
+    PipelineStateCache() = default;
+    ~PipelineStateCache() = default;
+
+    struct PipelineEntry {
+        Microsoft::WRL::ComPtr<ID3D12PipelineState> pso;
+        uint64_t vsHash = 0;
+        uint64_t psHash = 0;
+    };
+
+    struct RetiredPipeline {
+        Microsoft::WRL::ComPtr<ID3D12PipelineState> pso;
+        UINT64 fenceValue;
+    };
+
+    struct RootSignatureRecord {
+        Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature;  // 持有引用，避免指针被新对象复用
+        uint64_t hash = 0;
+        bool persistent = false;    // 按序列化内容哈希，可写入管线库
+    };
+
+    const RootSignatureRecord& GetRootSignatureRecord(ID3D12RootSignature* rootSignature);
+    uint64_t ComputeKey(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, const RootSignatureRecord& rootSignature) const;
+    bool SaveLibrary();
+
+    std::wstring m_filePath;
+    Microsoft::WRL::ComPtr<ID3D12PipelineLibrary> m_library;
+    std::vector<uint8_t> m_libraryData;     // 管线库引用这块内存，必须比m_library活得久
+    bool m_libraryDirty = false;
+
+    std::unordered_map<uint64_t, PipelineEntry> m_pipelines;
+    std::vector<RetiredPipeline> m_retiredPipelines;
+    std::unordered_map<ID3D12RootSignature*, RootSignatureRecord> m_rootSignatures;
+
+    int m_hitCount = 0;
+    int m_libraryHitCount = 0;
+    int m_missCount = 0;
+    int m_evictCount = 0;
+    double m_createTimeMs = 0.0;
+};
@@ -3,6 +3,7 @@
 #include <vector>
 #include <map>
 #include <d3d12.h>
+#include "FileWatcher.h"
 
 class Shader;
 class MaterialInstance;
@@ -78,6 +79,26 @@ public:
     // UI 窗口控制
     void ShowResourceWindow(bool* open);
 
+    // ========== 热重载 ==========
+
+    // 监视Content和Engine目录：.shader/.hlsl/.material/纹理文件保存后自动重新加载
+    bool StartHotReload();
+    void StopHotReload();
+    bool IsHotReloadEnabled() const { return m_fileWatcher.IsRunning(); }
+
+    // 每帧调用：取出防抖后的变更。shader直接提交后台编译（帧边界替换），材质和纹理排队等待ProcessPendingReloads
+    void PollFileChanges();
+    bool HasPendingReloads() const { return !m_pendingTextureReloads.empty() || !m_pendingMaterialReloads.empty(); }
+    // 重新上传排队的纹理、重新读取排队的材质（调用前GPU须空闲，commandList须已打开）
+    void ProcessPendingReloads(ID3D12GraphicsCommandList* commandList);
+    int GetHotReloadCount() const { return m_hotReloadCount; }
+
+    // ========== 资产烘焙 ==========
+
+    // 离线转换：把Content和Engine目录下所有.material和.texture.ast烘焙为.matbin/.texbin（多线程，不需要GPU）
+    // 运行时加载过期的资产也会自动重新烘焙，这里用于发布前或批量修改后一次性转换；返回失败的文件数
+    int CookAssets();
+
 private:
     ResourceManager() : m_contentRoot(nullptr), m_engineRoot(nullptr) {}
     ~ResourceManager() {
@@ -110,4 +131,10 @@ private:
     // 路径配置（在Initialize中动态设置）
     std::wstring m_contentPath;
     std::wstring m_enginePath;
+
+    // 热重载
+    FileWatcher m_fileWatcher;
+    std::vector<std::wstring> m_pendingTextureReloads;
+    std::vector<std::wstring> m_pendingMaterialReloads;
+    int m_hotReloadCount = 0;
 };
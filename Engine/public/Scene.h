@@ -5,11 +5,15 @@
 #include "StaticMeshComponent.h"
 #include "public/Material.h"
 #include "public/Actor.h"
+#include "public/FrustumCulling.h"
+#include "public/SpatialIndex.h"
+#include "public/DrawList.h"
 #include <d3d12.h>
 #include <DirectXMath.h>
 #include <future>  // 必须包含此头文件
 #include <d3dx12.h>
 #include <wrl/client.h>
+#include <unordered_map>
 #include <vector>
 
 using Microsoft::WRL::ComPtr;
@@ -56,18 +60,48 @@ public:
     }
     DirectX::XMFLOAT3 GetSkylightColor() const { return m_skylightColor; }
 
-    ID3D12Resource* GetConstantBuffer() const { return m_constantBuffer; }
+    // 本帧场景常量缓冲（b0）的GPU地址：Update中从逐帧上传分配器分配，所有Pass共享
+    D3D12_GPU_VIRTUAL_ADDRESS GetSceneCBAddress() const { return m_sceneCBAddress; }
 
     // 获取mesh（用于材质分配）
     StaticMeshComponent* GetStaticMesh() { return &m_staticMesh; }
 
     // Actor管理
     Actor* CreateActor(const std::string& name);
+    // 将外部创建的Actor加入场景（同时登记到空间索引）
+    void AddActor(Actor* actor);
     bool LoadActorFromMeshFile(const std::wstring& meshFilePath, ID3D12GraphicsCommandList* commandList);
     void RemoveActor(Actor* actor);
     std::vector<Actor*>& GetActors() { return m_actors; }
     Actor* GetActorByName(const std::string& name);
 
+    // 视锥剔除结果（Update中计算）：相机可见列表 / 阴影正交视锥内的投影者列表
+    const std::vector<Actor*>& GetVisibleActors() const { return m_visibleActors; }
+    const std::vector<Actor*>& GetShadowCasterActors() const { return m_shadowCasterActors; }
+    void SetFrustumCullingEnabled(bool enabled) { m_frustumCullingEnabled = enabled; }
+    bool IsFrustumCullingEnabled() const { return m_frustumCullingEnabled; }
+    const CullingStats& GetCullingStats() const { return m_cullingStats; }
+    // 剔除使用空间索引（关闭时退回逐个SoA测试，用于对比）
+    void SetSpatialIndexEnabled(bool enabled) { m_spatialIndexEnabled = enabled; }
+    bool IsSpatialIndexEnabled() const { return m_spatialIndexEnabled; }
+    const ActorSpatialIndex& GetSpatialIndex() const { return m_spatialIndex; }
+    // BasePass绘制列表提交统计（Render中计算）
+    const DrawSubmitStats& GetDrawStats() const { return m_drawStats; }
+
+    // 实例化：同Mesh同材质的Actor合并为一次DrawCall（关闭时每个Actor一次DrawCall，用于对比）
+    void SetInstancingEnabled(bool enabled) { m_instancingEnabled = enabled; }
+    bool IsInstancingEnabled() const { return m_instancingEnabled; }
+    // 阴影投影者的绘制列表和批次（Update中构建，阴影Pass按批次实例化绘制）
+    const DrawList& GetShadowDrawList() const { return m_shadowDrawList; }
+    const std::vector<DrawBatch>& GetShadowBatches() const { return m_shadowBatches; }
+    // 实例缓冲中第firstInstance个实例的GPU地址（绑定到根签名Slot 3）
+    D3D12_GPU_VIRTUAL_ADDRESS GetInstanceDataAddress(uint32_t firstInstance) const;
+
+    // 鼠标拾取：ndcX/ndcY为屏幕归一化坐标（[-1,1]，y向上），返回最近命中的Actor
+    Actor* PickActor(float ndcX, float ndcY);
+    // 范围查询：与包围盒相交的Actor追加到outActors
+    void QueryActorsInAABB(const SpatialAABB& aabb, std::vector<Actor*>& outActors);
+
     // Level管理
     bool LoadLevel(const std::wstring& levelFilePath, ID3D12GraphicsCommandList* commandList);
     bool SaveLevel(const std::wstring& levelFilePath);
@@ -131,6 +165,13 @@ private:
     // 通用纹理加载（替代原来4个独立函数）
     bool LoadAndUploadTexture(const wchar_t* pngPath, const char* textureName, bool isCubemap);
     bool LoadTextures();
+    // 视锥剔除：填充m_visibleActors和m_shadowCasterActors
+    void CullActors(const DirectX::XMMATRIX& cameraViewProj, const DirectX::XMMATRIX& lightViewProj);
+    // 对剔除结果排序、合批，并把实例数据写入本帧的上传内存
+    void BuildDrawLists(const DirectX::XMMATRIX& viewMatrix);
+    // 纹理流送反馈：按可见Actor的屏幕尺寸和网格UV密度估算各材质纹理需要的mip，交给TextureManager
+    void RequestTextureStreaming();
+    std::unordered_map<MaterialInstance*, float> m_streamingScreenSizes;  // 材质 -> 一个UV单位覆盖的最大像素数（每帧重建）
     // 异步加载相关成员
     std::future<bool> m_textureLoadFuture;  // 异步任务句柄
     std::atomic<bool> m_textureLoaded;      // 加载是否完成（原子变量，线程安全）
@@ -140,9 +181,7 @@ private:
 
     StaticMeshComponent m_staticMesh;
     Camera m_camera;
-    ID3D12Resource* m_constantBuffer;//常量缓冲区b0
-    // 修改：常量缓冲区大小调整为72（适配HLSL 16字节对齐）
-    void* m_mappedConstantBuffer = nullptr;      // 映射的常量缓冲区内存指针
+    D3D12_GPU_VIRTUAL_ADDRESS m_sceneCBAddress = 0;//常量缓冲区b0（逐帧分配）
     ID3D12Resource* m_texBuffer;////常量缓冲区b1
     SceneCBData m_cbData;  // 共享CB结构体，替代 float m_matrices[176]
 
@@ -158,6 +197,30 @@ private:
     DirectX::XMFLOAT3 m_skylightColor = DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);  // Skylight颜色（默认白色）
     float m_shadowOrthoSize = 20.0f;  // Shadowmap正交投影范围（默认20）
     int m_shadowMode = 2;             // 阴影模式：0=Hard, 1=PCF, 2=PCSS（默认PCSS）
+
+    // 视锥剔除
+    FrustumCuller m_culler;
+    ActorSpatialIndex m_spatialIndex;
+    bool m_spatialIndexEnabled = true;
+    std::vector<uint8_t> m_cameraVisibleMask;  // 按空间索引代理ID记录相机可见，避免重复更新CB
+    std::vector<Actor*> m_visibleActors;
+    std::vector<Actor*> m_shadowCasterActors;
+    bool m_frustumCullingEnabled = true;
+    uint64_t m_frameIndex = 0;  // 每次Update加一，用于判断Actor上一帧是否更新过实例数据
+
+    // BasePass绘制列表
+    DrawList m_drawList;
+    DrawStateCache m_drawStateCache;
+    DrawSubmitStats m_drawStats;
+    double m_drawListBuildTimeMs = 0.0;
+
+    // 实例化
+    bool m_instancingEnabled = true;
+    std::vector<DrawBatch> m_drawBatches;
+    DrawList m_shadowDrawList;
+    std::vector<DrawBatch> m_shadowBatches;
+    D3D12_GPU_VIRTUAL_ADDRESS m_instanceDataAddress = 0;  // 本帧实例数据（逐帧分配），BasePass实例在前、阴影实例在后
+    CullingStats m_cullingStats;
     bool m_shadowmapEnabled = true;   // Shadowmap开关（默认开启）
     int m_giType = 0;                 // GI模式：0=Close(ambient), 1=SSGI
 
@@ -13,7 +13,7 @@ public:
     ~ScreenPass();
 
     // ���������ó�����������������BasePass������
-    void SetSceneConstantBuffer(ID3D12Resource* sceneCB) { m_sceneConstantBuffer = sceneCB; }
+    void SetSceneConstantBuffer(D3D12_GPU_VIRTUAL_ADDRESS sceneCBAddress) { m_sceneCBAddress = sceneCBAddress; }
 
     // 设置材质常量缓冲区（用于匹配root signature）
     void SetMaterialConstantBuffer(ID3D12Resource* materialCB) { m_materialConstantBuffer = materialCB; }
@@ -65,7 +65,7 @@ private:
     int m_viewportHeight = 0;
 
     // �洢BasePass�ĳ������������������ݣ�
-    ID3D12Resource* m_sceneConstantBuffer = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS m_sceneCBAddress = 0;
 
     // 材质常量缓冲区（用于匹配root signature）
     ID3D12Resource* m_materialConstantBuffer = nullptr;
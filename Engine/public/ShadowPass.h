@@ -18,7 +18,7 @@ public:
     bool Initialize();
 
     // 设置场景常量缓冲区（包含LightViewProjectionMatrix）
-    void SetSceneConstantBuffer(ID3D12Resource* sceneCB) { m_sceneConstantBuffer = sceneCB; }
+    void SetSceneConstantBuffer(D3D12_GPU_VIRTUAL_ADDRESS sceneCBAddress) { m_sceneCBAddress = sceneCBAddress; }
 
     // 渲染Shadow Map（从光源视角渲染场景深度）
     void Render(ID3D12GraphicsCommandList* commandList,
@@ -62,5 +62,5 @@ private:
     UINT m_srvDescriptorSize;
 
     // 场景常量缓冲区引用
-    ID3D12Resource* m_sceneConstantBuffer = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS m_sceneCBAddress = 0;
 };
@@ -13,7 +13,7 @@ public:
     ~SkyPass();
 
     // 设置场景常量缓冲区（包含相机位置、矩阵等）
-    void SetSceneConstantBuffer(ID3D12Resource* sceneCB) { m_sceneConstantBuffer = sceneCB; }
+    void SetSceneConstantBuffer(D3D12_GPU_VIRTUAL_ADDRESS sceneCBAddress) { m_sceneCBAddress = sceneCBAddress; }
 
     // 初始化：创建天空球几何体和SRV堆
     bool Initialize(ID3D12GraphicsCommandList* commandList, float sphereRadius = 500.0f);
@@ -52,8 +52,8 @@ private:
     ComPtr<ID3D12DescriptorHeap> m_srvHeap;
     UINT m_srvDescriptorSize = 0;
 
-    // 场景常量缓冲区引用（不拥有所有权）
-    ID3D12Resource* m_sceneConstantBuffer = nullptr;
+    // 场景常量缓冲区GPU地址（每帧Update后设置）
+    D3D12_GPU_VIRTUAL_ADDRESS m_sceneCBAddress = 0;
 
     // 顶点结构
     struct SkyVertex {
@@ -0,0 +1,291 @@
+// SpatialIndex.h
+// 场景空间索引 — 动态AABB树（增量插入/删除/移动 + 旋转平衡），支持视锥、射线、AABB范围查询
+
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "FrustumCulling.h"
+#include "Mesh/MeshTypes.h"
+
+class Actor;
+
+// 轴对齐包围盒
+struct SpatialAABB {
+    float min[3] = { 0.0f, 0.0f, 0.0f };
+    float max[3] = { 0.0f, 0.0f, 0.0f };
+
+    bool Contains(const SpatialAABB& other) const {
+        for (int i = 0; i < 3; ++i) {
+            if (other.min[i] < min[i] || other.max[i] > max[i]) return false;
+        }
+        return true;
+    }
+
+    bool Overlaps(const SpatialAABB& other) const {
+        for (int i = 0; i < 3; ++i) {
+            if (other.min[i] > max[i] || other.max[i] < min[i]) return false;
+        }
+        return true;
+    }
+
+    float SurfaceArea() const {
+        float dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+        return 2.0f * (dx * dy + dy * dz + dz * dx);
+    }
+
+    static SpatialAABB Union(const SpatialAABB& a, const SpatialAABB& b) {
+        SpatialAABB result;
+        for (int i = 0; i < 3; ++i) {
+            result.min[i] = a.min[i] < b.min[i] ? a.min[i] : b.min[i];
+            result.max[i] = a.max[i] > b.max[i] ? a.max[i] : b.max[i];
+        }
+        return result;
+    }
+
+    // 射线与包围盒求交（slab），invDir为方向分量倒数，命中时tHit为进入距离
+    bool RayIntersect(const float origin[3], const float invDir[3], float maxDistance, float& tHit) const {
+        float tMin = 0.0f, tMax = maxDistance;
+        for (int i = 0; i < 3; ++i) {
+            float t1 = (min[i] - origin[i]) * invDir[i];
+            float t2 = (max[i] - origin[i]) * invDir[i];
+            if (t1 > t2) { float t = t1; t1 = t2; t2 = t; }
+            if (t1 > tMin) tMin = t1;
+            if (t2 < tMax) tMax = t2;
+            if (tMin > tMax) return false;
+        }
+        tHit = tMin;
+        return true;
+    }
+};
+
+// 动态AABB树：叶子存储外扩后的“胖”包围盒，小幅移动不需要改动树结构
+class DynamicAABBTree {
+public:
+    static constexpr int NullNode = -1;
+
+    DynamicAABBTree();
+
+    // 插入叶子，返回代理ID（即节点下标，在销毁前保持不变）
+    int CreateProxy(const SpatialAABB& aabb, void* userData);
+    void DestroyProxy(int proxyId);
+    // 移动代理：新包围盒仍在胖包围盒内时返回false（树不变），否则重新插入并返回true
+    bool MoveProxy(int proxyId, const SpatialAABB& aabb);
+    void Clear();
+    // 全量重建（按质心中位数自顶向下划分），代理ID保持不变；批量插入（关卡加载）后调用可提升查询效率
+    void Rebuild();
+
+    void* GetUserData(int proxyId) const { return m_nodes[proxyId].userData; }
+    const SpatialAABB& GetFatAABB(int proxyId) const { return m_nodes[proxyId].aabb; }
+    int GetProxyCount() const { return m_proxyCount; }
+    int GetNodeCapacity() const { return (int)m_nodes.size(); }
+    int GetHeight() const { return m_root == NullNode ? 0 : m_nodes[m_root].height; }
+
+    // 胖包围盒外扩量
+    void SetMargin(float margin) { m_margin = margin; }
+
+    // 视锥查询：callback(proxyId)。完全在某平面内侧的子树不再测试该平面，完全在视锥内的子树直接输出
+    template <typename Callback>
+    void QueryFrustum(const Frustum& frustum, Callback&& callback) const;
+
+    // 范围查询：callback(proxyId)
+    template <typename Callback>
+    void QueryAABB(const SpatialAABB& aabb, Callback&& callback) const;
+
+    // 射线查询：callback(proxyId, maxDistance) 返回新的裁剪距离（命中更近物体时缩短，后续只遍历更近的节点）
+    template <typename Callback>
+    void RayCast(const float origin[3], const float direction[3], float maxDistance, Callback&& callback) const;
+
+private:
+    struct TreeNode {
+        SpatialAABB aabb;
+        void* userData = nullptr;
+        int parent = NullNode;      // 空闲节点复用为空闲链表的next
+        int child1 = NullNode;
+        int child2 = NullNode;
+        int height = -1;            // 叶子为0，空闲节点为-1
+
+        bool IsLeaf() const { return child1 == NullNode; }
+    };
+
+    int AllocateNode();
+    void FreeNode(int nodeId);
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+    int Balance(int nodeId);
+    void RefitAncestors(int nodeId);
+    int BuildTopDown(int* leaves, int count);
+
+    std::vector<TreeNode> m_nodes;
+    int m_root = NullNode;
+    int m_freeList = NullNode;
+    int m_proxyCount = 0;
+    float m_margin = 0.1f;
+
+    // 查询用遍历栈（查询只在主线程进行）
+    mutable std::vector<std::pair<int, uint8_t>> m_stack;
+};
+
+// Actor空间索引：维护Actor世界包围盒到动态AABB树的映射，Transform变化时由Actor登记，下次Flush时批量更新
+class ActorSpatialIndex {
+public:
+    ActorSpatialIndex() = default;
+    ~ActorSpatialIndex() { Clear(); }
+
+    ActorSpatialIndex(const ActorSpatialIndex&) = delete;
+    ActorSpatialIndex& operator=(const ActorSpatialIndex&) = delete;
+
+    void Insert(Actor* actor);
+    void Remove(Actor* actor);
+    // Actor包围体变化时调用（由Actor自动登记）
+    void MarkDirty(Actor* actor);
+    // 更新所有登记过的Actor，返回实际改动树结构的数量
+    int Flush();
+    // 批量插入后重建整棵树（关卡加载完成时调用）
+    void Rebuild();
+    void Clear();
+
+    // 查询只读取Flush时缓存的紧包围盒，不访问Actor的惰性接口；调用前先Flush
+    // 视锥内有Mesh的Actor追加到outActors（胖包围盒命中后按紧包围盒精确测试）
+    void QueryFrustum(const Frustum& frustum, std::vector<Actor*>& outActors) const;
+    // 与范围相交的Actor追加到outActors
+    void QueryAABB(const SpatialAABB& aabb, std::vector<Actor*>& outActors) const;
+    // 射线拾取：返回最近命中的Actor（按世界AABB求交），outDistance为命中距离
+    Actor* RayCast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction,
+                   float maxDistance, float* outDistance = nullptr) const;
+
+    const DynamicAABBTree& GetTree() const { return m_tree; }
+
+    static SpatialAABB ToAABB(const MeshBounds& bounds);
+
+private:
+    void SetBounds(int proxyId, const SpatialAABB& bounds);
+
+    DynamicAABBTree m_tree;
+    std::vector<Actor*> m_dirtyActors;
+    // 各代理的紧包围盒（按代理ID索引，Insert/Flush时写入）
+    std::vector<SpatialAABB> m_bounds;
+};
+
+// 空间索引与暴力遍历的对比测试结果
+struct SpatialBenchmarkResult {
+    int actorCount = 0;
+    int treeHeight = 0;
+    double treeBuildMs = 0.0;        // 逐个插入
+    double treeRebuildMs = 0.0;      // 自顶向下全量重建
+    double treeUpdateMs = 0.0;       // 1%的包围盒移动后增量更新
+    double bruteFrustumMs = 0.0;     // 每次查询平均耗时
+    double treeFrustumMs = 0.0;
+    double bruteRayMs = 0.0;
+    double treeRayMs = 0.0;
+    double bruteAABBMs = 0.0;
+    double treeAABBMs = 0.0;
+    int visibleCount = 0;
+    bool resultsMatch = true;        // 两种方式结果是否一致
+};
+
+// 在随机分布的包围盒上比较动态AABB树与暴力遍历（SoA SSE视锥测试 / 逐个射线、范围测试）
+void RunSpatialIndexBenchmark(int actorCount, SpatialBenchmarkResult& outResult);
+
+// ========== 模板实现 ==========
+
+template <typename Callback>
+void DynamicAABBTree::QueryFrustum(const Frustum& frustum, Callback&& callback) const {
+    if (m_root == NullNode) return;
+
+    const uint8_t allPlanes = 0x3F;
+    m_stack.clear();
+    m_stack.push_back({ m_root, allPlanes });
+
+    while (!m_stack.empty()) {
+        int nodeId = m_stack.back().first;
+        uint8_t planeMask = m_stack.back().second;
+        m_stack.pop_back();
+
+        const TreeNode& node = m_nodes[nodeId];
+
+        if (planeMask) {
+            float center[3], extent[3];
+            for (int i = 0; i < 3; ++i) {
+                center[i] = (node.aabb.min[i] + node.aabb.max[i]) * 0.5f;
+                extent[i] = (node.aabb.max[i] - node.aabb.min[i]) * 0.5f;
+            }
+
+            bool outside = false;
+            for (int p = 0; p < 6; ++p) {
+                if (!(planeMask & (1 << p))) continue;
+                const DirectX::XMFLOAT4& plane = frustum.planes[p];
+                float d = plane.x * center[0] + plane.y * center[1] + plane.z * center[2] + plane.w;
+                float r = fabsf(plane.x) * extent[0] + fabsf(plane.y) * extent[1] + fabsf(plane.z) * extent[2];
+                if (d + r < 0.0f) {
+                    outside = true;
+                    break;
+                }
+                if (d - r >= 0.0f) {
+                    planeMask &= (uint8_t)~(1 << p);  // 子节点都在该平面内侧
+                }
+            }
+            if (outside) continue;
+        }
+
+        if (node.IsLeaf()) {
+            callback(nodeId);
+        } else {
+            m_stack.push_back({ node.child1, planeMask });
+            m_stack.push_back({ node.child2, planeMask });
+        }
+    }
+}
+
+template <typename Callback>
+void DynamicAABBTree::QueryAABB(const SpatialAABB& aabb, Callback&& callback) const {
+    if (m_root == NullNode) return;
+
+    m_stack.clear();
+    m_stack.push_back({ m_root, 0 });
+
+    while (!m_stack.empty()) {
+        int nodeId = m_stack.back().first;
+        m_stack.pop_back();
+
+        const TreeNode& node = m_nodes[nodeId];
+        if (!node.aabb.Overlaps(aabb)) continue;
+
+        if (node.IsLeaf()) {
+            callback(nodeId);
+        } else {
+            m_stack.push_back({ node.child1, 0 });
+            m_stack.push_back({ node.child2, 0 });
+        }
+    }
+}
+
+template <typename Callback>
+void DynamicAABBTree::RayCast(const float origin[3], const float direction[3], float maxDistance, Callback&& callback) const {
+    if (m_root == NullNode) return;
+
+    float invDir[3];
+    for (int i = 0; i < 3; ++i) {
+        invDir[i] = direction[i] != 0.0f ? 1.0f / direction[i] : 1e30f;
+    }
+
+    m_stack.clear();
+    m_stack.push_back({ m_root, 0 });
+
+    while (!m_stack.empty()) {
+        int nodeId = m_stack.back().first;
+        m_stack.pop_back();
+
+        const TreeNode& node = m_nodes[nodeId];
+        float tHit;
+        if (!node.aabb.RayIntersect(origin, invDir, maxDistance, tHit)) continue;
+
+        if (node.IsLeaf()) {
+            maxDistance = callback(nodeId, maxDistance);
+        } else {
+            m_stack.push_back({ node.child1, 0 });
+            m_stack.push_back({ node.child2, 0 });
+        }
+    }
+}
@@ -38,7 +38,7 @@ public:
     ~SsgiPass();
 
     bool Initialize(int viewportWidth, int viewportHeight);
-    void SetSceneConstantBuffer(ID3D12Resource* sceneCB) { m_sceneConstantBuffer = sceneCB; }
+    void SetSceneConstantBuffer(D3D12_GPU_VIRTUAL_ADDRESS sceneCBAddress) { m_sceneCBAddress = sceneCBAddress; }
 
     void Render(ID3D12GraphicsCommandList* cmdList,
         ID3D12PipelineState* depthMaxPso,
@@ -92,7 +92,6 @@ public:
 private:
     void CreateRenderTargets();
     void CreateSRVHeap();
-    void CreateConstantBuffer();
     void CreateDefaultBlackTexture();
     void CreateNoiseTexture();
     void UpdateConstants();
@@ -119,8 +118,8 @@ private:
     UINT m_rtvDescriptorSize = 0;
     UINT m_srvDescriptorSize = 0;
 
-    ID3D12Resource* m_sceneConstantBuffer = nullptr;
-    ComPtr<ID3D12Resource> m_ssgiConstantBuffer;
+    D3D12_GPU_VIRTUAL_ADDRESS m_sceneCBAddress = 0;
+    D3D12_GPU_VIRTUAL_ADDRESS m_ssgiCBAddress = 0;
 
     ComPtr<ID3D12Resource> m_defaultBlackTexture;
     ComPtr<ID3D12Resource> m_defaultBlackTextureUpload;
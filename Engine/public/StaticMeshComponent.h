@@ -4,40 +4,42 @@
 #include <unordered_map>
 #include <string>
 #include <fbxsdk.h>
+#include "Mesh/MeshTypes.h"
+#include "Mesh/MeshWelder.h"
+#include "Mesh/MeshOptimizer.h"
 
 // 前向声明
 class MaterialInstance;
 
-struct StaticMeshComponentVertexData {
-    float mPosition[4];
-    float mTexcoord[4];
-    float mNormal[4];
-    float mTangent[4];
-
-    bool operator==(const StaticMeshComponentVertexData& other) const {
-        return memcmp(mPosition, other.mPosition, sizeof(mPosition)) == 0 &&
-            memcmp(mTexcoord, other.mTexcoord, sizeof(mTexcoord)) == 0 &&
-            memcmp(mNormal, other.mNormal, sizeof(mNormal)) == 0 &&
-            memcmp(mTangent, other.mTangent, sizeof(mTangent)) == 0;
-    }
-};
+// 子网格：所有子网格共用StaticMeshComponent的IBO，这里只记录索引区间
 struct SubMesh {
-    ID3D12Resource* mIBO;
     D3D12_INDEX_BUFFER_VIEW mIBView;
     int mIndexCount;
-    ~SubMesh() { if (mIBO) mIBO->Release(); }
+    unsigned int mStartIndex;
+    MeshBounds mBounds;
 };
 
 class StaticMeshComponent {
 public:
     ID3D12Resource* mVBO = nullptr;
     D3D12_VERTEX_BUFFER_VIEW mVBOView = {};
+    ID3D12Resource* mIBO = nullptr;
     StaticMeshComponentVertexData* mVertexData = nullptr;
     int mVertexCount = 0;
     std::unordered_map<std::string, SubMesh*> mSubMeshes;
 
+    // 局部空间包围体
+    MeshBounds mBounds;
+
+    // 纹理坐标密度（局部空间每单位长度的UV单位数，见ComputeMeshUVDensity），纹理流送用
+    float mUVDensity = 0.0f;
+
+    // 导入统计（顶点焊接前后数量、耗时，仅直接从FBX导入时有效）
+    MeshWeldStats mImportStats;
+
     ~StaticMeshComponent() {
         if (mVBO) mVBO->Release();
+        if (mIBO) mIBO->Release();
         delete[] mVertexData;
         for (auto& pair : mSubMeshes) {
             delete pair.second;
@@ -51,17 +53,36 @@ public:
     void SetVertexNormal(int inIndex, float inX, float inY, float inZ, float inW = 0.0f);
     void SetVertexTangent(int inIndex, float inX, float inY, float inZ, float inW = 1.0f);
 
+    // 直接导入FBX并上传（不经过烘焙缓存）
     void InitFromFile(ID3D12GraphicsCommandList* inCommandList, const char* inFilePath);
+
+    // 从烘焙的.meshbin加载：内存映射后数据块直接上传
+    // fbxSourcePath非空时先检查烘焙结果是否过期，过期则重新烘焙
+    bool InitFromMeshBin(ID3D12GraphicsCommandList* inCommandList, const std::wstring& meshBinPath,
+                         const std::wstring& fbxSourcePath);
+
+    // 导入FBX到CPU侧数据（焊接+索引优化），不创建GPU资源
+    static bool ImportFBX(const char* inFilePath, MeshImportData& outData, MeshWeldStats* outWeldStats = nullptr);
+
+    // 上传顶点/索引数据（数据可以直接来自内存映射文件）
+    bool UploadGeometry(ID3D12GraphicsCommandList* inCommandList,
+                        const StaticMeshComponentVertexData* vertices, unsigned int vertexCount,
+                        const unsigned int* indices, unsigned int indexCount);
+    // 在已上传的IBO上登记子网格（需先调用UploadGeometry）
+    void AddSubMesh(const std::string& name, unsigned int indexOffset, unsigned int indexCount, const MeshBounds& bounds);
+
     void Render(ID3D12GraphicsCommandList* inCommandList, ID3D12RootSignature* rootSignature);
+    // 只提交子网格的DrawCall（顶点缓冲和材质由调用方绑定），instanceCount>1时为实例化绘制
+    void DrawSubMeshes(ID3D12GraphicsCommandList* inCommandList, UINT instanceCount = 1);
 
     // 材质相关方法
     void SetMaterial(MaterialInstance* material) { m_material = material; }
     MaterialInstance* GetMaterial() const { return m_material; }
 
 private:
-    bool ParseFBXScene(FbxScene* pScene, ID3D12GraphicsCommandList* inCommandList);
-    void ProcessFBXNode(FbxNode* pNode, ID3D12GraphicsCommandList* inCommandList);
-    void ProcessFBXMesh(FbxMesh* pMesh, const std::string& nodeName, ID3D12GraphicsCommandList* inCommandList);
+    static bool ParseFBXScene(FbxScene* pScene, MeshImportData& outData, MeshWeldStats* outWeldStats);
+    static void ProcessFBXNode(FbxNode* pNode, MeshImportData& outData, MeshWeldStats* outWeldStats);
+    static void ProcessFBXMesh(FbxMesh* pMesh, const std::string& nodeName, MeshImportData& outData, MeshWeldStats* outWeldStats);
 
     // 材质成员
     MaterialInstance* m_material = nullptr;
@@ -45,7 +45,7 @@ public:
     void Resize(int newWidth, int newHeight);
 
     // 设置场景常量缓冲区
-    void SetSceneConstantBuffer(ID3D12Resource* sceneCB) { m_sceneConstantBuffer = sceneCB; }
+    void SetSceneConstantBuffer(D3D12_GPU_VIRTUAL_ADDRESS sceneCBAddress) { m_sceneCBAddress = sceneCBAddress; }
 
     // 获取 TAA 输出纹理（用于最终显示）
     ID3D12Resource* GetOutputTexture() const { return m_outputRT.Get(); }
@@ -121,7 +121,7 @@ private:
     // 设置viewport和scissor（内部辅助）
     void SetViewportAndScissor(ID3D12GraphicsCommandList* cmdList);
 
-    // 更新TAA常量缓冲区（内部辅助）
+    // 写入本帧TAA常量（内部辅助）
     void UpdateTaaConstants();
 
     // 生成 Halton 序列（用于 Jitter）
@@ -152,10 +152,10 @@ private:
     UINT m_srvDescriptorSize = 0;
 
     // 场景常量缓冲区
-    ID3D12Resource* m_sceneConstantBuffer = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS m_sceneCBAddress = 0;
 
-    // TAA 常量缓冲区
-    ComPtr<ID3D12Resource> m_taaConstantBuffer;
+    // TAA 常量缓冲区（每帧从LinearUploadAllocator分配）
+    D3D12_GPU_VIRTUAL_ADDRESS m_taaCBAddress = 0;
 
     // Jitter 相关
     XMFLOAT2 m_currentJitter = { 0.0f, 0.0f };
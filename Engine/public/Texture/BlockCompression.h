@@ -0,0 +1,93 @@
+// BlockCompression.h
+// CPU块压缩编码器（BC1/BC3/BC5/BC7/BC6H）— 纹理导入时在进程内压缩，不再启动外部NVTT进程
+// 只依赖C++标准库和SSE2/AVX2内置函数，不包含Windows/D3D头文件，可在Linux上编译用于无头烘焙
+// 表面按块行分给ParallelFor的线程；每个4x4块独立编码，结果与线程数无关
+// BC7/BC6H的实现在BlockCompressionBC67.cpp
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class BlockFormat : uint8_t {
+    BC1,    // RGB，8字节/块（忽略Alpha）
+    BC3,    // RGBA，16字节/块（BC4 Alpha + 4色颜色块）
+    BC5,    // RG，16字节/块（两个BC4通道，法线贴图）
+    BC7,    // RGBA，16字节/块（只尝试部分模式，见BlockCompressionBC67.cpp）
+    BC6H    // HDR RGB（无符号半精度），16字节/块，输入用EncodeSurfaceHDR
+};
+
+// 质量档位（TextureCompressor把TextureCompressionQuality映射到这里）
+enum class BlockEncodeQuality : uint8_t {
+    Fast,       // 包围盒端点，不迭代
+    Normal,     // 主成分方向端点 + 1次最小二乘修正；BC7/BC6H只对估计最好的少数分区完整编码
+    High,       // 多次修正；BC1额外尝试3色模式，BC4额外尝试6值模式；BC7/BC6H搜索更多分区和模式
+    Ultra       // High + 量化端点的邻域搜索；BC7加入三子集模式，BC6H尝试全部双区域模式
+};
+
+struct BlockEncodeSettings {
+    BlockFormat format = BlockFormat::BC1;
+    BlockEncodeQuality quality = BlockEncodeQuality::Normal;
+    unsigned int maxThreads = 0;    // 0：全部硬件线程（小图自动减少）
+};
+
+// 一个4x4块的字节数
+size_t GetBlockBytes(BlockFormat format);
+// 一行块的字节数 / 整个表面的字节数（宽高不足4的按一个块）
+size_t GetBlockRowPitch(BlockFormat format, uint32_t width);
+size_t GetEncodedSurfaceSize(BlockFormat format, uint32_t width, uint32_t height);
+
+// 编码RGBA8表面（rowPitch为源行距字节数），边缘不足4像素的块复制边缘像素
+// outBlocks按GetBlockRowPitch逐行排列，大小为GetEncodedSurfaceSize
+void EncodeSurface(const uint8_t* rgba, uint32_t width, uint32_t height, size_t rowPitch,
+                   const BlockEncodeSettings& settings, uint8_t* outBlocks);
+
+// 编码单个块：rgba为16个像素（行优先，每像素4字节），out为GetBlockBytes字节
+// BC6H从这里进入时按[0,1]的LDR值编码
+void EncodeBlock(BlockFormat format, const uint8_t rgba[64], BlockEncodeQuality quality, uint8_t* out);
+
+// 解码回RGBA8（质量对比用）：BC1的A为255；BC5的B为0、A为255；BC6H截断到[0,1]
+void DecodeSurface(const uint8_t* blocks, BlockFormat format, uint32_t width, uint32_t height,
+                   uint8_t* outRGBA, size_t outRowPitch);
+
+// 两张RGBA8图像在该格式有效通道（BC1/BC6H:RGB，BC3/BC7:RGBA，BC5:RG）上的PSNR（dB），完全相同时返回99
+double ComputeBlockPSNR(BlockFormat format, const uint8_t* reference, size_t referenceRowPitch,
+                        const uint8_t* decoded, size_t decodedRowPitch, uint32_t width, uint32_t height);
+
+// ========== HDR（BC6H） ==========
+
+// 编码RGBA32F表面为BC6H（UF16）：负值按0、超出半精度范围的按65504处理，忽略Alpha
+// settings.format必须为BC6H，rowPitch为源行距字节数
+void EncodeSurfaceHDR(const float* rgba, uint32_t width, uint32_t height, size_t rowPitch,
+                      const BlockEncodeSettings& settings, uint8_t* outBlocks);
+
+// 解码BC6H为RGBA32F（A为1）
+void DecodeSurfaceHDR(const uint8_t* blocks, uint32_t width, uint32_t height, float* outRGBA, size_t outRowPitch);
+
+// HDR图像的PSNR：RGB先做x/(1+x)色调映射再按峰值1计算，与曝光无关的粗略质量指标
+double ComputeHDRPSNR(const float* reference, size_t referenceRowPitch,
+                      const float* decoded, size_t decodedRowPitch, uint32_t width, uint32_t height);
+
+// ========== BC7/BC6H单块接口 ==========
+
+void EncodeBC7Block(const uint8_t rgba[64], BlockEncodeQuality quality, uint8_t out[16]);
+void DecodeBC7Block(const uint8_t in[16], uint8_t outRGBA[64]);
+
+// rgba为16个像素的RGBA32F（忽略Alpha）
+void EncodeBC6HBlock(const float rgba[64], BlockEncodeQuality quality, uint8_t out[16]);
+void DecodeBC6HBlock(const uint8_t in[16], float outRGBA[64]);
+
+// ========== 性能与质量测试 ==========
+
+struct BlockEncoderBenchmarkResult {
+    BlockFormat format = BlockFormat::BC1;
+    BlockEncodeQuality quality = BlockEncodeQuality::Normal;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    double encodeMs = 0.0;
+    double megapixelsPerSecond = 0.0;
+    double psnr = 0.0;          // BC6H为ComputeHDRPSNR，其余为ComputeBlockPSNR
+};
+
+// 在合成图像（LDR：渐变+噪声+硬边+Alpha渐变；HDR：带高亮光源的天空）上测试每种格式和质量档位的吞吐量与PSNR
+void RunBlockEncoderBenchmark(uint32_t size, std::vector<BlockEncoderBenchmarkResult>& outResults);
@@ -0,0 +1,59 @@
+// MipGenerator.h
+// 引擎mip链生成器 — 可选滤波器（Box/Kaiser/Lanczos），sRGB纹理在线性空间滤波，保持Alpha测试覆盖率，法线贴图逐级重新归一化
+// 与BlockCompression一样只依赖C++标准库和SSE2/AVX2，可在Linux上编译；每级的水平/垂直两遍按行块分给ParallelFor
+// 逐级生成：同时只保留相邻两级，每级生成后直接交给块编码器，不保存整条浮点mip链
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+enum class MipFilter : uint8_t {
+    Box,        // 面积平均（偶数尺寸即2x2平均），最快，偏模糊
+    Kaiser,     // Kaiser窗sinc（半径3），清晰且振铃小，默认
+    Lanczos     // Lanczos3，最清晰，高对比边缘有轻微振铃
+};
+
+struct MipGenerateSettings {
+    MipFilter filter = MipFilter::Kaiser;
+    bool sRGB = false;              // RGB为sRGB编码：先转线性再滤波，输出时转回（Alpha总是线性）
+    bool normalMap = false;         // RGB为[0,1]编码的法线：每级重新归一化，忽略sRGB
+    float alphaCutoff = 0.0f;       // > 0：Alpha测试阈值，每级缩放Alpha使通过阈值的像素比例与顶层相同
+    bool wrap = true;               // 滤波越过边缘时环绕（平铺纹理）；false时夹取（立方体面、非平铺纹理）
+    uint32_t maxMipLevels = 0;      // 0：完整mip链
+    unsigned int maxThreads = 0;    // 0：全部硬件线程（小图自动减少）
+};
+
+// 线性空间的RGBA32F图像，行紧密排列（行距width * 16字节）
+struct MipImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<float> pixels;
+};
+
+const char* GetMipFilterName(MipFilter filter);
+
+// 完整mip链的级数（每级宽高减半，最小为1）
+uint32_t GetMipLevelCount(uint32_t width, uint32_t height);
+
+// 源图 -> MipImage：RGBA8按settings.sRGB（法线贴图除外）转线性；RGBA32F原样复制
+void LoadMipImage(const uint8_t* rgba, uint32_t width, uint32_t height, size_t rowPitch,
+                  const MipGenerateSettings& settings, MipImage& outImage);
+void LoadMipImage(const float* rgba, uint32_t width, uint32_t height, size_t rowPitch, MipImage& outImage);
+
+// MipImage -> RGBA8：截断到[0,1]，sRGB时RGB转回sRGB编码
+void StoreMipImage(const MipImage& image, const MipGenerateSettings& settings, uint8_t* outRGBA, size_t rowPitch);
+
+// 生成下一级（宽高各减半，最小为1）：可分离的多相滤波，法线贴图重新归一化
+void DownsampleMip(const MipImage& source, const MipGenerateSettings& settings, MipImage& outImage);
+
+// Alpha >= cutoff的像素比例
+float ComputeAlphaCoverage(const MipImage& image, float cutoff);
+// 缩放Alpha使覆盖率等于targetCoverage（取Alpha的分位数作为新阈值，缩放到cutoff）
+void ScaleAlphaToCoverage(MipImage& image, float cutoff, float targetCoverage);
+
+// 逐级生成mip链：第0级为top，每级（已做覆盖率修正）调用一次callback(level, image)
+// callback返回后该级被释放，需要保留的数据要在callback里复制或编码
+void GenerateMipChain(MipImage top, const MipGenerateSettings& settings,
+                      const std::function<void(uint32_t level, const MipImage& image)>& callback);
@@ -2,7 +2,9 @@
 #include <d3d12.h>
 #include <wrl/client.h>
 #include <string>
+#include <vector>
 #include <DirectXTex/DirectXTex.h>
+#include "MipGenerator.h"
 
 using Microsoft::WRL::ComPtr;
 
@@ -24,11 +26,12 @@ enum class TextureCompressionFormat {
 };
 
 // 压缩质量
+// 全部BC格式由引擎CPU编码器压缩，质量档位对应BlockEncodeQuality
 enum class TextureCompressionQuality {
-    Fast,       // GPU压缩，最快
-    Normal,     // GPU压缩，平衡
-    High,       // GPU压缩，高质量
-    Ultra       // CPU压缩(DirectXTex)，最高质量
+    Fast,       // 包围盒端点，最快
+    Normal,     // 主成分端点 + 一次修正，平衡
+    High,       // 多次修正并尝试更多块模式，高质量
+    Ultra       // High + 端点邻域搜索，最高质量
 };
 
 // 纹理过滤模式
@@ -56,6 +59,11 @@ struct TextureAssetDesc {
     bool generateMips = true;
     bool sRGB = true;
 
+    // mip生成设置（引擎MipGenerator）
+    MipFilter mipFilter = MipFilter::Kaiser;
+    bool normalMap = false;             // 法线贴图：每级重新归一化，不做sRGB转换
+    float alphaCutoff = 0.0f;           // > 0：Alpha测试阈值，各级保持与顶层相同的覆盖率
+
     // 采样设置
     TextureFilterMode filter = TextureFilterMode::Trilinear;
     TextureAddressMode addressU = TextureAddressMode::Wrap;
@@ -80,14 +88,14 @@ public:
     TextureAsset(const std::string& name);
     ~TextureAsset();
 
-    // 从资产文件加载 (.texture.ast)
+    // 从资产文件加载 (.texture.ast)；烘焙的.texbin有效时直接读取，否则解析XML并重新烘焙
     bool LoadFromAssetFile(const std::wstring& assetPath);
 
     // 从源文件导入（创建新资产）
     bool ImportFromSource(const std::wstring& sourcePath,
                           const TextureAssetDesc& desc);
 
-    // 保存资产描述文件
+    // 保存资产描述文件（同时更新.texbin）
     bool SaveAssetFile(const std::wstring& assetPath);
 
     // 加载到GPU（从缓存的DDS或源文件）
@@ -106,6 +114,17 @@ public:
     // 卸载GPU资源
     void UnloadFromGPU();
 
+    // 纹理流送：从缓存的DDS创建只含[firstMip, mip级数)的新资源，上传录制到commandList（本帧命令列表）
+    // 当前资源和SRV在上传完成前继续使用；同一时间只有一个待切换的新资源
+    bool StreamMips(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, UINT firstMip);
+    // 上传完成且没有在途帧时调用（会在原槽位重写SRV）：切换到新资源并重建SRV，被替换的资源追加到outReplaced
+    // 之后需在原槽位重建引用它的Bindless SRV（MaterialManager::RefreshTextureBindings）
+    bool CommitStreamedMips(ID3D12Device* device, std::vector<ComPtr<ID3D12Resource>>& outReplaced);
+    bool HasPendingStreamedMips() const { return m_streamingResource.Get() != nullptr; }
+
+    // 热重载：重新读取资产文件（或按原设置重新导入源文件）并重新上传，调用前GPU须空闲
+    bool ReloadFromDisk(ID3D12Device* device, ID3D12GraphicsCommandList* commandList);
+
     // 重新压缩（格式变更时）
     bool Recompress(TextureCompressionFormat newFormat,
                     ID3D12Device* device,
@@ -115,6 +134,22 @@ public:
     void SetCompressionFormat(TextureCompressionFormat format) { m_desc.format = format; }
     void SetGenerateMips(bool generate) { m_desc.generateMips = generate; }
     void SetSRGB(bool sRGB) { m_desc.sRGB = sRGB; }
+    void SetCompressionQuality(TextureCompressionQuality quality) { m_desc.quality = quality; }
+    void SetMipFilter(MipFilter filter) { m_desc.mipFilter = filter; }
+    void SetNormalMap(bool normalMap) { m_desc.normalMap = normalMap; }
+    void SetAlphaCutoff(float cutoff) { m_desc.alphaCutoff = cutoff; }
+
+    // 由资产设置得到的mip生成参数：法线贴图和BC6H不做sRGB转换，只有平铺的2D纹理边缘环绕
+    MipGenerateSettings GetMipGenerateSettings() const;
+
+    // 流送状态：可流送的纹理（从缓存DDS加载的带mip的2D纹理）在TextureManager中登记，首次加载只上传尾部低mip
+    bool IsStreamable() const { return m_streamable; }
+    UINT GetResidentMip() const { return m_residentMip; }          // 当前资源的顶层对应的mip级别
+    UINT GetStreamingTailMip() const { return m_streamingTailMip; } // 总是常驻的第一级mip
+    int GetStreamingId() const { return m_streamingId; }
+    void SetStreamingId(int id) { m_streamingId = id; }
+    bool IsStreamingPinned() const { return m_streamingPinned; }
+    void SetStreamingPinned(bool pinned) { m_streamingPinned = pinned; }
 
     // 检查是否已压缩
     bool IsCompressed() const { return m_desc.format != TextureCompressionFormat::None && m_cacheValid; }
@@ -128,9 +163,9 @@ public:
 
     UINT GetWidth() const { return m_runtimeInfo.width; }
     UINT GetHeight() const { return m_runtimeInfo.height; }
-    UINT GetMipLevels() const { return m_runtimeInfo.mipLevels; }
+    UINT GetMipLevels() const { return m_runtimeInfo.mipLevels; }     // 完整mip链的级数（流送时资源只含其中一部分）
     DXGI_FORMAT GetFormat() const { return m_runtimeInfo.format; }
-    size_t GetMemorySize() const { return m_runtimeInfo.memorySize; }
+    size_t GetMemorySize() const { return m_runtimeInfo.memorySize; }   // 当前常驻的字节数
 
     TextureType GetType() const { return m_desc.type; }
     TextureCompressionFormat GetCompressionFormat() const { return m_desc.format; }
@@ -158,11 +193,10 @@ public:
     static size_t CalculateMemorySize(UINT width, UINT height, UINT mipLevels,
                                       TextureCompressionFormat format);
 
-    // ========== NVTT压缩开关 ==========
-    // 是否使用NVIDIA Texture Tools进行压缩（默认开启）
-    static bool s_useNVTT;
-    static void SetUseNVTT(bool use) { s_useNVTT = use; }
-    static bool GetUseNVTT() { return s_useNVTT; }
+    // 烘焙格式路径：Brick.texture.ast -> Brick.texbin
+    static std::wstring GetAssetBinPath(const std::wstring& assetPath);
+    // 离线烘焙：解析资产XML并写出.texbin（不涉及GPU，可在工作线程调用）
+    static bool CookAssetFile(const std::wstring& assetPath);
 
 private:
     std::string m_name;
@@ -172,10 +206,10 @@ private:
     // 文件路径
     std::wstring m_assetPath;       // .texture.ast文件路径
     std::wstring m_sourcePath;      // 源文件路径 (png/jpg/hdr等)
-    std::string m_sourceHash;       // 源文件哈希（用于缓存验证）
+    std::string m_sourceHash;       // 源文件内容XXH64（十六进制，记录在资产文件中）
 
     // 缓存信息
-    std::wstring m_cacheDdsPath;    // 缓存的DDS文件路径
+    std::wstring m_cacheDdsPath;    // 缓存的DDS文件路径（TextureCacheIndex目录下的<烘焙键>.dds）
     bool m_cacheValid = false;
 
     // GPU资源
@@ -187,13 +221,22 @@ private:
 
     bool m_isLoaded = false;
 
-    // ========== 内部方法 ==========
-    // 计算源文件哈希
-    std::string CalculateSourceHash(const std::wstring& path);
+    // 流送状态
+    bool m_streamable = false;
+    bool m_streamingPinned = false;
+    UINT m_residentMip = 0;
+    UINT m_streamingTailMip = 0;
+    int m_streamingId = -1;         // TextureManager中的流送ID，未登记时为-1
+    // 正在上传、等待切换的新资源（StreamMips -> CommitStreamedMips）
+    ComPtr<ID3D12Resource> m_streamingResource;
+    ComPtr<ID3D12Resource> m_streamingUploadHeap;
+    UINT m_streamingMip = 0;
 
-    // 从缓存的DDS加载
+    // ========== 内部方法 ==========
+    // 从缓存的DDS加载：firstMip为UINT_MAX时是首次加载（开启流送时只加载尾部低mip并登记流送），否则只加载[firstMip, mip级数)
     bool LoadDDSFromCache(ID3D12Device* device,
-                          ID3D12GraphicsCommandList* commandList);
+                          ID3D12GraphicsCommandList* commandList,
+                          UINT firstMip = UINT_MAX);
 
     // 从源文件加载并压缩
     bool LoadAndCompressSource(ID3D12Device* device,
@@ -206,6 +249,13 @@ private:
     bool ParseAssetXML(const std::wstring& xmlPath);
     bool WriteAssetXML(const std::wstring& xmlPath);
 
-    // 生成缓存路径
+    // 烘焙格式（.texbin）读写，内容与资产XML一致
+    bool ReadAssetBin(const std::wstring& binPath);
+    bool WriteAssetBin(const std::wstring& binPath, const std::wstring& xmlPath);
+
+    // 按当前源文件内容和设置重新生成缓存路径，缓存文件存在即有效
+    void ValidateCache();
+
+    // 缓存路径：烘焙键 = 源文件内容哈希 + 格式/mip/sRGB/质量等设置，失败时返回空
     std::wstring GenerateCachePath();
 };
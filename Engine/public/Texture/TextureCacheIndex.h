@@ -0,0 +1,63 @@
+// TextureCacheIndex.h
+// 纹理烘焙缓存索引 — 源文件（规范化路径, 大小, 修改时间）-> 内容XXH64 -> 缓存目录下的<烘焙键>.dds
+// 烘焙键由内容哈希和影响结果的设置（格式、mip、sRGB、质量等，见TextureAsset::GenerateCachePath）组成：
+// 不同目录的同名纹理、同一源图的不同设置互不覆盖，内容和设置都相同的纹理共用一份结果
+// 大小和修改时间与记录一致的源文件不再读取；新记录在Flush/Shutdown时写回索引文件
+
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class TextureCacheIndex {
+public:
+    static TextureCacheIndex& GetInstance();
+
+    TextureCacheIndex(const TextureCacheIndex&) = delete;
+    TextureCacheIndex& operator=(const TextureCacheIndex&) = delete;
+
+    // 加载目录下的索引（目录不存在时创建）；未初始化时GetSourceHash每次读文件且不记录，GetCookedPath返回空
+    bool Initialize(const std::wstring& directory);
+    void Shutdown();
+
+    // 有新记录时写回索引
+    bool Flush();
+
+    // 源文件内容哈希：大小和修改时间与记录一致时直接返回，否则读文件重新计算并记录
+    bool GetSourceHash(const std::wstring& sourcePath, uint64_t& outHash);
+
+    // 烘焙结果路径：<缓存目录>\<cookKey的十六进制>.dds
+    std::wstring GetCookedPath(uint64_t cookKey) const;
+
+    const std::wstring& GetDirectory() const { return m_directory; }
+
+    // ========== 统计信息 ==========
+
+    int GetHashedCount() const { std::lock_guard<std::mutex> lock(m_mutex); return m_hashedCount; }
+    int GetReusedCount() const { std::lock_guard<std::mutex> lock(m_mutex); return m_reusedCount; }
+    size_t GetSourceCount() const { std::lock_guard<std::mutex> lock(m_mutex); return m_sources.size(); }
+
+private:
+    TextureCacheIndex() = default;
+    ~TextureCacheIndex() = default;
+
+    struct SourceRecord {
+        uint64_t size = 0;
+        uint64_t writeTime = 0;
+        uint64_t hash = 0;
+    };
+
+    // 调用方需持有m_mutex
+    bool LoadIndex();
+    bool WriteIndex();
+
+    std::wstring m_directory;
+    std::wstring m_indexPath;
+    std::unordered_map<std::wstring, SourceRecord> m_sources;  // 键为NormalizePathKey后的路径
+    bool m_dirty = false;
+    mutable std::mutex m_mutex;     // 保护记录表和统计，读文件计算哈希时不持锁
+
+    int m_hashedCount = 0;          // 读文件计算哈希的次数
+    int m_reusedCount = 0;          // 直接使用记录的次数
+};
@@ -9,6 +9,8 @@
 #include <string>
 #include <memory>
 #include "TextureAsset.h"
+#include "BlockCompression.h"
+#include "MipGenerator.h"
 
 using Microsoft::WRL::ComPtr;
 
@@ -23,6 +25,16 @@ struct CompressionParams {
     float padding[2];       // 对齐到16字节
 };
 
+// 引擎编码器与DirectXTex的对比结果（同一源图的顶层mip，PSNR在格式的有效通道上计算，BC6H为色调映射后的PSNR）
+struct BlockEncoderComparison {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    double enginePSNR = 0.0;
+    double engineMs = 0.0;
+    double directXTexPSNR = 0.0;
+    double directXTexMs = 0.0;
+};
+
 class TextureCompressor {
 public:
     static TextureCompressor& GetInstance();
@@ -52,14 +64,14 @@ public:
 
     // ========== CPU压缩（高质量，用于导入时） ==========
 
-    // 使用DirectXTex进行CPU压缩
+    // CPU压缩：默认全部BC格式使用引擎编码器（BlockCompression），关闭编码器时使用DirectXTex
     bool CompressCPU(const DirectX::ScratchImage& sourceImage,
                      TextureCompressionFormat format,
                      bool sRGB,
                      TextureCompressionQuality quality,
                      DirectX::ScratchImage& outCompressedImage);
 
-    // 压缩并保存为DDS
+    // 压缩并保存为DDS（需要生成mip时用引擎mip生成器，Kaiser滤波）
     bool CompressAndSaveDDS(const std::wstring& sourcePath,
                             const std::wstring& outputDdsPath,
                             TextureCompressionFormat format,
@@ -67,38 +79,39 @@ public:
                             bool sRGB,
                             TextureCompressionQuality quality);
 
-    // ========== NVIDIA Texture Tools 压缩（高质量） ==========
-
-    // NVTT压缩质量等级
-    enum class NVTTQuality {
-        Fastest = 0,    // 最快
-        Normal = 1,     // 普通
-        Production = 2, // 生产级（默认）
-        Highest = 3     // 最高质量
-    };
-
-    // 使用NVIDIA Texture Tools压缩
-    // 如果NVTT可用，优先使用NVTT；否则回退到DirectXTex
-    bool CompressWithNVTT(const std::wstring& sourcePath,
-                          const std::wstring& outputDdsPath,
-                          TextureCompressionFormat format,
-                          bool generateMips,
-                          bool sRGB,
-                          NVTTQuality quality = NVTTQuality::Production);
-
-    // 设置NVIDIA Texture Tools路径
-    void SetNVTTPath(const std::wstring& nvttExePath) { m_nvttPath = nvttExePath; }
-    const std::wstring& GetNVTTPath() const { return m_nvttPath; }
-
-    // 设置/获取NVTT压缩质量
-    void SetNVTTQuality(NVTTQuality quality) { m_nvttQuality = quality; }
-    NVTTQuality GetNVTTQuality() const { return m_nvttQuality; }
-
-    // 检查NVTT是否可用
-    bool IsNVTTAvailable() const;
-
-    // 获取质量名称
-    static const char* GetNVTTQualityName(NVTTQuality quality);
+    // ========== 引擎CPU编码器（BC1/BC3/BC5/BC7/BC6H） ==========
+
+    // 关闭时所有格式都用DirectXTex（对比或排查问题用）
+    void SetUseBlockEncoder(bool use) { m_useBlockEncoder = use; }
+    bool GetUseBlockEncoder() const { return m_useBlockEncoder; }
+
+    // 引擎编码器支持的格式
+    static bool SupportsBlockEncoder(TextureCompressionFormat format);
+    // 纹理的压缩质量 -> 编码器档位
+    static BlockEncodeQuality GetBlockEncodeQuality(TextureCompressionQuality quality);
+    static const char* GetQualityName(TextureCompressionQuality quality);
+
+    // 用引擎编码器压缩全部mip和数组层（源图先转换为RGBA8，BC6H转换为RGBA32F）
+    bool CompressWithBlockEncoder(const DirectX::ScratchImage& sourceImage,
+                                  TextureCompressionFormat format,
+                                  bool sRGB,
+                                  TextureCompressionQuality quality,
+                                  DirectX::ScratchImage& outCompressedImage);
+
+    // 用引擎mip生成器从源图顶层生成mip链（按mipSettings），逐级直接交给块编码器，不保存未压缩的mip链
+    // format为None时输出RGBA8（HDR源为RGBA32F）；引擎编码器不支持或已关闭时先生成未压缩mip链再交给CompressCPU
+    bool GenerateMipsAndCompress(const DirectX::ScratchImage& sourceImage,
+                                 TextureCompressionFormat format,
+                                 bool sRGB,
+                                 TextureCompressionQuality quality,
+                                 const MipGenerateSettings& mipSettings,
+                                 DirectX::ScratchImage& outImage);
+
+    // 质量对比：源文件顶层mip分别用引擎编码器和DirectXTex压缩再解码，比较PSNR和耗时
+    bool CompareWithDirectXTex(const std::wstring& sourcePath,
+                               TextureCompressionFormat format,
+                               TextureCompressionQuality quality,
+                               BlockEncoderComparison& outResult);
 
     // ========== 辅助函数 ==========
 
@@ -171,11 +184,8 @@ private:
     ComPtr<ID3D12Resource> m_constantBuffer;
     CompressionParams* m_mappedConstantBuffer = nullptr;
 
-    // NVIDIA Texture Tools 路径（可通过SetNVTTPath设置，默认在项目根目录的上级查找）
-    std::wstring m_nvttPath;
-
-    // NVTT压缩质量
-    NVTTQuality m_nvttQuality = NVTTQuality::Production;
+    // BC格式是否使用引擎编码器
+    bool m_useBlockEncoder = true;
 
     // 线程组大小（每个线程处理一个4x4块）
     static const UINT THREAD_GROUP_SIZE = 8;  // 8x8线程组
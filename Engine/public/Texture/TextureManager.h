@@ -1,5 +1,6 @@
 #pragma once
 #include "TextureAsset.h"
+#include "TextureStreaming.h"
 #include <map>
 #include <memory>
 #include <vector>
@@ -38,6 +39,10 @@ public:
     TextureAsset* GetTexture(const std::string& name);
     TextureAsset* GetTextureByPath(const std::wstring& path);
 
+    // 热重载：重新加载资产文件或源文件路径为changedPath的已加载纹理，调用前GPU须空闲
+    // 重新加载的纹理追加到outReloaded，返回数量
+    int ReloadTexturesFromFile(const std::wstring& changedPath, std::vector<TextureAsset*>& outReloaded);
+
     // ========== 纹理卸载 ==========
 
     void UnloadTexture(const std::string& name);
@@ -79,6 +84,36 @@ public:
     // 验证缓存有效性
     bool ValidateCache(const std::wstring& assetPath);
 
+    // ========== 纹理流送 ==========
+
+    // 开启时（需在加载纹理前设置）可流送的纹理首次只上传最大边不超过尾部尺寸的低mip，高mip按屏幕尺寸反馈加载
+    void SetStreamingEnabled(bool enabled) { m_streamingEnabled = enabled; }
+    bool IsStreamingEnabled() const { return m_streamingEnabled; }
+    // 首次加载时的尾部尺寸（流送关闭时为0，即加载完整mip链）
+    UINT GetStreamingTailSize() const { return m_streamingEnabled ? (UINT)kStreamingTailSize : 0u; }
+
+    // 流送纹理的显存预算（字节），超出时按LRU丢弃高mip；0表示不限制
+    void SetStreamingBudget(size_t bytes);
+    size_t GetStreamingBudget() const;
+
+    // TextureAsset加载/卸载时调用
+    void RegisterStreaming(TextureAsset* texture);
+    void UnregisterStreaming(TextureAsset* texture);
+    // 固定：始终保持完整mip链（预览面板中的纹理）
+    void SetStreamingPinned(TextureAsset* texture, bool pinned);
+
+    // 反馈：texture的一个UV单位在屏幕上覆盖pixelsPerUV个像素（每帧可多次调用，取最大）
+    void RequestStreaming(TextureAsset* texture, float pixelsPerUV);
+
+    // 每帧调用一次：每隔kStreamingUpdateInterval帧按累计的反馈和预算计算常驻变化（上一批上传未完成时推迟），返回是否有待执行的变化
+    bool UpdateStreaming();
+    // 每帧在BeginFrame之后、录制渲染命令之前调用（commandList为本帧命令列表）：
+    // 有上传完成时先等所有已提交的帧执行完（原槽位的SRV不能在在途帧读取时重写），再把上传切换到新资源，
+    // 追加到outChanged（需在原槽位重建引用它的SRV），返回数量；最后把UpdateStreaming得到的变化的上传录制到commandList
+    int ApplyStreaming(ID3D12GraphicsCommandList* commandList, std::vector<TextureAsset*>& outChanged);
+
+    StreamingStats GetStreamingStats() const;
+
     // ========== 统计信息 ==========
 
     int GetLoadedTextureCount() const { return (int)m_textures.size(); }
@@ -98,6 +133,11 @@ public:
 
     static const UINT MAX_TEXTURES = 1000;  // SRV堆最大纹理数
 
+    static constexpr UINT kStreamingTailSize = 64;                      // 总是常驻的低mip的最大边
+    static constexpr int kStreamingUpdateInterval = 8;                  // 每隔多少帧更新一次常驻（期间的反馈合并）
+    static constexpr size_t kDefaultStreamingBudget = 512ull << 20;     // 默认预算512MB
+    static constexpr size_t kStreamingUploadPerUpdate = 64ull << 20;    // 每次更新最多上传64MB
+
 private:
     TextureManager();
     ~TextureManager();
@@ -129,6 +169,22 @@ private:
     // 异步加载相关
     std::mutex m_textureMutex;
 
+    // 纹理流送（决策见TextureStreamer），流送ID -> 纹理
+    // 单独的锁：卸载纹理时（持有m_textureMutex）会注销流送
+    bool m_streamingEnabled = true;
+    TextureStreamer m_streamer;
+    std::vector<TextureAsset*> m_streamingTextures;
+    std::vector<StreamingAction> m_pendingStreamingActions;
+    int m_streamingFrame = 0;
+    // 录制到某一帧的上传，该帧的栅栏值完成且没有在途帧时切换到新资源
+    struct StreamingUpload {
+        TextureAsset* texture = nullptr;
+        int textureId = -1;
+        UINT64 fenceValue = 0;
+    };
+    std::vector<StreamingUpload> m_streamingUploads;
+    mutable std::mutex m_streamingMutex;
+
     // ========== 内部方法 ==========
 
     // 创建SRV描述符堆
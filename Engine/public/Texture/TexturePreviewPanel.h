@@ -8,6 +8,7 @@
 #include <string>
 #include <memory>
 #include "TextureAsset.h"
+#include "TextureCompressor.h"
 
 using Microsoft::WRL::ComPtr;
 
@@ -70,6 +71,9 @@ public:
     // 获取当前纹理
     TextureAsset* GetCurrentTexture() const { return m_currentTexture; }
 
+    // 纹理的GPU资源被替换后调用（如流送改变了常驻mip），当前预览的纹理需要重建预览SRV
+    void OnTextureResourceChanged(TextureAsset* texture);
+
 private:
     TexturePreviewPanel() = default;
     ~TexturePreviewPanel() = default;
@@ -129,6 +133,13 @@ private:
     TextureCompressionQuality m_selectedQuality = TextureCompressionQuality::Normal;
     bool m_generateMips = true;
     bool m_sRGB = true;
+    MipFilter m_mipFilter = MipFilter::Kaiser;
+    bool m_normalMap = false;
+    float m_alphaCutoff = 0.0f;     // 0：不做Alpha覆盖率修正
+
+    // 引擎编码器与DirectXTex的最近一次对比结果
+    BlockEncoderComparison m_encoderComparison;
+    bool m_hasEncoderComparison = false;
 
     // ImGui纹理ID（用于预览显示）
     D3D12_GPU_DESCRIPTOR_HANDLE m_previewSRV = {};
@@ -0,0 +1,100 @@
+// TextureStreaming.h
+// 纹理流送策略 — 按屏幕尺寸估算每张纹理需要的最精细mip，在显存预算内决定各纹理常驻的mip范围
+// 尾部低mip总是常驻并在首次加载时上传；高mip按请求加载，超出预算时从最久未使用（LRU）的纹理开始逐级丢弃
+// 模块只处理纹理ID和字节数，不依赖D3D，可以单独测试；资源重建和SRV更新由TextureManager执行
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 注册描述：mip 0最精细，mipBytes.size()为mip级数
+struct StreamingTextureDesc {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint64_t> mipBytes;     // 每级mip的显存字节数
+    uint32_t tailMip = 0;               // 从这一级起总是常驻（见GetStreamingTailMip）
+    uint32_t residentMip = 0;           // 注册时已常驻的最精细mip
+    bool pinned = false;                // 固定：始终请求mip 0，不参与LRU丢弃（如预览面板中的纹理）
+};
+
+// 一次常驻变化：纹理重建为只含[toMip, mip级数)的资源
+struct StreamingAction {
+    int textureId = -1;
+    uint32_t fromMip = 0;
+    uint32_t toMip = 0;
+    uint64_t bytes = 0;                 // 变化后常驻的字节数
+
+    bool IsLoad() const { return toMip < fromMip; }
+};
+
+struct StreamingStats {
+    uint64_t budgetBytes = 0;
+    uint64_t residentBytes = 0;         // 当前常驻
+    uint64_t requestedBytes = 0;        // 上次Update时所有请求都满足需要的字节数（未请求的纹理按尾部计）
+    int textureCount = 0;
+    int pendingLoads = 0;               // 上次Update后仍比请求模糊的纹理数（受上传量限制或超出预算）
+    int loadCount = 0;                  // 累计加载/丢弃次数
+    int evictCount = 0;
+};
+
+// 总是常驻的第一级mip：最大边不超过tailSize的最精细一级（tailSize为0时返回0，即不流送）
+// blockCompressed时只允许宽高为4的倍数的级别作为资源顶层（BC格式的要求），结果不超过第一个不满足的级别之前
+uint32_t GetStreamingTailMip(uint32_t width, uint32_t height, uint32_t mipCount, uint32_t tailSize, bool blockCompressed);
+
+// 屏幕尺寸对应的mip：pixelsPerUV为一个UV单位（纹理平铺一次）在屏幕上覆盖的像素数
+// 每个像素覆盖max(width, height) / pixelsPerUV个mip 0纹素，取log2向下取整（宁可偏清晰），再加mipBias
+uint32_t ComputeStreamingMip(uint32_t width, uint32_t height, uint32_t mipCount, float pixelsPerUV, float mipBias = 0.0f);
+
+class TextureStreamer {
+public:
+    // 注册/注销纹理，ID在注销后复用
+    int Register(const StreamingTextureDesc& desc);
+    void Unregister(int textureId);
+    bool IsRegistered(int textureId) const;
+
+    void SetPinned(int textureId, bool pinned);
+
+    // 显存预算：所有注册纹理常驻字节数之和的上限（只有尾部mip时仍超出则无法满足）；0表示不限制
+    void SetBudget(uint64_t bytes) { m_stats.budgetBytes = bytes; }
+    uint64_t GetBudget() const { return m_stats.budgetBytes; }
+    // 每次Update列出的加载最多上传的字节数（至少列出一个加载）；0表示不限制
+    void SetMaxUploadBytes(uint64_t bytes) { m_maxUploadBytes = bytes; }
+    uint64_t GetMaxUploadBytes() const { return m_maxUploadBytes; }
+
+    // 反馈：本轮需要textureId的mip级别，同一轮多次请求取最精细的一级
+    void Request(int textureId, uint32_t mip);
+    void RequestScreenSize(int textureId, float pixelsPerUV, float mipBias = 0.0f);
+
+    // 按本轮请求和预算计算常驻变化并开始新一轮反馈：先列出全部丢弃（释放显存），再按优先级列出加载
+    // 动作不会自动生效，执行成功后调用SetResidentMip
+    void Update(std::vector<StreamingAction>& outActions);
+    void SetResidentMip(int textureId, uint32_t mip);
+
+    uint32_t GetResidentMip(int textureId) const;
+    uint64_t GetResidentBytes(int textureId) const;
+    const StreamingStats& GetStats() const { return m_stats; }
+
+private:
+    struct Entry {
+        bool active = false;
+        bool pinned = false;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mipCount = 0;
+        uint32_t tailMip = 0;
+        uint32_t residentMip = 0;
+        uint32_t requestedMip = 0;      // lastRequestRound == m_round时有效
+        uint64_t lastRequestRound = 0;  // 最近一次被请求的轮次（LRU依据）
+        std::vector<uint64_t> bytesFrom;   // bytesFrom[m]：常驻[m, mipCount)的字节数，末尾多一个0
+    };
+
+    // 本轮期望的最精细mip：固定纹理为0，被请求的为请求级别，未请求的为尾部
+    uint32_t GetWantedMip(const Entry& entry) const;
+
+    std::vector<Entry> m_entries;
+    std::vector<int> m_freeIds;
+    uint64_t m_round = 1;               // 反馈轮次，每次Update后加一
+    uint64_t m_maxUploadBytes = 0;
+    StreamingStats m_stats;
+};
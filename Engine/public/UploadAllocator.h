@@ -0,0 +1,86 @@
+// UploadAllocator.h
+// 逐帧线性上传分配器 — 一块持久映射的上传堆按环形缓冲使用，每帧的常量/实例数据顺序分配，按栅栏值回收
+
+#pragma once
+#include <d3d12.h>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// 一次分配的结果：CPU写入地址 + GPU虚拟地址（可直接用于根描述符）
+struct UploadAllocation {
+    void* cpuAddress = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = 0;
+    uint64_t size = 0;
+};
+
+class LinearUploadAllocator {
+public:
+    static LinearUploadAllocator& GetInstance();
+
+    LinearUploadAllocator(const LinearUploadAllocator&) = delete;
+    LinearUploadAllocator& operator=(const LinearUploadAllocator&) = delete;
+
+    // 创建上传堆（InitD3D12之后调用）
+    bool Initialize(ID3D12Device* device, uint64_t capacity = 4 * 1024 * 1024);
+    // 释放上传堆（程序退出时调用，需保证GPU已空闲）
+    void Shutdown();
+
+    // 帧开始：回收GPU已执行完的帧占用的区域
+    void BeginFrame();
+    // 帧结束：用本帧最后一次提交的栅栏值标记本帧的所有分配
+    void EndFrame(uint64_t fenceValue);
+
+    // 分配size字节（alignment须为2的幂）。空间不足时先等待最早的在途帧；仍不足则换一块更大的上传堆
+    bool Allocate(uint64_t size, uint64_t alignment, UploadAllocation& outAllocation);
+
+    // 分配并写入常量缓冲数据（按256字节对齐），返回GPU地址，失败返回0
+    D3D12_GPU_VIRTUAL_ADDRESS AllocateConstants(const void* data, uint64_t size);
+
+    // ========== 统计信息 ==========
+
+    uint64_t GetCapacity() const { return m_capacity; }
+    uint64_t GetFrameUsage() const { return m_lastFrameBytes; }   // 上一帧分配量（含对齐和回绕浪费）
+    uint64_t GetPeakFrameUsage() const { return m_peakFrameBytes; }
+    int GetFramesInFlight() const { return (int)m_pendingFrames.size(); }
+
+private:
+    LinearUploadAllocator() = default;
+    ~LinearUploadAllocator();
+
+    // 在环上寻找空间，成功时推进写指针
+    bool TryAllocate(uint64_t size, uint64_t alignment, uint64_t& outOffset);
+    // 回收栅栏值已完成的帧；wait为true时至少等待并回收最早的一帧
+    void RetireFrames(bool wait);
+    bool CreateBuffer(uint64_t capacity);
+
+    // 已提交但GPU可能仍在读取的帧
+    struct FrameMarker {
+        uint64_t fenceValue = 0;
+        uint64_t endOffset = 0;     // 该帧结束时的写指针，回收后成为新的读指针
+        uint64_t bytes = 0;
+    };
+
+    // 扩容后被替换的旧上传堆，等引用它的帧执行完再释放
+    struct RetiredBuffer {
+        ID3D12Resource* resource = nullptr;
+        uint64_t fenceValue = 0;    // 0表示属于当前帧，EndFrame时补上
+    };
+
+    ID3D12Device* m_device = nullptr;
+    ID3D12Resource* m_buffer = nullptr;
+    uint8_t* m_mappedData = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS m_gpuBase = 0;
+    uint64_t m_capacity = 0;
+
+    uint64_t m_head = 0;            // 写指针
+    uint64_t m_tail = 0;            // 最早在途帧的起始位置
+    uint64_t m_usedBytes = 0;       // 在途帧 + 当前帧占用量，用于区分环满和环空
+    uint64_t m_frameBytes = 0;      // 当前帧在本块上传堆上的占用量
+    uint64_t m_frameTotalBytes = 0; // 当前帧总分配量（含扩容前的旧堆）
+    uint64_t m_lastFrameBytes = 0;
+    uint64_t m_peakFrameBytes = 0;
+
+    std::deque<FrameMarker> m_pendingFrames;
+    std::vector<RetiredBuffer> m_retiredBuffers;
+};